@@ -20,6 +20,10 @@
 #ifndef HPL_AI_NODE_GENERATOR_H
 #define HPL_AI_NODE_GENERATOR_H
 
+#include <cstdint>
+#include <map>
+#include <vector>
+
 #include "system/SystemTypes.h"
 #include "engine/EngineTypes.h"
 
@@ -50,7 +54,30 @@ namespace hpl {
 
 	//-------------------------------
 
-	class cAINodeGenerator : public iPhysicsRayCallback
+	/**
+	 * Nodes generated for one tile of the grid, nodes are in grid order and mvCellNodeNum has the number of nodes in each cell.
+	 */
+	class cAINodeGeneratorTile
+	{
+	public:
+		uint64_t mlHash;
+		int mlLastUsed;
+
+		std::vector<cVector3f> mvNodes;
+		std::vector<int> mvCellNodeNum;
+	};
+
+	typedef std::map<uint64_t, cAINodeGeneratorTile> tAINodeGeneratorTileMap;
+	typedef tAINodeGeneratorTileMap::iterator tAINodeGeneratorTileMapIt;
+
+	//-------------------------------
+
+	/**
+	 * Places nodes by casting rays down on a grid over the world, the grid is split into tiles that are cast on several threads.
+	 * Tiles are kept keyed by a hash of the params and the static bodies around them, so when generating again after
+	 * an edit, only the tiles near the changed bodies are cast again. The result is the same as casting the whole grid in order.
+	 */
+	class cAINodeGenerator
 	{
 	public:
 		cAINodeGenerator();
@@ -58,8 +85,14 @@ namespace hpl {
 
 		void Generate(cWorld* apWorld,cAINodeGeneratorParams *apParams);
 
+		void ClearTileCache(){ m_mapTiles.clear();}
+
+		void SetMaxThreads(int alX){ mlMaxThreads = alX;}
+		int GetMaxThreads(){ return mlMaxThreads;}
+
 	private:
-		bool OnIntersect(iPhysicsBody *pBody,cPhysicsRayParams *apParams);
+		void GenerateTile(cAINodeGeneratorTile *apTile, iPhysicsWorld *apPhysicsWorld, const cVector3f& avWorldMin, const cVector3f& avWorldMax,
+							const std::vector<float>& avX, const std::vector<float>& avZ, int alStartX, int alEndX, int alStartZ, int alEndZ);
 
 		void SaveToFile();
 		void LoadFromFile();
@@ -68,6 +101,10 @@ namespace hpl {
 		cWorld* mpWorld;
 		tTempAiNodeList *mpNodeList;
 		int mlIDCount;
+
+		int mlMaxThreads;
+		int mlGenerateCount;
+		tAINodeGeneratorTileMap m_mapTiles;
 	};
 
 };
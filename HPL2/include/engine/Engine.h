@@ -40,6 +40,7 @@ namespace hpl {
 
 	class cSystem;
 	class cInput;
+	class cInputRecorder;
 	class cResources;
 	class cGraphics;
 	class cScene;
@@ -160,12 +161,30 @@ namespace hpl {
 		void SetLimitFPS(bool abX){ mbLimitFPS = abX;}
 		bool GetLimitFPS(){ return mbLimitFPS;}
 
+		/**
+		 * Renders entities, cameras and bones inbetween the last two logic updates, from how far the time is between them.
+		 * A frame is then rendered every loop even if LimitFPS is set, so vsync should be used to limit it.
+		 */
+		void SetRenderInterpolation(bool abX);
+		bool GetRenderInterpolation(){ return mbRenderInterpolation;}
+
 		void SetWaitIfAppOutOfFocus(bool abX){ mbWaitIfAppOutOfFocus =abX;}
 		bool GetWaitIfAppOutOfFocus(){ return mbWaitIfAppOutOfFocus;}
 
 		void SetPaused(bool abPaused);
 		bool GetPaused();
 
+		/**
+		 * Records input, logic updates and frame times to a file, with the random seed used. Saved when stopped or at exit.
+		 */
+		bool StartInputRecording(const tWString& asFile);
+		/**
+		 * Replays a recording from StartInputRecording. Logic updates are run as recorded instead of by the timer,
+		 * so the replay runs as fast as it can. The engine exits when the recording ends.
+		 */
+		bool StartInputReplay(const tWString& asFile);
+		void StopInputRecording();
+
 		static void SetDeviceWasPlugged() { mbDevicePlugged = true; }
 		static void SetDeviceWasRemoved() { mbDeviceRemoved = true; }
 
@@ -190,6 +209,8 @@ namespace hpl {
 	private:
 		void UpdateFrameTimer();
 
+		bool WantLogicUpdate(cInputRecorder *apRecorder);
+
 		void CheckAndBroadcastFocusChange();
 
 		void CheckIfAppInFocusElseWait();
@@ -213,6 +234,7 @@ namespace hpl {
 		iTimer *mpFrameTimer;
 
 		bool mbLimitFPS;
+		bool mbRenderInterpolation;
 
 		tScriptVarMap m_mapLocalVars;
 		tScriptVarMap m_mapGlobalVars;
@@ -20,6 +20,7 @@
 #ifndef HPL_ANIMATION_TRACK_H
 #define HPL_ANIMATION_TRACK_H
 
+#include <vector>
 #include "math/MathTypes.h"
 #include "graphics/GraphicsTypes.h"
 #include "system/SystemTypes.h"
@@ -44,7 +45,10 @@ namespace hpl {
 		cKeyFrame* CreateKeyFrame(float afTime);
 		void ClearKeyFrames();
 
-		inline cKeyFrame* GetKeyFrame(int alIndex){ return mvKeyFrames[alIndex];}
+		/**
+		 * The key frame may be changed through the returned pointer, so the playback data is rebuilt the next time it is used.
+		 */
+		inline cKeyFrame* GetKeyFrame(int alIndex){ mbKeyFramesCompiled = false; return mvKeyFrames[alIndex];}
 		inline int GetKeyFrameNum(){ return (int) mvKeyFrames.size();}
 
 		inline tAnimTransformFlag GetTransformFlags(){ return mTransformFlags;}
@@ -55,8 +59,10 @@ namespace hpl {
 		 * \param apNode The node with it's base pose
 		 * \param afTime The time at which to apply the animation
 		 * \param afWeight The weight of the animation, a value from 0 to 1.
+		 * \param apCursor Key frame index used at the last call, kept by the caller (one per track and animation state).
+		 *  Playing forward then finds the frames without searching.
 		 */
-		void ApplyToNode(cNode3D* apNode, float afTime, float afWeight,bool bLoop=true);
+		void ApplyToNode(cNode3D* apNode, float afTime, float afWeight,bool bLoop=true, int *apCursor=NULL);
 
 		/**
 		 * Get a KeyFrame that contains an interpolated value.
@@ -81,11 +87,22 @@ namespace hpl {
 		int GetNodeIndex(){ return mlNodeIdx;}
 
 	private:
+		void CompileKeyFrames();
+		float GetKeyFrameIndicesAtTime(float afTime, int &alIdxA, int &alIdxB, int *apCursor);
+		void GetInterpolatedTransform(float afTime, int *apCursor, cQuaternion &aRotation, cVector3f &aTrans);
+
 		tString msName;
 
 		int mlNodeIdx;
 
 		tKeyFramePtrVec mvKeyFrames;
+
+		//Playback data, one contiguous array per component, built from the key frames when first needed.
+		//Rotations are normalized with positive w.
+		bool mbKeyFramesCompiled;
+		std::vector<float> mvKeyTimes;
+		std::vector<cQuaternion> mvKeyRotations;
+		std::vector<cVector3f> mvKeyTranslations;
 		tAnimTransformFlag mTransformFlags;
 
 		float mfMaxFrameTime;
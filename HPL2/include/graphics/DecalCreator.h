@@ -36,6 +36,29 @@ namespace hpl {
 	class cRendererCallbackFunctions;
 	class cBoundingVolume;
 	class DebugDraw;
+	class cTriangleBVH;
+
+	//----------------------------------------------
+
+	/**
+	 * Polygons clipped out of a mesh by the decal box, in the local space of the mesh.
+	 * The vertices of all polygons are stored after each other, mvPolygonSizes holds the vertex count of each one.
+	 */
+	class cDecalClipOutput
+	{
+	public:
+		cDecalClipOutput() : mlTriangleCount(0) {}
+
+		void Clear();
+		void Append(const cDecalClipOutput& aOutput, int alMaxTriangles);
+
+		tVector3fVec mvPositions;
+		tVector3fVec mvNormals;
+		tIntVec mvPolygonSizes;
+		int mlTriangleCount;
+	};
+
+	//----------------------------------------------
 
 	class cDecalCreator
 	{
@@ -48,6 +71,7 @@ namespace hpl {
 		void ClearMeshes();
 
 		void SetMaxTrianglesPerDecal(int alMaxTris) { mlMaxDecalTriangleCount = alMaxTris; }
+		void SetMaxClipThreads(int alX) { mlMaxClipThreads = alX; }
 
 		void SetDecalPosition(const cVector3f& avPosition);
 		void SetDecalUp(const cVector3f& avUp, bool abComputeBasis=true);
@@ -83,15 +107,28 @@ namespace hpl {
 
 		cBoundingVolume* GetDecalBoundingVolume();
 
+		/**
+		 * Clips the triangles of an indexed mesh that face the decal against the 6 planes of the decal box,
+		 * given in the space of the mesh. If apBVH is set, only the triangles near the box are tested.
+		 * Stops once more than alMaxTriangles triangles have been created. Meshes with many triangles to test
+		 * are split over up to alMaxThreads threads, the output is the same for any number of threads.
+		 */
+		static void ClipTriangles(	const float* apPositions, int alPosStride, const float* apNormals, int alNrmStride,
+									const unsigned int* apIndices, int alIndexNum, const cPlanef* apPlanes,
+									const cTriangleBVH* apBVH, int alMaxTriangles, int alMaxThreads, cDecalClipOutput& aOutput);
+
 	private:
 		void ComputeBasis();
 
 		bool AddPolygon(int alVertexCount, const cVector3f* apVertices, const cVector3f* apNormals, iVertexBuffer* apDecalVB,
 						const cMatrixf& amtxWorldMatrix,const cMatrixf& amtxWorldNormalRot);
 		void ClipMesh(cSubMeshEntity* apMesh, iVertexBuffer* apDecalVB);
-		int ClipPolygon(int alVertexCount, const cVector3f* apVertices, const cVector3f* apNormals,
-						cVector3f* apNewVertices, cVector3f* apNewNormals, const std::vector<cPlanef>& avPlanes);
-		int ClipPolygonAgainstPlane(const cPlanef& aPlane, int alVertexCount,
+		static void ClipTriangleRange(	const float* apPositions, int alPosStride, const float* apNormals, int alNrmStride,
+										const unsigned int* apIndices, const cPlanef* apPlanes, const int* apTriangles,
+										int alStart, int alEnd, int alMaxTriangles, cDecalClipOutput& aOutput);
+		static int ClipPolygon(int alVertexCount, const cVector3f* apVertices, const cVector3f* apNormals,
+						cVector3f* apNewVertices, cVector3f* apNewNormals, const cPlanef* apPlanes);
+		static int ClipPolygonAgainstPlane(const cPlanef& aPlane, int alVertexCount,
 									const cVector3f* apVertices, const cVector3f* apNormals,
 									cVector3f* apNewVertices, cVector3f* apNewNormals);
 
@@ -123,8 +160,10 @@ namespace hpl {
 		int mlDecalVertexCount;
 		int mlDecalTriangleCount;
 		int mlMaxDecalTriangleCount;
+		int mlMaxClipThreads;
 
 		tPlanefVec mvClipPlanes;
+		cDecalClipOutput mClipOutput;
 
 		tString msMaterial;
 		cVector2l mvSubDiv;
@@ -21,6 +21,8 @@
 #define HPL_FONTDATA_H
 
 #include <vector>
+#include <list>
+#include <unordered_map>
 #include "math/MathTypes.h"
 #include "system/SystemTypes.h"
 #include "system/SystemTypes.h"
@@ -55,6 +57,70 @@ namespace hpl {
 	typedef std::vector<cGlyph*> tGlyphVec;
 	typedef tGlyphVec::iterator tGlyphVecIt;
 
+	//------------------------------------------------
+
+	class iFontData;
+
+	class cTextLayoutGlyph
+	{
+	public:
+		int mlGlyph;		// Index in the font, used with iFontData::GetGlyph
+		size_t mlChar;		// Position of the character in the laid out string
+		float mfX;			// Offset from the start of the row, scaled by the font size
+	};
+
+	typedef std::vector<cTextLayoutGlyph> tTextLayoutGlyphVec;
+
+	class cTextLayoutRow
+	{
+	public:
+		size_t mlStart;		// First character in the laid out string
+		size_t mlLength;	// Number of characters, same as the string given by GetWordWrapRows
+		size_t mlFirstGlyph;
+		size_t mlGlyphNum;
+		float mfLength;		// Same as GetLength on the row string
+	};
+
+	typedef std::vector<cTextLayoutRow> tTextLayoutRowVec;
+
+	/**
+	 * A string split into word wrapped rows with the glyphs to draw for each row. Created and owned by
+	 * iFontData::GetWordWrapLayout, the layout is only valid until the next call to it on the same font.
+	 */
+	class cTextLayout
+	{
+	friend class iFontData;
+	public:
+		iFontData* GetFont() const { return mpFont;}
+		const tWString& GetText() const { return msText;}
+		const cVector2f& GetFontSize() const { return mvFontSize;}
+		float GetMaxLength() const { return mfMaxLength;}
+
+		size_t GetRowNum() const { return mvRows.size();}
+		const cTextLayoutRow& GetRow(size_t alIdx) const { return mvRows[alIdx];}
+		tWString GetRowText(size_t alIdx) const { return msText.substr(mvRows[alIdx].mlStart, mvRows[alIdx].mlLength);}
+
+		const cTextLayoutGlyph& GetGlyph(size_t alIdx) const { return mvGlyphs[alIdx];}
+
+	private:
+		iFontData* mpFont;
+		size_t mlHash;
+		tWString msText;
+		cVector2f mvFontSize;
+		float mfMaxLength;
+
+		tTextLayoutRowVec mvRows;
+		tTextLayoutGlyphVec mvGlyphs;
+	};
+
+	typedef std::list<cTextLayout> tTextLayoutList;
+	typedef tTextLayoutList::iterator tTextLayoutListIt;
+
+	typedef std::unordered_map<size_t, tTextLayoutListIt> tTextLayoutMap;
+	typedef tTextLayoutMap::iterator tTextLayoutMapIt;
+
+	//------------------------------------------------
+
 	class iFontData : public iResourceBase
 	{
 	public:
@@ -121,6 +187,24 @@ namespace hpl {
 		void GetWordWrapRows(float afLength,float afFontHeight,cVector2f avSize,const tWString& asString,
 								tWStringVec *apRowVec);
 
+		/**
+		 * Get the word wrapped rows and glyph positions of a string. Layouts are kept in a least recently used
+		 * cache keyed by the string, size and length, so calling this every frame with the same text does
+		 * not allocate anything.
+		 * \param afLength Max length of a row
+		 * \param avSize size of the characters
+		 * \param asString
+		 * \return The layout, valid until the next call on this font.
+		 */
+		const cTextLayout* GetWordWrapLayout(float afLength,const cVector2f& avSize,const tWString& asString);
+
+		void SetLayoutCacheSize(size_t alSize);
+		size_t GetLayoutCacheSize(){ return mlLayoutCacheSize;}
+		void ClearLayoutCache();
+
+		size_t GetLayoutCacheHits(){ return mlLayoutCacheHits;}
+		size_t GetLayoutCacheMisses(){ return mlLayoutCacheMisses;}
+
 		/**
 		 * Get height of the font.
 		 * \return
@@ -156,6 +240,15 @@ namespace hpl {
 
 		cVector2f mvSizeRatio;
 
+		tTextLayoutList mlstLayouts;
+		tTextLayoutMap m_mapLayouts;
+		size_t mlLayoutCacheSize;
+		size_t mlLayoutCacheHits;
+		size_t mlLayoutCacheMisses;
+
+		void BuildWordWrapLayout(cTextLayout *apLayout);
+		float GetRangeLength(const cVector2f& avSize,const tWString& asString, size_t alStart, size_t alEnd);
+
 		cGlyph* CreateGlyph(cFrameSubImage* apImage, const cVector2l &avOffset,const cVector2l &avSize,
 							const cVector2l& avFontSize, int alAdvance);
 		void AddGlyph(cGlyph *apGlyph);
@@ -0,0 +1,144 @@
+#pragma once
+
+#include "graphics/offsetAllocator.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace hpl {
+
+    /**
+     * Growable pool of elements (vertices or indices) split into chunks, each chunk has its own offset allocator.
+     * A chunk is added when a request does not fit and released again once it is empty, so the pool follows
+     * what is loaded instead of being sized for the worst map up front.
+     *
+     * Allocations are referred to by handle. Compaction empties a chunk a few allocations per update by moving
+     * them into the other chunks and pointing the handle at the new place, once the pool is mostly unused or
+     * has grown only because the free space was in pieces. The users only have to read the location through
+     * the handle when they use it. Freed and moved-from ranges stay reserved for a number of frames so the GPU
+     * can finish the frames that still read them.
+     *
+     * The storage is behind BackingStore, the pool logic does not touch any graphics api and can run on
+     * plain memory.
+     */
+    class GeometryPool final {
+    public:
+        using Handle = uint32_t;
+        static constexpr Handle InvalidHandle = UINT32_MAX;
+
+        class BackingStore {
+        public:
+            virtual ~BackingStore() = default;
+            // chunk indices are reused once a chunk is removed
+            virtual void addChunk(uint32_t chunk, uint32_t numElements) = 0;
+            virtual void removeChunk(uint32_t chunk) = 0;
+            // ranges never overlap, they are either in different chunks or both reserved in the same one
+            virtual void move(uint32_t srcChunk, uint32_t srcOffset, uint32_t dstChunk, uint32_t dstOffset, uint32_t numElements) = 0;
+        };
+
+        struct Config {
+            uint32_t m_chunkSize = 0; // elements, requests larger than this get a chunk of their own size
+            uint32_t m_maxChunks = 16;
+            uint32_t m_retireFrames = 0; // frames a freed range stays reserved
+            uint32_t m_moveBudget = 0; // elements moved per update, 0 turns compaction off
+            float m_compactOccupancy = 0.5f; // chunks are merged when less than this much of the pool is used
+        };
+
+        struct Stats {
+            uint32_t m_numChunks = 0;
+            uint32_t m_numAllocations = 0;
+            uint64_t m_capacity = 0;
+            uint64_t m_used = 0;
+            uint64_t m_retired = 0;
+            uint64_t m_free = 0;
+            uint32_t m_largestFreeRegion = 0;
+            float m_occupancy = 0.0f; // used / capacity
+            float m_fragmentation = 0.0f; // 1 - largest free region / free, 0 when all free space is one region
+
+            uint32_t m_numGrows = 0;
+            uint32_t m_numReleases = 0;
+            uint32_t m_numFailed = 0;
+            uint64_t m_movedElements = 0;
+        };
+
+        GeometryPool();
+        GeometryPool(const Config& config, BackingStore* store);
+        GeometryPool(GeometryPool&&) = default;
+        GeometryPool(const GeometryPool&) = delete;
+        ~GeometryPool();
+
+        GeometryPool& operator=(GeometryPool&&) = default;
+        GeometryPool& operator=(const GeometryPool&) = delete;
+
+        // returns InvalidHandle if the pool is at its max chunks and nothing fits
+        Handle allocate(uint32_t numElements);
+        void free(Handle handle);
+
+        uint32_t chunk(Handle handle) const { return m_slots[handle].m_chunk; }
+        uint32_t offset(Handle handle) const { return m_slots[handle].m_allocation.offset; }
+        uint32_t size(Handle handle) const { return m_slots[handle].m_size; }
+
+        /**
+         * Call once per frame. Frees the ranges whose frames are done, releases empty chunks and
+         * moves up to m_moveBudget elements out of the chunk that is being compacted.
+         */
+        void update(uint64_t frame);
+        // moves everything out of fragmented chunks right away, eg while loading
+        void compactAll();
+
+        Stats stats() const;
+        uint32_t chunkCapacity(uint32_t chunk) const { return m_chunks[chunk].m_capacity; }
+        bool isChunkActive(uint32_t chunk) const { return chunk < m_chunks.size() && m_chunks[chunk].m_allocator != nullptr; }
+        uint32_t numChunkSlots() const { return static_cast<uint32_t>(m_chunks.size()); }
+
+    private:
+        struct Chunk {
+            std::unique_ptr<OffsetAllocator::Allocator> m_allocator;
+            uint32_t m_capacity = 0;
+            uint32_t m_used = 0;
+            uint32_t m_retired = 0;
+            uint32_t m_numAllocations = 0;
+            bool m_isDraining = false; // evacuated, only used when nothing else fits until it is released
+        };
+        struct Slot {
+            OffsetAllocator::Allocation m_allocation;
+            uint32_t m_chunk = 0;
+            uint32_t m_size = 0;
+            bool m_isAlive = false;
+        };
+        struct RetiredRange {
+            OffsetAllocator::Allocation m_allocation;
+            uint32_t m_chunk;
+            uint32_t m_size;
+            uint64_t m_frame;
+        };
+
+        bool allocateInChunks(uint32_t numElements, uint32_t skipChunk, bool mayGrow, uint32_t& chunk, OffsetAllocator::Allocation& allocation);
+        uint32_t addChunk(uint32_t numElements);
+        void retire(uint32_t chunk, const OffsetAllocator::Allocation& allocation, uint32_t size);
+        void releaseRetired(bool all);
+        void releaseEmptyChunks();
+        uint32_t findEvacuateChunk() const;
+        uint32_t evacuate(uint32_t budget);
+
+        Config m_config;
+        BackingStore* m_store = nullptr;
+        std::vector<Chunk> m_chunks;
+        std::vector<Slot> m_slots;
+        std::vector<Handle> m_freeSlots;
+        std::vector<RetiredRange> m_retired;
+
+        bool m_isFragmented = false; // grown while there was enough free space in total
+        uint32_t m_evacuateChunk = UINT32_MAX;
+        std::vector<Handle> m_evacuateHandles;
+        size_t m_evacuateCursor = 0;
+
+        uint64_t m_frame = 0;
+        uint32_t m_numGrows = 0;
+        uint32_t m_numReleases = 0;
+        uint32_t m_numFailed = 0;
+        uint64_t m_movedElements = 0;
+    };
+
+} // namespace hpl
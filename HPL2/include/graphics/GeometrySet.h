@@ -2,12 +2,15 @@
 
 #include "graphics/ForgeHandles.h"
 #include "graphics/ForgeRenderer.h"
-#include "graphics/offsetAllocator.h"
+#include "graphics/GeometryPool.h"
 
 #include "Common_3/Graphics/Interfaces/IGraphics.h"
 #include "Common_3/Utilities/RingBuffer.h"
 #include <folly/small_vector.h>
 
+#include <memory>
+#include <vector>
+
 namespace hpl {
 
     class GeometrySet final {
@@ -39,6 +42,30 @@ namespace hpl {
             friend class GeometrySet;
         };
 
+        /**
+         * The streams of every chunk of a pool, buffers are created and released as the pool grows and shrinks.
+         * Buffers are persistently mapped so compaction can copy between chunks right away on the cpu, any
+         * later write to the allocation then goes to the new place.
+         */
+        class ChunkStore final : public GeometryPool::BackingStore {
+        public:
+            ChunkStore(DescriptorType descriptors, std::span<GeometryStreamDesc> streamDesc);
+
+            void addChunk(uint32_t chunk, uint32_t numElements) override;
+            void removeChunk(uint32_t chunk) override;
+            void move(uint32_t srcChunk, uint32_t srcOffset, uint32_t dstChunk, uint32_t dstOffset, uint32_t numElements) override;
+
+            inline std::span<GeometryStream> streams(uint32_t chunk) { return m_chunks[chunk]; }
+        private:
+            DescriptorType m_descriptors;
+            folly::small_vector<GeometryStreamDesc, 15> m_streamDesc;
+            std::vector<folly::small_vector<GeometryStream, 15>> m_chunks;
+        };
+
+        /**
+         * Vertices and indices of one user of the set. Compaction can move them to another chunk between
+         * frames, so always look up the buffers and offsets when binding or writing instead of keeping them.
+         */
         class GeometrySetSubAllocation final {
         public:
             ~GeometrySetSubAllocation();
@@ -49,15 +76,19 @@ namespace hpl {
             void operator=(GeometrySetSubAllocation&& allocation);
             void operator=(const GeometrySetSubAllocation& allocation) = delete;
 
-            inline SharedBuffer& indexBuffer() { return m_geometrySet->m_indexBuffer; }
-            inline std::span<GeometryStream> vertexStreams() { return m_geometrySet->m_vertexStreams; }
-            inline std::span<GeometryStream>::iterator getStreamBySemantic(ShaderSemantic semantic) {return m_geometrySet->getStreamBySemantic(semantic);}
-            inline uint32_t vertexOffset() { return m_vertexAllocation.offset; }
-            inline uint32_t indexOffset() { return m_indexAllocation.offset; }
+            inline SharedBuffer& indexBuffer() { return m_geometrySet->indexBuffer(indexChunk()); }
+            inline std::span<GeometryStream> vertexStreams() { return m_geometrySet->vertexStreams(vertexChunk()); }
+            inline std::span<GeometryStream>::iterator getStreamBySemantic(ShaderSemantic semantic) {return m_geometrySet->getStreamBySemantic(vertexChunk(), semantic);}
+            inline uint32_t vertexOffset() { return m_geometrySet->m_vertexPool.offset(m_vertexHandle); }
+            inline uint32_t indexOffset() { return m_geometrySet->m_indexPool.offset(m_indexHandle); }
+            inline uint32_t vertexChunk() { return m_geometrySet->m_vertexPool.chunk(m_vertexHandle); }
+            inline uint32_t indexChunk() { return m_geometrySet->m_indexPool.chunk(m_indexHandle); }
 
         private:
-            OffsetAllocator::Allocation m_vertexAllocation;
-            OffsetAllocator::Allocation m_indexAllocation;
+            void release();
+
+            GeometryPool::Handle m_vertexHandle = GeometryPool::InvalidHandle;
+            GeometryPool::Handle m_indexHandle = GeometryPool::InvalidHandle;
             GeometrySet* m_geometrySet = nullptr;
             friend class GeometrySet;
         };
@@ -65,24 +96,30 @@ namespace hpl {
         GeometrySet(GeometrySet&& set);
         GeometrySet(const GeometrySet& set) = delete;
         GeometrySet();
-        explicit GeometrySet(uint32_t numElements, uint32_t numIndecies, std::span<GeometryStreamDesc> stream);
-        void cmdBindGeometrySet(Cmd* cmd, std::span<ShaderSemantic> semantics);
+        explicit GeometrySet(const GeometryPool::Config& vertexConfig, const GeometryPool::Config& indexConfig, std::span<GeometryStreamDesc> stream);
+        void cmdBindGeometrySet(Cmd* cmd, uint32_t vertexChunk, uint32_t indexChunk, std::span<ShaderSemantic> semantics);
 
-        inline std::span<GeometryStream> vertexStreams() { return m_vertexStreams; }
-        inline std::span<GeometryStream>::iterator getStreamBySemantic(ShaderSemantic semantic) {
-            return std::find_if(vertexStreams().begin(), vertexStreams().end(), [&](auto& stream) {
+        inline std::span<GeometryStream> vertexStreams(uint32_t chunk) { return m_vertexStore->streams(chunk); }
+        inline std::span<GeometryStream>::iterator getStreamBySemantic(uint32_t chunk, ShaderSemantic semantic) {
+            auto streams = vertexStreams(chunk);
+            return std::find_if(streams.begin(), streams.end(), [&](auto& stream) {
                 return stream.m_semantic == semantic;
             });
         }
-        inline SharedBuffer& indexBuffer() { return m_indexBuffer; }
+        inline SharedBuffer& indexBuffer(uint32_t chunk) { return m_indexStore->streams(chunk)[0].m_buffer; }
         void operator=(GeometrySet&& set);
         void operator=(const GeometrySet& set) = delete;
         std::shared_ptr<GeometrySet::GeometrySetSubAllocation> allocate(uint32_t numElements, uint32_t numIndecies);
+
+        // once per frame, releases what the gpu is done with and compacts a little
+        void update(uint64_t frame);
+        inline GeometryPool::Stats vertexStats() const { return m_vertexPool.stats(); }
+        inline GeometryPool::Stats indexStats() const { return m_indexPool.stats(); }
     private:
-        OffsetAllocator::Allocator m_vertexStreamAllocator;
-        OffsetAllocator::Allocator m_indexStreamAllocator;
-        folly::small_vector<GeometryStream, 15> m_vertexStreams;
-        SharedBuffer m_indexBuffer;
+        std::unique_ptr<ChunkStore> m_vertexStore;
+        std::unique_ptr<ChunkStore> m_indexStore;
+        GeometryPool m_vertexPool;
+        GeometryPool m_indexPool;
         friend class GeometryStream;
     };
 }
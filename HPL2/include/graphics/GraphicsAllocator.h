@@ -24,11 +24,18 @@ namespace hpl {
 
         GraphicsAllocator(ForgeRenderer* renderer);
 
-        static constexpr uint32_t OpaqueVertexBufferSize = 6000000;
-        static constexpr uint32_t OpaqueIndexBufferSize =  3000000;
+        // the geometry sets start with one chunk and grow a chunk at a time up to the max
+        static constexpr uint32_t OpaqueVertexChunkSize = 3000000;
+        static constexpr uint32_t OpaqueIndexChunkSize =  1500000;
+        static constexpr uint32_t OpaqueMaxChunks = 8;
 
-        static constexpr uint32_t ParticleVertexBufferSize = 61440;
-        static constexpr uint32_t ParticleIndexBufferSize = 61440;
+        static constexpr uint32_t ParticleVertexChunkSize = 61440;
+        static constexpr uint32_t ParticleIndexChunkSize = 61440;
+        static constexpr uint32_t ParticleMaxChunks = 8;
+
+        // elements compaction moves per frame, reading back from mapped buffers is slow so keep it small
+        static constexpr uint32_t VertexMoveBudget = 8192;
+        static constexpr uint32_t IndexMoveBudget = 16384;
 
         static constexpr uint32_t ImmediateVertexBufferSize = hpl::Math::BYTE_MB * 30;
         static constexpr uint32_t ImmediateIndexBufferSize =  hpl::Math::BYTE_MB * 15;
@@ -36,6 +43,11 @@ namespace hpl {
         GPURingBufferOffset allocTransientVertexBuffer(uint32_t size);
         GPURingBufferOffset allocTransientIndexBuffer(uint32_t size);
         GeometrySet& resolveSet(AllocationSet set);
+
+        // once per frame after the frame has been started
+        void Update(uint64_t frame);
+        GeometryPool::Stats vertexStats(AllocationSet set) const;
+        GeometryPool::Stats indexStats(AllocationSet set) const;
     private:
         std::array<GeometrySet, NumOfAllocationSets> m_geometrySets;
 
@@ -74,6 +74,9 @@ namespace hpl {
             return cVector2l(0, 0);
         }
 
+        // bytes of all mips and array slices of the texture
+        size_t GetMemorySize() const;
+
         inline SharedTexture& GetTexture() {
             return m_texture;
         }
@@ -119,6 +119,7 @@ namespace hpl {
 
 	class cMaterial : public iResourceBase {
 	friend class iMaterialType;
+	friend class cMaterialUvAnimationTable;
 	public:
         static constexpr uint32_t MaxMaterialID = 2048;
         static constexpr uint32_t MaxParticleMaterialID = 1024;
@@ -201,6 +202,10 @@ namespace hpl {
 		cMaterialUvAnimation *GetUvAnimation(int alIdx){ return &mvUvAnimations[alIdx]; }
 		inline const cMatrixf& GetUvMatrix() const { return m_mtxUV;}
 		void ClearUvAnimations();
+		/**
+		 * The uv matrix the animations give afTime seconds after they started, built from full matrices.
+		 */
+		cMatrixf GetUvMatrixAtTime(float afTime) const;
 
         // we want to build a derived state from the matera information
         // decouples the state managment to work on forward++ model
@@ -244,11 +249,61 @@ namespace hpl {
 		tString msPhysicsMaterial;
 
 		uint32_t m_generation = 0; // used to check if the material has changed since last frame
-		float mfAnimTime = 0;
+		int mlUvAnimationSlot = -1;
 		int mlRenderFrameCount = -1;
 
 		bool mbAutoDestroyTextures = true;
 		bool mbDepthTest = true;
 	};
 
+	/**
+	 * The uv animations of all materials in one table, evaluated together the first time a material is updated
+	 * in a render frame. Animations that stay in the uv plane, moving along X or Y and rotating around Z, are
+	 * done as 2D affine transforms in flat arrays, with sines and cosines only for the animations that need them. Materials with any other animation use GetUvMatrixAtTime.
+	 * The uv matrix goes to the per object data, so the material generation is left as it is.
+	 */
+	class cMaterialUvAnimationTable final
+	{
+	public:
+		static void Add(cMaterial *apMaterial);
+		static void Remove(cMaterial *apMaterial);
+		static void SetChanged(){ mbCompiled = false;}
+
+		/**
+		 * Evaluates all animations, once per alRenderFrame. The animation time then moves on by afTimeStep.
+		 */
+		static void Update(int alRenderFrame, float afTimeStep);
+
+		static int GetMaterialNum(){ return (int)mvMaterials.size();}
+		static int GetPlanarMaterialNum(){ return mlPlanarMaterials;}
+		static int GetChangedNum(){ return mlChangedNum;}
+
+	private:
+		static void Compile();
+
+		static std::vector<cMaterial*> mvMaterials;
+		static std::vector<double> mvStartTime;
+		static double mfTime;
+		static int mlLastRenderFrame;
+		static bool mbCompiled;
+		static int mlPlanarMaterials;
+		static int mlChangedNum;
+
+		// Set up by Compile, the slots of the materials done in 2D and of the ones done with matrices
+		static std::vector<uint32_t> mvPlanarSlots;
+		static std::vector<uint32_t> mvMatrixSlots;
+		static std::vector<uint32_t> mvPlanarFirstAnim;
+		static std::vector<float> mvLocalTime;
+
+		// Per animation of the planar materials
+		static std::vector<uint32_t> mvAnimMaterial;
+		static std::vector<float> mvAnimSpeed;
+		static std::vector<float> mvAnimAmp;
+		static std::vector<float> mvAnimDirU;
+		static std::vector<float> mvAnimDirV;
+		static std::vector<float> mvAnimAffine[6];
+		static std::vector<uint32_t> mvSinAnims;
+		static std::vector<uint32_t> mvRotateAnims;
+	};
+
 };
@@ -5,6 +5,7 @@
 #include <cstdint>
 #include <functional>
 #include <variant>
+#include <vector>
 
 #include "Common_3/Utilities/Math/MathTypes.h"
 #include "FixPreprocessor.h"
@@ -15,6 +16,21 @@ namespace hpl::MeshUtility {
         uint32_t numIndices;
     };
 
+    struct VertexCacheStats {
+        float acmr = 0.0f; // vertices transformed per triangle
+        float atvr = 0.0f; // vertices transformed per vertex used
+    };
+
+    // bytes per vertex with every stream as floats and quantized, and the largest error quantizing adds
+    struct QuantizationStats {
+        uint32_t floatVertexSize = 0;
+        uint32_t quantizedVertexSize = 0;
+        float maxPositionError = 0.0f;
+        float maxNormalError = 0.0f; // degrees
+        float maxTangentError = 0.0f; // degrees
+        float maxUVError = 0.0f;
+    };
+
     // for create might have to offset the indecies
     //void OffsetIndecies(uint32_t vtxOffset, uint32_t numIndecies, AssetBuffer::BufferIndexView* index);
 
@@ -111,6 +127,45 @@ namespace hpl::MeshUtility {
         GraphicsBuffer::BufferStructuredView<float3>* normal,
         GraphicsBuffer::BufferStructuredView<float2>* uv,
         std::variant<GraphicsBuffer::BufferStructuredView<float3>*, GraphicsBuffer::BufferStructuredView<float4>*> tangent);
-}
 
+    // reorders the triangles so vertices are reused while still in the post transform cache (Forsyth's linear speed optimizer)
+    void OptimizeVertexCache(
+        uint32_t numVerts,
+        uint32_t numIndecies,
+        GraphicsBuffer::BufferIndexView* index);
+
+    // renumbers the vertices in the order the indices first use them, so vertex fetches move forward through memory.
+    // returns the new index of every vertex, unused vertices are moved last. the vertex streams are not touched.
+    std::vector<uint32_t> OptimizeVertexFetch(
+        uint32_t numVerts,
+        uint32_t numIndecies,
+        GraphicsBuffer::BufferIndexView* index);
 
+    // simulates a FIFO post transform cache with cacheSize entries
+    VertexCacheStats AnalyzeVertexCache(
+        uint32_t numVerts,
+        uint32_t numIndecies,
+        GraphicsBuffer::BufferIndexView* index,
+        uint32_t cacheSize = 16);
+
+    // bytes read through a small cache of 64 byte lines for every transformed vertex, divided by the size of the used vertices.
+    // 1.0 means every byte is read once.
+    float AnalyzeVertexFetch(
+        uint32_t numVerts,
+        uint32_t numIndecies,
+        GraphicsBuffer::BufferIndexView* index,
+        uint32_t vertexSize);
+
+    // positions as 16 bit values normalized to the bounds, normals and tangents octahedral 16 bit, uvs as halfs
+    QuantizationStats AnalyzeQuantization(
+        uint32_t numVerts,
+        GraphicsBuffer::BufferStructuredView<float3>* position,
+        GraphicsBuffer::BufferStructuredView<float3>* normal,
+        GraphicsBuffer::BufferStructuredView<float3>* tangent,
+        GraphicsBuffer::BufferStructuredView<float2>* uv);
+
+    uint32_t EncodeOctahedral(const float3& normal);
+    float3 DecodeOctahedral(uint32_t encoded);
+    uint16_t EncodeHalf(float value);
+    float DecodeHalf(uint16_t value);
+}
@@ -42,6 +42,7 @@ namespace hpl {
     class iCollideShape;
 
     class cMaterialManager;
+    class cTriangleBVH;
 
     class cSubMesh final {
         friend class cMesh;
@@ -191,6 +192,8 @@ namespace hpl {
         // Renderable implementation.
         cMaterial* GetMaterial();
         iVertexBuffer* GetVertexBuffer();
+        // Triangle tree over the vertex buffer, built the first time it is asked for.
+        cTriangleBVH* GetTriangleBVH();
 
         const tString& GetName() {
             return m_name;
@@ -261,6 +264,9 @@ namespace hpl {
 
         bool hasMesh();
         void SetStreamBuffers(iVertexBuffer* buffer, std::vector<StreamBufferInfo>&& vertexStreams, IndexBufferInfo&& indexStream);
+        // Reorders the triangles for the post transform cache and the vertices in the order they are used,
+        // the vertex bone pairs and the vertex buffer are updated to match.
+        void OptimizeVertexOrder();
         void Compile();
     private:
 
@@ -270,6 +276,7 @@ namespace hpl {
         tString m_materialName;
         cMaterial* m_material = nullptr;
         iVertexBuffer* m_vtxBuffer = nullptr;
+        cTriangleBVH* m_triangleBVH = nullptr;
 
         cMatrixf m_mtxLocalTransform = cMatrixf::Identity;
 
@@ -0,0 +1,74 @@
+/*
+ * Copyright © 2009-2020 Frictional Games
+ *
+ * This file is part of Amnesia: The Dark Descent.
+ *
+ * Amnesia: The Dark Descent is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * Amnesia: The Dark Descent is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Amnesia: The Dark Descent.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef HPL_TRIANGLE_BVH_H
+#define HPL_TRIANGLE_BVH_H
+
+#include "math/MathTypes.h"
+#include "system/SystemTypes.h"
+
+namespace hpl {
+
+	//----------------------------------------------
+
+	/**
+	 * Bounding volume hierarchy over the triangles of an indexed mesh, in the local space of the mesh.
+	 * Used to find the triangles near a volume without going through the entire mesh, eg when clipping decals.
+	 */
+	class cTriangleBVH
+	{
+	public:
+		cTriangleBVH();
+
+		/**
+		 * Builds the tree, the positions and indices are not kept. alPosStride is the number of floats per vertex.
+		 */
+		void Build(const float *apPositions, int alPosStride, const unsigned int *apIndices, int alIndexNum);
+
+		/**
+		 * Gets the triangles whose bounds are not entirely behind any of the planes. Triangle i uses
+		 * indices 3*i to 3*i+2. The result is sorted, so the triangles come in the same order as in the mesh.
+		 */
+		void FindTriangles(const cPlanef *apPlanes, int alPlaneNum, tIntVec& avTriangles) const;
+
+		int GetTriangleNum() const { return (int)mvTriangles.size(); }
+		int GetNodeNum() const { return (int)mvNodes.size(); }
+
+	private:
+		class cNode
+		{
+		public:
+			cVector3f mvMin;
+			cVector3f mvMax;
+			//Leaf: first triangle in mvTriangles, Node: index of the second child, the first is the next node.
+			int mlFirst;
+			//Number of triangles if a leaf, 0 if a node.
+			int mlCount;
+		};
+
+		void BuildNode(int alFirst, int alCount, const tVector3fVec& avTriMin, const tVector3fVec& avTriMax, const tVector3fVec& avCentroids);
+
+		std::vector<cNode> mvNodes;
+		tIntVec mvTriangles;
+	};
+
+	//----------------------------------------------
+
+};
+#endif // HPL_TRIANGLE_BVH_H
@@ -19,6 +19,7 @@
 #pragma once
 
 #include <list>
+#include <vector>
 #include "gui/GuiTypes.h"
 
 #include "graphics/GraphicsTypes.h"
@@ -40,13 +41,16 @@ namespace hpl {
 	class cScene;
 
 	class cFrustum;
+	class Image;
 	class iFontData;
+	class cTextLayout;
 
 	class cGui;
 	class cGuiSkin;
 	class iGuiMaterial;
 	class iGuiPopUp;
 	class iWidget;
+	class iTimer;
 
 	class cWidgetWindow;
 	class cWidgetFrame;
@@ -99,14 +103,24 @@ namespace hpl {
 		cVector3f mvPivot;
 	};
 
-	class cGuiRenderObjectCompare
+	typedef std::vector<cGuiRenderObject> tGuiRenderObjectVec;
+	typedef tGuiRenderObjectVec::iterator tGuiRenderObjectVecIt;
+
+	//-----------------------------------------------
+
+	class cGuiSetDrawStats
 	{
 	public:
-		bool operator()(const cGuiRenderObject& aObjectA, const cGuiRenderObject& aObjectB) const;
-	};
+		cGuiSetDrawStats() : mlFrames(0), mlRenderObjects(0), mlCachedRenderObjects(0), mlDrawCalls(0), mfBuildTime(0), mfRenderTime(0)
+		{}
 
-	typedef std::multiset<cGuiRenderObject,cGuiRenderObjectCompare> tGuiRenderObjectSet;
-	typedef tGuiRenderObjectSet::iterator tGuiRenderObjectSetIt;
+		int mlFrames;
+		int mlRenderObjects;
+		int mlCachedRenderObjects;	// Render objects replayed from widget draw caches
+		int mlDrawCalls;
+		double mfBuildTime;		// Milliseconds spent creating render objects in DrawAll and DrawFont
+		double mfRenderTime;	// Milliseconds spent sorting and writing vertices in Draw
+	};
 
 	//-----------------------------------------------
 
@@ -116,15 +130,18 @@ namespace hpl {
 	class cGuiClipRegion
 	{
 	public:
-		cGuiClipRegion() : mRect(0,0,-1,-1){}
+		cGuiClipRegion() : mRect(0,0,-1,-1), mlDrawFrame(-1), mlDrawId(0){}
 		~cGuiClipRegion();
 
 		void Clear();
 		cGuiClipRegion* CreateChild(const cVector3f &avPos, const cVector2f &avSize);
 
-		//tGuiRenderObjectSet m_setObjects;
 		cRect2f mRect;
 
+		//Id used in the render object sort key, only valid during the frame it was set.
+		int mlDrawFrame;
+		int mlDrawId;
+
 		tGuiClipRegionList mlstChildren;
 	};
 
@@ -224,6 +241,34 @@ namespace hpl {
 						const cVector2f &avSize, const cColor& aColor,
 						const wchar_t* fmt,...);
 
+		/**
+		 * Draws a row from a layout created by iFontData::GetWordWrapLayout.
+		 * \param alMaxChars If >= 0, only the glyphs of the first alMaxChars characters in the row are drawn.
+		 */
+		void DrawTextLayoutRow(	const cTextLayout *apLayout, size_t alRow,
+								const cVector3f &avPos, const cColor& aColor,
+								eFontAlign aAlign = eFontAlign_Left,
+								eGuiMaterial aMaterial = eGuiMaterial_FontNormal,
+								int alMaxChars=-1);
+
+		/**
+		 * Draws all rows of a layout, afRowHeight apart.
+		 */
+		void DrawTextLayout(const cTextLayout *apLayout,
+							const cVector3f &avPos, float afRowHeight, const cColor& aColor,
+							eFontAlign aAlign = eFontAlign_Left,
+							eGuiMaterial aMaterial = eGuiMaterial_FontNormal);
+
+		/**
+		 * Adds render objects saved from an earlier frame, the clip region is replaced by the one given.
+		 */
+		void AddRenderObjects(const tGuiRenderObjectVec& avObjects, cGuiClipRegion *apClipRegion);
+		size_t GetRenderObjectNum(){ return mvRenderObjects.size();}
+		const cGuiRenderObject& GetRenderObject(size_t alIdx){ return mvRenderObjects[alIdx];}
+
+		void ResetDrawStats(){ mDrawStats = cGuiSetDrawStats();}
+		const cGuiSetDrawStats& GetDrawStats(){ return mDrawStats;}
+
 		////////////////////////////////////
 		// Widget Creation
 		cWidgetWindow* CreateWidgetWindow(	tWidgetWindowButtonFlag alFlags=eWidgetWindowButtonFlag_None,
@@ -482,12 +527,30 @@ namespace hpl {
 
 		bool GetDrawFocus() { return mbDrawFocus; }
 
+		/**
+		 * The key render objects are sorted on. Lower z is drawn first. At equal z objects are drawn by clip
+		 * region in the order the regions were first used, then by material and texture, both descending as the
+		 * render object set was sorted before the keys.
+		 */
+		static uint64_t GetRenderObjectKey(float afZ, int alClipId, eGuiMaterial aMaterial, const Image* apTexture);
+		/**
+		 * Fills avSorted with the indices of avKeys in ascending key order. Equal keys keep their order.
+		 */
+		static void SortRenderObjectKeys(	const std::vector<uint64_t>& avKeys, std::vector<uint32_t>& avSorted,
+											std::vector<uint32_t>& avTemp);
+
 	private:
 		void DrawTextFromCharArry(	const wchar_t* apString, iFontData *apFont,
 									const cVector2f& avSize, const cVector3f& avPosition,
 									const cColor& aColor, eGuiMaterial aMaterial,
 									eFontAlign aAlign);
 
+		void AddRenderObject(const cGuiRenderObject& aObject);
+		void SortRenderObjects();
+
+		void StartBuildTimer();
+		void StopBuildTimer();
+
 
 		void AddWidget(iWidget *apWidget,iWidget *apParent);
 
@@ -543,7 +606,18 @@ namespace hpl {
 		iWidget* mpWidgetRoot;
 		tWidgetList mlstWidgets;
 
-		tGuiRenderObjectSet m_setRenderObjects;
+		//Render objects are appended during the frame and sorted once in Draw using the key.
+		tGuiRenderObjectVec mvRenderObjects;
+		std::vector<uint64_t> mvRenderObjectKeys;
+		std::vector<uint32_t> mvSortedRenderObjects;
+		std::vector<uint32_t> mvSortTemp;
+		int mlDrawFrameCount;
+		int mlClipRegionDrawIdCount;
+
+		cGuiSetDrawStats mDrawStats;
+		iTimer *mpBuildTimer;
+		iTimer *mpRenderTimer;
+		int mlBuildTimerDepth;
 
 		int mlPopupCount;
 		float mfLastPopUpZ;
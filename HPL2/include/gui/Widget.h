@@ -34,6 +34,7 @@ namespace hpl {
 
 	class cGuiGfxElement;
 	class cGuiClipRegion;
+	class cGuiRenderObject;
 
 	class cGuiGlobalShortcut;
 
@@ -121,15 +122,15 @@ namespace hpl {
 		const tWString& GetText()const{ return msText; }
 
 		iFontData *GetDefaultFontType(){ return mpDefaultFontType;}
-		virtual void SetDefaultFontType(iFontData *apFont){ mpDefaultFontType = apFont;}
+		virtual void SetDefaultFontType(iFontData *apFont){ mpDefaultFontType = apFont; mbDrawCacheDirty = true;}
 
 		const cColor& GetDefaultFontColor(){ return mDefaultFontColor;}
-		virtual void SetDefaultFontColor(const cColor& aColor){ mDefaultFontColor = aColor;}
+		virtual void SetDefaultFontColor(const cColor& aColor){ mDefaultFontColor = aColor; mbDrawCacheDirty = true;}
 
 		const cVector2f& GetDefaultFontSize(){ return mvDefaultFontSize;}
-		virtual void SetDefaultFontSize(const cVector2f& avSize){ mvDefaultFontSize = avSize;}
+		virtual void SetDefaultFontSize(const cVector2f& avSize){ mvDefaultFontSize = avSize; mbDrawCacheDirty = true;}
 
-		void SetClipActive(bool abX){ mbClipsGraphics = abX;}
+		void SetClipActive(bool abX){ mbClipsGraphics = abX; mbDrawCacheDirty = true;}
 		bool GetClipActive(){ return mbClipsGraphics;}
 
 		void SetPosition(const cVector3f &avPos);
@@ -263,6 +264,14 @@ namespace hpl {
 
 		void LoadGraphics();
 
+		/**
+		 * Widgets that draw the same thing every frame can keep the render objects from OnDraw and reuse
+		 * them until something changes. Position, size, color, enabled state, text and clip rect are
+		 * checked here, anything else that changes the output must call SetDrawCacheDirty.
+		 */
+		void SetDrawCacheActive(bool abX);
+		void SetDrawCacheDirty(){ mbDrawCacheDirty = true;}
+
 		/////////////////////////
 		// Variables
 		cGuiSet *mpSet;
@@ -323,6 +332,8 @@ namespace hpl {
 
 		int UIArrowToArrayPos(eUIArrow aDir);
 
+		void DrawWithCache(float afTimeStep, cGuiClipRegion *apClipRegion);
+
         std::vector<tWidgetCallbackList> mvCallbackLists;
 
 		bool mbPositionIsUpdated;
@@ -331,6 +342,15 @@ namespace hpl {
 		int mlUserValue;
 
 		std::vector<iWidget*>			mvFocusNavWidgets;
+
+		bool mbDrawCacheActive;
+		bool mbDrawCacheDirty;
+		std::vector<cGuiRenderObject> mvDrawCache;
+		cVector3f mvDrawCachePosition;
+		cVector2f mvDrawCacheSize;
+		cColor mDrawCacheColorMul;
+		bool mbDrawCacheEnabled;
+		cRect2f mDrawCacheClipRect;
 	};
 
 };
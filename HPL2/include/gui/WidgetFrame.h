@@ -33,7 +33,7 @@ namespace hpl {
 		cWidgetFrame(cGuiSet *apSet, cGuiSkin *apSkin, bool abHScrollBar=false, bool abVScrollBar=false);
 		virtual ~cWidgetFrame();
 
-		void SetDrawFrame(bool abX){ mbDrawFrame = abX;}
+		void SetDrawFrame(bool abX){ mbDrawFrame = abX; SetDrawCacheDirty();}
 		bool GetDrawFrame(){ return mbDrawFrame;}
 
 		void SetDrawBackground(bool abX){mbDrawBackground = abX;}
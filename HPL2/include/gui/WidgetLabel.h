@@ -32,11 +32,11 @@ namespace hpl {
 		cWidgetLabel(cGuiSet *apSet, cGuiSkin *apSkin);
 		virtual ~cWidgetLabel();
 
-		void SetTextAlign(eFontAlign aType){mTextAlign = aType;}
+		void SetTextAlign(eFontAlign aType){mTextAlign = aType; SetDrawCacheDirty();}
 		eFontAlign GetTextAlign(){ return mTextAlign;}
 
 		bool GetWordWrap(){ return mbWordWrap;}
-		void SetWordWrap(bool abX){ mbWordWrap = abX;}
+		void SetWordWrap(bool abX){ mbWordWrap = abX; SetDrawCacheDirty();}
 
 		void SetMaxTextLength(int alLength);
 		int GetMaxTextLength(){return mlMaxCharacters;}
@@ -46,16 +46,16 @@ namespace hpl {
 
 		void SetDefaultFontSize(const cVector2f& avSize);
 
-		void SetDrawBackGround(bool abX) { mbDrawBackGround = abX; }
+		void SetDrawBackGround(bool abX) { mbDrawBackGround = abX; SetDrawCacheDirty(); }
 		bool GetDrawBackGround() { return mbDrawBackGround; }
 
-		void SetBackGroundColor(const cColor &aColor){ mBackGroundColor = aColor;}
+		void SetBackGroundColor(const cColor &aColor){ mBackGroundColor = aColor; SetDrawCacheDirty();}
 		const cColor& GetBackGroundColor(){ return mBackGroundColor;}
 
 		void SetScrollWaitTime(float afX) { mfWaitToScrollTime = afX; }
 		float GetScrollWaitTime() { return mfWaitToScrollTime; }
 
-		void SetScrollOffset(float afX) { mfWordWrapOffset = afX; }
+		void SetScrollOffset(float afX) { mfWordWrapOffset = afX; SetDrawCacheDirty(); }
 
 		void SetScrollSpeedMul(float afX) { mfScrollSpeedMul = afX; }
 		float GetScrollSpeedMul() { return mfScrollSpeedMul; }
@@ -31,6 +31,7 @@
 #include "system/PreprocessParser.h"
 #include "system/Platform.h"
 #include "system/SHA1.h"
+#include "system/WildcardNameIndex.h"
 
 #include "input/Input.h"
 #include "input/InputDevice.h"
@@ -96,6 +97,7 @@
 #include "resources/ScriptManager.h"
 #include "resources/TextureManager.h"
 #include "resources/MaterialManager.h"
+#include "resources/MaterialDatabase.h"
 #include "resources/MeshManager.h"
 #include "resources/MeshLoaderHandler.h"
 #include "resources/SoundEntityManager.h"
@@ -108,11 +110,13 @@
 #include "resources/ConfigFile.h"
 #include "resources/BinaryBuffer.h"
 #include "resources/EntityLoader_Object.h"
+#include "resources/EntityPrototype.h"
 #include "resources/XmlDocument.h"
 #include "resources/WorldLoader.h"
 #include "resources/WorldLoaderHandler.h"
 #include "resources/EngineFileLoading.h"
 #include "resources/LanguageFile.h"
+#include "resources/MapPreloader.h"
 
 #include "scene/Scene.h"
 #include "scene/Viewport.h"
@@ -160,6 +164,7 @@
 #include "physics/PhysicsJointSlider.h"
 #include "physics/SurfaceData.h"
 #include "physics/PhysicsRope.h"
+#include "physics/PhysicsTriggerVolume.h"
 
 #include "ai/AI.h"
 #include "ai/AStar.h"
@@ -0,0 +1,42 @@
+#ifndef HPL_BITMAP_LOADER_DDS_H
+#define HPL_BITMAP_LOADER_DDS_H
+
+#include "resources/BitmapLoader.h"
+
+#include <cstdio>
+
+namespace hpl {
+
+	class cBitmapLoaderDevilDDS;
+
+	/**
+	 * Reads DDS files directly without going through DevIL. The loader keeps no state between
+	 * calls so several bitmaps can be decoded at the same time from different threads.
+	 * Files using a layout that is not handled here (DX10 header, partial cube maps, uncommon
+	 * pixel formats) are passed on to the DevIL loader, which is serialized.
+	 */
+	class cBitmapLoaderDDS : public iBitmapLoader
+	{
+	public:
+		cBitmapLoaderDDS();
+		~cBitmapLoaderDDS();
+
+		cBitmap* LoadBitmap(const tWString& asFile, tBitmapLoadFlag aFlags);
+		bool SaveBitmap(cBitmap* apBitmap,const tWString& asFile, tBitmapSaveFlag aFlags);
+
+	private:
+		struct cDDSFormat
+		{
+			ePixelFormat mPixelFormat;
+			int mlBytesPerPixel;
+			int mlBlockSize;	//Size of a 4x4 block, 0 if not compressed.
+		};
+
+		bool ReadHeader(FILE *apFile, cVector3l& avSize, int& alNumOfImages, int& alNumOfMipMaps, cDDSFormat& aFormat);
+		int GetMipMapSize(const cVector3l& avSize, int alMipMap, const cDDSFormat& aFormat);
+
+		cBitmapLoaderDevilDDS *mpFallbackLoader;
+	};
+
+};
+#endif // HPL_BITMAP_LOADER_DDS_H
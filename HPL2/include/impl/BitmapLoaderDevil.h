@@ -24,6 +24,8 @@
 
 #include <IL/il.h>
 
+#include <mutex>
+
 namespace hpl {
 
 
@@ -45,6 +47,8 @@ namespace hpl {
 		ILenum FileNameToDevilTypeW(const tWString& asFile);
 
 		static bool mbIsInitialized;
+		//DevIL works on a global bound image, only one thread at a time can use it.
+		static std::mutex mDevilMutex;
 	};
 
 };
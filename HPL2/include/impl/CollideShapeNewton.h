@@ -37,6 +37,17 @@ namespace hpl {
 	typedef std::vector<iCollideShape*> tCollideShapeVec;
 	typedef tCollideShapeVec::iterator tCollideShapeVecIt;
 
+	//Node in the bounds tree of a compound. Leaves have a sub shape, other nodes have the right child
+	//in mlRight and the left one right after themselves.
+	class cCollideShapeNewtonNode
+	{
+	public:
+		cVector3f mvMin;
+		cVector3f mvMax;
+		int mlRight;
+		int mlSubShape;
+	};
+
 	class cCollideShapeNewton : public iCollideShape
 	{
 	public:
@@ -60,11 +71,24 @@ namespace hpl {
 
 		NewtonCollision* GetNewtonCollision(){ return mpNewtonCollision;}
 
+		/**
+		 * If the bounding volume covers the shape. Static scenes do not set one up.
+		 */
+		bool HasBounds(){ return mType != eCollideShapeType_StaticScene;}
+
+		/**
+		 * Gets the sub shapes with bounds overlapping a box in the space of the shape, sorted by index.
+		 */
+		void GetSubShapesInBox(const cVector3f& avMin, const cVector3f& avMax, tIntVec& avSubShapes);
+
 	private:
+		int BuildSubShapeTree(std::vector<int>& avShapes, int alFirst, int alCount);
+
 		NewtonCollision* mpNewtonCollision;
 		NewtonWorld *mpNewtonWorld;
 
 		tCollideShapeVec mvSubShapes;
+		std::vector<cCollideShapeNewtonNode> mvSubShapeTree;
 	};
 };
 #endif // HPL_COLLIDE_SHAPE_NEWTON_H
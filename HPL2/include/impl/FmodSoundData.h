@@ -40,6 +40,8 @@ namespace hpl {
 
 		bool IsStereo(){ return false;}
 
+		size_t GetMemorySize(){ return 0;}
+
 		//FMOD Specific
 		FSOUND_SAMPLE *GetSample(){ return mpSample;}
 		FSOUND_STREAM *GetStream(){ return mpStream;}
@@ -465,6 +465,7 @@ namespace hpl {
 		~cMeshLoaderCollada();
 
 		void SetLoadAndSaveMSHFormat(bool abX){ mbLoadAndSaveMSHFormat = abX;} //Needed for tools!
+		void SetOptimizeVertexOrder(bool abX){ mbOptimizeVertexOrder = abX;}
 
 		cMesh* LoadMesh(const tWString& asFile, tMeshLoadFlag aFlags);
 		bool SaveMesh(cMesh* apMesh,const tWString& asFile){return false;}
@@ -478,6 +479,7 @@ namespace hpl {
 	private:
 		cMeshLoaderMSH *mpMeshLoaderMSH;
 		bool mbLoadAndSaveMSHFormat;
+		bool mbOptimizeVertexOrder;
 
 		float mfUnitScale;
 		bool mbZToY;
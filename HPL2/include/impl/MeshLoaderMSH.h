@@ -54,7 +54,17 @@ namespace hpl {
 		cAnimation* LoadAnimation(const tWString& asFile);
 		bool SaveAnimation(cAnimation* apAnimation, const tWString& asFile);
 
+		/**
+		 * Reads the material names of the sub meshes in a loaded msh file without creating anything.
+		 * The buffer position is kept. Does not use any loader state, so it can be called from any thread.
+		 */
+		static bool GetMaterialNames(cBinaryBuffer* apBuffer, tStringVec& avMaterials);
+
 	private:
+		static bool GetMaterialNamesFromBuffer(cBinaryBuffer* apBuffer, tStringVec& avMaterials);
+		static void SkipNodeInBuffer(cBinaryBuffer* apBuffer);
+		static void SkipBoneInBuffer(cBinaryBuffer* apBuffer);
+
 		void AddAnimation(cAnimation *apAnimation, cBinaryBuffer* apBuffer);
 		cAnimation* GetAnimation(cBinaryBuffer* apBuffer, const tWString &asFullPath);
 
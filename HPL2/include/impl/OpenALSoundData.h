@@ -30,6 +30,8 @@
 
 namespace hpl {
 
+	class cBinaryBuffer;
+
 	class cOpenALSoundData : public iSoundData
 	{
 	public:
@@ -44,9 +46,17 @@ namespace hpl {
 
 		bool IsStereo();
 
+		size_t GetMemorySize();
+
 		cOAL_Sample*	GetSample(){ return ( mpSample ); } //static_cast<cOAL_Sample*> (mpSoundData));}
 		cOAL_Stream*	GetStream(){ return ( mpStream ); } //static_cast<cOAL_Stream*> (mpSoundData));}
 
+		/**
+		 * Decodes a sample file into a 16 bit PCM wav in memory, ogg files are decompressed and wav files copied.
+		 * Does not touch OpenAL so it can be run on any thread, uploading the result is all that is left for CreateFromFile.
+		 */
+		static bool DecodeSampleToBuffer(const tWString &asFile, cBinaryBuffer *apBuffer);
+
 	private:
 		cOAL_Sample*	mpSample;
 		cOAL_Stream*	mpStream;
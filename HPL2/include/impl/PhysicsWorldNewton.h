@@ -100,6 +100,18 @@ namespace hpl {
 						cCollideData & aCollideData, int alMaxPoints,
 						bool abCorrectNormalDirection);
 
+		/**
+		 * When on, sub shape pairs of compounds only get the exact test if their bounds overlap. On by default,
+		 * off tests every pair like before and is only there to compare with.
+		 */
+		void SetPruneShapePairs(bool abX){ mbPruneShapePairs = abX;}
+		bool GetPruneShapePairs(){ return mbPruneShapePairs;}
+		/**
+		 * Number of sub shape pairs given to Newton by CheckShapeCollision since the last reset.
+		 */
+		int GetShapePairsTested(){ return mlShapePairsTested;}
+		void ResetShapePairsTested(){ mlShapePairsTested = 0;}
+
 		void RenderShapeDebugGeometry(	iCollideShape *apShape, const cMatrixf& a_mtxTransform,
 										DebugDraw *apLowLevel, const cColor& aColor);
 		void RenderDebugGeometry(DebugDraw *apLowLevel, const cColor& aColor);
@@ -118,6 +130,11 @@ namespace hpl {
 		float mfMaxTimeStep;
 
 		ePhysicsAccuracy mAccuracy;
+
+		bool mbPruneShapePairs;
+		int mlShapePairsTested;
+		tIntVec mvTempSubShapesA;
+		tIntVec mvTempSubShapesB;
 	};
 };
 #endif // HPL_PHYSICS_WORLD_NEWTON_H
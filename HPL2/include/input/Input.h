@@ -36,6 +36,7 @@ namespace hpl {
 	class iInputDevice;
 	class cAction;
 	class iSubAction;
+	class cInputRecorder;
 
 	typedef std::map<tString, cAction*> tActionMap;
 	typedef tActionMap::iterator tActionMapIt;
@@ -159,6 +160,11 @@ namespace hpl {
 
 		iLowLevelInput* GetLowLevel(){ return mpLowLevelInput;}
 
+		/**
+		 * While recording or replaying, the keyboard and mouse returned are the recorded ones.
+		 */
+		cInputRecorder* GetRecorder(){ return mpRecorder;}
+
 		void AppDeviceWasPlugged();
 		void AppDeviceWasRemoved();
 	private:
@@ -172,6 +178,8 @@ namespace hpl {
 		iMouse* mpMouse;
 		iKeyboard* mpKeyboard;
 		tGamepadList mlstGamepads;
+
+		cInputRecorder *mpRecorder;
 	};
 };
 
@@ -0,0 +1,179 @@
+/*
+ * Copyright © 2009-2020 Frictional Games
+ *
+ * This file is part of Amnesia: The Dark Descent.
+ *
+ * Amnesia: The Dark Descent is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * Amnesia: The Dark Descent is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Amnesia: The Dark Descent.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef HPL_INPUT_RECORDER_H
+#define HPL_INPUT_RECORDER_H
+
+#include <list>
+#include <vector>
+
+#include "system/SystemTypes.h"
+#include "input/InputTypes.h"
+#include "input/Keyboard.h"
+#include "input/Mouse.h"
+
+namespace hpl {
+
+	class cBinaryBuffer;
+
+	//------------------------------------------
+
+	enum eInputRecorderMode
+	{
+		eInputRecorderMode_Off,
+		eInputRecorderMode_Record,
+		eInputRecorderMode_Replay,
+
+		eInputRecorderMode_LastEnum
+	};
+
+	//------------------------------------------
+
+	/**
+	 * Keyboard with the state of one recorded input update, used instead of the live one while recording or replaying.
+	 */
+	class cRecordedKeyboard : public iKeyboard
+	{
+	friend class cInputRecorder;
+	public:
+		cRecordedKeyboard();
+
+		void Update(){}
+
+		bool KeyIsDown(eKey aKey){ return mvKeyArray[aKey];}
+		cKeyPress GetKey();
+		bool KeyIsPressed(){ return mlstKeysPressed.empty()==false;}
+		cKeyPress GetReleasedKey();
+		bool KeyIsReleased(){ return mlstKeysReleased.empty()==false;}
+
+	private:
+		std::vector<bool> mvKeyArray;
+		std::list<cKeyPress> mlstKeysPressed;
+		std::list<cKeyPress> mlstKeysReleased;
+	};
+
+	//------------------------------------------
+
+	/**
+	 * Mouse with the state of one recorded input update. Like the SDL mouse, the relative movement is reset once read.
+	 */
+	class cRecordedMouse : public iMouse
+	{
+	friend class cInputRecorder;
+	public:
+		cRecordedMouse();
+
+		void Update(){}
+
+		bool ButtonIsDown(eMouseButton aButton){ return mvMButtonArray[aButton];}
+		cVector2l GetAbsPosition(){ return mvMouseAbsPos;}
+		cVector2l GetRelPosition();
+
+	private:
+		std::vector<bool> mvMButtonArray;
+		cVector2l mvMouseAbsPos;
+		cVector2l mvMouseRelPos;
+	};
+
+	//------------------------------------------
+
+	/**
+	 * Records keyboard and mouse state for every input update together with the logic updates and frame times of the
+	 * engine loop, so that a play session can be replayed exactly. The random seed and update rate are saved in the header.
+	 *
+	 * The data is a stream of tagged entries that is read back in the order it was written. If the game does something
+	 * else than when recorded the tags will not match, and the replay is stopped.
+	 *
+	 * The file has a header and then the data in compressed chunks. A chunk is added about once a second while
+	 * recording, so a session that ends in a crash can still be replayed up to shortly before it.
+	 *
+	 * Gamepads are not recorded, and none are reported while recording or replaying.
+	 */
+	class cInputRecorder
+	{
+	public:
+		cInputRecorder();
+		~cInputRecorder();
+
+		bool StartRecording(const tWString& asFile, int alSeed, int alUpdatesPerSec);
+		bool StartReplay(const tWString& asFile);
+		/**
+		 * Stops recording or replay, a recording is saved to file.
+		 */
+		void Stop();
+
+		eInputRecorderMode GetMode(){ return mMode;}
+		bool IsActive(){ return mMode != eInputRecorderMode_Off;}
+		bool IsRecording(){ return mMode == eInputRecorderMode_Record;}
+		bool IsReplaying(){ return mMode == eInputRecorderMode_Replay;}
+		/**
+		 * True when a replay has reached the end of the data, or lost sync with it.
+		 */
+		bool IsReplayDone(){ return mbReplayDone;}
+
+		int GetSeed(){ return mlSeed;}
+		int GetUpdatesPerSec(){ return mlUpdatesPerSec;}
+		int GetInputUpdateCount(){ return mlInputUpdateCount;}
+
+		iKeyboard* GetKeyboard(){ return &mKeyboard;}
+		iMouse* GetMouse(){ return &mMouse;}
+
+		/**
+		 * Called by cInput after the live devices are updated. Records their state or replaces it with the recorded one.
+		 */
+		void UpdateInput(iKeyboard *apLiveKeyboard, iMouse *apLiveMouse);
+
+		/**
+		 * Called by the engine loop. When replaying, the logic updates and frame times come from the recording instead of the timers.
+		 */
+		bool ReplayWantUpdate(float *apStepSize);
+		void RecordUpdate(float afStepSize);
+		void RecordEndUpdateLoop();
+
+		float UpdateFrameTime(float afFrameTime);
+
+	private:
+		bool CheckTag(char alTag);
+		void RecordInput(iKeyboard *apLiveKeyboard, iMouse *apLiveMouse);
+		void ReplayInput();
+		void ResetDevices();
+		void StopReplay(const tString& asReason);
+		void FlushRecording();
+
+		eInputRecorderMode mMode;
+		bool mbReplayDone;
+
+		tWString msFile;
+		cBinaryBuffer *mpData;
+
+		int mlSeed;
+		int mlUpdatesPerSec;
+		int mlInputUpdateCount;
+		size_t mlFlushedSize;
+		int mlLoopsSinceFlush;
+
+		cRecordedKeyboard mKeyboard;
+		cRecordedMouse mMouse;
+	};
+
+	//------------------------------------------
+
+};
+
+#endif // HPL_INPUT_RECORDER_H
@@ -900,6 +900,12 @@ namespace hpl {
 		static cMatrixf MatrixSlerp(float afT,const cMatrixf& a_mtxA, const cMatrixf& a_mtxB,
 											bool abShortestPath);
 
+		/**
+		* Same as MatrixSlerp (shortest path) but keeps the scale of the matrices, which is interpolated linearly.
+		* \param afT The amount inbetween the matrices. 0.0 is A and 1 is B.
+		*/
+		static cMatrixf MatrixSlerpScaled(float afT,const cMatrixf& a_mtxA, const cMatrixf& a_mtxB);
+
 		/**
 		 * Matrix multiplication,  A * B = R. This means that B is applied BEFORE A.
 		 */
@@ -138,6 +138,13 @@ namespace hpl {
 		void SetCollideAttachments(bool abX){ mbCollideAttachments  = abX;}
 		bool GetCollideAttachments(){ return mbCollideAttachments;}
 
+		/**
+		 * Only every alX:th particle (and the end) is simulated, the ones between are placed on a line
+		 * between them. 1 simulates all, used for ropes far from the camera.
+		 */
+		void SetLodStep(int alX);
+		int GetLodStep(){ return mlLodStep;}
+
 		/////////////////////////////
 		// Debug
 		void RenderDebug(iLowLevelGraphics *apLowLevel);
@@ -147,6 +154,7 @@ namespace hpl {
 		bool CheckSpecificDataSleeping();
 		bool CheckSpecificDataAwake();
 		void SetSpecificDataSleeping(bool abSleeping);
+		bool CheckParticlesSleeping();
 
 		void UpdateMovement(float afTimeStep);
 		void UpdateMotor(float afTimeStep);
@@ -159,6 +167,11 @@ namespace hpl {
 
 		void BuildRopeParticles();
 
+		void BuildSolverNodes();
+		void GetSolverData();
+		void SetSolverData();
+		void ApplySleepingForces();
+
 		void SetAttachedBody(int alIdx, cVerletParticle *apParticle, iPhysicsBody *apBody);
 
 		cVector3f GetStartDirection();
@@ -166,6 +179,9 @@ namespace hpl {
 		cPidControllerVec3 mForcePid[2];
 
 		cPhysicsRopeAttachment mvAttachedBody[2];
+		cVector3f mvAttachedForce[2];
+		cVector3f mvAttachedTorque[2];
+		cVector3f mvSleepAttachPos[2];
 
 		bool mbCollideAttachments;
 
@@ -201,6 +217,18 @@ namespace hpl {
 		float mfStiffness;
 
 		bool mbHasUpdated;
+
+		/////////////////////////////
+		// Solver data, one entry per simulated particle (node) in rope order
+		std::vector<cVerletParticle*> mvParticles;
+		tIntVec mvNodeIndices;
+		std::vector<cVector3f> mvNodePositions;
+		std::vector<cVector3f> mvNodePrevPositions;
+		std::vector<float> mvNodeInvMasses;
+		std::vector<float> mvNodeLengths;	//Length to the previous node
+		std::vector<cVector3f> mvSleepCheckPositions;
+		bool mbSolverNodesUpdated;
+		int mlLodStep;
 	};
 };
 #endif // HPL_PHYSICS_ROPE_H
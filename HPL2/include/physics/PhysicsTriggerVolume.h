@@ -0,0 +1,133 @@
+/*
+ * Copyright © 2009-2020 Frictional Games
+ *
+ * This file is part of Amnesia: The Dark Descent.
+ *
+ * Amnesia: The Dark Descent is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * Amnesia: The Dark Descent is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Amnesia: The Dark Descent.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef HPL_PHYSICS_TRIGGER_VOLUME_H
+#define HPL_PHYSICS_TRIGGER_VOLUME_H
+
+#include "system/SystemTypes.h"
+#include "physics/CollideData.h"
+
+#include <unordered_map>
+
+namespace hpl {
+
+	//-------------------------------------------
+
+	class iPhysicsWorld;
+	class iPhysicsBody;
+
+	//-------------------------------------------
+
+	class iPhysicsTriggerCallback
+	{
+	public:
+		virtual ~iPhysicsTriggerCallback(){}
+
+		/**
+		 * Filter for bodies in the bounds of the trigger. Only called when a body is tested again, so it
+		 * must only depend on the body state that the trigger keeps track of (or RetestAll must be called).
+		 */
+		virtual bool CheckBody(iPhysicsBody *apBody){ return true;}
+
+		virtual void OnBodyEnter(iPhysicsBody *apBody){}
+		virtual void OnBodyExit(iPhysicsBody *apBody){}
+	};
+
+	//-------------------------------------------
+
+	/**
+	 * Keeps the set of bodies that overlap a trigger body. Each update gets the bodies in the bounds of the
+	 * trigger, but only tests a body again (filter, bounding volume and shape collision) if it has moved,
+	 * has been enabled or disabled, or has changed collide, active or mass since the last update, or if the
+	 * trigger body has moved. Enter and exit are sent to the callback when the set changes.
+	 * Created and updated by iPhysicsWorld, after the simulation.
+	 */
+	class cPhysicsTriggerVolume
+	{
+	public:
+		cPhysicsTriggerVolume(iPhysicsWorld *apWorld, iPhysicsBody *apTriggerBody, iPhysicsTriggerCallback *apCallback);
+		~cPhysicsTriggerVolume();
+
+		void Update();
+
+		/**
+		 * Bodies that are inside, in the order the broadphase returned them the last update.
+		 */
+		const std::vector<iPhysicsBody*>& GetOverlaps(){ return mvOverlaps;}
+		bool IsOverlapping(iPhysicsBody *apBody);
+
+		/**
+		 * Makes all bodies be tested again on the next update, call when the filter has changed.
+		 */
+		void RetestAll();
+
+		/**
+		 * Removes the body without calling exit, called by the world when the body is destroyed.
+		 */
+		void OnBodyDestroyed(iPhysicsBody *apBody);
+
+		iPhysicsBody* GetTriggerBody(){ return mpTriggerBody;}
+
+		int GetBodiesChecked(){ return mlBodiesChecked;}
+		int GetBodiesTested(){ return mlBodiesTested;}
+
+	private:
+		class cBodyState
+		{
+		public:
+			int mlTransformCount;
+			float mfMass;
+			bool mbEnabled;
+			bool mbCollide;
+			bool mbActive;
+
+			bool mbInside;
+			int mlUpdateCount;
+		};
+
+		typedef std::unordered_map<iPhysicsBody*, cBodyState> tBodyStateMap;
+		typedef tBodyStateMap::iterator tBodyStateMapIt;
+
+		bool TestBody(iPhysicsBody *apBody);
+
+		iPhysicsWorld *mpWorld;
+		iPhysicsBody *mpTriggerBody;
+		iPhysicsTriggerCallback *mpCallback;
+
+		tBodyStateMap m_mapBodyStates;
+		std::vector<iPhysicsBody*> mvOverlaps;
+
+		int mlUpdateCount;
+		int mlTriggerTransformCount;
+		bool mbRetestAll;
+
+		int mlBodiesChecked;
+		int mlBodiesTested;
+
+		cCollideData mCollideData;
+		std::vector<iPhysicsBody*> mvTempBodies;
+		std::vector<iPhysicsBody*> mvTempOverlaps;
+		std::vector<iPhysicsBody*> mvTempEntered;
+		std::vector<iPhysicsBody*> mvTempExited;
+	};
+
+	//-------------------------------------------
+
+};
+#endif // HPL_PHYSICS_TRIGGER_VOLUME_H
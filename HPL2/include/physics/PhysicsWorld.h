@@ -47,6 +47,8 @@ namespace hpl {
 	class iPhysicsJointSlider;
 	class iPhysicsController;
 	class iPhysicsRope;
+	class cPhysicsTriggerVolume;
+	class iPhysicsTriggerCallback;
 	class cBinaryBuffer;
 
 	class cWorld;
@@ -76,6 +78,9 @@ namespace hpl {
 	typedef std::list<iPhysicsRope*> tPhysicsRopeList;
 	typedef tPhysicsRopeList::iterator tPhysicsRopeListIt;
 
+	typedef std::list<cPhysicsTriggerVolume*> tPhysicsTriggerVolumeList;
+	typedef tPhysicsTriggerVolumeList::iterator tPhysicsTriggerVolumeListIt;
+
 	typedef std::map<tString, iPhysicsMaterial*> tPhysicsMaterialMap;
 	typedef tPhysicsMaterialMap::iterator tPhysicsMaterialMapIt;
 
@@ -215,6 +220,12 @@ namespace hpl {
 		iPhysicsRope* GetRopeFromUniqueID(int alID);
 		void DestroyRope(iPhysicsRope* apRope);
 
+		/**
+		 * Tracks the bodies overlapping apTriggerBody, see cPhysicsTriggerVolume. The trigger must be
+		 * destroyed before its body.
+		 */
+		cPhysicsTriggerVolume* CreateTriggerVolume(iPhysicsBody *apTriggerBody, iPhysicsTriggerCallback *apCallback);
+		void DestroyTriggerVolume(cPhysicsTriggerVolume* apTrigger);
 
 		//! @}
 
@@ -276,6 +287,7 @@ namespace hpl {
 		tPhysicsJointList mlstJoints;
 		tPhysicsControllerList mlstControllers;
 		tPhysicsRopeList mlstRopes;
+		tPhysicsTriggerVolumeList mlstTriggerVolumes;
 		cWorld *mpWorld;
 
 		std::vector<iPhysicsBody*> mvTempBodies;
@@ -33,6 +33,7 @@ namespace hpl {
 
 	class cVerletParticle;
 	class iVerletParticleContainer;
+	class iPhysicsRope;
 
 	//------------------------------------------
 
@@ -68,6 +69,7 @@ namespace hpl {
 	class cVerletParticle
 	{
 		friend class iVerletParticleContainer;
+		friend class iPhysicsRope;
 	public:
 		cVerletParticle(iVerletParticleContainer *apRope);
 		cVerletParticle(iVerletParticleContainer *apRope, const cVector3f& avPos, float afInvMass);
@@ -130,6 +132,7 @@ namespace hpl {
 		bool GetCollide(){ return mbCollide;}
 
 		void SetSleeping(bool abX);
+		bool GetSleeping(){ return mbSleeping;}
 
 		inline int GetUpdateCount() const { return mlUpdateCount; }
 
@@ -140,6 +143,7 @@ namespace hpl {
 		virtual bool CheckSpecificDataSleeping()=0;	//Tested when container is NOT sleeping
 		virtual bool CheckSpecificDataAwake()=0;		//Tested when container IS sleeping
 		virtual void SetSpecificDataSleeping(bool abSleeping)=0;
+		virtual bool CheckParticlesSleeping();	//Tested when it is time for a sleep check
 
 		void PreUpdate(float afTimeStep);
 
@@ -27,6 +27,8 @@
 #include "system/SystemTypes.h"
 #include "resources/ResourcesTypes.h"
 
+#include <vector>
+
 namespace hpl {
 
 	//------------------------------------------------------------
@@ -45,6 +47,11 @@ namespace hpl {
 		~cBitmapLoaderHandler();
 
 		cBitmap* LoadBitmap(const tWString& asFile, tBitmapLoadFlag aFlags);
+		/**
+		 * Decodes several files at once spread over the cJobPool workers. The result has the same order as
+		 * the files, with NULL for any file that failed to load.
+		 */
+		void LoadBitmaps(const tWStringVec& avFiles, tBitmapLoadFlag aFlags, std::vector<cBitmap*>& avBitmaps);
 		bool SaveBitmap(cBitmap* apBitmap, const tWString& asFile, tBitmapSaveFlag aFlags);
 
 	private:
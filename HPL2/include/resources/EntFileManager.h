@@ -27,6 +27,7 @@ namespace hpl {
 
 	class cResources;
 	class iXmlDocument;
+	class cEntityPrototype;
 
 	//------------------------------------
 
@@ -37,8 +38,13 @@ namespace hpl {
 		~cEntFile();
 
 		bool CreateFromFile();
+		void CreateFromDocument(iXmlDocument *apDoc);
 
 		iXmlDocument *GetXmlDoc(){ return mpXmlDoc;}
+		/**
+		 * The file compiled into typed data, done the first time it is asked for.
+		 */
+		const cEntityPrototype* GetPrototype();
 
 		//resources stuff.
 		bool Reload(){ return false;}
@@ -47,6 +53,7 @@ namespace hpl {
 
 	private:
 		iXmlDocument *mpXmlDoc;
+		cEntityPrototype *mpPrototype;
 	};
 
 
@@ -42,6 +42,7 @@ namespace hpl {
 	class iLight;
 	class iHapticShape;
 	class cBoneState;
+	class cEntityPrototype;
 
 	//--------------------------------------------
 
@@ -70,7 +71,8 @@ namespace hpl {
 
         iEntity3D* Load(const tString &asName, int alID, bool abActive, cXmlElement *apRootElem,
 						const cMatrixf &a_mtxTransform, const cVector3f &avScale,
-						cWorld *apWorld, const tString &asFileName, const tWString &asFullPath, cResourceVarsObject *apInstanceVars);
+						cWorld *apWorld, const tString &asFileName, const tWString &asFullPath, cResourceVarsObject *apInstanceVars,
+						const cEntityPrototype *apPrototype=NULL);
 
 	protected:
 		virtual void BeforeLoad(cXmlElement *apRootElem, const cMatrixf &a_mtxTransform,cWorld *apWorld, cResourceVarsObject *apInstanceVars)=0;
@@ -79,21 +81,18 @@ namespace hpl {
 		void AttachEntityChild(iEntity3D *apParent, const cMatrixf& a_mtxInvParent, iEntity3D *apChild);
 		void AttachBoneChild(cBoneState *apBoneState, const cMatrixf& a_mtxInvParent, iEntity3D *apChild);
 		void AttachBoneToBody(iPhysicsBody *apParentBody, const cMatrixf& a_mtxInvParent, cBoneState *apBoneState);
-		void LoadAndAttachChildren(cXmlElement *apMainElem, iEntity3D *apEntityParent, cBoneState *apBoneStateParent,
+		void LoadAndAttachChildren(const tIntVec& avChildIDs, iEntity3D *apEntityParent, cBoneState *apBoneStateParent,
             						std::list<iEntity3D*>& a_lstChildList, tNodeStateMap &a_mapBoneStates,
 									bool abRemoveAttachedChild, bool abIsBody);
 
 		cBillboard* GetBillboardFromID(int alID);
 		iLight* GetLightFromName(const tString& asName);
 
-		void SetBodyProperties(iPhysicsBody *apBody, cXmlElement *apPhysicsElem);
-		void SetJointProperties(iPhysicsJoint *apJoint, cXmlElement *apJointElem,cWorld *apWorld);
-
 		void LoadController(iPhysicsJoint *apJoint,iPhysicsWorld *apPhysicsWorld, TiXmlElement *apElem);
 
 		eAnimationEventType GetAnimationEventType(const char* apString);
 
-		void LoadUserVariables(cXmlElement *apRootElem);
+		void LoadUserVariables(const cEntityPrototype *apPrototype);
 
 		tString msSubType;
 		int mlID;
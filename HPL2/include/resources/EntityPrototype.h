@@ -0,0 +1,263 @@
+/*
+ * Copyright © 2009-2020 Frictional Games
+ *
+ * This file is part of Amnesia: The Dark Descent.
+ *
+ * Amnesia: The Dark Descent is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * Amnesia: The Dark Descent is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Amnesia: The Dark Descent.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef HPL_ENTITY_PROTOTYPE_H
+#define HPL_ENTITY_PROTOTYPE_H
+
+#include "system/SystemTypes.h"
+#include "math/MathTypes.h"
+#include "graphics/GraphicsTypes.h"
+#include "physics/PhysicsTypes.h"
+#include "physics/PhysicsJoint.h"
+
+#include "resources/Resources.h"
+
+namespace hpl {
+
+	class cXmlElement;
+	class iPhysicsWorld;
+	class iPhysicsBody;
+	class iCollideShape;
+
+	//--------------------------------------------
+
+	enum eEntityPrototypeObject
+	{
+		eEntityPrototypeObject_ParticleSystem,
+		eEntityPrototypeObject_Billboard,
+		eEntityPrototypeObject_Sound,
+		eEntityPrototypeObject_Light,
+		eEntityPrototypeObject_LastEnum
+	};
+
+	//--------------------------------------------
+
+	class cEntityPrototypeSubMesh
+	{
+	public:
+		tString msName;
+		int mlID;
+		cVector3f mvWorldPos;
+		cVector3f mvRotation;
+		cVector3f mvScale;
+	};
+
+	//--------------------------------------------
+
+	class cEntityPrototypeAnimEvent
+	{
+	public:
+		float mfTime;
+		eAnimationEventType mType;
+		tString msValue;
+	};
+
+	class cEntityPrototypeAnimation
+	{
+	public:
+		tString msFile;
+		tString msName;
+		float mfSpeed;
+		float mfSpecialEventTime;
+		std::vector<cEntityPrototypeAnimEvent> mvEvents;
+	};
+
+	//--------------------------------------------
+
+	/**
+	 * Particle systems, billboards, sounds and lights are created by cEngineFileLoading, which takes
+	 * the element. It points into the document the prototype was compiled from.
+	 */
+	class cEntityPrototypeObject
+	{
+	public:
+		eEntityPrototypeObject mType;
+		cXmlElement *mpElement;
+	};
+
+	//--------------------------------------------
+
+	class cEntityPrototypeBone
+	{
+	public:
+		int mlID;
+		tString msName;
+		tIntVec mvChildIDs;
+	};
+
+	//--------------------------------------------
+
+	class cEntityPrototypeShape
+	{
+	public:
+		iCollideShape* Create(iPhysicsWorld *apPhysicsWorld, const cVector3f& avScale) const;
+
+		int mlID;
+		eCollideShapeType mType;
+		cVector3f mvSize;
+		cVector3f mvOffset;
+		cVector3f mvRotation;
+	};
+
+	//--------------------------------------------
+
+	class cEntityPrototypeBody
+	{
+	public:
+		void SetProperties(iPhysicsBody *apBody, const cVector3f& avScale) const;
+
+		int mlID;
+		tString msName;
+		tString msMaterial;
+		tIntVec mvShapeIDs;
+		tIntVec mvChildIDs;
+
+		cVector3f mvWorldPos;
+		cVector3f mvRotation;
+
+		float mfMass;
+		float mfAngularDamping;
+		float mfLinearDamping;
+		float mfBuoyancyDensityMul;
+		float mfMaxAngularSpeed;
+		float mfMaxLinearSpeed;
+
+		bool mbBlocksSound;
+		bool mbCollideCharacter;
+		bool mbCollideNonCharacter;
+		bool mbHasGravity;
+		bool mbContinuousCollision;
+		bool mbPushedByCharacterGravity;
+		bool mbVolatile;
+		bool mbUseSurfaceEffects;
+		bool mbCanAttachCharacter;
+	};
+
+	//--------------------------------------------
+
+	class cEntityPrototypeJoint
+	{
+	public:
+		void SetProperties(iPhysicsJoint *apJoint) const;
+
+		ePhysicsJointType mType;
+		tString msName;
+		cVector3f mvWorldPos;
+		cVector3f mvPinDir;
+		int mlParentID;
+		int mlChildID;
+
+		//Angles in radians for hinges, cone and twist angle for balls, distances for sliders and screws.
+		float mfMinLimit;
+		float mfMaxLimit;
+
+		tString msMoveSound;
+		float mfMinMoveSpeed;
+		float mfMinMoveFreq;
+		float mfMinMoveVolume;
+		float mfMinMoveFreqSpeed;
+		float mfMaxMoveFreq;
+		float mfMaxMoveVolume;
+		float mfMaxMoveFreqSpeed;
+		float mfMiddleMoveSpeed;
+		float mfMiddleMoveVolume;
+		ePhysicsJointSpeed mMoveSpeedType;
+
+		bool mbStickyMinLimit;
+		bool mbStickyMaxLimit;
+
+		bool mbBreakable;
+		float mfBreakForce;
+		tString msBreakSound;
+
+		bool mbLimitAutoSleep;
+		float mfLimitAutoSleepDist;
+		int mlLimitAutoSleepNumSteps;
+
+		bool mbCollideBodies;
+
+		tString msMaxLimitSound;
+		float mfMaxLimitMaxSpeed;
+		float mfMaxLimitMinSpeed;
+		tString msMinLimitSound;
+		float mfMinLimitMaxSpeed;
+		float mfMinLimitMinSpeed;
+
+		int mlID;
+	};
+
+	//--------------------------------------------
+
+	class cEntityLoadStats
+	{
+	public:
+		cEntityLoadStats() : mlPrototypesCompiled(0), mlInstancesCreated(0), mfCompileTime(0), mfInstanceTime(0){}
+
+		int mlPrototypesCompiled;
+		int mlInstancesCreated;
+		double mfCompileTime;	//ms
+		double mfInstanceTime;	//ms
+	};
+
+	//--------------------------------------------
+
+	/**
+	 * Everything cEntityLoader_Object needs from an .ent file, read once into typed data so placing
+	 * an entity does not go through the xml again. cEntFile compiles it the first time it is used and
+	 * it is not changed after that. Transform, scale and instance variables are applied by the loader.
+	 */
+	class cEntityPrototype
+	{
+	public:
+		cEntityPrototype();
+		~cEntityPrototype();
+
+		bool Compile(cXmlElement *apRootElem, const tWString& asFullPath);
+
+		bool IsValid() const { return mbValid;}
+
+		static cEntityLoadStats& GetLoadStats(){ return mLoadStats;}
+		static void ResetLoadStats(){ mLoadStats = cEntityLoadStats();}
+
+		tString msMeshFile;
+		std::vector<cEntityPrototypeSubMesh> mvSubMeshes;
+		std::vector<cEntityPrototypeAnimation> mvAnimations;
+		std::vector<cEntityPrototypeObject> mvObjects;
+		std::vector<cEntityPrototypeBone> mvBones;
+		std::vector<cEntityPrototypeShape> mvShapes;
+		std::vector<cEntityPrototypeBody> mvBodies;
+		std::vector<cEntityPrototypeJoint> mvJoints;
+
+		bool mbHasUserVariables;
+		tString msEntityType;
+		tString msEntitySubType;
+		tResourceVarMap m_mapUserVariables;
+
+	private:
+		void CompileChildIDs(cXmlElement *apMainElem, tIntVec& avChildIDs);
+
+		bool mbValid;
+
+		static cEntityLoadStats mLoadStats;
+	};
+
+	//--------------------------------------------
+
+};
+#endif // HPL_ENTITY_PROTOTYPE_H
@@ -21,6 +21,7 @@
 #define HPL_FILESEARCHER_H
 
 #include <map>
+#include <shared_mutex>
 #include "resources/ResourcesTypes.h"
 #include "system/SystemTypes.h"
 
@@ -71,9 +72,31 @@ namespace hpl {
          */
         const tWString& GetFilePath(const tString& asFileNameAndPath, int *apEqualCount=NULL);
 
+		/**
+		 * Registers an offline cooked replacement for a file. Only used if the cooked file exists.
+		 * \param asSourcePath Path to the original file
+		 * \param asCookedPath Path to the file to load instead
+		 */
+		void AddCookedFile(const tWString& asSourcePath, const tWString& asCookedPath);
+
+		/**
+		 * Returns the path of the cooked version of a file found by GetFilePath, or the path itself if there is none.
+		 */
+		tWString GetCookedFilePath(const tWString& asFilePath);
+
+		/**
+		 * Gets the paths of all added files with the extension asExt (without the dot, any case).
+		 */
+		void GetFilesWithExt(tWStringVec &avFiles, const tString& asExt);
+
 	private:
+		void AddDirectoryFiles(const tWString& asSearchPath, const tString& asMask, bool abAddSubDirectories);
+
+		// lookups are done from the map preloader thread as well
+		std::shared_mutex m_mutex;
 		tFilePathMap m_mapFiles;
 		tWStringSet m_setLoadedDirs;
+		std::map<tWString, tWString> m_mapCookedFiles;
 
 		tWString msNull;
 	};
@@ -21,7 +21,9 @@
 #define HPL_LANGUAGE_FILE_H
 
 #include <map>
+#include <vector>
 #include "system/SystemTypes.h"
+#include "resources/ResourcesTypes.h"
 
 namespace hpl {
 
@@ -33,6 +35,7 @@ namespace hpl {
 	{
 	public:
 		tWString mwsText;
+		tLanguageEntryId mlId;
 	};
 
 	typedef std::map<tString, cLanguageEntry*> tLanguageEntryMap;
@@ -63,14 +66,45 @@ namespace hpl {
 
 		bool AddFromFile(const tWString& asFile, bool abAddResourceDirs, const tWString& asAltPath = _W(""));
 
+		/**
+		 * Removes all texts, the entry ids are kept and get their texts back when a language file is added again.
+		 */
+		void Clear();
+
 		const tWString& Translate(const tString& asCat, const tString& asName);
+		const tWString& Translate(tLanguageEntryId alId);
+
+		/**
+		 * Gets the id of an entry, creating it if it is not loaded (yet). Keep the id and use it with Translate
+		 * for text that is fetched often.
+		 */
+		tLanguageEntryId GetEntryId(const tString& asCat, const tString& asName);
+		/**
+		 * Same as GetEntryId but returns kLanguageEntryId_None instead of creating the entry.
+		 */
+		tLanguageEntryId FindEntryId(const tString& asCat, const tString& asName);
 
 		tLanguageCategoryMap* GetCategoryMap(){ return &m_mapCategories;}
 
 	private:
+		class cLanguageKey
+		{
+		public:
+			tString msCat;
+			tString msName;
+			unsigned int mlHash;
+		};
+
+		static unsigned int GetKeyHash(const tString& asCat, const tString& asName);
+		void RehashKeys(size_t alNumSlots);
+
 		tLanguageCategoryMap m_mapCategories;
 		tWString mwsEmpty;
 
+		std::vector<cLanguageKey> mvKeys;
+		std::vector<cLanguageEntry*> mvEntries; //Indexed by id, NULL if not in the loaded language
+		std::vector<tLanguageEntryId> mvKeySlots; //Open addressed hash of the ids, linear probing
+
 		cResources *mpResources;
 	};
 
@@ -0,0 +1,163 @@
+/*
+ * Copyright © 2009-2020 Frictional Games
+ *
+ * This file is part of Amnesia: The Dark Descent.
+ *
+ * Amnesia: The Dark Descent is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * Amnesia: The Dark Descent is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Amnesia: The Dark Descent.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef HPL_MAP_PRELOADER_H
+#define HPL_MAP_PRELOADER_H
+
+#include "engine/RTTI.h"
+#include "system/SystemTypes.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace hpl {
+
+	class cBinaryBuffer;
+	class cBitmap;
+	class cBitmapLoaderHandler;
+	class cFileSearcher;
+	class iLowLevelResources;
+	class iXmlDocument;
+	class cXmlElement;
+
+	//------------------------------------
+
+	/**
+	 * Prepares the CPU side data of maps that are likely to be entered next on a background thread.
+	 * The map file, the entity files, the mesh caches, the images used by the materials of the meshes
+	 * and the samples of the sound entities are read and decoded ahead of time, the decoding is spread over
+	 * the job pool. The loaders take the prepared data on the main thread when the map is actually loaded,
+	 * anything that touches the GPU, OpenAL or the world is still created by the loaders themselves.
+	 */
+	class MapPreloader
+	{
+		HPL_RTTI_CLASS(MapPreloader, "{3b0f6a53-7f0e-4c1c-9a4d-6d2b1e8c4f21}")
+	public:
+		class cStats
+		{
+		public:
+			size_t mlUsedMemory = 0;
+			int mlPreparedFiles = 0;
+			int mlPreparedBitmaps = 0;
+			int mlPreparedSounds = 0;
+			int mlTakenFiles = 0;
+			int mlSkippedFiles = 0; //Files that did not fit in the memory budget
+		};
+
+		MapPreloader(cFileSearcher *apFileSearcher, iLowLevelResources *apLowLevelResources,
+					cBitmapLoaderHandler *apBitmapLoaderHandler, const tStringList& alstSoundFormats);
+		~MapPreloader();
+
+		void SetActive(bool abX);
+		bool IsActive(){ return mbActive;}
+
+		/**
+		 * The budget is measured in bytes of prepared data.
+		 */
+		void SetMemoryBudget(size_t alBytes);
+		size_t GetMemoryBudget(){ return mlMemoryBudget;}
+
+		/**
+		 * Queues a map for preloading. The path is the full path as returned by the cFileSearcher.
+		 * Requesting a map that is already queued or prepared does nothing.
+		 */
+		void Request(const tWString& asMapPath);
+		bool IsRequested(const tWString& asMapPath);
+
+		/**
+		 * Stops the worker after the step it is currently doing and drops the queue.
+		 * Data that is already prepared is kept so it can be taken by the loaders.
+		 */
+		void CancelPending();
+		/**
+		 * Cancels pending work and frees all prepared data.
+		 */
+		void Clear();
+
+		/**
+		 * The caller takes ownership, NULL is returned if the file is not prepared.
+		 * Sound samples are taken as binary buffers holding a wav file.
+		 */
+		iXmlDocument* TakeXmlDocument(const tWString& asPath);
+		std::unique_ptr<cBinaryBuffer> TakeBinaryBuffer(const tWString& asPath);
+		cBitmap* TakeBitmap(const tWString& asPath);
+
+		cStats GetStats();
+
+	private:
+		class cPreparedFile
+		{
+		public:
+			cPreparedFile() = default;
+			cPreparedFile(cPreparedFile&& aFile);
+			~cPreparedFile();
+
+			iXmlDocument *mpXmlDoc = nullptr;
+			std::unique_ptr<cBinaryBuffer> mpBuffer;
+			cBitmap *mpBitmap = nullptr;
+			size_t mlSize = 0;
+			bool mbSound = false;
+		};
+
+		void WorkerThread();
+		void PrepareMap(const tWString& asMapPath, unsigned int alGeneration);
+		void PrepareEntityFile(const tString& asFile, unsigned int alGeneration, tStringVec& avMaterials);
+		void PrepareMeshFile(const tString& asFile, unsigned int alGeneration, tStringVec& avMaterials);
+		void PrepareImages(const tStringVec& avMaterials, unsigned int alGeneration);
+		void PrepareSounds(const tStringVec& avSoundEntities, unsigned int alGeneration);
+
+		void CollectFileIndex(cXmlElement *apContentsElem, const tString& asIndexName, tStringVec& avFiles);
+		tWString GetImagePath(const tString& asName);
+		tWString GetSoundPath(const tString& asName);
+
+		bool PrepareXmlDocument(const tWString& asPath, unsigned int alGeneration, iXmlDocument **apOutDoc);
+		bool ReserveMemory(const tWString& asPath, size_t alSize, unsigned int alGeneration);
+		bool AddPreparedFile(const tWString& asPath, cPreparedFile& aFile, unsigned int alGeneration);
+
+		bool IsCancelled(unsigned int alGeneration){ return alGeneration != mlGeneration;}
+
+		cFileSearcher *mpFileSearcher;
+		iLowLevelResources *mpLowLevelResources;
+		cBitmapLoaderHandler *mpBitmapLoaderHandler;
+		tStringList mlstSoundFormats;
+
+		std::mutex mMutex;
+		std::condition_variable mCondition;
+		std::thread mWorkerThread;
+
+		tWStringList mlstQueue;
+		tWStringSet m_setRequestedMaps;
+		tWStringSet m_setVisitedFiles;
+		std::map<tWString, cPreparedFile> m_mapPreparedFiles;
+		cStats mStats;
+
+		std::atomic<unsigned int> mlGeneration;
+		size_t mlMemoryBudget;
+		bool mbActive;
+		bool mbQuit;
+	};
+
+	//------------------------------------
+
+};
+#endif // HPL_MAP_PRELOADER_H
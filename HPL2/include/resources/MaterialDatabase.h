@@ -0,0 +1,133 @@
+/*
+ * Copyright © 2009-2020 Frictional Games
+ *
+ * This file is part of Amnesia: The Dark Descent.
+ *
+ * Amnesia: The Dark Descent is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * Amnesia: The Dark Descent is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Amnesia: The Dark Descent.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef HPL_MATERIAL_DATABASE_H
+#define HPL_MATERIAL_DATABASE_H
+
+#include "system/SystemTypes.h"
+#include "graphics/GraphicsTypes.h"
+#include "graphics/Material.h"
+
+#include <mutex>
+#include <unordered_map>
+
+namespace hpl {
+
+	class cBinaryBuffer;
+
+	//--------------------------------------------
+
+	class cCompiledMaterialTexture
+	{
+	public:
+		eMaterialTexture mUnit;
+		tString msFile;
+		eTextureType mType;
+		eTextureWrap mWrap;
+		eTextureAnimMode mAnimMode;
+		bool mbMipMaps;
+		bool mbCompress;
+		float mfFrameTime;
+	};
+
+	//--------------------------------------------
+
+	/**
+	 * A .mat file with everything resolved from strings: the type, the texture units the type uses (file
+	 * paths made relative to the material's dir) and the shader data from the specific variables.
+	 */
+	class cCompiledMaterial
+	{
+	public:
+		MaterialID mID;
+		tString msType;
+		bool mbDepthTest;
+		tString msPhysicsMaterial;
+		bool mbHasTextureUnits;
+		std::vector<cCompiledMaterialTexture> mvTextures;
+		std::vector<cMaterialUvAnimation> mvUvAnimations;
+		ShaderMaterialData mDescriptor;
+	};
+
+	//--------------------------------------------
+
+	/**
+	 * Binary cache of compiled materials, saved as a single file. An entry is used as long as the .mat file
+	 * has the same modified date and size. If the date has changed, the file is read and the entry is still
+	 * used if the contents hash the same, else the file is compiled again.
+	 * Lookups can be done from several threads.
+	 */
+	class cMaterialDatabase
+	{
+	public:
+		cMaterialDatabase();
+		~cMaterialDatabase();
+
+		/**
+		 * Loads a database saved earlier. A missing or outdated file gives an empty database.
+		 */
+		bool Load(const tWString& asFile);
+		bool Save(const tWString& asFile);
+
+		/**
+		 * Gets the compiled version of the .mat file at asPath, compiling it if there is no valid entry.
+		 * \return false if the file could not be read or compiled.
+		 */
+		bool GetMaterial(const tWString& asPath, cCompiledMaterial &aMaterial);
+
+		bool IsChanged(){ return mbChanged;}
+		int GetEntryCount(){ return (int)m_mapEntries.size();}
+
+		int GetHits(){ return mlHits;}
+		int GetCompiled(){ return mlCompiled;}
+		void ResetStats(){ mlHits = 0; mlCompiled = 0;}
+
+		/**
+		 * Compiles a .mat file from its contents, asPath is used for messages and relative texture paths.
+		 */
+		static bool Compile(const char* apData, size_t alSize, const tWString& asPath, cCompiledMaterial &aMaterial);
+
+	private:
+		class cEntry
+		{
+		public:
+			cDate mDate;
+			int mlFileSize;
+			unsigned int mlHash;
+			cCompiledMaterial mMaterial;
+		};
+
+		typedef std::unordered_map<tString, cEntry> tEntryMap;
+		typedef tEntryMap::iterator tEntryMapIt;
+
+		static void SaveMaterial(cBinaryBuffer *apBuffer, const cCompiledMaterial &aMaterial);
+		static void LoadMaterial(cBinaryBuffer *apBuffer, cCompiledMaterial &aMaterial);
+
+		std::mutex m_mutex;
+		tEntryMap m_mapEntries;
+		bool mbChanged;
+
+		int mlHits;
+		int mlCompiled;
+	};
+
+	//--------------------------------------------
+
+};
+#endif // HPL_MATERIAL_DATABASE_H
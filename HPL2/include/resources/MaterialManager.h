@@ -30,6 +30,8 @@ namespace hpl {
 	class cMaterial;
 	class iMaterialType;
 	class cResourceVarsObject;
+	class cMaterialDatabase;
+	class cCompiledMaterial;
 
 	class cMaterialManager : public iResourceManager
 	{
@@ -58,21 +60,38 @@ namespace hpl {
 
 		cMaterial* CreateCustomMaterial(const tString& asName, iMaterialType *apMaterialType);
 
-		const char* GetTextureString(eMaterialTexture aType);
+		static const char* GetTextureString(eMaterialTexture aType);
 
 		void SetDisableRenderDataLoading(bool abX){ mbDisableRenderDataLoading = abX;}
 
+		/**
+		 * Loads materials through a binary database of compiled materials saved at asFile, instead of parsing
+		 * every .mat file. The file is created if it does not exist.
+		 */
+		void SetDatabaseFile(const tWString& asFile);
+		cMaterialDatabase* GetDatabase(){ return mpDatabase;}
+		/**
+		 * Saves the database if any material has been compiled since it was loaded.
+		 */
+		void SaveDatabase();
+		/**
+		 * Compiles all .mat files in the resource dirs into the database.
+		 * \return the number of materials in the database.
+		 */
+		int CompileAllToDatabase();
+
 		// Useful stuff if public
-		eTextureType GetType(const char* asType);
-		eTextureWrap GetWrap(const char* asType);
-		eTextureAnimMode GetAnimMode(const char* asType);
-		eMaterialBlendMode GetBlendMode(const char* asType);
+		static eTextureType GetType(const char* asType);
+		static eTextureWrap GetWrap(const char* asType);
+		static eTextureAnimMode GetAnimMode(const char* asType);
+		static eMaterialBlendMode GetBlendMode(const char* asType);
 
-		eMaterialUvAnimation GetUvAnimType(const char* apString);
-		eMaterialAnimationAxis GetAnimAxis(const char* apString);
+		static eMaterialUvAnimation GetUvAnimType(const char* apString);
+		static eMaterialAnimationAxis GetAnimAxis(const char* apString);
 
 	private:
 		cMaterial* LoadFromFile(const tString& asName,const tWString& asPath);
+		bool GetCompiledMaterial(const tWString& asPath, cCompiledMaterial &aMaterial);
 
 		unsigned int mlTextureSizeDownScaleLevel;
 		eTextureFilter mTextureFilter;
@@ -87,6 +106,9 @@ namespace hpl {
 
 		bool mbDisableRenderDataLoading;
 
+		cMaterialDatabase *mpDatabase;
+		tWString msDatabaseFile;
+
 		int mlIdCounter;
 	};
 
@@ -21,6 +21,7 @@
 #define HPL_RESOURCEBASE_H
 
 #include <time.h>
+#include <list>
 #include "system/SystemTypes.h"
 #include "system/LowLevelSystem.h"
 #include <engine/RTTI.h>
@@ -28,6 +29,8 @@
 
 namespace hpl {
 
+	class iResourceManager;
+
 	class iResourceBase
 	{
 		HPL_RTTI_CLASS(iResourceBase, "{d9cd842a-c76b-4261-879f-53f1baa5ff7c}")
@@ -62,7 +65,11 @@ namespace hpl {
 
 		unsigned long GetTime(){return mlTime;}
 		unsigned long GetPrio(){return mlPrio;}
-		unsigned long GetSize(){return mlSize;}
+		/**
+		 * Approximate number of bytes the resource keeps in memory, set by the manager when it is loaded.
+		 */
+		size_t GetSize(){return mlSize;}
+		void SetSize(size_t alSize){ mlSize = alSize;}
 
 		void SetLogDestruction(bool abX){ mbLogDestruction = abX;}
 
@@ -82,14 +89,19 @@ namespace hpl {
 
 		unsigned int mlPrio; //dunno if this will be of any use.
 		unsigned long mlTime; //Time for creation.
-		unsigned long mlSize; //for completion. Not used yet.
+		size_t mlSize;
 
 		unsigned int mlUserCount;
         unsigned long mlHandle;
 		bool mbLogDestruction;
 
 	private:
+		friend class iResourceManager;
+
 		tWString msFullPath;
+
+		bool mbInUnusedList;
+		std::list<iResourceBase*>::iterator mUnusedIt;
 	};
 
 };
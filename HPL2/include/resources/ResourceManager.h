@@ -19,6 +19,7 @@
 
 #pragma once
 
+#include <list>
 #include <map>
 #include "system/SystemTypes.h"
 #include <engine/RTTI.h>
@@ -61,6 +62,27 @@ namespace hpl {
 
 		virtual void Update(float afTimeStep){}
 
+		/**
+		 * Sets how many bytes of resources are kept loaded. Resources without users are kept in a least recently
+		 * used list until the manager is over budget, so getting them again is free. 0 (default) means unused
+		 * resources are only destroyed the way the manager did before, eg by Destroy or DestroyUnused.
+		 */
+		void SetMemoryBudget(size_t alBytes){ mlMemoryBudget = alBytes;}
+		size_t GetMemoryBudget(){ return mlMemoryBudget;}
+
+		/**
+		 * Bytes of all resources in the manager, used and unused.
+		 */
+		size_t GetMemoryUsage(){ return mlMemoryUsage;}
+		size_t GetUnusedMemoryUsage();
+		int GetUnusedCount();
+
+		/**
+		 * Destroys the least recently used resources without users until the manager is within budget.
+		 * Called every frame by cResources.
+		 */
+		void EvictUnused();
+
 	protected:
 		tResourceBaseMap m_mapResources;
 
@@ -83,6 +105,23 @@ namespace hpl {
 		void AddResource(iResourceBase* apResource, bool abLog=true, bool abAddToSet=true);
 		void RemoveResource(iResourceBase* apResource);
 
+		/**
+		 * Call when a resource has lost its last user. Returns true if it is kept in the unused list,
+		 * false if there is no budget and the caller should destroy it as usual.
+		 */
+		bool KeepUnused(iResourceBase* apResource);
+
+		/**
+		 * Removes a resource without users from the manager and frees it. Managers that do not create their
+		 * resources with hplNew override this.
+		 */
+		virtual void DestroyUnusedResource(iResourceBase* apResource);
+
+		size_t mlMemoryBudget;
+		size_t mlMemoryUsage;
+		tResourceBaseList mlstUnused;
+		bool mbDestroyingAll;
+
 		tString GetTabs();
 		static int mlTabCount;
 
@@ -71,6 +71,8 @@ namespace hpl {
 	class iXmlDocument;
 	class cXmlElement;
 	class cBinaryBuffer;
+	class MapPreloader;
+	class cEntityPrototype;
 
 	//-------------------------------------------------------
 
@@ -132,9 +134,13 @@ namespace hpl {
 
 		bool GetCreatesStaticEntity(){ return mbCreatesStaticEntity; }
 
+		/**
+		 * apPrototype is the compiled ent file apRootElem belongs to, if NULL the loader compiles the element itself.
+		 */
 		virtual iEntity3D* Load(const tString &asName, int alID, bool abActive, cXmlElement* apRootElem,
 								const cMatrixf &a_mtxTransform, const cVector3f &avScale,
-								cWorld *apWorld, const tString &asFileName, const tWString &asFullPath, cResourceVarsObject *apInstanceVars)=0;
+								cWorld *apWorld, const tString &asFileName, const tWString &asFullPath, cResourceVarsObject *apInstanceVars,
+								const cEntityPrototype *apPrototype=NULL)=0;
 
 	protected:
 		bool mbCreatesStaticEntity;
@@ -194,6 +200,11 @@ namespace hpl {
 		bool AddLanguageFile(const tString &asFilePath, bool abAddResourceDirs, const tWString &asAltPath = _W(""));
 		void ClearTranslations();
 		const tWString& Translate(const tString& asCat, const tString& asName);
+		const tWString& Translate(tLanguageEntryId alId);
+		/**
+		 * Id of a language entry that can be kept and passed to Translate, it stays valid when the language changes.
+		 */
+		tLanguageEntryId GetTranslationId(const tString& asCat, const tString& asName);
 
 		void AddEntityLoader(iEntityLoader* apLoader, bool abSetAsDefault=false);
 		iEntityLoader* GetEntityLoader(const tString& asName);
@@ -202,6 +213,10 @@ namespace hpl {
 		iAreaLoader* GetAreaLoader(const tString& asName);
 
 		bool LoadResourceDirsFile(const tString &asFile, const tWString &asAltPath = _W(""));
+		/**
+		 * Loads a manifest written by the texture cooker. Textures listed in it are loaded from the cooked file instead.
+		 */
+		bool LoadCookedTexturesFile(const tWString &asFile);
 
 		iXmlDocument* LoadXmlDocument(const tString& asFile);
 		void DestroyXmlDocument(iXmlDocument* apDoc);
@@ -225,6 +240,8 @@ namespace hpl {
 		cAnimationManager* GetAnimationManager(){ return mpAnimationManager;}
 		cEntFileManager* GetEntFileManager(){ return mpEntFileManager; }
 
+		MapPreloader* GetMapPreloader(){ return mpMapPreloader; }
+
 		iLowLevelSystem* GetLowLevelSystem(){ return mpLowLevelSystem;}
 
 		static void SetForceCacheLoadingAndSkipSaving(bool abX){ mbForceCacheLoadingAndSkipSaving = abX;}
@@ -251,6 +268,8 @@ namespace hpl {
 		cAnimationManager *mpAnimationManager;
 		cEntFileManager *mpEntFileManager;
 
+		MapPreloader *mpMapPreloader;
+
 		cLanguageFile *mpLanguageFile;
 
 		cMeshManager* mpMeshManager;
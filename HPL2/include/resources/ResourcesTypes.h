@@ -56,6 +56,16 @@ namespace hpl {
 
 	//-------------------------------------------------------
 
+	/**
+	 * Index of a language entry (category + name). Ids stay the same for as long as the program runs,
+	 * also when another language is loaded, so they can be looked up once and kept.
+	 */
+	typedef int tLanguageEntryId;
+
+	#define kLanguageEntryId_None	(-1)
+
+	//-------------------------------------------------------
+
 	class cEFL_LightBillboardConnection
 	{
 	public:
@@ -33,6 +33,7 @@ namespace hpl {
 	class cResources;
 	class iTexture;
 	class cBitmapLoaderHandler;
+	class cBitmap;
 	//------------------------------------------------------
 
 	typedef std::map<tString, iTexture*> tTextureAttenuationMap;
@@ -114,9 +115,24 @@ namespace hpl {
 
 		void Update(float afTimeStep);
 
-		int GetMemoryUsage(){ return mlMemoryUsage;}
+
+		/**
+		 * Decodes the bitmaps of all images in the list that are not loaded yet on several threads.
+		 * The Create*Image calls that follow for those names only need to upload the data.
+		 */
+		void PrepareImages(const tStringVec& avNames);
+
+		void ResetDecodeStats();
+		int GetDecodedBitmapCount(){ return mlDecodedBitmapCount;}
+		unsigned long GetBitmapDecodeTime(){ return mlBitmapDecodeTime;}
+
+	protected:
+		void DestroyUnusedResource(iResourceBase* apResource);
 
 	private:
+		cBitmap* LoadImageBitmap(const tWString& asPath);
+		void LoadImageBitmaps(const tWStringVec& avPaths, std::vector<cBitmap*>& avBitmaps);
+		void DestroyPreparedBitmaps();
 
 		Image* _wrapperImageResource(const tString& asName, std::function<Image*(const tString& asName, const tWString& path, cBitmap* bitmap)> createImageHandler);
 
@@ -127,7 +143,10 @@ namespace hpl {
 
 		tStringVec mvCubeSideSuffixes;
 
-		int mlMemoryUsage;
+
+		std::map<tWString, cBitmap*> m_preparedBitmaps;
+		int mlDecodedBitmapCount;
+		unsigned long mlBitmapDecodeTime;
 
 		cGraphics* mpGraphics;
 		cResources* mpResources;
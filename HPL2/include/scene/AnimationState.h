@@ -118,6 +118,15 @@ namespace hpl {
 		float GetFadeStep(){ return mfFadeStep;}
 		void SetFadeStep(float afX){ mfFadeStep = afX;}
 
+		/**
+		 * Key frame cursor for a track in the animation, passed to cAnimationTrack::ApplyToNode.
+		 */
+		int* GetTrackCursor(int alTrack)
+		{
+			if(alTrack >= (int)mvTrackCursors.size()) mvTrackCursors.resize(alTrack+1, 0);
+			return &mvTrackCursors[alTrack];
+		}
+
 	private:
 		tString msName;
 
@@ -126,6 +135,7 @@ namespace hpl {
 		cAnimation* mpAnimation;
 
 		std::vector<cAnimationEvent*> mvEvents;
+		std::vector<int> mvTrackCursors;
 
 		//Properties of the animation
 		float mfLength;
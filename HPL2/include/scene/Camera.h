@@ -197,6 +197,21 @@ namespace hpl {
 		cMatrixf& GetPrevView(){ return m_mtxPrevView;}
 		cMatrixf& GetPrevProjection(){ return m_mtxPrevProjection;}
 
+		//////////////////////////////////////////////////
+		////////// INTERPOLATION /////////////////////////
+		//////////////////////////////////////////////////
+
+		/**
+		 * Keeps the view at the end of a logic update, see iEntity3D::EndInterpolationTick.
+		 */
+		void EndInterpolationTick();
+		/**
+		 * Sets the position and view inbetween the last two logic updates until RestoreInterpolation is called.
+		 * Nothing is done if the camera was changed after the last update.
+		 */
+		void ApplyInterpolation(float afT);
+		void RestoreInterpolation();
+
 	private:
 		void UpdateMoveMatrix();
 
@@ -235,6 +250,14 @@ namespace hpl {
 
 		cFrustum mFrustum;
 
+		cVector3f mvInterpolationPrevPosition;
+		cVector3f mvInterpolationPosition;
+		cMatrixf m_mtxInterpolationPrevView;
+		cMatrixf m_mtxInterpolationView;
+		cVector3f mvInterpolationRestorePosition;
+		int mlInterpolationTick;
+		bool mbInterpolationApplied;
+
 		bool mbInfFarPlane;
 
 		bool mbViewUpdated;
@@ -21,6 +21,7 @@
 #define HPL_ENTITY3D_H
 
 #include <list>
+#include <vector>
 #include "engine/RTTI.h"
 #include "math/MathTypes.h"
 #include "system/SystemTypes.h"
@@ -54,6 +55,7 @@ namespace hpl {
 	class iEntity3D
 	{
 		HPL_RTTI_CLASS(iEntity3D, "{5349d61b-bec3-4b44-9cf7-9c683dc59602}")
+		friend class cNode3D;
 	public:
 		iEntity3D(tString asName);
 		virtual ~iEntity3D();
@@ -125,9 +127,57 @@ namespace hpl {
 		inline int GetIteratorCount(){ return mlIteratorCount;}
 		inline void SetIteratorCount(const int alX){ mlIteratorCount = alX;}
 
+		/**
+		 * Changing the transform of an entity only marks its children as pending, they are updated when one of them
+		 * is asked for its world transform or when this is called. Called once per frame before rendering.
+		 */
+		static void UpdatePendingTransforms();
+		static size_t GetPendingTransformNum(){ return mvPendingTransformEntities.size();}
+
+		/**
+		 * Interpolated rendering. When enabled, entities moved during a logic update keep their world transform
+		 * from before and after it, and ApplyInterpolation puts them inbetween until RestoreInterpolation is called.
+		 * EndInterpolationTick must be called after each logic update.
+		 */
+		static void SetInterpolationEnabled(bool abX);
+		static bool GetInterpolationEnabled(){ return mbInterpolationEnabled;}
+		static void EndInterpolationTick();
+		/**
+		 * \param afT How far the current time is between the last two logic updates, 0 is the previous and 1 the last.
+		 */
+		static void ApplyInterpolation(float afT);
+		static void RestoreInterpolation();
+		static bool GetInterpolationApplied(){ return mbInterpolationApplied;}
+		static float GetInterpolationFraction(){ return mfInterpolationFraction;}
+		/**
+		 * The number of the logic update running now, the last one that ended is one less.
+		 */
+		static int GetInterpolationTick(){ return mlInterpolationTick;}
+		static size_t GetInterpolatedNum(){ return mvInterpolatedEntities.size();}
+		/**
+		 * Moving further than this in one logic update is taken as a teleport and is not interpolated.
+		 */
+		static void SetInterpolationMaxDistance(float afX){ mfInterpolationMaxDistance = afX;}
+		static float GetInterpolationMaxDistance(){ return mfInterpolationMaxDistance;}
+
+		/**
+		 * If the world transform is interpolated when rendering, true for renderables.
+		 */
+		void SetRenderInterpolated(bool abX){ mbRenderInterpolated = abX;}
+		bool GetRenderInterpolated(){ return mbRenderInterpolated;}
+
 	protected:
 		virtual void OnTransformUpdated(){}
 		virtual void OnUpdateWorldTransform(){}
+		/**
+		 * Called at the end of a logic update if the transform was updated or RequestInterpolationTick was called.
+		 */
+		virtual void OnInterpolationTick(){}
+
+		/**
+		 * Makes OnInterpolationTick get called at the end of the current logic update.
+		 */
+		void RequestInterpolationTick();
 
 		cNode3D* mpParentNode;
 
@@ -160,6 +210,41 @@ namespace hpl {
 		int mlIteratorCount;
 	private:
 		void UpdateWorldTransform();
+
+		void MarkTransformUpdated(bool abUpdateCallbacks);
+		void PropagateTransformToChildren();
+		void ResolvePendingParentTransforms();
+
+		static iEntity3D* GetTopPendingEntity(iEntity3D *apParent, cNode3D *apParentNode);
+		static int GetHierarchyDepth(iEntity3D *apEntity);
+
+		bool mbChildTransformsPending;
+		bool mbInPendingTransformQueue;
+		int mlResolvedTransformGeneration;
+
+		//The pending transform lists are shared by all worlds and not locked, entities must only be moved,
+		//created and destroyed on the main thread.
+		static std::vector<iEntity3D*> mvPendingTransformEntities;
+		static std::vector<std::pair<int, iEntity3D*> > mvSortedPendingTransformEntities;
+		static int mlTransformGeneration;
+
+		bool mbRenderInterpolated;
+		bool mbInInterpolationQueue;
+		bool mbInInterpolatedList;
+		bool mbInterpolatedTransformSet;
+		int mlInterpolationKeptTick;
+		cMatrixf m_mtxInterpolationPrev;
+		cMatrixf m_mtxInterpolationCurrent;
+
+		static std::vector<iEntity3D*> mvInterpolationQueue;
+		static std::vector<iEntity3D*> mvInterpolatedEntities;
+		static std::vector<iEntity3D*> mvInterpolationAppliedEntities;
+		static bool mbInterpolationEnabled;
+		static bool mbInterpolationApplied;
+		static float mfInterpolationFraction;
+		static int mlInterpolationTick;
+		static int mlInterpolationStartTick;
+		static float mfInterpolationMaxDistance;
 	};
 
 };
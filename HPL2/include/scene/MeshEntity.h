@@ -114,8 +114,36 @@ namespace hpl {
 		void SetNormalizeAnimationWeights(bool abX){ mbNormalizeAnimationWeights = abX;}
 		bool GetNormalizeAnimationWeights(){  return mbNormalizeAnimationWeights;}
 
+		/**
+		 * When active, the skeleton pose is updated less often when the entity is far away or was not rendered
+		 * last frame. Animation times, fades and events are still updated every frame. A skipped pose is built
+		 * when a bone state is fetched through GetBoneState, GetBoneStateFromName or GetBoneStateRoot, so these
+		 * are always up to date. Entities attached to bones only move when the pose is built. Not used on
+		 * entities with skeleton colliders. Off unless set or turned on with SetAnimationLodActiveByDefault.
+		 */
+		void SetAnimationLodActive(bool abX){ mbAnimationLodActive = abX;}
+		bool GetAnimationLodActive(){ return mbAnimationLodActive;}
+
+		/**
+		 * If animation LOD is active for mesh entities created from now on.
+		 */
+		static void SetAnimationLodActiveByDefault(bool abX){ mbAnimationLodActiveByDefault = abX;}
+
+		/**
+		 * Position that the animation LOD distances are measured from, usually the camera. Set each frame.
+		 */
+		static void SetAnimationLodOrigin(const cVector3f& avPos){ mvAnimationLodOrigin = avPos; mbAnimationLodOriginSet = true;}
+		/**
+		 * Beyond afHalfRateDist the pose is updated every other frame and beyond afQuarterRateDist every fourth.
+		 */
+		static void SetAnimationLodDistances(float afHalfRateDist, float afQuarterRateDist){ mfAnimationLodHalfRateDist = afHalfRateDist; mfAnimationLodQuarterRateDist = afQuarterRateDist;}
+		/**
+		 * Number of frames between pose updates when the entity was not rendered.
+		 */
+		static void SetAnimationLodHiddenInterval(int alFrames){ mlAnimationLodHiddenInterval = alFrames;}
+
 		//Bone states
-		cNode3D* GetBoneStateRoot(){ return mpBoneStateRoot;}
+		cNode3D* GetBoneStateRoot(){ if(mbBonePoseOutdated) UpdateOutdatedBonePose(); return mpBoneStateRoot;}
 
 		cBoneState* GetBoneState(int alIndex);
 		int GetBoneStateIndex(const tString &asName);
@@ -200,7 +228,14 @@ namespace hpl {
 		void* GetUserData() { return mpUserData; }
 
 	private:
+		void OnInterpolationTick();
+
 		float GetAnimationWeightMul();
+		bool UpdateAnimationLod();
+		void ApplyAnimationToBones(cAnimationState *apAnimState, float afTimePos, float afWeight);
+		void UpdateOutdatedBonePose();
+
+		void GetBoneMatrices(std::vector<cMatrixf> &avMatrices);
 
 		void CreateNodes();
 
@@ -248,6 +283,12 @@ namespace hpl {
 
 		std::vector<cMatrixf> mvBoneMatrices;
 
+		std::vector<cMatrixf> mvPrevTickBoneMatrices;
+		std::vector<cMatrixf> mvTickBoneMatrices;
+		int mlTickBoneMatricesTick;
+		int mlBoneMatricesInterpolationTick;
+		float mfBoneMatricesInterpolationFraction;
+
 		bool mbSkeletonPhysics;
 		bool mbSkeletonPhysicsFading;
 		float mfSkeletonPhysicsFadeSpeed;
@@ -263,6 +304,21 @@ namespace hpl {
 		bool mbUpdatedBones;
 		bool mbHasUpdatedAnimation;
 
+		bool mbAnimationLodActive;
+		int mlAnimationLodFrameCount;
+
+		bool mbBonePoseOutdated;
+		std::vector<float> mvOutdatedPoseTimes;
+		std::vector<float> mvOutdatedPoseWeights;
+
+		static cVector3f mvAnimationLodOrigin;
+		static bool mbAnimationLodOriginSet;
+		static bool mbAnimationLodActiveByDefault;
+		static float mfAnimationLodHalfRateDist;
+		static float mfAnimationLodQuarterRateDist;
+		static int mlAnimationLodHiddenInterval;
+		static int mlAnimationLodStagger;
+
 		tNodeStateVec mvNodeStates;
 		tNodeStateIndexMap m_mapNodeStateIndices;
 
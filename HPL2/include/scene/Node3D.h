@@ -133,6 +133,7 @@ namespace hpl {
 		cVector3f mvTranslation;
 
 		bool mbTransformUpdated;
+		int mlResolvedTransformGeneration;
 
 		cNode3D* mpParent;
 		iEntity3D* mpEntityParent;
@@ -168,6 +168,11 @@ namespace hpl {
 
 		int GetParticleNum(){ return mlNumOfParticles;}
 
+		/**
+		 * Memory an emitter with alMaxParticles allocates, the particles and their vertices and indices.
+		 */
+		static size_t GetAllocatedSize(unsigned int alMaxParticles);
+
 		//Entity implementation
 		virtual tString GetEntityType() override { return "ParticleEmitter"; }
 		virtual bool IsVisible() override;
@@ -276,6 +281,8 @@ namespace hpl {
 
 		virtual iParticleEmitter* Create(tString asName, cVector3f avSize)=0;
 
+		virtual int GetMaxParticleNum()=0;
+
 		float GetWarmUpTime() const { return mfWarmUpTime;}
 		float GetWarmUpStepsPerSec() const { return mfWarmUpStepsPerSec;}
 
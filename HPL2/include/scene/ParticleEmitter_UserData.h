@@ -81,6 +81,8 @@ namespace hpl {
 
 		iParticleEmitter* Create(tString asName, cVector3f avSize);
 
+		int GetMaxParticleNum(){ return mlMaxParticleNum;}
+
 		void LoadFromElement(cXmlElement *apElement);
 		void LoadFromElement(::rapidxml::xml_node<char>*apElement);
 
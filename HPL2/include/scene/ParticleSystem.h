@@ -63,6 +63,11 @@ namespace hpl {
 
 		iParticleEmitterData* GetEmitterData(int alIdx) const { return mvEmitterData[alIdx]; }
 
+		/**
+		 * Memory each system created from the data allocates for its emitters.
+		 */
+		size_t GetAllocatedSize();
+
 	private:
 		cResources* mpResources;
 		cGraphics *mpGraphics;
@@ -70,6 +70,13 @@ namespace hpl {
 
 		void Update(float timeStep);
 
+		/**
+		 * Interpolated rendering of entities and cameras, called by cEngine. See iEntity3D::EndInterpolationTick.
+		 */
+		void EndInterpolationTick();
+		void ApplyInterpolation(float afT);
+		void RestoreInterpolation();
+
 		///// VIEW PORT METHODS ////////////////////
 
 		cViewport* CreateViewport(cCamera *apCamera=NULL, cWorld *apWorld=NULL, bool abPushFront = false);
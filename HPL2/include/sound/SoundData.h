@@ -43,6 +43,11 @@ namespace hpl {
 
 		virtual bool IsStereo()=0;
 
+		/**
+		 * Size in bytes of the decoded sample data kept in memory.
+		 */
+		virtual size_t GetMemorySize()=0;
+
 		bool IsStream(){ return mbStream;}
 		void SetLoopStream(bool abX){mbLoopStream = abX;}
 		bool GetLoopStream(){ return mbLoopStream;}
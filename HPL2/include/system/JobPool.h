@@ -0,0 +1,85 @@
+/*
+ * Copyright © 2009-2020 Frictional Games
+ *
+ * This file is part of Amnesia: The Dark Descent.
+ *
+ * Amnesia: The Dark Descent is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * Amnesia: The Dark Descent is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Amnesia: The Dark Descent.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef HPL_JOB_POOL_H
+#define HPL_JOB_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace hpl {
+
+	//--------------------------------------------
+
+	/**
+	 * Worker threads that are started once and kept, for splitting work over the cores without creating
+	 * threads for every batch. The calling thread always takes part, so a batch is done even if all workers
+	 * are busy, and batches can be started from within a batch.
+	 */
+	class cJobPool
+	{
+	public:
+		cJobPool(int alWorkerNum);
+		~cJobPool();
+
+		/**
+		 * The pool shared by the engine, with a worker less than there are cores as the caller helps out.
+		 */
+		static cJobPool* GetDefault();
+
+		/**
+		 * Calls aFunc for every index from 0 to alCount-1 and returns once all are done. At most alMaxThreads
+		 * threads, the caller included, work on it at the same time. Indices are handed out one at a time.
+		 */
+		void ParallelFor(size_t alCount, const std::function<void(size_t)>& aFunc, int alMaxThreads = -1);
+
+		int GetWorkerNum(){ return (int)mvWorkers.size();}
+
+	private:
+		class cBatch
+		{
+		public:
+			const std::function<void(size_t)> *mpFunc;
+			size_t mlCount;
+			std::atomic<size_t> mlNext;
+			int mlMaxWorkers;
+			int mlActiveWorkers;
+		};
+
+		void RunBatch(cBatch *apBatch);
+		void WorkerThread();
+
+		std::vector<std::thread> mvWorkers;
+		std::deque<cBatch*> mlstBatches;
+		bool mbQuit;
+		std::mutex mMutex;
+		std::condition_variable mWorkCondition;
+		std::condition_variable mDoneCondition;
+	};
+
+	//--------------------------------------------
+
+};
+
+#endif // HPL_JOB_POOL_H
@@ -48,7 +48,8 @@ namespace hpl {
 		bool WantUpdate();
 
 		/**
-		 * Resets various variables that makes the graphics is never frozen.
+		 * Resets various variables that makes the graphics is never frozen. If the updates could not keep up
+		 * (the max was reached or they take longer to run than the time they step), the time left to catch up is dropped.
 		 */
 		void EndUpdateLoop();
 
@@ -73,6 +74,12 @@ namespace hpl {
 		 */
 		float GetStepSize();
 
+		/**
+		 * How far the current time is between the last two updates, from 0 (at the previous one) to 1 (at the last one).
+		 * Used to interpolate what is rendered between updates.
+		 */
+		float GetInterpolationFraction();
+
 		double GetLocalTime(){ return mlLocalTime;}
 		double GetLocalTimeAdd(){ return mlLocalTimeAdd;}
 
@@ -89,6 +96,9 @@ namespace hpl {
 		int mlMaxUpdates;
 		int mlUpdateCount;
 
+		double mlUpdateLoopStartTime;
+		bool mbDropUpdates;
+
 		iLowLevelSystem *mpLowLevelSystem;
 	};
 
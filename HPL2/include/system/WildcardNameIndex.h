@@ -0,0 +1,101 @@
+/*
+ * Copyright © 2009-2020 Frictional Games
+ *
+ * This file is part of Amnesia: The Dark Descent.
+ *
+ * Amnesia: The Dark Descent is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * Amnesia: The Dark Descent is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Amnesia: The Dark Descent.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef HPL_WILDCARD_NAME_INDEX_H
+#define HPL_WILDCARD_NAME_INDEX_H
+
+#include "system/SystemTypes.h"
+
+#include <map>
+#include <unordered_map>
+
+namespace hpl {
+
+	//--------------------------------------------
+
+	/**
+	 * A wildcard pattern split at '*'. A name matches when it contains every segment, the same way
+	 * as splitting with cString::GetStringVec and testing each part with cString::GetFirstStringPos.
+	 * Segments are not anchored and do not need to come in order, so "lamp_*" also matches "old_lamp_2".
+	 */
+	class cWildcardPattern
+	{
+	public:
+		tStringVec mvSegments;
+		//For each segment the n-gram keys to look up, a single key for segments shorter than three chars.
+		std::vector<std::vector<unsigned int> > mvSegmentGrams;
+	};
+
+	//--------------------------------------------
+
+	/**
+	 * Index of names for wildcard lookups. Every name is stored with its 1, 2 and 3 char grams, a lookup
+	 * walks the shortest gram list among the pattern segments and tests only those names. Results are
+	 * sorted by the order value given when adding, so a caller that adds with an increasing counter gets
+	 * them back in the order they were added. Compiled patterns are kept between lookups.
+	 */
+	class cWildcardNameIndex
+	{
+	public:
+		cWildcardNameIndex();
+		~cWildcardNameIndex();
+
+		void Add(void *apData, int alOrder, const tString& asName);
+		void Remove(int alOrder);
+		void Clear();
+
+		/**
+		 * Gets the data of all matching names, sorted by order. A pattern with no segments, such as "*", matches all.
+		 */
+		void Find(const tString& asPattern, std::vector<void*>& avData);
+
+		int GetSize(){ return (int)m_mapEntries.size();}
+
+		const cWildcardPattern* GetPattern(const tString& asPattern);
+
+	private:
+		class cEntry
+		{
+		public:
+			void *mpData;
+			tString msName;
+		};
+
+		typedef std::map<int, cEntry> tEntryMap;
+		typedef tEntryMap::iterator tEntryMapIt;
+
+		typedef std::unordered_map<unsigned int, tIntVec> tGramMap;
+		typedef tGramMap::iterator tGramMapIt;
+
+		typedef std::map<tString, cWildcardPattern> tPatternMap;
+		typedef tPatternMap::iterator tPatternMapIt;
+
+		void GetNameGrams(const tString& asName, std::vector<unsigned int>& avGrams);
+
+		tEntryMap m_mapEntries;
+		tGramMap m_mapGrams;
+		tPatternMap m_mapPatterns;
+
+		std::vector<unsigned int> mvTempGrams;
+	};
+
+	//--------------------------------------------
+
+};
+#endif // HPL_WILDCARD_NAME_INDEX_H
@@ -511,6 +511,9 @@ namespace hpl {
 	bool cAINodeContainer::FreePath(const cVector3f &avStart, const cVector3f &avEnd, int alRayNum,
 									tAIFreePathFlag aFlags,iAIFreePathCallback *apCallback)
 	{
+		//Containers without a world (eg in tools and benchmarks) have nothing to collide with
+		if(mpWorld==NULL) return true;
+
 		iPhysicsWorld *pPhysicsWorld = mpWorld->GetPhysicsWorld();
 		if(pPhysicsWorld==NULL) return true;
 
@@ -25,15 +25,20 @@
 #include "system/System.h"
 #include "system/String.h"
 #include "system/Platform.h"
+#include "system/JobPool.h"
 
 #include "resources/Resources.h"
 #include "resources/FileSearcher.h"
+#include "resources/BinaryBuffer.h"
 
 #include "physics/PhysicsWorld.h"
 #include "physics/PhysicsBody.h"
+#include "physics/CollideShape.h"
 
 #include "impl/tinyXML/tinyxml.h"
 
+#include <algorithm>
+
 
 namespace hpl {
 
@@ -81,6 +86,79 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 
+	class cNodeRayCallback : public iPhysicsRayCallback
+	{
+	public:
+		bool OnIntersect(iPhysicsBody *pBody,cPhysicsRayParams *apParams)
+		{
+			if(pBody->GetMass() != 0) return true;
+
+			mpNodes->push_back(apParams->mvPoint + cVector3f(0,mfHeightFromGround,0));
+
+			return true;
+		}
+
+		std::vector<cVector3f> *mpNodes;
+		float mfHeightFromGround;
+	};
+
+	//-----------------------------------------------------------------------
+
+	#define kAINodeGeneratorTileCells (32)
+	#define kAINodeGeneratorMaxCachedTiles (16384)
+
+	static inline uint64_t HashData(uint64_t alHash, const void *apData, size_t alSize)
+	{
+		const unsigned char *pData = (const unsigned char*)apData;
+		for(size_t i=0; i<alSize; ++i)
+		{
+			alHash ^= pData[i];
+			alHash *= 1099511628211ULL;
+		}
+		return alHash;
+	}
+
+	template<class T> static inline uint64_t HashValue(uint64_t alHash, const T& aX)
+	{
+		return HashData(alHash, &aX, sizeof(T));
+	}
+
+	//Map geometry is merged into mesh shapes and compounds, so an edit can stay within the bounds of the
+	//body. Mesh shapes hash their serialized collision and compounds each sub shape with its offset.
+	static uint64_t HashShape(uint64_t alHash, iCollideShape *apShape, iPhysicsWorld *apWorld)
+	{
+		alHash = HashValue(alHash, apShape->GetType());
+		alHash = HashValue(alHash, apShape->GetSize());
+		alHash = HashValue(alHash, apShape->GetOffset());
+		alHash = HashValue(alHash, apShape->GetVolume());
+
+		if(apShape->GetType() == eCollideShapeType_Mesh)
+		{
+			cBinaryBuffer buffer;
+			apWorld->SaveMeshShapeToBuffer(apShape, &buffer);
+			alHash = HashData(alHash, buffer.GetDataPointer(), buffer.GetSize());
+		}
+
+		alHash = HashValue(alHash, apShape->GetSubShapeNum());
+		for(int i=0; i<apShape->GetSubShapeNum(); ++i)
+		{
+			alHash = HashShape(alHash, apShape->GetSubShape(i), apWorld);
+		}
+		return alHash;
+	}
+
+	//-----------------------------------------------------------------------
+
+	class cAINodeGeneratorBody
+	{
+	public:
+		cVector3f mvMin;
+		cVector3f mvMax;
+		uint64_t mlHash;
+	};
+
+	//-----------------------------------------------------------------------
+
 	//////////////////////////////////////////////////////////////////////////
 	// CONSTRUCTORS
 	//////////////////////////////////////////////////////////////////////////
@@ -89,7 +167,8 @@ namespace hpl {
 
 	cAINodeGenerator::cAINodeGenerator()
 	{
-
+		mlMaxThreads = cJobPool::GetDefault()->GetWorkerNum() + 1;
+		mlGenerateCount = 0;
 	}
 
 	cAINodeGenerator::~cAINodeGenerator()
@@ -105,10 +184,6 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 
-	static cCollideRayCallback gCollideRayCallback;
-
-	//-----------------------------------------------------------------------
-
 	void cAINodeGenerator::Generate(cWorld* apWorld,cAINodeGeneratorParams *apParams)
 	{
 		mpWorld = apWorld;
@@ -191,67 +266,146 @@ namespace hpl {
 
 
 		/////////////////////////////////////////
-		//Place the nodes in the world
-		cVector3f vPos(vWorldMin.x,0,vWorldMin.z);
-
-		while(vPos.z <= vWorldMax.z)
+		//Get the grid positions, added up the same way as when the whole grid was cast in one go so the rays are the same
+		std::vector<float> vX;
+		std::vector<float> vZ;
+		for(float fX = vWorldMin.x; vX.empty() || fX <= vWorldMax.x; fX += apParams->mfGridSize) vX.push_back(fX);
+		for(float fZ = vWorldMin.z; fZ <= vWorldMax.z; fZ += apParams->mfGridSize) vZ.push_back(fZ);
+		if(vZ.empty())
 		{
-			cVector3f vStart(vPos.x, vWorldMax.y, vPos.z);
-			cVector3f vEnd(vPos.x, vWorldMin.y, vPos.z);
+			SaveToFile();
+			return;
+		}
 
-			pPhysicsWorld->CastRay(this,vStart,vEnd,false,false,true);
+		int lTilesX = ((int)vX.size() + kAINodeGeneratorTileCells-1) / kAINodeGeneratorTileCells;
+		int lTilesZ = ((int)vZ.size() + kAINodeGeneratorTileCells-1) / kAINodeGeneratorTileCells;
+		int lTileNum = lTilesX * lTilesZ;
 
-			//Log("Pos: %s Min: %s Max: %s\n",vPos.ToString().c_str(),
-			//								vWorldMin.ToString().c_str(),
-			//								vWorldMax.ToString().c_str());
+		/////////////////////////////////////////
+		//Hash everything that is the same for all tiles
+		uint64_t lBaseHash = 14695981039346656037ULL;
+		lBaseHash = HashData(lBaseHash, mpParams->msNodeType.c_str(), mpParams->msNodeType.size());
+		lBaseHash = HashValue(lBaseHash, mpParams->mfHeightFromGround);
+		lBaseHash = HashValue(lBaseHash, mpParams->mfMinWallDist);
+		lBaseHash = HashValue(lBaseHash, mpParams->mfGridSize);
+		lBaseHash = HashValue(lBaseHash, vWorldMin.y);
+		lBaseHash = HashValue(lBaseHash, vWorldMax.y);
+
+		std::vector<uint64_t> vTileHashes(lTileNum, lBaseHash);
+		for(int z=0; z<lTilesZ; ++z)
+		for(int x=0; x<lTilesX; ++x)
+		{
+			uint64_t &lHash = vTileHashes[z*lTilesX + x];
+			lHash = HashValue(lHash, vX[x*kAINodeGeneratorTileCells]);
+			lHash = HashValue(lHash, vZ[z*kAINodeGeneratorTileCells]);
+			lHash = HashValue(lHash, std::min((int)vX.size() - x*kAINodeGeneratorTileCells, kAINodeGeneratorTileCells));
+			lHash = HashValue(lHash, std::min((int)vZ.size() - z*kAINodeGeneratorTileCells, kAINodeGeneratorTileCells));
+		}
 
-			vPos.x += apParams->mfGridSize;
-			if(vPos.x > vWorldMax.x)
+		/////////////////////////////////////////
+		//Add the static bodies to the hashes of the tiles they can be hit in. Nodes are pushed from walls,
+		//so the rays can reach up to twice the wall distance outside of a tile.
+		float fTileSize = mpParams->mfGridSize * kAINodeGeneratorTileCells;
+		float fMargin = mpParams->mfMinWallDist*2 + mpParams->mfGridSize;
+
+		cPhysicsBodyIterator staticIt = pPhysicsWorld->GetBodyIterator();
+		while(staticIt.HasNext())
+		{
+			iPhysicsBody *pBody = staticIt.Next();
+			if(pBody->GetMass() != 0 || pBody->IsActive()==false) continue;
+
+			cAINodeGeneratorBody body;
+			body.mvMin = pBody->GetBoundingVolume()->GetMin();
+			body.mvMax = pBody->GetBoundingVolume()->GetMax();
+
+			iCollideShape *pShape = pBody->GetShape();
+			body.mlHash = HashData(14695981039346656037ULL, pBody->GetName().c_str(), pBody->GetName().size());
+			body.mlHash = HashValue(body.mlHash, body.mvMin);
+			body.mlHash = HashValue(body.mlHash, body.mvMax);
+			body.mlHash = HashValue(body.mlHash, pBody->GetWorldMatrix());
+			if(pShape) body.mlHash = HashShape(body.mlHash, pShape, pPhysicsWorld);
+
+			int lMinX = cMath::Max((int)floor((body.mvMin.x - fMargin - vX[0]) / fTileSize), 0);
+			int lMaxX = cMath::Min((int)floor((body.mvMax.x + fMargin - vX[0]) / fTileSize), lTilesX-1);
+			int lMinZ = cMath::Max((int)floor((body.mvMin.z - fMargin - vZ[0]) / fTileSize), 0);
+			int lMaxZ = cMath::Min((int)floor((body.mvMax.z + fMargin - vZ[0]) / fTileSize), lTilesZ-1);
+
+			for(int z=lMinZ; z<=lMaxZ; ++z)
+			for(int x=lMinX; x<=lMaxX; ++x)
 			{
-				vPos.x = vWorldMin.x;
-				vPos.z +=  apParams->mfGridSize;
+				uint64_t &lHash = vTileHashes[z*lTilesX + x];
+				lHash = HashValue(lHash, body.mlHash);
 			}
 		}
 
 		/////////////////////////////////////////
-		//Check so that the nodes are not too close to walls
-		cVector3f vEnds[4] = {	cVector3f(mpParams->mfMinWallDist,0,0),
-									cVector3f(-mpParams->mfMinWallDist,0,0),
-									cVector3f(0,0,mpParams->mfMinWallDist),
-									cVector3f(0,0,-mpParams->mfMinWallDist)
-							};
+		//Use the cached tiles that are unchanged and cast the rest
+		++mlGenerateCount;
 
-		cVector3f vPushBackDirs[4] = {	cVector3f(-1,0,0),
-										cVector3f(1,0,0),
-										cVector3f(0,0,-1),
-										cVector3f(0,0,1)
-								};
+		std::vector<cAINodeGeneratorTile*> vTiles(lTileNum);
+		std::vector<int> vTilesToCast;
+		for(int i=0; i<lTileNum; ++i)
+		{
+			cAINodeGeneratorTile &tile = m_mapTiles[vTileHashes[i]];
+			if(tile.mvCellNodeNum.empty()) vTilesToCast.push_back(i);
 
-		tTempAiNodeListIt nodeIt = mpNodeList->begin();
-		for(; nodeIt != mpNodeList->end(); ++nodeIt)
+			tile.mlHash = vTileHashes[i];
+			tile.mlLastUsed = mlGenerateCount;
+			vTiles[i] = &tile;
+		}
+
+		//Tiles are handed out one at a time on the job pool
+		cJobPool::GetDefault()->ParallelFor(vTilesToCast.size(), [&](size_t alIdx)
 		{
-			cTempAiNode &Node = *nodeIt;
+			int lTile = vTilesToCast[alIdx];
+			int lTileX = lTile % lTilesX;
+			int lTileZ = lTile / lTilesX;
+			GenerateTile(	vTiles[lTile], pPhysicsWorld, vWorldMin, vWorldMax, vX, vZ,
+							lTileX*kAINodeGeneratorTileCells, std::min((lTileX+1)*kAINodeGeneratorTileCells, (int)vX.size()),
+							lTileZ*kAINodeGeneratorTileCells, std::min((lTileZ+1)*kAINodeGeneratorTileCells, (int)vZ.size()));
+		}, mlMaxThreads);
 
-			//Check if there are any walls close by.
-			for(int i=0; i<4; ++i)
+		Log("Generated AI nodes '%s': %d tiles, %d cast and %d unchanged\n", mpParams->msNodeType.c_str(), lTileNum,
+			(int)vTilesToCast.size(), lTileNum - (int)vTilesToCast.size());
+
+		/////////////////////////////////////////
+		//Add the nodes in grid order, a row at a time through all the tiles
+		for(int z=0; z<(int)vZ.size(); ++z)
+		{
+			int lTileZ = z / kAINodeGeneratorTileCells;
+			int lRowInTile = z % kAINodeGeneratorTileCells;
+
+			for(int lTileX=0; lTileX<lTilesX; ++lTileX)
 			{
-				gCollideRayCallback.mbIntersected = false;
-				pPhysicsWorld->CastRay(&gCollideRayCallback,Node.mvPos,Node.mvPos + vEnds[i],true,false,true);
+				cAINodeGeneratorTile *pTile = vTiles[lTileZ*lTilesX + lTileX];
+				int lCellsX = std::min((lTileX+1)*kAINodeGeneratorTileCells, (int)vX.size()) - lTileX*kAINodeGeneratorTileCells;
+
+				int lNode =0;
+				for(int i=0; i<lRowInTile*lCellsX; ++i) lNode += pTile->mvCellNodeNum[i];
 
-				if(gCollideRayCallback.mbIntersected)
+				for(int x=0; x<lCellsX; ++x)
 				{
-					//Log("Walldistance %f : Add: (%s) Push (%s) Min: %f\n",gCollideRayCallback.mfDist,
-					//											vEnds[i].ToString().c_str(),
-					//											vPushBackDirs[i].ToString().c_str(),
-					//											mpParams->mfMinWallDist);
-					if(gCollideRayCallback.mfDist < mpParams->mfMinWallDist)
+					int lCellNodeNum = pTile->mvCellNodeNum[lRowInTile*lCellsX + x];
+					for(int i=0; i<lCellNodeNum; ++i, ++lNode)
 					{
-						Node.mvPos += vPushBackDirs[i] * (mpParams->mfMinWallDist - gCollideRayCallback.mfDist);
+						mpNodeList->push_back(cTempAiNode(pTile->mvNodes[lNode],"",mlIDCount));
+						mlIDCount++;
 					}
 				}
 			}
 		}
 
+		/////////////////////////////////////////
+		//Keep the cache from growing forever, when too large only keep the tiles from this world
+		if(m_mapTiles.size() > kAINodeGeneratorMaxCachedTiles)
+		{
+			for(tAINodeGeneratorTileMapIt tileIt = m_mapTiles.begin(); tileIt != m_mapTiles.end(); )
+			{
+				if(tileIt->second.mlLastUsed != mlGenerateCount)	tileIt = m_mapTiles.erase(tileIt);
+				else												++tileIt;
+			}
+		}
+
 		///////////////////////////////////////////
 		// Save to file
 
@@ -264,18 +418,61 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 
-	bool cAINodeGenerator::OnIntersect(iPhysicsBody *pBody,cPhysicsRayParams *apParams)
+	void cAINodeGenerator::GenerateTile(cAINodeGeneratorTile *apTile, iPhysicsWorld *apPhysicsWorld, const cVector3f& avWorldMin, const cVector3f& avWorldMax,
+										const std::vector<float>& avX, const std::vector<float>& avZ, int alStartX, int alEndX, int alStartZ, int alEndZ)
 	{
-		if(pBody->GetMass() != 0) return true;
+		apTile->mvNodes.clear();
+		apTile->mvCellNodeNum.clear();
+		apTile->mvCellNodeNum.reserve((alEndX-alStartX) * (alEndZ-alStartZ));
 
-		iPhysicsWorld *pPhysicsWorld = mpWorld->GetPhysicsWorld();
+		/////////////////////////////////////////
+		//Place the nodes in the tile
+		cNodeRayCallback nodeCallback;
+		nodeCallback.mpNodes = &apTile->mvNodes;
+		nodeCallback.mfHeightFromGround = mpParams->mfHeightFromGround;
+
+		for(int z=alStartZ; z<alEndZ; ++z)
+		for(int x=alStartX; x<alEndX; ++x)
+		{
+			cVector3f vStart(avX[x], avWorldMax.y, avZ[z]);
+			cVector3f vEnd(avX[x], avWorldMin.y, avZ[z]);
 
-		cVector3f vPosition = apParams->mvPoint + cVector3f(0,mpParams->mfHeightFromGround,0);
+			size_t lNodeNum = apTile->mvNodes.size();
+			apPhysicsWorld->CastRay(&nodeCallback,vStart,vEnd,false,false,true);
+			apTile->mvCellNodeNum.push_back((int)(apTile->mvNodes.size() - lNodeNum));
+		}
 
-		mpNodeList->push_back(cTempAiNode(vPosition,"",mlIDCount));
-		mlIDCount++;
+		/////////////////////////////////////////
+		//Check so that the nodes are not too close to walls
+		cVector3f vEnds[4] = {	cVector3f(mpParams->mfMinWallDist,0,0),
+									cVector3f(-mpParams->mfMinWallDist,0,0),
+									cVector3f(0,0,mpParams->mfMinWallDist),
+									cVector3f(0,0,-mpParams->mfMinWallDist)
+							};
 
-		return true;
+		cVector3f vPushBackDirs[4] = {	cVector3f(-1,0,0),
+										cVector3f(1,0,0),
+										cVector3f(0,0,-1),
+										cVector3f(0,0,1)
+								};
+
+		cCollideRayCallback collideCallback;
+		for(size_t lNode=0; lNode<apTile->mvNodes.size(); ++lNode)
+		{
+			cVector3f &vNodePos = apTile->mvNodes[lNode];
+
+			//Check if there are any walls close by.
+			for(int i=0; i<4; ++i)
+			{
+				collideCallback.mbIntersected = false;
+				apPhysicsWorld->CastRay(&collideCallback,vNodePos,vNodePos + vEnds[i],true,false,true);
+
+				if(collideCallback.mbIntersected && collideCallback.mfDist < mpParams->mfMinWallDist)
+				{
+					vNodePos += vPushBackDirs[i] * (mpParams->mfMinWallDist - collideCallback.mfDist);
+				}
+			}
+		}
 	}
 
 	//-----------------------------------------------------------------------
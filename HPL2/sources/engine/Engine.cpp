@@ -27,6 +27,7 @@
 #include <engine/IUpdateEventLoop.h>
 #include "engine/Interface.h"
 #include "graphics/Enum.h"
+#include "graphics/GraphicsAllocator.h"
 #include "system/System.h"
 #include "sound/Sound.h"
 #include "physics/Physics.h"
@@ -36,15 +37,18 @@
 #include "gui/Gui.h"
 #include "haptic/Haptic.h"
 #include "scene/Scene.h"
+#include "scene/Entity3D.h"
 #include "generate/Generate.h"
 
 #include "system/LogicTimer.h"
+#include "math/Math.h"
 #include "system/String.h"
 #include "system/Platform.h"
 #include "system/Timer.h"
 
 #include "input/Input.h"
 #include "input/Mouse.h"
+#include "input/InputRecorder.h"
 
 #include "graphics/LowLevelGraphics.h"
 #include "graphics/Renderer.h"
@@ -368,6 +372,7 @@ namespace hpl {
 		mfGameTime =0;
 
 		mbLimitFPS = true;
+		mbRenderInterpolation = false;
 
 		mpFPSCounter = hplNew( cFPSCounter,(mpSystem->GetLowLevel()) );
 		mpFrameTimer = cPlatform::CreateTimer();
@@ -438,6 +443,8 @@ namespace hpl {
 
 		auto renderer = Interface<ForgeRenderer>::Get();
 
+		cInputRecorder *pRecorder = mpInput->GetRecorder();
+
 		renderer->IncrementFrame();
 		while(!GetGameIsDone())
 		{
@@ -449,7 +456,7 @@ namespace hpl {
 			//Check if paused
 			if(GetPaused())
 			{
-				cPlatform::Sleep(10);
+				if(pRecorder->IsReplaying()==false) cPlatform::Sleep(10);
 				mpInput->Update(1.0f/100.0f);
 				bIsUpdated = true;
 
@@ -458,9 +465,11 @@ namespace hpl {
 			else
 			{
 				//////////////////////////
-				//Update logic.
-				while(mpLogicTimer->WantUpdate() && !GetGameIsDone())
+				//Update logic. When replaying input, the updates are the recorded ones.
+				while(!GetGameIsDone() && WantLogicUpdate(pRecorder))
 				{
+					pRecorder->RecordUpdate(GetStepSize());
+
 					/////////////////////////////////////////////
 					// Run Update callback in updater
 					mpUpdater->RunMessage(eUpdateableMessage_PreUpdate, GetStepSize());
@@ -496,8 +505,18 @@ namespace hpl {
 
 					//Increase game time.
 					mfGameTime += GetStepSize();
+
+					//Keep the transforms of the update to render inbetween
+					if(mbRenderInterpolation) mpScene->EndInterpolationTick();
 				}
 				mpLogicTimer->EndUpdateLoop();
+				pRecorder->RecordEndUpdateLoop();
+			}
+
+			if(pRecorder->IsReplayDone() && !GetGameIsDone())
+			{
+				Log("Input replay done after %.2f seconds of game time\n", mfGameTime);
+				Exit();
 			}
 
 			//if(GetGameIsDone()) Log("1\n");
@@ -521,6 +540,7 @@ namespace hpl {
                 renderer->SubmitFrame();
                 mpUpdater->RunMessage(eUpdateableMessage_OnPostBufferSwap);
 				renderer->IncrementFrame();
+				Interface<GraphicsAllocator>::Get()->Update(renderer->GetFrame().FrameCount());
                 STOP_TIMING(SwapBuffers)
 
 				//Log("Swap done: %d\n", cPlatform::GetApplicationTime());
@@ -530,22 +550,29 @@ namespace hpl {
 
 			////////////////////////////////////
 			// Render frame
-			if(!mbLimitFPS || bIsUpdated)
+			if(!mbLimitFPS || bIsUpdated || mbRenderInterpolation)
 			{
 				///////////////////////////////////////
            		//Get the the from the last frame.
 				UpdateFrameTimer();
+				mfFrameTime = pRecorder->UpdateFrameTime(mfFrameTime);
 
 				//On draw callback sending that to gui, etc
 				START_TIMING(OnDraw)
 				mpUpdater->RunMessage(eUpdateableMessage_OnDraw, mfFrameTime);
 				STOP_TIMING(OnDraw)
 
-				//Render this frame
+				//Render this frame, inbetween the last two updates if interpolating. A replay shows the
+				//last update as the fraction depends on the time and the frames would differ from the recording.
+				if(mbRenderInterpolation)
+					mpScene->ApplyInterpolation(pRecorder->IsReplaying() ? 1.0f : mpLogicTimer->GetInterpolationFraction());
+
 				START_TIMING(RenderAll)
 				mpScene->Render(renderer->GetFrame(), mfFrameTime, tSceneRenderFlag_All);
 				STOP_TIMING(RenderAll)
 
+				if(mbRenderInterpolation) mpScene->RestoreInterpolation();
+
 				START_TIMING(PostRender)
 				mpUpdater->RunMessage(eUpdateableMessage_OnPostRender, mfFrameTime);
 				STOP_TIMING(PostRender)
@@ -755,6 +782,33 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 
+	bool cEngine::StartInputRecording(const tWString& asFile)
+	{
+		//Save a seed so that the replay gets the same random numbers
+		int lSeed = (int)(cPlatform::GetApplicationTime() & 0x7fffffff);
+		cMath::Randomize(lSeed);
+
+		return mpInput->GetRecorder()->StartRecording(asFile, lSeed, GetUpdatesPerSec());
+	}
+
+	bool cEngine::StartInputReplay(const tWString& asFile)
+	{
+		cInputRecorder *pRecorder = mpInput->GetRecorder();
+		if(pRecorder->StartReplay(asFile)==false) return false;
+
+		cMath::Randomize(pRecorder->GetSeed());
+		SetUpdatesPerSec(pRecorder->GetUpdatesPerSec());
+
+		return true;
+	}
+
+	void cEngine::StopInputRecording()
+	{
+		mpInput->GetRecorder()->Stop();
+	}
+
+	//-----------------------------------------------------------------------
+
 	//////////////////////////////////////////////////////////////////////////
 	// PRIVATE METHOD
 	//////////////////////////////////////////////////////////////////////////
@@ -783,6 +837,30 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 
+	void cEngine::SetRenderInterpolation(bool abX)
+	{
+		if(mbRenderInterpolation == abX) return;
+
+		mbRenderInterpolation = abX;
+		iEntity3D::SetInterpolationEnabled(abX);
+	}
+
+	//-----------------------------------------------------------------------
+
+	bool cEngine::WantLogicUpdate(cInputRecorder *apRecorder)
+	{
+		if(apRecorder->IsReplayDone()) return false;
+		if(apRecorder->IsReplaying()==false) return mpLogicTimer->WantUpdate();
+
+		float fStepSize;
+		if(apRecorder->ReplayWantUpdate(&fStepSize)==false) return false;
+
+		if(cMath::Abs(fStepSize - GetStepSize()) > 0.0001f) SetUpdatesPerSec((int)(1.0f/fStepSize + 0.5f));
+		return true;
+	}
+
+	//-----------------------------------------------------------------------
+
 	void cEngine::CheckAndBroadcastFocusChange()
 	{
 		bool bHadInputFocus = mbApplicationHasInputFocus;
@@ -24,6 +24,8 @@
 #include "system/LowLevelSystem.h"
 #include "scene/Node3D.h"
 
+#include <algorithm>
+
 namespace hpl {
 
 	//////////////////////////////////////////////////////////////////////////
@@ -42,6 +44,8 @@ namespace hpl {
 		mfMaxFrameTime = 0;
 
 		mlNodeIdx = -1;
+
+		mbKeyFramesCompiled = false;
 	}
 
 	//-----------------------------------------------------------------------
@@ -68,6 +72,8 @@ namespace hpl {
 
 	cKeyFrame* cAnimationTrack::CreateKeyFrame(float afTime)
 	{
+		mbKeyFramesCompiled = false;
+
 		cKeyFrame* pFrame = hplNew( cKeyFrame,());
 		pFrame->time = afTime;
 
@@ -97,17 +103,21 @@ namespace hpl {
 
 	void cAnimationTrack::ClearKeyFrames()
 	{
+		mbKeyFramesCompiled = false;
+
 		STLDeleteAll(mvKeyFrames);
 		mvKeyFrames.clear();
 	}
 
 	//-----------------------------------------------------------------------
 
-	void cAnimationTrack::ApplyToNode(cNode3D* apNode, float afTime, float afWeight, bool bLoop)
+	void cAnimationTrack::ApplyToNode(cNode3D* apNode, float afTime, float afWeight, bool bLoop, int *apCursor)
 	{
 		if(mvKeyFrames.empty()) return;
 
-		cKeyFrame Frame = GetInterpolatedKeyFrame(afTime);
+		cQuaternion qFrameRot;
+		cVector3f vFrameTrans;
+		GetInterpolatedTransform(afTime, apCursor, qFrameRot, vFrameTrans);
 
 		//Scale
 		//Skip this for now...
@@ -116,11 +126,11 @@ namespace hpl {
 		apNode->AddScale(vScale);*/
 
 		//Rotation
-		cQuaternion qRot = cMath::QuaternionSlerp(afWeight, cQuaternion::Identity, Frame.rotation, true);
+		cQuaternion qRot = cMath::QuaternionSlerp(afWeight, cQuaternion::Identity, qFrameRot, true);
 		apNode->AddRotation(qRot);
 
 		//Translation
-		cVector3f vTrans = Frame.trans * afWeight;
+		cVector3f vTrans = vFrameTrans * afWeight;
 		apNode->AddTranslation(vTrans);
 	}
 
@@ -138,63 +148,7 @@ namespace hpl {
 			return ResultKeyFrame;
 		}
 
-		cKeyFrame *pKeyFrameA = NULL;
-		cKeyFrame *pKeyFrameB = NULL;
-
-		float fT = GetKeyFramesAtTime(afTime, &pKeyFrameA, &pKeyFrameB, bLoop);
-
-
-        if(fT == 0.0f)
-		{
-			ResultKeyFrame.rotation = pKeyFrameA->rotation;
-			ResultKeyFrame.trans = pKeyFrameA->trans;
-		}
-		else
-		{
-			//Do a linear interpolation
-			//This should include spline stuff later on.
-
-
-			cQuaternion rotA = pKeyFrameA->rotation;
-			cQuaternion rotB = pKeyFrameB->rotation;
-            /*
-            if ( rotA.v.x == -1 * rotB.v.x
-                && rotA.v.y == -1 * rotB.v.y
-                && rotA.v.z == -1 * rotB.v.z
-                && rotA.w == -1 * rotB.w )
-            {
-                ResultKeyFrame.rotation = rotB;
-            }
-            else
-            {
-                ResultKeyFrame.rotation = cMath::QuaternionSlerp(fT, rotA,
-													rotB, true);
-            }*/
-
-            rotA.Normalize();
-            rotB.Normalize();
-
-			if ( rotA.w < 0 )
-            {
-                rotA = rotA * -1.0f;
-            }
-
-            if ( rotB.w < 0 )
-            {
-                rotB = rotB * -1.0f;
-            }
-
-
-            ResultKeyFrame.rotation = cMath::QuaternionSlerp(fT, rotA,
-													rotB, true);
-
-            /*
-
-            ResultKeyFrame.rotation = cMath::QuaternionSlerp(fT, pKeyFrameA->rotation,
-													pKeyFrameB->rotation, true);
-                                                    */
-			ResultKeyFrame.trans = pKeyFrameA->trans * (1 - fT) + pKeyFrameB->trans * fT;
-		}
+		GetInterpolatedTransform(afTime, NULL, ResultKeyFrame.rotation, ResultKeyFrame.trans);
 
 		return ResultKeyFrame;
 	}
@@ -203,65 +157,19 @@ namespace hpl {
 
 	float cAnimationTrack::GetKeyFramesAtTime(float afTime, cKeyFrame** apKeyFrameA,cKeyFrame** apKeyFrameB, bool bLoop)
 	{
-		float fTotalAnimLength = mpParent->GetLength();
-
-		// Wrap time
-		//Not sure it is a good idea to clamp the length.
-		//But wrapping screws loop mode up.
-		//Wrap(..., totalLength + kEpislon), migh work though.
-		afTime = cMath::Clamp(afTime, 0, fTotalAnimLength);
+		if(mbKeyFramesCompiled==false) CompileKeyFrames();
 
-		//If longer than max time return last frame and first
-		if(afTime >= mfMaxFrameTime)
-		{
-			*apKeyFrameA = mvKeyFrames[mvKeyFrames.size()-1];
-			*apKeyFrameB = mvKeyFrames[0];
-
-			//Get T between end to start again. (the last frame doesn't mean the anim is over.
-			// In that case wrap to the first frame).
-			float fDeltaT = fTotalAnimLength - (*apKeyFrameA)->time;
-
-			//If animation time is >= max time might as well just return the last frame.
-			//Not sure if this is good for some looping anims, in that case check the code.
-			return 0.0f;//(afTime - (*apKeyFrameA)->time) / fDeltaT;
-		}
+		int lIdxA, lIdxB;
+		float fT = GetKeyFrameIndicesAtTime(afTime, lIdxA, lIdxB, NULL);
 
-		//Get the number of frames
-		const int lSize = (int)mvKeyFrames.size();
-
-		//Find the second frame.
-		int lIdxB=-1;
-		for(int i=0; i< lSize; i++)
-		{
-			if(afTime <= mvKeyFrames[i]->time)
-			{
-				lIdxB = i;
-				break;
-			}
-		}
-
-		//If first frame was found, the lowest time is not 0.
-		//If so return the first frame only.
-		if(lIdxB == 0)
-		{
-			*apKeyFrameA = mvKeyFrames[0];
-			*apKeyFrameB = mvKeyFrames[0];
-			return 0.0f;
-		}
-
-		//Get the frames
-		*apKeyFrameA = mvKeyFrames[lIdxB-1];
+		*apKeyFrameA = mvKeyFrames[lIdxA];
 		*apKeyFrameB = mvKeyFrames[lIdxB];
 
-		float fDeltaT = (*apKeyFrameB)->time - (*apKeyFrameA)->time;
-
-		return (afTime - (*apKeyFrameA)->time) / fDeltaT;
+		return fT;
 	}
 
 	//-----------------------------------------------------------------------
 
-
-
 	void cAnimationTrack::Smooth(float afAmount,float afPow,  int alSamples, bool abTranslation, bool abRotation)
 	{
 		/*/////////////////////////////////
@@ -352,5 +260,117 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 
+	void cAnimationTrack::CompileKeyFrames()
+	{
+		mbKeyFramesCompiled = true;
+
+		mvKeyTimes.resize(mvKeyFrames.size());
+		mvKeyRotations.resize(mvKeyFrames.size());
+		mvKeyTranslations.resize(mvKeyFrames.size());
+
+		for(size_t i=0; i<mvKeyFrames.size(); ++i)
+		{
+			cKeyFrame *pFrame = mvKeyFrames[i];
+
+			//Normalized and with the same sign, so interpolation does not need to do it every frame.
+			cQuaternion qRot = pFrame->rotation;
+			qRot.Normalize();
+			if(qRot.w < 0) qRot = qRot * -1.0f;
+
+			mvKeyTimes[i] = pFrame->time;
+			mvKeyRotations[i] = qRot;
+			mvKeyTranslations[i] = pFrame->trans;
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
+	float cAnimationTrack::GetKeyFrameIndicesAtTime(float afTime, int &alIdxA, int &alIdxB, int *apCursor)
+	{
+		float fTotalAnimLength = mpParent->GetLength();
+
+		// Wrap time
+		//Not sure it is a good idea to clamp the length.
+		//But wrapping screws loop mode up.
+		//Wrap(..., totalLength + kEpislon), migh work though.
+		afTime = cMath::Clamp(afTime, 0, fTotalAnimLength);
+
+		const int lSize = (int)mvKeyTimes.size();
+
+		//If longer than max time return last frame and first
+		//If animation time is >= max time might as well just return the last frame.
+		//Not sure if this is good for some looping anims, in that case check the code.
+		if(afTime >= mfMaxFrameTime)
+		{
+			alIdxA = lSize-1;
+			alIdxB = 0;
+			return 0.0f;
+		}
+
+		////////////////////////////
+		// Find the second frame, the first one with time equal or larger than afTime.
+		// Check the frame used last time and the one after first, during normal playback one of them is it.
+		int lIdxB=-1;
+		if(apCursor)
+		{
+			for(int lIdx = *apCursor; lIdx <= *apCursor+1; ++lIdx)
+			{
+				if(lIdx < 0 || lIdx >= lSize) continue;
+
+				if(afTime <= mvKeyTimes[lIdx] && (lIdx==0 || afTime > mvKeyTimes[lIdx-1]))
+				{
+					lIdxB = lIdx;
+					break;
+				}
+			}
+		}
+		if(lIdxB < 0)
+		{
+			lIdxB = (int)(std::lower_bound(mvKeyTimes.begin(), mvKeyTimes.end(), afTime) - mvKeyTimes.begin());
+			if(lIdxB >= lSize) lIdxB = lSize-1;
+		}
+		if(apCursor) *apCursor = lIdxB;
+
+		//If first frame was found, the lowest time is not 0.
+		//If so return the first frame only.
+		if(lIdxB == 0)
+		{
+			alIdxA = 0;
+			alIdxB = 0;
+			return 0.0f;
+		}
+
+		//Get the frames
+		alIdxA = lIdxB-1;
+		alIdxB = lIdxB;
+
+		float fDeltaT = mvKeyTimes[alIdxB] - mvKeyTimes[alIdxA];
+
+		return (afTime - mvKeyTimes[alIdxA]) / fDeltaT;
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cAnimationTrack::GetInterpolatedTransform(float afTime, int *apCursor, cQuaternion &aRotation, cVector3f &aTrans)
+	{
+		if(mbKeyFramesCompiled==false) CompileKeyFrames();
+
+		int lIdxA, lIdxB;
+		float fT = GetKeyFrameIndicesAtTime(afTime, lIdxA, lIdxB, apCursor);
+
+		if(fT == 0.0f)
+		{
+			aRotation = mvKeyRotations[lIdxA];
+			aTrans = mvKeyTranslations[lIdxA];
+		}
+		else
+		{
+			//Do a linear interpolation
+			//This should include spline stuff later on.
+			aRotation = cMath::QuaternionSlerp(fT, mvKeyRotations[lIdxA], mvKeyRotations[lIdxB], true);
+			aTrans = mvKeyTranslations[lIdxA] * (1 - fT) + mvKeyTranslations[lIdxB] * fT;
+		}
+	}
+
 	//-----------------------------------------------------------------------
 }
\ No newline at end of file
@@ -19,6 +19,7 @@
 
 #include "system/String.h"
 #include "system/LowLevelSystem.h"
+#include "system/JobPool.h"
 
 #include "resources/Resources.h"
 #include "resources/MaterialManager.h"
@@ -34,13 +35,60 @@
 #include "graphics/SubMesh.h"
 #include "graphics/Renderer.h"
 #include "graphics/LowLevelGraphics.h"
+#include "graphics/TriangleBVH.h"
 
 #include "scene/MeshEntity.h"
 #include "math/Math.h"
 
+#include <algorithm>
+#include <cstdint>
+
 
 namespace hpl {
 
+	//////////////////////////////////////////////////////////////////////////
+	// DEFINES
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	//Fewer triangles than this per range and handing it to the job pool costs more than it saves
+	static const int kMinClipTrianglesPerThread = 2048;
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// CLIP OUTPUT
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	void cDecalClipOutput::Clear()
+	{
+		mvPositions.clear();
+		mvNormals.clear();
+		mvPolygonSizes.clear();
+		mlTriangleCount = 0;
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cDecalClipOutput::Append(const cDecalClipOutput& aOutput, int alMaxTriangles)
+	{
+		int lVertex = 0;
+		for(size_t i=0; i<aOutput.mvPolygonSizes.size() && mlTriangleCount <= alMaxTriangles; ++i)
+		{
+			int lCount = aOutput.mvPolygonSizes[i];
+			mvPositions.insert(mvPositions.end(), aOutput.mvPositions.begin()+lVertex, aOutput.mvPositions.begin()+lVertex+lCount);
+			mvNormals.insert(mvNormals.end(), aOutput.mvNormals.begin()+lVertex, aOutput.mvNormals.begin()+lVertex+lCount);
+			mvPolygonSizes.push_back(lCount);
+			mlTriangleCount += lCount-2;
+			lVertex += lCount;
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
 	//////////////////////////////////////////////////////////////////////////
 	// CONSTRUCTORS
 	//////////////////////////////////////////////////////////////////////////
@@ -71,6 +119,7 @@ namespace hpl {
 		mpDecalVB = NULL;
 
 		mlMaxDecalTriangleCount = 250;
+		mlMaxClipThreads = cJobPool::GetDefault()->GetWorkerNum() + 1;
 
 		mbCompiled = false;
 	}
@@ -552,10 +601,6 @@ namespace hpl {
 	{
 		//Log("Clipping mesh %s\n", apSubMesh->GetName().c_str());
 
-		cVector3f vNewVertices[9];
-		cVector3f vNewNormals[9];
-		float fInvThree = 1.0f/3.0f;
-
 		cMatrixf mtxSubMeshWorldMatrix = apSubMesh->GetWorldMatrix();
 		cMatrixf mtxInvSubMeshWorldMatrix = cMath::MatrixInverse(mtxSubMeshWorldMatrix);
 		cMatrixf mtxSubMeshWorldNormalRot = mtxInvSubMeshWorldMatrix.GetRotation().GetTranspose();
@@ -569,34 +614,98 @@ namespace hpl {
 			vTransformedPlanes.push_back(cMath::TransformPlane(mtxInvSubMeshWorldMatrix, mvClipPlanes[i]));
 			//Log("Plane %d transformed normal:(%s) d:%f\n", i, vTransformedPlanes.back().GetNormal().ToFileString().c_str(), vTransformedPlanes.back().d);
 		}
-		cVector3f vTransformedUp = vTransformedPlanes[2].GetNormal();
 
 		iVertexBuffer* pSubMeshVB = apSubMesh->GetVertexBuffer();
+		cTriangleBVH* pBVH = apSubMesh->GetSubMesh()->GetTriangleBVH();
 
-		float* pVertices = pSubMeshVB->GetFloatArray(eVertexBufferElement_Position);
-		float* pNormals = pSubMeshVB->GetFloatArray(eVertexBufferElement_Normal);
-		unsigned int* pIndices = pSubMeshVB->GetIndices();
-		int lPosStride = pSubMeshVB->GetElementNum(eVertexBufferElement_Position);
-		int lNrmStride = pSubMeshVB->GetElementNum(eVertexBufferElement_Normal);
+		//////////////////////////////////////////////////
+		// Clip the triangles near the decal
+		ClipTriangles(	pSubMeshVB->GetFloatArray(eVertexBufferElement_Position), pSubMeshVB->GetElementNum(eVertexBufferElement_Position),
+						pSubMeshVB->GetFloatArray(eVertexBufferElement_Normal), pSubMeshVB->GetElementNum(eVertexBufferElement_Normal),
+						pSubMeshVB->GetIndices(), pSubMeshVB->GetIndexNum(), &vTransformedPlanes[0],
+						pBVH, mlMaxDecalTriangleCount - mlDecalTriangleCount, mlMaxClipThreads, mClipOutput);
+
+		int lVertex = 0;
+		for(size_t i=0; i<mClipOutput.mvPolygonSizes.size(); ++i)
+		{
+			int lCount = mClipOutput.mvPolygonSizes[i];
+			if(AddPolygon(lCount, &mClipOutput.mvPositions[lVertex], &mClipOutput.mvNormals[lVertex], apDecalVB, mtxSubMeshWorldMatrix,mtxSubMeshWorldNormalRot)==false) break;
+			lVertex += lCount;
+		}
+	}
 
-		// Clip every triangle in submesh
-		for(int j=0;j<pSubMeshVB->GetIndexNum();j+=3)
+	//-----------------------------------------------------------------------
+
+	void cDecalCreator::ClipTriangles(	const float* apPositions, int alPosStride, const float* apNormals, int alNrmStride,
+										const unsigned int* apIndices, int alIndexNum, const cPlanef* apPlanes,
+										const cTriangleBVH* apBVH, int alMaxTriangles, int alMaxThreads, cDecalClipOutput& aOutput)
+	{
+		aOutput.Clear();
+		if(apPositions==NULL || apNormals==NULL || apIndices==NULL) return;
+
+		//////////////////////////////////////////////////
+		// Get the triangles to test, all of them without a tree
+		tIntVec vTriangles;
+		const int* pTriangles = NULL;
+		int lTriangleNum = alIndexNum/3;
+		if(apBVH)
 		{
-			cVector3f vTriangle[3];
-			cVector3f vNormal[3];
+			apBVH->FindTriangles(apPlanes, 6, vTriangles);
+			if(vTriangles.empty()) return;
 
-			for(int k=0;k<3;++k)
-			{
-				int lPosBaseIdx = pIndices[j+k]*lPosStride;
-				int lNrmBaseIdx = pIndices[j+k]*lNrmStride;
+			pTriangles = &vTriangles[0];
+			lTriangleNum = (int)vTriangles.size();
+		}
 
-				vTriangle[k] = cVector3f(pVertices[lPosBaseIdx],
-										pVertices[lPosBaseIdx+1],
-										pVertices[lPosBaseIdx+2]);
-				vNormal[k] = cVector3f(pNormals[lNrmBaseIdx],
-										pNormals[lNrmBaseIdx+1],
-										pNormals[lNrmBaseIdx+2]);
+		//////////////////////////////////////////////////
+		// Few triangles, clip on this thread
+		int lThreadNum = std::min(alMaxThreads, lTriangleNum / kMinClipTrianglesPerThread);
+		if(lThreadNum <= 1)
+		{
+			ClipTriangleRange(	apPositions, alPosStride, apNormals, alNrmStride, apIndices, apPlanes, pTriangles,
+								0, lTriangleNum, alMaxTriangles, aOutput);
+			return;
+		}
 
+		//////////////////////////////////////////////////
+		// Split into even ranges on the job pool.
+		// Appended in order so the result is the same as clipping on one thread.
+		std::vector<cDecalClipOutput> vOutputs(lThreadNum);
+		cJobPool::GetDefault()->ParallelFor(lThreadNum, [&](size_t alRange)
+		{
+			int lStart = (int)((int64_t)lTriangleNum * alRange / lThreadNum);
+			int lEnd = (int)((int64_t)lTriangleNum * (alRange+1) / lThreadNum);
+			ClipTriangleRange(	apPositions, alPosStride, apNormals, alNrmStride, apIndices, apPlanes, pTriangles,
+								lStart, lEnd, alMaxTriangles, vOutputs[alRange]);
+		}, lThreadNum);
+
+		for(int i=0; i<lThreadNum; ++i)
+		{
+			aOutput.Append(vOutputs[i], alMaxTriangles);
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cDecalCreator::ClipTriangleRange(	const float* apPositions, int alPosStride, const float* apNormals, int alNrmStride,
+											const unsigned int* apIndices, const cPlanef* apPlanes, const int* apTriangles,
+											int alStart, int alEnd, int alMaxTriangles, cDecalClipOutput& aOutput)
+	{
+		cVector3f vNewVertices[9];
+		cVector3f vNewNormals[9];
+
+		cVector3f vTransformedUp = apPlanes[2].GetNormal();
+
+		// Clip every triangle in range
+		for(int lTri=alStart; lTri<alEnd && aOutput.mlTriangleCount <= alMaxTriangles; ++lTri)
+		{
+			int j = (apTriangles ? apTriangles[lTri] : lTri) * 3;
+
+			cVector3f vTriangle[3];
+			for(int k=0;k<3;++k)
+			{
+				const float *pPos = &apPositions[apIndices[j+k]*alPosStride];
+				vTriangle[k] = cVector3f(pPos[0], pPos[1], pPos[2]);
 			}
 
 			// Skip if backfacing
@@ -606,24 +715,49 @@ namespace hpl {
 			if(cMath::Vector3Dot(vTransformedUp, vTriNormal)<=kEpsilonf)
 				continue;
 
-			vNewVertices[0] = vTriangle[0];
-			vNewVertices[1] = vTriangle[1];
-			vNewVertices[2] = vTriangle[2];
+			//////////////////////////////////////////////////
+			// Classify against all planes at once, most triangles are either completely
+			// outside one plane or inside all of them and need no clipping.
+			bool bOutside = false;
+			bool bInside = true;
+			for(int p=0; p<6 && bOutside==false; ++p)
+			{
+				int lNegativeCount = 0;
+				for(int k=0;k<3;++k)
+				{
+					lNegativeCount += (cMath::PlaneToPointDist(apPlanes[p], vTriangle[k]) < kEpsilonf) ? 1 : 0;
+				}
+				bOutside = lNegativeCount==3;
+				bInside = bInside && lNegativeCount==0;
+			}
+			if(bOutside) continue;
 
-			vNewNormals[0] = vNormal[0];
-			vNewNormals[1] = vNormal[1];
-			vNewNormals[2] = vNormal[2];
+			for(int k=0;k<3;++k)
+			{
+				const float *pNrm = &apNormals[apIndices[j+k]*alNrmStride];
+				vNewVertices[k] = vTriangle[k];
+				vNewNormals[k] = cVector3f(pNrm[0], pNrm[1], pNrm[2]);
+			}
 
 			// Clip triangle against planes
-			int lCount = ClipPolygon(3, vNewVertices, vNewNormals, vNewVertices, vNewNormals, vTransformedPlanes);
-			if((lCount!=0) && (AddPolygon(lCount, vNewVertices, vNewNormals, apDecalVB, mtxSubMeshWorldMatrix,mtxSubMeshWorldNormalRot)==false)) break;
+			int lCount = 3;
+			if(bInside==false)
+			{
+				lCount = ClipPolygon(3, vNewVertices, vNewNormals, vNewVertices, vNewNormals, apPlanes);
+				if(lCount==0) continue;
+			}
+
+			aOutput.mvPositions.insert(aOutput.mvPositions.end(), vNewVertices, vNewVertices+lCount);
+			aOutput.mvNormals.insert(aOutput.mvNormals.end(), vNewNormals, vNewNormals+lCount);
+			aOutput.mvPolygonSizes.push_back(lCount);
+			aOutput.mlTriangleCount += lCount-2;
 		}
 	}
 
 	//-----------------------------------------------------------------------
 
 	int cDecalCreator::ClipPolygon(int alVertexCount, const cVector3f* apVertices, const cVector3f* apNormals,
-									cVector3f* apNewVertices, cVector3f* apNewNormals, const std::vector<cPlanef>& avPlanes)
+									cVector3f* apNewVertices, cVector3f* apNewNormals, const cPlanef* apPlanes)
 	{
 		/*Log("Clipping triangle with vertices (%s) (%s) (%s)\n", apVertices[0].ToString().c_str(),
 														  apVertices[1].ToString().c_str(),
@@ -631,22 +765,22 @@ namespace hpl {
 		cVector3f vTempVertices[9];
 		cVector3f vTempNormals[9];
 
-		int lCount = ClipPolygonAgainstPlane(avPlanes[0], alVertexCount, apVertices, apNormals, vTempVertices, vTempNormals);
+		int lCount = ClipPolygonAgainstPlane(apPlanes[0], alVertexCount, apVertices, apNormals, vTempVertices, vTempNormals);
 		if(lCount!=0)
 		{
-			lCount = ClipPolygonAgainstPlane(avPlanes[1], lCount, vTempVertices, vTempNormals, apNewVertices, apNewNormals);
+			lCount = ClipPolygonAgainstPlane(apPlanes[1], lCount, vTempVertices, vTempNormals, apNewVertices, apNewNormals);
 			if(lCount!=0)
 			{
-				lCount = ClipPolygonAgainstPlane(avPlanes[2], lCount, apNewVertices, apNewNormals, vTempVertices, vTempNormals);
+				lCount = ClipPolygonAgainstPlane(apPlanes[2], lCount, apNewVertices, apNewNormals, vTempVertices, vTempNormals);
 				if(lCount!=0)
 				{
-					lCount = ClipPolygonAgainstPlane(avPlanes[3], lCount, vTempVertices, vTempNormals, apNewVertices, apNewNormals);
+					lCount = ClipPolygonAgainstPlane(apPlanes[3], lCount, vTempVertices, vTempNormals, apNewVertices, apNewNormals);
 					if(lCount!=0)
 					{
-						lCount = ClipPolygonAgainstPlane(avPlanes[4], lCount, apNewVertices, apNewNormals, vTempVertices, vTempNormals);
+						lCount = ClipPolygonAgainstPlane(apPlanes[4], lCount, apNewVertices, apNewNormals, vTempVertices, vTempNormals);
 						if(lCount!=0)
 						{
-							lCount = ClipPolygonAgainstPlane(avPlanes[5], lCount, vTempVertices, vTempNormals, apNewVertices, apNewNormals);
+							lCount = ClipPolygonAgainstPlane(apPlanes[5], lCount, vTempVertices, vTempNormals, apNewVertices, apNewNormals);
 						}
 					}
 				}
@@ -32,10 +32,13 @@ namespace hpl {
             for(size_t i = 0; i < elements.size(); i++) {
                 ShaderSemantic semantic = hplToForgeShaderSemantic(elements[i]);
                 auto stream = packet->m_unified.m_subAllocation->getStreamBySemantic(semantic);
+                // the chunk can be released by the geometry set before this frame is done
+                resourcePool->Push(stream->buffer());
                 vbBuffer.push_back(stream->buffer().m_handle);
                 vbOffsets.push_back((packet->m_unified.m_vertexOffset + packet->m_unified.m_subAllocation->vertexOffset()) * stream->stride());
                 vbStride.push_back(stream->stride());
             }
+            resourcePool->Push(packet->m_unified.m_subAllocation->indexBuffer());
             cmdBindVertexBuffer(cmd, elements.size(), vbBuffer.data(), vbStride.data(), vbOffsets.data());
             cmdBindIndexBuffer(cmd, packet->m_unified.m_subAllocation->indexBuffer().m_handle, INDEX_TYPE_UINT32,
                                (packet->m_unified.m_subAllocation->indexOffset() + packet->m_unified.m_indexOffset) * GeometrySet::IndexBufferStride );
@@ -20,6 +20,9 @@
 #include "graphics/FontData.h"
 #include <stdarg.h>
 #include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <functional>
 
 #include "system/LowLevelSystem.h"
 
@@ -62,6 +65,11 @@ namespace hpl {
 	{
 		mpLowLevelGraphics = apLowLevelGraphics;
 		mpResources = NULL;
+
+		mlLayoutCacheSize = 256;
+		mlLayoutCacheHits = 0;
+		mlLayoutCacheMisses = 0;
+		m_mapLayouts.reserve(mlLayoutCacheSize);
 	}
 
 	//-----------------------------------------------------------------------
@@ -225,16 +233,170 @@ namespace hpl {
 	}
 
 
+	void iFontData::GetWordWrapRows(float afLength,float afFontHeight,cVector2f avSize,
+							const tWString& asString,tWStringVec *apRowVec)
+	{
+		const cTextLayout *pLayout = GetWordWrapLayout(afLength, avSize, asString);
+
+		for(size_t i=0; i<pLayout->GetRowNum(); ++i)
+		{
+			apRowVec->push_back(pLayout->GetRowText(i));
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
+	static inline size_t HashCombine(size_t alSeed, float afValue)
+	{
+		unsigned int lBits;
+		memcpy(&lBits, &afValue, sizeof(lBits));
+		return alSeed ^ ((size_t)lBits + 0x9e3779b9 + (alSeed << 6) + (alSeed >> 2));
+	}
+
+	const cTextLayout* iFontData::GetWordWrapLayout(float afLength,const cVector2f& avSize,const tWString& asString)
+	{
+		size_t lHash = std::hash<tWString>()(asString);
+		lHash = HashCombine(lHash, afLength);
+		lHash = HashCombine(lHash, avSize.x);
+		lHash = HashCombine(lHash, avSize.y);
+
+		////////////////////////////
+		// Look for a cached layout, on a hash collision the entry is rebuilt in place
+		tTextLayoutListIt layoutIt;
+		tTextLayoutMapIt mapIt = m_mapLayouts.find(lHash);
+		if(mapIt != m_mapLayouts.end())
+		{
+			layoutIt = mapIt->second;
+			mlstLayouts.splice(mlstLayouts.begin(), mlstLayouts, layoutIt);
+
+			if(	layoutIt->mfMaxLength == afLength && layoutIt->mvFontSize.x == avSize.x &&
+				layoutIt->mvFontSize.y == avSize.y && layoutIt->msText == asString)
+			{
+				++mlLayoutCacheHits;
+				return &(*layoutIt);
+			}
+		}
+		////////////////////////////
+		// Not found, reuse the least recently used layout if the cache is full
+		else
+		{
+			if(mlstLayouts.size() >= mlLayoutCacheSize)
+			{
+				layoutIt = --mlstLayouts.end();
+				m_mapLayouts.erase(layoutIt->mlHash);
+				mlstLayouts.splice(mlstLayouts.begin(), mlstLayouts, layoutIt);
+			}
+			else
+			{
+				mlstLayouts.push_front(cTextLayout());
+				layoutIt = mlstLayouts.begin();
+			}
+			m_mapLayouts[lHash] = layoutIt;
+		}
+		++mlLayoutCacheMisses;
+
+		cTextLayout *pLayout = &(*layoutIt);
+		pLayout->mpFont = this;
+		pLayout->mlHash = lHash;
+		pLayout->msText = asString;
+		pLayout->mvFontSize = avSize;
+		pLayout->mfMaxLength = afLength;
+		BuildWordWrapLayout(pLayout);
+
+		return pLayout;
+	}
+
+	//-----------------------------------------------------------------------
+
+	void iFontData::SetLayoutCacheSize(size_t alSize)
+	{
+		mlLayoutCacheSize = alSize > 0 ? alSize : 1;
+
+		while(mlstLayouts.size() > mlLayoutCacheSize)
+		{
+			m_mapLayouts.erase(mlstLayouts.back().mlHash);
+			mlstLayouts.pop_back();
+		}
+		m_mapLayouts.reserve(mlLayoutCacheSize);
+	}
+
+	void iFontData::ClearLayoutCache()
+	{
+		mlstLayouts.clear();
+		m_mapLayouts.clear();
+		mlLayoutCacheHits = 0;
+		mlLayoutCacheMisses = 0;
+	}
+
+	//-----------------------------------------------------------------------
+
+	float iFontData::GetLength(const cVector2f& avSize,const wchar_t* sText)
+	{
+		int lCount=0;
+		float lXAdd =0;
+		float fLength =0;
+		while(sText[lCount] != 0)
+		{
+			unsigned short lGlyphNum = ((wchar_t)sText[lCount]);
+			if(lGlyphNum<mlFirstChar || lGlyphNum>mlLastChar){
+				lCount++;
+				continue;
+			}
+			lGlyphNum -= mlFirstChar;
+
+			cGlyph *pGlyph = GetGlyph(lGlyphNum);
+			if(pGlyph)
+			{
+				cVector2f vOffset(pGlyph->mvOffset * avSize);
+				cVector2f vSize(pGlyph->mvSize * avSize);
+
+				fLength += pGlyph->mfAdvance*avSize.x;
+			}
+			lCount++;
+		}
+
+		return fLength;
+	}
+
+	//-----------------------------------------------------------------------
+
+
+	float iFontData::GetLengthFmt(const cVector2f& avSize,const wchar_t* fmt,...)
+	{
+		wchar_t sText[256];
+		va_list ap;
+		if (fmt == NULL) return 0;
+		va_start(ap, fmt);
+		vswprintf(sText, 255, fmt, ap);
+		va_end(ap);
+
+		return GetLength(avSize, sText);
+	}
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// PRIVATE METHODS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
 	struct cRowLength
 	{
 		unsigned int mlPos;
 		bool mbIncr;
 	};
 
-
-	void iFontData::GetWordWrapRows(float afLength,float afFontHeight,cVector2f avSize,
-							const tWString& asString,tWStringVec *apRowVec)
+	void iFontData::BuildWordWrapLayout(cTextLayout *apLayout)
 	{
+		const tWString& sString = apLayout->msText;
+		const cVector2f& vSize = apLayout->mvFontSize;
+		float fMaxLength = apLayout->mfMaxLength;
+
+		apLayout->mvRows.clear();
+		apLayout->mvGlyphs.clear();
+
+		////////////////////////////
+		// Find where the rows break, measuring the characters in place instead of creating substrings.
 		int rows = 0;
 
 		unsigned int pos;
@@ -245,17 +407,14 @@ namespace hpl {
 		cRowLength row;
 		float fTextLength;
 
-		for(pos = 0; pos < asString.size();pos++)
+		for(pos = 0; pos < sString.size();pos++)
 		{
-			//Log("char: %d\n",(char)asString[pos]);
-			if(asString[pos] == _W(' ') || asString[pos] == _W('\n') || IsChineseFullwidthChar(asString[pos]))
+			if(sString[pos] == _W(' ') || sString[pos] == _W('\n') || IsChineseFullwidthChar(sString[pos]))
 			{
-				tWString temp = asString.substr(first_letter, pos-first_letter);
-				fTextLength =  GetLength(avSize,temp.c_str());
+				fTextLength = GetRangeLength(vSize, sString, first_letter, pos);
 
-				//Log("r:%d p:%d f:%d l:%d Temp:'%s'\n",rows,pos,first_letter,last_space, temp.c_str());
 				bool nothing = true;
-				if(fTextLength > afLength && IsChineseFullwidthChar(asString[pos]) == false)
+				if(fTextLength > fMaxLength && IsChineseFullwidthChar(sString[pos]) == false)
 				{
 					rows++;
 
@@ -267,7 +426,7 @@ namespace hpl {
 					last_space = pos;
 					nothing = false;
 				}
-				else if (fTextLength > afLength && IsChineseFullwidthChar(asString[pos]) == true)
+				else if (fTextLength > fMaxLength && IsChineseFullwidthChar(sString[pos]) == true)
 				{
 					row.mbIncr = false;
 					row.mlPos = last_space + 1;
@@ -279,7 +438,7 @@ namespace hpl {
 					nothing = false;
 				}
 
-				if(asString[pos] == _W('\n'))
+				if(sString[pos] == _W('\n'))
 				{
 					last_space = pos;
 					first_letter=last_space+1;
@@ -288,7 +447,6 @@ namespace hpl {
 					row.mlPos = last_space;
 					rowLengthList.push_back(row);
 
-
 					rows++;
 					nothing = false;
 				}
@@ -298,9 +456,8 @@ namespace hpl {
 				}
 			}
 		}
-		tWString temp =  asString.substr(first_letter, pos-first_letter);
-		fTextLength = GetLength(avSize,temp.c_str());
-		if(fTextLength > afLength)
+		fTextLength = GetRangeLength(vSize, sString, first_letter, pos);
+		if(fTextLength > fMaxLength)
 		{
 			rows++;
 			row.mlPos = last_space;
@@ -308,77 +465,80 @@ namespace hpl {
 			rowLengthList.push_back(row);
 		}
 
+		////////////////////////////
+		// Create the rows, with the same start and length as a substr would give
+		cTextLayoutRow layoutRow;
 		if(rows==0)
 		{
-			apRowVec->push_back(asString.c_str());
+			layoutRow.mlStart = 0;
+			layoutRow.mlLength = sString.size();
+			apLayout->mvRows.push_back(layoutRow);
 		}
 		else
 		{
-			first_letter=0;
-			unsigned int i=0;
-
+			size_t lFirst=0;
 			for(std::list<cRowLength>::iterator it = rowLengthList.begin();it != rowLengthList.end();++it)
 			{
-				apRowVec->push_back(asString.substr(first_letter, it->mlPos -first_letter).c_str());
-				i++;
-				first_letter = it->mlPos;
-				if (it->mbIncr)
-					first_letter++;
-			}
-			apRowVec->push_back(asString.substr(first_letter).c_str());
+				layoutRow.mlStart = lFirst;
+				layoutRow.mlLength = std::min((size_t)(unsigned int)(it->mlPos - lFirst), sString.size() - lFirst);
+				apLayout->mvRows.push_back(layoutRow);
 
+				lFirst = std::min((size_t)it->mlPos, sString.size());
+				if (it->mbIncr && lFirst < sString.size())
+					lFirst++;
+			}
+			layoutRow.mlStart = lFirst;
+			layoutRow.mlLength = sString.size() - lFirst;
+			apLayout->mvRows.push_back(layoutRow);
 		}
-	}
 
-	//-----------------------------------------------------------------------
-
-	float iFontData::GetLength(const cVector2f& avSize,const wchar_t* sText)
-	{
-		int lCount=0;
-		float lXAdd =0;
-		float fLength =0;
-		while(sText[lCount] != 0)
+		////////////////////////////
+		// Place the glyphs of each row
+		for(size_t i=0; i<apLayout->mvRows.size(); ++i)
 		{
-			unsigned short lGlyphNum = ((wchar_t)sText[lCount]);
-			if(lGlyphNum<mlFirstChar || lGlyphNum>mlLastChar){
-				lCount++;
-				continue;
-			}
-			lGlyphNum -= mlFirstChar;
+			cTextLayoutRow& rowData = apLayout->mvRows[i];
+			rowData.mlFirstGlyph = apLayout->mvGlyphs.size();
 
-			cGlyph *pGlyph = GetGlyph(lGlyphNum);
-			if(pGlyph)
+			float fX = 0;
+			for(size_t lChar = rowData.mlStart; lChar < rowData.mlStart + rowData.mlLength; ++lChar)
 			{
-				cVector2f vOffset(pGlyph->mvOffset * avSize);
-				cVector2f vSize(pGlyph->mvSize * avSize);
+				unsigned short lGlyphNum = ((wchar_t)sString[lChar]);
+				if(lGlyphNum<mlFirstChar || lGlyphNum>mlLastChar) continue;
+				lGlyphNum -= mlFirstChar;
 
-				fLength += pGlyph->mfAdvance*avSize.x;
+				cGlyph *pGlyph = GetGlyph(lGlyphNum);
+				if(pGlyph==NULL) continue;
+
+				cTextLayoutGlyph glyph;
+				glyph.mlGlyph = lGlyphNum;
+				glyph.mlChar = lChar;
+				glyph.mfX = fX;
+				apLayout->mvGlyphs.push_back(glyph);
+
+				fX += pGlyph->mfAdvance*vSize.x;
 			}
-			lCount++;
-		}
 
-		return fLength;
+			rowData.mlGlyphNum = apLayout->mvGlyphs.size() - rowData.mlFirstGlyph;
+			rowData.mfLength = fX;
+		}
 	}
 
 	//-----------------------------------------------------------------------
 
-
-	float iFontData::GetLengthFmt(const cVector2f& avSize,const wchar_t* fmt,...)
+	float iFontData::GetRangeLength(const cVector2f& avSize,const tWString& asString, size_t alStart, size_t alEnd)
 	{
-		wchar_t sText[256];
-		va_list ap;
-		if (fmt == NULL) return 0;
-		va_start(ap, fmt);
-		vswprintf(sText, 255, fmt, ap);
-		va_end(ap);
+		float fLength =0;
+		for(size_t i=alStart; i<alEnd; ++i)
+		{
+			unsigned short lGlyphNum = ((wchar_t)asString[i]);
+			if(lGlyphNum<mlFirstChar || lGlyphNum>mlLastChar) continue;
 
-		return GetLength(avSize, sText);
-	}
-	//-----------------------------------------------------------------------
+			cGlyph *pGlyph = GetGlyph(lGlyphNum - mlFirstChar);
+			if(pGlyph) fLength += pGlyph->mfAdvance*avSize.x;
+		}
 
-	//////////////////////////////////////////////////////////////////////////
-	// PRIVATE METHODS
-	//////////////////////////////////////////////////////////////////////////
+		return fLength;
+	}
 
 	//-----------------------------------------------------------------------
 
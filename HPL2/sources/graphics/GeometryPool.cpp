@@ -0,0 +1,331 @@
+#include "graphics/GeometryPool.h"
+
+#include "Common_3/Utilities/Interfaces/ILog.h"
+
+#include <algorithm>
+
+namespace hpl {
+
+    GeometryPool::GeometryPool() {
+    }
+
+    GeometryPool::GeometryPool(const Config& config, BackingStore* store)
+        : m_config(config)
+        , m_store(store) {
+        ASSERT(m_store);
+        ASSERT(m_config.m_chunkSize > 0 && m_config.m_maxChunks > 0);
+        addChunk(m_config.m_chunkSize);
+        m_numGrows = 0;
+    }
+
+    GeometryPool::~GeometryPool() {
+    }
+
+    GeometryPool::Handle GeometryPool::allocate(uint32_t numElements) {
+        uint32_t chunkIndex = 0;
+        OffsetAllocator::Allocation allocation;
+        if (!allocateInChunks(numElements, UINT32_MAX, true, chunkIndex, allocation)) {
+            m_numFailed++;
+            return InvalidHandle;
+        }
+
+        Handle handle;
+        if (!m_freeSlots.empty()) {
+            handle = m_freeSlots.back();
+            m_freeSlots.pop_back();
+        } else {
+            handle = static_cast<Handle>(m_slots.size());
+            m_slots.emplace_back();
+        }
+        auto& slot = m_slots[handle];
+        slot.m_allocation = allocation;
+        slot.m_chunk = chunkIndex;
+        slot.m_size = numElements;
+        slot.m_isAlive = true;
+
+        auto& chunk = m_chunks[chunkIndex];
+        chunk.m_used += numElements;
+        chunk.m_numAllocations++;
+        return handle;
+    }
+
+    void GeometryPool::free(Handle handle) {
+        if (handle == InvalidHandle) {
+            return;
+        }
+        auto& slot = m_slots[handle];
+        ASSERT(slot.m_isAlive);
+        auto& chunk = m_chunks[slot.m_chunk];
+        chunk.m_used -= slot.m_size;
+        chunk.m_numAllocations--;
+        retire(slot.m_chunk, slot.m_allocation, slot.m_size);
+
+        slot.m_isAlive = false;
+        slot.m_allocation = OffsetAllocator::Allocation();
+        m_freeSlots.push_back(handle);
+    }
+
+    void GeometryPool::update(uint64_t frame) {
+        m_frame = frame;
+        releaseRetired(false);
+        if (m_config.m_moveBudget > 0) {
+            evacuate(m_config.m_moveBudget);
+        }
+        releaseEmptyChunks();
+    }
+
+    void GeometryPool::compactAll() {
+        for (uint32_t i = 0; i < m_config.m_maxChunks; i++) {
+            if (evacuate(UINT32_MAX) == 0) {
+                break;
+            }
+        }
+        releaseEmptyChunks();
+    }
+
+    GeometryPool::Stats GeometryPool::stats() const {
+        Stats stats;
+        for (auto& chunk : m_chunks) {
+            if (!chunk.m_allocator) {
+                continue;
+            }
+            auto report = chunk.m_allocator->storageReport();
+            stats.m_numChunks++;
+            stats.m_numAllocations += chunk.m_numAllocations;
+            stats.m_capacity += chunk.m_capacity;
+            stats.m_used += chunk.m_used;
+            stats.m_retired += chunk.m_retired;
+            stats.m_free += report.totalFreeSpace;
+            stats.m_largestFreeRegion = std::max(stats.m_largestFreeRegion, report.largestFreeRegion);
+        }
+        stats.m_occupancy = stats.m_capacity > 0 ? static_cast<float>(stats.m_used) / static_cast<float>(stats.m_capacity) : 0.0f;
+        stats.m_fragmentation =
+            stats.m_free > 0 ? 1.0f - static_cast<float>(stats.m_largestFreeRegion) / static_cast<float>(stats.m_free) : 0.0f;
+        stats.m_numGrows = m_numGrows;
+        stats.m_numReleases = m_numReleases;
+        stats.m_numFailed = m_numFailed;
+        stats.m_movedElements = m_movedElements;
+        return stats;
+    }
+
+    bool GeometryPool::allocateInChunks(
+        uint32_t numElements, uint32_t skipChunk, bool mayGrow, uint32_t& chunkIndex, OffsetAllocator::Allocation& allocation) {
+        // chunks in order, so the data collects in the first ones and the later ones can empty out
+        auto tryChunks = [&](bool draining) {
+            for (uint32_t i = 0; i < m_chunks.size(); i++) {
+                auto& chunk = m_chunks[i];
+                if (!chunk.m_allocator || i == skipChunk || chunk.m_isDraining != draining ||
+                    (chunk.m_capacity - chunk.m_used - chunk.m_retired) < numElements) {
+                    continue;
+                }
+                allocation = chunk.m_allocator->allocate(numElements);
+                if (allocation.offset != OffsetAllocator::Allocation::NO_SPACE) {
+                    chunkIndex = i;
+                    return true;
+                }
+            }
+            return false;
+        };
+        if (tryChunks(false)) {
+            return true;
+        }
+
+        uint32_t numActive = 0;
+        uint64_t totalFree = 0;
+        for (auto& chunk : m_chunks) {
+            if (chunk.m_allocator) {
+                numActive++;
+                totalFree += chunk.m_capacity - chunk.m_used - chunk.m_retired;
+            }
+        }
+        if (mayGrow && numActive < m_config.m_maxChunks) {
+            // there was room in total, just not in one piece
+            m_isFragmented |= totalFree >= numElements;
+            chunkIndex = addChunk(std::max(m_config.m_chunkSize, numElements));
+            allocation = m_chunks[chunkIndex].m_allocator->allocate(numElements);
+            return allocation.offset != OffsetAllocator::Allocation::NO_SPACE;
+        }
+
+        // rather use a chunk that is being emptied than fail
+        return tryChunks(true);
+    }
+
+    uint32_t GeometryPool::addChunk(uint32_t numElements) {
+        uint32_t index = 0;
+        while (index < m_chunks.size() && m_chunks[index].m_allocator) {
+            index++;
+        }
+        if (index == m_chunks.size()) {
+            m_chunks.emplace_back();
+        }
+        auto& chunk = m_chunks[index];
+        chunk.m_allocator = std::make_unique<OffsetAllocator::Allocator>(numElements);
+        chunk.m_capacity = numElements;
+        chunk.m_used = 0;
+        chunk.m_retired = 0;
+        chunk.m_numAllocations = 0;
+        chunk.m_isDraining = false;
+        m_store->addChunk(index, numElements);
+        m_numGrows++;
+        return index;
+    }
+
+    void GeometryPool::retire(uint32_t chunkIndex, const OffsetAllocator::Allocation& allocation, uint32_t size) {
+        auto& chunk = m_chunks[chunkIndex];
+        if (m_config.m_retireFrames == 0) {
+            chunk.m_allocator->free(allocation);
+            return;
+        }
+        chunk.m_retired += size;
+        m_retired.push_back(RetiredRange{ allocation, chunkIndex, size, m_frame });
+    }
+
+    void GeometryPool::releaseRetired(bool all) {
+        auto it = std::remove_if(m_retired.begin(), m_retired.end(), [&](const RetiredRange& range) {
+            if (!all && range.m_frame + m_config.m_retireFrames > m_frame) {
+                return false;
+            }
+            auto& chunk = m_chunks[range.m_chunk];
+            chunk.m_allocator->free(range.m_allocation);
+            chunk.m_retired -= range.m_size;
+            return true;
+        });
+        m_retired.erase(it, m_retired.end());
+    }
+
+    void GeometryPool::releaseEmptyChunks() {
+        uint32_t numActive = 0;
+        uint64_t totalFree = 0;
+        for (auto& chunk : m_chunks) {
+            if (chunk.m_allocator) {
+                numActive++;
+                totalFree += chunk.m_capacity - chunk.m_used - chunk.m_retired;
+            }
+        }
+        for (uint32_t i = 0; i < m_chunks.size() && numActive > 1; i++) {
+            auto& chunk = m_chunks[i];
+            if (!chunk.m_allocator || chunk.m_numAllocations > 0 || chunk.m_retired > 0) {
+                continue;
+            }
+            // keep some room around so the next few allocations don't grow the pool right back
+            if (totalFree - chunk.m_capacity < m_config.m_chunkSize / 2) {
+                continue;
+            }
+            totalFree -= chunk.m_capacity;
+            if (i == m_evacuateChunk) {
+                m_evacuateChunk = UINT32_MAX;
+                m_evacuateHandles.clear();
+            }
+            m_store->removeChunk(i);
+            chunk.m_allocator.reset();
+            chunk.m_capacity = 0;
+            chunk.m_isDraining = false;
+            m_numReleases++;
+            numActive--;
+        }
+    }
+
+    uint32_t GeometryPool::findEvacuateChunk() const {
+        uint32_t numActive = 0;
+        uint64_t capacity = 0;
+        uint64_t used = 0;
+        uint64_t totalFree = 0;
+        for (auto& chunk : m_chunks) {
+            if (chunk.m_allocator) {
+                numActive++;
+                capacity += chunk.m_capacity;
+                used += chunk.m_used;
+                totalFree += chunk.m_capacity - chunk.m_used - chunk.m_retired;
+            }
+        }
+        // worth it when a chunk could be given back, or when the holes have made the pool grow
+        const bool isSparse = static_cast<float>(used) < static_cast<float>(capacity) * m_config.m_compactOccupancy;
+        if (numActive < 2 || (!isSparse && !m_isFragmented)) {
+            return UINT32_MAX;
+        }
+
+        // the chunk with the least to move, as long as the others can take it and still have room to spare
+        uint32_t result = UINT32_MAX;
+        for (uint32_t i = 0; i < m_chunks.size(); i++) {
+            auto& chunk = m_chunks[i];
+            if (!chunk.m_allocator || chunk.m_numAllocations == 0) {
+                continue;
+            }
+            const uint64_t freeElsewhere = totalFree - (chunk.m_capacity - chunk.m_used - chunk.m_retired);
+            if (freeElsewhere >= chunk.m_used + m_config.m_chunkSize / 2 &&
+                (result == UINT32_MAX || chunk.m_used < m_chunks[result].m_used)) {
+                result = i;
+            }
+        }
+        return result;
+    }
+
+    uint32_t GeometryPool::evacuate(uint32_t budget) {
+        if (m_evacuateChunk == UINT32_MAX) {
+            m_evacuateChunk = findEvacuateChunk();
+            if (m_evacuateChunk == UINT32_MAX) {
+                m_isFragmented = false;
+                return 0;
+            }
+            m_isFragmented = false;
+            m_chunks[m_evacuateChunk].m_isDraining = true;
+            m_evacuateHandles.clear();
+            m_evacuateCursor = 0;
+            for (Handle handle = 0; handle < m_slots.size(); handle++) {
+                if (m_slots[handle].m_isAlive && m_slots[handle].m_chunk == m_evacuateChunk) {
+                    m_evacuateHandles.push_back(handle);
+                }
+            }
+            // the large ones first while there is the most room for them
+            std::sort(m_evacuateHandles.begin(), m_evacuateHandles.end(), [&](Handle a, Handle b) {
+                return m_slots[a].m_size > m_slots[b].m_size;
+            });
+        }
+
+        uint32_t moved = 0;
+        while (m_evacuateCursor < m_evacuateHandles.size() && moved < budget) {
+            const Handle handle = m_evacuateHandles[m_evacuateCursor];
+            auto& slot = m_slots[handle];
+            // freed since, or the slot was reused by a new allocation
+            if (!slot.m_isAlive || slot.m_chunk != m_evacuateChunk) {
+                m_evacuateCursor++;
+                continue;
+            }
+
+            uint32_t dstChunk = 0;
+            OffsetAllocator::Allocation dstAllocation;
+            // never grows, growing for every allocation that doesn't fit would just spread the chunk out
+            if (!allocateInChunks(slot.m_size, m_evacuateChunk, false, dstChunk, dstAllocation)) {
+                // nowhere to go, give up on this chunk for now
+                m_chunks[m_evacuateChunk].m_isDraining = false;
+                m_evacuateChunk = UINT32_MAX;
+                m_evacuateHandles.clear();
+                return moved;
+            }
+
+            m_store->move(slot.m_chunk, slot.m_allocation.offset, dstChunk, dstAllocation.offset, slot.m_size);
+
+            auto& srcChunk = m_chunks[slot.m_chunk];
+            srcChunk.m_used -= slot.m_size;
+            srcChunk.m_numAllocations--;
+            retire(slot.m_chunk, slot.m_allocation, slot.m_size);
+
+            auto& destChunk = m_chunks[dstChunk];
+            destChunk.m_used += slot.m_size;
+            destChunk.m_numAllocations++;
+            slot.m_chunk = dstChunk;
+            slot.m_allocation = dstAllocation;
+
+            moved += slot.m_size;
+            m_movedElements += slot.m_size;
+            m_evacuateCursor++;
+        }
+
+        if (m_evacuateCursor >= m_evacuateHandles.size()) {
+            m_evacuateChunk = UINT32_MAX;
+            m_evacuateHandles.clear();
+        }
+        return moved;
+    }
+
+} // namespace hpl
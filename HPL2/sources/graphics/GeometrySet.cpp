@@ -1,123 +1,173 @@
 #include "graphics/GeometrySet.h"
 #include "graphics/offsetAllocator.h"
 
+#include "Common_3/Utilities/Interfaces/ILog.h"
+
+#include <cstring>
+
 
 namespace hpl {
 
-    void GeometrySet::cmdBindGeometrySet(Cmd* cmd, std::span<ShaderSemantic> semantics) {
+    void GeometrySet::cmdBindGeometrySet(Cmd* cmd, uint32_t vertexChunk, uint32_t indexChunk, std::span<ShaderSemantic> semantics) {
         folly::small_vector<Buffer*, 16> bufferArgs;
         folly::small_vector<uint64_t, 16> offsetArgs;
         folly::small_vector<uint32_t, 16> strideArgs;
         for(auto& semantic: semantics) {
-            auto stream = getStreamBySemantic(semantic);
+            auto stream = getStreamBySemantic(vertexChunk, semantic);
             bufferArgs.push_back(stream->buffer().m_handle);
             offsetArgs.push_back(0);
             strideArgs.push_back(stream->stride());
         }
         cmdBindVertexBuffer(cmd, bufferArgs.size(), bufferArgs.data(), strideArgs.data(), offsetArgs.data());
-        cmdBindIndexBuffer(cmd, indexBuffer().m_handle, INDEX_TYPE_UINT32, 0);
+        cmdBindIndexBuffer(cmd, indexBuffer(indexChunk).m_handle, INDEX_TYPE_UINT32, 0);
     }
 
     std::shared_ptr<GeometrySet::GeometrySetSubAllocation> GeometrySet::allocate(uint32_t numElements, uint32_t numIndecies) {
         auto subAllocation = std::make_shared<GeometrySet::GeometrySetSubAllocation>();
-        subAllocation->m_indexAllocation = m_indexStreamAllocator.allocate(numIndecies);
-        subAllocation->m_vertexAllocation = m_vertexStreamAllocator.allocate(numElements);
-
-        auto vertexStorageReport = m_vertexStreamAllocator.storageReport();
-        auto indexStorageReport = m_indexStreamAllocator.storageReport();
-        //LOGF(LogLevel::eDEBUG, "vertex storage total free space: %d largest region: %d", vertexStorageReport.totalFreeSpace, vertexStorageReport.largestFreeRegion);
-        //LOGF(LogLevel::eDEBUG, "index storage total free space: %d largest region: %d", indexStorageReport.totalFreeSpace, indexStorageReport.largestFreeRegion);
-
-        ASSERT(subAllocation->m_indexAllocation.offset != OffsetAllocator::Allocation::NO_SPACE);
-        ASSERT(subAllocation->m_indexAllocation.metadata != OffsetAllocator::Allocation::NO_SPACE);
-        ASSERT(subAllocation->m_vertexAllocation.offset != OffsetAllocator::Allocation::NO_SPACE);
-        ASSERT(subAllocation->m_vertexAllocation.metadata != OffsetAllocator::Allocation::NO_SPACE);
-
+        subAllocation->m_indexHandle = m_indexPool.allocate(numIndecies);
+        subAllocation->m_vertexHandle = m_vertexPool.allocate(numElements);
         subAllocation->m_geometrySet = this;
 
+        if(subAllocation->m_indexHandle == GeometryPool::InvalidHandle || subAllocation->m_vertexHandle == GeometryPool::InvalidHandle) {
+            auto vertexStats = m_vertexPool.stats();
+            auto indexStats = m_indexPool.stats();
+            LOGF(LogLevel::eERROR, "GeometrySet out of space: vertex %llu/%llu in %u chunks, index %llu/%llu in %u chunks",
+                static_cast<unsigned long long>(vertexStats.m_used), static_cast<unsigned long long>(vertexStats.m_capacity), vertexStats.m_numChunks,
+                static_cast<unsigned long long>(indexStats.m_used), static_cast<unsigned long long>(indexStats.m_capacity), indexStats.m_numChunks);
+        }
+        ASSERT(subAllocation->m_indexHandle != GeometryPool::InvalidHandle);
+        ASSERT(subAllocation->m_vertexHandle != GeometryPool::InvalidHandle);
+
         return subAllocation;
     }
 
-    GeometrySet::GeometryStream::GeometryStream(GeometryStream&& stream)
-        : m_semantic(stream.m_semantic)
-        , m_stride(stream.m_stride)
-        , m_buffer(std::move(stream.m_buffer)) {
+    void GeometrySet::update(uint64_t frame) {
+        m_vertexPool.update(frame);
+        m_indexPool.update(frame);
     }
 
-    void GeometrySet::GeometryStream::operator=(GeometryStream&& stream){
-        m_semantic = stream.m_semantic;
-        m_stride = stream.m_stride;
-        m_buffer = std::move(stream.m_buffer);
+    GeometrySet::ChunkStore::ChunkStore(DescriptorType descriptors, std::span<GeometryStreamDesc> streamDesc)
+        : m_descriptors(descriptors)
+        , m_streamDesc(streamDesc.begin(), streamDesc.end()) {
     }
 
-    GeometrySet::GeometrySet(uint32_t numElements, uint32_t numIndecies, std::span<GeometryStreamDesc> streamDesc)
-        : m_vertexStreamAllocator(numElements)
-        , m_indexStreamAllocator(numIndecies) {
-        for (auto& desc : streamDesc) {
-            auto& vertexStream = m_vertexStreams.emplace_back();
-            vertexStream.m_stride = desc.m_stride;
-            vertexStream.m_semantic = desc.m_semantic;
-            vertexStream.m_buffer.Load([&](Buffer** buffer) {
+    void GeometrySet::ChunkStore::addChunk(uint32_t chunk, uint32_t numElements) {
+        if(chunk >= m_chunks.size()) {
+            m_chunks.resize(chunk + 1);
+        }
+        auto& streams = m_chunks[chunk];
+        streams.clear();
+        for (auto& desc : m_streamDesc) {
+            auto& stream = streams.emplace_back();
+            stream.m_stride = desc.m_stride;
+            stream.m_semantic = desc.m_semantic;
+            stream.m_buffer.Load([&](Buffer** buffer) {
                 BufferLoadDesc loadDesc = {};
                 loadDesc.ppBuffer = buffer;
-                loadDesc.mDesc.mDescriptors = DESCRIPTOR_TYPE_VERTEX_BUFFER | DESCRIPTOR_TYPE_BUFFER_RAW;
+                loadDesc.mDesc.mDescriptors = m_descriptors;
                 loadDesc.mDesc.mMemoryUsage = RESOURCE_MEMORY_USAGE_CPU_TO_GPU;
-                loadDesc.mDesc.mStructStride = vertexStream.m_stride;
+                loadDesc.mDesc.mFlags = BUFFER_CREATION_FLAG_PERSISTENT_MAP_BIT;
+                loadDesc.mDesc.mStructStride = stream.m_stride;
                 loadDesc.mDesc.mElementCount = numElements;
-                loadDesc.mDesc.mSize = numElements * vertexStream.m_stride;
+                loadDesc.mDesc.mSize = static_cast<uint64_t>(numElements) * stream.m_stride;
                 loadDesc.mDesc.pName = desc.m_name;
                 addResource(&loadDesc, nullptr);
                 return true;
             });
         }
-        m_indexBuffer.Load([&](Buffer** buffer) {
-            BufferLoadDesc loadDesc = {};
-            loadDesc.ppBuffer = buffer;
-            loadDesc.mDesc.mDescriptors = DESCRIPTOR_TYPE_INDEX_BUFFER | DESCRIPTOR_TYPE_BUFFER_RAW;
-            loadDesc.mDesc.mMemoryUsage = RESOURCE_MEMORY_USAGE_CPU_TO_GPU;
-            loadDesc.mDesc.mStructStride = sizeof(uint32_t);
-            loadDesc.mDesc.mElementCount = numIndecies;
-            loadDesc.mDesc.mSize = numIndecies * sizeof(uint32_t);
-            loadDesc.mDesc.pName = "GeometrySet Index";
-            addResource(&loadDesc, nullptr);
-            return true;
-        });
+    }
+
+    void GeometrySet::ChunkStore::removeChunk(uint32_t chunk) {
+        // frames in flight keep their own reference through the command resource pool
+        m_chunks[chunk].clear();
+    }
+
+    void GeometrySet::ChunkStore::move(uint32_t srcChunk, uint32_t srcOffset, uint32_t dstChunk, uint32_t dstOffset, uint32_t numElements) {
+        auto& srcStreams = m_chunks[srcChunk];
+        auto& dstStreams = m_chunks[dstChunk];
+        for (size_t i = 0; i < srcStreams.size(); i++) {
+            const uint64_t stride = srcStreams[i].m_stride;
+            auto* src = static_cast<uint8_t*>(srcStreams[i].m_buffer.m_handle->pCpuMappedAddress);
+            auto* dst = static_cast<uint8_t*>(dstStreams[i].m_buffer.m_handle->pCpuMappedAddress);
+            ASSERT(src && dst);
+            std::memcpy(dst + dstOffset * stride, src + srcOffset * stride, numElements * stride);
+        }
+    }
+
+    GeometrySet::GeometryStream::GeometryStream(GeometryStream&& stream)
+        : m_semantic(stream.m_semantic)
+        , m_stride(stream.m_stride)
+        , m_buffer(std::move(stream.m_buffer)) {
+    }
+
+    void GeometrySet::GeometryStream::operator=(GeometryStream&& stream){
+        m_semantic = stream.m_semantic;
+        m_stride = stream.m_stride;
+        m_buffer = std::move(stream.m_buffer);
+    }
+
+    GeometrySet::GeometrySet(const GeometryPool::Config& vertexConfig, const GeometryPool::Config& indexConfig, std::span<GeometryStreamDesc> streamDesc) {
+        std::array indexDesc = {
+            GeometryStreamDesc("GeometrySet Index", ShaderSemantic::SEMANTIC_UNDEFINED, IndexBufferStride),
+        };
+        m_vertexStore = std::make_unique<ChunkStore>(DESCRIPTOR_TYPE_VERTEX_BUFFER | DESCRIPTOR_TYPE_BUFFER_RAW, streamDesc);
+        m_indexStore = std::make_unique<ChunkStore>(DESCRIPTOR_TYPE_INDEX_BUFFER | DESCRIPTOR_TYPE_BUFFER_RAW, indexDesc);
+        m_vertexPool = GeometryPool(vertexConfig, m_vertexStore.get());
+        m_indexPool = GeometryPool(indexConfig, m_indexStore.get());
     }
 
     GeometrySet::GeometryStream::GeometryStream() {
     }
 
-    GeometrySet::GeometrySet()
-        : m_vertexStreamAllocator(0)
-        , m_indexStreamAllocator(0) {
+    GeometrySet::GeometrySet() {
     }
 
     GeometrySet::GeometrySet(GeometrySet&& set)
-        : m_vertexStreamAllocator(std::move(set.m_vertexStreamAllocator))
-        , m_indexStreamAllocator(std::move(set.m_indexStreamAllocator))
-        , m_vertexStreams(std::move(set.m_vertexStreams))
-        , m_indexBuffer(std::move(set.m_indexBuffer)) {
+        : m_vertexStore(std::move(set.m_vertexStore))
+        , m_indexStore(std::move(set.m_indexStore))
+        , m_vertexPool(std::move(set.m_vertexPool))
+        , m_indexPool(std::move(set.m_indexPool)) {
     }
 
     void GeometrySet::operator=(GeometrySet&& set) {
-        m_vertexStreamAllocator = std::move(set.m_vertexStreamAllocator);
-        m_indexStreamAllocator = std::move(set.m_indexStreamAllocator);
-        m_vertexStreams = std::move(set.m_vertexStreams);
-        m_indexBuffer = std::move(set.m_indexBuffer);
+        m_vertexPool = std::move(set.m_vertexPool);
+        m_indexPool = std::move(set.m_indexPool);
+        m_vertexStore = std::move(set.m_vertexStore);
+        m_indexStore = std::move(set.m_indexStore);
     }
 
 
     GeometrySet::GeometrySetSubAllocation::GeometrySetSubAllocation(GeometrySetSubAllocation&& allocation):
-        m_vertexAllocation(std::move(allocation.m_vertexAllocation)),
-        m_indexAllocation(std::move(allocation.m_vertexAllocation)),
+        m_vertexHandle(allocation.m_vertexHandle),
+        m_indexHandle(allocation.m_indexHandle),
         m_geometrySet(allocation.m_geometrySet){
+        allocation.m_vertexHandle = GeometryPool::InvalidHandle;
+        allocation.m_indexHandle = GeometryPool::InvalidHandle;
+        allocation.m_geometrySet = nullptr;
     }
 
-    GeometrySet::GeometrySetSubAllocation::~GeometrySetSubAllocation() {
+    void GeometrySet::GeometrySetSubAllocation::operator=(GeometrySetSubAllocation&& allocation) {
+        release();
+        m_vertexHandle = allocation.m_vertexHandle;
+        m_indexHandle = allocation.m_indexHandle;
+        m_geometrySet = allocation.m_geometrySet;
+        allocation.m_vertexHandle = GeometryPool::InvalidHandle;
+        allocation.m_indexHandle = GeometryPool::InvalidHandle;
+        allocation.m_geometrySet = nullptr;
+    }
+
+    void GeometrySet::GeometrySetSubAllocation::release() {
         if(m_geometrySet) {
-            m_geometrySet->m_vertexStreamAllocator.free(m_vertexAllocation);
-            m_geometrySet->m_indexStreamAllocator.free(m_indexAllocation);
+            m_geometrySet->m_vertexPool.free(m_vertexHandle);
+            m_geometrySet->m_indexPool.free(m_indexHandle);
         }
+        m_vertexHandle = GeometryPool::InvalidHandle;
+        m_indexHandle = GeometryPool::InvalidHandle;
+        m_geometrySet = nullptr;
+    }
+
+    GeometrySet::GeometrySetSubAllocation::~GeometrySetSubAllocation() {
+        release();
     }
 
     GeometrySet::GeometrySetSubAllocation::GeometrySetSubAllocation() {
@@ -8,6 +8,30 @@ namespace hpl {
         return m_geometrySets[set];
     }
 
+    void GraphicsAllocator::Update(uint64_t frame) {
+        for (auto& set : m_geometrySets) {
+            set.update(frame);
+        }
+    }
+
+    GeometryPool::Stats GraphicsAllocator::vertexStats(AllocationSet set) const {
+        return m_geometrySets[set].vertexStats();
+    }
+
+    GeometryPool::Stats GraphicsAllocator::indexStats(AllocationSet set) const {
+        return m_geometrySets[set].indexStats();
+    }
+
+    static GeometryPool::Config CreatePoolConfig(uint32_t chunkSize, uint32_t maxChunks, uint32_t moveBudget) {
+        GeometryPool::Config config;
+        config.m_chunkSize = chunkSize;
+        config.m_maxChunks = maxChunks;
+        config.m_moveBudget = moveBudget;
+        // a freed range can still be read by the frames the gpu has not finished yet
+        config.m_retireFrames = ForgeRenderer::SwapChainLength;
+        return config;
+    }
+
     GraphicsAllocator::GraphicsAllocator(ForgeRenderer* renderer)
         : m_renderer(renderer) {
         {
@@ -18,7 +42,10 @@ namespace hpl {
                 GeometrySet::GeometryStreamDesc("opaque_uv0", ShaderSemantic::SEMANTIC_TEXCOORD0, sizeof(float2)),
                 GeometrySet::GeometryStreamDesc("opaque_color", ShaderSemantic::SEMANTIC_COLOR, sizeof(float4)),
             };
-            m_geometrySets[AllocationSet::OpaqueSet] = GeometrySet(OpaqueVertexBufferSize, OpaqueIndexBufferSize, streamDesc);
+            m_geometrySets[AllocationSet::OpaqueSet] = GeometrySet(
+                CreatePoolConfig(OpaqueVertexChunkSize, OpaqueMaxChunks, VertexMoveBudget),
+                CreatePoolConfig(OpaqueIndexChunkSize, OpaqueMaxChunks, IndexMoveBudget),
+                streamDesc);
         }
         {
             std::array streamDesc = {
@@ -26,7 +53,10 @@ namespace hpl {
                 GeometrySet::GeometryStreamDesc("opaque_uv0", ShaderSemantic::SEMANTIC_TEXCOORD0, sizeof(float2)),
                 GeometrySet::GeometryStreamDesc("opaque_color", ShaderSemantic::SEMANTIC_COLOR, sizeof(float4)),
             };
-            m_geometrySets[AllocationSet::ParticleSet] = GeometrySet(ParticleVertexBufferSize, ParticleIndexBufferSize, streamDesc);
+            m_geometrySets[AllocationSet::ParticleSet] = GeometrySet(
+                CreatePoolConfig(ParticleVertexChunkSize, ParticleMaxChunks, VertexMoveBudget),
+                CreatePoolConfig(ParticleIndexChunkSize, ParticleMaxChunks, IndexMoveBudget),
+                streamDesc);
         }
 
         {
@@ -16,8 +16,11 @@
 
 #include <graphics/Image.h>
 #include <graphics/Bitmap.h>
+#include <algorithm>
 #include <vector>
 
+#include "tinyimageformat_query.h"
+
 namespace hpl
 {
 
@@ -55,4 +58,27 @@ namespace hpl
     void Image::operator=(Image&& other) {
         m_texture = std::move(other.m_texture);
     }
+
+    size_t Image::GetMemorySize() const {
+        if (!m_texture.IsValid()) {
+            return 0;
+        }
+        const Texture* texture = m_texture.m_handle;
+        const TinyImageFormat format = static_cast<TinyImageFormat>(texture->mFormat);
+        const size_t blockWidth = TinyImageFormat_WidthOfBlock(format);
+        const size_t blockHeight = TinyImageFormat_HeightOfBlock(format);
+        const size_t blockBytes = TinyImageFormat_BitSizeOfBlock(format) / 8;
+
+        size_t width = texture->mWidth;
+        size_t height = texture->mHeight;
+        size_t depth = texture->mDepth;
+        size_t size = 0;
+        for (uint32_t mip = 0; mip < texture->mMipLevels; ++mip) {
+            size += ((width + blockWidth - 1) / blockWidth) * ((height + blockHeight - 1) / blockHeight) * depth * blockBytes;
+            width = std::max<size_t>(1, width / 2);
+            height = std::max<size_t>(1, height / 2);
+            depth = std::max<size_t>(1, depth / 2);
+        }
+        return size * (static_cast<size_t>(texture->mArraySizeMinusOne) + 1);
+    }
 } // namespace hpl
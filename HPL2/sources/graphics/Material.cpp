@@ -33,6 +33,7 @@
 #include "graphics/Renderable.h"
 
 #include "math/Math.h"
+#include <algorithm>
 #include <utility>
 
 #include "tinyimageformat_query.h"
@@ -48,6 +49,7 @@ namespace hpl {
     }
 
     cMaterial::~cMaterial() {
+        cMaterialUvAnimationTable::Remove(this);
     }
 
     void cMaterial::SetTextureAnisotropy(float afx) {
@@ -199,49 +201,262 @@ namespace hpl {
     }
 
     void cMaterial::UpdateBeforeRendering(float afTimeStep) {
-        if(!mvUvAnimations.empty()) {
-            m_mtxUV = cMatrixf::Identity;
-            for (size_t i = 0; i < mvUvAnimations.size(); ++i) {
-                cMaterialUvAnimation* pAnim = &mvUvAnimations[i];
-                switch(pAnim->mType) {
-                    case eMaterialUvAnimation_Translate: {
-                        cVector3f vDir = GetAxisVector(pAnim->mAxis);
-                        cMatrixf mtxAdd = cMath::MatrixTranslate(vDir * pAnim->mfSpeed * mfAnimTime);
-                        m_mtxUV = cMath::MatrixMul(m_mtxUV, mtxAdd);
-                        break;
-                    }
-                    case eMaterialUvAnimation_Sin: {
-                        cVector3f vDir = GetAxisVector(pAnim->mAxis);
-                        cMatrixf mtxAdd = cMath::MatrixTranslate(vDir * sin(mfAnimTime * pAnim->mfSpeed) * pAnim->mfAmp);
-                        m_mtxUV = cMath::MatrixMul(m_mtxUV, mtxAdd);
-                        break;
-                    }
-                    case eMaterialUvAnimation_Rotate: {
-                        cVector3f vDir = GetAxisVector(pAnim->mAxis);
-                        cMatrixf mtxRot = cMath::MatrixRotate(vDir * pAnim->mfSpeed * mfAnimTime, eEulerRotationOrder_XYZ);
-                        m_mtxUV = cMath::MatrixMul(m_mtxUV, mtxRot);
-                        break;
-                    }
-                    default: {
-                        ASSERT(false && "Unknown Animation Type");
-                        break;
-                    }
-                }
+        // The caller has just set the render frame count, the table is only evaluated for the first material
+        cMaterialUvAnimationTable::Update(mlRenderFrameCount, afTimeStep);
+    }
+
+    cMatrixf cMaterial::GetUvMatrixAtTime(float afTime) const {
+        cMatrixf mtxUV = cMatrixf::Identity;
+        for (const cMaterialUvAnimation& anim : mvUvAnimations) {
+            switch (anim.mType) {
+            case eMaterialUvAnimation_Translate: {
+                cVector3f vDir = GetAxisVector(anim.mAxis);
+                cMatrixf mtxAdd = cMath::MatrixTranslate(vDir * anim.mfSpeed * afTime);
+                mtxUV = cMath::MatrixMul(mtxUV, mtxAdd);
+                break;
+            }
+            case eMaterialUvAnimation_Sin: {
+                cVector3f vDir = GetAxisVector(anim.mAxis);
+                cMatrixf mtxAdd = cMath::MatrixTranslate(vDir * sin(afTime * anim.mfSpeed) * anim.mfAmp);
+                mtxUV = cMath::MatrixMul(mtxUV, mtxAdd);
+                break;
+            }
+            case eMaterialUvAnimation_Rotate: {
+                cVector3f vDir = GetAxisVector(anim.mAxis);
+                cMatrixf mtxRot = cMath::MatrixRotate(vDir * anim.mfSpeed * afTime, eEulerRotationOrder_XYZ);
+                mtxUV = cMath::MatrixMul(mtxUV, mtxRot);
+                break;
+            }
+            default: {
+                ASSERT(false && "Unknown Animation Type");
+                break;
+            }
             }
-            IncreaseGeneration();
-            mfAnimTime += afTimeStep;
         }
+        return mtxUV;
     }
 
     void cMaterial::AddUvAnimation(eMaterialUvAnimation aType, float afSpeed, float afAmp, eMaterialAnimationAxis aAxis) {
         mvUvAnimations.push_back(cMaterialUvAnimation(aType, afSpeed, afAmp, aAxis));
+        if (mlUvAnimationSlot < 0) {
+            cMaterialUvAnimationTable::Add(this);
+        } else {
+            cMaterialUvAnimationTable::SetChanged();
+        }
     }
 
     //-----------------------------------------------------------------------
 
     void cMaterial::ClearUvAnimations() {
+        cMaterialUvAnimationTable::Remove(this);
         mvUvAnimations.clear();
         m_mtxUV = cMatrixf::Identity;
     }
 
+    //-----------------------------------------------------------------------
+
+    std::vector<cMaterial*> cMaterialUvAnimationTable::mvMaterials;
+    std::vector<double> cMaterialUvAnimationTable::mvStartTime;
+    double cMaterialUvAnimationTable::mfTime = 0;
+    int cMaterialUvAnimationTable::mlLastRenderFrame = -1;
+    bool cMaterialUvAnimationTable::mbCompiled = false;
+    int cMaterialUvAnimationTable::mlPlanarMaterials = 0;
+    int cMaterialUvAnimationTable::mlChangedNum = 0;
+
+    std::vector<uint32_t> cMaterialUvAnimationTable::mvPlanarSlots;
+    std::vector<uint32_t> cMaterialUvAnimationTable::mvMatrixSlots;
+    std::vector<uint32_t> cMaterialUvAnimationTable::mvPlanarFirstAnim;
+    std::vector<float> cMaterialUvAnimationTable::mvLocalTime;
+
+    std::vector<uint32_t> cMaterialUvAnimationTable::mvAnimMaterial;
+    std::vector<float> cMaterialUvAnimationTable::mvAnimSpeed;
+    std::vector<float> cMaterialUvAnimationTable::mvAnimAmp;
+    std::vector<float> cMaterialUvAnimationTable::mvAnimDirU;
+    std::vector<float> cMaterialUvAnimationTable::mvAnimDirV;
+    std::vector<float> cMaterialUvAnimationTable::mvAnimAffine[6];
+    std::vector<uint32_t> cMaterialUvAnimationTable::mvSinAnims;
+    std::vector<uint32_t> cMaterialUvAnimationTable::mvRotateAnims;
+
+    void cMaterialUvAnimationTable::Add(cMaterial* apMaterial) {
+        apMaterial->mlUvAnimationSlot = (int)mvMaterials.size();
+        mvMaterials.push_back(apMaterial);
+        mvStartTime.push_back(mfTime);
+        mbCompiled = false;
+    }
+
+    void cMaterialUvAnimationTable::Remove(cMaterial* apMaterial) {
+        const int slot = apMaterial->mlUvAnimationSlot;
+        if (slot < 0) {
+            return;
+        }
+
+        // The last one takes the place of the removed one
+        mvMaterials[slot] = mvMaterials.back();
+        mvStartTime[slot] = mvStartTime.back();
+        mvMaterials[slot]->mlUvAnimationSlot = slot;
+        mvMaterials.pop_back();
+        mvStartTime.pop_back();
+
+        apMaterial->mlUvAnimationSlot = -1;
+        mbCompiled = false;
+    }
+
+    //-----------------------------------------------------------------------
+
+    static bool IsPlanarUvAnimation(const cMaterialUvAnimation& aAnim) {
+        switch (aAnim.mType) {
+        case eMaterialUvAnimation_Translate:
+        case eMaterialUvAnimation_Sin:
+            return aAnim.mAxis == eMaterialAnimationAxis_X || aAnim.mAxis == eMaterialAnimationAxis_Y;
+        case eMaterialUvAnimation_Rotate:
+            return aAnim.mAxis == eMaterialAnimationAxis_Z;
+        default:
+            break;
+        }
+        return false;
+    }
+
+    void cMaterialUvAnimationTable::Compile() {
+        mvPlanarSlots.resize(0);
+        mvMatrixSlots.resize(0);
+        mvPlanarFirstAnim.resize(0);
+        mvAnimMaterial.resize(0);
+        mvAnimSpeed.resize(0);
+        mvAnimAmp.resize(0);
+        mvAnimDirU.resize(0);
+        mvAnimDirV.resize(0);
+        mvSinAnims.resize(0);
+        mvRotateAnims.resize(0);
+
+        for (uint32_t slot = 0; slot < mvMaterials.size(); ++slot) {
+            const std::vector<cMaterialUvAnimation>& vAnims = mvMaterials[slot]->mvUvAnimations;
+            if (std::all_of(vAnims.begin(), vAnims.end(), IsPlanarUvAnimation) == false) {
+                mvMatrixSlots.push_back(slot);
+                continue;
+            }
+
+            mvPlanarSlots.push_back(slot);
+            mvPlanarFirstAnim.push_back((uint32_t)mvAnimMaterial.size());
+            for (const cMaterialUvAnimation& anim : vAnims) {
+                if (anim.mType == eMaterialUvAnimation_Sin) {
+                    mvSinAnims.push_back((uint32_t)mvAnimMaterial.size());
+                } else if (anim.mType == eMaterialUvAnimation_Rotate) {
+                    mvRotateAnims.push_back((uint32_t)mvAnimMaterial.size());
+                }
+                mvAnimMaterial.push_back(slot);
+                mvAnimSpeed.push_back(anim.mfSpeed);
+                mvAnimAmp.push_back(anim.mfAmp);
+                mvAnimDirU.push_back(anim.mType != eMaterialUvAnimation_Rotate && anim.mAxis == eMaterialAnimationAxis_X ? 1.0f : 0.0f);
+                mvAnimDirV.push_back(anim.mType != eMaterialUvAnimation_Rotate && anim.mAxis == eMaterialAnimationAxis_Y ? 1.0f : 0.0f);
+            }
+        }
+        mvPlanarFirstAnim.push_back((uint32_t)mvAnimMaterial.size());
+
+        for (auto& affine : mvAnimAffine) {
+            affine.resize(mvAnimMaterial.size());
+        }
+        mvLocalTime.resize(mvMaterials.size());
+        mlPlanarMaterials = (int)mvPlanarSlots.size();
+        mbCompiled = true;
+    }
+
+    //-----------------------------------------------------------------------
+
+    void cMaterialUvAnimationTable::Update(int alRenderFrame, float afTimeStep) {
+        if (alRenderFrame == mlLastRenderFrame) {
+            return;
+        }
+        mlLastRenderFrame = alRenderFrame;
+        mlChangedNum = 0;
+
+        if (mvMaterials.empty()) {
+            return;
+        }
+        if (!mbCompiled) {
+            Compile();
+        }
+
+        for (size_t i = 0; i < mvMaterials.size(); ++i) {
+            mvLocalTime[i] = (float)(mfTime - mvStartTime[i]);
+        }
+
+        ////////////////////////////
+        // Each animation as a 2D affine transform. All start out as a move along their axis, rotations have
+        // no axis so they do not move. Only the sin and rotate animations then need any trigonometry.
+        const size_t animNum = mvAnimMaterial.size();
+        float* pA = mvAnimAffine[0].data();
+        float* pB = mvAnimAffine[1].data();
+        float* pC = mvAnimAffine[2].data();
+        float* pD = mvAnimAffine[3].data();
+        float* pTx = mvAnimAffine[4].data();
+        float* pTy = mvAnimAffine[5].data();
+        for (size_t i = 0; i < animNum; ++i) {
+            const float fMove = mvAnimSpeed[i] * mvLocalTime[mvAnimMaterial[i]];
+            pA[i] = 1;
+            pB[i] = 0;
+            pC[i] = 0;
+            pD[i] = 1;
+            pTx[i] = fMove * mvAnimDirU[i];
+            pTy[i] = fMove * mvAnimDirV[i];
+        }
+        for (uint32_t i : mvSinAnims) {
+            const float fMove = sinf(mvAnimSpeed[i] * mvLocalTime[mvAnimMaterial[i]]) * mvAnimAmp[i];
+            pTx[i] = fMove * mvAnimDirU[i];
+            pTy[i] = fMove * mvAnimDirV[i];
+        }
+        for (uint32_t i : mvRotateAnims) {
+            const float fAngle = mvAnimSpeed[i] * mvLocalTime[mvAnimMaterial[i]];
+            const float fCos = cosf(fAngle);
+            const float fSin = sinf(fAngle);
+            pA[i] = fCos;
+            pB[i] = -fSin;
+            pC[i] = fSin;
+            pD[i] = fCos;
+        }
+
+        ////////////////////////////
+        // Chain the animations of each material in the order they were added, as the matrices were multiplied
+        for (size_t i = 0; i < mvPlanarSlots.size(); ++i) {
+            float a = 1, b = 0, c = 0, d = 1, tx = 0, ty = 0;
+            for (uint32_t j = mvPlanarFirstAnim[i]; j < mvPlanarFirstAnim[i + 1]; ++j) {
+                const float fTx = a * pTx[j] + b * pTy[j] + tx;
+                const float fTy = c * pTx[j] + d * pTy[j] + ty;
+                const float fA = a * pA[j] + b * pC[j];
+                const float fB = a * pB[j] + b * pD[j];
+                const float fC = c * pA[j] + d * pC[j];
+                const float fD = c * pB[j] + d * pD[j];
+                a = fA;
+                b = fB;
+                c = fC;
+                d = fD;
+                tx = fTx;
+                ty = fTy;
+            }
+
+            cMatrixf& mtxUV = mvMaterials[mvPlanarSlots[i]]->m_mtxUV;
+            if (mtxUV.m[0][0] == a && mtxUV.m[0][1] == b && mtxUV.m[1][0] == c && mtxUV.m[1][1] == d && mtxUV.m[0][3] == tx &&
+                mtxUV.m[1][3] == ty) {
+                continue;
+            }
+            mtxUV = cMatrixf(a, b, 0, tx,
+                             c, d, 0, ty,
+                             0, 0, 1, 0,
+                             0, 0, 0, 1);
+            ++mlChangedNum;
+        }
+
+        ////////////////////////////
+        // Animations that turn the uv plane out of itself
+        for (uint32_t slot : mvMatrixSlots) {
+            cMaterial* pMaterial = mvMaterials[slot];
+            cMatrixf mtxUV = pMaterial->GetUvMatrixAtTime(mvLocalTime[slot]);
+            if (mtxUV != pMaterial->m_mtxUV) {
+                pMaterial->m_mtxUV = mtxUV;
+                ++mlChangedNum;
+            }
+        }
+
+        mfTime += afTimeStep;
+    }
+
 } // namespace hpl
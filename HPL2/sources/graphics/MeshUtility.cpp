@@ -7,8 +7,11 @@
 #include "graphics/mikktspace.h"
 #include "math/Math.h"
 
+#include <algorithm>
 #include <cfloat>
+#include <cmath>
 #include <cstdint>
+#include <cstring>
 #include <array>
 #include <folly/small_vector.h>
 #include <variant>
@@ -808,4 +811,398 @@ namespace hpl::MeshUtility {
         bool isSuccess = genTangSpaceDefault(&context);
         ASSERT(isSuccess == true);
     }
+
+    namespace details {
+        // tuning from Forsyth's "Linear-Speed Vertex Cache Optimisation"
+        static constexpr uint32_t ForsythCacheSize = 32;
+        static constexpr float ForsythCacheDecayPower = 1.5f;
+        static constexpr float ForsythLastTriScore = 0.75f;
+        static constexpr float ForsythValenceBoostScale = 2.0f;
+        static constexpr float ForsythValenceBoostPower = 0.5f;
+
+        static float ForsythVertexScore(int cachePosition, uint32_t remainingValence) {
+            if (remainingValence == 0) {
+                return -1.0f; // no triangles left that use the vertex
+            }
+            float score = 0.0f;
+            if (cachePosition >= 0) {
+                if (cachePosition < 3) {
+                    // used by the last triangle, a fixed score so it is not picked again right away
+                    score = ForsythLastTriScore;
+                } else {
+                    const float scaler = 1.0f / (ForsythCacheSize - 3);
+                    score = std::pow(1.0f - (cachePosition - 3) * scaler, ForsythCacheDecayPower);
+                }
+            }
+            // vertices with few triangles left are worth finishing off
+            score += ForsythValenceBoostScale * std::pow(static_cast<float>(remainingValence), -ForsythValenceBoostPower);
+            return score;
+        }
+
+        static float SignNotZero(float value) {
+            return value >= 0.0f ? 1.0f : -1.0f;
+        }
+
+        static float AngleBetweenDegrees(const float3& a, const float3& b) {
+            const float lenA = std::sqrt(a.x * a.x + a.y * a.y + a.z * a.z);
+            const float lenB = std::sqrt(b.x * b.x + b.y * b.y + b.z * b.z);
+            if (lenA < FLT_EPSILON || lenB < FLT_EPSILON) {
+                return 0.0f;
+            }
+            const float cosAngle = std::clamp((a.x * b.x + a.y * b.y + a.z * b.z) / (lenA * lenB), -1.0f, 1.0f);
+            return std::acos(cosAngle) * (180.0f / kPif);
+        }
+    } // namespace details
+
+    void OptimizeVertexCache(
+        uint32_t numVerts,
+        uint32_t numIndecies,
+        GraphicsBuffer::BufferIndexView* index) {
+        const uint32_t numTriangles = numIndecies / 3;
+        if (numTriangles == 0) {
+            return;
+        }
+
+        std::vector<uint32_t> indices(numTriangles * 3);
+        for (uint32_t i = 0; i < indices.size(); i++) {
+            indices[i] = index->Get(i);
+        }
+
+        // triangles using each vertex, the ones not yet added are kept first in each list
+        std::vector<uint32_t> remainingValence(numVerts, 0);
+        for (uint32_t idx : indices) {
+            remainingValence[idx]++;
+        }
+        std::vector<uint32_t> adjacencyOffset(numVerts + 1, 0);
+        for (uint32_t i = 0; i < numVerts; i++) {
+            adjacencyOffset[i + 1] = adjacencyOffset[i] + remainingValence[i];
+        }
+        std::vector<uint32_t> adjacency(indices.size());
+        {
+            std::vector<uint32_t> fill(adjacencyOffset.begin(), adjacencyOffset.end() - 1);
+            for (uint32_t i = 0; i < indices.size(); i++) {
+                adjacency[fill[indices[i]]++] = i / 3;
+            }
+        }
+
+        std::vector<int> cachePosition(numVerts, -1);
+        std::vector<float> vertexScore(numVerts);
+        for (uint32_t i = 0; i < numVerts; i++) {
+            vertexScore[i] = details::ForsythVertexScore(-1, remainingValence[i]);
+        }
+        std::vector<float> triangleScore(numTriangles);
+        std::vector<bool> triangleAdded(numTriangles, false);
+        for (uint32_t i = 0; i < numTriangles; i++) {
+            triangleScore[i] = vertexScore[indices[i * 3]] + vertexScore[indices[i * 3 + 1]] + vertexScore[indices[i * 3 + 2]];
+        }
+
+        std::array<uint32_t, details::ForsythCacheSize + 3> cache;
+        std::array<uint32_t, details::ForsythCacheSize + 3> newCache;
+        uint32_t cacheCount = 0;
+        uint32_t scanCursor = 0;
+        int bestTriangle = -1;
+
+        std::vector<uint32_t> output;
+        output.reserve(indices.size());
+        for (uint32_t added = 0; added < numTriangles; added++) {
+            // nothing in the cache has triangles left, continue with the next triangle in the original order
+            if (bestTriangle < 0) {
+                while (triangleAdded[scanCursor]) {
+                    scanCursor++;
+                }
+                bestTriangle = scanCursor;
+            }
+
+            const uint32_t* tri = &indices[bestTriangle * 3];
+            triangleAdded[bestTriangle] = true;
+            for (uint32_t k = 0; k < 3; k++) {
+                const uint32_t vtx = tri[k];
+                output.push_back(vtx);
+
+                // move the triangle past the remaining ones in the vertex's list
+                uint32_t* list = &adjacency[adjacencyOffset[vtx]];
+                uint32_t last = remainingValence[vtx] - 1;
+                for (uint32_t j = 0; j <= last; j++) {
+                    if (list[j] == static_cast<uint32_t>(bestTriangle)) {
+                        std::swap(list[j], list[last]);
+                        break;
+                    }
+                }
+                remainingValence[vtx]--;
+            }
+
+            // the triangle's vertices go first in the cache, the rest are pushed back
+            uint32_t newCount = 0;
+            for (uint32_t k = 0; k < 3; k++) {
+                newCache[newCount++] = tri[k];
+            }
+            for (uint32_t i = 0; i < cacheCount; i++) {
+                const uint32_t vtx = cache[i];
+                if (vtx != tri[0] && vtx != tri[1] && vtx != tri[2]) {
+                    newCache[newCount++] = vtx;
+                }
+            }
+            for (uint32_t i = details::ForsythCacheSize; i < newCount; i++) {
+                cachePosition[newCache[i]] = -1;
+                vertexScore[newCache[i]] = details::ForsythVertexScore(-1, remainingValence[newCache[i]]);
+            }
+            cacheCount = std::min(newCount, details::ForsythCacheSize);
+            for (uint32_t i = 0; i < cacheCount; i++) {
+                const uint32_t vtx = newCache[i];
+                cache[i] = vtx;
+                cachePosition[vtx] = static_cast<int>(i);
+                vertexScore[vtx] = details::ForsythVertexScore(static_cast<int>(i), remainingValence[vtx]);
+            }
+
+            // rescore the triangles touching the changed vertices and pick the best
+            bestTriangle = -1;
+            float bestScore = -1.0f;
+            for (uint32_t i = 0; i < newCount; i++) {
+                const uint32_t vtx = newCache[i];
+                for (uint32_t j = 0; j < remainingValence[vtx]; j++) {
+                    const uint32_t triIdx = adjacency[adjacencyOffset[vtx] + j];
+                    const uint32_t* adjTri = &indices[triIdx * 3];
+                    const float score = vertexScore[adjTri[0]] + vertexScore[adjTri[1]] + vertexScore[adjTri[2]];
+                    triangleScore[triIdx] = score;
+                    if (score > bestScore) {
+                        bestScore = score;
+                        bestTriangle = static_cast<int>(triIdx);
+                    }
+                }
+            }
+        }
+
+        for (uint32_t i = 0; i < output.size(); i++) {
+            index->Write(i, output[i]);
+        }
+    }
+
+    std::vector<uint32_t> OptimizeVertexFetch(
+        uint32_t numVerts,
+        uint32_t numIndecies,
+        GraphicsBuffer::BufferIndexView* index) {
+        std::vector<uint32_t> remap(numVerts, UINT32_MAX);
+        uint32_t nextVertex = 0;
+        for (uint32_t i = 0; i < numIndecies; i++) {
+            const uint32_t vtx = index->Get(i);
+            if (remap[vtx] == UINT32_MAX) {
+                remap[vtx] = nextVertex++;
+            }
+            index->Write(i, remap[vtx]);
+        }
+        for (uint32_t i = 0; i < numVerts; i++) {
+            if (remap[i] == UINT32_MAX) {
+                remap[i] = nextVertex++;
+            }
+        }
+        return remap;
+    }
+
+    VertexCacheStats AnalyzeVertexCache(
+        uint32_t numVerts,
+        uint32_t numIndecies,
+        GraphicsBuffer::BufferIndexView* index,
+        uint32_t cacheSize) {
+        VertexCacheStats stats;
+        if (numIndecies < 3) {
+            return stats;
+        }
+
+        // a vertex is still in the FIFO if fewer than cacheSize misses happened since it was added
+        std::vector<uint32_t> addedAtMiss(numVerts, 0);
+        std::vector<bool> used(numVerts, false);
+        uint32_t missCount = 0;
+        uint32_t usedCount = 0;
+        for (uint32_t i = 0; i < numIndecies; i++) {
+            const uint32_t vtx = index->Get(i);
+            if (!used[vtx]) {
+                used[vtx] = true;
+                usedCount++;
+            }
+            if (addedAtMiss[vtx] == 0 || missCount + 1 - addedAtMiss[vtx] > cacheSize) {
+                missCount++;
+                addedAtMiss[vtx] = missCount;
+            }
+        }
+
+        stats.acmr = static_cast<float>(missCount) / static_cast<float>(numIndecies / 3);
+        stats.atvr = static_cast<float>(missCount) / static_cast<float>(std::max(usedCount, 1u));
+        return stats;
+    }
+
+    float AnalyzeVertexFetch(
+        uint32_t numVerts,
+        uint32_t numIndecies,
+        GraphicsBuffer::BufferIndexView* index,
+        uint32_t vertexSize) {
+        static constexpr uint32_t CacheLineSize = 64;
+        static constexpr uint32_t CacheLineNum = 64;
+        static constexpr uint32_t TransformCacheSize = 16;
+        if (numIndecies == 0 || vertexSize == 0) {
+            return 0.0f;
+        }
+
+        // only vertices missing the post transform cache are fetched, through a direct mapped cache
+        std::vector<uint32_t> addedAtMiss(numVerts, 0);
+        std::vector<bool> used(numVerts, false);
+        std::array<uint64_t, CacheLineNum> lineTags;
+        lineTags.fill(UINT64_MAX);
+        uint32_t missCount = 0;
+        uint64_t usedCount = 0;
+        uint64_t bytesFetched = 0;
+        for (uint32_t i = 0; i < numIndecies; i++) {
+            const uint32_t vtx = index->Get(i);
+            if (!used[vtx]) {
+                used[vtx] = true;
+                usedCount++;
+            }
+            if (addedAtMiss[vtx] != 0 && missCount + 1 - addedAtMiss[vtx] <= TransformCacheSize) {
+                continue;
+            }
+            missCount++;
+            addedAtMiss[vtx] = missCount;
+
+            const uint64_t startLine = (static_cast<uint64_t>(vtx) * vertexSize) / CacheLineSize;
+            const uint64_t endLine = (static_cast<uint64_t>(vtx + 1) * vertexSize - 1) / CacheLineSize;
+            for (uint64_t line = startLine; line <= endLine; line++) {
+                uint64_t& tag = lineTags[line % CacheLineNum];
+                if (tag != line) {
+                    tag = line;
+                    bytesFetched += CacheLineSize;
+                }
+            }
+        }
+
+        return static_cast<float>(static_cast<double>(bytesFetched) / static_cast<double>(usedCount * vertexSize));
+    }
+
+    QuantizationStats AnalyzeQuantization(
+        uint32_t numVerts,
+        GraphicsBuffer::BufferStructuredView<float3>* position,
+        GraphicsBuffer::BufferStructuredView<float3>* normal,
+        GraphicsBuffer::BufferStructuredView<float3>* tangent,
+        GraphicsBuffer::BufferStructuredView<float2>* uv) {
+        QuantizationStats stats;
+
+        if (position) {
+            // 3 x unorm16 padded to 8 bytes
+            stats.floatVertexSize += sizeof(float3);
+            stats.quantizedVertexSize += 4 * sizeof(uint16_t);
+
+            float3 boundMin = float3(FLT_MAX, FLT_MAX, FLT_MAX);
+            float3 boundMax = float3(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+            for (uint32_t i = 0; i < numVerts; i++) {
+                const float3 pos = position->Get(i);
+                boundMin = float3(std::min(boundMin.x, pos.x), std::min(boundMin.y, pos.y), std::min(boundMin.z, pos.z));
+                boundMax = float3(std::max(boundMax.x, pos.x), std::max(boundMax.y, pos.y), std::max(boundMax.z, pos.z));
+            }
+            const float3 extent = float3(
+                std::max(boundMax.x - boundMin.x, FLT_EPSILON),
+                std::max(boundMax.y - boundMin.y, FLT_EPSILON),
+                std::max(boundMax.z - boundMin.z, FLT_EPSILON));
+            for (uint32_t i = 0; i < numVerts; i++) {
+                const float3 pos = position->Get(i);
+                const float src[3] = { pos.x, pos.y, pos.z };
+                const float minValue[3] = { boundMin.x, boundMin.y, boundMin.z };
+                const float extentValue[3] = { extent.x, extent.y, extent.z };
+                float errorSqr = 0.0f;
+                for (uint32_t k = 0; k < 3; k++) {
+                    const float quantized = std::round((src[k] - minValue[k]) / extentValue[k] * 65535.0f);
+                    const float decoded = minValue[k] + (quantized / 65535.0f) * extentValue[k];
+                    errorSqr += (decoded - src[k]) * (decoded - src[k]);
+                }
+                stats.maxPositionError = std::max(stats.maxPositionError, std::sqrt(errorSqr));
+            }
+        }
+
+        if (normal) {
+            stats.floatVertexSize += sizeof(float3);
+            stats.quantizedVertexSize += sizeof(uint32_t);
+            for (uint32_t i = 0; i < numVerts; i++) {
+                const float3 value = normal->Get(i);
+                stats.maxNormalError = std::max(stats.maxNormalError, details::AngleBetweenDegrees(value, DecodeOctahedral(EncodeOctahedral(value))));
+            }
+        }
+
+        if (tangent) {
+            stats.floatVertexSize += sizeof(float3);
+            stats.quantizedVertexSize += sizeof(uint32_t);
+            for (uint32_t i = 0; i < numVerts; i++) {
+                const float3 value = tangent->Get(i);
+                stats.maxTangentError = std::max(stats.maxTangentError, details::AngleBetweenDegrees(value, DecodeOctahedral(EncodeOctahedral(value))));
+            }
+        }
+
+        if (uv) {
+            stats.floatVertexSize += sizeof(float2);
+            stats.quantizedVertexSize += 2 * sizeof(uint16_t);
+            for (uint32_t i = 0; i < numVerts; i++) {
+                const float2 value = uv->Get(i);
+                stats.maxUVError = std::max(stats.maxUVError, std::abs(DecodeHalf(EncodeHalf(value.x)) - value.x));
+                stats.maxUVError = std::max(stats.maxUVError, std::abs(DecodeHalf(EncodeHalf(value.y)) - value.y));
+            }
+        }
+
+        return stats;
+    }
+
+    uint32_t EncodeOctahedral(const float3& normal) {
+        const float length = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+        if (length < FLT_EPSILON) {
+            return 0;
+        }
+        float x = normal.x / length;
+        float y = normal.y / length;
+        if (normal.z < 0.0f) {
+            // fold the lower half over the diagonals
+            const float foldX = (1.0f - std::abs(y)) * details::SignNotZero(x);
+            const float foldY = (1.0f - std::abs(x)) * details::SignNotZero(y);
+            x = foldX;
+            y = foldY;
+        }
+        const int16_t qx = static_cast<int16_t>(std::round(std::clamp(x, -1.0f, 1.0f) * 32767.0f));
+        const int16_t qy = static_cast<int16_t>(std::round(std::clamp(y, -1.0f, 1.0f) * 32767.0f));
+        return static_cast<uint32_t>(static_cast<uint16_t>(qx)) | (static_cast<uint32_t>(static_cast<uint16_t>(qy)) << 16);
+    }
+
+    float3 DecodeOctahedral(uint32_t encoded) {
+        float x = static_cast<float>(static_cast<int16_t>(encoded & 0xffff)) / 32767.0f;
+        float y = static_cast<float>(static_cast<int16_t>(encoded >> 16)) / 32767.0f;
+        const float z = 1.0f - std::abs(x) - std::abs(y);
+        if (z < 0.0f) {
+            const float unfoldX = (1.0f - std::abs(y)) * details::SignNotZero(x);
+            const float unfoldY = (1.0f - std::abs(x)) * details::SignNotZero(y);
+            x = unfoldX;
+            y = unfoldY;
+        }
+        const float length = std::sqrt(x * x + y * y + z * z);
+        return float3(x / length, y / length, z / length);
+    }
+
+    uint16_t EncodeHalf(float value) {
+        uint32_t bits = 0;
+        std::memcpy(&bits, &value, sizeof(float));
+        const uint32_t sign = (bits >> 16) & 0x8000;
+        const int32_t expMantissa = static_cast<int32_t>(bits & 0x7fffffff);
+
+        // rebias the exponent and round the mantissa to nearest
+        int32_t half = (expMantissa - (112 << 23) + (1 << 12)) >> 13;
+        half = (expMantissa < (113 << 23)) ? 0 : half; // too small, flush to zero
+        half = (expMantissa >= (143 << 23)) ? 0x7c00 : half; // too large, infinity
+        half = (expMantissa > (255 << 23)) ? 0x7e00 : half; // NaN
+        return static_cast<uint16_t>(sign | static_cast<uint32_t>(half));
+    }
+
+    float DecodeHalf(uint16_t value) {
+        const uint32_t sign = static_cast<uint32_t>(value & 0x8000) << 16;
+        const int32_t expMantissa = value & 0x7fff;
+
+        int32_t bits = (expMantissa + (112 << 10)) << 13;
+        bits = (expMantissa < (1 << 10)) ? 0 : bits; // zero, denormals are flushed
+        bits += (expMantissa >= (31 << 10)) ? (112 << 23) : 0; // infinity and NaN
+        const uint32_t result = sign | static_cast<uint32_t>(bits);
+        float out = 0.0f;
+        std::memcpy(&out, &result, sizeof(float));
+        return out;
+    }
 } // namespace hpl::MeshUtility
@@ -102,6 +102,8 @@ namespace hpl {
 		mpRenderContainerNode = NULL;
 
 		mpRenderableUserData = NULL;
+
+		SetRenderInterpolated(true);
 	}
 
 	//-----------------------------------------------------------------------
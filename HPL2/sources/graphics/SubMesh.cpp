@@ -26,7 +26,9 @@
 #include "graphics/Bone.h"
 #include "graphics/Material.h"
 #include "graphics/Mesh.h"
+#include "graphics/MeshUtility.h"
 #include "graphics/Skeleton.h"
+#include "graphics/TriangleBVH.h"
 #include "graphics/VertexBuffer.h"
 #include "resources/MaterialManager.h"
 
@@ -92,6 +94,8 @@ namespace hpl {
             m_materialManager->Destroy(m_material);
         if (m_vtxBuffer)
             hplDelete(m_vtxBuffer);
+        if (m_triangleBVH)
+            hplDelete(m_triangleBVH);
     }
 
     void cSubMesh::SetMaterial(cMaterial* apMaterial) {
@@ -102,6 +106,10 @@ namespace hpl {
 
     void cSubMesh::SetVertexBuffer(iVertexBuffer* apVtxBuffer) {
         m_vtxBuffer = apVtxBuffer;
+        if (m_triangleBVH) {
+            hplDelete(m_triangleBVH);
+            m_triangleBVH = nullptr;
+        }
     }
 
     cMaterial* cSubMesh::GetMaterial() {
@@ -112,6 +120,19 @@ namespace hpl {
         return m_vtxBuffer;
     }
 
+    cTriangleBVH* cSubMesh::GetTriangleBVH() {
+        if (m_triangleBVH == nullptr && m_vtxBuffer) {
+            float* pPositions = m_vtxBuffer->GetFloatArray(eVertexBufferElement_Position);
+            if (pPositions == nullptr) {
+                return nullptr;
+            }
+            m_triangleBVH = hplNew(cTriangleBVH, ());
+            m_triangleBVH->Build(
+                pPositions, m_vtxBuffer->GetElementNum(eVertexBufferElement_Position), m_vtxBuffer->GetIndices(), m_vtxBuffer->GetIndexNum());
+        }
+        return m_triangleBVH;
+    }
+
     void cSubMesh::ResizeVertexBonePairs(int alSize) {
         m_vtxBonePairs.resize(alSize);
     }
@@ -200,6 +221,10 @@ namespace hpl {
         m_vertexStreams = std::move(vertexStreams);
         m_indexStream = std::move(indexStream);
 
+        if (m_triangleBVH) {
+            hplDelete(m_triangleBVH);
+            m_triangleBVH = nullptr;
+        }
         if(buffer) {
             m_vtxBuffer = buffer;
             WriteToVertexBuffer(m_vertexStreams, m_indexStream, m_vtxBuffer);
@@ -288,6 +313,43 @@ namespace hpl {
 
     //-----------------------------------------------------------------------
 
+    void cSubMesh::OptimizeVertexOrder() {
+        auto posStream = std::find_if(m_vertexStreams.begin(), m_vertexStreams.end(), [&](auto& stream) {
+            return stream.m_semantic == ShaderSemantic::SEMANTIC_POSITION;
+        });
+        if (posStream == m_vertexStreams.end() || m_indexStream.m_numberElements < 3) {
+            return;
+        }
+        const uint32_t numVertices = posStream->m_numberElements;
+        auto index = m_indexStream.GetView();
+        MeshUtility::OptimizeVertexCache(numVertices, m_indexStream.m_numberElements, &index);
+        std::vector<uint32_t> remap = MeshUtility::OptimizeVertexFetch(numVertices, m_indexStream.m_numberElements, &index);
+
+        std::vector<uint8_t> source;
+        for (auto& stream : m_vertexStreams) {
+            auto rawView = stream.m_buffer.CreateViewRaw();
+            auto bytes = rawView.rawByteSpan();
+            if (stream.m_numberElements != numVertices || bytes.size() < static_cast<size_t>(numVertices) * stream.m_stride) {
+                continue;
+            }
+            source.assign(bytes.begin(), bytes.begin() + static_cast<size_t>(numVertices) * stream.m_stride);
+            for (uint32_t i = 0; i < numVertices; i++) {
+                std::memcpy(bytes.data() + static_cast<size_t>(remap[i]) * stream.m_stride, source.data() + static_cast<size_t>(i) * stream.m_stride, stream.m_stride);
+            }
+        }
+        for (auto& pair : m_vtxBonePairs) {
+            pair.vtxIdx = remap[pair.vtxIdx];
+        }
+
+        if (m_vtxBuffer) {
+            WriteToVertexBuffer(m_vertexStreams, m_indexStream, m_vtxBuffer);
+        }
+        if (m_triangleBVH) {
+            hplDelete(m_triangleBVH);
+            m_triangleBVH = nullptr;
+        }
+    }
+
     void cSubMesh::Compile() {
         // build plan normal?
         if (m_vtxBuffer && m_vtxBuffer->GetIndexNum() <= 400 * 3) {
@@ -0,0 +1,205 @@
+/*
+ * Copyright © 2009-2020 Frictional Games
+ *
+ * This file is part of Amnesia: The Dark Descent.
+ *
+ * Amnesia: The Dark Descent is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * Amnesia: The Dark Descent is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Amnesia: The Dark Descent.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "graphics/TriangleBVH.h"
+
+#include "math/Math.h"
+
+#include <algorithm>
+
+namespace hpl {
+
+	//////////////////////////////////////////////////////////////////////////
+	// DEFINES
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	static const int kMaxTrianglesPerLeaf = 4;
+
+	//Median splits keep the depth at about log2(triangles / leaf size), this is plenty.
+	static const int kMaxStackSize = 64;
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// CONSTRUCTORS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	cTriangleBVH::cTriangleBVH()
+	{
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// PUBLIC METHODS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	void cTriangleBVH::Build(const float *apPositions, int alPosStride, const unsigned int *apIndices, int alIndexNum)
+	{
+		mvNodes.clear();
+		mvTriangles.clear();
+
+		int lTriangleNum = alIndexNum / 3;
+		if(lTriangleNum <= 0 || apPositions==NULL || apIndices==NULL) return;
+
+		////////////////////////////
+		// Bounds and center of each triangle
+		tVector3fVec vTriMin(lTriangleNum);
+		tVector3fVec vTriMax(lTriangleNum);
+		tVector3fVec vCentroids(lTriangleNum);
+		mvTriangles.resize(lTriangleNum);
+
+		for(int i=0; i<lTriangleNum; ++i)
+		{
+			const float *pPos = &apPositions[apIndices[i*3]*alPosStride];
+			cVector3f vMin(pPos[0], pPos[1], pPos[2]);
+			cVector3f vMax = vMin;
+			for(int j=1; j<3; ++j)
+			{
+				pPos = &apPositions[apIndices[i*3+j]*alPosStride];
+				for(int k=0; k<3; ++k)
+				{
+					vMin.v[k] = cMath::Min(vMin.v[k], pPos[k]);
+					vMax.v[k] = cMath::Max(vMax.v[k], pPos[k]);
+				}
+			}
+
+			vTriMin[i] = vMin;
+			vTriMax[i] = vMax;
+			vCentroids[i] = (vMin + vMax) * 0.5f;
+			mvTriangles[i] = i;
+		}
+
+		mvNodes.reserve(2 * (lTriangleNum / kMaxTrianglesPerLeaf + 1));
+		BuildNode(0, lTriangleNum, vTriMin, vTriMax, vCentroids);
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cTriangleBVH::FindTriangles(const cPlanef *apPlanes, int alPlaneNum, tIntVec& avTriangles) const
+	{
+		avTriangles.clear();
+		if(mvNodes.empty()) return;
+
+		int vStack[kMaxStackSize];
+		int lStackSize = 0;
+		vStack[lStackSize++] = 0;
+
+		while(lStackSize > 0)
+		{
+			int lNode = vStack[--lStackSize];
+			const cNode &node = mvNodes[lNode];
+
+			////////////////////////////
+			// Skip if the corner furthest along a plane normal is still behind it
+			bool bOutside = false;
+			for(int i=0; i<alPlaneNum; ++i)
+			{
+				const cPlanef &plane = apPlanes[i];
+				float fDist =	plane.a * (plane.a >= 0 ? node.mvMax.x : node.mvMin.x) +
+								plane.b * (plane.b >= 0 ? node.mvMax.y : node.mvMin.y) +
+								plane.c * (plane.c >= 0 ? node.mvMax.z : node.mvMin.z) + plane.d;
+				if(fDist < 0)
+				{
+					bOutside = true;
+					break;
+				}
+			}
+			if(bOutside) continue;
+
+			if(node.mlCount > 0)
+			{
+				avTriangles.insert(avTriangles.end(), mvTriangles.begin() + node.mlFirst, mvTriangles.begin() + node.mlFirst + node.mlCount);
+			}
+			else
+			{
+				vStack[lStackSize++] = node.mlFirst;
+				vStack[lStackSize++] = lNode+1;
+			}
+		}
+
+		std::sort(avTriangles.begin(), avTriangles.end());
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// PRIVATE METHODS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	void cTriangleBVH::BuildNode(int alFirst, int alCount, const tVector3fVec& avTriMin, const tVector3fVec& avTriMax, const tVector3fVec& avCentroids)
+	{
+		////////////////////////////
+		// Bounds of the triangles and of their centers
+		cVector3f vMin = avTriMin[mvTriangles[alFirst]];
+		cVector3f vMax = avTriMax[mvTriangles[alFirst]];
+		cVector3f vCenterMin = avCentroids[mvTriangles[alFirst]];
+		cVector3f vCenterMax = vCenterMin;
+		for(int i=alFirst+1; i<alFirst+alCount; ++i)
+		{
+			int lTri = mvTriangles[i];
+			for(int k=0; k<3; ++k)
+			{
+				vMin.v[k] = cMath::Min(vMin.v[k], avTriMin[lTri].v[k]);
+				vMax.v[k] = cMath::Max(vMax.v[k], avTriMax[lTri].v[k]);
+				vCenterMin.v[k] = cMath::Min(vCenterMin.v[k], avCentroids[lTri].v[k]);
+				vCenterMax.v[k] = cMath::Max(vCenterMax.v[k], avCentroids[lTri].v[k]);
+			}
+		}
+
+		int lNode = (int)mvNodes.size();
+		mvNodes.push_back(cNode());
+		mvNodes[lNode].mvMin = vMin;
+		mvNodes[lNode].mvMax = vMax;
+
+		if(alCount <= kMaxTrianglesPerLeaf)
+		{
+			mvNodes[lNode].mlFirst = alFirst;
+			mvNodes[lNode].mlCount = alCount;
+			return;
+		}
+
+		////////////////////////////
+		// Split at the median along the axis the centers are spread the most
+		cVector3f vExtent = vCenterMax - vCenterMin;
+		int lAxis = 0;
+		if(vExtent.y > vExtent.v[lAxis]) lAxis = 1;
+		if(vExtent.z > vExtent.v[lAxis]) lAxis = 2;
+
+		int lHalf = alCount/2;
+		std::nth_element(mvTriangles.begin() + alFirst, mvTriangles.begin() + alFirst + lHalf, mvTriangles.begin() + alFirst + alCount,
+						[&](int alA, int alB){ return avCentroids[alA].v[lAxis] < avCentroids[alB].v[lAxis]; });
+
+		mvNodes[lNode].mlCount = 0;
+		BuildNode(alFirst, lHalf, avTriMin, avTriMax, avCentroids);
+		mvNodes[lNode].mlFirst = (int)mvNodes.size();
+		BuildNode(alFirst + lHalf, alCount - lHalf, avTriMin, avTriMax, avCentroids);
+	}
+
+	//-----------------------------------------------------------------------
+
+}
@@ -28,7 +28,9 @@
 #include "math/Math.h"
 #include "math/MathTypes.h"
 #include "system/LowLevelSystem.h"
+#include "system/Platform.h"
 #include "system/String.h"
+#include "system/Timer.h"
 
 #include "graphics/FontData.h"
 #include "graphics/Graphics.h"
@@ -82,6 +84,7 @@
 #include <stdlib.h>
 
 #include <algorithm>
+#include <cstring>
 
 #include "Common_3/Utilities/RingBuffer.h"
 #include <FixPreprocessor.h>
@@ -257,41 +260,24 @@ namespace hpl {
         return (fAZ > fBZ);
     }
 
-    bool cGuiRenderObjectCompare::operator()(const cGuiRenderObject& aObjectA, const cGuiRenderObject& aObjectB) const {
-        // Z
-        float fZA = aObjectA.mvPos.z;
-        float fZB = aObjectB.mvPos.z;
-        if (fZA != fZB) {
-            return fZA < fZB;
+    // Maps a float to an unsigned int with the same ordering.
+    static inline uint32_t FloatToSortableBits(float afX) {
+        if (afX == 0.0f) {
+            afX = 0.0f; // -0 and 0 must end up the same
         }
-
-        // Clip Region
-        cGuiClipRegion* pClipA = aObjectA.mpClipRegion;
-        cGuiClipRegion* pClipB = aObjectB.mpClipRegion;
-        if (pClipA != pClipB) {
-            return pClipA > pClipB;
-        }
-
-        // Material
-        eGuiMaterial pMaterialA =
-            aObjectA.mpCustomMaterial != eGuiMaterial::eGuiMaterial_LastEnum ? aObjectA.mpCustomMaterial : aObjectA.mpGfx->m_materialType;
-        eGuiMaterial pMaterialB =
-            aObjectB.mpCustomMaterial != eGuiMaterial::eGuiMaterial_LastEnum ? aObjectB.mpCustomMaterial : aObjectB.mpGfx->m_materialType;
-        if (pMaterialA != pMaterialB) {
-            return pMaterialA > pMaterialB;
-        }
-
-        // Texture
-        Image* pTextureA = aObjectA.mpGfx->mvTextures[0];
-        Image* pTextureB = aObjectB.mpGfx->mvTextures[0];
-        if (pTextureA != pTextureB) {
-            return pTextureA > pTextureB;
-        }
-
-        // Equal
-        return false;
+        uint32_t lBits;
+        memcpy(&lBits, &afX, sizeof(uint32_t));
+        return (lBits & 0x80000000u) ? ~lBits : (lBits | 0x80000000u);
     }
 
+    // Sort key layout, highest bits first: z (32), clip region (14), material (4), texture (14).
+    // Clip and texture only need to group equal objects, ids that collide just give more batches.
+    // Material and texture are stored inverted, so they sort descending like the old render object set.
+    static constexpr uint32_t kRenderKeyClipBits = 14;
+    static constexpr uint32_t kRenderKeyTextureBits = 14;
+    static constexpr uint32_t kRenderKeyMaterialBits = 4;
+    static_assert(eGuiMaterial_LastEnum < (1 << kRenderKeyMaterialBits), "Material does not fit in the gui sort key");
+
     cGuiClipRegion::~cGuiClipRegion() {
         Clear();
     }
@@ -468,6 +454,12 @@ namespace hpl {
         mpFocusDrawCallback = NULL;
 
         mbSortWidgets = false;
+
+        mlDrawFrameCount = 0;
+        mlClipRegionDrawIdCount = 0;
+        mpBuildTimer = cPlatform::CreateTimer();
+        mpRenderTimer = cPlatform::CreateTimer();
+        mlBuildTimerDepth = 0;
     }
 
     //-----------------------------------------------------------------------
@@ -482,6 +474,9 @@ namespace hpl {
         mbDestroyingSet = false;
 
         ClearGlobalShortcuts();
+
+        hplDelete(mpBuildTimer);
+        hplDelete(mpRenderTimer);
     }
 
     void cGuiSet::Update(float afTimeStep) {
@@ -510,12 +505,16 @@ namespace hpl {
         if (mbActive == false)
             return;
 
+        StartBuildTimer();
+
         ///////////////////////////////
         // Draw all widgets
         SetCurrentClipRegion(&mBaseClipRegion);
         mpWidgetRoot->Draw(afTimeStep, &mBaseClipRegion);
 
         SetCurrentClipRegion(&mBaseClipRegion);
+
+        StopBuildTimer();
     }
 
     //-----------------------------------------------------------------------
@@ -626,14 +625,17 @@ namespace hpl {
 
     void cGuiSet::Draw(const ForgeRenderer::Frame& frame, cFrustum* apFrustum) {
         const bool isSwapChainRead = frame.m_currentFrame > 0;
-        if (m_setRenderObjects.empty() || !isSwapChainRead) {
+        if (mvRenderObjects.empty() || !isSwapChainRead) {
             return;
         }
 
+        mpRenderTimer->Start();
+        SortRenderObjects();
+
         iLowLevelGraphics* pLowLevelGraphics = mpGraphics->GetLowLevel();
 
-        size_t vertexBufferSize = m_setRenderObjects.size() * sizeof(gui::PositionTexColor) * 4;
-        size_t indexBufferSize = m_setRenderObjects.size() * sizeof(uint32_t) * 6;
+        size_t vertexBufferSize = mvRenderObjects.size() * sizeof(gui::PositionTexColor) * 4;
+        size_t indexBufferSize = mvRenderObjects.size() * sizeof(uint32_t) * 6;
         GraphicsAllocator* graphicsAllocator = Interface<GraphicsAllocator>::Get();
 
         GPURingBufferOffset vb = graphicsAllocator->allocTransientVertexBuffer(vertexBufferSize);
@@ -677,16 +679,17 @@ namespace hpl {
         cmdSetViewport(frame.m_cmd, 0.0f, 0.0f, (float)vSize.x, (float)vSize.y, 0.0f, 1.0f);
         cmdSetScissor(frame.m_cmd, 0, 0, vSize.x, vSize.y);
 
-        auto it = m_setRenderObjects.begin();
+        auto it = mvSortedRenderObjects.begin();
+        const cGuiRenderObject* pObject = &mvRenderObjects[*it];
 
         eGuiMaterial pLastMaterial = eGuiMaterial::eGuiMaterial_LastEnum;
         Image* pLastTexture = NULL;
         cGuiClipRegion* pLastClipRegion = NULL;
 
-        cGuiGfxElement* pGfx = it->mpGfx;
-        eGuiMaterial materialType = it->mpCustomMaterial != eGuiMaterial_LastEnum ? it->mpCustomMaterial : pGfx->m_materialType;
+        cGuiGfxElement* pGfx = pObject->mpGfx;
+        eGuiMaterial materialType = pObject->mpCustomMaterial != eGuiMaterial_LastEnum ? pObject->mpCustomMaterial : pGfx->m_materialType;
         Image* pTexture = pGfx->mvTextures[0];
-        cGuiClipRegion* pClipRegion = it->mpClipRegion;
+        cGuiClipRegion* pClipRegion = pObject->mpClipRegion;
 
         BufferUpdateDesc vertexUpdateDesc = { vb.pBuffer, vb.mOffset, vertexBufferSize };
         BufferUpdateDesc indexUpdateDesc = { ib.pBuffer, ib.mOffset, indexBufferSize };
@@ -695,7 +698,7 @@ namespace hpl {
 
         size_t vertexBufferOffset = 0;
         size_t indexBufferOffset = 0;
-        while (it != m_setRenderObjects.end()) {
+        while (it != mvSortedRenderObjects.end()) {
             size_t vertexBufferIndex = 0;
             size_t indexBufferIndex = 0;
 
@@ -757,7 +760,7 @@ namespace hpl {
             gui::descriptorIndex = (gui::descriptorIndex + 1) % gui::MAX_GUI_DRAW_CALLS;
 
             do {
-                const cGuiRenderObject& object = *it;
+                const cGuiRenderObject& object = *pObject;
                 cGuiGfxElement* pGfx = object.mpGfx;
 
                 if (object.mbRotated) {
@@ -818,13 +821,14 @@ namespace hpl {
                 /////////////////////////////
                 // Get next object
                 ++it;
-                if (it == m_setRenderObjects.end())
+                if (it == mvSortedRenderObjects.end())
                     break;
 
-                pGfx = it->mpGfx;
-                materialType = it->mpCustomMaterial != eGuiMaterial_LastEnum ? it->mpCustomMaterial : pGfx->m_materialType;
-                pTexture = it->mpGfx->mvTextures[0];
-                pClipRegion = it->mpClipRegion;
+                pObject = &mvRenderObjects[*it];
+                pGfx = pObject->mpGfx;
+                materialType = pObject->mpCustomMaterial != eGuiMaterial_LastEnum ? pObject->mpCustomMaterial : pGfx->m_materialType;
+                pTexture = pGfx->mvTextures[0];
+                pClipRegion = pObject->mpClipRegion;
             } while (pTexture == pLastTexture && materialType == pLastMaterial && pClipRegion == pLastClipRegion);
 
             uint64_t vbOffset = vb.mOffset + vertexBufferOffset * sizeof(gui::PositionTexColor);
@@ -836,16 +840,44 @@ namespace hpl {
 
             vertexBufferOffset += vertexBufferIndex;
             indexBufferOffset += indexBufferIndex;
+            mDrawStats.mlDrawCalls++;
         }
 
         endUpdateResource(&vertexUpdateDesc);
         endUpdateResource(&indexUpdateDesc);
 
         mBaseClipRegion.Clear();
+
+        mpRenderTimer->Stop();
+        mDrawStats.mfRenderTime += mpRenderTimer->GetTimeInMilliSec();
     }
 
     void cGuiSet::ClearRenderObjects() {
-        m_setRenderObjects.clear();
+        if (mvRenderObjects.empty() == false) {
+            mDrawStats.mlFrames++;
+            mDrawStats.mlRenderObjects += (int)mvRenderObjects.size();
+        }
+
+        mvRenderObjects.clear();
+        mvRenderObjectKeys.clear();
+        mlDrawFrameCount++;
+        mlClipRegionDrawIdCount = 0;
+    }
+
+    //-----------------------------------------------------------------------
+
+    void cGuiSet::AddRenderObjects(const tGuiRenderObjectVec& avObjects, cGuiClipRegion* apClipRegion) {
+        if (apClipRegion->mRect.w == 0 || apClipRegion->mRect.h == 0)
+            return;
+
+        for (size_t i = 0; i < avObjects.size(); ++i) {
+            cGuiRenderObject object = avObjects[i];
+            object.mpClipRegion = apClipRegion;
+            object.mpGfx->Flush();
+
+            AddRenderObject(object);
+        }
+        mDrawStats.mlCachedRenderObjects += (int)avObjects.size();
     }
 
     //-----------------------------------------------------------------------
@@ -921,7 +953,7 @@ namespace hpl {
             object.mbRotated = false;
         }
 
-        m_setRenderObjects.insert(object);
+        AddRenderObject(object);
     }
 
     //-----------------------------------------------------------------------
@@ -973,6 +1005,65 @@ namespace hpl {
 
     //-----------------------------------------------------------------------
 
+    void cGuiSet::DrawTextLayoutRow(
+        const cTextLayout* apLayout,
+        size_t alRow,
+        const cVector3f& avPos,
+        const cColor& aColor,
+        eFontAlign aAlign,
+        eGuiMaterial aMaterial,
+        int alMaxChars) {
+        const cTextLayoutRow& row = apLayout->GetRow(alRow);
+        iFontData* pFont = apLayout->GetFont();
+        const cVector2f& vFontSize = apLayout->GetFontSize();
+
+        //////////////////////////////////////////////////////
+        // Find the glyphs to draw and the length they take up
+        size_t lGlyphNum = row.mlGlyphNum;
+        float fLength = row.mfLength;
+        if (alMaxChars >= 0 && (size_t)alMaxChars < row.mlLength) {
+            size_t lEndChar = row.mlStart + alMaxChars;
+            for (size_t i = 0; i < row.mlGlyphNum; ++i) {
+                const cTextLayoutGlyph& glyph = apLayout->GetGlyph(row.mlFirstGlyph + i);
+                if (glyph.mlChar >= lEndChar) {
+                    lGlyphNum = i;
+                    fLength = glyph.mfX;
+                    break;
+                }
+            }
+        }
+
+        StartBuildTimer();
+
+        cVector3f vPos = avPos;
+        if (aAlign == eFontAlign_Center) {
+            vPos.x -= fLength / 2;
+        } else if (aAlign == eFontAlign_Right) {
+            vPos.x -= fLength;
+        }
+
+        for (size_t i = 0; i < lGlyphNum; ++i) {
+            const cTextLayoutGlyph& glyph = apLayout->GetGlyph(row.mlFirstGlyph + i);
+            cGlyph* pGlyph = pFont->GetGlyph(glyph.mlGlyph);
+
+            cVector3f vGlyphPos(vPos.x + glyph.mfX + pGlyph->mvOffset.x * vFontSize.x, vPos.y + pGlyph->mvOffset.y * vFontSize.y, vPos.z);
+            DrawGfx(pGlyph->mpGuiGfx, vGlyphPos, pGlyph->mvSize * vFontSize, aColor, aMaterial);
+        }
+
+        StopBuildTimer();
+    }
+
+    void cGuiSet::DrawTextLayout(
+        const cTextLayout* apLayout, const cVector3f& avPos, float afRowHeight, const cColor& aColor, eFontAlign aAlign, eGuiMaterial aMaterial) {
+        cVector3f vPos = avPos;
+        for (size_t i = 0; i < apLayout->GetRowNum(); ++i) {
+            DrawTextLayoutRow(apLayout, i, vPos, aColor, aAlign, aMaterial);
+            vPos.y += afRowHeight;
+        }
+    }
+
+    //-----------------------------------------------------------------------
+
     cWidgetWindow* cGuiSet::CreateWidgetWindow(
         tWidgetWindowButtonFlag alFlags,
         const cVector3f& avLocalPos,
@@ -1654,6 +1745,8 @@ namespace hpl {
         const cColor& aColor,
         eGuiMaterial aMaterial,
         eFontAlign aAlign) {
+        StartBuildTimer();
+
         int lCount = 0;
         cVector3f vPos = avPosition;
 
@@ -1690,12 +1783,105 @@ namespace hpl {
             }
             lCount++;
         }
+
+        StopBuildTimer();
     }
 
     //--------------------------------------------------------------
 
 #define kLogRender (false)
 
+    void cGuiSet::AddRenderObject(const cGuiRenderObject& aObject) {
+        ///////////////////////////
+        // Clip region id, given out in the order regions are first used this frame
+        cGuiClipRegion* pClipRegion = aObject.mpClipRegion;
+        if (pClipRegion->mlDrawFrame != mlDrawFrameCount) {
+            pClipRegion->mlDrawFrame = mlDrawFrameCount;
+            pClipRegion->mlDrawId = std::min<int>(mlClipRegionDrawIdCount++, (1 << kRenderKeyClipBits) - 1);
+        }
+
+        eGuiMaterial material = aObject.mpCustomMaterial != eGuiMaterial_LastEnum ? aObject.mpCustomMaterial : aObject.mpGfx->m_materialType;
+
+        mvRenderObjects.push_back(aObject);
+        mvRenderObjectKeys.push_back(GetRenderObjectKey(aObject.mvPos.z, pClipRegion->mlDrawId, material, aObject.mpGfx->mvTextures[0]));
+    }
+
+    //-----------------------------------------------------------------------
+
+    uint64_t cGuiSet::GetRenderObjectKey(float afZ, int alClipId, eGuiMaterial aMaterial, const Image* apTexture) {
+        uint64_t lTexture = ~(uint64_t)(reinterpret_cast<uintptr_t>(apTexture) >> 4);
+
+        uint64_t lKey = (uint64_t)FloatToSortableBits(afZ) << 32;
+        lKey |= (uint64_t)alClipId << (kRenderKeyMaterialBits + kRenderKeyTextureBits);
+        lKey |= (uint64_t)(eGuiMaterial_LastEnum - 1 - aMaterial) << kRenderKeyTextureBits;
+        lKey |= lTexture & ((1 << kRenderKeyTextureBits) - 1);
+        return lKey;
+    }
+
+    //-----------------------------------------------------------------------
+
+    void cGuiSet::SortRenderObjects() {
+        SortRenderObjectKeys(mvRenderObjectKeys, mvSortedRenderObjects, mvSortTemp);
+    }
+
+    //-----------------------------------------------------------------------
+
+    void cGuiSet::SortRenderObjectKeys(const std::vector<uint64_t>& avKeys, std::vector<uint32_t>& avSorted,
+                                       std::vector<uint32_t>& avTemp) {
+        size_t lCount = avKeys.size();
+        avSorted.resize(lCount);
+        avTemp.resize(lCount);
+        for (size_t i = 0; i < lCount; ++i) {
+            avSorted[i] = (uint32_t)i;
+        }
+
+        ///////////////////////////
+        // LSD radix sort on the key one byte at a time, stable so objects with equal keys keep the draw order.
+        // Bytes that are the same in all keys are skipped, which is most of them for a flat 2D gui.
+        uint64_t lChangedBits = 0;
+        for (size_t i = 1; i < lCount; ++i) {
+            lChangedBits |= avKeys[i] ^ avKeys[0];
+        }
+
+        for (int lShift = 0; lShift < 64; lShift += 8) {
+            if (((lChangedBits >> lShift) & 0xff) == 0)
+                continue;
+
+            uint32_t vOffsets[256] = { 0 };
+            for (size_t i = 0; i < lCount; ++i) {
+                vOffsets[(avKeys[i] >> lShift) & 0xff]++;
+            }
+            uint32_t lSum = 0;
+            for (int i = 0; i < 256; ++i) {
+                uint32_t lNum = vOffsets[i];
+                vOffsets[i] = lSum;
+                lSum += lNum;
+            }
+            for (size_t i = 0; i < lCount; ++i) {
+                uint32_t lIdx = avSorted[i];
+                avTemp[vOffsets[(avKeys[lIdx] >> lShift) & 0xff]++] = lIdx;
+            }
+            avSorted.swap(avTemp);
+        }
+    }
+
+    //-----------------------------------------------------------------------
+
+    void cGuiSet::StartBuildTimer() {
+        // DrawFont is called from inside DrawAll as well, only time the outermost call.
+        if (mlBuildTimerDepth++ == 0)
+            mpBuildTimer->Start();
+    }
+
+    void cGuiSet::StopBuildTimer() {
+        if (--mlBuildTimerDepth == 0) {
+            mpBuildTimer->Stop();
+            mDrawStats.mfBuildTime += mpBuildTimer->GetTimeInMilliSec();
+        }
+    }
+
+    //-----------------------------------------------------------------------
+
     void cGuiSet::AddWidget(iWidget* apWidget, iWidget* apParent) {
         mlstWidgets.push_front(apWidget);
 
@@ -2367,9 +2553,7 @@ namespace hpl {
                     float fMaxTextLength = GetVirtualSize().x * 0.4f;
                     iFontData* pFont = mpLabelToolTip->GetDefaultFontType();
 
-                    tWStringVec vRows;
-                    pFont->GetWordWrapRows(fMaxTextLength, mvFontSize.y + 2, mvFontSize, sTipText, &vRows);
-                    int lRows = (int)vRows.size();
+                    int lRows = (int)pFont->GetWordWrapLayout(fMaxTextLength, mvFontSize, sTipText)->GetRowNum();
 
                     cVector3f vPos = mvMousePos + mpGfxCurrentPointer->GetImageSize();
                     vPos.z = mfMouseZ - 2;
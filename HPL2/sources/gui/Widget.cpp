@@ -90,6 +90,9 @@ namespace hpl {
 
 		mbGlobalKeyPressListener = false;
 		mbGlobalUIInputListener = false;
+
+		mbDrawCacheActive = false;
+		mbDrawCacheDirty = true;
 	}
 
 	//-----------------------------------------------------------------------
@@ -147,7 +150,8 @@ namespace hpl {
 	{
 		if(mbVisible==false) return;
 
-		OnDraw(afTimeStep, apClipRegion);
+		if(mbDrawCacheActive)	DrawWithCache(afTimeStep, apClipRegion);
+		else					OnDraw(afTimeStep, apClipRegion);
 
 		cGuiClipRegion *pChildRegion = apClipRegion;
 		if(mbClipsGraphics)
@@ -372,6 +376,7 @@ namespace hpl {
 		mbTextChanged = true;
 
 		msText = asText;
+		mbDrawCacheDirty = true;
 
 		OnChangeText();
 		ProcessMessage(eGuiMessage_TextChange, cGuiMessageData());
@@ -473,6 +478,7 @@ namespace hpl {
 	void iWidget::SetSize(const cVector2f &avSize)
 	{
 		mvSize = avSize;
+		mbDrawCacheDirty = true;
 
 		OnChangeSize();
 
@@ -844,6 +850,53 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 
+	void iWidget::DrawWithCache(float afTimeStep, cGuiClipRegion *apClipRegion)
+	{
+		const cVector3f& vPos = GetGlobalPosition();
+		bool bEnabled = IsEnabled();
+		const cRect2f& clipRect = apClipRegion->mRect;
+
+		///////////////////////////////
+		// Reuse the objects from the last time if nothing has changed
+		if(	mbDrawCacheDirty==false && vPos == mvDrawCachePosition && mvSize == mvDrawCacheSize &&
+			mColorMul == mDrawCacheColorMul && bEnabled == mbDrawCacheEnabled &&
+			clipRect.x == mDrawCacheClipRect.x && clipRect.y == mDrawCacheClipRect.y &&
+			clipRect.w == mDrawCacheClipRect.w && clipRect.h == mDrawCacheClipRect.h)
+		{
+			mpSet->AddRenderObjects(mvDrawCache, apClipRegion);
+			return;
+		}
+
+		///////////////////////////////
+		// Draw and save what was added
+		size_t lStart = mpSet->GetRenderObjectNum();
+		OnDraw(afTimeStep, apClipRegion);
+
+		mvDrawCache.clear();
+		mbDrawCacheDirty = false;
+		for(size_t i=lStart; i<mpSet->GetRenderObjectNum(); ++i)
+		{
+			const cGuiRenderObject& object = mpSet->GetRenderObject(i);
+
+			//Objects in clip regions made during the draw can not be reused
+			if(object.mpClipRegion != apClipRegion)
+			{
+				mvDrawCache.clear();
+				mbDrawCacheDirty = true;
+				break;
+			}
+			mvDrawCache.push_back(object);
+		}
+
+		mvDrawCachePosition = vPos;
+		mvDrawCacheSize = mvSize;
+		mDrawCacheColorMul = mColorMul;
+		mbDrawCacheEnabled = bEnabled;
+		mDrawCacheClipRect = clipRect;
+	}
+
+	//-----------------------------------------------------------------------
+
 	int iWidget::UIArrowToArrayPos(eUIArrow aDir)
 	{
 		return cMath::Log2ToInt(aDir);
@@ -868,12 +921,22 @@ namespace hpl {
 		{
 			mpDefaultFont = NULL;
 		}
+		mbDrawCacheDirty = true;
 
 		OnLoadGraphics();
 	}
 
 	//-----------------------------------------------------------------------
 
+	void iWidget::SetDrawCacheActive(bool abX)
+	{
+		mbDrawCacheActive = abX;
+		mbDrawCacheDirty = true;
+		mvDrawCache.clear();
+	}
+
+	//-----------------------------------------------------------------------
+
 	void iWidget::SetPositionUpdated()
 	{
         mbPositionIsUpdated = true;
@@ -45,6 +45,7 @@ namespace hpl {
 		mbVScrollBar = abVScrollBar;
 
 		mbDrawFrame = false;
+		SetDrawCacheActive(true);
 
 		mbDrawBackground = false;
 		mfBackgroundZ = -0.5;
@@ -61,6 +61,8 @@ namespace hpl {
 		mbDrawBackGround = false;
 		mBackGroundColor = cColor(1,1);
 
+		SetDrawCacheActive(true);
+
 		LoadGraphics();
 	}
 
@@ -83,6 +85,7 @@ namespace hpl {
 		if(mlMaxCharacters == alLength) return;
 
 		mlMaxCharacters = alLength;
+		SetDrawCacheDirty();
 	}
 
 	//-----------------------------------------------------------------------
@@ -127,35 +130,33 @@ namespace hpl {
 
 		if(mbWordWrap)
 		{
+			if(mpDefaultFontType==NULL) return;
+
 			int lChars =0;
-			bool bEnabled = IsEnabled();
 			float fHeight = mvDefaultFontSize.y+2;
-			tWStringVec vRows;
-			mpDefaultFontType->GetWordWrapRows(mvSize.x,fHeight,
-												mvDefaultFontSize, msText,
-												&vRows);
+			const cTextLayout *pLayout = mpDefaultFontType->GetWordWrapLayout(mvSize.x, mvDefaultFontSize, msText);
 
-			mfWordWrapRowsHeight = (fHeight-1) * (int)vRows.size();
+			mfWordWrapRowsHeight = (fHeight-1) * (int)pLayout->GetRowNum();
 
-			for(size_t i=0; i< vRows.size(); ++i)
+			cColor textColor = IsEnabled() ? mDefaultFontColor : cColor(0.5f, mDefaultFontColor.a);
+			for(size_t i=0; i< pLayout->GetRowNum(); ++i)
 			{
 				bool bBreak = false;
+				int lMaxRowChars = -1;
+				int lRowChars = (int)pLayout->GetRow(i).mlLength;
 				if(mlMaxCharacters>=0)
 				{
-					if(lChars + (int)vRows[i].length() > mlMaxCharacters)
+					if(lChars + lRowChars > mlMaxCharacters)
 					{
-						vRows[i] = cString::SubW(vRows[i],0, mlMaxCharacters - lChars);
+						lMaxRowChars = mlMaxCharacters - lChars;
+						lRowChars = lMaxRowChars;
 						bBreak = true;
 					}
-					lChars += (int)vRows[i].length();
+					lChars += lRowChars;
 				}
 
-				if(bEnabled)
-					DrawDefaultText(vRows[i], GetGlobalPosition()+vOffset-cVector3f(0,mfWordWrapOffset,0),mTextAlign);
-				else {
-					DrawDefaultText(vRows[i], GetGlobalPosition()+vOffset-cVector3f(0,mfWordWrapOffset,0),mTextAlign, cColor(0.5f, mDefaultFontColor.a));
-					//DrawSkinText(vRows[i],eGuiSkinFont_Disabled,GetGlobalPosition()+vOffset,mTextAlign);
-				}
+				mpSet->DrawTextLayoutRow(pLayout, i, GetGlobalPosition()+vOffset-cVector3f(0,mfWordWrapOffset,0),
+										textColor*mColorMul, mTextAlign, eGuiMaterial_FontNormal, lMaxRowChars);
 				vOffset.y += fHeight;
 
 				if(bBreak) break;
@@ -205,6 +206,7 @@ namespace hpl {
 			return;
 
 		float fAdvance = afTimeStep * mfScrollSpeedMul;
+		SetDrawCacheDirty();
 
 		// Scroll down
 		if(mbScrollingDown)
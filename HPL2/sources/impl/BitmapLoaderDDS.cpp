@@ -0,0 +1,263 @@
+#include "impl/BitmapLoaderDDS.h"
+
+#include "impl/BitmapLoaderDevilDDS.h"
+
+#include "graphics/Bitmap.h"
+#include "system/LowLevelSystem.h"
+#include "system/Platform.h"
+#include "system/String.h"
+
+#include <algorithm>
+#include <cstdint>
+
+#undef LoadBitmap
+
+namespace hpl {
+
+	//////////////////////////////////////////////////////////////////////////
+	// DEFINES
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	#define DDS_FOURCC(a,b,c,d)	((uint32_t)(a) | ((uint32_t)(b) << 8) | ((uint32_t)(c) << 16) | ((uint32_t)(d) << 24))
+
+	static const uint32_t kDDSMagic = DDS_FOURCC('D','D','S',' ');
+	static const int kDDSHeaderSize = 124;
+
+	//Index of the fields in the header, counted in 32 bit words after the magic number
+	enum eDDSHeaderField
+	{
+		eDDSHeaderField_Size = 0,
+		eDDSHeaderField_Flags = 1,
+		eDDSHeaderField_Height = 2,
+		eDDSHeaderField_Width = 3,
+		eDDSHeaderField_Depth = 5,
+		eDDSHeaderField_MipMapCount = 6,
+		eDDSHeaderField_PixelFlags = 19,
+		eDDSHeaderField_FourCC = 20,
+		eDDSHeaderField_BitCount = 21,
+		eDDSHeaderField_RMask = 22,
+		eDDSHeaderField_GMask = 23,
+		eDDSHeaderField_BMask = 24,
+		eDDSHeaderField_AMask = 25,
+		eDDSHeaderField_Caps2 = 27,
+		eDDSHeaderField_LastEnum = 31,
+	};
+
+	static const uint32_t kDDSD_MipMapCount = 0x20000;
+	static const uint32_t kDDSD_Depth = 0x800000;
+
+	static const uint32_t kDDPF_AlphaPixels = 0x1;
+	static const uint32_t kDDPF_Alpha = 0x2;
+	static const uint32_t kDDPF_FourCC = 0x4;
+	static const uint32_t kDDPF_RGB = 0x40;
+	static const uint32_t kDDPF_Luminance = 0x20000;
+
+	static const uint32_t kDDSCAPS2_CubeMap = 0x200;
+	static const uint32_t kDDSCAPS2_CubeMapAllFaces = 0xFC00;
+	static const uint32_t kDDSCAPS2_Volume = 0x200000;
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// CONSTRUCTORS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	cBitmapLoaderDDS::cBitmapLoaderDDS()
+	{
+		AddSupportedExtension("dds");
+
+		mpFallbackLoader = hplNew( cBitmapLoaderDevilDDS, () );
+	}
+
+	cBitmapLoaderDDS::~cBitmapLoaderDDS()
+	{
+		hplDelete(mpFallbackLoader);
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// PUBLIC METHODS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	cBitmap* cBitmapLoaderDDS::LoadBitmap(const tWString& asFile, tBitmapLoadFlag aFlags)
+	{
+		FILE *pFile = cPlatform::OpenFile(asFile, _W("rb"));
+		if(pFile == NULL)
+		{
+			Error("Could not open file %s for reading!\n",cString::To8Char(asFile).c_str());
+			return NULL;
+		}
+
+		////////////////////////////////////////
+		//Read the header, anything not handled here is left to DevIL
+		cVector3l vSize;
+		int lNumOfImages, lNumOfMipMaps;
+		cDDSFormat format;
+		if(ReadHeader(pFile, vSize, lNumOfImages, lNumOfMipMaps, format)==false ||
+			(format.mlBlockSize > 0 && (aFlags & eBitmapLoadFlag_ForceNoCompression)))
+		{
+			fclose(pFile);
+			return mpFallbackLoader->LoadBitmap(asFile, aFlags);
+		}
+
+		cBitmap *pBitmap = hplNew(cBitmap, () );
+
+		if(lNumOfImages > 1 || lNumOfMipMaps > 1)
+		{
+			pBitmap->SetUpData(lNumOfImages, lNumOfMipMaps);
+		}
+		pBitmap->SetSize(vSize);
+		pBitmap->SetBytesPerPixel(format.mlBytesPerPixel);
+		pBitmap->SetIsCompressed(format.mlBlockSize > 0);
+		pBitmap->SetPixelFormat(format.mPixelFormat);
+
+		////////////////////////////////////////
+		//Read the data, it is stored with all mipmaps of a face after each other.
+		for(int image=0; image< lNumOfImages; ++image)
+		for(int mip=0; mip< lNumOfMipMaps; ++mip)
+		{
+			cBitmapData *pImage = pBitmap->GetData(image,mip);
+
+			int lSize = GetMipMapSize(vSize, mip, format);
+			pImage->mlSize = lSize;
+			pImage->mpData = hplNewArray(unsigned char,lSize);
+
+			if(fread(pImage->mpData, 1, lSize, pFile) != (size_t)lSize)
+			{
+				Error("DDS file '%s' is truncated!\n",cString::To8Char(asFile).c_str());
+				hplDelete(pBitmap);
+				fclose(pFile);
+				return NULL;
+			}
+		}
+
+		fclose(pFile);
+
+		return pBitmap;
+	}
+
+	//-----------------------------------------------------------------------
+
+	bool cBitmapLoaderDDS::SaveBitmap(cBitmap* apBitmap,const tWString& asFile, tBitmapSaveFlag aFlags)
+	{
+		return mpFallbackLoader->SaveBitmap(apBitmap, asFile, aFlags);
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// PRIVATE METHODS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	bool cBitmapLoaderDDS::ReadHeader(FILE *apFile, cVector3l& avSize, int& alNumOfImages, int& alNumOfMipMaps, cDDSFormat& aFormat)
+	{
+		uint32_t lMagic=0;
+		uint32_t vHeader[eDDSHeaderField_LastEnum];
+		if(fread(&lMagic, sizeof(uint32_t), 1, apFile) != 1 || lMagic != kDDSMagic) return false;
+		if(fread(vHeader, sizeof(uint32_t), eDDSHeaderField_LastEnum, apFile) != eDDSHeaderField_LastEnum) return false;
+		if(vHeader[eDDSHeaderField_Size] != kDDSHeaderSize) return false;
+
+		////////////////////////////////////////
+		//Size and layout
+		avSize.x = (int)vHeader[eDDSHeaderField_Width];
+		avSize.y = (int)vHeader[eDDSHeaderField_Height];
+		avSize.z = 1;
+		if(avSize.x <= 0 || avSize.y <= 0) return false;
+
+		uint32_t lCaps2 = vHeader[eDDSHeaderField_Caps2];
+		if((lCaps2 & kDDSCAPS2_Volume) && (vHeader[eDDSHeaderField_Flags] & kDDSD_Depth))
+		{
+			avSize.z = std::max(1, (int)vHeader[eDDSHeaderField_Depth]);
+		}
+
+		alNumOfImages = 1;
+		if(lCaps2 & kDDSCAPS2_CubeMap)
+		{
+			//Partial cube maps are left to DevIL
+			if((lCaps2 & kDDSCAPS2_CubeMapAllFaces) != kDDSCAPS2_CubeMapAllFaces) return false;
+			alNumOfImages = 6;
+		}
+
+		alNumOfMipMaps = 1;
+		if(vHeader[eDDSHeaderField_Flags] & kDDSD_MipMapCount)
+		{
+			alNumOfMipMaps = std::max(1, (int)vHeader[eDDSHeaderField_MipMapCount]);
+		}
+
+		////////////////////////////////////////
+		//Pixel format
+		uint32_t lPixelFlags = vHeader[eDDSHeaderField_PixelFlags];
+		uint32_t lBitCount = vHeader[eDDSHeaderField_BitCount];
+		uint32_t lRMask = vHeader[eDDSHeaderField_RMask];
+		uint32_t lGMask = vHeader[eDDSHeaderField_GMask];
+		uint32_t lBMask = vHeader[eDDSHeaderField_BMask];
+		uint32_t lAMask = vHeader[eDDSHeaderField_AMask];
+
+		aFormat.mlBlockSize = 0;
+		aFormat.mPixelFormat = ePixelFormat_Unknown;
+
+		if(lPixelFlags & kDDPF_FourCC)
+		{
+			//Compressed data reports the size of a decompressed pixel, same as DevIL.
+			aFormat.mlBytesPerPixel = 4;
+			switch(vHeader[eDDSHeaderField_FourCC])
+			{
+			case DDS_FOURCC('D','X','T','1'): aFormat.mPixelFormat = ePixelFormat_DXT1; aFormat.mlBlockSize = 8; break;
+			case DDS_FOURCC('D','X','T','3'): aFormat.mPixelFormat = ePixelFormat_DXT3; aFormat.mlBlockSize = 16; break;
+			case DDS_FOURCC('D','X','T','5'): aFormat.mPixelFormat = ePixelFormat_DXT5; aFormat.mlBlockSize = 16; break;
+			}
+		}
+		else if((lPixelFlags & kDDPF_RGB) && lBitCount == 32 && (lPixelFlags & kDDPF_AlphaPixels) && lAMask == 0xff000000)
+		{
+			aFormat.mlBytesPerPixel = 4;
+			if(lRMask == 0x00ff0000 && lGMask == 0x0000ff00 && lBMask == 0x000000ff)		aFormat.mPixelFormat = ePixelFormat_BGRA;
+			else if(lRMask == 0x000000ff && lGMask == 0x0000ff00 && lBMask == 0x00ff0000)	aFormat.mPixelFormat = ePixelFormat_RGBA;
+		}
+		else if((lPixelFlags & kDDPF_RGB) && lBitCount == 24)
+		{
+			aFormat.mlBytesPerPixel = 3;
+			if(lRMask == 0x00ff0000 && lGMask == 0x0000ff00 && lBMask == 0x000000ff)		aFormat.mPixelFormat = ePixelFormat_BGR;
+			else if(lRMask == 0x000000ff && lGMask == 0x0000ff00 && lBMask == 0x00ff0000)	aFormat.mPixelFormat = ePixelFormat_RGB;
+		}
+		else if((lPixelFlags & kDDPF_Luminance) && (lPixelFlags & kDDPF_AlphaPixels)==0 && lBitCount == 8)
+		{
+			//Loaded as alpha the way DevIL does, the shaders sample these from the alpha channel
+			aFormat.mlBytesPerPixel = 1;
+			aFormat.mPixelFormat = ePixelFormat_Alpha;
+		}
+		else if((lPixelFlags & kDDPF_Alpha) && lBitCount == 8)
+		{
+			aFormat.mlBytesPerPixel = 1;
+			aFormat.mPixelFormat = ePixelFormat_Alpha;
+		}
+
+		return aFormat.mPixelFormat != ePixelFormat_Unknown;
+	}
+
+	//-----------------------------------------------------------------------
+
+	int cBitmapLoaderDDS::GetMipMapSize(const cVector3l& avSize, int alMipMap, const cDDSFormat& aFormat)
+	{
+		int lWidth = std::max(1, avSize.x >> alMipMap);
+		int lHeight = std::max(1, avSize.y >> alMipMap);
+		int lDepth = std::max(1, avSize.z >> alMipMap);
+
+		if(aFormat.mlBlockSize > 0)
+		{
+			return std::max(1, (lWidth+3)/4) * std::max(1, (lHeight+3)/4) * aFormat.mlBlockSize * lDepth;
+		}
+
+		return lWidth * lHeight * lDepth * aFormat.mlBytesPerPixel;
+	}
+
+	//-----------------------------------------------------------------------
+}
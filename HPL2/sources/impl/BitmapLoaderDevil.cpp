@@ -32,6 +32,7 @@
 namespace hpl {
 
 	bool iBitmapLoaderDevil::mbIsInitialized = false;
+	std::mutex iBitmapLoaderDevil::mDevilMutex;
 
 	//////////////////////////////////////////////////////////////////////////
 	// CONSTRUCTORS
@@ -58,6 +59,7 @@ namespace hpl {
 
 	bool iBitmapLoaderDevil::SaveBitmap(cBitmap* apBitmap,const tWString& asFile, tBitmapSaveFlag aFlags)
 	{
+		std::lock_guard<std::mutex> lock(mDevilMutex);
 		Initialize();
 
 		//create image id
@@ -54,6 +54,7 @@ namespace hpl {
 
 	cBitmap* cBitmapLoaderDevilDDS::LoadBitmap(const tWString& asFile, tBitmapLoadFlag aFlags)
 	{
+		std::lock_guard<std::mutex> lock(mDevilMutex);
 		Initialize();
 
 		//create image id
@@ -57,6 +57,7 @@ namespace hpl {
 
 	cBitmap* cBitmapLoaderDevilMisc::LoadBitmap(const tWString& asFile, tBitmapLoadFlag aFlags)
 	{
+		std::lock_guard<std::mutex> lock(mDevilMutex);
 		Initialize();
 
 		//create image id
@@ -23,6 +23,9 @@
 #include "system/LowLevelSystem.h"
 #include "system/Platform.h"
 #include "resources/BinaryBuffer.h"
+#include "math/Math.h"
+
+#include <algorithm>
 
 namespace hpl {
 
@@ -162,6 +165,56 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 
+	static inline bool BoxesOverlap(const cVector3f& avMinA, const cVector3f& avMaxA, const cVector3f& avMinB, const cVector3f& avMaxB)
+	{
+		return	avMinA.x <= avMaxB.x && avMaxA.x >= avMinB.x &&
+				avMinA.y <= avMaxB.y && avMaxA.y >= avMinB.y &&
+				avMinA.z <= avMaxB.z && avMaxA.z >= avMinB.z;
+	}
+
+	void cCollideShapeNewton::GetSubShapesInBox(const cVector3f& avMin, const cVector3f& avMax, tIntVec& avSubShapes)
+	{
+		avSubShapes.clear();
+
+		////////////////////////////
+		// Single shape
+		if(mType != eCollideShapeType_Compound)
+		{
+			if(HasBounds()==false || BoxesOverlap(mBoundingVolume.GetMin(), mBoundingVolume.GetMax(), avMin, avMax))
+				avSubShapes.push_back(0);
+			return;
+		}
+
+		if(mvSubShapeTree.empty()) return;
+
+		////////////////////////////
+		// Walk the tree, balanced so depth is low
+		int vStack[64];
+		int lStackSize = 0;
+		vStack[lStackSize++] = 0;
+
+		while(lStackSize > 0)
+		{
+			int lNode = vStack[--lStackSize];
+			const cCollideShapeNewtonNode &node = mvSubShapeTree[lNode];
+			if(BoxesOverlap(node.mvMin, node.mvMax, avMin, avMax)==false) continue;
+
+			if(node.mlSubShape >= 0)
+			{
+				avSubShapes.push_back(node.mlSubShape);
+			}
+			else
+			{
+				vStack[lStackSize++] = node.mlRight;
+				vStack[lStackSize++] = lNode+1;
+			}
+		}
+
+		std::sort(avSubShapes.begin(), avSubShapes.end());
+	}
+
+	//-----------------------------------------------------------------------
+
 	cVector3f cCollideShapeNewton::GetInertia(float afMass)
 	{
 		cVector3f vInertia(1,1,1);
@@ -292,6 +345,13 @@ namespace hpl {
 
 		mBoundingVolume.SetLocalMinMax(vFinalMin, vFinalMax);
 
+		// Create bounds tree of the sub shapes
+		std::vector<int> vShapeIdx(avShapes.size());
+		for(size_t i=0; i< avShapes.size(); i++) vShapeIdx[i] = (int)i;
+
+		mvSubShapeTree.clear();
+		mvSubShapeTree.reserve(avShapes.size()*2);
+		BuildSubShapeTree(vShapeIdx, 0, (int)vShapeIdx.size());
 	}
 
 	//-----------------------------------------------------------------------
@@ -428,4 +488,62 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 
+	int cCollideShapeNewton::BuildSubShapeTree(std::vector<int>& avShapes, int alFirst, int alCount)
+	{
+		int lNode = (int)mvSubShapeTree.size();
+		mvSubShapeTree.push_back(cCollideShapeNewtonNode());
+
+		////////////////////////////
+		// Bounds of all shapes and of their centers
+		cVector3f vMin = mvSubShapes[avShapes[alFirst]]->GetBoundingVolume().GetMin();
+		cVector3f vMax = mvSubShapes[avShapes[alFirst]]->GetBoundingVolume().GetMax();
+		cVector3f vCenterMin = (vMin + vMax) * 0.5f;
+		cVector3f vCenterMax = vCenterMin;
+		for(int i=alFirst+1; i<alFirst+alCount; ++i)
+		{
+			cBoundingVolume &bv = mvSubShapes[avShapes[i]]->GetBoundingVolume();
+			vMin = cMath::Vector3Min(vMin, bv.GetMin());
+			vMax = cMath::Vector3Max(vMax, bv.GetMax());
+
+			cVector3f vCenter = (bv.GetMin() + bv.GetMax()) * 0.5f;
+			vCenterMin = cMath::Vector3Min(vCenterMin, vCenter);
+			vCenterMax = cMath::Vector3Max(vCenterMax, vCenter);
+		}
+
+		mvSubShapeTree[lNode].mvMin = vMin;
+		mvSubShapeTree[lNode].mvMax = vMax;
+		mvSubShapeTree[lNode].mlRight = -1;
+		mvSubShapeTree[lNode].mlSubShape = -1;
+
+		if(alCount == 1)
+		{
+			mvSubShapeTree[lNode].mlSubShape = avShapes[alFirst];
+			return lNode;
+		}
+
+		////////////////////////////
+		// Split at the median along the axis the centers spread most
+		cVector3f vSpread = vCenterMax - vCenterMin;
+		int lAxis = 0;
+		if(vSpread.y > vSpread.v[lAxis]) lAxis = 1;
+		if(vSpread.z > vSpread.v[lAxis]) lAxis = 2;
+
+		int lHalf = alCount / 2;
+		std::nth_element(avShapes.begin() + alFirst, avShapes.begin() + alFirst + lHalf, avShapes.begin() + alFirst + alCount,
+						[this, lAxis](int alA, int alB)
+						{
+							cBoundingVolume &bvA = mvSubShapes[alA]->GetBoundingVolume();
+							cBoundingVolume &bvB = mvSubShapes[alB]->GetBoundingVolume();
+							return bvA.GetMin().v[lAxis] + bvA.GetMax().v[lAxis] < bvB.GetMin().v[lAxis] + bvB.GetMax().v[lAxis];
+						});
+
+		BuildSubShapeTree(avShapes, alFirst, lHalf);
+		int lRight = BuildSubShapeTree(avShapes, alFirst + lHalf, alCount - lHalf);
+		mvSubShapeTree[lNode].mlRight = lRight;
+
+		return lNode;
+	}
+
+	//-----------------------------------------------------------------------
+
 }
@@ -22,7 +22,7 @@
 #include "impl/MeshLoaderFBX.h"
 #include "impl/MeshLoaderCollada.h"
 #include "impl/XmlDocumentTiny.h"
-#include "impl/BitmapLoaderDevilDDS.h"
+#include "impl/BitmapLoaderDDS.h"
 #include "impl/BitmapLoaderDevilMisc.h"
 
 #include "system/String.h"
@@ -60,7 +60,7 @@ namespace hpl {
 
 	void cLowLevelResourcesSDL::AddBitmapLoaders(cBitmapLoaderHandler* apHandler)
 	{
-		apHandler->AddLoader(hplNew( cBitmapLoaderDevilDDS,()));
+		apHandler->AddLoader(hplNew( cBitmapLoaderDDS,()));
 		apHandler->AddLoader(hplNew( cBitmapLoaderDevilMisc,()));
 	}
 
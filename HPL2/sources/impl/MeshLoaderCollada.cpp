@@ -77,6 +77,7 @@ namespace hpl {
 	{
 		mpMeshLoaderMSH = apMeshLoaderMSH;
 		mbLoadAndSaveMSHFormat = abLoadAndSaveMSHFormat;
+		mbOptimizeVertexOrder = true;
 
 		AddSupportedExtension("dae");
 		AddSupportedExtension("dae_anim");
@@ -668,6 +669,7 @@ namespace hpl {
             LegacyVertexBuffer* legacyBuffer = new LegacyVertexBuffer(eVertexBufferDrawType_Tri, eVertexBufferUsageType_Static, 0, 0);
 		    pSubMesh->SetStreamBuffers(legacyBuffer,
                       std::move(vertexStreams), std::move(indexInfo));
+			if(mbOptimizeVertexOrder) pSubMesh->OptimizeVertexOrder();
 		    pSubMesh->Compile();
 		}
 
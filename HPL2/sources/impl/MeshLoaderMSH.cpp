@@ -29,6 +29,8 @@
 #include "graphics/VertexBuffer.h"
 #include "system/String.h"
 #include "resources/BinaryBuffer.h"
+#include "resources/MapPreloader.h"
+#include "engine/Interface.h"
 
 #include "graphics/Mesh.h"
 #include "graphics/Animation.h"
@@ -68,8 +70,15 @@ namespace hpl {
 	{
 		/////////////////////////////////////////////////
 		// Load file
-		cBinaryBuffer binBuff(asFile);
-		if(binBuff.Load()==false)
+		//The map preloader might already have read the file on its worker thread
+		std::unique_ptr<cBinaryBuffer> pPreloadedBuff;
+		if(MapPreloader* pPreloader = Interface<MapPreloader>::Get())
+		{
+			pPreloadedBuff = pPreloader->TakeBinaryBuffer(asFile);
+		}
+		cBinaryBuffer fileBuff(asFile);
+		cBinaryBuffer& binBuff = pPreloadedBuff ? *pPreloadedBuff : fileBuff;
+		if(pPreloadedBuff==NULL && binBuff.Load()==false)
 		{
 		    LOGF(LogLevel::eERROR, "Could not load file '%s' in MSH loader.", cString::To8Char(asFile).c_str());
 			return NULL;
@@ -514,8 +523,15 @@ namespace hpl {
 		if(gbLogMSHLoad) Log("------ Loading Anim ---------\n");
 		/////////////////////////////////////////////////
 		// Load file
-		cBinaryBuffer binBuff(asFile);
-		if(binBuff.Load()==false)
+		//The map preloader might already have read the file on its worker thread
+		std::unique_ptr<cBinaryBuffer> pPreloadedBuff;
+		if(MapPreloader* pPreloader = Interface<MapPreloader>::Get())
+		{
+			pPreloadedBuff = pPreloader->TakeBinaryBuffer(asFile);
+		}
+		cBinaryBuffer fileBuff(asFile);
+		cBinaryBuffer& binBuff = pPreloadedBuff ? *pPreloadedBuff : fileBuff;
+		if(pPreloadedBuff==NULL && binBuff.Load()==false)
 		{
 			Error("Could not load file '%s' in MSH loader.", cString::To8Char(asFile).c_str());
 			return NULL;
@@ -572,6 +588,21 @@ namespace hpl {
 		return bRet;
 	}
 
+	//-----------------------------------------------------------------------
+
+	bool cMeshLoaderMSH::GetMaterialNames(cBinaryBuffer* apBuffer, tStringVec& avMaterials)
+	{
+		size_t lStartPos = apBuffer->GetPos();
+		apBuffer->SetPos(0);
+
+		bool bRet = GetMaterialNamesFromBuffer(apBuffer, avMaterials);
+
+		apBuffer->SetPos(lStartPos);
+		return bRet;
+	}
+
+	//-----------------------------------------------------------------------
+
 	void cMeshLoaderMSH::AddAnimation(cAnimation *apAnimation, cBinaryBuffer* apBuffer)
 	{
 		////////////////////////
@@ -825,5 +856,98 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 
+	bool cMeshLoaderMSH::GetMaterialNamesFromBuffer(cBinaryBuffer* apBuffer, tStringVec& avMaterials)
+	{
+		if(apBuffer->GetInt32() != MSH_FORMAT_MAGIC_NUMBER) return false;
+		if(apBuffer->GetInt32() != MSH_FORMAT_VERSION) return false;
+
+		int lSubMeshNum = apBuffer->GetInt32();
+		apBuffer->GetInt32(); //Animation num
+		bool bSkeleton = apBuffer->GetBool();
+
+		////////////////////////////
+		// Skeleton and nodes, layout as in LoadMesh
+		if(bSkeleton)
+		{
+			int lRootChildNum = apBuffer->GetInt32();
+			for(int i=0; i<lRootChildNum; ++i) SkipBoneInBuffer(apBuffer);
+		}
+
+		int lRootChildNum = apBuffer->GetInt32();
+		for(int i=0; i<lRootChildNum; ++i) SkipNodeInBuffer(apBuffer);
+
+		////////////////////////////
+		// Sub meshes, only the names are read and the rest is skipped
+		for(int sub=0; sub<lSubMeshNum; ++sub)
+		{
+			if(apBuffer->IsEOF()) return false;
+
+			tString sName, sMaterial;
+			apBuffer->GetString(&sName);
+			apBuffer->GetString(&sMaterial);
+			if(sMaterial != "") avMaterials.push_back(sMaterial);
+
+			if(sub == lSubMeshNum-1) break;
+
+			//Transform, model scale and collide shape
+			apBuffer->AddPos(sizeof(float)*16 + sizeof(float)*3 + 1);
+
+			//Colliders
+			int lColliderNum = apBuffer->GetInt32();
+			apBuffer->AddPos(lColliderNum * (2 + sizeof(float)*16 + sizeof(float)*3 + 1));
+
+			//Vertex bone pairs
+			int lVtxBonePairNum = apBuffer->GetInt32();
+			apBuffer->AddPos(lVtxBonePairNum * (sizeof(int)*2 + sizeof(float)));
+
+			//Vertex arrays
+			int lVtxNum = apBuffer->GetInt32();
+			int lVtxTypeNum = apBuffer->GetInt32();
+			for(int i=0; i<lVtxTypeNum; ++i)
+			{
+				apBuffer->GetShort16();
+				eVertexBufferElementFormat elementFormat = (eVertexBufferElementFormat)apBuffer->GetShort16();
+				apBuffer->GetInt32();
+				int lElementNum = apBuffer->GetInt32();
+
+				size_t lElementSize = elementFormat == eVertexBufferElementFormat_Byte ? 1 : 4;
+				apBuffer->AddPos((size_t)lVtxNum * lElementNum * lElementSize);
+			}
+
+			//Indices
+			int lIdxNum = apBuffer->GetInt32();
+			apBuffer->AddPos(lIdxNum * sizeof(int));
+		}
+
+		return true;
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cMeshLoaderMSH::SkipNodeInBuffer(cBinaryBuffer* apBuffer)
+	{
+		tString sName;
+		apBuffer->GetString(&sName);
+		apBuffer->AddPos(sizeof(float)*16 + sizeof(int)); //Transform and custom flags
+		int lChildNum = apBuffer->GetInt32();
+
+		for(int i=0; i<lChildNum; ++i) SkipNodeInBuffer(apBuffer);
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cMeshLoaderMSH::SkipBoneInBuffer(cBinaryBuffer* apBuffer)
+	{
+		tString sName, sSid;
+		apBuffer->GetString(&sName);
+		apBuffer->GetString(&sSid);
+		apBuffer->AddPos(sizeof(float)*16); //Transform
+		int lChildNum = apBuffer->GetInt32();
+
+		for(int i=0; i<lChildNum; ++i) SkipBoneInBuffer(apBuffer);
+	}
+
+	//-----------------------------------------------------------------------
+
 
 }
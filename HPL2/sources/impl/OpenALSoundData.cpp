@@ -20,9 +20,22 @@
 #include "impl/OpenALSoundData.h"
 #include "impl/OpenALSoundChannel.h"
 
+#include "OALWrapper/OAL_Sample.h"
+
+#include "engine/Interface.h"
+#include "resources/BinaryBuffer.h"
+#include "resources/MapPreloader.h"
+
 #include "system/LowLevelSystem.h"
+#include "system/Platform.h"
 #include "system/String.h"
 
+#include <vorbis/vorbisfile.h>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
 namespace hpl {
 
 	//////////////////////////////////////////////////////////////////////////
@@ -94,7 +107,17 @@ namespace hpl {
 		}
 		else
 		{
-			mpSample = OAL_Sample_Load ( asFile.c_str() );
+			//The map preloader might already have decoded the file on its worker thread
+			std::unique_ptr<cBinaryBuffer> pPreparedBuff;
+			if(MapPreloader* pPreloader = Interface<MapPreloader>::Get())
+			{
+				pPreparedBuff = pPreloader->TakeBinaryBuffer(asFile);
+			}
+
+			if(pPreparedBuff)
+				mpSample = OAL_Sample_LoadFromBuffer ( pPreparedBuff->GetDataPointer(), pPreparedBuff->GetSize(), eOAL_SampleFormat_Wav );
+			else
+				mpSample = OAL_Sample_Load ( asFile.c_str() );
 //			mpSoundData = OAL_Sample_Load ( asFile.c_str() );
 			if(mpSample == NULL)//mpSoundData==NULL){
 			{
@@ -112,6 +135,68 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 
+	bool cOpenALSoundData::DecodeSampleToBuffer(const tWString &asFile, cBinaryBuffer *apBuffer)
+	{
+		tString sExt = cString::ToLowerCase(cString::To8Char(cString::GetFileExtW(asFile)));
+		if(sExt == "wav") return apBuffer->Load(asFile);
+		if(sExt != "ogg") return false;
+
+		FILE *pFile = cPlatform::OpenFile(asFile, _W("rb"));
+		if(pFile == NULL) return false;
+
+		//ov_clear closes the file from here on
+		OggVorbis_File ovFile;
+		if(ov_open_callbacks(pFile, &ovFile, NULL, 0, OV_CALLBACKS_DEFAULT) < 0)
+		{
+			fclose(pFile);
+			return false;
+		}
+
+		////////////////////////////
+		// Decode, same settings as the OALWrapper ogg sample
+		vorbis_info *pInfo = ov_info(&ovFile, -1);
+		int lChannels = pInfo->channels;
+		int lFrequency = pInfo->rate;
+		int lBlockAlign = lChannels * 2;
+
+		std::vector<char> vPCM((size_t)ov_pcm_total(&ovFile, -1) * lBlockAlign);
+		size_t lDataSize = 0;
+		int lSection = 0;
+		while(lDataSize < vPCM.size())
+		{
+			long lChunkSize = ov_read(&ovFile, &vPCM[lDataSize], (int)std::min<size_t>(vPCM.size() - lDataSize, 4096), 0, 2, 1, &lSection);
+			if(lChunkSize == 0) break;
+			if(lChunkSize < 0)
+			{
+				ov_clear(&ovFile);
+				return false;
+			}
+			lDataSize += lChunkSize;
+		}
+		ov_clear(&ovFile);
+
+		////////////////////////////
+		// Wrap in a wav header
+		apBuffer->Reserve(44 + lDataSize);
+		apBuffer->AddCharArray("RIFF", 4);
+		apBuffer->AddInt32((int)(36 + lDataSize));
+		apBuffer->AddCharArray("WAVEfmt ", 8);
+		apBuffer->AddInt32(16);
+		apBuffer->AddShort16(1); //PCM
+		apBuffer->AddShort16((short)lChannels);
+		apBuffer->AddInt32(lFrequency);
+		apBuffer->AddInt32(lFrequency * lBlockAlign);
+		apBuffer->AddShort16((short)lBlockAlign);
+		apBuffer->AddShort16(16);
+		apBuffer->AddCharArray("data", 4);
+		apBuffer->AddInt32((int)lDataSize);
+		apBuffer->AddCharArray(vPCM.data(), lDataSize);
+
+		return true;
+	}
+
+	//-----------------------------------------------------------------------
+
 	iSoundChannel* cOpenALSoundData::CreateChannel(int alPriority)
 	{
 		//if(mpSoundData==NULL)return NULL;
@@ -151,4 +236,15 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 
+	size_t cOpenALSoundData::GetMemorySize()
+	{
+		//Streams only decode into a few small buffers while playing.
+		if (mbStream || mpSample==NULL) return 0;
+
+		size_t lFrames = (size_t)(mpSample->GetTotalTime() * mpSample->GetFrequency() + 0.5);
+		return lFrames * mpSample->GetChannels() * mpSample->GetBytesPerSample();
+	}
+
+	//-----------------------------------------------------------------------
+
 }
@@ -65,6 +65,9 @@ namespace hpl {
 		mvGravity = cVector3f(0,-9.81f,0);
 		mfMaxTimeStep = 1.0f/60.0f;
 
+		mbPruneShapePairs = true;
+		mlShapePairsTested = 0;
+
 		/////////////////////////////////
 		//Create default material.
 		int lDefaultMatId = 0;//NewtonMaterialGetDefaultGroupID(mpNewtonWorld);
@@ -448,35 +451,41 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 
-	static bool gbRayCalcDist;
-	static bool gbRayCalcNormal;
-	static bool gbRayCalcPoint;
-	static iPhysicsRayCallback *gpRayCallback;
-	static cVector3f gvRayOrigin;
-	static cVector3f gvRayEnd;
-	static cVector3f gvRayDelta;
-	static float gfRayLength;
-	//Temp:
-	static cVector3f gvRayBoxMin;
-	static cVector3f gvRayBoxMax;
+	// The state of a ray cast is passed to the callbacks as user data, so several threads can cast rays at once
+	class cNewtonRayCast
+	{
+	public:
+		bool mbCalcDist;
+		bool mbCalcNormal;
+		bool mbCalcPoint;
+		iPhysicsRayCallback *mpCallback;
+		cVector3f mvOrigin;
+		cVector3f mvEnd;
+		cVector3f mvDelta;
+		float mfLength;
+		//Temp:
+		cVector3f mvBoxMin;
+		cVector3f mvBoxMax;
 
-	static cPhysicsRayParams gRayParams;
+		cPhysicsRayParams mParams;
+	};
 
 	//////////////////////////////////////
 
-	static unsigned RayCastPrefilterFunc (const NewtonBody* apNewtonBody,const NewtonCollision* collision, void* userData)
+	static unsigned RayCastPrefilterFunc (const NewtonBody* apNewtonBody,const NewtonCollision* collision, void* apUserData)
 	{
+		cNewtonRayCast *pRay = (cNewtonRayCast*)apUserData;
 		cPhysicsBodyNewton* pRigidBody = (cPhysicsBodyNewton*) NewtonBodyGetUserData(apNewtonBody);
 		if(pRigidBody->IsActive()==false) return 0;
 
 		//Temp:
 		cBoundingVolume *pBv = pRigidBody->GetBoundingVolume();
-		if(cMath::CheckAABBIntersection(gvRayBoxMin, gvRayBoxMax, pBv->GetMin(), pBv->GetMax())==false)
+		if(cMath::CheckAABBIntersection(pRay->mvBoxMin, pRay->mvBoxMax, pBv->GetMin(), pBv->GetMax())==false)
 		{
 			return 0;
 		}
 
-		bool bRet = gpRayCallback->BeforeIntersect(pRigidBody);
+		bool bRet = pRay->mpCallback->BeforeIntersect(pRigidBody);
 
 		if(bRet) return 1;
 		else return 0;
@@ -485,24 +494,25 @@ namespace hpl {
 	static float RayCastFilterFunc (const NewtonBody* apNewtonBody, const float* apNormalVec,
 								int alCollisionID, void* apUserData, float afIntersetParam)
 	{
+		cNewtonRayCast *pRay = (cNewtonRayCast*)apUserData;
 		cPhysicsBodyNewton* pRigidBody = (cPhysicsBodyNewton*) NewtonBodyGetUserData(apNewtonBody);
 		if(pRigidBody->IsActive()==false) return 1;
 
-		gRayParams.mfT = afIntersetParam;
+		pRay->mParams.mfT = afIntersetParam;
 
 		//Calculate stuff needed.
-		if(gbRayCalcDist){
-			gRayParams.mfDist = gfRayLength * afIntersetParam;
+		if(pRay->mbCalcDist){
+			pRay->mParams.mfDist = pRay->mfLength * afIntersetParam;
 		}
-		if(gbRayCalcNormal){
-			gRayParams.mvNormal.FromVec(apNormalVec);
+		if(pRay->mbCalcNormal){
+			pRay->mParams.mvNormal.FromVec(apNormalVec);
 		}
-		if(gbRayCalcPoint){
-			gRayParams.mvPoint = gvRayOrigin + gvRayDelta * afIntersetParam;
+		if(pRay->mbCalcPoint){
+			pRay->mParams.mvPoint = pRay->mvOrigin + pRay->mvDelta * afIntersetParam;
 		}
 
 		//Call the call back
-		bool bRet = gpRayCallback->OnIntersect(pRigidBody,&gRayParams);
+		bool bRet = pRay->mpCallback->OnIntersect(pRigidBody,&pRay->mParams);
 
 		//return correct value.
 		if(bRet) return 1;//afIntersetParam;
@@ -516,37 +526,38 @@ namespace hpl {
 								bool abCalcDist, bool abCalcNormal,bool abCalcPoint,
 								bool abUsePrefilter)
 	{
-		gbRayCalcPoint = abCalcPoint;
-		gbRayCalcNormal = abCalcNormal;
-		gbRayCalcDist = abCalcDist;
+		cNewtonRayCast ray;
+		ray.mbCalcPoint = abCalcPoint;
+		ray.mbCalcNormal = abCalcNormal;
+		ray.mbCalcDist = abCalcDist;
 
-		gvRayOrigin = avOrigin;
-		gvRayEnd = avEnd;
+		ray.mvOrigin = avOrigin;
+		ray.mvEnd = avEnd;
 
-		gvRayDelta = avEnd - avOrigin;
-		gfRayLength = gvRayDelta.Length();
+		ray.mvDelta = avEnd - avOrigin;
+		ray.mfLength = ray.mvDelta.Length();
 
-        gpRayCallback = apCallback;
+        ray.mpCallback = apCallback;
 
 		////////////
 		//Temp:
 		for(int i=0; i<3; ++i)
 		{
-			if(gvRayOrigin.v[i] > gvRayEnd.v[i]){
-				gvRayBoxMin.v[i] = gvRayEnd.v[i];
-				gvRayBoxMax.v[i] = gvRayOrigin.v[i];
+			if(ray.mvOrigin.v[i] > ray.mvEnd.v[i]){
+				ray.mvBoxMin.v[i] = ray.mvEnd.v[i];
+				ray.mvBoxMax.v[i] = ray.mvOrigin.v[i];
 			}
 			else {
-				gvRayBoxMin.v[i] = gvRayOrigin.v[i];
-				gvRayBoxMax.v[i] = gvRayEnd.v[i];
+				ray.mvBoxMin.v[i] = ray.mvOrigin.v[i];
+				ray.mvBoxMax.v[i] = ray.mvEnd.v[i];
 			}
 		}
 
 
 		if(abUsePrefilter)
-			NewtonWorldRayCast(mpNewtonWorld, avOrigin.v, avEnd.v,RayCastFilterFunc, NULL, RayCastPrefilterFunc);
+			NewtonWorldRayCast(mpNewtonWorld, avOrigin.v, avEnd.v,RayCastFilterFunc, &ray, RayCastPrefilterFunc);
 		else
-			NewtonWorldRayCast(mpNewtonWorld, avOrigin.v, avEnd.v,RayCastFilterFunc, NULL, NULL);
+			NewtonWorldRayCast(mpNewtonWorld, avOrigin.v, avEnd.v,RayCastFilterFunc, &ray, NULL);
 	}
 
 	//-----------------------------------------------------------------------
@@ -561,6 +572,33 @@ namespace hpl {
 		}
 	}
 
+	//Added to the bounds so pairs that Newton still counts as touching are not pruned.
+	static const float kShapePairBoundsMargin = 0.01f;
+
+	static void GetTransformedBox(const cMatrixf& a_mtxTransform, const cVector3f& avMin, const cVector3f& avMax,
+								cVector3f& avOutMin, cVector3f& avOutMax)
+	{
+		cVector3f vCenter = cMath::MatrixMul(a_mtxTransform, (avMin + avMax) * 0.5f);
+		cVector3f vHalf = (avMax - avMin) * 0.5f;
+
+		cVector3f vExtent;
+		for(int i=0; i<3; ++i)
+		{
+			vExtent.v[i] =	cMath::Abs(a_mtxTransform.m[i][0]) * vHalf.x +
+							cMath::Abs(a_mtxTransform.m[i][1]) * vHalf.y +
+							cMath::Abs(a_mtxTransform.m[i][2]) * vHalf.z + kShapePairBoundsMargin;
+		}
+
+		avOutMin = vCenter - vExtent;
+		avOutMax = vCenter + vExtent;
+	}
+
+	static void GetAllSubShapes(int alCount, tIntVec& avSubShapes)
+	{
+		avSubShapes.resize(alCount);
+		for(int i=0; i<alCount; ++i) avSubShapes[i] = i;
+	}
+
 	bool cPhysicsWorldNewton::CheckShapeCollision(	iCollideShape* apShapeA, const cMatrixf& a_mtxA,
 										iCollideShape* apShapeB, const cMatrixf& a_mtxB,
 										cCollideData & aCollideData, int alMaxPoints,
@@ -587,13 +625,51 @@ namespace hpl {
 			aCollideData.mlNumOfPoints = 0;
 			int lCollideDataStart =0;
 
-			for(int a=0; a< lACount; a++)
+			//////////////////////////
+			// Get the sub shapes of A inside the bounds of B. Pairs are still tested in index order
+			// so the contact points come out the same as when testing all.
+			bool bPrune = mbPruneShapePairs && pNewtonShapeA->HasBounds() && pNewtonShapeB->HasBounds();
+			cMatrixf mtxAToB;
+			if(bPrune)
+			{
+				cMatrixf mtxBToA = cMath::MatrixMul(cMath::MatrixInverse(a_mtxA), a_mtxB);
+				mtxAToB = cMath::MatrixInverse(mtxBToA);
+
+				cBoundingVolume &bvB = pNewtonShapeB->GetBoundingVolume();
+				cVector3f vMin, vMax;
+				GetTransformedBox(mtxBToA, bvB.GetMin(), bvB.GetMax(), vMin, vMax);
+				pNewtonShapeA->GetSubShapesInBox(vMin, vMax, mvTempSubShapesA);
+			}
+			else
+			{
+				GetAllSubShapes(lACount, mvTempSubShapesA);
+			}
+
+			for(size_t lAIdx=0; lAIdx< mvTempSubShapesA.size(); lAIdx++)
 			{
-				for(int b=0; b< lBCount; b++)
+				int a = mvTempSubShapesA[lAIdx];
+				cCollideShapeNewton *pSubShapeA = static_cast<cCollideShapeNewton*>(pNewtonShapeA->GetSubShape(a));
+
+				//////////////////////////
+				// Get the sub shapes of B inside the bounds of the sub shape
+				if(bPrune)
+				{
+					cBoundingVolume &bvSubA = pSubShapeA->GetBoundingVolume();
+					cVector3f vMin, vMax;
+					GetTransformedBox(mtxAToB, bvSubA.GetMin(), bvSubA.GetMax(), vMin, vMax);
+					pNewtonShapeB->GetSubShapesInBox(vMin, vMax, mvTempSubShapesB);
+				}
+				else
+				{
+					GetAllSubShapes(lBCount, mvTempSubShapesB);
+				}
+
+				for(size_t lBIdx=0; lBIdx< mvTempSubShapesB.size(); lBIdx++)
 				{
-					cCollideShapeNewton *pSubShapeA = static_cast<cCollideShapeNewton*>(pNewtonShapeA->GetSubShape(a));
+					int b = mvTempSubShapesB[lBIdx];
 					cCollideShapeNewton *pSubShapeB = static_cast<cCollideShapeNewton*>(pNewtonShapeB->GetSubShape(b));
 
+					mlShapePairsTested++;
 					int lNum = NewtonCollisionCollide(mpNewtonWorld, alMaxPoints,
 												pSubShapeA->GetNewtonCollision(), &(mtxTransposeA.m[0][0]),
 												pSubShapeB->GetNewtonCollision(), &(mtxTransposeB.m[0][0]),
@@ -644,6 +720,7 @@ namespace hpl {
 		else
 		{
 			//Log(" 1\n");
+			mlShapePairsTested++;
 			int lNum = NewtonCollisionCollide(mpNewtonWorld, alMaxPoints,
 										pNewtonShapeA->GetNewtonCollision(), &(mtxTransposeA.m[0][0]),
 										pNewtonShapeB->GetNewtonCollision(), &(mtxTransposeB.m[0][0]),
@@ -26,6 +26,7 @@
 #include "input/Action.h"
 #include "input/ActionKeyboard.h"
 #include "input/ActionMouseButton.h"
+#include "input/InputRecorder.h"
 
 #if USE_XINPUT
 #include "impl/GamepadXInput.h"
@@ -51,6 +52,8 @@ namespace hpl
 		mlstInputDevices.push_back(mpMouse);
 		mlstInputDevices.push_back(mpKeyboard);
 
+		mpRecorder = hplNew( cInputRecorder, () );
+
 		RefreshGamepads();
 	}
 
@@ -63,6 +66,8 @@ namespace hpl
 
 		STLMapDeleteAll(m_mapActions);
 
+		hplDelete(mpRecorder);
+
 		if(mpKeyboard)hplDelete(mpKeyboard);
 		if(mpMouse)hplDelete(mpMouse);
 
@@ -104,6 +109,8 @@ namespace hpl
 
 		mpLowLevelInput->EndInputUpdate();
 
+		mpRecorder->UpdateInput(mpKeyboard, mpMouse);
+
 		for(tActionMapIt it = m_mapActions.begin(); it!= m_mapActions.end();++it)
 		{
 			it->second->Update(afTimeStep);
@@ -200,6 +207,7 @@ namespace hpl
 
 	iKeyboard* cInput::GetKeyboard()
 	{
+		if(mpRecorder->IsActive()) return mpRecorder->GetKeyboard();
 		return mpKeyboard;
 	}
 
@@ -207,6 +215,7 @@ namespace hpl
 
 	iMouse* cInput::GetMouse()
 	{
+		if(mpRecorder->IsActive()) return mpRecorder->GetMouse();
 		return mpMouse;
 	}
 
@@ -263,11 +272,15 @@ namespace hpl
 
 	int cInput::GetGamepadNum()
 	{
+		//Gamepads are not recorded, so they are left out of both recording and replay to keep them in sync
+		if(mpRecorder->IsActive()) return 0;
 		return (int)mlstGamepads.size();
 	}
 
 	iGamepad* cInput::GetGamepad(int alIdx)
 	{
+		if(mpRecorder->IsActive()) return NULL;
+
 		tGamepadListIt it = mlstGamepads.begin();
 		for(size_t i=0; it!=mlstGamepads.end(); ++i, ++it)
 		{
@@ -0,0 +1,535 @@
+/*
+ * Copyright © 2009-2020 Frictional Games
+ *
+ * This file is part of Amnesia: The Dark Descent.
+ *
+ * Amnesia: The Dark Descent is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * Amnesia: The Dark Descent is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Amnesia: The Dark Descent.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "input/InputRecorder.h"
+
+#include "resources/BinaryBuffer.h"
+#include "math/Math.h"
+#include "system/LowLevelSystem.h"
+#include "system/Platform.h"
+#include "system/String.h"
+
+#include <cstring>
+
+namespace hpl
+{
+	//////////////////////////////////////////////////////////////////////////
+	// DEFINES
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	#define kInputRecordVersion (2)
+
+	//Update loops between each chunk written to file
+	#define kInputRecordFlushLoops (60)
+
+	#define kInputRecordTag_Update		('U')
+	#define kInputRecordTag_EndLoop		('E')
+	#define kInputRecordTag_FrameTime	('F')
+	#define kInputRecordTag_Input		('I')
+
+	#define kInputRecordFlag_Keys		(0x01)
+	#define kInputRecordFlag_Pressed	(0x02)
+	#define kInputRecordFlag_Released	(0x04)
+	#define kInputRecordFlag_Buttons	(0x08)
+	#define kInputRecordFlag_AbsPos		(0x10)
+	#define kInputRecordFlag_RelPos		(0x20)
+
+	static const char gsInputRecordMagic[4] = {'H','P','L','R'};
+
+	//-----------------------------------------------------------------------
+
+	static void AddKeyPresses(cBinaryBuffer *apData, const std::list<cKeyPress>& alstKeys)
+	{
+		size_t lCount = cMath::Min(alstKeys.size(), (size_t)255);
+		apData->AddUnsignedChar((unsigned char)lCount);
+
+		std::list<cKeyPress>::const_iterator it = alstKeys.begin();
+		for(size_t i=0; i<lCount; ++i, ++it)
+		{
+			apData->AddShort16((short)it->mKey);
+			apData->AddInt32(it->mlUnicode);
+			apData->AddUnsignedChar((unsigned char)it->mlModifier);
+		}
+	}
+
+	static void GetKeyPresses(cBinaryBuffer *apData, std::list<cKeyPress>& alstKeys)
+	{
+		alstKeys.clear();
+
+		int lCount = apData->GetUnsignedChar();
+		for(int i=0; i<lCount; ++i)
+		{
+			eKey key = (eKey)apData->GetShort16();
+			int lUnicode = apData->GetInt32();
+			int lModifier = apData->GetUnsignedChar();
+			alstKeys.push_back(cKeyPress(key, lUnicode, lModifier));
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// RECORDED DEVICES
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	cRecordedKeyboard::cRecordedKeyboard() : iKeyboard("Recorded Keyboard")
+	{
+		mvKeyArray.resize(eKey_LastEnum, false);
+	}
+
+	cKeyPress cRecordedKeyboard::GetKey()
+	{
+		if(mlstKeysPressed.empty()) return cKeyPress(eKey_None, 0, 0);
+
+		cKeyPress key = mlstKeysPressed.front();
+		mlstKeysPressed.pop_front();
+		return key;
+	}
+
+	cKeyPress cRecordedKeyboard::GetReleasedKey()
+	{
+		if(mlstKeysReleased.empty()) return cKeyPress(eKey_None, 0, 0);
+
+		cKeyPress key = mlstKeysReleased.front();
+		mlstKeysReleased.pop_front();
+		return key;
+	}
+
+	//-----------------------------------------------------------------------
+
+	cRecordedMouse::cRecordedMouse() : iMouse("Recorded Mouse")
+	{
+		mvMButtonArray.resize(eMouseButton_LastEnum, false);
+		mvMouseAbsPos = cVector2l(0,0);
+		mvMouseRelPos = cVector2l(0,0);
+	}
+
+	cVector2l cRecordedMouse::GetRelPosition()
+	{
+		cVector2l vPos = mvMouseRelPos;
+		mvMouseRelPos = cVector2l(0,0);
+		return vPos;
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// CONSTRUCTORS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	cInputRecorder::cInputRecorder()
+	{
+		mMode = eInputRecorderMode_Off;
+		mbReplayDone = false;
+
+		mpData = NULL;
+
+		mlSeed = 0;
+		mlUpdatesPerSec = 0;
+		mlInputUpdateCount = 0;
+		mlFlushedSize = 0;
+		mlLoopsSinceFlush = 0;
+	}
+
+	//-----------------------------------------------------------------------
+
+	cInputRecorder::~cInputRecorder()
+	{
+		Stop();
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// PUBLIC METHODS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	bool cInputRecorder::StartRecording(const tWString& asFile, int alSeed, int alUpdatesPerSec)
+	{
+		Stop();
+
+		msFile = asFile;
+		mlSeed = alSeed;
+		mlUpdatesPerSec = alUpdatesPerSec;
+		mlInputUpdateCount = 0;
+		mbReplayDone = false;
+
+		//The header is written now, the data is added to it in chunks
+		cBinaryBuffer headerBuffer;
+		headerBuffer.AddCharArray(gsInputRecordMagic, 4);
+		headerBuffer.AddInt32(kInputRecordVersion);
+		headerBuffer.AddInt32(mlSeed);
+		headerBuffer.AddInt32(mlUpdatesPerSec);
+		if(headerBuffer.Save(msFile)==false)
+		{
+			Error("Could not create input recording '%s'\n", cString::To8Char(msFile).c_str());
+			return false;
+		}
+
+		mpData = hplNew( cBinaryBuffer, () );
+		mpData->Reserve(1 << 20);
+		mlFlushedSize = 0;
+		mlLoopsSinceFlush = 0;
+
+		ResetDevices();
+
+		mMode = eInputRecorderMode_Record;
+
+		Log("Recording input to '%s' (seed %d, %d updates/sec)\n", cString::To8Char(msFile).c_str(), mlSeed, mlUpdatesPerSec);
+
+		return true;
+	}
+
+	//-----------------------------------------------------------------------
+
+	bool cInputRecorder::StartReplay(const tWString& asFile)
+	{
+		Stop();
+
+		cBinaryBuffer fileBuffer;
+		if(fileBuffer.Load(asFile)==false)
+		{
+			Error("Could not load input recording '%s'\n", cString::To8Char(asFile).c_str());
+			return false;
+		}
+
+		char vMagic[4];
+		fileBuffer.GetCharArray(vMagic, 4);
+		if(memcmp(vMagic, gsInputRecordMagic, 4)!=0 || fileBuffer.GetInt32() != kInputRecordVersion)
+		{
+			Error("'%s' is not an input recording or has the wrong version\n", cString::To8Char(asFile).c_str());
+			return false;
+		}
+
+		mlSeed = fileBuffer.GetInt32();
+		mlUpdatesPerSec = fileBuffer.GetInt32();
+
+		//A recording cut short by a crash can end with a partly written chunk, everything before it is used
+		mpData = hplNew( cBinaryBuffer, () );
+		int lChunks = 0;
+		while(fileBuffer.GetPos() + 4 <= fileBuffer.GetSize())
+		{
+			size_t lChunkStart = fileBuffer.GetPos();
+			size_t lChunkSize = (size_t)fileBuffer.GetInt32();
+			fileBuffer.SetPos(lChunkStart);
+			if(lChunkStart + 4 + lChunkSize > fileBuffer.GetSize()) break;
+
+			if(mpData->DecompressAndAddFromBuffer(&fileBuffer, true)==false) break;
+			++lChunks;
+		}
+		if(lChunks == 0 || mpData->GetSize() == 0)
+		{
+			Error("Could not decompress input recording '%s'\n", cString::To8Char(asFile).c_str());
+			hplDelete(mpData);
+			mpData = NULL;
+			return false;
+		}
+		mpData->SetPos(0);
+
+		msFile = asFile;
+		mlInputUpdateCount = 0;
+		mbReplayDone = false;
+
+		ResetDevices();
+
+		mMode = eInputRecorderMode_Replay;
+
+		Log("Replaying input from '%s' (seed %d, %d updates/sec, %d chunks)\n", cString::To8Char(msFile).c_str(), mlSeed, mlUpdatesPerSec, lChunks);
+
+		return true;
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cInputRecorder::Stop()
+	{
+		if(mMode == eInputRecorderMode_Record)
+		{
+			FlushRecording();
+			Log("Saved input recording '%s', %d input updates\n", cString::To8Char(msFile).c_str(), mlInputUpdateCount);
+		}
+
+		if(mpData) hplDelete(mpData);
+		mpData = NULL;
+
+		mMode = eInputRecorderMode_Off;
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cInputRecorder::UpdateInput(iKeyboard *apLiveKeyboard, iMouse *apLiveMouse)
+	{
+		if(mMode == eInputRecorderMode_Record)		RecordInput(apLiveKeyboard, apLiveMouse);
+		else if(mMode == eInputRecorderMode_Replay)	ReplayInput();
+	}
+
+	//-----------------------------------------------------------------------
+
+	bool cInputRecorder::ReplayWantUpdate(float *apStepSize)
+	{
+		if(mMode != eInputRecorderMode_Replay) return false;
+		if(mpData->IsEOF())
+		{
+			StopReplay("end of recording");
+			return false;
+		}
+
+		char lTag = mpData->GetChar();
+		if(lTag == kInputRecordTag_Update)
+		{
+			*apStepSize = mpData->GetFloat32();
+			return true;
+		}
+		if(lTag != kInputRecordTag_EndLoop) StopReplay("recording is out of sync");
+
+		return false;
+	}
+
+	void cInputRecorder::RecordUpdate(float afStepSize)
+	{
+		if(mMode != eInputRecorderMode_Record) return;
+
+		mpData->AddChar(kInputRecordTag_Update);
+		mpData->AddFloat32(afStepSize);
+	}
+
+	void cInputRecorder::RecordEndUpdateLoop()
+	{
+		if(mMode != eInputRecorderMode_Record) return;
+
+		mpData->AddChar(kInputRecordTag_EndLoop);
+
+		if(++mlLoopsSinceFlush >= kInputRecordFlushLoops) FlushRecording();
+	}
+
+	//-----------------------------------------------------------------------
+
+	float cInputRecorder::UpdateFrameTime(float afFrameTime)
+	{
+		if(mMode == eInputRecorderMode_Record)
+		{
+			mpData->AddChar(kInputRecordTag_FrameTime);
+			mpData->AddFloat32(afFrameTime);
+		}
+		else if(mMode == eInputRecorderMode_Replay)
+		{
+			if(CheckTag(kInputRecordTag_FrameTime)) return mpData->GetFloat32();
+		}
+
+		return afFrameTime;
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// PRIVATE METHODS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	bool cInputRecorder::CheckTag(char alTag)
+	{
+		if(mpData->IsEOF())
+		{
+			StopReplay("end of recording");
+			return false;
+		}
+		if(mpData->GetChar() != alTag)
+		{
+			StopReplay("recording is out of sync");
+			return false;
+		}
+		return true;
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cInputRecorder::RecordInput(iKeyboard *apLiveKeyboard, iMouse *apLiveMouse)
+	{
+		//////////////////////
+		//Get the changes from the last update
+		std::vector<short> vChangedKeys;
+		for(int i=0; i<eKey_LastEnum; ++i)
+		{
+			bool bDown = apLiveKeyboard->KeyIsDown((eKey)i);
+			if(bDown == mKeyboard.mvKeyArray[i]) continue;
+
+			mKeyboard.mvKeyArray[i] = bDown;
+			vChangedKeys.push_back((short)i);
+		}
+
+		mKeyboard.mlstKeysPressed.clear();
+		while(apLiveKeyboard->KeyIsPressed()) mKeyboard.mlstKeysPressed.push_back(apLiveKeyboard->GetKey());
+		mKeyboard.mlstKeysReleased.clear();
+		while(apLiveKeyboard->KeyIsReleased()) mKeyboard.mlstKeysReleased.push_back(apLiveKeyboard->GetReleasedKey());
+
+		unsigned short lButtons =0;
+		bool bButtonsChanged = false;
+		for(int i=0; i<eMouseButton_LastEnum; ++i)
+		{
+			bool bDown = apLiveMouse->ButtonIsDown((eMouseButton)i);
+			if(bDown) lButtons |= 1 << i;
+			if(bDown != mMouse.mvMButtonArray[i]) bButtonsChanged = true;
+			mMouse.mvMButtonArray[i] = bDown;
+		}
+
+		cVector2l vAbsPos = apLiveMouse->GetAbsPosition();
+		bool bAbsChanged = vAbsPos != mMouse.mvMouseAbsPos;
+		mMouse.mvMouseAbsPos = vAbsPos;
+		mMouse.mvMouseRelPos = apLiveMouse->GetRelPosition();
+
+		//////////////////////
+		//Write the changed parts
+		unsigned char lFlags =0;
+		if(vChangedKeys.empty()==false)					lFlags |= kInputRecordFlag_Keys;
+		if(mKeyboard.mlstKeysPressed.empty()==false)	lFlags |= kInputRecordFlag_Pressed;
+		if(mKeyboard.mlstKeysReleased.empty()==false)	lFlags |= kInputRecordFlag_Released;
+		if(bButtonsChanged)								lFlags |= kInputRecordFlag_Buttons;
+		if(bAbsChanged)									lFlags |= kInputRecordFlag_AbsPos;
+		if(mMouse.mvMouseRelPos != cVector2l(0,0))		lFlags |= kInputRecordFlag_RelPos;
+
+		mpData->AddChar(kInputRecordTag_Input);
+		mpData->AddUnsignedChar(lFlags);
+
+		if(lFlags & kInputRecordFlag_Keys)
+		{
+			mpData->AddUnsignedShort16((unsigned short)vChangedKeys.size());
+			mpData->AddShort16Array(&vChangedKeys[0], vChangedKeys.size());
+		}
+		if(lFlags & kInputRecordFlag_Pressed)	AddKeyPresses(mpData, mKeyboard.mlstKeysPressed);
+		if(lFlags & kInputRecordFlag_Released)	AddKeyPresses(mpData, mKeyboard.mlstKeysReleased);
+		if(lFlags & kInputRecordFlag_Buttons)	mpData->AddUnsignedShort16(lButtons);
+		if(lFlags & kInputRecordFlag_AbsPos)
+		{
+			mpData->AddShort16((short)vAbsPos.x);
+			mpData->AddShort16((short)vAbsPos.y);
+		}
+		if(lFlags & kInputRecordFlag_RelPos)
+		{
+			mpData->AddShort16((short)mMouse.mvMouseRelPos.x);
+			mpData->AddShort16((short)mMouse.mvMouseRelPos.y);
+		}
+
+		++mlInputUpdateCount;
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cInputRecorder::ReplayInput()
+	{
+		mKeyboard.mlstKeysPressed.clear();
+		mKeyboard.mlstKeysReleased.clear();
+		mMouse.mvMouseRelPos = cVector2l(0,0);
+
+		if(CheckTag(kInputRecordTag_Input)==false) return;
+
+		unsigned char lFlags = mpData->GetUnsignedChar();
+
+		if(lFlags & kInputRecordFlag_Keys)
+		{
+			int lCount = mpData->GetUnsignedShort16();
+			for(int i=0; i<lCount; ++i)
+			{
+				int lKey = mpData->GetShort16();
+				if(lKey>=0 && lKey<eKey_LastEnum) mKeyboard.mvKeyArray[lKey] = !mKeyboard.mvKeyArray[lKey];
+			}
+		}
+		if(lFlags & kInputRecordFlag_Pressed)	GetKeyPresses(mpData, mKeyboard.mlstKeysPressed);
+		if(lFlags & kInputRecordFlag_Released)	GetKeyPresses(mpData, mKeyboard.mlstKeysReleased);
+		if(lFlags & kInputRecordFlag_Buttons)
+		{
+			unsigned short lButtons = mpData->GetUnsignedShort16();
+			for(int i=0; i<eMouseButton_LastEnum; ++i) mMouse.mvMButtonArray[i] = (lButtons & (1 << i)) != 0;
+		}
+		if(lFlags & kInputRecordFlag_AbsPos)
+		{
+			mMouse.mvMouseAbsPos.x = mpData->GetShort16();
+			mMouse.mvMouseAbsPos.y = mpData->GetShort16();
+		}
+		if(lFlags & kInputRecordFlag_RelPos)
+		{
+			mMouse.mvMouseRelPos.x = mpData->GetShort16();
+			mMouse.mvMouseRelPos.y = mpData->GetShort16();
+		}
+
+		++mlInputUpdateCount;
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cInputRecorder::ResetDevices()
+	{
+		std::fill(mKeyboard.mvKeyArray.begin(), mKeyboard.mvKeyArray.end(), false);
+		mKeyboard.mlstKeysPressed.clear();
+		mKeyboard.mlstKeysReleased.clear();
+
+		std::fill(mMouse.mvMButtonArray.begin(), mMouse.mvMButtonArray.end(), false);
+		mMouse.mvMouseAbsPos = cVector2l(0,0);
+		mMouse.mvMouseRelPos = cVector2l(0,0);
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cInputRecorder::FlushRecording()
+	{
+		mlLoopsSinceFlush = 0;
+		if(mpData->GetSize() <= mlFlushedSize) return;
+
+		//Only what was added since the last chunk is compressed. Chunks end after an update loop, so a replay
+		//of a crashed session stops cleanly at the end of the last one.
+		cBinaryBuffer chunkBuffer;
+		chunkBuffer.CompressAndAdd(mpData->GetDataPointerAtPos(mlFlushedSize), mpData->GetSize() - mlFlushedSize, -1, true);
+
+		FILE *pFile = cPlatform::OpenFile(msFile, _W("ab"));
+		if(pFile==NULL)
+		{
+			Error("Could not write to input recording '%s'\n", cString::To8Char(msFile).c_str());
+			return;
+		}
+		size_t lWritten = fwrite(chunkBuffer.GetDataPointer(), 1, chunkBuffer.GetSize(), pFile);
+		fclose(pFile);
+
+		if(lWritten != chunkBuffer.GetSize())
+		{
+			Error("Could not write to input recording '%s'\n", cString::To8Char(msFile).c_str());
+			return;
+		}
+		mlFlushedSize = mpData->GetSize();
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cInputRecorder::StopReplay(const tString& asReason)
+	{
+		Log("Input replay of '%s' stopped after %d input updates: %s\n", cString::To8Char(msFile).c_str(), mlInputUpdateCount, asReason.c_str());
+
+		mbReplayDone = true;
+		Stop();
+	}
+
+	//-----------------------------------------------------------------------
+}
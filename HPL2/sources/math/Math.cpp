@@ -2202,6 +2202,36 @@ namespace hpl {
 		return mtxFinal;
 	}
 
+	//-----------------------------------------------------------------------
+
+	cMatrixf cMath::MatrixSlerpScaled(float afT,const cMatrixf& a_mtxA, const cMatrixf& a_mtxB)
+	{
+		if(afT <= 0) return a_mtxA;
+		if(afT >= 1) return a_mtxB;
+
+		cVector3f vScaleA(	cVector3f(a_mtxA.m[0][0], a_mtxA.m[1][0], a_mtxA.m[2][0]).Length(),
+							cVector3f(a_mtxA.m[0][1], a_mtxA.m[1][1], a_mtxA.m[2][1]).Length(),
+							cVector3f(a_mtxA.m[0][2], a_mtxA.m[1][2], a_mtxA.m[2][2]).Length());
+		cVector3f vScaleB(	cVector3f(a_mtxB.m[0][0], a_mtxB.m[1][0], a_mtxB.m[2][0]).Length(),
+							cVector3f(a_mtxB.m[0][1], a_mtxB.m[1][1], a_mtxB.m[2][1]).Length(),
+							cVector3f(a_mtxB.m[0][2], a_mtxB.m[1][2], a_mtxB.m[2][2]).Length());
+
+		//A flattened matrix has no rotation to get
+		const float fMinScale = 0.00001f;
+		if(	vScaleA.x < fMinScale || vScaleA.y < fMinScale || vScaleA.z < fMinScale ||
+			vScaleB.x < fMinScale || vScaleB.y < fMinScale || vScaleB.z < fMinScale)
+		{
+			return afT < 0.5f ? a_mtxA : a_mtxB;
+		}
+
+		cMatrixf mtxRotA = MatrixMul(a_mtxA, MatrixScale(cVector3f(1.0f/vScaleA.x, 1.0f/vScaleA.y, 1.0f/vScaleA.z)));
+		cMatrixf mtxRotB = MatrixMul(a_mtxB, MatrixScale(cVector3f(1.0f/vScaleB.x, 1.0f/vScaleB.y, 1.0f/vScaleB.z)));
+
+		cMatrixf mtxFinal = MatrixSlerp(afT, mtxRotA, mtxRotB, true);
+
+		return MatrixMul(mtxFinal, MatrixScale(vScaleA * (1 - afT) + vScaleB * afT));
+	}
+
 	cMatrixf cMath::MatrixMul(const cMatrixf &a_mtxA,const cMatrixf &a_mtxB)
 	{
 		cMatrixf mtxC;
@@ -35,6 +35,15 @@
 
 namespace hpl {
 
+	//Movement allowed for a particle between two sleep checks for the rope to fall asleep. Checking only the
+	//speed puts ropes to sleep at the top of a swing.
+	static const float kfSleepCheckMoveSqrLimit = 0.005f * 0.005f;
+
+	//How much an attached body may move away from where it was when the rope fell asleep, or how fast it may
+	//move, before the rope wakes up.
+	static const float kfAttachedWakeDistSqr = 0.005f * 0.005f;
+	static const float kfAttachedWakeSpeedSqr = 0.01f * 0.01f;
+
 	//////////////////////////////////////////////////////////////////////////
 	// CONSTRUCTORS
 	//////////////////////////////////////////////////////////////////////////
@@ -52,6 +61,10 @@ namespace hpl {
 		{
 			mvAttachedBody[i].mpBody = NULL;
 			mForcePid[i].SetErrorNum(10);
+
+			mvAttachedForce[i] = 0;
+			mvAttachedTorque[i] = 0;
+			mvSleepAttachPos[i] = 0;
 		}
 
 		mfTotalLength = cMath::Vector3Dist(avStartPos, avEndPos);
@@ -88,6 +101,9 @@ namespace hpl {
 		mlMaxIterations = 3;
 
 		mbHasUpdated = false;
+
+		mbSolverNodesUpdated = false;
+		mlLodStep = 1;
 	}
 
 
@@ -123,10 +139,16 @@ namespace hpl {
 		PreUpdate(afTimeStep);
 		if(mbSleeping)
 		{
+			ApplySleepingForces();
 			return;
 		}
 
 		UpdateMotorAndAutoMove(afTimeStep);
+
+		//The solver works on arrays of the simulated particles, copied from and back to the particles.
+		if(mbSolverNodesUpdated==false) BuildSolverNodes();
+		GetSolverData();
+
 		UpdateMovement(afTimeStep);
 
 		UpdateAttachedParticlePositions(afTimeStep);
@@ -137,6 +159,8 @@ namespace hpl {
 		}
 
 		UpdateAttachedBodies(afTimeStep);
+
+		SetSolverData();
 	}
 
 	//-----------------------------------------------------------------------
@@ -247,6 +271,17 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 
+	void iPhysicsRope::SetLodStep(int alX)
+	{
+		if(alX < 1) alX = 1;
+		if(mlLodStep == alX) return;
+
+		mlLodStep = alX;
+		mbSolverNodesUpdated = false;
+	}
+
+	//-----------------------------------------------------------------------
+
 	void iPhysicsRope::RenderDebug(iLowLevelGraphics *apLowLevel)
 	{
 		cVector3f vPrevPos =0;
@@ -313,12 +348,15 @@ namespace hpl {
 	{
 		if(mbMotorActive) return true;
 
+		//Attached bodies are kept enabled by the force applied while sleeping, so only wake up if one has moved.
 		for(int i=0; i<2; ++i)
 		{
 			iPhysicsBody *pBody = mvAttachedBody[i].mpBody;
 			if(pBody)
 			{
-				if(pBody->GetEnabled()) return true;
+				cVector3f vPos = cMath::MatrixMul(pBody->GetLocalMatrix(), mvAttachedBody[i].mvBodyLocalPos);
+				if(cMath::Vector3DistSqr(vPos, mvSleepAttachPos[i]) > kfAttachedWakeDistSqr) return true;
+				if(pBody->GetLinearVelocity().SqrLength() > kfAttachedWakeSpeedSqr) return true;
 			}
 		}
 		return false;
@@ -331,20 +369,51 @@ namespace hpl {
 			iPhysicsBody *pBody = mvAttachedBody[i].mpBody;
 			if(pBody)
 			{
-				if(abSleeping==false) pBody->Enable();
+				if(abSleeping)
+					mvSleepAttachPos[i] = cMath::MatrixMul(pBody->GetLocalMatrix(), mvAttachedBody[i].mvBodyLocalPos);
+				else
+					pBody->Enable();
 			}
 		}
 	}
 
+	bool iPhysicsRope::CheckParticlesSleeping()
+	{
+		if(mbSolverNodesUpdated==false || mvNodePositions.empty())
+			return iVerletParticleContainer::CheckParticlesSleeping();
+
+		size_t lCount = mvNodePositions.size();
+		bool bSleeping = mvSleepCheckPositions.size() == lCount;
+
+		for(size_t i=0; i<lCount && bSleeping; ++i)
+		{
+			if(cMath::Vector3DistSqr(mvNodePositions[i], mvNodePrevPositions[i]) > mfSleepCheckSqrLimit) bSleeping = false;
+			if(cMath::Vector3DistSqr(mvNodePositions[i], mvSleepCheckPositions[i]) > kfSleepCheckMoveSqrLimit) bSleeping = false;
+		}
+
+		mvSleepCheckPositions = mvNodePositions;
+
+		return bSleeping;
+	}
+
 	//-----------------------------------------------------------------------
 
 	void iPhysicsRope::UpdateMovement(float afTimeStep)
 	{
-		for(tVerletParticleListIt it = mlstParticles.begin(); it != mlstParticles.end(); ++it)
-		{
-			cVerletParticle *pPart = *it;
+		//Same as cVerletParticle::UpdateMovement
+		cVector3f vGravityAdd = mvGravityForce * afTimeStep*afTimeStep;
+		cVector3f vZero(0);
+
+		size_t lCount = mvNodePositions.size();
+		cVector3f *pPos = &mvNodePositions[0];
+		cVector3f *pPrevPos = &mvNodePrevPositions[0];
+		const float *pInvMass = &mvNodeInvMasses[0];
 
-			pPart->UpdateMovement(afTimeStep);
+		for(size_t i=0; i<lCount; ++i)
+		{
+			cVector3f vTemp = pPos[i];
+			pPos[i] += (pPos[i]*mfDampingMul - pPrevPos[i]*mfDampingMul) + (pInvMass[i] == 0 ? vZero : vGravityAdd);
+			pPrevPos[i] = vTemp;
 		}
 	}
 
@@ -451,7 +520,8 @@ namespace hpl {
 
 			cVector3f vPos = cMath::MatrixMul(mvAttachedBody[i].mpBody->GetLocalMatrix(), mvAttachedBody[i].mvBodyLocalPos);
 
-			mvAttachedBody[i].mpParticle->SetPosition(vPos, false);
+			//Attachment 0 is the start particle and 1 the end particle, both always simulated
+			mvNodePositions[i==0 ? 0 : mvNodePositions.size()-1] = vPos;
 		}
 	}
 
@@ -467,7 +537,7 @@ namespace hpl {
 
 			iPhysicsBody *pBody = mvAttachedBody[i].mpBody;
 
-			cVector3f vWantedPos = mvAttachedBody[i].mpParticle->GetPosition();
+			cVector3f vWantedPos = mvNodePositions[i==0 ? 0 : mvNodePositions.size()-1];
 			cVector3f vCurrentPos = cMath::MatrixMul(pBody->GetLocalMatrix(), mvAttachedBody[i].mvBodyLocalPos);
 			cVector3f vError = vWantedPos - vCurrentPos;
 
@@ -487,48 +557,53 @@ namespace hpl {
 
 			cVector3f vTorque = cMath::Vector3Cross(vLocalPos, vForce);
 
-			//Log("  torque (%s)\n", cMath::MatrixMul(pBody->GetInertiaMatrix(), vTorque).ToString().c_str());
-			pBody->AddTorque(cMath::MatrixMul(pBody->GetInertiaMatrix(), vTorque) );
-			//Log("  force (%s)\n", (vForce * pBody->GetMass()).ToString().c_str());
-			pBody->AddForce(vForce * pBody->GetMass());
+			mvAttachedTorque[i] = cMath::MatrixMul(pBody->GetInertiaMatrix(), vTorque);
+			mvAttachedForce[i] = vForce * pBody->GetMass();
+
+			//Log("  torque (%s)\n", mvAttachedTorque[i].ToString().c_str());
+			pBody->AddTorque(mvAttachedTorque[i]);
+			//Log("  force (%s)\n", mvAttachedForce[i].ToString().c_str());
+			pBody->AddForce(mvAttachedForce[i]);
 		}
 	}
 
 	//-----------------------------------------------------------------------
 
-	void iPhysicsRope::UpdateConstraints(float afTimeStep)
+	void iPhysicsRope::ApplySleepingForces()
 	{
-		cVerletParticle *pPrevPart = NULL;
-		tVerletParticleListIt it = mlstParticles.begin();
-		for(int lCount = 0; it != mlstParticles.end(); ++it, ++lCount)
+		//Keep holding the attached bodies with the last force so they do not start to fall.
+		for(int i=0; i<2; ++i)
 		{
-			cVerletParticle *pPart = *it;
-			if(lCount >0)
-			{
-				float fLength = lCount==1 ? mfFirstSegmentLength : mfSegmentLength;
+			iPhysicsBody *pBody = mvAttachedBody[i].mpBody;
+			if(pBody==NULL || pBody->GetMass()==0) continue;
 
-				//Log("Updating %d, pos1: (%s) pos2: (%s)\n", lCount, pPrevPart->mvPosition.ToString().c_str(), pPart->mvPosition.ToString().c_str());
+			pBody->AddTorque(mvAttachedTorque[i]);
+			pBody->AddForce(mvAttachedForce[i]);
+		}
+	}
 
-				UpdateLengthConstraint(pPrevPart, pPart, fLength);
-			}
+	//-----------------------------------------------------------------------
 
-			pPrevPart = pPart;
-		}
+	void iPhysicsRope::UpdateConstraints(float afTimeStep)
+	{
+		//Same as UpdateLengthConstraint, the order is kept so each constraint sees the previous one.
+		size_t lCount = mvNodePositions.size();
+		cVector3f *pPos = &mvNodePositions[0];
+		const float *pInvMass = &mvNodeInvMasses[0];
+		const float *pLength = &mvNodeLengths[0];
 
-		//Skip collision testing for now!
-		return;
-		it = mlstParticles.begin();
-		for(int lCount = 0; it != mlstParticles.end(); ++it, ++lCount)
+		for(size_t i=1; i<lCount; ++i)
 		{
-			cVerletParticle *pPart = *it;
+			cVector3f vDelta = pPos[i] - pPos[i-1];
+			float fDist = vDelta.Length();
 
-			if(mbCollideAttachments==false && (pPart == GetStartParticle() || pPart == GetEndParticle()))
-			{
-				continue;
-			}
+			float fDiff = (fDist - pLength[i])/(fDist*(pInvMass[i-1] + pInvMass[i]));
 
-			if(pPart->GetInvMass() != 0) UpdateParticleCollisionConstraint(pPart, pPart->GetPrevPosition(), mfParticleRadius);
+			pPos[i-1] += vDelta * fDiff * pInvMass[i-1];
+			pPos[i] -= vDelta * fDiff * pInvMass[i];
 		}
+
+		//Particle collision (UpdateParticleCollisionConstraint) is skipped for now!
 	}
 
 	//-----------------------------------------------------------------------
@@ -546,14 +621,15 @@ namespace hpl {
 			}
 		}
 
-		float fMaxCount = (float) mlstParticles.size() - 1;
+		if(mbSolverNodesUpdated==false) BuildSolverNodes();
 
-		tVerletParticleListIt it = mlstParticles.begin();
-		for(float fCount = 0; it != mlstParticles.end(); ++it, ++fCount)
+		float fMaxCount = (float) mvParticles.size() - 1;
+
+		for(size_t i=0; i<mvParticles.size(); ++i)
 		{
-			cVerletParticle *pPart = *it;
+			cVerletParticle *pPart = mvParticles[i];
 
-			float fT = fCount / fMaxCount;
+			float fT = (float)i / fMaxCount;
 
 			cVector3f vAdd = vAddPos[0]*(1-fT) + vAddPos[1]*fT;
 
@@ -565,6 +641,8 @@ namespace hpl {
 
 	void iPhysicsRope::BuildRopeParticles()
 	{
+		mbSolverNodesUpdated = false;
+
 		////////////////////////
 		//If not updated, clear data
 		if(mbHasUpdated==false)
@@ -643,6 +721,96 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 
+	void iPhysicsRope::BuildSolverNodes()
+	{
+		mvParticles.assign(mlstParticles.begin(), mlstParticles.end());
+		int lCount = (int)mvParticles.size();
+
+		////////////////////////
+		//Every lod step:th particle and the end are simulated, each with the rope length to the previous one
+		mvNodeIndices.resize(0);
+		mvNodeLengths.resize(0);
+
+		mvNodeIndices.push_back(0);
+		mvNodeLengths.push_back(0);
+
+		float fLength = 0;
+		for(int i=1; i<lCount; ++i)
+		{
+			fLength += i==1 ? mfFirstSegmentLength : mfSegmentLength;
+
+			if(i % mlLodStep == 0 || i == lCount-1)
+			{
+				mvNodeIndices.push_back(i);
+				mvNodeLengths.push_back(fLength);
+				fLength = 0;
+			}
+		}
+
+		mvNodePositions.resize(mvNodeIndices.size());
+		mvNodePrevPositions.resize(mvNodeIndices.size());
+		mvNodeInvMasses.resize(mvNodeIndices.size());
+
+		mvSleepCheckPositions.resize(0);
+
+		mbSolverNodesUpdated = true;
+	}
+
+	//-----------------------------------------------------------------------
+
+	void iPhysicsRope::GetSolverData()
+	{
+		for(size_t i=0; i<mvNodeIndices.size(); ++i)
+		{
+			cVerletParticle *pPart = mvParticles[mvNodeIndices[i]];
+
+			mvNodePositions[i] = pPart->mvPosition;
+			mvNodePrevPositions[i] = pPart->mvPrevPosition;
+			mvNodeInvMasses[i] = pPart->mfInvMass;
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
+	void iPhysicsRope::SetSolverData()
+	{
+		for(size_t i=0; i<mvNodeIndices.size(); ++i)
+		{
+			cVerletParticle *pPart = mvParticles[mvNodeIndices[i]];
+
+			pPart->mvPosition = mvNodePositions[i];
+			pPart->mvPrevPosition = mvNodePrevPositions[i];
+		}
+
+		if(mvNodeIndices.size() == mvParticles.size()) return;
+
+		////////////////////////
+		//Place the particles that are not simulated between the nodes
+		for(size_t i=1; i<mvNodeIndices.size(); ++i)
+		{
+			int lStart = mvNodeIndices[i-1];
+			int lEnd = mvNodeIndices[i];
+			if(lEnd - lStart <= 1) continue;
+
+			const cVector3f &vStartPos = mvNodePositions[i-1];
+			const cVector3f &vStartPrevPos = mvNodePrevPositions[i-1];
+			cVector3f vDelta = mvNodePositions[i] - vStartPos;
+			cVector3f vPrevDelta = mvNodePrevPositions[i] - vStartPrevPos;
+			float fInvSpan = 1.0f / (float)(lEnd - lStart);
+
+			for(int j=lStart+1; j<lEnd; ++j)
+			{
+				float fT = (float)(j - lStart) * fInvSpan;
+				cVerletParticle *pPart = mvParticles[j];
+
+				pPart->mvPosition = vStartPos + vDelta*fT;
+				pPart->mvPrevPosition = vStartPrevPos + vPrevDelta*fT;
+			}
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
 	void iPhysicsRope::SetAttachedBody(int alIdx, cVerletParticle *apParticle, iPhysicsBody *apBody)
 	{
 		mForcePid[alIdx].Reset();
@@ -0,0 +1,225 @@
+/*
+ * Copyright © 2009-2020 Frictional Games
+ *
+ * This file is part of Amnesia: The Dark Descent.
+ *
+ * Amnesia: The Dark Descent is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * Amnesia: The Dark Descent is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Amnesia: The Dark Descent.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "physics/PhysicsTriggerVolume.h"
+
+#include "physics/PhysicsWorld.h"
+#include "physics/PhysicsBody.h"
+#include "system/LowLevelSystem.h"
+#include "math/Math.h"
+
+namespace hpl {
+
+	//////////////////////////////////////////////////////////////////////////
+	// CONSTRUCTORS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	cPhysicsTriggerVolume::cPhysicsTriggerVolume(iPhysicsWorld *apWorld, iPhysicsBody *apTriggerBody, iPhysicsTriggerCallback *apCallback)
+	{
+		mpWorld = apWorld;
+		mpTriggerBody = apTriggerBody;
+		mpCallback = apCallback;
+
+		mlUpdateCount = 0;
+		mlTriggerTransformCount = -1;
+		mbRetestAll = true;
+
+		mlBodiesChecked = 0;
+		mlBodiesTested = 0;
+
+		mCollideData.SetMaxSize(1);
+	}
+
+	//-----------------------------------------------------------------------
+
+	cPhysicsTriggerVolume::~cPhysicsTriggerVolume()
+	{
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// PUBLIC METHODS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	void cPhysicsTriggerVolume::Update()
+	{
+		++mlUpdateCount;
+
+		mlBodiesChecked = 0;
+		mlBodiesTested = 0;
+
+		///////////////////////////
+		// If the trigger has moved, all bodies need to be tested
+		int lTriggerCount = mpTriggerBody->GetTransformUpdateCount();
+		bool bTestAll = mbRetestAll || lTriggerCount != mlTriggerTransformCount;
+		mlTriggerTransformCount = lTriggerCount;
+		mbRetestAll = false;
+
+		///////////////////////////
+		// Go through the bodies in the bounds and test the ones that have changed
+		mvTempBodies.resize(0);
+		mvTempOverlaps.resize(0);
+		mvTempEntered.resize(0);
+		mvTempExited.resize(0);
+
+		mpWorld->GetBodiesInBV(mpTriggerBody->GetBoundingVolume(), &mvTempBodies);
+
+		for(size_t i=0; i<mvTempBodies.size(); ++i)
+		{
+			iPhysicsBody *pBody = mvTempBodies[i];
+			if(pBody == mpTriggerBody) continue;
+
+			++mlBodiesChecked;
+
+			int lTransformCount = pBody->GetTransformUpdateCount();
+			float fMass = pBody->GetMass();
+			bool bEnabled = pBody->GetEnabled();
+			bool bCollide = pBody->GetCollide();
+			bool bActive = pBody->IsActive();
+
+			std::pair<tBodyStateMapIt, bool> ret = m_mapBodyStates.insert(tBodyStateMap::value_type(pBody, cBodyState()));
+			cBodyState &state = ret.first->second;
+
+			bool bWasInside = ret.second ? false : state.mbInside;
+
+			if(	bTestAll || ret.second ||
+				state.mlTransformCount != lTransformCount || state.mfMass != fMass ||
+				state.mbEnabled != bEnabled || state.mbCollide != bCollide || state.mbActive != bActive)
+			{
+				state.mlTransformCount = lTransformCount;
+				state.mfMass = fMass;
+				state.mbEnabled = bEnabled;
+				state.mbCollide = bCollide;
+				state.mbActive = bActive;
+
+				state.mbInside = TestBody(pBody);
+			}
+			state.mlUpdateCount = mlUpdateCount;
+
+			if(state.mbInside)
+			{
+				mvTempOverlaps.push_back(pBody);
+				if(bWasInside==false) mvTempEntered.push_back(pBody);
+			}
+		}
+
+		///////////////////////////
+		// Bodies that were inside and are not anymore, or have left the bounds
+		for(size_t i=0; i<mvOverlaps.size(); ++i)
+		{
+			iPhysicsBody *pBody = mvOverlaps[i];
+			tBodyStateMapIt it = m_mapBodyStates.find(pBody);
+
+			if(it == m_mapBodyStates.end() || it->second.mlUpdateCount != mlUpdateCount || it->second.mbInside==false)
+			{
+				mvTempExited.push_back(pBody);
+			}
+		}
+
+		///////////////////////////
+		// Forget bodies that are not in the bounds
+		if(m_mapBodyStates.size() > (size_t)mlBodiesChecked)
+		{
+			for(tBodyStateMapIt it = m_mapBodyStates.begin(); it != m_mapBodyStates.end(); )
+			{
+				if(it->second.mlUpdateCount != mlUpdateCount)	it = m_mapBodyStates.erase(it);
+				else											++it;
+			}
+		}
+
+		mvOverlaps.swap(mvTempOverlaps);
+
+		///////////////////////////
+		// Callbacks, a body destroyed in a callback is set to NULL in the lists
+		if(mpCallback==NULL) return;
+
+		for(size_t i=0; i<mvTempExited.size(); ++i)
+		{
+			if(mvTempExited[i]) mpCallback->OnBodyExit(mvTempExited[i]);
+		}
+		for(size_t i=0; i<mvTempEntered.size(); ++i)
+		{
+			if(mvTempEntered[i]) mpCallback->OnBodyEnter(mvTempEntered[i]);
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
+	bool cPhysicsTriggerVolume::IsOverlapping(iPhysicsBody *apBody)
+	{
+		for(size_t i=0; i<mvOverlaps.size(); ++i)
+		{
+			if(mvOverlaps[i] == apBody) return true;
+		}
+		return false;
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cPhysicsTriggerVolume::RetestAll()
+	{
+		mbRetestAll = true;
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cPhysicsTriggerVolume::OnBodyDestroyed(iPhysicsBody *apBody)
+	{
+		if(apBody == mpTriggerBody)
+		{
+			Error("Trigger body '%s' destroyed before its trigger volume!\n", apBody->GetName().c_str());
+			return;
+		}
+
+		m_mapBodyStates.erase(apBody);
+		STLFindAndRemove(mvOverlaps, apBody);
+
+		for(size_t i=0; i<mvTempEntered.size(); ++i) if(mvTempEntered[i] == apBody) mvTempEntered[i] = NULL;
+		for(size_t i=0; i<mvTempExited.size(); ++i) if(mvTempExited[i] == apBody) mvTempExited[i] = NULL;
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// PRIVATE METHODS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	bool cPhysicsTriggerVolume::TestBody(iPhysicsBody *apBody)
+	{
+		++mlBodiesTested;
+
+		if(mpCallback && mpCallback->CheckBody(apBody)==false) return false;
+
+		if(cMath::CheckBVIntersection(*apBody->GetBoundingVolume(), *mpTriggerBody->GetBoundingVolume())==false) return false;
+
+		return mpWorld->CheckShapeCollision(apBody->GetShape(), apBody->GetLocalMatrix(),
+											mpTriggerBody->GetShape(), mpTriggerBody->GetLocalMatrix(),
+											mCollideData, 1, false);
+	}
+
+	//-----------------------------------------------------------------------
+
+}
@@ -26,6 +26,7 @@
 #include "physics/PhysicsJoint.h"
 #include "physics/PhysicsController.h"
 #include "physics/PhysicsRope.h"
+#include "physics/PhysicsTriggerVolume.h"
 #include "physics/SurfaceData.h"
 #include "system/LowLevelSystem.h"
 #include "system/System.h"
@@ -173,6 +174,17 @@ namespace hpl {
 
 			pRope->UpdateAfterSimulate(afTimeStep);
 		}
+
+		////////////////////////////////////
+		//Update trigger volumes, bodies are where they are going to be this frame now
+		START_TIMING(TriggerVolumes)
+		for(tPhysicsTriggerVolumeListIt it = mlstTriggerVolumes.begin(); it != mlstTriggerVolumes.end(); ++it)
+		{
+			cPhysicsTriggerVolume *pTrigger = *it;
+
+			pTrigger->Update();
+		}
+		STOP_TIMING(TriggerVolumes)
 	}
 
 	//-----------------------------------------------------------------------
@@ -192,6 +204,11 @@ namespace hpl {
 	{
 		if(apBody->IsInUpdateList()) RemoveBodyFromUpdateList(apBody, true);
 
+		for(tPhysicsTriggerVolumeListIt triggerIt = mlstTriggerVolumes.begin(); triggerIt != mlstTriggerVolumes.end(); ++triggerIt)
+		{
+			(*triggerIt)->OnBodyDestroyed(apBody);
+		}
+
 		tPhysicsBodyListIt it = mlstBodies.begin();
 		for(; it != mlstBodies.end(); ++it)
 		{
@@ -345,8 +362,25 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 
+	cPhysicsTriggerVolume* iPhysicsWorld::CreateTriggerVolume(iPhysicsBody *apTriggerBody, iPhysicsTriggerCallback *apCallback)
+	{
+		cPhysicsTriggerVolume *pTrigger = hplNew( cPhysicsTriggerVolume, (this, apTriggerBody, apCallback) );
+		mlstTriggerVolumes.push_back(pTrigger);
+		return pTrigger;
+	}
+
+	void iPhysicsWorld::DestroyTriggerVolume(cPhysicsTriggerVolume* apTrigger)
+	{
+		STLFindAndDelete(mlstTriggerVolumes, apTrigger);
+	}
+
+	//-----------------------------------------------------------------------
+
 	void iPhysicsWorld::DestroyAll()
 	{
+		//Triggers first, so destroying bodies does not notify them
+		STLDeleteAll(mlstTriggerVolumes);
+
 		STLDeleteAll(mlstCharBodies);
 
 		//Bodies
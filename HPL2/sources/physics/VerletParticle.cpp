@@ -229,21 +229,11 @@ namespace hpl {
 			//Update counter and see if time for check
 			mfSleepCheckCount+= afTimeStep;
 			if(mfSleepCheckCount < mfSleepCheckTime) return;
+			mfSleepCheckCount = 0;
 
 			//////////////////////////
-			//Iterate particles and see if all are sleeping
-			bool bAllSleeping=true;
-			for(tVerletParticleListIt it = mlstParticles.begin(); it != mlstParticles.end(); ++it)
-			{
-				cVerletParticle *pPart = *it;
-
-				float fSqrSpeed = cMath::Vector3DistSqr(pPart->GetPosition(), pPart->GetPrevPosition());
-				if(fSqrSpeed > mfSleepCheckSqrLimit)
-				{
-					bAllSleeping= false;
-					break;
-				}
-			}
+			//Check particles and see if all are sleeping
+			bool bAllSleeping = CheckParticlesSleeping();
 
 			//////////////////////////
 			//Check implementation specific sleeping.
@@ -271,6 +261,20 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 
+	bool iVerletParticleContainer::CheckParticlesSleeping()
+	{
+		for(tVerletParticleListIt it = mlstParticles.begin(); it != mlstParticles.end(); ++it)
+		{
+			cVerletParticle *pPart = *it;
+
+			float fSqrSpeed = cMath::Vector3DistSqr(pPart->GetPosition(), pPart->GetPrevPosition());
+			if(fSqrSpeed > mfSleepCheckSqrLimit) return false;
+		}
+		return true;
+	}
+
+	//-----------------------------------------------------------------------
+
 	void iVerletParticleContainer::UpdateLengthConstraint(cVerletParticle *apP1, cVerletParticle *apP2, float afLength)
 	{
 		cVector3f vDelta =  apP2->mvPosition - apP1->mvPosition;
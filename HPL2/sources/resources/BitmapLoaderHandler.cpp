@@ -21,12 +21,14 @@
 
 #include "system/String.h"
 #include "system/LowLevelSystem.h"
+#include "system/JobPool.h"
 #include "resources/Resources.h"
 #include "graphics/Graphics.h"
 
 #include "graphics/Bitmap.h"
 #include "resources/BitmapLoader.h"
 
+#include <algorithm>
 
 #undef LoadBitmap
 
@@ -79,6 +81,20 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 
+	void cBitmapLoaderHandler::LoadBitmaps(const tWStringVec& avFiles, tBitmapLoadFlag aFlags, std::vector<cBitmap*>& avBitmaps)
+	{
+		avBitmaps.assign(avFiles.size(), NULL);
+		if(avFiles.empty()) return;
+
+		//Decoded on the shared workers, a material has only a few images so no threads are created for them
+		cJobPool::GetDefault()->ParallelFor(avFiles.size(), [&](size_t alIdx)
+		{
+			avBitmaps[alIdx] = LoadBitmap(avFiles[alIdx], aFlags);
+		});
+	}
+
+	//-----------------------------------------------------------------------
+
 	bool cBitmapLoaderHandler::SaveBitmap(cBitmap* apBitmap, const tWString& asFile, tBitmapSaveFlag aFlags)
 	{
 		iBitmapLoader *pBitmapLoader = static_cast<iBitmapLoader*>(GetLoaderForFile(asFile));
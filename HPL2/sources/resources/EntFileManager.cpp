@@ -24,6 +24,8 @@
 #include "resources/Resources.h"
 #include "resources/LowLevelResources.h"
 #include "resources/XmlDocument.h"
+#include "resources/MapPreloader.h"
+#include "resources/EntityPrototype.h"
 
 
 namespace hpl {
@@ -31,9 +33,11 @@ namespace hpl {
 	cEntFile::cEntFile(const tString& asName, const tWString& asFullPath, cResources *apResources) : iResourceBase(asName, asFullPath, 0)
 	{
 		mpXmlDoc = apResources->GetLowLevel()->CreateXmlDocument(asName);
+		mpPrototype = NULL;
 	}
 	cEntFile::~cEntFile()
 	{
+		if(mpPrototype) hplDelete(mpPrototype);
 		hplDelete(mpXmlDoc);
 	}
 
@@ -42,6 +46,25 @@ namespace hpl {
 		return mpXmlDoc->CreateFromFile(GetFullPath());
 	}
 
+	void cEntFile::CreateFromDocument(iXmlDocument *apDoc)
+	{
+		if(mpPrototype) hplDelete(mpPrototype);
+		mpPrototype = NULL;
+
+		hplDelete(mpXmlDoc);
+		mpXmlDoc = apDoc;
+	}
+
+	const cEntityPrototype* cEntFile::GetPrototype()
+	{
+		if(mpPrototype==NULL)
+		{
+			mpPrototype = hplNew( cEntityPrototype, () );
+			mpPrototype->Compile(mpXmlDoc, GetFullPath());
+		}
+		return mpPrototype;
+	}
+
 	cEntFileManager::cEntFileManager(cResources *apResources)
 		: iResourceManager(apResources->GetFileSearcher(), apResources->GetLowLevel(), apResources->GetLowLevelSystem())
 	{
@@ -67,7 +90,13 @@ namespace hpl {
 		if(pEntFile==NULL && sPath!=_W(""))
 		{
 			pEntFile = hplNew(cEntFile, (asNewName, sPath.c_str(), mpResources));
-			if(pEntFile->CreateFromFile()==false)
+
+			iXmlDocument *pPreloadedDoc = mpResources->GetMapPreloader()->TakeXmlDocument(sPath);
+			if(pPreloadedDoc)
+			{
+				pEntFile->CreateFromDocument(pPreloadedDoc);
+			}
+			else if(pEntFile->CreateFromFile()==false)
 			{
 				Error("Couldn't load entity file '%s'!\n",cString::To8Char(sPath).c_str());
 				hplDelete(pEntFile);
@@ -43,6 +43,7 @@
 #include "resources/FileSearcher.h"
 #include "resources/XmlDocument.h"
 #include "resources/EngineFileLoading.h"
+#include "resources/EntityPrototype.h"
 
 #include "graphics/Mesh.h"
 #include "graphics/SubMesh.h"
@@ -61,6 +62,8 @@
 #include "haptic/LowLevelHaptic.h"
 #include "haptic/HapticShape.h"
 
+#include <chrono>
+
 namespace hpl {
 
 	//////////////////////////////////////////////////////////////////////////
@@ -85,18 +88,14 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 
-	static iCollideShape* GetBodyShape(cXmlElement *apBodyElem,iPhysicsWorld *apPhysicsWorld, tLoaderCollideShapeMap &a_setShapes)
+	static iCollideShape* GetBodyShape(const cEntityPrototypeBody& aBody,iPhysicsWorld *apPhysicsWorld, tLoaderCollideShapeMap &a_setShapes)
 	{
 		////////////////////////////////////////
 		// Get shapes for body
 		tCollideShapeVec vShapes;
-		cXmlNodeListIterator boundShapeIt = apBodyElem->GetChildIterator();
-		while(boundShapeIt.HasNext())
+		for(size_t i=0; i<aBody.mvShapeIDs.size(); ++i)
 		{
-			cXmlElement *pShapeElem = boundShapeIt.Next()->ToElement();
-			int lShapeID = pShapeElem->GetAttributeInt("ID");
-
-			tLoaderCollideShapeMapIt it = a_setShapes.find(lShapeID);
+			tLoaderCollideShapeMapIt it = a_setShapes.find(aBody.mvShapeIDs[i]);
 			if(it != a_setShapes.end())
 			{
 				vShapes.push_back(it->second);
@@ -115,49 +114,6 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 
-	eCollideShapeType ToCollideShape(const tString& asType)
-	{
-		tString sLowType = cString::ToLowerCase(asType);
-
-		if(sLowType == "box") return eCollideShapeType_Box;
-		if(sLowType == "cylinder") return eCollideShapeType_Cylinder;
-		if(sLowType == "sphere") return eCollideShapeType_Sphere;
-		if(sLowType == "capsule") return eCollideShapeType_Capsule;
-
-		Error("CollideShape '%s' does not exist!\n", asType.c_str());
-
-		return eCollideShapeType_Null;
-	}
-
-	static iCollideShape* CreateCollideShape(cXmlElement *apShapeElem, iPhysicsWorld *apPhysicsWorld, const cVector3f &avScale)
-	{
-		eCollideShapeType type = ToCollideShape(apShapeElem->GetAttributeString("ShapeType"));
-		cVector3f vSize = apShapeElem->GetAttributeVector3f("Scale") * avScale;
-		cVector3f vPos = apShapeElem->GetAttributeVector3f("RelativeTranslation") * avScale;
-		cVector3f vRot = apShapeElem->GetAttributeVector3f("RelativeRotation");
-
-		cMatrixf mtxOffset = cMath::MatrixRotate(vRot,eEulerRotationOrder_XYZ);
-		mtxOffset.SetTranslation(vPos);
-
-		switch(type)
-		{
-		case eCollideShapeType_Box:
-			return apPhysicsWorld->CreateBoxShape(vSize,&mtxOffset);
-		case eCollideShapeType_Sphere:
-			return apPhysicsWorld->CreateSphereShape(vSize,&mtxOffset);
-		case eCollideShapeType_Cylinder:
-			mtxOffset = cMath::MatrixMul(mtxOffset, cMath::MatrixRotateZ(kPi2f));
-			return apPhysicsWorld->CreateCylinderShape(vSize.x,vSize.y,&mtxOffset);
-		case eCollideShapeType_Capsule:
-			mtxOffset = cMath::MatrixMul(mtxOffset, cMath::MatrixRotateZ(kPi2f));
-			return apPhysicsWorld->CreateCapsuleShape(vSize.x,vSize.y,&mtxOffset);
-		}
-
-		return NULL;
-	}
-
-	//-----------------------------------------------------------------------
-
 	static iPhysicsBody * FindBody(int alID, tLoaderPhysicsBodyMap &a_setBodies)
 	{
 		tLoaderPhysicsBodyMapIt it = a_setBodies.find(alID);
@@ -166,22 +122,8 @@ namespace hpl {
 		return it->second;
 	}
 
-	static ePhysicsJointType ToJointType(const tString& asType)
-	{
-		tString sLowType = cString::ToLowerCase(asType);
-
-        if(sLowType == "jointhinge")	return ePhysicsJointType_Hinge;
-		if(sLowType == "jointball")		return ePhysicsJointType_Ball;
-		if(sLowType == "jointslider")	return ePhysicsJointType_Slider;
-		if(sLowType == "joinscrew")		return ePhysicsJointType_Screw;
-
-		Error("Joint type '%s' does not exist!\n", asType.c_str());
-
-		return ePhysicsJointType_Ball;
-	}
-
 	static iPhysicsJoint* CreateJoint(	const tString& asEntityName,
-										cXmlElement *apJointElem, iPhysicsWorld *apPhysicsWorld,
+										const cEntityPrototypeJoint& aJoint, iPhysicsWorld *apPhysicsWorld,
 										tLoaderPhysicsBodyMap &a_setBodies,
 										const cMatrixf& a_mtxTransform,
 										const cVector3f& avScale)
@@ -189,74 +131,64 @@ namespace hpl {
 
 		/////////////////////////////
 		//Get pin direction and pivot and transform according to entity
-		cVector3f vPivot = apJointElem->GetAttributeVector3f("WorldPos") * avScale;
-		cVector3f vPinDir = apJointElem->GetAttributeVector3f("PinDir");
-
-		vPivot = cMath::MatrixMul(a_mtxTransform, vPivot);
-		vPinDir = cMath::MatrixMul3x3(a_mtxTransform, vPinDir);
+		cVector3f vPivot = cMath::MatrixMul(a_mtxTransform, aJoint.mvWorldPos * avScale);
+		cVector3f vPinDir = cMath::MatrixMul3x3(a_mtxTransform, aJoint.mvPinDir);
 
 		/////////////////////////////
-		//Name and type
-		tString sJointName = asEntityName + "_" + apJointElem->GetAttributeString("Name");
-
-		ePhysicsJointType jointType = ToJointType(apJointElem->GetValue());
-
+		//Name
+		tString sJointName = asEntityName + "_" + aJoint.msName;
 
 		/////////////////////////////
 		//Get the bodies
-		int lParentID = apJointElem->GetAttributeInt("ConnectedParentBodyID");
-		int lChildID = apJointElem->GetAttributeInt("ConnectedChildBodyID");
-
-		iPhysicsBody *pParentBody = lParentID > 0 ? FindBody(lParentID,a_setBodies) : NULL;
-		iPhysicsBody *pChildBody = FindBody(lChildID,a_setBodies);
+		iPhysicsBody *pParentBody = aJoint.mlParentID > 0 ? FindBody(aJoint.mlParentID,a_setBodies) : NULL;
+		iPhysicsBody *pChildBody = FindBody(aJoint.mlChildID,a_setBodies);
 
 		if(pChildBody==NULL)
 		{
-			Error("Could not find child body with ID %d for joint '%s'\n", lChildID, sJointName.c_str());
+			Error("Could not find child body with ID %d for joint '%s'\n", aJoint.mlChildID, sJointName.c_str());
 			return NULL;
 		}
 
 		///////////////////////////
 		// Hinge
-		if(jointType == ePhysicsJointType_Hinge)
+		if(aJoint.mType == ePhysicsJointType_Hinge)
 		{
 			iPhysicsJointHinge *pJoint = apPhysicsWorld->CreateJointHinge(sJointName,vPivot,vPinDir,pParentBody,pChildBody);
 
-			pJoint->SetMinAngle(cMath::ToRad(apJointElem->GetAttributeFloat("MinAngle")));
-			pJoint->SetMaxAngle(cMath::ToRad(apJointElem->GetAttributeFloat("MaxAngle")));
+			pJoint->SetMinAngle(aJoint.mfMinLimit);
+			pJoint->SetMaxAngle(aJoint.mfMaxLimit);
 
 			return pJoint;
 		}
 		///////////////////////////
 		// Ball
-		else if(jointType == ePhysicsJointType_Ball)
+		else if(aJoint.mType == ePhysicsJointType_Ball)
 		{
 			iPhysicsJointBall *pJoint = apPhysicsWorld->CreateJointBall(sJointName,vPivot,vPinDir,pParentBody,pChildBody);
 
-			pJoint->SetConeLimits(	cMath::ToRad(apJointElem->GetAttributeFloat("MaxConeAngle")),
-									cMath::ToRad(apJointElem->GetAttributeFloat("MaxTwistAngle")));
+			pJoint->SetConeLimits(aJoint.mfMinLimit, aJoint.mfMaxLimit);
 
 			return pJoint;
 		}
 		///////////////////////////
 		// Slider
-		else if(jointType == ePhysicsJointType_Slider)
+		else if(aJoint.mType == ePhysicsJointType_Slider)
 		{
 			iPhysicsJointSlider *pJoint = apPhysicsWorld->CreateJointSlider(sJointName, vPivot,vPinDir,pParentBody,pChildBody);
 
-			pJoint->SetMinDistance(apJointElem->GetAttributeFloat("MinDistance"));
-			pJoint->SetMaxDistance(apJointElem->GetAttributeFloat("MaxDistance"));
+			pJoint->SetMinDistance(aJoint.mfMinLimit);
+			pJoint->SetMaxDistance(aJoint.mfMaxLimit);
 
 			return pJoint;
 		}
 		///////////////////////////
 		// Screw
-		else if(jointType == ePhysicsJointType_Screw)
+		else if(aJoint.mType == ePhysicsJointType_Screw)
 		{
 			iPhysicsJointScrew *pJoint = apPhysicsWorld->CreateJointScrew(sJointName,vPivot,vPinDir,pParentBody,pChildBody);
 
-			pJoint->SetMinDistance(apJointElem->GetAttributeFloat("MinDistance"));
-			pJoint->SetMaxDistance(apJointElem->GetAttributeFloat("MaxDistance"));
+			pJoint->SetMinDistance(aJoint.mfMinLimit);
+			pJoint->SetMaxDistance(aJoint.mfMaxLimit);
 
 			return pJoint;
 		}
@@ -277,27 +209,26 @@ namespace hpl {
 		return mtxOut;
 	}
 
-
-	//-----------------------------------------------------------------------
-
-	eAnimationEventType ToAnimEventType(const tString& asType)
-	{
-		tString sLowType = cString::ToLowerCase(asType);
-
-        if(sLowType == "playsound")	return eAnimationEventType_PlaySound;
-		if(sLowType == "step")		return eAnimationEventType_Step;
-
-		Error("No animation event named '%s'\n", asType.c_str());
-		return eAnimationEventType_LastEnum;
-	}
-
 	//-----------------------------------------------------------------------
 
 
 	iEntity3D* cEntityLoader_Object::Load(	const tString &asName, int alID, bool abActive, cXmlElement *apRootElem,
 											const cMatrixf &a_mtxTransform, const cVector3f &avScale,
-											cWorld *apWorld, const tString &asFileName, const tWString &asFullPath, cResourceVarsObject *apInstanceVars)
+											cWorld *apWorld, const tString &asFileName, const tWString &asFullPath, cResourceVarsObject *apInstanceVars,
+											const cEntityPrototype *apPrototype)
 	{
+		////////////////////////////////////////
+		// Get the compiled file, when loading straight from an element it is compiled just for this entity
+		cEntityPrototype tempPrototype;
+		if(apPrototype==NULL)
+		{
+			tempPrototype.Compile(apRootElem, asFullPath);
+			apPrototype = &tempPrototype;
+		}
+		if(apPrototype->IsValid()==false) return NULL;
+
+		std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
 		////////////////////////////////////////
 		// Init
 		mvBodies.clear();
@@ -327,16 +258,6 @@ namespace hpl {
 
 		iPhysicsWorld *pPhysicsWorld = apWorld->GetPhysicsWorld();
 
-		////////////////////////////////////////
-		// Load ModelData
-		cXmlElement* pModelDataElem = apRootElem->GetFirstElement("ModelData");
-		if(pModelDataElem==NULL){
-			Error("Couldn't load element ModelData"); return NULL;
-		}
-
-		//msName = cString::ToString(pModelDataElem->Attribute("Name"),"");
-		//msSubType = cString::ToString(pModelDataElem->Attribute("Subtype"),"");
-
 		//////////////////////////////
 		// Before load virtual call.
 		BeforeLoad(apRootElem,a_mtxTransform,apWorld,apInstanceVars);
@@ -344,21 +265,9 @@ namespace hpl {
 
 		////////////////////////////////////////
 		// Load Mesh and create entity
-		cXmlElement *pMeshElem =NULL;
 		{
-			pMeshElem  = pModelDataElem->GetFirstElement("Mesh");
-			if(pMeshElem==NULL){
-				Error("Couldn't load element Mesh"); return NULL;
-			}
-
-			// Create mesh
-			tString sMeshFile = pMeshElem->GetAttributeString("Filename");
-			if(cString::GetFilePath(sMeshFile).size() < 1)
-			{
-				sMeshFile = cString::SetFilePath(sMeshFile, cString::To8Char(cString::GetFilePathW(asFullPath) ) );
-			}
-			//Log("Mesh: '%s'\n",sMeshFile.c_str());
-			mpMesh = apWorld->GetResources()->GetMeshManager()->CreateMesh(sMeshFile);
+			//Log("Mesh: '%s'\n",apPrototype->msMeshFile.c_str());
+			mpMesh = apWorld->GetResources()->GetMeshManager()->CreateMesh(apPrototype->msMeshFile);
 			if(mpMesh==NULL) return NULL;
 
 			//Create entity
@@ -376,20 +285,16 @@ namespace hpl {
 		// Load sub meshes
 		{
 			bool bHasSkeleton = mpMesh->GetSkeleton()!=NULL;
-			cXmlNodeListIterator submeshIt = pMeshElem->GetChildIterator();
-			while(submeshIt.HasNext())
+			for(size_t i=0; i<apPrototype->mvSubMeshes.size(); ++i)
 			{
-				cXmlElement *pSubMeshElem = submeshIt.Next()->ToElement();
+				const cEntityPrototypeSubMesh& subMesh = apPrototype->mvSubMeshes[i];
 
 				//////////////////////////
 				// Load the sub entity
-				tString sName = pSubMeshElem->GetAttributeString("Name");
-				//tString sMaterialFile = cString::ToString(pSubMeshElem->Attribute("MaterialFile"),"");
-
-				cSubMeshEntity *pSubEntity = mpEntity->GetSubMeshEntityName(sName);
+				cSubMeshEntity *pSubEntity = mpEntity->GetSubMeshEntityName(subMesh.msName);
 				if(pSubEntity==NULL)
 				{
-					Warning("Sub mesh '%s' does not exist in mesh '%s'!\n",sName.c_str(), mpMesh->GetName().c_str());
+					Warning("Sub mesh '%s' does not exist in mesh '%s'!\n",subMesh.msName.c_str(), mpMesh->GetName().c_str());
 					continue;
 				}
 				if(bHasSkeleton==false)
@@ -400,73 +305,42 @@ namespace hpl {
 				// Get transform matrix
 				if(bHasSkeleton==false)
 				{
-					cMatrixf mtxLocalTransform = GetMatrixFromVectors(	pSubMeshElem->GetAttributeVector3f("WorldPos")*mvScale,
-																		pSubMeshElem->GetAttributeVector3f("Rotation"),
-																		pSubMeshElem->GetAttributeVector3f("Scale")*mvScale);
-
-					//mtxLocalTransform = cMath::MatrixMul(mtxLocalTransform, cMath::MatrixScale(mvScale));
+					cMatrixf mtxLocalTransform = GetMatrixFromVectors(	subMesh.mvWorldPos*mvScale,
+																		subMesh.mvRotation,
+																		subMesh.mvScale*mvScale);
 
 					pSubEntity->SetWorldMatrix(mtxLocalTransform);
 				}
 
 				//////////////////////////
 				// Set the variables
-				int lID = pSubMeshElem->GetAttributeInt("ID",-1);
-				if(lID < 0) lID = pSubMeshElem->GetAttributeInt("SubMeshID"); //To support older files!
-
-				pSubEntity->SetUniqueID(lID);
-
-
-				//////////////////////////
-				// Set material
-				//TODO:
-				/*if(sMaterialFile != "")
-				{
-				cMaterial *pMaterial = apWorld->GetResources()->GetMaterialManager()->CreateMaterial(sMaterialFile);
-				if(pMaterial)
-				{
-				pSubEntity->SetCustomMaterial(pMaterial);
-				}
-				}*/
+				pSubEntity->SetUniqueID(subMesh.mlID);
 			}
 		}
 
 		////////////////////////////////////////
 		// Animations
-		cXmlElement *pAnimationsElem  = pModelDataElem->GetFirstElement("Animations");
-		if(mbLoadAnimations && mpEntity && pAnimationsElem)
+		if(mbLoadAnimations && mpEntity)
 		{
-			cXmlNodeListIterator animElemIt = pAnimationsElem->GetChildIterator();
-			while(animElemIt.HasNext())
+			for(size_t i=0; i<apPrototype->mvAnimations.size(); ++i)
 			{
-				cXmlElement *pAnimElem = animElemIt.Next()->ToElement();
-
-				tString sFile = pAnimElem->GetAttributeString("File");
-				tString sName = pAnimElem->GetAttributeString("Name");
-				float fSpeed = pAnimElem->GetAttributeFloat("Speed",1.0f);
-				float fSpecialEventTime = pAnimElem->GetAttributeFloat("SpecialEventTime",0.0f);
+				const cEntityPrototypeAnimation& anim = apPrototype->mvAnimations[i];
 
-				if(cString::GetFilePath(sFile).length() <= 1)
-					sFile = cString::SetFilePath(sFile, cString::To8Char(cString::GetFilePathW(asFullPath) ) );
-
-				cAnimation *pAnim = apWorld->GetResources()->GetAnimationManager()->CreateAnimation(sFile);
+				cAnimation *pAnim = apWorld->GetResources()->GetAnimationManager()->CreateAnimation(anim.msFile);
 
 				if(pAnim)
 				{
-					cAnimationState *pState = mpEntity->AddAnimation(pAnim, sName,fSpeed);
-					pState->SetSpecialEventTime(fSpecialEventTime);
+					cAnimationState *pState = mpEntity->AddAnimation(pAnim, anim.msName,anim.mfSpeed);
+					pState->SetSpecialEventTime(anim.mfSpecialEventTime);
 
 					///////////////////////////////
 					// Load events
-					cXmlNodeListIterator eventElemIt = pAnimElem->GetChildIterator();
-					while(eventElemIt.HasNext())
+					for(size_t j=0; j<anim.mvEvents.size(); ++j)
 					{
-						cXmlElement *pEventElem = eventElemIt.Next()->ToElement();
-
                         cAnimationEvent *pEvent = pState->CreateEvent();
-						pEvent->mfTime = pEventElem->GetAttributeFloat("Time");
-						pEvent->mType = ToAnimEventType(pEventElem->GetAttributeString("Type"));
-						pEvent->msValue = pEventElem->GetAttributeString("Value");
+						pEvent->mfTime = anim.mvEvents[j].mfTime;
+						pEvent->mType = anim.mvEvents[j].mType;
+						pEvent->msValue = anim.mvEvents[j].msValue;
 					}
 
 				}
@@ -480,80 +354,67 @@ namespace hpl {
 			//List that contain light and billboard connections
 			tEFL_LightBillboardConnectionList lstLightBillboardListConnections;
 
-            cXmlElement *pEntitiesElem  = pModelDataElem->GetFirstElement("Entities");
-			if(pEntitiesElem)
+			for(size_t i=0; i<apPrototype->mvObjects.size(); ++i)
 			{
-				////////////////////////
-				//Iterate entities
-				cXmlNodeListIterator entityIt = pEntitiesElem->GetChildIterator();
-				while(entityIt.HasNext())
-				{
-					cXmlElement *pEntityElem = entityIt.Next()->ToElement();
-					const tString& sEntityType = pEntityElem->GetValue();
-					iEntity3D *pEntity = NULL;
+				const cEntityPrototypeObject& object = apPrototype->mvObjects[i];
+				iEntity3D *pEntity = NULL;
 
-					/////////////////////////
-					// Particle System
-					if(sEntityType == "ParticleSystem")
-					{
-						if(mbLoadParticleSystems)
-						{
-							cParticleSystem *pPS = cEngineFileLoading::LoadParticleSystem(pEntityElem,asName +"_", apWorld);
-							if(pPS)	mvParticleSystems.push_back(pPS);
-							pEntity = pPS;
-						}
-					}
-					/////////////////////////
-					// Billboard
-					else if(sEntityType == "Billboard")
+				switch(object.mType)
+				{
+				/////////////////////////
+				// Particle System
+				case eEntityPrototypeObject_ParticleSystem:
+					if(mbLoadParticleSystems)
 					{
-						if(mbLoadBillboards)
-						{
-							cBillboard *pBillboard = cEngineFileLoading::LoadBillboard(pEntityElem,asName +"_", apWorld, apWorld->GetResources(), mbLoadAsStatic,
-																						&lstLightBillboardListConnections);
-							if(pBillboard)	mvBillboards.push_back(pBillboard);
-							pEntity = pBillboard;
-						}
+						cParticleSystem *pPS = cEngineFileLoading::LoadParticleSystem(object.mpElement,asName +"_", apWorld);
+						if(pPS)	mvParticleSystems.push_back(pPS);
+						pEntity = pPS;
 					}
-					/////////////////////////
-					// Sound
-					else if(sEntityType == "Sound")
+					break;
+				/////////////////////////
+				// Billboard
+				case eEntityPrototypeObject_Billboard:
+					if(mbLoadBillboards)
 					{
-						if(mbLoadSounds)
-						{
-							cSoundEntity *pSound = cEngineFileLoading::LoadSound(pEntityElem,asName +"_", apWorld);
-							if(pSound)	mvSoundEntities.push_back(pSound);
-							pEntity = pSound;
-						}
+						cBillboard *pBillboard = cEngineFileLoading::LoadBillboard(object.mpElement,asName +"_", apWorld, apWorld->GetResources(), mbLoadAsStatic,
+																					&lstLightBillboardListConnections);
+						if(pBillboard)	mvBillboards.push_back(pBillboard);
+						pEntity = pBillboard;
 					}
-                    /////////////////////////
-					// Light
-					else if(cString::GetLastStringPos(sEntityType,"Light")>0)
+					break;
+				/////////////////////////
+				// Sound
+				case eEntityPrototypeObject_Sound:
+					if(mbLoadSounds)
 					{
-						if(mbLoadLights)
-						{
-							iLight *pLight = cEngineFileLoading::LoadLight(pEntityElem,asName +"_", apWorld, apWorld->GetResources(),mbLoadAsStatic);
-							if(pLight)	mvLights.push_back(pLight);
-							pEntity = pLight;
-						}
+						cSoundEntity *pSound = cEngineFileLoading::LoadSound(object.mpElement,asName +"_", apWorld);
+						if(pSound)	mvSoundEntities.push_back(pSound);
+						pEntity = pSound;
 					}
-					/////////////////////////
-					// Unknown
-					else
+					break;
+                /////////////////////////
+				// Light
+				case eEntityPrototypeObject_Light:
+					if(mbLoadLights)
 					{
-						Error("Entity world entity type '%s' is unknown!\n", sEntityType.c_str());
+						iLight *pLight = cEngineFileLoading::LoadLight(object.mpElement,asName +"_", apWorld, apWorld->GetResources(),mbLoadAsStatic);
+						if(pLight)	mvLights.push_back(pLight);
+						pEntity = pLight;
 					}
+					break;
+				default:
+					break;
+				}
 
-					/////////////////////////
-					// Add to list and scale!
-					if(pEntity)
-					{
-						//Scale the local position accoringly!
-						cVector3f vPos = pEntity->GetLocalPosition();
-						pEntity->SetPosition(vPos * mvScale);
+				/////////////////////////
+				// Add to list and scale!
+				if(pEntity)
+				{
+					//Scale the local position accoringly!
+					cVector3f vPos = pEntity->GetLocalPosition();
+					pEntity->SetPosition(vPos * mvScale);
 
-						lstEntities.push_back(pEntity);
-					}
+					lstEntities.push_back(pEntity);
 				}
 			}
 
@@ -592,33 +453,23 @@ namespace hpl {
 		tNodeStateMap mapBoneStates;
 		if(mpMesh->GetSkeleton())
 		{
-			cXmlElement *pBonesElem  = pModelDataElem->GetFirstElement("Bones");
-			if(pBonesElem)
+			for(size_t i=0; i<apPrototype->mvBones.size(); ++i)
 			{
-				//////////////////////////
-				// Iterate bones
-				cXmlNodeListIterator boneIt = pBonesElem->GetChildIterator();
-				while(boneIt.HasNext())
-				{
-					cXmlElement *pBoneElem = boneIt.Next()->ToElement();
-
-					int lID = pBoneElem->GetAttributeInt("ID");
-					tString sName = pBoneElem->GetAttributeString("Name");
+				const cEntityPrototypeBone& bone = apPrototype->mvBones[i];
 
-					cBoneState *pBoneState = mpEntity->GetBoneStateFromName(sName);
-					if(pBoneState==NULL){
-						Error("Could not find bone '%s' in model '%s'\n", sName.c_str(), cString::To8Char(asFullPath).c_str());
-						continue;
-					}
+				cBoneState *pBoneState = mpEntity->GetBoneStateFromName(bone.msName);
+				if(pBoneState==NULL){
+					Error("Could not find bone '%s' in model '%s'\n", bone.msName.c_str(), cString::To8Char(asFullPath).c_str());
+					continue;
+				}
 
-					/////////////////////////////
-					//Add bones to list
-                    mapBoneStates.insert(tNodeStateMap::value_type(lID, pBoneState));
+				/////////////////////////////
+				//Add bones to list
+                mapBoneStates.insert(tNodeStateMap::value_type(bone.mlID, pBoneState));
 
-					/////////////////////////////
-					//Add children to bone
-					LoadAndAttachChildren(pBoneElem, NULL, pBoneState, lstTempEntities, mapBoneStates, true, false);
-				}
+				/////////////////////////////
+				//Add children to bone
+				LoadAndAttachChildren(bone.mvChildIDs, NULL, pBoneState, lstTempEntities, mapBoneStates, true, false);
 			}
 		}
 
@@ -630,20 +481,14 @@ namespace hpl {
 
 		if(pPhysicsWorld)
 		{
-			cXmlElement *pShapesElem  = pModelDataElem->GetFirstElement("Shapes");
-			if(pShapesElem)
+			for(size_t i=0; i<apPrototype->mvShapes.size(); ++i)
 			{
-				cXmlNodeListIterator shapeIt = pShapesElem->GetChildIterator();
-				while(shapeIt.HasNext())
-				{
-					cXmlElement *pBodyShapeElem = shapeIt.Next()->ToElement();
+				const cEntityPrototypeShape& shape = apPrototype->mvShapes[i];
 
-					iCollideShape *pCollideShape = CreateCollideShape(pBodyShapeElem, pPhysicsWorld, mvScale);
-					if(pCollideShape == NULL) continue;
-					int lID = pBodyShapeElem->GetAttributeInt("ID");
+				iCollideShape *pCollideShape = shape.Create(pPhysicsWorld, mvScale);
+				if(pCollideShape == NULL) continue;
 
-					setShapes.insert(tLoaderCollideShapeMap::value_type(lID, pCollideShape));
-				}
+				setShapes.insert(tLoaderCollideShapeMap::value_type(shape.mlID, pCollideShape));
 			}
 		}
 
@@ -655,50 +500,41 @@ namespace hpl {
 		if(pPhysicsWorld)
 		{
 			////////////////////////
-			//Iterate the bodies elements
-			cXmlElement *pBodiesElem  = pModelDataElem->GetFirstElement("Bodies");
-			if(pBodiesElem)
+			//Iterate the bodies
+			for(size_t i=0; i<apPrototype->mvBodies.size(); ++i)
 			{
-				cXmlNodeListIterator bodyIt = pBodiesElem->GetChildIterator();
-				while(bodyIt.HasNext())
-				{
-					/////////////////////
-					// Init
-					cXmlElement *pBodyElem = bodyIt.Next()->ToElement();
-					int lID = pBodyElem->GetAttributeInt("ID");
-					tString sBodyName = pBodyElem->GetAttributeString("Name");
-
-					/////////////////////
-					// Get shape
-					iCollideShape *pShape = GetBodyShape(pBodyElem,pPhysicsWorld,setShapes);
-					if(pShape==NULL){
-						Error("No shapes found for body '%s'\n", sBodyName.c_str());
-						continue;
-					}
+				const cEntityPrototypeBody& body = apPrototype->mvBodies[i];
 
-					/////////////////////
-					// Create body and set up properties
-					iPhysicsBody *pBody = pPhysicsWorld->CreateBody(asName +"_"+ sBodyName,pShape);
-					SetBodyProperties(pBody, pBodyElem);
+				/////////////////////
+				// Get shape
+				iCollideShape *pShape = GetBodyShape(body,pPhysicsWorld,setShapes);
+				if(pShape==NULL){
+					Error("No shapes found for body '%s'\n", body.msName.c_str());
+					continue;
+				}
 
-					//Material
-					iPhysicsMaterial *pPhysicsMat = pPhysicsWorld->GetMaterialFromName(pBodyElem->GetAttributeString("Material"));
-					if(pPhysicsMat) pBody->SetMaterial(pPhysicsMat);
+				/////////////////////
+				// Create body and set up properties
+				iPhysicsBody *pBody = pPhysicsWorld->CreateBody(asName +"_"+ body.msName,pShape);
+				body.SetProperties(pBody, mvScale);
 
-					setBodies.insert(tLoaderPhysicsBodyMap::value_type(lID, pBody));
-					mvBodies.push_back(pBody);
+				//Material
+				iPhysicsMaterial *pPhysicsMat = pPhysicsWorld->GetMaterialFromName(body.msMaterial);
+				if(pPhysicsMat) pBody->SetMaterial(pPhysicsMat);
 
-					/////////////////////
-					// Add extra properties
-					size_t lIdx = mvBodies.size() -1;
-					mvBodyExtraData.push_back(cEntityBodyExtraData());
+				setBodies.insert(tLoaderPhysicsBodyMap::value_type(body.mlID, pBody));
+				mvBodies.push_back(pBody);
 
-					mvBodyExtraData[lIdx].m_mtxLocalTransform = pBody->GetLocalMatrix();
+				/////////////////////
+				// Add extra properties
+				size_t lIdx = mvBodies.size() -1;
+				mvBodyExtraData.push_back(cEntityBodyExtraData());
 
-					/////////////////////
-					// Attach children
-					LoadAndAttachChildren(pBodyElem, pBody, NULL, lstTempEntities, mapBoneStates, true, true);
-				}
+				mvBodyExtraData[lIdx].m_mtxLocalTransform = pBody->GetLocalMatrix();
+
+				/////////////////////
+				// Attach children
+				LoadAndAttachChildren(body.mvChildIDs, pBody, NULL, lstTempEntities, mapBoneStates, true, true);
 			}
 
 			////////////////////////
@@ -710,7 +546,7 @@ namespace hpl {
 					Error("Loading entity %s: Skeletons in mesh file (%ls) and .ent file (%ls) differ! Probably caused by .ent not being up to date with mesh\n",
 						asName.c_str(),
 						mpMesh->GetFullPath().c_str(),
-						static_cast<iXmlDocument*>(apRootElem)->GetPath().c_str());
+						asFullPath.c_str());
 				}
 				else
 					lstTempEntities.push_back(mpEntity);
@@ -782,22 +618,16 @@ namespace hpl {
 		////////////////////////////////////////
 		// Load Joints
 		{
-			cXmlElement *JointsElem  = pModelDataElem->GetFirstElement("Joints");
-			if(JointsElem)
+			for(size_t i=0; i<apPrototype->mvJoints.size(); ++i)
 			{
-				cXmlNodeListIterator jointIt = JointsElem->GetChildIterator();
-				while(jointIt.HasNext())
-				{
-					cXmlElement *pJointElem = jointIt.Next()->ToElement();
-
+				const cEntityPrototypeJoint& joint = apPrototype->mvJoints[i];
 
-					iPhysicsJoint *pJoint = CreateJoint(asName,pJointElem,pPhysicsWorld,setBodies, a_mtxTransform, mvScale);
-					if(pJoint)
-					{
-						SetJointProperties(pJoint,pJointElem, apWorld);
+				iPhysicsJoint *pJoint = CreateJoint(asName,joint,pPhysicsWorld,setBodies, a_mtxTransform, mvScale);
+				if(pJoint)
+				{
+					joint.SetProperties(pJoint);
 
-						mvJoints.push_back(pJoint);
-					}
+					mvJoints.push_back(pJoint);
 				}
 			}
 		}
@@ -825,12 +655,16 @@ namespace hpl {
 
 		////////////////////////////////////////
 		// Load user variables();
-		LoadUserVariables(apRootElem);
+		LoadUserVariables(apPrototype);
 
 		// After load virtual call.
 		// This is where the user adds extra stuff.
 		AfterLoad(apRootElem,a_mtxTransform,apWorld,apInstanceVars);
 
+		cEntityLoadStats& loadStats = cEntityPrototype::GetLoadStats();
+		loadStats.mlInstancesCreated++;
+		loadStats.mfInstanceTime += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+
 		return mpEntity;
 	}
 
@@ -898,12 +732,11 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 
-	void cEntityLoader_Object::LoadAndAttachChildren(	cXmlElement *apMainElem, iEntity3D *apEntityParent, cBoneState *apBoneStateParent,
+	void cEntityLoader_Object::LoadAndAttachChildren(	const tIntVec& avChildIDs, iEntity3D *apEntityParent, cBoneState *apBoneStateParent,
 														tEntity3DList& a_lstChildList, tNodeStateMap &a_mapBoneStates,
 														bool abRemoveAttachedChild, bool abIsBody)
 	{
-		cXmlElement *pChildrenElem  = apMainElem->GetFirstElement("Children");
-		if(pChildrenElem==NULL) return;
+		if(avChildIDs.empty()) return;
 
 		cMatrixf mtxInvParent;
 		if(apEntityParent)
@@ -912,13 +745,10 @@ namespace hpl {
 			mtxInvParent = cMath::MatrixInverse(apBoneStateParent->GetWorldMatrix());
 
 		///////////////////////////////
-		//Iterate the children elements
-		cXmlNodeListIterator childIt = pChildrenElem->GetChildIterator();
-		while(childIt.HasNext())
+		//Iterate the children
+		for(size_t i=0; i<avChildIDs.size(); ++i)
 		{
-			cXmlElement *pChildElem = childIt.Next()->ToElement();
-
-			int lID = pChildElem->GetAttributeInt("ID");
+			int lID = avChildIDs[i];
 
 			//////////////////////////////////
 			// Search for child entity
@@ -1004,97 +834,6 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 
-	void cEntityLoader_Object::SetBodyProperties(iPhysicsBody *apBody, cXmlElement *apElem)
-	{
-		apBody->SetMatrix(GetMatrixFromVectors(	apElem->GetAttributeVector3f("WorldPos") * mvScale,
-												apElem->GetAttributeVector3f("Rotation"),
-												1.0f)
-												);
-
-		apBody->SetMass(apElem->GetAttributeFloat("Mass",1.0f));
-
-		apBody->SetAngularDamping(apElem->GetAttributeFloat("AngularDamping"));
-		apBody->SetLinearDamping(apElem->GetAttributeFloat("LinearDamping"));
-
-		apBody->SetBlocksSound(apElem->GetAttributeBool("BlocksSound",false));
-		apBody->SetCollideCharacter(apElem->GetAttributeBool("CollideCharacter",true));
-		apBody->SetCollide(apElem->GetAttributeBool("CollideNonCharacter",true));
-
-		apBody->SetGravity(apElem->GetAttributeBool("HasGravity",true));
-		apBody->SetBuoyancyDensityMul(apElem->GetAttributeFloat("BuoyancyDensityMul",1.0));
-
-		apBody->SetMaxAngularSpeed(apElem->GetAttributeFloat("MaxAngularSpeed",0));
-		apBody->SetMaxLinearSpeed(apElem->GetAttributeFloat("MaxLinearSpeed",0));
-
-		apBody->SetContinuousCollision(apElem->GetAttributeBool("ContinuousCollision",true));
-
-		apBody->SetPushedByCharacterGravity(apElem->GetAttributeBool("PushedByCharacterGravity",false));
-
-		apBody->SetVolatile(apElem->GetAttributeBool("Volatile",false));
-
-		apBody->SetUseSurfaceEffects(apElem->GetAttributeBool("UseSurfaceEffects",true));
-
-		apBody->SetGravityCanAttachCharacter(apElem->GetAttributeBool("CanAttachCharacter",false));
-
-		apBody->SetUniqueID(apElem->GetAttributeInt("ID",-1));
-	}
-
-	//-----------------------------------------------------------------------
-
-	void cEntityLoader_Object::SetJointProperties(iPhysicsJoint *pJoint, cXmlElement *apJointElem, cWorld *apWorld)
-	{
-		tString t = apJointElem->GetAttributeString("MoveSound","");
-		pJoint->SetMoveSound(t);
-		pJoint->SetMinMoveSpeed(apJointElem->GetAttributeFloat("MinMoveSpeed",0.5f));
-		pJoint->SetMinMoveFreq(apJointElem->GetAttributeFloat("MinMoveFreq",0.9f));
-		pJoint->SetMinMoveVolume(apJointElem->GetAttributeFloat("MinMoveVolume",0.3f));
-		pJoint->SetMinMoveFreqSpeed(apJointElem->GetAttributeFloat("MinMoveFreqSpeed",0.9f));
-		pJoint->SetMaxMoveFreq(apJointElem->GetAttributeFloat("MaxMoveFreq",1.1f));
-		pJoint->SetMaxMoveVolume(apJointElem->GetAttributeFloat("MaxMoveVolume",1.0f));
-		pJoint->SetMaxMoveFreqSpeed(apJointElem->GetAttributeFloat("MaxMoveFreqSpeed",1.1f));
-		pJoint->SetMiddleMoveSpeed(apJointElem->GetAttributeFloat("MiddleMoveSpeed",1.0f));
-		pJoint->SetMiddleMoveVolume(apJointElem->GetAttributeFloat("MiddleMoveVolume",1.0f));
-		pJoint->SetMoveSpeedType(cString::ToLowerCase(apJointElem->GetAttributeString("MoveType","Linear")) == "angular" ?
-									ePhysicsJointSpeed_Angular : 	ePhysicsJointSpeed_Linear);
-
-		pJoint->SetStickyMinLimit(apJointElem->GetAttributeBool("StickyMinLimit",false));
-		pJoint->SetStickyMaxLimit(apJointElem->GetAttributeBool("StickyMaxLimit",false));
-
-		pJoint->SetBreakable(apJointElem->GetAttributeBool("Breakable",false));
-		pJoint->SetBreakForce(apJointElem->GetAttributeFloat("BreakForce",1000));
-		pJoint->SetBreakSound(apJointElem->GetAttributeString("BreakSound",""));
-
-		pJoint->SetLimitAutoSleep(apJointElem->GetAttributeBool("LimitAutoSleep",false));
-		pJoint->SetLimitAutoSleepDist(apJointElem->GetAttributeFloat("LimitAutoSleepDist",0.02f));
-		pJoint->SetLimitAutoSleepNumSteps(apJointElem->GetAttributeInt("LimitAutoSleepNumSteps",10));
-
-		pJoint->SetCollideBodies(apJointElem->GetAttributeBool("CollideBodies",true));
-
-		pJoint->GetMaxLimit()->msSound = apJointElem->GetAttributeString("MaxLimitSound","");
-		pJoint->GetMaxLimit()->mfMaxSpeed = apJointElem->GetAttributeFloat("MaxLimitMaxSpeed",10.0f);
-		pJoint->GetMaxLimit()->mfMinSpeed = apJointElem->GetAttributeFloat("MaxLimit_MinSpeed",20.0f);
-		if(pJoint->GetMaxLimit()->mfMaxSpeed <=0) pJoint->GetMaxLimit()->mfMaxSpeed = 0.01f;
-
-		pJoint->GetMinLimit()->msSound = apJointElem->GetAttributeString("MinLimitSound","");
-		pJoint->GetMinLimit()->mfMaxSpeed = apJointElem->GetAttributeFloat("MinLimitMaxSpeed",10.0f);
-		pJoint->GetMinLimit()->mfMinSpeed = apJointElem->GetAttributeFloat("MinLimitMinSpeed",20.0f);
-		if(pJoint->GetMinLimit()->mfMaxSpeed <=0) pJoint->GetMaxLimit()->mfMaxSpeed = 0.01f;
-
-		pJoint->SetUniqueID(apJointElem->GetAttributeInt("ID",-1));
-
-
-		/////////////////////////////
-		//Load all controllers
-		//TODO!
-		/*TiXmlElement *pControllerElem = pJointElem->FirstChildElement("Controller");
-		for(; pControllerElem != NULL; pControllerElem = pControllerElem->NextSiblingElement("Controller"))
-		{
-			LoadController(pJoint,apWorld->GetPhysicsWorld(),pControllerElem);
-		}*/
-	}
-
-	//-----------------------------------------------------------------------
-
 	ePhysicsControllerType GetControllerType(const char* apString)
 	{
 		if(apString == NULL) return ePhysicsControllerType_LastEnum;
@@ -1254,18 +993,17 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 
-	void cEntityLoader_Object::LoadUserVariables(cXmlElement *apRootElem)
+	void cEntityLoader_Object::LoadUserVariables(const cEntityPrototype *apPrototype)
 	{
-		cXmlElement *pVarRootElem = apRootElem->GetFirstElement("UserDefinedVariables");
-		if(pVarRootElem==NULL){
+		if(apPrototype->mbHasUserVariables==false){
 			Warning("Can not find a use variable root element!\n");
 			return;
 		}
 
-		msEntityType = pVarRootElem->GetAttributeString("EntityType");
-		msEntitySubType = pVarRootElem->GetAttributeString("EntitySubType");
+		msEntityType = apPrototype->msEntityType;
+		msEntitySubType = apPrototype->msEntitySubType;
 
-		LoadVariables(pVarRootElem);
+		m_mapVars = apPrototype->m_mapUserVariables;
 	}
 
 	//-----------------------------------------------------------------------
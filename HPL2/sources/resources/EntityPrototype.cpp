@@ -0,0 +1,547 @@
+/*
+ * Copyright © 2009-2020 Frictional Games
+ *
+ * This file is part of Amnesia: The Dark Descent.
+ *
+ * Amnesia: The Dark Descent is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * Amnesia: The Dark Descent is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Amnesia: The Dark Descent.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "resources/EntityPrototype.h"
+
+#include "system/String.h"
+#include "system/LowLevelSystem.h"
+
+#include "physics/PhysicsWorld.h"
+#include "physics/PhysicsBody.h"
+#include "physics/PhysicsJoint.h"
+#include "physics/CollideShape.h"
+
+#include "math/Math.h"
+
+#include "resources/XmlDocument.h"
+
+#include <chrono>
+
+namespace hpl {
+
+	//////////////////////////////////////////////////////////////////////////
+	// STATIC DATA
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	cEntityLoadStats cEntityPrototype::mLoadStats;
+
+	//-----------------------------------------------------------------------
+
+	static eCollideShapeType ToCollideShape(const tString& asType)
+	{
+		tString sLowType = cString::ToLowerCase(asType);
+
+		if(sLowType == "box") return eCollideShapeType_Box;
+		if(sLowType == "cylinder") return eCollideShapeType_Cylinder;
+		if(sLowType == "sphere") return eCollideShapeType_Sphere;
+		if(sLowType == "capsule") return eCollideShapeType_Capsule;
+
+		Error("CollideShape '%s' does not exist!\n", asType.c_str());
+
+		return eCollideShapeType_Null;
+	}
+
+	//-----------------------------------------------------------------------
+
+	static ePhysicsJointType ToJointType(const tString& asType)
+	{
+		tString sLowType = cString::ToLowerCase(asType);
+
+        if(sLowType == "jointhinge")	return ePhysicsJointType_Hinge;
+		if(sLowType == "jointball")		return ePhysicsJointType_Ball;
+		if(sLowType == "jointslider")	return ePhysicsJointType_Slider;
+		if(sLowType == "joinscrew")		return ePhysicsJointType_Screw;
+
+		Error("Joint type '%s' does not exist!\n", asType.c_str());
+
+		return ePhysicsJointType_Ball;
+	}
+
+	//-----------------------------------------------------------------------
+
+	static eAnimationEventType ToAnimEventType(const tString& asType)
+	{
+		tString sLowType = cString::ToLowerCase(asType);
+
+        if(sLowType == "playsound")	return eAnimationEventType_PlaySound;
+		if(sLowType == "step")		return eAnimationEventType_Step;
+
+		Error("No animation event named '%s'\n", asType.c_str());
+		return eAnimationEventType_LastEnum;
+	}
+
+	//-----------------------------------------------------------------------
+
+	static tString GetFileRelativeToEntity(const tString& asFile, const tWString& asFullPath)
+	{
+		if(cString::GetFilePath(asFile).length() > 1) return asFile;
+
+		return cString::SetFilePath(asFile, cString::To8Char(cString::GetFilePathW(asFullPath)));
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// SHAPE, BODY AND JOINT
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	iCollideShape* cEntityPrototypeShape::Create(iPhysicsWorld *apPhysicsWorld, const cVector3f& avScale) const
+	{
+		cVector3f vSize = mvSize * avScale;
+
+		cMatrixf mtxOffset = cMath::MatrixRotate(mvRotation,eEulerRotationOrder_XYZ);
+		mtxOffset.SetTranslation(mvOffset * avScale);
+
+		switch(mType)
+		{
+		case eCollideShapeType_Box:
+			return apPhysicsWorld->CreateBoxShape(vSize,&mtxOffset);
+		case eCollideShapeType_Sphere:
+			return apPhysicsWorld->CreateSphereShape(vSize,&mtxOffset);
+		case eCollideShapeType_Cylinder:
+			mtxOffset = cMath::MatrixMul(mtxOffset, cMath::MatrixRotateZ(kPi2f));
+			return apPhysicsWorld->CreateCylinderShape(vSize.x,vSize.y,&mtxOffset);
+		case eCollideShapeType_Capsule:
+			mtxOffset = cMath::MatrixMul(mtxOffset, cMath::MatrixRotateZ(kPi2f));
+			return apPhysicsWorld->CreateCapsuleShape(vSize.x,vSize.y,&mtxOffset);
+		default:
+			break;
+		}
+
+		return NULL;
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cEntityPrototypeBody::SetProperties(iPhysicsBody *apBody, const cVector3f& avScale) const
+	{
+		cMatrixf mtxBody = cMath::MatrixRotate(mvRotation, eEulerRotationOrder_XYZ);
+		mtxBody.SetTranslation(mvWorldPos * avScale);
+		apBody->SetMatrix(mtxBody);
+
+		apBody->SetMass(mfMass);
+
+		apBody->SetAngularDamping(mfAngularDamping);
+		apBody->SetLinearDamping(mfLinearDamping);
+
+		apBody->SetBlocksSound(mbBlocksSound);
+		apBody->SetCollideCharacter(mbCollideCharacter);
+		apBody->SetCollide(mbCollideNonCharacter);
+
+		apBody->SetGravity(mbHasGravity);
+		apBody->SetBuoyancyDensityMul(mfBuoyancyDensityMul);
+
+		apBody->SetMaxAngularSpeed(mfMaxAngularSpeed);
+		apBody->SetMaxLinearSpeed(mfMaxLinearSpeed);
+
+		apBody->SetContinuousCollision(mbContinuousCollision);
+
+		apBody->SetPushedByCharacterGravity(mbPushedByCharacterGravity);
+
+		apBody->SetVolatile(mbVolatile);
+
+		apBody->SetUseSurfaceEffects(mbUseSurfaceEffects);
+
+		apBody->SetGravityCanAttachCharacter(mbCanAttachCharacter);
+
+		apBody->SetUniqueID(mlID);
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cEntityPrototypeJoint::SetProperties(iPhysicsJoint *apJoint) const
+	{
+		apJoint->SetMoveSound(msMoveSound);
+		apJoint->SetMinMoveSpeed(mfMinMoveSpeed);
+		apJoint->SetMinMoveFreq(mfMinMoveFreq);
+		apJoint->SetMinMoveVolume(mfMinMoveVolume);
+		apJoint->SetMinMoveFreqSpeed(mfMinMoveFreqSpeed);
+		apJoint->SetMaxMoveFreq(mfMaxMoveFreq);
+		apJoint->SetMaxMoveVolume(mfMaxMoveVolume);
+		apJoint->SetMaxMoveFreqSpeed(mfMaxMoveFreqSpeed);
+		apJoint->SetMiddleMoveSpeed(mfMiddleMoveSpeed);
+		apJoint->SetMiddleMoveVolume(mfMiddleMoveVolume);
+		apJoint->SetMoveSpeedType(mMoveSpeedType);
+
+		apJoint->SetStickyMinLimit(mbStickyMinLimit);
+		apJoint->SetStickyMaxLimit(mbStickyMaxLimit);
+
+		apJoint->SetBreakable(mbBreakable);
+		apJoint->SetBreakForce(mfBreakForce);
+		apJoint->SetBreakSound(msBreakSound);
+
+		apJoint->SetLimitAutoSleep(mbLimitAutoSleep);
+		apJoint->SetLimitAutoSleepDist(mfLimitAutoSleepDist);
+		apJoint->SetLimitAutoSleepNumSteps(mlLimitAutoSleepNumSteps);
+
+		apJoint->SetCollideBodies(mbCollideBodies);
+
+		apJoint->GetMaxLimit()->msSound = msMaxLimitSound;
+		apJoint->GetMaxLimit()->mfMaxSpeed = mfMaxLimitMaxSpeed;
+		apJoint->GetMaxLimit()->mfMinSpeed = mfMaxLimitMinSpeed;
+		if(apJoint->GetMaxLimit()->mfMaxSpeed <=0) apJoint->GetMaxLimit()->mfMaxSpeed = 0.01f;
+
+		apJoint->GetMinLimit()->msSound = msMinLimitSound;
+		apJoint->GetMinLimit()->mfMaxSpeed = mfMinLimitMaxSpeed;
+		apJoint->GetMinLimit()->mfMinSpeed = mfMinLimitMinSpeed;
+		if(apJoint->GetMinLimit()->mfMaxSpeed <=0) apJoint->GetMaxLimit()->mfMaxSpeed = 0.01f;
+
+		apJoint->SetUniqueID(mlID);
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// CONSTRUCTORS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	cEntityPrototype::cEntityPrototype()
+	{
+		mbValid = false;
+		mbHasUserVariables = false;
+	}
+
+	cEntityPrototype::~cEntityPrototype()
+	{
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// PUBLIC METHODS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	bool cEntityPrototype::Compile(cXmlElement *apRootElem, const tWString& asFullPath)
+	{
+		std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+		mbValid = false;
+
+		////////////////////////////////////////
+		// User variables
+		cXmlElement *pVarRootElem = apRootElem->GetFirstElement("UserDefinedVariables");
+		mbHasUserVariables = pVarRootElem != NULL;
+		if(pVarRootElem)
+		{
+			msEntityType = pVarRootElem->GetAttributeString("EntityType");
+			msEntitySubType = pVarRootElem->GetAttributeString("EntitySubType");
+
+			cXmlNodeListIterator varIt = pVarRootElem->GetChildIterator();
+			while(varIt.HasNext())
+			{
+				cXmlElement *pVarElem = varIt.Next()->ToElement();
+				m_mapUserVariables.insert(tResourceVarMap::value_type(pVarElem->GetAttributeString("Name"), pVarElem->GetAttributeString("Value")));
+			}
+		}
+
+		////////////////////////////////////////
+		// Model data and mesh
+		cXmlElement* pModelDataElem = apRootElem->GetFirstElement("ModelData");
+		if(pModelDataElem==NULL){
+			Error("Couldn't load element ModelData"); return false;
+		}
+
+		cXmlElement *pMeshElem = pModelDataElem->GetFirstElement("Mesh");
+		if(pMeshElem==NULL){
+			Error("Couldn't load element Mesh"); return false;
+		}
+
+		msMeshFile = pMeshElem->GetAttributeString("Filename");
+		if(cString::GetFilePath(msMeshFile).size() < 1)
+		{
+			msMeshFile = cString::SetFilePath(msMeshFile, cString::To8Char(cString::GetFilePathW(asFullPath) ) );
+		}
+
+		////////////////////////////////////////
+		// Sub meshes
+		cXmlNodeListIterator submeshIt = pMeshElem->GetChildIterator();
+		while(submeshIt.HasNext())
+		{
+			cXmlElement *pSubMeshElem = submeshIt.Next()->ToElement();
+
+			cEntityPrototypeSubMesh subMesh;
+			subMesh.msName = pSubMeshElem->GetAttributeString("Name");
+			subMesh.mvWorldPos = pSubMeshElem->GetAttributeVector3f("WorldPos");
+			subMesh.mvRotation = pSubMeshElem->GetAttributeVector3f("Rotation");
+			subMesh.mvScale = pSubMeshElem->GetAttributeVector3f("Scale");
+
+			subMesh.mlID = pSubMeshElem->GetAttributeInt("ID",-1);
+			if(subMesh.mlID < 0) subMesh.mlID = pSubMeshElem->GetAttributeInt("SubMeshID"); //To support older files!
+
+			mvSubMeshes.push_back(subMesh);
+		}
+
+		////////////////////////////////////////
+		// Animations
+		cXmlElement *pAnimationsElem  = pModelDataElem->GetFirstElement("Animations");
+		if(pAnimationsElem)
+		{
+			cXmlNodeListIterator animElemIt = pAnimationsElem->GetChildIterator();
+			while(animElemIt.HasNext())
+			{
+				cXmlElement *pAnimElem = animElemIt.Next()->ToElement();
+
+				mvAnimations.push_back(cEntityPrototypeAnimation());
+				cEntityPrototypeAnimation& anim = mvAnimations.back();
+
+				anim.msFile = GetFileRelativeToEntity(pAnimElem->GetAttributeString("File"), asFullPath);
+				anim.msName = pAnimElem->GetAttributeString("Name");
+				anim.mfSpeed = pAnimElem->GetAttributeFloat("Speed",1.0f);
+				anim.mfSpecialEventTime = pAnimElem->GetAttributeFloat("SpecialEventTime",0.0f);
+
+				cXmlNodeListIterator eventElemIt = pAnimElem->GetChildIterator();
+				while(eventElemIt.HasNext())
+				{
+					cXmlElement *pEventElem = eventElemIt.Next()->ToElement();
+
+					cEntityPrototypeAnimEvent event;
+					event.mfTime = pEventElem->GetAttributeFloat("Time");
+					event.mType = ToAnimEventType(pEventElem->GetAttributeString("Type"));
+					event.msValue = pEventElem->GetAttributeString("Value");
+					anim.mvEvents.push_back(event);
+				}
+			}
+		}
+
+		////////////////////////////////////////
+		// Particle systems, billboards, sounds and lights
+		cXmlElement *pEntitiesElem  = pModelDataElem->GetFirstElement("Entities");
+		if(pEntitiesElem)
+		{
+			cXmlNodeListIterator entityIt = pEntitiesElem->GetChildIterator();
+			while(entityIt.HasNext())
+			{
+				cXmlElement *pEntityElem = entityIt.Next()->ToElement();
+				const tString& sEntityType = pEntityElem->GetValue();
+
+				cEntityPrototypeObject object;
+				object.mpElement = pEntityElem;
+
+				if(sEntityType == "ParticleSystem")							object.mType = eEntityPrototypeObject_ParticleSystem;
+				else if(sEntityType == "Billboard")							object.mType = eEntityPrototypeObject_Billboard;
+				else if(sEntityType == "Sound")								object.mType = eEntityPrototypeObject_Sound;
+				else if(cString::GetLastStringPos(sEntityType,"Light")>0)	object.mType = eEntityPrototypeObject_Light;
+				else
+				{
+					Error("Entity world entity type '%s' is unknown!\n", sEntityType.c_str());
+					continue;
+				}
+
+				mvObjects.push_back(object);
+			}
+		}
+
+		////////////////////////////////////////
+		// Bones
+		cXmlElement *pBonesElem  = pModelDataElem->GetFirstElement("Bones");
+		if(pBonesElem)
+		{
+			cXmlNodeListIterator boneIt = pBonesElem->GetChildIterator();
+			while(boneIt.HasNext())
+			{
+				cXmlElement *pBoneElem = boneIt.Next()->ToElement();
+
+				mvBones.push_back(cEntityPrototypeBone());
+				cEntityPrototypeBone& bone = mvBones.back();
+
+				bone.mlID = pBoneElem->GetAttributeInt("ID");
+				bone.msName = pBoneElem->GetAttributeString("Name");
+				CompileChildIDs(pBoneElem, bone.mvChildIDs);
+			}
+		}
+
+		////////////////////////////////////////
+		// Shapes
+		cXmlElement *pShapesElem  = pModelDataElem->GetFirstElement("Shapes");
+		if(pShapesElem)
+		{
+			cXmlNodeListIterator shapeIt = pShapesElem->GetChildIterator();
+			while(shapeIt.HasNext())
+			{
+				cXmlElement *pShapeElem = shapeIt.Next()->ToElement();
+
+				cEntityPrototypeShape shape;
+				shape.mlID = pShapeElem->GetAttributeInt("ID");
+				shape.mType = ToCollideShape(pShapeElem->GetAttributeString("ShapeType"));
+				shape.mvSize = pShapeElem->GetAttributeVector3f("Scale");
+				shape.mvOffset = pShapeElem->GetAttributeVector3f("RelativeTranslation");
+				shape.mvRotation = pShapeElem->GetAttributeVector3f("RelativeRotation");
+
+				mvShapes.push_back(shape);
+			}
+		}
+
+		////////////////////////////////////////
+		// Bodies
+		cXmlElement *pBodiesElem  = pModelDataElem->GetFirstElement("Bodies");
+		if(pBodiesElem)
+		{
+			cXmlNodeListIterator bodyIt = pBodiesElem->GetChildIterator();
+			while(bodyIt.HasNext())
+			{
+				cXmlElement *pBodyElem = bodyIt.Next()->ToElement();
+
+				mvBodies.push_back(cEntityPrototypeBody());
+				cEntityPrototypeBody& body = mvBodies.back();
+
+				body.mlID = pBodyElem->GetAttributeInt("ID",-1);
+				body.msName = pBodyElem->GetAttributeString("Name");
+				body.msMaterial = pBodyElem->GetAttributeString("Material");
+
+				//Every child element that has an id is matched against the shapes, like it has always been.
+				cXmlNodeListIterator boundShapeIt = pBodyElem->GetChildIterator();
+				while(boundShapeIt.HasNext())
+				{
+					body.mvShapeIDs.push_back(boundShapeIt.Next()->ToElement()->GetAttributeInt("ID"));
+				}
+				CompileChildIDs(pBodyElem, body.mvChildIDs);
+
+				body.mvWorldPos = pBodyElem->GetAttributeVector3f("WorldPos");
+				body.mvRotation = pBodyElem->GetAttributeVector3f("Rotation");
+
+				body.mfMass = pBodyElem->GetAttributeFloat("Mass",1.0f);
+				body.mfAngularDamping = pBodyElem->GetAttributeFloat("AngularDamping");
+				body.mfLinearDamping = pBodyElem->GetAttributeFloat("LinearDamping");
+				body.mfBuoyancyDensityMul = pBodyElem->GetAttributeFloat("BuoyancyDensityMul",1.0);
+				body.mfMaxAngularSpeed = pBodyElem->GetAttributeFloat("MaxAngularSpeed",0);
+				body.mfMaxLinearSpeed = pBodyElem->GetAttributeFloat("MaxLinearSpeed",0);
+
+				body.mbBlocksSound = pBodyElem->GetAttributeBool("BlocksSound",false);
+				body.mbCollideCharacter = pBodyElem->GetAttributeBool("CollideCharacter",true);
+				body.mbCollideNonCharacter = pBodyElem->GetAttributeBool("CollideNonCharacter",true);
+				body.mbHasGravity = pBodyElem->GetAttributeBool("HasGravity",true);
+				body.mbContinuousCollision = pBodyElem->GetAttributeBool("ContinuousCollision",true);
+				body.mbPushedByCharacterGravity = pBodyElem->GetAttributeBool("PushedByCharacterGravity",false);
+				body.mbVolatile = pBodyElem->GetAttributeBool("Volatile",false);
+				body.mbUseSurfaceEffects = pBodyElem->GetAttributeBool("UseSurfaceEffects",true);
+				body.mbCanAttachCharacter = pBodyElem->GetAttributeBool("CanAttachCharacter",false);
+			}
+		}
+
+		////////////////////////////////////////
+		// Joints
+		cXmlElement *pJointsElem  = pModelDataElem->GetFirstElement("Joints");
+		if(pJointsElem)
+		{
+			cXmlNodeListIterator jointIt = pJointsElem->GetChildIterator();
+			while(jointIt.HasNext())
+			{
+				cXmlElement *pJointElem = jointIt.Next()->ToElement();
+
+				mvJoints.push_back(cEntityPrototypeJoint());
+				cEntityPrototypeJoint& joint = mvJoints.back();
+
+				joint.mType = ToJointType(pJointElem->GetValue());
+				joint.msName = pJointElem->GetAttributeString("Name");
+				joint.mvWorldPos = pJointElem->GetAttributeVector3f("WorldPos");
+				joint.mvPinDir = pJointElem->GetAttributeVector3f("PinDir");
+				joint.mlParentID = pJointElem->GetAttributeInt("ConnectedParentBodyID");
+				joint.mlChildID = pJointElem->GetAttributeInt("ConnectedChildBodyID");
+
+				switch(joint.mType)
+				{
+				case ePhysicsJointType_Hinge:
+					joint.mfMinLimit = cMath::ToRad(pJointElem->GetAttributeFloat("MinAngle"));
+					joint.mfMaxLimit = cMath::ToRad(pJointElem->GetAttributeFloat("MaxAngle"));
+					break;
+				case ePhysicsJointType_Ball:
+					joint.mfMinLimit = cMath::ToRad(pJointElem->GetAttributeFloat("MaxConeAngle"));
+					joint.mfMaxLimit = cMath::ToRad(pJointElem->GetAttributeFloat("MaxTwistAngle"));
+					break;
+				default:
+					joint.mfMinLimit = pJointElem->GetAttributeFloat("MinDistance");
+					joint.mfMaxLimit = pJointElem->GetAttributeFloat("MaxDistance");
+					break;
+				}
+
+				joint.msMoveSound = pJointElem->GetAttributeString("MoveSound","");
+				joint.mfMinMoveSpeed = pJointElem->GetAttributeFloat("MinMoveSpeed",0.5f);
+				joint.mfMinMoveFreq = pJointElem->GetAttributeFloat("MinMoveFreq",0.9f);
+				joint.mfMinMoveVolume = pJointElem->GetAttributeFloat("MinMoveVolume",0.3f);
+				joint.mfMinMoveFreqSpeed = pJointElem->GetAttributeFloat("MinMoveFreqSpeed",0.9f);
+				joint.mfMaxMoveFreq = pJointElem->GetAttributeFloat("MaxMoveFreq",1.1f);
+				joint.mfMaxMoveVolume = pJointElem->GetAttributeFloat("MaxMoveVolume",1.0f);
+				joint.mfMaxMoveFreqSpeed = pJointElem->GetAttributeFloat("MaxMoveFreqSpeed",1.1f);
+				joint.mfMiddleMoveSpeed = pJointElem->GetAttributeFloat("MiddleMoveSpeed",1.0f);
+				joint.mfMiddleMoveVolume = pJointElem->GetAttributeFloat("MiddleMoveVolume",1.0f);
+				joint.mMoveSpeedType = cString::ToLowerCase(pJointElem->GetAttributeString("MoveType","Linear")) == "angular" ?
+											ePhysicsJointSpeed_Angular : 	ePhysicsJointSpeed_Linear;
+
+				joint.mbStickyMinLimit = pJointElem->GetAttributeBool("StickyMinLimit",false);
+				joint.mbStickyMaxLimit = pJointElem->GetAttributeBool("StickyMaxLimit",false);
+
+				joint.mbBreakable = pJointElem->GetAttributeBool("Breakable",false);
+				joint.mfBreakForce = pJointElem->GetAttributeFloat("BreakForce",1000);
+				joint.msBreakSound = pJointElem->GetAttributeString("BreakSound","");
+
+				joint.mbLimitAutoSleep = pJointElem->GetAttributeBool("LimitAutoSleep",false);
+				joint.mfLimitAutoSleepDist = pJointElem->GetAttributeFloat("LimitAutoSleepDist",0.02f);
+				joint.mlLimitAutoSleepNumSteps = pJointElem->GetAttributeInt("LimitAutoSleepNumSteps",10);
+
+				joint.mbCollideBodies = pJointElem->GetAttributeBool("CollideBodies",true);
+
+				joint.msMaxLimitSound = pJointElem->GetAttributeString("MaxLimitSound","");
+				joint.mfMaxLimitMaxSpeed = pJointElem->GetAttributeFloat("MaxLimitMaxSpeed",10.0f);
+				joint.mfMaxLimitMinSpeed = pJointElem->GetAttributeFloat("MaxLimit_MinSpeed",20.0f);
+				joint.msMinLimitSound = pJointElem->GetAttributeString("MinLimitSound","");
+				joint.mfMinLimitMaxSpeed = pJointElem->GetAttributeFloat("MinLimitMaxSpeed",10.0f);
+				joint.mfMinLimitMinSpeed = pJointElem->GetAttributeFloat("MinLimitMinSpeed",20.0f);
+
+				joint.mlID = pJointElem->GetAttributeInt("ID",-1);
+			}
+		}
+
+		mbValid = true;
+
+		mLoadStats.mlPrototypesCompiled++;
+		mLoadStats.mfCompileTime += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+
+		return true;
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// PRIVATE METHODS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	void cEntityPrototype::CompileChildIDs(cXmlElement *apMainElem, tIntVec& avChildIDs)
+	{
+		cXmlElement *pChildrenElem  = apMainElem->GetFirstElement("Children");
+		if(pChildrenElem==NULL) return;
+
+		cXmlNodeListIterator childIt = pChildrenElem->GetChildIterator();
+		while(childIt.HasNext())
+		{
+			avChildIDs.push_back(childIt.Next()->ToElement()->GetAttributeInt("ID"));
+		}
+	}
+
+	//-----------------------------------------------------------------------
+}
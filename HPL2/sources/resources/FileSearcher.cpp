@@ -71,62 +71,26 @@ namespace hpl {
 
 	void cFileSearcher::AddDirectory(const tWString& asSearchPath, const tString &asMask, bool abAddSubDirectories)
 	{
-		//Make the path with only "/" and lower case.
-		tWString sPath = cString::ReplaceCharToW(asSearchPath,_W("\\"),_W("/"));
-
-		///////////////////////////////
-		//Add all files in directory
-		tWStringList lstFileNames;
-
-		cPlatform::FindFilesInDir(lstFileNames,sPath, cString::To16Char(asMask));
-
-		for(tWStringListIt it = lstFileNames.begin();it!=lstFileNames.end();it++)
-		{
-			tWString& sFile = *it;
-			tString sLowFile = cString::ToLowerCase(cString::To8Char(sFile));
-			tWString sFilePath = cString::ReplaceCharToW( cPlatform::GetFullFilePath( cString::SetFilePathW(sFile,sPath)), _W("\\"),_W("/"));;
-
-			//Check if file and path already exist
-			tFilePathMapIt pathIt = m_mapFiles.find(sLowFile);
-			if(pathIt != m_mapFiles.end() && pathIt->second.msPath == sFilePath)
-			{
-				continue;
-			}
-
-			//Add file
-			//Log("Adding lowercase file: '%s' with path: '%s'\n 8bitHash: %u 16bitHash %u\n", sLowFile.c_str(), cString::To8Char(sFilePath).c_str(),
-			//	cString::GetHash(cString::To8Char(sFilePath)), cString::GetHashW(sFilePath));
-			m_mapFiles.insert(tFilePathMap::value_type(sLowFile, cFileSearcherEntry(sFilePath) ));
-		}
-
-		//////////////////////////////////
-		//Search sub directories if set.
-		if(abAddSubDirectories)
-		{
-			tWStringList lstDirNames;
-			cPlatform::FindFoldersInDir(lstDirNames,sPath,false);
-
-			for(tWStringListIt it = lstDirNames.begin();it!=lstDirNames.end();it++)
-			{
-				tWString sNewPath = cString::SetFilePathW(*it, sPath);
-
-				AddDirectory(sNewPath,asMask,true);
-			}
-		}
+		std::unique_lock<std::shared_mutex> lock(m_mutex);
+		AddDirectoryFiles(asSearchPath, asMask, abAddSubDirectories);
 	}
 
 	//-----------------------------------------------------------------------
 
 	void cFileSearcher::ClearDirectories()
 	{
+		std::unique_lock<std::shared_mutex> lock(m_mutex);
 		m_mapFiles.clear();
 		m_setLoadedDirs.clear();
+		m_mapCookedFiles.clear();
 	}
 
 	//-----------------------------------------------------------------------
 
 	const tWString& cFileSearcher::GetFilePath(const tString& asFileNameAndPath, int *apEqualCount)
 	{
+		std::shared_lock<std::shared_mutex> lock(m_mutex);
+
 		tString sFile = cString::GetFileName(asFileNameAndPath);
 		tString sLowName = cString::ToLowerCase(sFile);
 
@@ -212,4 +176,99 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 
+	void cFileSearcher::AddCookedFile(const tWString& asSourcePath, const tWString& asCookedPath)
+	{
+		if(cPlatform::FileExists(asCookedPath)==false) return;
+
+		//Keys use the same full path form as the files added from directories.
+		tWString sSource = cString::ToLowerCaseW(cString::ReplaceCharToW(cPlatform::GetFullFilePath(asSourcePath), _W("\\"),_W("/")));
+		tWString sCooked = cString::ReplaceCharToW(cPlatform::GetFullFilePath(asCookedPath), _W("\\"),_W("/"));
+
+		std::unique_lock<std::shared_mutex> lock(m_mutex);
+		m_mapCookedFiles[sSource] = sCooked;
+	}
+
+	//-----------------------------------------------------------------------
+
+	tWString cFileSearcher::GetCookedFilePath(const tWString& asFilePath)
+	{
+		std::shared_lock<std::shared_mutex> lock(m_mutex);
+		if(m_mapCookedFiles.empty()) return asFilePath;
+
+		std::map<tWString, tWString>::iterator it = m_mapCookedFiles.find(cString::ToLowerCaseW(asFilePath));
+		if(it == m_mapCookedFiles.end()) return asFilePath;
+
+		return it->second;
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cFileSearcher::GetFilesWithExt(tWStringVec &avFiles, const tString& asExt)
+	{
+		std::shared_lock<std::shared_mutex> lock(m_mutex);
+
+		//The keys are lower case file names
+		tString sLowExt = cString::ToLowerCase(asExt);
+		for(tFilePathMapIt it = m_mapFiles.begin(); it != m_mapFiles.end(); ++it)
+		{
+			if(cString::GetFileExt(it->first) == sLowExt) avFiles.push_back(it->second.msPath);
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// PRIVATE METHODS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	void cFileSearcher::AddDirectoryFiles(const tWString& asSearchPath, const tString &asMask, bool abAddSubDirectories)
+	{
+		//Make the path with only "/" and lower case.
+		tWString sPath = cString::ReplaceCharToW(asSearchPath,_W("\\"),_W("/"));
+
+		///////////////////////////////
+		//Add all files in directory
+		tWStringList lstFileNames;
+
+		cPlatform::FindFilesInDir(lstFileNames,sPath, cString::To16Char(asMask));
+
+		for(tWStringListIt it = lstFileNames.begin();it!=lstFileNames.end();it++)
+		{
+			tWString& sFile = *it;
+			tString sLowFile = cString::ToLowerCase(cString::To8Char(sFile));
+			tWString sFilePath = cString::ReplaceCharToW( cPlatform::GetFullFilePath( cString::SetFilePathW(sFile,sPath)), _W("\\"),_W("/"));;
+
+			//Check if file and path already exist
+			tFilePathMapIt pathIt = m_mapFiles.find(sLowFile);
+			if(pathIt != m_mapFiles.end() && pathIt->second.msPath == sFilePath)
+			{
+				continue;
+			}
+
+			//Add file
+			//Log("Adding lowercase file: '%s' with path: '%s'\n 8bitHash: %u 16bitHash %u\n", sLowFile.c_str(), cString::To8Char(sFilePath).c_str(),
+			//	cString::GetHash(cString::To8Char(sFilePath)), cString::GetHashW(sFilePath));
+			m_mapFiles.insert(tFilePathMap::value_type(sLowFile, cFileSearcherEntry(sFilePath) ));
+		}
+
+		//////////////////////////////////
+		//Search sub directories if set.
+		if(abAddSubDirectories)
+		{
+			tWStringList lstDirNames;
+			cPlatform::FindFoldersInDir(lstDirNames,sPath,false);
+
+			for(tWStringListIt it = lstDirNames.begin();it!=lstDirNames.end();it++)
+			{
+				tWString sNewPath = cString::SetFilePathW(*it, sPath);
+
+				AddDirectoryFiles(sNewPath,asMask,true);
+			}
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
 }
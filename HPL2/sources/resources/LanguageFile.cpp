@@ -257,6 +257,11 @@ namespace hpl {
 					Warning("Language entry '%s' in category '%s' already exists!\n",sEntryName.c_str(), sCatName.c_str());
 					hplDelete(pEntry);
 				}
+				else
+				{
+					pEntry->mlId = GetEntryId(sCatName, sEntryName);
+					mvEntries[pEntry->mlId] = pEntry;
+				}
 			}
 		}
 
@@ -286,36 +291,133 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 
+	void cLanguageFile::Clear()
+	{
+		STLMapDeleteAll(m_mapCategories);
+
+		for(size_t i=0; i<mvEntries.size(); ++i) mvEntries[i] = NULL;
+	}
+
+	//-----------------------------------------------------------------------
+
 	const tWString& cLanguageFile::Translate(const tString& asCat, const tString& asName)
 	{
-		tLanguageCategoryMapIt CatIt = m_mapCategories.find(asCat);
-		if(CatIt == m_mapCategories.end())
+		tLanguageEntryId lId = FindEntryId(asCat, asName);
+		if(lId == kLanguageEntryId_None || mvEntries[lId]==NULL)
 		{
-			Warning("Could not find language file category '%s'\n",asCat.c_str());
+			Warning("Could not find language file entry '%s' in category '%s'\n",asName.c_str(), asCat.c_str());
 			return mwsEmpty;
 		}
 
-        cLanguageCategory *pCategory = CatIt->second;
-		tLanguageEntryMapIt EntryIt = pCategory->m_mapEntries.find(asName);
-		if(EntryIt == pCategory->m_mapEntries.end())
+		return mvEntries[lId]->mwsText;
+	}
+
+	const tWString& cLanguageFile::Translate(tLanguageEntryId alId)
+	{
+		if(alId < 0 || alId >= (tLanguageEntryId)mvEntries.size())
 		{
-			Warning("Could not find language file entry '%s'\n",asName.c_str());
+			Warning("Invalid language entry id %d\n",alId);
 			return mwsEmpty;
 		}
 
-		cLanguageEntry *pEntry = EntryIt->second;
+		cLanguageEntry *pEntry = mvEntries[alId];
+		if(pEntry==NULL)
+		{
+			Warning("Could not find language file entry '%s' in category '%s'\n",mvKeys[alId].msName.c_str(), mvKeys[alId].msCat.c_str());
+			return mwsEmpty;
+		}
 
 		return pEntry->mwsText;
 	}
 
 	//-----------------------------------------------------------------------
 
+	tLanguageEntryId cLanguageFile::GetEntryId(const tString& asCat, const tString& asName)
+	{
+		tLanguageEntryId lId = FindEntryId(asCat, asName);
+		if(lId != kLanguageEntryId_None) return lId;
+
+		//Keep the table at most half full
+		if((mvKeys.size()+1)*2 > mvKeySlots.size())
+		{
+			RehashKeys(mvKeySlots.empty() ? 1024 : mvKeySlots.size()*2);
+		}
+
+		cLanguageKey key;
+		key.msCat = asCat;
+		key.msName = asName;
+		key.mlHash = GetKeyHash(asCat, asName);
+
+		lId = (tLanguageEntryId)mvKeys.size();
+		mvKeys.push_back(key);
+		mvEntries.push_back(NULL);
+
+		size_t lMask = mvKeySlots.size()-1;
+		size_t lSlot = key.mlHash & lMask;
+		while(mvKeySlots[lSlot] != kLanguageEntryId_None) lSlot = (lSlot+1) & lMask;
+		mvKeySlots[lSlot] = lId;
+
+		return lId;
+	}
+
+	//-----------------------------------------------------------------------
+
+	tLanguageEntryId cLanguageFile::FindEntryId(const tString& asCat, const tString& asName)
+	{
+		if(mvKeySlots.empty()) return kLanguageEntryId_None;
+
+		unsigned int lHash = GetKeyHash(asCat, asName);
+		size_t lMask = mvKeySlots.size()-1;
+		for(size_t lSlot = lHash & lMask; mvKeySlots[lSlot] != kLanguageEntryId_None; lSlot = (lSlot+1) & lMask)
+		{
+			const cLanguageKey& key = mvKeys[mvKeySlots[lSlot]];
+			if(key.mlHash == lHash && key.msName == asName && key.msCat == asCat)
+			{
+				return mvKeySlots[lSlot];
+			}
+		}
+
+		return kLanguageEntryId_None;
+	}
+
+	//-----------------------------------------------------------------------
+
 	//////////////////////////////////////////////////////////////////////////
 	// PRIVATE METHODS
 	//////////////////////////////////////////////////////////////////////////
 
 	//-----------------------------------------------------------------------
 
+	unsigned int cLanguageFile::GetKeyHash(const tString& asCat, const tString& asName)
+	{
+		//FNV-1a over both strings, with a separator so "ab"+"c" and "a"+"bc" differ
+		unsigned int lHash = 2166136261u;
+		for(size_t i=0; i<asCat.size(); ++i)
+		{
+			lHash = (lHash ^ (unsigned char)asCat[i]) * 16777619u;
+		}
+		lHash = (lHash ^ 0xff) * 16777619u;
+		for(size_t i=0; i<asName.size(); ++i)
+		{
+			lHash = (lHash ^ (unsigned char)asName[i]) * 16777619u;
+		}
+		return lHash;
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cLanguageFile::RehashKeys(size_t alNumSlots)
+	{
+		mvKeySlots.assign(alNumSlots, kLanguageEntryId_None);
+
+		size_t lMask = alNumSlots-1;
+		for(size_t i=0; i<mvKeys.size(); ++i)
+		{
+			size_t lSlot = mvKeys[i].mlHash & lMask;
+			while(mvKeySlots[lSlot] != kLanguageEntryId_None) lSlot = (lSlot+1) & lMask;
+			mvKeySlots[lSlot] = (tLanguageEntryId)i;
+		}
+	}
 
 	//-----------------------------------------------------------------------
 }
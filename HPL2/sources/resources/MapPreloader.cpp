@@ -0,0 +1,665 @@
+/*
+ * Copyright © 2009-2020 Frictional Games
+ *
+ * This file is part of Amnesia: The Dark Descent.
+ *
+ * Amnesia: The Dark Descent is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * Amnesia: The Dark Descent is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Amnesia: The Dark Descent.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "resources/MapPreloader.h"
+
+#include "resources/BinaryBuffer.h"
+#include "resources/BitmapLoaderHandler.h"
+#include "resources/FileSearcher.h"
+#include "resources/LowLevelResources.h"
+#include "resources/MaterialDatabase.h"
+#include "resources/Resources.h"
+#include "resources/XmlDocument.h"
+
+#include "impl/MeshLoaderMSH.h"
+#include "impl/OpenALSoundData.h"
+
+#include "graphics/Bitmap.h"
+
+#include "system/JobPool.h"
+#include "system/LowLevelSystem.h"
+#include "system/Platform.h"
+#include "system/String.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace hpl {
+
+	//////////////////////////////////////////////////////////////////////////
+	// PREPARED FILE
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	MapPreloader::cPreparedFile::cPreparedFile(cPreparedFile&& aFile)
+	{
+		mpXmlDoc = aFile.mpXmlDoc;
+		mpBuffer = std::move(aFile.mpBuffer);
+		mpBitmap = aFile.mpBitmap;
+		mlSize = aFile.mlSize;
+		mbSound = aFile.mbSound;
+
+		aFile.mpXmlDoc = nullptr;
+		aFile.mpBitmap = nullptr;
+		aFile.mlSize = 0;
+	}
+
+	MapPreloader::cPreparedFile::~cPreparedFile()
+	{
+		if(mpXmlDoc) hplDelete(mpXmlDoc);
+		if(mpBitmap) hplDelete(mpBitmap);
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// CONSTRUCTORS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	MapPreloader::MapPreloader(cFileSearcher *apFileSearcher, iLowLevelResources *apLowLevelResources,
+								cBitmapLoaderHandler *apBitmapLoaderHandler, const tStringList& alstSoundFormats)
+	{
+		mpFileSearcher = apFileSearcher;
+		mpLowLevelResources = apLowLevelResources;
+		mpBitmapLoaderHandler = apBitmapLoaderHandler;
+		mlstSoundFormats = alstSoundFormats;
+
+		mlGeneration = 0;
+		mlMemoryBudget = 256 * 1024 * 1024;
+		mbActive = true;
+		mbQuit = false;
+
+		mWorkerThread = std::thread([this]() { WorkerThread(); });
+	}
+
+	//-----------------------------------------------------------------------
+
+	MapPreloader::~MapPreloader()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mbQuit = true;
+			mlGeneration++;
+		}
+		mCondition.notify_all();
+		if(mWorkerThread.joinable()) mWorkerThread.join();
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// PUBLIC METHODS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	void MapPreloader::SetActive(bool abX)
+	{
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mbActive = abX;
+		}
+		if(abX==false) Clear();
+
+		mCondition.notify_all();
+	}
+
+	//-----------------------------------------------------------------------
+
+	void MapPreloader::SetMemoryBudget(size_t alBytes)
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mlMemoryBudget = alBytes;
+	}
+
+	//-----------------------------------------------------------------------
+
+	void MapPreloader::Request(const tWString& asMapPath)
+	{
+		if(asMapPath == _W("")) return;
+
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			if(mbActive==false || m_setRequestedMaps.find(asMapPath) != m_setRequestedMaps.end()) return;
+
+			m_setRequestedMaps.insert(asMapPath);
+			mlstQueue.push_back(asMapPath);
+		}
+		mCondition.notify_all();
+	}
+
+	bool MapPreloader::IsRequested(const tWString& asMapPath)
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		return m_setRequestedMaps.find(asMapPath) != m_setRequestedMaps.end();
+	}
+
+	//-----------------------------------------------------------------------
+
+	void MapPreloader::CancelPending()
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mlGeneration++;
+		mlstQueue.clear();
+	}
+
+	//-----------------------------------------------------------------------
+
+	void MapPreloader::Clear()
+	{
+		//The prepared data is released outside of the lock
+		std::map<tWString, cPreparedFile> mapPreparedFiles;
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mlGeneration++;
+			mlstQueue.clear();
+			m_setRequestedMaps.clear();
+			m_setVisitedFiles.clear();
+			mapPreparedFiles.swap(m_mapPreparedFiles);
+			mStats.mlUsedMemory = 0;
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
+	iXmlDocument* MapPreloader::TakeXmlDocument(const tWString& asPath)
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+
+		std::map<tWString, cPreparedFile>::iterator it = m_mapPreparedFiles.find(asPath);
+		if(it == m_mapPreparedFiles.end() || it->second.mpXmlDoc == nullptr) return nullptr;
+
+		iXmlDocument *pDoc = it->second.mpXmlDoc;
+		it->second.mpXmlDoc = nullptr;
+
+		mStats.mlUsedMemory -= it->second.mlSize;
+		mStats.mlTakenFiles++;
+		m_mapPreparedFiles.erase(it);
+		return pDoc;
+	}
+
+	std::unique_ptr<cBinaryBuffer> MapPreloader::TakeBinaryBuffer(const tWString& asPath)
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+
+		std::map<tWString, cPreparedFile>::iterator it = m_mapPreparedFiles.find(asPath);
+		if(it == m_mapPreparedFiles.end() || it->second.mpBuffer == nullptr) return nullptr;
+
+		std::unique_ptr<cBinaryBuffer> pBuffer = std::move(it->second.mpBuffer);
+
+		mStats.mlUsedMemory -= it->second.mlSize;
+		mStats.mlTakenFiles++;
+		m_mapPreparedFiles.erase(it);
+		return pBuffer;
+	}
+
+	cBitmap* MapPreloader::TakeBitmap(const tWString& asPath)
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+
+		std::map<tWString, cPreparedFile>::iterator it = m_mapPreparedFiles.find(asPath);
+		if(it == m_mapPreparedFiles.end() || it->second.mpBitmap == nullptr) return nullptr;
+
+		cBitmap *pBitmap = it->second.mpBitmap;
+		it->second.mpBitmap = nullptr;
+
+		mStats.mlUsedMemory -= it->second.mlSize;
+		mStats.mlTakenFiles++;
+		m_mapPreparedFiles.erase(it);
+		return pBitmap;
+	}
+
+	//-----------------------------------------------------------------------
+
+	MapPreloader::cStats MapPreloader::GetStats()
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		return mStats;
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// PRIVATE METHODS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	void MapPreloader::WorkerThread()
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+		while(true)
+		{
+			mCondition.wait(lock, [&]() { return mbQuit || (mbActive && mlstQueue.empty()==false); });
+			if(mbQuit) break;
+
+			tWString sMapPath = mlstQueue.front();
+			mlstQueue.pop_front();
+			unsigned int lGeneration = mlGeneration;
+
+			lock.unlock();
+			PrepareMap(sMapPath, lGeneration);
+			lock.lock();
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
+	void MapPreloader::PrepareMap(const tWString& asMapPath, unsigned int alGeneration)
+	{
+		unsigned long lStartTime = cPlatform::GetApplicationTime();
+
+		iXmlDocument *pMapDoc = nullptr;
+		if(PrepareXmlDocument(asMapPath, alGeneration, &pMapDoc)==false) return;
+
+		///////////////////////////
+		// Collect what the map uses before the document is handed over,
+		// the main thread is free to take it as soon as it is added.
+		tStringVec vEntityFiles;
+		tStringVec vStaticObjectFiles;
+		tStringVec vMaterials;
+		tStringVec vSoundEntities;
+
+		cXmlElement *pMapDataElem = pMapDoc->GetFirstElement("MapData");
+		cXmlElement *pContentsElem = pMapDataElem ? pMapDataElem->GetFirstElement("MapContents") : nullptr;
+		if(pContentsElem)
+		{
+			CollectFileIndex(pContentsElem, "FileIndex_Entities", vEntityFiles);
+			CollectFileIndex(pContentsElem, "FileIndex_StaticObjects", vStaticObjectFiles);
+			CollectFileIndex(pContentsElem, "FileIndex_Decals", vMaterials);
+
+			cXmlElement *pPrimitivesElem = pContentsElem->GetFirstElement("Primitives");
+			if(pPrimitivesElem)
+			{
+				cXmlNodeListIterator it = pPrimitivesElem->GetChildIterator();
+				while(it.HasNext())
+				{
+					tString sMaterial = it.Next()->ToElement()->GetAttributeString("Material", "");
+					if(sMaterial != "") vMaterials.push_back(sMaterial);
+				}
+			}
+
+			cXmlElement *pEntitiesElem = pContentsElem->GetFirstElement("Entities");
+			if(pEntitiesElem)
+			{
+				cXmlNodeListIterator it = pEntitiesElem->GetChildIterator();
+				while(it.HasNext())
+				{
+					cXmlElement *pEntityElem = it.Next()->ToElement();
+					if(pEntityElem->GetValue() != "Sound") continue;
+
+					tString sFile = pEntityElem->GetAttributeString("SoundEntityFile", "");
+					if(sFile != "") vSoundEntities.push_back(sFile);
+				}
+			}
+		}
+
+		cPreparedFile mapFile;
+		mapFile.mpXmlDoc = pMapDoc;
+		mapFile.mlSize = cPlatform::GetFileSize(asMapPath);
+		AddPreparedFile(asMapPath, mapFile, alGeneration);
+
+		///////////////////////////
+		// Entity files are cheap and are needed for every instance, do them first.
+		for(size_t i=0; i<vEntityFiles.size() && IsCancelled(alGeneration)==false; ++i)
+		{
+			PrepareEntityFile(vEntityFiles[i], alGeneration, vMaterials);
+		}
+		for(size_t i=0; i<vStaticObjectFiles.size() && IsCancelled(alGeneration)==false; ++i)
+		{
+			PrepareMeshFile(vStaticObjectFiles[i], alGeneration, vMaterials);
+		}
+
+		///////////////////////////
+		// Images and sounds are where the decoding time goes, these are spread over the job pool.
+		if(IsCancelled(alGeneration)) return;
+		PrepareImages(vMaterials, alGeneration);
+
+		if(IsCancelled(alGeneration)) return;
+		PrepareSounds(vSoundEntities, alGeneration);
+
+		cStats stats = GetStats();
+		Log("Preloaded map '%s' in %d ms (%d files, %d bitmaps, %d sounds, %d kb in use, %d skipped)\n",
+			cString::To8Char(cString::GetFileNameW(asMapPath)).c_str(),
+			(int)(cPlatform::GetApplicationTime() - lStartTime),
+			stats.mlPreparedFiles, stats.mlPreparedBitmaps, stats.mlPreparedSounds,
+			(int)(stats.mlUsedMemory / 1024), stats.mlSkippedFiles);
+	}
+
+	//-----------------------------------------------------------------------
+
+	void MapPreloader::PrepareEntityFile(const tString& asFile, unsigned int alGeneration, tStringVec& avMaterials)
+	{
+		//Same lookup as cEntFileManager::CreateEntFile so the paths match
+		tWString sPath = mpFileSearcher->GetFilePath(cString::SetFileExt(cString::ToLowerCase(asFile), "ent"));
+		if(sPath == _W("")) return;
+
+		iXmlDocument *pEntDoc = nullptr;
+		if(PrepareXmlDocument(sPath, alGeneration, &pEntDoc)==false) return;
+
+		tString sMeshFile;
+		cXmlElement *pModelDataElem = pEntDoc->GetFirstElement("ModelData");
+		cXmlElement *pMeshElem = pModelDataElem ? pModelDataElem->GetFirstElement("Mesh") : nullptr;
+		if(pMeshElem) sMeshFile = pMeshElem->GetAttributeString("Filename", "");
+
+		cPreparedFile entFile;
+		entFile.mpXmlDoc = pEntDoc;
+		entFile.mlSize = cPlatform::GetFileSize(sPath);
+		AddPreparedFile(sPath, entFile, alGeneration);
+
+		if(sMeshFile != "") PrepareMeshFile(sMeshFile, alGeneration, avMaterials);
+	}
+
+	//-----------------------------------------------------------------------
+
+	void MapPreloader::PrepareMeshFile(const tString& asFile, unsigned int alGeneration, tStringVec& avMaterials)
+	{
+		tWString sPath = mpFileSearcher->GetFilePath(asFile);
+		if(sPath == _W("")) return;
+
+		tString sExt = cString::ToLowerCase(cString::GetFileExt(asFile));
+		if(sExt == "dae")
+		{
+			//Only the msh cache can be read off the main thread, mirror the check in cMeshLoaderCollada
+			//so that nothing is prepared that the loader is going to ignore.
+			tWString sMshPath = cString::SetFileExtW(sPath, _W("msh"));
+			if(cPlatform::FileExists(sMshPath)==false) return;
+			if(	cResources::GetForceCacheLoadingAndSkipSaving()==false &&
+				cPlatform::FileModifiedDate(sMshPath) <= cPlatform::FileModifiedDate(sPath))
+			{
+				return;
+			}
+			sPath = sMshPath;
+		}
+		else if(sExt != "msh")
+		{
+			return;
+		}
+
+		size_t lSize = cPlatform::GetFileSize(sPath);
+		if(ReserveMemory(sPath, lSize, alGeneration)==false) return;
+
+		cPreparedFile meshFile;
+		meshFile.mpBuffer = std::make_unique<cBinaryBuffer>(sPath);
+		if(meshFile.mpBuffer->Load()==false) return;
+		meshFile.mlSize = lSize;
+
+		//Read before the buffer is added, after that it belongs to the main thread
+		cMeshLoaderMSH::GetMaterialNames(meshFile.mpBuffer.get(), avMaterials);
+
+		AddPreparedFile(sPath, meshFile, alGeneration);
+	}
+
+	//-----------------------------------------------------------------------
+
+	void MapPreloader::PrepareImages(const tStringVec& avMaterials, unsigned int alGeneration)
+	{
+		///////////////////////////
+		// Get the images of the materials, picked the same way as cMaterialManager::LoadFromFile does
+		tWStringSet setMaterialPaths;
+		tWStringVec vImagePaths;
+		for(size_t i=0; i<avMaterials.size(); ++i)
+		{
+			if(IsCancelled(alGeneration)) return;
+
+			tWString sMatPath = mpFileSearcher->GetFilePath(cString::SetFileExt(avMaterials[i], "mat"));
+			if(sMatPath == _W("") || setMaterialPaths.insert(sMatPath).second==false) continue;
+
+			cBinaryBuffer matBuff;
+			if(matBuff.Load(sMatPath)==false) continue;
+
+			cCompiledMaterial compiled;
+			if(cMaterialDatabase::Compile(matBuff.GetDataPointer(), matBuff.GetSize(), sMatPath, compiled)==false) continue;
+
+			for(const cCompiledMaterialTexture& texture : compiled.mvTextures)
+			{
+				if(texture.mAnimMode != eTextureAnimMode_None) continue;
+				if(texture.mType == eTextureType_CubeMap && cString::ToLowerCase(cString::GetFileExt(texture.msFile)) != "dds") continue;
+
+				tWString sImagePath = GetImagePath(texture.msFile);
+				if(sImagePath == _W("")) continue;
+				if(std::find(vImagePaths.begin(), vImagePaths.end(), sImagePath) != vImagePaths.end()) continue;
+
+				vImagePaths.push_back(sImagePath);
+			}
+		}
+
+		///////////////////////////
+		// Decode. Images that are already loaded by the current map are decoded again and never taken,
+		// the texture manager can not be asked from this thread. The budget keeps this in check.
+		tWStringVec vPaths;
+		tWStringVec vLoadPaths;
+		for(size_t i=0; i<vImagePaths.size(); ++i)
+		{
+			tWString sLoadPath = mpFileSearcher->GetCookedFilePath(vImagePaths[i]);
+			if(ReserveMemory(vImagePaths[i], cPlatform::GetFileSize(sLoadPath), alGeneration)==false) continue;
+
+			vPaths.push_back(vImagePaths[i]);
+			vLoadPaths.push_back(sLoadPath);
+		}
+		if(vPaths.empty()) return;
+
+		std::vector<cBitmap*> vBitmaps;
+		mpBitmapLoaderHandler->LoadBitmaps(vLoadPaths, 0, vBitmaps);
+
+		for(size_t i=0; i<vPaths.size(); ++i)
+		{
+			if(vBitmaps[i]==nullptr) continue;
+
+			cPreparedFile imageFile;
+			imageFile.mpBitmap = vBitmaps[i];
+			for(int lImage=0; lImage<vBitmaps[i]->GetNumOfImages(); ++lImage)
+			for(int lMip=0; lMip<vBitmaps[i]->GetNumOfMipMaps(); ++lMip)
+			{
+				imageFile.mlSize += vBitmaps[i]->GetData(lImage, lMip)->mlSize;
+			}
+
+			AddPreparedFile(vPaths[i], imageFile, alGeneration);
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
+	void MapPreloader::PrepareSounds(const tStringVec& avSoundEntities, unsigned int alGeneration)
+	{
+		///////////////////////////
+		// Get the samples of the sound entities, streamed ones are left to the sound manager
+		tWStringSet setSoundEntityPaths;
+		tWStringVec vSoundPaths;
+		for(size_t i=0; i<avSoundEntities.size(); ++i)
+		{
+			if(IsCancelled(alGeneration)) return;
+
+			tWString sPath = mpFileSearcher->GetFilePath(cString::SetFileExt(avSoundEntities[i], "snt"));
+			if(sPath == _W("") || setSoundEntityPaths.insert(sPath).second==false) continue;
+
+			iXmlDocument *pDoc = mpLowLevelResources->CreateXmlDocument();
+			if(pDoc->CreateFromFile(sPath)==false)
+			{
+				hplDelete(pDoc);
+				continue;
+			}
+
+			cXmlElement *pSoundsElem = pDoc->GetFirstElement("SOUNDS");
+			cXmlElement *pPropElem = pDoc->GetFirstElement("PROPERTIES");
+			if(pSoundsElem && pPropElem && pPropElem->GetAttributeBool("Stream",true)==false)
+			{
+				const char* vTypes[] = { "Main", "Start", "Stop" };
+				for(const char* sType : vTypes)
+				{
+					cXmlElement *pTypeElem = pSoundsElem->GetFirstElement(sType);
+					if(pTypeElem == nullptr) continue;
+
+					cXmlNodeListIterator it = pTypeElem->GetChildIterator();
+					while(it.HasNext())
+					{
+						tWString sSoundPath = GetSoundPath(it.Next()->ToElement()->GetAttributeString("File", ""));
+						if(sSoundPath == _W("")) continue;
+						if(std::find(vSoundPaths.begin(), vSoundPaths.end(), sSoundPath) != vSoundPaths.end()) continue;
+
+						vSoundPaths.push_back(sSoundPath);
+					}
+				}
+			}
+			hplDelete(pDoc);
+		}
+
+		///////////////////////////
+		// Decode
+		tWStringVec vPaths;
+		for(size_t i=0; i<vSoundPaths.size(); ++i)
+		{
+			if(ReserveMemory(vSoundPaths[i], cPlatform::GetFileSize(vSoundPaths[i]), alGeneration)==false) continue;
+			vPaths.push_back(vSoundPaths[i]);
+		}
+		if(vPaths.empty()) return;
+
+		std::vector<std::unique_ptr<cBinaryBuffer>> vBuffers(vPaths.size());
+		cJobPool::GetDefault()->ParallelFor(vPaths.size(), [&](size_t alIdx)
+		{
+			if(IsCancelled(alGeneration)) return;
+
+			std::unique_ptr<cBinaryBuffer> pBuffer = std::make_unique<cBinaryBuffer>();
+			if(cOpenALSoundData::DecodeSampleToBuffer(vPaths[alIdx], pBuffer.get())) vBuffers[alIdx] = std::move(pBuffer);
+		});
+
+		for(size_t i=0; i<vPaths.size(); ++i)
+		{
+			if(vBuffers[i]==nullptr) continue;
+
+			cPreparedFile soundFile;
+			soundFile.mlSize = vBuffers[i]->GetSize();
+			soundFile.mpBuffer = std::move(vBuffers[i]);
+			soundFile.mbSound = true;
+
+			AddPreparedFile(vPaths[i], soundFile, alGeneration);
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
+	void MapPreloader::CollectFileIndex(cXmlElement *apContentsElem, const tString& asIndexName, tStringVec& avFiles)
+	{
+		cXmlElement *pIndexElem = apContentsElem->GetFirstElement(asIndexName);
+		if(pIndexElem == nullptr) return;
+
+		cXmlNodeListIterator it = pIndexElem->GetChildIterator();
+		while(it.HasNext())
+		{
+			tString sPath = it.Next()->ToElement()->GetAttributeString("Path", "");
+			if(sPath != "") avFiles.push_back(sPath);
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
+	tWString MapPreloader::GetImagePath(const tString& asName)
+	{
+		//Same order as cTextureManager::FindImageResource
+		if(cString::GetFileExt(asName)=="")
+		{
+			tStringVec *pFormats = mpBitmapLoaderHandler->GetSupportedTypes();
+			for(tStringVecIt it = pFormats->begin(); it != pFormats->end(); ++it)
+			{
+				tWString sPath = mpFileSearcher->GetFilePath(cString::SetFileExt(asName, *it));
+				if(sPath != _W("")) return sPath;
+			}
+		}
+		return mpFileSearcher->GetFilePath(asName);
+	}
+
+	tWString MapPreloader::GetSoundPath(const tString& asName)
+	{
+		if(asName == "") return _W("");
+
+		//Same order as cSoundManager::FindSampleData
+		if(cString::GetFileExt(asName)=="")
+		{
+			for(tStringListIt it = mlstSoundFormats.begin(); it != mlstSoundFormats.end(); ++it)
+			{
+				tWString sPath = mpFileSearcher->GetFilePath(cString::SetFileExt(asName, *it));
+				if(sPath != _W("")) return sPath;
+			}
+			return _W("");
+		}
+		return mpFileSearcher->GetFilePath(asName);
+	}
+
+	//-----------------------------------------------------------------------
+
+	bool MapPreloader::PrepareXmlDocument(const tWString& asPath, unsigned int alGeneration, iXmlDocument **apOutDoc)
+	{
+		if(ReserveMemory(asPath, cPlatform::GetFileSize(asPath), alGeneration)==false) return false;
+
+		iXmlDocument *pDoc = mpLowLevelResources->CreateXmlDocument();
+		if(pDoc->CreateFromFile(asPath)==false)
+		{
+			hplDelete(pDoc);
+			return false;
+		}
+		*apOutDoc = pDoc;
+		return true;
+	}
+
+	//-----------------------------------------------------------------------
+
+	bool MapPreloader::ReserveMemory(const tWString& asPath, size_t alSize, unsigned int alGeneration)
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		if(IsCancelled(alGeneration) || m_setVisitedFiles.insert(asPath).second==false) return false;
+
+		//Only the worker adds files, so the check holds until the file is added. Decoded data can be
+		//larger than the file, AddPreparedFile checks again with the real size.
+		if(mStats.mlUsedMemory + alSize > mlMemoryBudget)
+		{
+			mStats.mlSkippedFiles++;
+			return false;
+		}
+		return true;
+	}
+
+	//-----------------------------------------------------------------------
+
+	bool MapPreloader::AddPreparedFile(const tWString& asPath, cPreparedFile& aFile, unsigned int alGeneration)
+	{
+		//Files that are not added are released by the caller when going out of scope
+		std::lock_guard<std::mutex> lock(mMutex);
+		if(IsCancelled(alGeneration)) return false;
+
+		if(mStats.mlUsedMemory + aFile.mlSize > mlMemoryBudget)
+		{
+			mStats.mlSkippedFiles++;
+			return false;
+		}
+
+		mStats.mlUsedMemory += aFile.mlSize;
+		mStats.mlPreparedFiles++;
+		if(aFile.mpBitmap) mStats.mlPreparedBitmaps++;
+		if(aFile.mbSound) mStats.mlPreparedSounds++;
+
+		m_mapPreparedFiles.emplace(asPath, std::move(aFile));
+		return true;
+	}
+
+	//-----------------------------------------------------------------------
+
+}
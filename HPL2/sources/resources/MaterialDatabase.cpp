@@ -0,0 +1,596 @@
+/*
+ * Copyright © 2009-2020 Frictional Games
+ *
+ * This file is part of Amnesia: The Dark Descent.
+ *
+ * Amnesia: The Dark Descent is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * Amnesia: The Dark Descent is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Amnesia: The Dark Descent.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "resources/MaterialDatabase.h"
+
+#include "resources/MaterialManager.h"
+#include "resources/BinaryBuffer.h"
+#include "resources/Resources.h"
+
+#include "system/LowLevelSystem.h"
+#include "system/Platform.h"
+#include "system/String.h"
+
+#include "math/Math.h"
+
+#include "Common_3/Utilities/Log/Log.h"
+#include "Common_3/Utilities/Interfaces/ILog.h"
+#include <FixPreprocessor.h>
+#include "tinyxml2.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace hpl {
+
+	//////////////////////////////////////////////////////////////////////////
+	// STATIC DATA
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	//Increase when the compiled data changes, older databases are then thrown away
+	static const int kMaterialDatabaseMagic = 0x42444D48; //"HMDB"
+	static const int kMaterialDatabaseVersion = 1;
+
+	static const unsigned int kMaterialDatabaseCRCKey = 0x4D415444;
+	static const unsigned int kMaterialFileHashKey = 0x4D415446;
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// CONSTRUCTORS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	cMaterialDatabase::cMaterialDatabase()
+	{
+		mbChanged = false;
+
+		mlHits = 0;
+		mlCompiled = 0;
+	}
+
+	//-----------------------------------------------------------------------
+
+	cMaterialDatabase::~cMaterialDatabase()
+	{
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// PUBLIC METHODS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	bool cMaterialDatabase::Load(const tWString& asFile)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		m_mapEntries.clear();
+		mbChanged = false;
+
+		if(cPlatform::FileExists(asFile)==false) return false;
+
+		cBinaryBuffer buff;
+		if(buff.Load(asFile)==false) return false;
+
+		///////////////////////////
+		// Header and CRC
+		if(buff.GetSize() < 12 || buff.GetInt32() != kMaterialDatabaseMagic || buff.GetInt32() != kMaterialDatabaseVersion)
+		{
+			Log(" Material database '%s' is from another version, rebuilding it.\n", cString::To8Char(asFile).c_str());
+			return false;
+		}
+		if(buff.CheckInternalCRC(kMaterialDatabaseCRCKey)==false)
+		{
+			Warning("CRC check for material database '%s' failed, rebuilding it.\n", cString::To8Char(asFile).c_str());
+			return false;
+		}
+
+		///////////////////////////
+		// Entries
+		int lCount = buff.GetInt32();
+		for(int i=0; i<lCount && buff.IsEOF()==false; ++i)
+		{
+			tString sKey;
+			buff.GetString(&sKey);
+
+			cEntry &entry = m_mapEntries[sKey];
+			entry.mDate.seconds = buff.GetInt32();
+			entry.mDate.minutes = buff.GetInt32();
+			entry.mDate.hours = buff.GetInt32();
+			entry.mDate.month_day = buff.GetInt32();
+			entry.mDate.month = buff.GetInt32();
+			entry.mDate.year = buff.GetInt32();
+			entry.mlFileSize = buff.GetInt32();
+			entry.mlHash = (unsigned int)buff.GetInt32();
+
+			LoadMaterial(&buff, entry.mMaterial);
+		}
+
+		Log(" Loaded %d compiled materials from '%s'\n", (int)m_mapEntries.size(), cString::To8Char(asFile).c_str());
+
+		return true;
+	}
+
+	//-----------------------------------------------------------------------
+
+	bool cMaterialDatabase::Save(const tWString& asFile)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		cBinaryBuffer buff;
+		buff.AddInt32(kMaterialDatabaseMagic);
+		buff.AddInt32(kMaterialDatabaseVersion);
+
+		buff.AddCRC_Begin();
+
+		buff.AddInt32((int)m_mapEntries.size());
+		for(tEntryMapIt it = m_mapEntries.begin(); it != m_mapEntries.end(); ++it)
+		{
+			const cEntry &entry = it->second;
+
+			buff.AddString(it->first);
+			buff.AddInt32(entry.mDate.seconds);
+			buff.AddInt32(entry.mDate.minutes);
+			buff.AddInt32(entry.mDate.hours);
+			buff.AddInt32(entry.mDate.month_day);
+			buff.AddInt32(entry.mDate.month);
+			buff.AddInt32(entry.mDate.year);
+			buff.AddInt32(entry.mlFileSize);
+			buff.AddInt32((int)entry.mlHash);
+
+			SaveMaterial(&buff, entry.mMaterial);
+		}
+
+		buff.AddCRC_End(kMaterialDatabaseCRCKey);
+
+		if(buff.Save(asFile)==false)
+		{
+			Error("Couldn't save material database to '%s'\n", cString::To8Char(asFile).c_str());
+			return false;
+		}
+
+		mbChanged = false;
+		return true;
+	}
+
+	//-----------------------------------------------------------------------
+
+	bool cMaterialDatabase::GetMaterial(const tWString& asPath, cCompiledMaterial &aMaterial)
+	{
+		tString sKey = cString::ToLowerCase(cString::To8Char(asPath));
+		cDate fileDate = cPlatform::FileModifiedDate(asPath);
+		int lFileSize = (int)cPlatform::GetFileSize(asPath);
+
+		///////////////////////////
+		// Same date and size, use the entry as it is
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+
+			tEntryMapIt it = m_mapEntries.find(sKey);
+			if(it != m_mapEntries.end() && it->second.mDate == fileDate && it->second.mlFileSize == lFileSize)
+			{
+				aMaterial = it->second.mMaterial;
+				++mlHits;
+				return true;
+			}
+		}
+
+		///////////////////////////
+		// Read the file, if the contents are the same only the date needs updating
+		cBinaryBuffer fileBuff;
+		if(fileBuff.Load(asPath)==false) return false;
+
+		unsigned int lHash = fileBuff.GetCRC(kMaterialFileHashKey, 0, (int)fileBuff.GetSize());
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+
+			tEntryMapIt it = m_mapEntries.find(sKey);
+			if(it != m_mapEntries.end() && it->second.mlFileSize == (int)fileBuff.GetSize() && it->second.mlHash == lHash)
+			{
+				it->second.mDate = fileDate;
+				mbChanged = true;
+
+				aMaterial = it->second.mMaterial;
+				++mlHits;
+				return true;
+			}
+		}
+
+		///////////////////////////
+		// Compile
+		cCompiledMaterial material;
+		if(Compile(fileBuff.GetDataPointer(), fileBuff.GetSize(), asPath, material)==false) return false;
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+
+			cEntry &entry = m_mapEntries[sKey];
+			entry.mDate = fileDate;
+			entry.mlFileSize = (int)fileBuff.GetSize();
+			entry.mlHash = lHash;
+			entry.mMaterial = material;
+			mbChanged = true;
+
+			++mlCompiled;
+		}
+
+		aMaterial = material;
+		return true;
+	}
+
+	//-----------------------------------------------------------------------
+
+	bool cMaterialDatabase::Compile(const char* apData, size_t alSize, const tWString& asPath, cCompiledMaterial &aMaterial)
+	{
+		tString sName = cString::To8Char(cString::GetFileNameW(asPath));
+
+		tinyxml2::XMLDocument document;
+		document.Parse(apData, alSize);
+
+		auto* rootElement = document.FirstChildElement();
+		if (rootElement == nullptr) {
+			LOGF(LogLevel::eERROR,"Material-%s: Root not found", sName.c_str());
+			return false;
+		}
+		auto* mainElement = rootElement->FirstChildElement("Main");
+		if (mainElement  == nullptr) {
+			LOGF(LogLevel::eERROR,"Material-%s: Main child not found", sName.c_str());
+			return false;
+		}
+
+		const char* sType = "";
+		if(mainElement->QueryAttribute("Type", &sType) != tinyxml2::XMLError::XML_SUCCESS) {
+			LOGF(LogLevel::eERROR,"Material-%s:Missing Type Attribute: ", sName.c_str());
+			return false;
+		}
+
+		bool bDepthTest = true;
+		const char* sPhysicsMatName = "Default";
+		const char* sBlendMode = "Add";
+
+		mainElement->QueryBoolAttribute("DepthTest", &bDepthTest);
+		mainElement->QueryStringAttribute("PhysicsMaterial", &sPhysicsMatName);
+		mainElement->QueryStringAttribute("BlendMode", &sBlendMode);
+
+		aMaterial.msType = cString::ToLowerCase(sType);
+		aMaterial.mbDepthTest = bDepthTest;
+		aMaterial.msPhysicsMaterial = sPhysicsMatName;
+		aMaterial.mvTextures.clear();
+		aMaterial.mvUvAnimations.clear();
+
+		memset(&aMaterial.mDescriptor, 0, sizeof(ShaderMaterialData));
+		aMaterial.mDescriptor.m_id = MaterialID::Unknown;
+		aMaterial.mID = MaterialID::Unknown;
+
+		auto metaInfo = std::find_if(cMaterial::MaterialMetaTable.begin(), cMaterial::MaterialMetaTable.end(), [&](auto& info) {
+			return info.m_name == aMaterial.msType;
+		});
+
+		///////////////////////////
+		// Textures, only the units that the type uses
+		auto* textureUnits = rootElement->FirstChildElement("TextureUnits");
+		aMaterial.mbHasTextureUnits = textureUnits != nullptr;
+
+		//Unknown types are kept, the manager can still use the physics material
+		if (metaInfo == cMaterial::MaterialMetaTable.end()) {
+			return true;
+		}
+		aMaterial.mID = metaInfo->m_id;
+
+		if (textureUnits) {
+			tString sMaterialDir = cString::To8Char(cString::GetFilePathW(asPath));
+
+			for (eMaterialTexture textureType : metaInfo->m_usedTextures) {
+				auto* pTexChild = textureUnits->FirstChildElement(cMaterialManager::GetTextureString(textureType));
+				if (pTexChild == NULL) {
+					continue;
+				}
+				cCompiledMaterialTexture texture;
+				texture.mUnit = textureType;
+				texture.mbMipMaps = true;
+				texture.mbCompress = false;
+				texture.mfFrameTime = 1.0f;
+
+				const char* textureTypeStr = "";
+				const char* wrapStr = "";
+				const char* sFileQuery = "";
+				const char* animModeStr = "None";
+
+				pTexChild->QueryStringAttribute("AnimMode", &animModeStr);
+				pTexChild->QueryStringAttribute("Wrap", &wrapStr);
+				pTexChild->QueryStringAttribute("Type", &textureTypeStr);
+				pTexChild->QueryStringAttribute("File", &sFileQuery );
+				pTexChild->QueryBoolAttribute("MipMaps", &texture.mbMipMaps);
+				pTexChild->QueryBoolAttribute("Compress", &texture.mbCompress);
+				pTexChild->QueryFloatAttribute("AnimFrameTime", &texture.mfFrameTime);
+
+				if (strcmp(sFileQuery ,"") == 0) {
+					continue;
+				}
+				texture.mWrap = cMaterialManager::GetWrap(wrapStr);
+				texture.mType = cMaterialManager::GetType(textureTypeStr);
+				texture.mAnimMode = cMaterialManager::GetAnimMode(animModeStr);
+
+				texture.msFile = sFileQuery;
+				if (cString::GetFilePath(texture.msFile).length() <= 1) {
+					texture.msFile = cString::SetFilePath(texture.msFile, sMaterialDir);
+				}
+				aMaterial.mvTextures.push_back(texture);
+			}
+		}
+
+		///////////////////////////
+		// Animations
+		auto* pUvAnimRoot  = rootElement->FirstChildElement("UvAnimations");
+		if (pUvAnimRoot) {
+			auto animElement = pUvAnimRoot->FirstChildElement();
+			for(;animElement != nullptr; animElement = animElement->NextSiblingElement()) {
+				const char* animTypeStr = "";
+				const char* animAxisStr = "";
+				float fSpeed = 0;
+				float fAmp = 0;
+				animElement->QueryStringAttribute("Type", &animTypeStr);
+				animElement->QueryStringAttribute("Axis", &animAxisStr);
+				animElement->QueryFloatAttribute("Speed", &fSpeed);
+				animElement->QueryFloatAttribute("Amplitude", &fAmp);
+
+				aMaterial.mvUvAnimations.push_back(cMaterialUvAnimation(cMaterialManager::GetUvAnimType(animTypeStr), fSpeed, fAmp,
+																		cMaterialManager::GetAnimAxis(animAxisStr)));
+			}
+		}
+
+		///////////////////////////
+		// Variables
+		cResourceVarsObject userVars;
+		auto* pUserVarsRoot = rootElement->FirstChildElement("SpecificVariables");
+		if (pUserVarsRoot)
+			userVars.LoadVariables(pUserVarsRoot);
+
+		ShaderMaterialData& materialDescriptor = aMaterial.mDescriptor;
+		materialDescriptor.m_id = metaInfo->m_id;
+		switch (metaInfo->m_id) {
+		case MaterialID::SolidDiffuse:
+			{
+				materialDescriptor.m_solid.m_heightMapScale = userVars.GetVarFloat("HeightMapScale", 0.1f);
+				materialDescriptor.m_solid.m_heightMapBias = userVars.GetVarFloat("HeightMapBias", 0);
+				materialDescriptor.m_solid.m_frenselBias = userVars.GetVarFloat("FrenselBias", 0.2f);
+				materialDescriptor.m_solid.m_frenselPow = userVars.GetVarFloat("FrenselPow", 8.0f);
+				materialDescriptor.m_solid.m_alphaDissolveFilter = userVars.GetVarBool("AlphaDissolveFilter", false);
+				break;
+			}
+		case MaterialID::Translucent:
+			{
+				materialDescriptor.m_translucent.m_hasRefraction = userVars.GetVarBool("Refraction", false);
+				materialDescriptor.m_translucent.m_refractionNormals = userVars.GetVarBool("RefractionNormals", true);
+				materialDescriptor.m_translucent.m_refractionEdgeCheck = userVars.GetVarBool("RefractionEdgeCheck", true);
+				materialDescriptor.m_translucent.m_isAffectedByLightLevel = userVars.GetVarBool("AffectedByLightLevel", false);
+
+				materialDescriptor.m_translucent.m_refractionScale = userVars.GetVarFloat("RefractionScale", 1.0f);
+				materialDescriptor.m_translucent.m_frenselBias = userVars.GetVarFloat("FrenselBias", 0.2f);
+				materialDescriptor.m_translucent.m_frenselPow = userVars.GetVarFloat("FrenselPow", 8.0);
+				materialDescriptor.m_translucent.m_rimLightMul = userVars.GetVarFloat("RimLightMul", 0.0f);
+				materialDescriptor.m_translucent.m_rimLightPow = userVars.GetVarFloat("RimLightPow", 8.0f);
+				materialDescriptor.m_translucent.m_blend = cMaterialManager::GetBlendMode(sBlendMode);
+				break;
+			}
+		case MaterialID::Water:
+			{
+				materialDescriptor.m_water.m_hasReflection = userVars.GetVarBool("HasReflection", true);
+				materialDescriptor.m_water.m_refractionScale = userVars.GetVarFloat("RefractionScale", 1.0f);
+				materialDescriptor.m_water.m_frenselBias = userVars.GetVarFloat("FrenselBias", 0.2f);
+				materialDescriptor.m_water.m_frenselPow = userVars.GetVarFloat("FrenselPow", 8.0f);
+				materialDescriptor.m_water.m_reflectionFadeStart = userVars.GetVarFloat("ReflectionFadeStart", 0);
+				materialDescriptor.m_water.m_reflectionFadeEnd = userVars.GetVarFloat("ReflectionFadeEnd", 0);
+				materialDescriptor.m_water.m_waveSpeed = userVars.GetVarFloat("WaveSpeed", 1.0f);
+				materialDescriptor.m_water.m_waveAmplitude = userVars.GetVarFloat("WaveAmplitude", 1.0f);
+				materialDescriptor.m_water.m_waveFreq = userVars.GetVarFloat("WaveFreq", 1.0f);
+
+				materialDescriptor.m_water.m_isLargeSurface = userVars.GetVarBool("LargeSurface", false);
+				materialDescriptor.m_water.m_worldReflectionOcclusionTest =
+					userVars.GetVarBool("OcclusionCullWorldReflection", true);
+				break;
+			}
+		case MaterialID::Decal:
+			{
+				materialDescriptor.m_translucent.m_blend = cMaterialManager::GetBlendMode(sBlendMode);
+				break;
+			}
+		default:
+			ASSERT(false && "Invalid material type");
+			break;
+		}
+
+		return true;
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// PRIVATE METHODS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	void cMaterialDatabase::SaveMaterial(cBinaryBuffer *apBuffer, const cCompiledMaterial &aMaterial)
+	{
+		apBuffer->AddUnsignedChar((unsigned char)aMaterial.mID);
+		apBuffer->AddString(aMaterial.msType);
+		apBuffer->AddBool(aMaterial.mbDepthTest);
+		apBuffer->AddString(aMaterial.msPhysicsMaterial);
+		apBuffer->AddBool(aMaterial.mbHasTextureUnits);
+
+		apBuffer->AddInt32((int)aMaterial.mvTextures.size());
+		for(size_t i=0; i<aMaterial.mvTextures.size(); ++i)
+		{
+			const cCompiledMaterialTexture &texture = aMaterial.mvTextures[i];
+			apBuffer->AddInt32(texture.mUnit);
+			apBuffer->AddString(texture.msFile);
+			apBuffer->AddInt32(texture.mType);
+			apBuffer->AddInt32(texture.mWrap);
+			apBuffer->AddInt32(texture.mAnimMode);
+			apBuffer->AddBool(texture.mbMipMaps);
+			apBuffer->AddBool(texture.mbCompress);
+			apBuffer->AddFloat32(texture.mfFrameTime);
+		}
+
+		apBuffer->AddInt32((int)aMaterial.mvUvAnimations.size());
+		for(size_t i=0; i<aMaterial.mvUvAnimations.size(); ++i)
+		{
+			const cMaterialUvAnimation &anim = aMaterial.mvUvAnimations[i];
+			apBuffer->AddInt32(anim.mType);
+			apBuffer->AddFloat32(anim.mfSpeed);
+			apBuffer->AddFloat32(anim.mfAmp);
+			apBuffer->AddInt32(anim.mAxis);
+		}
+
+		const ShaderMaterialData &desc = aMaterial.mDescriptor;
+		apBuffer->AddUnsignedChar((unsigned char)desc.m_id);
+		switch(desc.m_id)
+		{
+		case MaterialID::SolidDiffuse:
+			apBuffer->AddFloat32(desc.m_solid.m_heightMapScale);
+			apBuffer->AddFloat32(desc.m_solid.m_heightMapBias);
+			apBuffer->AddFloat32(desc.m_solid.m_frenselBias);
+			apBuffer->AddFloat32(desc.m_solid.m_frenselPow);
+			apBuffer->AddBool(desc.m_solid.m_alphaDissolveFilter);
+			break;
+		case MaterialID::Translucent:
+			apBuffer->AddInt32(desc.m_translucent.m_blend);
+			apBuffer->AddBool(desc.m_translucent.m_isAffectedByLightLevel);
+			apBuffer->AddBool(desc.m_translucent.m_hasRefraction);
+			apBuffer->AddBool(desc.m_translucent.m_refractionEdgeCheck);
+			apBuffer->AddBool(desc.m_translucent.m_refractionNormals);
+			apBuffer->AddFloat32(desc.m_translucent.m_refractionScale);
+			apBuffer->AddFloat32(desc.m_translucent.m_frenselBias);
+			apBuffer->AddFloat32(desc.m_translucent.m_frenselPow);
+			apBuffer->AddFloat32(desc.m_translucent.m_rimLightMul);
+			apBuffer->AddFloat32(desc.m_translucent.m_rimLightPow);
+			break;
+		case MaterialID::Water:
+			apBuffer->AddBool(desc.m_water.m_hasReflection);
+			apBuffer->AddBool(desc.m_water.m_isLargeSurface);
+			apBuffer->AddBool(desc.m_water.m_worldReflectionOcclusionTest);
+			apBuffer->AddFloat32(desc.m_water.m_refractionScale);
+			apBuffer->AddFloat32(desc.m_water.m_frenselBias);
+			apBuffer->AddFloat32(desc.m_water.m_frenselPow);
+			apBuffer->AddFloat32(desc.m_water.m_reflectionFadeStart);
+			apBuffer->AddFloat32(desc.m_water.m_reflectionFadeEnd);
+			apBuffer->AddFloat32(desc.m_water.m_waveSpeed);
+			apBuffer->AddFloat32(desc.m_water.m_waveAmplitude);
+			apBuffer->AddFloat32(desc.m_water.m_waveFreq);
+			break;
+		case MaterialID::Decal:
+			apBuffer->AddInt32(desc.m_translucent.m_blend);
+			break;
+		default:
+			break;
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cMaterialDatabase::LoadMaterial(cBinaryBuffer *apBuffer, cCompiledMaterial &aMaterial)
+	{
+		aMaterial.mID = (MaterialID)apBuffer->GetUnsignedChar();
+		apBuffer->GetString(&aMaterial.msType);
+		aMaterial.mbDepthTest = apBuffer->GetBool();
+		apBuffer->GetString(&aMaterial.msPhysicsMaterial);
+		aMaterial.mbHasTextureUnits = apBuffer->GetBool();
+
+		int lTextureCount = apBuffer->GetInt32();
+		aMaterial.mvTextures.resize(cMath::Max(lTextureCount, 0));
+		for(size_t i=0; i<aMaterial.mvTextures.size(); ++i)
+		{
+			cCompiledMaterialTexture &texture = aMaterial.mvTextures[i];
+			texture.mUnit = (eMaterialTexture)apBuffer->GetInt32();
+			apBuffer->GetString(&texture.msFile);
+			texture.mType = (eTextureType)apBuffer->GetInt32();
+			texture.mWrap = (eTextureWrap)apBuffer->GetInt32();
+			texture.mAnimMode = (eTextureAnimMode)apBuffer->GetInt32();
+			texture.mbMipMaps = apBuffer->GetBool();
+			texture.mbCompress = apBuffer->GetBool();
+			texture.mfFrameTime = apBuffer->GetFloat32();
+		}
+
+		int lAnimCount = apBuffer->GetInt32();
+		aMaterial.mvUvAnimations.clear();
+		for(int i=0; i<lAnimCount; ++i)
+		{
+			eMaterialUvAnimation type = (eMaterialUvAnimation)apBuffer->GetInt32();
+			float fSpeed = apBuffer->GetFloat32();
+			float fAmp = apBuffer->GetFloat32();
+			eMaterialAnimationAxis axis = (eMaterialAnimationAxis)apBuffer->GetInt32();
+			aMaterial.mvUvAnimations.push_back(cMaterialUvAnimation(type, fSpeed, fAmp, axis));
+		}
+
+		ShaderMaterialData &desc = aMaterial.mDescriptor;
+		memset(&desc, 0, sizeof(ShaderMaterialData));
+		desc.m_id = (MaterialID)apBuffer->GetUnsignedChar();
+		switch(desc.m_id)
+		{
+		case MaterialID::SolidDiffuse:
+			desc.m_solid.m_heightMapScale = apBuffer->GetFloat32();
+			desc.m_solid.m_heightMapBias = apBuffer->GetFloat32();
+			desc.m_solid.m_frenselBias = apBuffer->GetFloat32();
+			desc.m_solid.m_frenselPow = apBuffer->GetFloat32();
+			desc.m_solid.m_alphaDissolveFilter = apBuffer->GetBool();
+			break;
+		case MaterialID::Translucent:
+			desc.m_translucent.m_blend = (eMaterialBlendMode)apBuffer->GetInt32();
+			desc.m_translucent.m_isAffectedByLightLevel = apBuffer->GetBool();
+			desc.m_translucent.m_hasRefraction = apBuffer->GetBool();
+			desc.m_translucent.m_refractionEdgeCheck = apBuffer->GetBool();
+			desc.m_translucent.m_refractionNormals = apBuffer->GetBool();
+			desc.m_translucent.m_refractionScale = apBuffer->GetFloat32();
+			desc.m_translucent.m_frenselBias = apBuffer->GetFloat32();
+			desc.m_translucent.m_frenselPow = apBuffer->GetFloat32();
+			desc.m_translucent.m_rimLightMul = apBuffer->GetFloat32();
+			desc.m_translucent.m_rimLightPow = apBuffer->GetFloat32();
+			break;
+		case MaterialID::Water:
+			desc.m_water.m_hasReflection = apBuffer->GetBool();
+			desc.m_water.m_isLargeSurface = apBuffer->GetBool();
+			desc.m_water.m_worldReflectionOcclusionTest = apBuffer->GetBool();
+			desc.m_water.m_refractionScale = apBuffer->GetFloat32();
+			desc.m_water.m_frenselBias = apBuffer->GetFloat32();
+			desc.m_water.m_frenselPow = apBuffer->GetFloat32();
+			desc.m_water.m_reflectionFadeStart = apBuffer->GetFloat32();
+			desc.m_water.m_reflectionFadeEnd = apBuffer->GetFloat32();
+			desc.m_water.m_waveSpeed = apBuffer->GetFloat32();
+			desc.m_water.m_waveAmplitude = apBuffer->GetFloat32();
+			desc.m_water.m_waveFreq = apBuffer->GetFloat32();
+			break;
+		case MaterialID::Decal:
+			desc.m_translucent.m_blend = (eMaterialBlendMode)apBuffer->GetInt32();
+			break;
+		default:
+			break;
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
+}
@@ -31,6 +31,29 @@
 
 namespace hpl {
 
+	//////////////////////////////////////////////////////////////////////////
+	// HELPERS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	static size_t GetMeshMemorySize(cMesh *apMesh)
+	{
+		size_t lSize =0;
+		for(int i=0; i<apMesh->GetSubMeshNum(); ++i)
+		{
+			cSubMesh *pSubMesh = apMesh->GetSubMesh(i);
+			for(auto& stream: pSubMesh->streamBuffers())
+			{
+				lSize += (size_t)stream.m_numberElements * stream.m_stride;
+			}
+			lSize += (size_t)pSubMesh->IndexStream().m_numberElements * sizeof(uint32_t);
+		}
+		return lSize;
+	}
+
+	//-----------------------------------------------------------------------
+
 	//////////////////////////////////////////////////////////////////////////
 	// CONSTRUCTORS
 	//////////////////////////////////////////////////////////////////////////
@@ -124,6 +147,7 @@ namespace hpl {
 				return NULL;
 			}
 
+			pMesh->SetSize(GetMeshMemorySize(pMesh));
 			AddResource(pMesh);
 		}
 
@@ -160,7 +184,7 @@ namespace hpl {
 	{
 		apResource->DecUserCount();
 
-		if(apResource->HasUsers()==false){
+		if(apResource->HasUsers()==false && KeepUnused(apResource)==false){
 			RemoveResource(apResource);
 			hplDelete(apResource);
 		}
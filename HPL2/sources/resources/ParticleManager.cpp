@@ -153,7 +153,12 @@ namespace hpl {
 
 	void cParticleManager::AddData(cParticleSystemData *apData)
 	{
+		//What a system created from the data allocates, the data itself is small.
+		apData->SetSize(apData->GetAllocatedSize());
 		AddResource(apData);
+
+		//Preloaded data has no users until a system is created from it
+		KeepUnused(apData);
 	}
 
 	//-----------------------------------------------------------------------
@@ -198,6 +203,8 @@ namespace hpl {
 		if(apResource->HasUsers())
 		{
 			apResource->DecUserCount();
+
+			if(apResource->HasUsers()==false) KeepUnused(apResource);
 		}
 	}
 
@@ -38,6 +38,8 @@ namespace hpl {
 		mlPrio = alPrio;
 		mlHandle = 0;
 		mlUserCount =0;
+		mlSize = 0;
+		mbInUnusedList = false;
 		msName = asName;
 		mbLogDestruction = false;
 		msFullPath = asFullPath;
@@ -47,6 +47,10 @@ namespace hpl {
 		mpFileSearcher = apFileSearcher;
 		mpLowLevelResources = apLowLevelResources;
 		mpLowLevelSystem = apLowLevelSystem;
+
+		mlMemoryBudget = 0;
+		mlMemoryUsage = 0;
+		mbDestroyingAll = false;
 	}
 
 	//-----------------------------------------------------------------------
@@ -129,8 +133,7 @@ namespace hpl {
 
 			if(pRes->HasUsers()==false)
 			{
-				RemoveResource(pRes);
-				hplDelete(pRes);
+				DestroyUnusedResource(pRes);
 			}
 		}
 		//Log("--------------------------------------\n");
@@ -142,6 +145,9 @@ namespace hpl {
 
 	void iResourceManager::DestroyAll()
 	{
+		//Destroy must free the resources now and not keep them around as unused
+		mbDestroyingAll = true;
+
 		tResourceBaseMapIt it = m_mapResources.begin();
 		while(it != m_mapResources.end())
 		{
@@ -160,6 +166,50 @@ namespace hpl {
 
 			//Log(" Done!\n");
 		}
+
+		mbDestroyingAll = false;
+	}
+
+	//-----------------------------------------------------------------------
+
+	size_t iResourceManager::GetUnusedMemoryUsage()
+	{
+		size_t lSize =0;
+		for(tResourceBaseListIt it = mlstUnused.begin(); it != mlstUnused.end(); ++it)
+		{
+			iResourceBase *pRes = *it;
+			if(pRes->HasUsers()==false) lSize += pRes->GetSize();
+		}
+		return lSize;
+	}
+
+	int iResourceManager::GetUnusedCount()
+	{
+		int lCount =0;
+		for(tResourceBaseListIt it = mlstUnused.begin(); it != mlstUnused.end(); ++it)
+		{
+			if((*it)->HasUsers()==false) ++lCount;
+		}
+		return lCount;
+	}
+
+	//-----------------------------------------------------------------------
+
+	void iResourceManager::EvictUnused()
+	{
+		if(mlMemoryBudget == 0) return;
+
+		//Oldest are first. Resources that got users again are left in the list until they are reached here.
+		while(mlMemoryUsage > mlMemoryBudget && mlstUnused.empty()==false)
+		{
+			iResourceBase *pRes = mlstUnused.front();
+			mlstUnused.pop_front();
+			pRes->mbInUnusedList = false;
+
+			if(pRes->HasUsers()) continue;
+
+			DestroyUnusedResource(pRes);
+		}
 	}
 
 	//-----------------------------------------------------------------------
@@ -217,6 +267,7 @@ namespace hpl {
 		{
 			int lHash = cString::GetHashW(apResource->GetFullPath());
 			m_mapResources.insert(tResourceBaseMap::value_type(lHash, apResource));
+			mlMemoryUsage += apResource->GetSize();
 		}
 
 		//Log("Adding %d, '%s' hash: %u\n",apResource,cString::To8Char(apResource->GetFullPath()).c_str(), lHash);
@@ -237,6 +288,12 @@ namespace hpl {
 	{
 		//Log("Removing resource name: '%s' path: '%s' ", apResource->GetName().c_str(), cString::To8Char(apResource->GetFullPath()).c_str());
 
+		if(apResource->mbInUnusedList)
+		{
+			mlstUnused.erase(apResource->mUnusedIt);
+			apResource->mbInUnusedList = false;
+		}
+
 		unsigned int lHash = cString::GetHashW(apResource->GetFullPath());
 
 		tResourceBaseMapIt it = m_mapResources.find(lHash);
@@ -257,6 +314,7 @@ namespace hpl {
 			{
 				//Log("...done!\n");
 				m_mapResources.erase(it);
+				mlMemoryUsage -= apResource->GetSize();
 				return;
 			}
 		}
@@ -264,5 +322,32 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 
+	bool iResourceManager::KeepUnused(iResourceBase* apResource)
+	{
+		if(mlMemoryBudget == 0 || mbDestroyingAll) return false;
+
+		//Move to the back, it is now the most recently used
+		if(apResource->mbInUnusedList)
+		{
+			mlstUnused.splice(mlstUnused.end(), mlstUnused, apResource->mUnusedIt);
+		}
+		else
+		{
+			apResource->mUnusedIt = mlstUnused.insert(mlstUnused.end(), apResource);
+			apResource->mbInUnusedList = true;
+		}
+
+		return true;
+	}
+
+	//-----------------------------------------------------------------------
+
+	void iResourceManager::DestroyUnusedResource(iResourceBase* apResource)
+	{
+		RemoveResource(apResource);
+		hplDelete(apResource);
+	}
+
+	//-----------------------------------------------------------------------
 
 }
@@ -39,9 +39,13 @@
 #include "resources/BitmapLoaderHandler.h"
 #include "resources/WorldLoaderHandler.h"
 #include "resources/BinaryBuffer.h"
+#include "resources/MapPreloader.h"
 
 #include "resources/WorldLoaderHplMap.h"
 
+#include "sound/Sound.h"
+#include "sound/LowLevelSound.h"
+
 #include "system/System.h"
 #include "system/LowLevelSystem.h"
 #include "system/String.h"
@@ -69,6 +73,7 @@ namespace hpl {
 		mpDefaultAreaLoader = NULL;
 
 		mpLanguageFile = NULL;
+		mpMapPreloader = NULL;
 	}
 
 	//-----------------------------------------------------------------------
@@ -86,6 +91,13 @@ namespace hpl {
 
         Interface<cTextureManager>::UnRegister(mpTextureManager);
 
+		//Stop preloading before any manager or the file searcher goes away
+		if(mpMapPreloader)
+		{
+			Interface<MapPreloader>::UnRegister(mpMapPreloader);
+			hplDelete(mpMapPreloader);
+		}
+
 		hplDelete(mpFontManager);
 		hplDelete(mpScriptManager);
 		hplDelete(mpParticleManager);
@@ -284,7 +296,7 @@ namespace hpl {
 		mpParticleManager = hplNew( cParticleManager,(apGraphics, this) );
 		mlstManagers.push_back(mpParticleManager);
 		mpSoundManager = hplNew( cSoundManager,(apSound, this) );
-		mlstManagers.push_back(mpParticleManager);
+		mlstManagers.push_back(mpSoundManager);
 		mpFontManager = hplNew( cFontManager,(apGraphics,apGui, this) );
 		mlstManagers.push_back(mpFontManager);
 		mpScriptManager = hplNew( cScriptManager,(apSystem, this) );
@@ -304,6 +316,12 @@ namespace hpl {
 
         Interface<cTextureManager>::Register(mpTextureManager);
 
+		Log(" Creating map preloader\n");
+		tStringList lstSoundFormats;
+		apSound->GetLowLevel()->GetSupportedFormats(lstSoundFormats);
+		mpMapPreloader = hplNew( MapPreloader,(mpFileSearcher, mpLowLevelResources, mpBitmapLoaderHandler, lstSoundFormats) );
+		Interface<MapPreloader>::Register(mpMapPreloader);
+
 		Log(" Adding loaders to handlers \n");
 
 		//Low level resources will load non-propitary formats.
@@ -326,6 +344,7 @@ namespace hpl {
 			iResourceManager *pManager = *it;
 
 			pManager->Update(afTimeStep);
+			pManager->EvictUnused();
 		}
 	}
 
@@ -371,10 +390,10 @@ namespace hpl {
 
 	void cResources::ClearTranslations()
 	{
+		//Only the texts are removed so ids already handed out stay valid
 		if(mpLanguageFile)
 		{
-			hplDelete(mpLanguageFile);
-			mpLanguageFile = NULL;
+			mpLanguageFile->Clear();
 		}
 	}
 
@@ -390,6 +409,28 @@ namespace hpl {
 		}
 	}
 
+	const tWString& cResources::Translate(tLanguageEntryId alId)
+	{
+		if(mpLanguageFile)
+		{
+			return mpLanguageFile->Translate(alId);
+		}
+		else
+		{
+			return mwsEmptyString;
+		}
+	}
+
+	tLanguageEntryId cResources::GetTranslationId(const tString& asCat, const tString& asName)
+	{
+		if(mpLanguageFile == NULL)
+		{
+			mpLanguageFile = hplNew( cLanguageFile, (this) );
+		}
+
+		return mpLanguageFile->GetEntryId(asCat, asName);
+	}
+
 	//-----------------------------------------------------------------------
 
 	void cResources::AddEntityLoader(iEntityLoader* apLoader, bool abSetAsDefault)
@@ -472,6 +513,20 @@ namespace hpl {
 				continue;
 			}
 
+			//Manifest from the texture cooker, mapping source images to compressed dds files.
+			if(pChildElem->GetValue() == "CookedTextures")
+			{
+				LoadCookedTexturesFile(cString::To16Char(sPath));
+				continue;
+			}
+
+			//Binary file with compiled materials, created if missing.
+			if(pChildElem->GetValue() == "MaterialDatabase")
+			{
+				mpMaterialManager->SetDatabaseFile(cString::To16Char(sPath));
+				continue;
+			}
+
 			bool bAddSubDirs = pChildElem->GetAttributeBool("AddSubDirs",false);
 
 			if(sPath[0]=='/' || sPath[0]=='\\') sPath = cString::Sub(sPath, 1);
@@ -489,6 +544,37 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 
+	bool cResources::LoadCookedTexturesFile(const tWString &asFile)
+	{
+		iXmlDocument* pDoc = mpLowLevelResources->CreateXmlDocument();
+		if(pDoc->CreateFromFile(asFile)==false)
+		{
+			Warning("Couldn't load cooked textures file '%s'!\n",cString::To8Char(asFile).c_str());
+			hplDelete( pDoc);
+			return false;
+		}
+
+		int lCount=0;
+		cXmlNodeListIterator it = pDoc->GetChildIterator();
+		while(it.HasNext())
+		{
+			cXmlElement *pChildElem = it.Next()->ToElement();
+
+			tString sSource = pChildElem->GetAttributeString("Source");
+			tString sCooked = pChildElem->GetAttributeString("Cooked");
+			if(sSource=="" || sCooked=="") continue;
+
+			mpFileSearcher->AddCookedFile(cString::To16Char(sSource), cString::To16Char(sCooked));
+			++lCount;
+		}
+		Log(" Loaded %d cooked textures from '%s'\n", lCount, cString::To8Char(asFile).c_str());
+
+		hplDelete( pDoc);
+		return true;
+	}
+
+	//-----------------------------------------------------------------------
+
 	iXmlDocument* cResources::LoadXmlDocument(const tString& asFile)
 	{
 		tWString sPath = mpFileSearcher->GetFilePath(asFile);
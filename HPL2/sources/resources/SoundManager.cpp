@@ -92,8 +92,12 @@ namespace hpl {
 				pSound = mpSound->GetLowLevel()->LoadSoundData(	asName,sPath,"",abStream, abLoopStream);
 				if(pSound)
 				{
+					pSound->SetSize(pSound->GetMemorySize());
 					AddResource(pSound);
 					pSound->SetSoundManager(mpResources->GetSoundManager());
+
+					//Samples are often loaded without being played right away, so they start out as unused.
+					KeepUnused(pSound);
 				}
 			}
 		}
@@ -118,9 +122,10 @@ namespace hpl {
 		apResource->DecUserCount();
 
 		iSoundData *pData = static_cast<iSoundData *>(apResource);
-		if(pData->IsStream() && pData->HasUsers()==false)
+		if(pData->HasUsers()==false)
 		{
-			STLFindAndDelete(mlstStreamData, pData);
+			if(pData->IsStream())	STLFindAndDelete(mlstStreamData, pData);
+			else					KeepUnused(pData);
 		}
 	}
 
@@ -28,10 +28,13 @@
 #include "resources/BitmapLoaderHandler.h"
 #include "resources/FileSearcher.h"
 #include "resources/LowLevelResources.h"
+#include "resources/MapPreloader.h"
 #include "resources/Resources.h"
 #include "system/LowLevelSystem.h"
+#include "system/Platform.h"
 #include "system/String.h"
 
+#include <algorithm>
 #include <memory>
 #include <vector>
 
@@ -55,7 +58,8 @@ namespace hpl {
 
 		mpBitmapLoaderHandler = mpResources->GetBitmapLoaderHandler();
 
-		mlMemoryUsage =0;
+		mlDecodedBitmapCount =0;
+		mlBitmapDecodeTime =0;
 
 		mvCubeSideSuffixes.push_back("_pos_x");
 		mvCubeSideSuffixes.push_back("_neg_x");
@@ -68,6 +72,7 @@ namespace hpl {
 	cTextureManager::~cTextureManager()
 	{
 		STLMapDeleteAll(m_mapAttenuationTextures);
+		DestroyPreparedBitmaps();
 		DestroyAll();
 		Log(" Destroyed all textures\n");
 	}
@@ -81,7 +86,7 @@ namespace hpl {
 		if( resource==NULL && sPath!=_W(""))
 		{
 			// pTexture = FindTexture2D(asName,sPath);
-			cBitmap *pBmp = mpBitmapLoaderHandler->LoadBitmap(sPath,0);
+			cBitmap *pBmp = LoadImageBitmap(sPath);
 			if(!pBmp) {
 
 				Error("Texture manager Couldn't load bitmap '%s'\n", cString::To8Char(sPath).c_str());
@@ -93,7 +98,7 @@ namespace hpl {
 			//Bitmap is no longer needed so delete it.
 			hplDelete(pBmp);
 
-			// mlMemoryUsage += pTexture->GetMemorySize();
+			resource->SetSize(resource->GetMemorySize());
 			AddResource(resource);
 		}
 
@@ -190,17 +195,15 @@ namespace hpl {
 
 			//Load bitmaps for all faces
 			std::vector<cBitmap*> vBitmaps;
+			LoadImageBitmaps(vPaths, vBitmaps);
 			for(int i=0;i<6; i++)
 			{
-				cBitmap* pBmp = mpBitmapLoaderHandler->LoadBitmap(vPaths[i],0);
-				if(pBmp==NULL){
+				if(vBitmaps[i]==NULL){
 					Error("Couldn't load bitmap '%s'!\n",cString::To8Char(vPaths[i]).c_str());
-					for(int j=0;j<(int)vBitmaps.size();j++) hplDelete(vBitmaps[j]);
+					for(int j=0;j<(int)vBitmaps.size();j++) if(vBitmaps[j]) hplDelete(vBitmaps[j]);
 					EndLoad();
 					return NULL;
 				}
-
-				vBitmaps.push_back(pBmp);
 			}
 			ASSERT(vBitmaps.size() == 6 && "vBitmaps.size() == 6");
 
@@ -308,25 +311,24 @@ namespace hpl {
                     }
 
                     std::vector<cBitmap*> vBitmaps;
+                    LoadImageBitmaps(vPaths, vBitmaps);
                     for (size_t i = 0; i < vPaths.size(); ++i) {
-                            cBitmap* pBmp = mpBitmapLoaderHandler->LoadBitmap(vPaths[i], 0);
-                            if (pBmp == NULL) {
+                            if (vBitmaps[i] == NULL) {
                                     Error("Couldn't load bitmap '%s'!\n", cString::To8Char(vPaths[i]).c_str());
 
                                     for (int j = 0; j < (int)vBitmaps.size(); j++)
-                                        hplDelete(vBitmaps[j]);
+                                        if (vBitmaps[j]) hplDelete(vBitmaps[j]);
 
                                     EndLoad();
                                     return NULL;
                             }
-
-                            vBitmaps.push_back(pBmp);
                     }
 
                     // Create the animated texture
 
                     animatedImage = new AnimatedImage(sBaseName, sFakeFullPath);
                     std::vector<std::unique_ptr<Image>> images;
+                    size_t lSize = 0;
                     for (auto& bitmap : vBitmaps) {
                             std::unique_ptr<Image> image = std::make_unique<Image>();
 
@@ -337,9 +339,11 @@ namespace hpl {
                             image->SetForgeTexture(std::move(handle));
 
                             // Image::InitializeFromBitmap(*image, *bitmap, desc);
+                            lSize += image->GetMemorySize();
                             images.push_back(std::move(image));
                     }
                     animatedImage->Initialize(std::span(images));
+                    animatedImage->SetSize(lSize);
 
                     AddResource(animatedImage);
             }
@@ -381,6 +385,42 @@ namespace hpl {
     }
 
 
+	void cTextureManager::PrepareImages(const tStringVec& avNames)
+	{
+		//Anything left over from the last batch was never asked for
+		DestroyPreparedBitmaps();
+
+		tWStringVec vPaths;
+		for(const tString& sName : avNames)
+		{
+			tWString sPath;
+			Image* pImage = FindImageResource(sName, sPath);
+			if(pImage || sPath==_W("")) continue;
+			if(std::find(vPaths.begin(), vPaths.end(), sPath) != vPaths.end()) continue;
+
+			vPaths.push_back(sPath);
+		}
+		if(vPaths.size() < 2) return; //Nothing to gain
+
+		std::vector<cBitmap*> vBitmaps;
+		LoadImageBitmaps(vPaths, vBitmaps);
+		for(size_t i=0; i<vPaths.size(); ++i)
+		{
+			//Failed files are loaded again by the create call so the error ends up in the usual place
+			if(vBitmaps[i]) m_preparedBitmaps[vPaths[i]] = vBitmaps[i];
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cTextureManager::ResetDecodeStats()
+	{
+		mlDecodedBitmapCount =0;
+		mlBitmapDecodeTime =0;
+	}
+
+	//-----------------------------------------------------------------------
+
 	void cTextureManager::Unload(iResourceBase* apResource)
 	{
 
@@ -391,7 +431,7 @@ namespace hpl {
 	{
 		apResource->DecUserCount();
 
-		if(apResource->HasUsers()==false)
+		if(apResource->HasUsers()==false && KeepUnused(apResource)==false)
 		{
 			RemoveResource(apResource);
 			delete apResource;
@@ -400,6 +440,15 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 
+	void cTextureManager::DestroyUnusedResource(iResourceBase* apResource)
+	{
+		//Images are not created with hplNew
+		RemoveResource(apResource);
+		delete apResource;
+	}
+
+	//-----------------------------------------------------------------------
+
 	void cTextureManager::Update(float afTimeStep)
 	{
 		for(auto& res: m_mapResources) {
@@ -445,6 +494,69 @@ namespace hpl {
 	}
 
 
+	cBitmap* cTextureManager::LoadImageBitmap(const tWString& asPath)
+	{
+		auto it = m_preparedBitmaps.find(asPath);
+		if(it != m_preparedBitmaps.end())
+		{
+			cBitmap *pBmp = it->second;
+			m_preparedBitmaps.erase(it);
+			return pBmp;
+		}
+
+		//The map preloader might already have decoded the image on its worker thread
+		if(cBitmap *pPreloadedBmp = mpResources->GetMapPreloader()->TakeBitmap(asPath))
+		{
+			return pPreloadedBmp;
+		}
+
+		unsigned long lStartTime = cPlatform::GetApplicationTime();
+		cBitmap *pBmp = mpBitmapLoaderHandler->LoadBitmap(mpFileSearcher->GetCookedFilePath(asPath),0);
+		mlBitmapDecodeTime += cPlatform::GetApplicationTime() - lStartTime;
+		if(pBmp) mlDecodedBitmapCount++;
+
+		return pBmp;
+	}
+
+	void cTextureManager::LoadImageBitmaps(const tWStringVec& avPaths, std::vector<cBitmap*>& avBitmaps)
+	{
+		avBitmaps.assign(avPaths.size(), NULL);
+
+		//Resources keep the source path as name, only the file read is swapped for the cooked one.
+		//Images the map preloader already decoded are not read again.
+		std::vector<size_t> vLoadIndices;
+		tWStringVec vLoadPaths;
+		for(size_t i=0; i<avPaths.size(); ++i)
+		{
+			avBitmaps[i] = mpResources->GetMapPreloader()->TakeBitmap(avPaths[i]);
+			if(avBitmaps[i]) continue;
+
+			vLoadIndices.push_back(i);
+			vLoadPaths.push_back(mpFileSearcher->GetCookedFilePath(avPaths[i]));
+		}
+		if(vLoadPaths.empty()) return;
+
+		std::vector<cBitmap*> vLoadedBitmaps;
+		unsigned long lStartTime = cPlatform::GetApplicationTime();
+		mpBitmapLoaderHandler->LoadBitmaps(vLoadPaths, 0, vLoadedBitmaps);
+		mlBitmapDecodeTime += cPlatform::GetApplicationTime() - lStartTime;
+
+		for(size_t i=0; i<vLoadIndices.size(); ++i)
+		{
+			avBitmaps[vLoadIndices[i]] = vLoadedBitmaps[i];
+			if(vLoadedBitmaps[i]) mlDecodedBitmapCount++;
+		}
+	}
+
+	void cTextureManager::DestroyPreparedBitmaps()
+	{
+		for(auto& prepared : m_preparedBitmaps)
+		{
+			hplDelete(prepared.second);
+		}
+		m_preparedBitmaps.clear();
+	}
+
 	iTexture* cTextureManager::FindTexture2D(const tString &asName, tWString &asFilePath)
 	{
 		iTexture *pTexture=NULL;
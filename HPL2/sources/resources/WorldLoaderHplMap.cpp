@@ -31,12 +31,15 @@
 #include "system/Platform.h"
 
 #include "resources/Resources.h"
+#include "resources/MapPreloader.h"
 #include "resources/MeshManager.h"
 #include "resources/MaterialManager.h"
+#include "resources/MaterialDatabase.h"
 #include "resources/TextureManager.h"
 #include "resources/LowLevelResources.h"
 #include "resources/XmlDocument.h"
 #include "resources/EngineFileLoading.h"
+#include "resources/EntityPrototype.h"
 #include "resources/BinaryBuffer.h"
 
 #include "scene/Scene.h"
@@ -110,6 +113,9 @@ namespace hpl {
 	cWorld* cWorldLoaderHplMap::LoadWorld(const tWString& asFile,tWorldLoadFlag aFlags)
 	{
 		unsigned long lLoadStartTime = cPlatform::GetApplicationTime();
+		mpResources->GetTextureManager()->ResetDecodeStats();
+		cMaterialDatabase *pMaterialDatabase = mpResources->GetMaterialManager()->GetDatabase();
+		if(pMaterialDatabase) pMaterialDatabase->ResetStats();
 		mlCurrentFlags = aFlags;
 		bool bLoadedFromNormalFile=false;
 
@@ -119,7 +125,14 @@ namespace hpl {
 		tWString sExt = cString::ToLowerCaseW(cString::GetFileExtW(asFile));
 		if(sExt != _W("cmap"))
 		{
-			if(pDoc->CreateFromFile(asFile)==false)
+			//Use the document parsed by the preloader if there is one
+			iXmlDocument* pPreloadedDoc = mpResources->GetMapPreloader()->TakeXmlDocument(asFile);
+			if(pPreloadedDoc)
+			{
+				hplDelete(pDoc);
+				pDoc = pPreloadedDoc;
+			}
+			else if(pDoc->CreateFromFile(asFile)==false)
 			{
 				hplDelete(pDoc);
 
@@ -283,10 +296,15 @@ namespace hpl {
 		// Load rest of entities
 		if( (mlCurrentFlags & eWorldLoadFlag_NoEntities)==0)
 		{
+			cEntityPrototype::ResetLoadStats();
 			lStartTime = cPlatform::GetApplicationTime();
 			LoadEntities(pXmlContents);
 			lDeltaTime = cPlatform::GetApplicationTime() - lStartTime;
 			LOGF_IF(LogLevel::eDEBUG, gbLogTiming,"  Entities: %d ms", lDeltaTime);
+
+			const cEntityLoadStats& entityStats = cEntityPrototype::GetLoadStats();
+			LOGF_IF(LogLevel::eDEBUG, gbLogTiming,"   Ent files compiled: %d in %.1f ms, instances: %d in %.1f ms",
+				entityStats.mlPrototypesCompiled, entityStats.mfCompileTime, entityStats.mlInstancesCreated, entityStats.mfInstanceTime);
 		}
 
 		//////////////////////////////
@@ -310,6 +328,19 @@ namespace hpl {
 		lDeltaTime = cPlatform::GetApplicationTime() - lLoadStartTime;
 		if(gbLogTiming) Log("  Total: %d ms\n", lDeltaTime);
 
+		{
+			cTextureManager *pTextureManager = mpResources->GetTextureManager();
+			unsigned long lDecodeTime = pTextureManager->GetBitmapDecodeTime();
+			LOGF_IF(LogLevel::eDEBUG, gbLogTiming,"  Textures decoded: %d in %d ms (%.1f per second)", pTextureManager->GetDecodedBitmapCount(), lDecodeTime,
+				lDecodeTime > 0 ? (float)pTextureManager->GetDecodedBitmapCount() * 1000.0f / (float)lDecodeTime : 0.0f);
+		}
+
+		if(pMaterialDatabase)
+		{
+			LOGF_IF(LogLevel::eDEBUG, gbLogTiming,"  Materials from database: %d, compiled: %d", pMaterialDatabase->GetHits(), pMaterialDatabase->GetCompiled());
+			mpResources->GetMaterialManager()->SaveDatabase();
+		}
+
 		LOGF_IF(LogLevel::eDEBUG, gbLogTiming,"  Meshes created: %d", mlStaticMeshEntitiesCreated);
 	    LOGF_IF(LogLevel::eDEBUG, gbLogTiming,"  Bodies created: %d", mlStaticMeshBodiesCreated);
 
@@ -59,6 +59,8 @@ namespace hpl {
 		mfSpecialEventTime =0;
 
 		mfFadeStep=0;
+
+		mvTrackCursors.resize(mpAnimation->GetTrackNum(), 0);
 	}
 
 	//-----------------------------------------------------------------------
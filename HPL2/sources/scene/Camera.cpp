@@ -75,6 +75,8 @@ namespace hpl {
 		mfYawLimitMin =0;
 		mfYawLimitMax =0;
 
+		mlInterpolationTick = -1;
+		mbInterpolationApplied = false;
 	}
 
 	//-----------------------------------------------------------------------
@@ -536,6 +538,73 @@ namespace hpl {
 	//-----------------------------------------------------------------------
 
 
+	void cCamera::EndInterpolationTick()
+	{
+		//Already done for this update by another viewport
+		if(mlInterpolationTick == iEntity3D::GetInterpolationTick()) return;
+
+		RestoreInterpolation();
+
+		mvInterpolationPrevPosition = mvInterpolationPosition;
+		m_mtxInterpolationPrevView = m_mtxInterpolationView;
+		mvInterpolationPosition = mvPosition;
+		m_mtxInterpolationView = GetViewMatrix();
+
+		//Not kept at the update before, so there is nothing to interpolate from
+		if(mlInterpolationTick != iEntity3D::GetInterpolationTick()-1)
+		{
+			mvInterpolationPrevPosition = mvInterpolationPosition;
+			m_mtxInterpolationPrevView = m_mtxInterpolationView;
+		}
+
+		mlInterpolationTick = iEntity3D::GetInterpolationTick();
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cCamera::ApplyInterpolation(float afT)
+	{
+		if(mbInterpolationApplied || afT >= 1) return;
+		if(mlInterpolationTick != iEntity3D::GetInterpolationTick()-1) return;
+
+		//Changed after the last update, shown as it is and the next update interpolates from here
+		if(mvPosition != mvInterpolationPosition || GetViewMatrix() != m_mtxInterpolationView)
+		{
+			mvInterpolationPosition = mvPosition;
+			m_mtxInterpolationView = GetViewMatrix();
+			return;
+		}
+		if(mvInterpolationPrevPosition == mvInterpolationPosition && m_mtxInterpolationPrevView == m_mtxInterpolationView) return;
+
+		float fMaxDist = iEntity3D::GetInterpolationMaxDistance();
+		if(cMath::Vector3DistSqr(mvInterpolationPrevPosition, mvInterpolationPosition) > fMaxDist*fMaxDist) return;
+
+		mvInterpolationRestorePosition = mvPosition;
+		mvPosition = mvInterpolationPrevPosition * (1 - afT) + mvInterpolationPosition * afT;
+
+		cMatrixf mtxRotation = cMath::MatrixSlerp(afT, m_mtxInterpolationPrevView.GetRotation(), m_mtxInterpolationView.GetRotation(), true);
+		m_mtxView = cMath::MatrixMul(mtxRotation, cMath::MatrixTranslate(mvPosition*-1));
+
+		mbViewUpdated = false;
+		mbFrustumUpdated = true;
+		mbInterpolationApplied = true;
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cCamera::RestoreInterpolation()
+	{
+		if(mbInterpolationApplied==false) return;
+
+		mvPosition = mvInterpolationRestorePosition;
+
+		mbViewUpdated = true;
+		mbFrustumUpdated = true;
+		mbInterpolationApplied = false;
+	}
+
+	//-----------------------------------------------------------------------
+
 	cVector3f cCamera::GetForward()
 	{
 		return GetViewMatrix().GetForward()*-1.0f;
@@ -23,8 +23,38 @@
 
 #include "system/LowLevelSystem.h"
 
+#include <algorithm>
+
 namespace hpl {
 
+	//////////////////////////////////////////////////////////////////////////
+	// STATIC VARIABLES
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	std::vector<iEntity3D*> iEntity3D::mvPendingTransformEntities;
+	std::vector<std::pair<int, iEntity3D*> > iEntity3D::mvSortedPendingTransformEntities;
+	int iEntity3D::mlTransformGeneration = 0;
+
+	std::vector<iEntity3D*> iEntity3D::mvInterpolationQueue;
+	std::vector<iEntity3D*> iEntity3D::mvInterpolatedEntities;
+	std::vector<iEntity3D*> iEntity3D::mvInterpolationAppliedEntities;
+	bool iEntity3D::mbInterpolationEnabled = false;
+	bool iEntity3D::mbInterpolationApplied = false;
+	float iEntity3D::mfInterpolationFraction = 1.0f;
+	int iEntity3D::mlInterpolationTick = 0;
+	int iEntity3D::mlInterpolationStartTick = 0;
+	float iEntity3D::mfInterpolationMaxDistance = 2.0f;
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// CONSTRUCTORS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
 	iEntity3D::iEntity3D(tString asName)
 	{
 		msName = asName;
@@ -37,6 +67,16 @@ namespace hpl {
 
 		mbTransformUpdated = true;
 
+		mbChildTransformsPending = false;
+		mbInPendingTransformQueue = false;
+		mlResolvedTransformGeneration = -1;
+
+		mbRenderInterpolated = false;
+		mbInInterpolationQueue = false;
+		mbInInterpolatedList = false;
+		mbInterpolatedTransformSet = false;
+		mlInterpolationKeptTick = -1;
+
 		mlCount = 0;
 
 		msSourceFile = "";
@@ -54,6 +94,20 @@ namespace hpl {
 
 	iEntity3D::~iEntity3D()
 	{
+		if(mbInPendingTransformQueue)
+			STLFindAndRemove(mvPendingTransformEntities, this);
+		//A transform callback can destroy an entity while UpdatePendingTransforms is running, it skips cleared entries.
+		for(size_t i=0; i<mvSortedPendingTransformEntities.size(); ++i)
+		{
+			if(mvSortedPendingTransformEntities[i].second == this) mvSortedPendingTransformEntities[i].second = NULL;
+		}
+		if(mbInInterpolationQueue)
+			STLFindAndRemove(mvInterpolationQueue, this);
+		if(mbInInterpolatedList)
+			STLFindAndRemove(mvInterpolatedEntities, this);
+		if(mbInterpolatedTransformSet)
+			STLFindAndRemove(mvInterpolationAppliedEntities, this);
+
 		if(mpParentNode)
 			mpParentNode->RemoveEntity(this);
 		else if(mpParent)
@@ -163,42 +217,202 @@ namespace hpl {
 
 	void iEntity3D::SetTransformUpdated(bool abUpdateCallbacks)
 	{
-		mbTransformUpdated = true;
-		mlCount++;
+		MarkTransformUpdated(abUpdateCallbacks);
 
-		mbUpdateBoundingVolume = true;
+		if(mlstChildren.empty() && mlstNodeChildren.empty()) return;
 
-		OnTransformUpdated();
+		////////////////////////////
+		// Children are updated later, so moving the same parent many times a frame only updates them once.
+		if(mbChildTransformsPending==false)
+		{
+			mbChildTransformsPending = true;
+			++mlTransformGeneration;
+		}
+		if(mbInPendingTransformQueue==false)
+		{
+			mbInPendingTransformQueue = true;
+			mvPendingTransformEntities.push_back(this);
+		}
+	}
 
-		//Update children
-		for(tEntity3DListIt EntIt = mlstChildren.begin(); EntIt != mlstChildren.end();++EntIt)
+	//-----------------------------------------------------------------------
+
+	void iEntity3D::UpdatePendingTransforms()
+	{
+		////////////////////////////
+		// Updating children through nodes can add new entities, so loop until nothing is left
+		while(mvPendingTransformEntities.empty()==false)
 		{
-			iEntity3D *pChild = *EntIt;
-			pChild->SetTransformUpdated(true);
+			mvSortedPendingTransformEntities.clear();
+			for(size_t i=0; i<mvPendingTransformEntities.size(); ++i)
+			{
+				iEntity3D *pEntity = mvPendingTransformEntities[i];
+				pEntity->mbInPendingTransformQueue = false;
+
+				if(pEntity->mbChildTransformsPending)
+					mvSortedPendingTransformEntities.push_back(std::pair<int, iEntity3D*>(GetHierarchyDepth(pEntity), pEntity));
+			}
+			mvPendingTransformEntities.clear();
+
+			////////////////////////////
+			// Parents first, updating a parent also updates any pending entity below it.
+			std::stable_sort(mvSortedPendingTransformEntities.begin(), mvSortedPendingTransformEntities.end(),
+							[](const std::pair<int, iEntity3D*>& aA, const std::pair<int, iEntity3D*>& aB){ return aA.first < aB.first;});
+
+			for(size_t i=0; i<mvSortedPendingTransformEntities.size(); ++i)
+			{
+				iEntity3D *pEntity = mvSortedPendingTransformEntities[i].second;
+				if(pEntity && pEntity->mbChildTransformsPending)
+					pEntity->PropagateTransformToChildren();
+			}
 		}
+		mvSortedPendingTransformEntities.clear();
+	}
 
-		//Update node children
-		for(tNode3DListIt nodeIt = mlstNodeChildren.begin(); nodeIt != mlstNodeChildren.end();++nodeIt)
+	//-----------------------------------------------------------------------
+
+	void iEntity3D::SetInterpolationEnabled(bool abX)
+	{
+		if(mbInterpolationEnabled == abX) return;
+
+		RestoreInterpolation();
+		mbInterpolationEnabled = abX;
+		mlInterpolationStartTick = mlInterpolationTick;
+
+		for(size_t i=0; i<mvInterpolationQueue.size(); ++i) mvInterpolationQueue[i]->mbInInterpolationQueue = false;
+		for(size_t i=0; i<mvInterpolatedEntities.size(); ++i) mvInterpolatedEntities[i]->mbInInterpolatedList = false;
+		mvInterpolationQueue.clear();
+		mvInterpolatedEntities.clear();
+	}
+
+	//-----------------------------------------------------------------------
+
+	void iEntity3D::EndInterpolationTick()
+	{
+		if(mbInterpolationEnabled==false) return;
+
+		RestoreInterpolation();
+
+		//The world transforms are taken below, so have all children updated first
+		UpdatePendingTransforms();
+
+		for(size_t i=0; i<mvInterpolatedEntities.size(); ++i) mvInterpolatedEntities[i]->mbInInterpolatedList = false;
+		mvInterpolatedEntities.clear();
+
+		////////////////////////////
+		// Keep the transform from before and after this update
+		for(size_t i=0; i<mvInterpolationQueue.size(); ++i)
 		{
-			cNode3D *pNode = *nodeIt;
-			pNode->SetWorldTransformUpdated();
+			iEntity3D *pEntity = mvInterpolationQueue[i];
+			pEntity->mbInInterpolationQueue = false;
+
+			//No transform kept since interpolation was enabled, so start from where it is now
+			if(pEntity->mlInterpolationKeptTick < mlInterpolationStartTick)
+				pEntity->m_mtxInterpolationCurrent = pEntity->GetWorldMatrix();
+
+			pEntity->m_mtxInterpolationPrev = pEntity->m_mtxInterpolationCurrent;
+			pEntity->m_mtxInterpolationCurrent = pEntity->GetWorldMatrix();
+			pEntity->mlInterpolationKeptTick = mlInterpolationTick;
+
+			pEntity->OnInterpolationTick();
+
+			pEntity->mbInInterpolatedList = true;
+			mvInterpolatedEntities.push_back(pEntity);
 		}
+		mvInterpolationQueue.clear();
 
-		//Update callbacks
-		if(mlstCallbacks.empty() || abUpdateCallbacks==false) return;
+		++mlInterpolationTick;
+	}
 
-		tEntityCallbackListIt it = mlstCallbacks.begin();
-		for(; it!= mlstCallbacks.end(); ++it)
+	//-----------------------------------------------------------------------
+
+	void iEntity3D::ApplyInterpolation(float afT)
+	{
+		if(mbInterpolationEnabled==false) return;
+
+		RestoreInterpolation();
+
+		mbInterpolationApplied = true;
+		mfInterpolationFraction = afT;
+
+		UpdatePendingTransforms();
+
+		////////////////////////////
+		// Entities changed after the last update are shown as they are, so the next update interpolates from there.
+		for(size_t i=0; i<mvInterpolationQueue.size(); ++i)
 		{
-			iEntityCallback* pCallback = *it;
-			pCallback->OnTransformUpdate(this);
+			iEntity3D *pEntity = mvInterpolationQueue[i];
+			pEntity->m_mtxInterpolationCurrent = pEntity->GetWorldMatrix();
+		}
+
+		if(afT >= 1) return;
+
+		////////////////////////////
+		// Get all world transforms before any is changed, so none is created from an interpolated parent.
+		// Only the direct children are created from the parent, below that they are from the children.
+		for(size_t i=0; i<mvInterpolatedEntities.size(); ++i)
+		{
+			iEntity3D *pEntity = mvInterpolatedEntities[i];
+			pEntity->GetWorldMatrix();
+			for(tEntity3DListIt it = pEntity->mlstChildren.begin(); it != pEntity->mlstChildren.end(); ++it)
+			{
+				(*it)->GetWorldMatrix();
+			}
+			for(tNode3DListIt it = pEntity->mlstNodeChildren.begin(); it != pEntity->mlstNodeChildren.end(); ++it)
+			{
+				(*it)->GetWorldMatrix();
+			}
+		}
+
+		////////////////////////////
+		// Set the interpolated transforms
+		float fMaxDistSqr = mfInterpolationMaxDistance * mfInterpolationMaxDistance;
+		for(size_t i=0; i<mvInterpolatedEntities.size(); ++i)
+		{
+			iEntity3D *pEntity = mvInterpolatedEntities[i];
+
+			if(pEntity->mbRenderInterpolated==false || pEntity->mbInInterpolationQueue) continue;
+
+			const cMatrixf &mtxPrev = pEntity->m_mtxInterpolationPrev;
+			const cMatrixf &mtxCurrent = pEntity->m_mtxInterpolationCurrent;
+			if(mtxPrev == mtxCurrent) continue;
+			if(cMath::Vector3DistSqr(mtxPrev.GetTranslation(), mtxCurrent.GetTranslation()) > fMaxDistSqr) continue;
+
+			pEntity->m_mtxWorldTransform = cMath::MatrixSlerpScaled(afT, mtxPrev, mtxCurrent);
+			pEntity->mbUpdateBoundingVolume = true;
+			pEntity->mlCount++;
+
+			pEntity->mbInterpolatedTransformSet = true;
+			mvInterpolationAppliedEntities.push_back(pEntity);
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
+	void iEntity3D::RestoreInterpolation()
+	{
+		mbInterpolationApplied = false;
+		mfInterpolationFraction = 1.0f;
+
+		////////////////////////////
+		// Have the world transforms created again from the local ones
+		for(size_t i=0; i<mvInterpolationAppliedEntities.size(); ++i)
+		{
+			iEntity3D *pEntity = mvInterpolationAppliedEntities[i];
+			pEntity->mbInterpolatedTransformSet = false;
+			pEntity->mbTransformUpdated = true;
+			pEntity->mbUpdateBoundingVolume = true;
+			pEntity->mlCount++;
 		}
+		mvInterpolationAppliedEntities.clear();
 	}
 
 	//-----------------------------------------------------------------------
 
 	bool iEntity3D::GetTransformUpdated()
 	{
+		ResolvePendingParentTransforms();
+
 		return mbTransformUpdated;
 	}
 
@@ -206,6 +420,8 @@ namespace hpl {
 
 	int iEntity3D::GetTransformUpdateCount()
 	{
+		ResolvePendingParentTransforms();
+
 		return mlCount;
 	}
 
@@ -213,6 +429,8 @@ namespace hpl {
 
 	cBoundingVolume* iEntity3D::GetBoundingVolume()
 	{
+		ResolvePendingParentTransforms();
+
 		if(mbApplyTransformToBV && mbUpdateBoundingVolume)
 		{
 			mBoundingVolume.SetTransform(GetWorldMatrix());
@@ -334,6 +552,8 @@ namespace hpl {
 
 	void iEntity3D::UpdateWorldTransform()
 	{
+		ResolvePendingParentTransforms();
+
 		if(mbTransformUpdated)
 		{
 			//Log("CREATING Entity '%s' world transform!\n",msName.c_str());
@@ -361,4 +581,146 @@ namespace hpl {
 	}
 
 	//-----------------------------------------------------------------------
+
+	void iEntity3D::MarkTransformUpdated(bool abUpdateCallbacks)
+	{
+		mbTransformUpdated = true;
+		mlCount++;
+
+		mbUpdateBoundingVolume = true;
+
+		if(mbInterpolationEnabled && mbRenderInterpolated) RequestInterpolationTick();
+
+		OnTransformUpdated();
+
+		//Update callbacks
+		if(mlstCallbacks.empty() || abUpdateCallbacks==false) return;
+
+		tEntityCallbackListIt it = mlstCallbacks.begin();
+		for(; it!= mlstCallbacks.end(); ++it)
+		{
+			iEntityCallback* pCallback = *it;
+			pCallback->OnTransformUpdate(this);
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
+	void iEntity3D::RequestInterpolationTick()
+	{
+		if(mbInterpolationEnabled==false || mbInInterpolationQueue) return;
+
+		mbInInterpolationQueue = true;
+		mvInterpolationQueue.push_back(this);
+	}
+
+	//-----------------------------------------------------------------------
+
+	void iEntity3D::PropagateTransformToChildren()
+	{
+		mbChildTransformsPending = false;
+
+		//Update children
+		for(tEntity3DListIt EntIt = mlstChildren.begin(); EntIt != mlstChildren.end();++EntIt)
+		{
+			iEntity3D *pChild = *EntIt;
+			pChild->MarkTransformUpdated(true);
+			pChild->PropagateTransformToChildren();
+		}
+
+		//Update node children
+		for(tNode3DListIt nodeIt = mlstNodeChildren.begin(); nodeIt != mlstNodeChildren.end();++nodeIt)
+		{
+			cNode3D *pNode = *nodeIt;
+			pNode->SetWorldTransformUpdated();
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
+	void iEntity3D::ResolvePendingParentTransforms()
+	{
+		//Nothing has been moved since the last check
+		while(mlResolvedTransformGeneration != mlTransformGeneration)
+		{
+			mlResolvedTransformGeneration = mlTransformGeneration;
+
+			iEntity3D *pTop = GetTopPendingEntity(mpParentNode ? NULL : mpParent, mpParentNode);
+			if(pTop) pTop->PropagateTransformToChildren();
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
+	iEntity3D* iEntity3D::GetTopPendingEntity(iEntity3D *apParent, cNode3D *apParentNode)
+	{
+		iEntity3D *pTop = NULL;
+
+		//Walk the same parents as the world transform is created from
+		iEntity3D *pEntity = apParent;
+		cNode3D *pNode = apParentNode;
+		while(pEntity || pNode)
+		{
+			if(pNode)
+			{
+				if(pNode->mpParent)	pNode = pNode->mpParent;
+				else
+				{
+					pEntity = pNode->mpEntityParent;
+					pNode = NULL;
+				}
+				continue;
+			}
+
+			if(pEntity->mbChildTransformsPending) pTop = pEntity;
+
+			if(pEntity->mpParentNode)
+			{
+				pNode = pEntity->mpParentNode;
+				pEntity = NULL;
+			}
+			else
+			{
+				pEntity = pEntity->mpParent;
+			}
+		}
+
+		return pTop;
+	}
+
+	//-----------------------------------------------------------------------
+
+	int iEntity3D::GetHierarchyDepth(iEntity3D *apEntity)
+	{
+		int lDepth = 0;
+
+		iEntity3D *pEntity = apEntity;
+		cNode3D *pNode = NULL;
+		while(pEntity || pNode)
+		{
+			++lDepth;
+			if(pNode)
+			{
+				if(pNode->mpParent)	pNode = pNode->mpParent;
+				else
+				{
+					pEntity = pNode->mpEntityParent;
+					pNode = NULL;
+				}
+			}
+			else if(pEntity->mpParentNode)
+			{
+				pNode = pEntity->mpParentNode;
+				pEntity = NULL;
+			}
+			else
+			{
+				pEntity = pEntity->mpParent;
+			}
+		}
+
+		return lDepth;
+	}
+
+	//-----------------------------------------------------------------------
 }
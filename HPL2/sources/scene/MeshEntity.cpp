@@ -36,6 +36,7 @@
 #include "graphics/Skeleton.h"
 #include "graphics/Bone.h"
 #include "graphics/BoneState.h"
+#include "graphics/Renderer.h"
 
 #include "scene/AnimationState.h"
 #include "scene/NodeState.h"
@@ -52,6 +53,24 @@
 
 namespace hpl {
 
+	//////////////////////////////////////////////////////////////////////////
+	// STATIC VARIABLES
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	cVector3f cMeshEntity::mvAnimationLodOrigin = 0;
+	bool cMeshEntity::mbAnimationLodOriginSet = false;
+	bool cMeshEntity::mbAnimationLodActiveByDefault = false;
+	float cMeshEntity::mfAnimationLodHalfRateDist = 12.0f;
+	float cMeshEntity::mfAnimationLodQuarterRateDist = 25.0f;
+	int cMeshEntity::mlAnimationLodHiddenInterval = 4;
+	int cMeshEntity::mlAnimationLodStagger = 0;
+
+	//Blend layers with less weight than this are not applied to the pose
+	static const float kfNegligibleAnimationWeight = 0.001f;
+
+	//-----------------------------------------------------------------------
 
 	cMeshEntity::cMeshEntity(const tString asName,cMesh* apMesh, cMaterialManager* apMaterialManager,
 							cMeshManager* apMeshManager, cAnimationManager *apAnimationManager) :
@@ -83,6 +102,10 @@ namespace hpl {
 
 		mbBoneMatricesNeedUpdate = true;
 
+		mlTickBoneMatricesTick = -1;
+		mlBoneMatricesInterpolationTick = -1;
+		mfBoneMatricesInterpolationFraction = 0;
+
 		mbStatic = false;
 
 		mbSkeletonPhysics = false;
@@ -99,6 +122,11 @@ namespace hpl {
 
 		mbUpdatedBones = false;
 		mbHasUpdatedAnimation = true;
+		mbBonePoseOutdated = false;
+
+		//Spread out the reduced rate updates, so a group loaded at once does not update on the same frame.
+		mbAnimationLodActive = mbAnimationLodActiveByDefault;
+		mlAnimationLodFrameCount = (mlAnimationLodStagger++) & 3;
 
 		////////////////////////////////////////////////
 		//Create sub entities
@@ -269,7 +297,7 @@ namespace hpl {
 			hplDelete(mpBoneStateRoot);
 		}
 
-		mpMeshManager->Destroy(mpMesh);
+		if(mpMeshManager) mpMeshManager->Destroy(mpMesh);
 
 		STLDeleteAll(mvNodeStates);
 		STLDeleteAll(mvBoneStates);
@@ -409,10 +437,37 @@ namespace hpl {
 				}
 			}
 
+			//////////////////////////////////////
+			// SKELETON, POSE SKIPPED
+			// The animations still move forward and the bones keep the last pose. The time and weight the pose
+			// should have used are saved, so it can be built if the bones are queried before the next update.
+			if(	mpMesh->GetSkeleton() && bAnimationActive && mbSkeletonPhysics==false &&
+				UpdateAnimationLod()==false)
+			{
+				float fAnimationWeightMul = GetAnimationWeightMul();
+
+				mvOutdatedPoseTimes.resize(mvAnimationStates.size());
+				mvOutdatedPoseWeights.resize(mvAnimationStates.size());
+				for(size_t i=0; i< mvAnimationStates.size(); i++)
+				{
+					cAnimationState *pAnimState = mvAnimationStates[i];
+
+					mvOutdatedPoseTimes[i] = pAnimState->GetTimePosition();
+					mvOutdatedPoseWeights[i] = pAnimState->IsActive() ? pAnimState->GetWeight() * fAnimationWeightMul : 0.0f;
+
+					if(pAnimState->IsActive()) pAnimState->Update(afTimeStep);
+				}
+
+				mbBonePoseOutdated = true;
+			}
 			//////////////////////////////////////
 			// SKELETON
-			if(mpMesh->GetSkeleton())
+			else if(mpMesh->GetSkeleton())
 			{
+				//If the animations stopped after a skipped pose, the bones are left in the last pose they should have had.
+				if(mbBonePoseOutdated && bAnimationActive==false) UpdateOutdatedBonePose();
+				mbBonePoseOutdated = false;
+
 				//If transform needs to be updated.
 				bool bUpdateTransform = false;
 
@@ -482,39 +537,7 @@ namespace hpl {
 
 					if(pAnimState->IsActive())
 					{
-						cAnimation *pAnim = pAnimState->GetAnimation();
-
-						/////////////////////////////////////
-						//Go through all tracks in animation and apply to nodes
-						for(int i=0; i<pAnim->GetTrackNum(); i++)
-						{
-							cAnimationTrack *pTrack = pAnim->GetTrack(i);
-
-							///////////////////////////////////
-							//If index not yet set, get it!
-							if(pTrack->GetNodeIndex()==-1)
-							{
-								int lBoneIdx = mpMesh->GetSkeleton()->GetBoneIndexByName(pTrack->GetName());
-								if(lBoneIdx==-1)
-								{
-									// XXX: This line is commented to avoid log clutter
-									//Error("Track '%s' in '%s' does not have a corresponding bone! Skeleton bone name mismatch?\n", pTrack->GetName().c_str(), mpMesh->GetName().c_str());
-									pTrack->SetNodeIndex(-2);
-								}
-								else
-									pTrack->SetNodeIndex(lBoneIdx);
-							}
-
-							cNode3D* pState = GetBoneState(pTrack->GetNodeIndex());
-
-							///////////////////////////////////
-							//Apply the animation track to node.
-							if(pState && pState->IsActive())
-							{
-								pTrack->ApplyToNode(pState,pAnimState->GetTimePosition(),pAnimState->GetWeight() * fAnimationWeightMul, pAnimState->IsLooping());
-							}
-						}
-
+						ApplyAnimationToBones(pAnimState, pAnimState->GetTimePosition(), pAnimState->GetWeight() * fAnimationWeightMul);
 
 						pAnimState->Update(afTimeStep);
 					}
@@ -600,8 +623,9 @@ namespace hpl {
 						if(pAnimState->IsActive())
 						{
 							cAnimation *pAnim = pAnimState->GetAnimation();
+							float fWeight = pAnimState->GetWeight() * fAnimationWeightMul;
 
-							for(int i=0; i<pAnim->GetTrackNum(); i++)
+							for(int i=0; i<pAnim->GetTrackNum() && fWeight >= kfNegligibleAnimationWeight; i++)
 							{
 								cAnimationTrack *pTrack = pAnim->GetTrack(i);
 
@@ -612,7 +636,7 @@ namespace hpl {
 								cNode3D* pNodeState = GetNodeState(pTrack->GetNodeIndex());
 
 								if(pNodeState->IsActive())
-									pTrack->ApplyToNode(pNodeState,pAnimState->GetTimePosition(),pAnimState->GetWeight() * fAnimationWeightMul);
+									pTrack->ApplyToNode(pNodeState,pAnimState->GetTimePosition(),fWeight, true, pAnimState->GetTrackCursor(i));
 							}
 
 							pAnimState->Update(afTimeStep);
@@ -686,7 +710,13 @@ namespace hpl {
 
 		/////////////////////////////////////////
 		/// Final things
-		if(mpMesh->GetSkeleton()) mbBoneMatricesNeedUpdate = true;
+		if(mpMesh->GetSkeleton())
+		{
+			mbBoneMatricesNeedUpdate = true;
+
+			//The game can still change the bones during this update, so they are kept when it ends.
+			if(mvAnimationStates.empty()==false || mbSkeletonPhysics) RequestInterpolationTick();
+		}
 	}
 
 	//-----------------------------------------------------------------------
@@ -853,6 +883,8 @@ namespace hpl {
 		{
 			return NULL;
 		}
+		if(mbBonePoseOutdated) UpdateOutdatedBonePose();
+
 		return mvBoneStates[alIndex];
 	}
 
@@ -884,6 +916,8 @@ namespace hpl {
 		int lIdx = GetBoneStateIndex(asName);
 		if(lIdx >= 0)
 		{
+			if(mbBonePoseOutdated) UpdateOutdatedBonePose();
+
 			return mvBoneStates[lIdx];
 		}
 		else
@@ -1163,6 +1197,30 @@ namespace hpl {
 
 	void cMeshEntity::UpdateGraphicsForFrame(float afFrameTime)
 	{
+		//////////////////////////////////////////
+		//Interpolated between the last two logic updates
+		if(	iEntity3D::GetInterpolationApplied() && mlTickBoneMatricesTick >= 0 &&
+			mlTickBoneMatricesTick == iEntity3D::GetInterpolationTick()-1)
+		{
+			float fT = iEntity3D::GetInterpolationFraction();
+			if(	mbBoneMatricesNeedUpdate == false &&
+				mlBoneMatricesInterpolationTick == mlTickBoneMatricesTick && mfBoneMatricesInterpolationFraction == fT)
+			{
+				return;
+			}
+
+			mlBoneMatricesInterpolationTick = mlTickBoneMatricesTick;
+			mfBoneMatricesInterpolationFraction = fT;
+			mbBoneMatricesNeedUpdate = false;
+			mlBoneMatricesTransformCount = -1;
+
+			for(size_t i=0; i<mvBoneMatrices.size(); ++i)
+			{
+				mvBoneMatrices[i] = cMath::MatrixSlerpScaled(fT, mvPrevTickBoneMatrices[i], mvTickBoneMatrices[i]);
+			}
+			return;
+		}
+
 		//////////////////////////////////////////
 		//Check so update is needed
 		if(	mbBoneMatricesNeedUpdate == false &&
@@ -1173,30 +1231,11 @@ namespace hpl {
 
 		mlBoneMatricesTransformCount = GetTransformUpdateCount();
 		mbBoneMatricesNeedUpdate = false;
+		mlBoneMatricesInterpolationTick = -1;
 
 		///////////////////////////////////
 		//Update the bone matrices
-		cSkeleton *pSkeleton = mpMesh->GetSkeleton();
-		if(pSkeleton)
-		{
-			if(mlInvWorldMatrixTransformCount != GetTransformUpdateCount())
-			{
-				mlInvWorldMatrixTransformCount = GetTransformUpdateCount();
-				m_mtxInvWorldMatrix = cMath::MatrixInverse(GetWorldMatrix());
-			}
-
-			for(int i=0; i< pSkeleton->GetBoneNum(); i++)
-			{
-				cBone *pBone = pSkeleton->GetBoneByIndex(i);
-				cNode3D* pState = mvBoneStates[i];
-
-				//Transform the movement of the bone into the
-				//Bind pose's local space.
-				cMatrixf mtxLocal = cMath::MatrixMul(m_mtxInvWorldMatrix,pState->GetWorldMatrix());
-
-				mvBoneMatrices[i] = cMath::MatrixMul(mtxLocal,pBone->GetInvWorldTransform());
-			}
-		}
+		if(mpMesh->GetSkeleton()) GetBoneMatrices(mvBoneMatrices);
 	}
 
 	//-----------------------------------------------------------------------
@@ -1320,6 +1359,48 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 
+	void cMeshEntity::OnInterpolationTick()
+	{
+		if(mpMesh->GetSkeleton()==NULL) return;
+
+		mvPrevTickBoneMatrices.swap(mvTickBoneMatrices);
+		mvTickBoneMatrices.resize(mvBoneMatrices.size());
+		GetBoneMatrices(mvTickBoneMatrices);
+
+		//Not kept at the update before, so there is nothing to interpolate from
+		if(mlTickBoneMatricesTick != iEntity3D::GetInterpolationTick()-1)
+			mvPrevTickBoneMatrices = mvTickBoneMatrices;
+
+		mlTickBoneMatricesTick = iEntity3D::GetInterpolationTick();
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cMeshEntity::GetBoneMatrices(std::vector<cMatrixf> &avMatrices)
+	{
+		cSkeleton *pSkeleton = mpMesh->GetSkeleton();
+
+		if(mlInvWorldMatrixTransformCount != GetTransformUpdateCount())
+		{
+			mlInvWorldMatrixTransformCount = GetTransformUpdateCount();
+			m_mtxInvWorldMatrix = cMath::MatrixInverse(GetWorldMatrix());
+		}
+
+		for(int i=0; i< pSkeleton->GetBoneNum(); i++)
+		{
+			cBone *pBone = pSkeleton->GetBoneByIndex(i);
+			cNode3D* pState = mvBoneStates[i];
+
+			//Transform the movement of the bone into the
+			//Bind pose's local space.
+			cMatrixf mtxLocal = cMath::MatrixMul(m_mtxInvWorldMatrix,pState->GetWorldMatrix());
+
+			avMatrices[i] = cMath::MatrixMul(mtxLocal,pBone->GetInvWorldTransform());
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
 	float cMeshEntity::GetAnimationWeightMul()
 	{
 		if(mbNormalizeAnimationWeights==false) return 1.0f;
@@ -1348,6 +1429,126 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 
+	bool cMeshEntity::UpdateAnimationLod()
+	{
+		//The colliders are used by the game every frame, so they are always kept up to date.
+		if(mbAnimationLodActive==false || mbSkeletonColliders) return true;
+
+		////////////////////////////
+		// Visible if any sub mesh was rendered last frame
+		bool bRendered = false;
+		for(size_t i=0; i<mvSubMeshes.size(); ++i)
+		{
+			if(mvSubMeshes[i]->GetRenderFrameCount() >= iRenderer::GetRenderFrameCount()-1)
+			{
+				bRendered = true;
+				break;
+			}
+		}
+
+		////////////////////////////
+		// Frames between pose updates
+		int lInterval = 1;
+		if(bRendered==false)
+		{
+			lInterval = mlAnimationLodHiddenInterval;
+		}
+		else if(mbAnimationLodOriginSet)
+		{
+			float fDistSqr = cMath::Vector3DistSqr(GetBoundingVolume()->GetWorldCenter(), mvAnimationLodOrigin);
+			if(fDistSqr > mfAnimationLodQuarterRateDist*mfAnimationLodQuarterRateDist)	lInterval = 4;
+			else if(fDistSqr > mfAnimationLodHalfRateDist*mfAnimationLodHalfRateDist)	lInterval = 2;
+		}
+
+		++mlAnimationLodFrameCount;
+		if(mlAnimationLodFrameCount < lInterval) return false;
+
+		mlAnimationLodFrameCount = 0;
+		return true;
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cMeshEntity::ApplyAnimationToBones(cAnimationState *apAnimState, float afTimePos, float afWeight)
+	{
+		cAnimation *pAnim = apAnimState->GetAnimation();
+
+		/////////////////////////////////////
+		//Go through all tracks in animation and apply to nodes
+		for(int i=0; i<pAnim->GetTrackNum() && afWeight >= kfNegligibleAnimationWeight; i++)
+		{
+			cAnimationTrack *pTrack = pAnim->GetTrack(i);
+
+			///////////////////////////////////
+			//If index not yet set, get it!
+			if(pTrack->GetNodeIndex()==-1)
+			{
+				int lBoneIdx = mpMesh->GetSkeleton()->GetBoneIndexByName(pTrack->GetName());
+				if(lBoneIdx==-1)
+				{
+					// XXX: This line is commented to avoid log clutter
+					//Error("Track '%s' in '%s' does not have a corresponding bone! Skeleton bone name mismatch?\n", pTrack->GetName().c_str(), mpMesh->GetName().c_str());
+					pTrack->SetNodeIndex(-2);
+				}
+				else
+					pTrack->SetNodeIndex(lBoneIdx);
+			}
+
+			cNode3D* pState = GetBoneState(pTrack->GetNodeIndex());
+
+			///////////////////////////////////
+			//Apply the animation track to node.
+			if(pState && pState->IsActive())
+			{
+				pTrack->ApplyToNode(pState,afTimePos,afWeight, apAnimState->IsLooping(), apAnimState->GetTrackCursor(i));
+			}
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cMeshEntity::UpdateOutdatedBonePose()
+	{
+		//Cleared first, as the bone states are fetched below.
+		mbBonePoseOutdated = false;
+
+		//////////////////////////////////
+		//Reset all bones states
+		for(size_t i=0;i < mvBoneStates.size(); i++)
+		{
+			cNode3D *pState = mvBoneStates[i];
+			if(pState->IsActive()) pState->SetMatrix(mpMesh->GetSkeleton()->GetBoneByIndex((int)i)->GetLocalTransform(),false);
+		}
+
+		//////////////////////////////////
+		//Apply the animations as they were when the pose was skipped
+		for(size_t i=0; i< mvAnimationStates.size() && i < mvOutdatedPoseTimes.size(); i++)
+		{
+			ApplyAnimationToBones(mvAnimationStates[i], mvOutdatedPoseTimes[i], mvOutdatedPoseWeights[i]);
+		}
+
+		cNode3DIterator NodeIt = mpBoneStateRoot->GetChildIterator();
+		while(NodeIt.HasNext())
+		{
+			cNode3D *pBoneState = static_cast<cNode3D*>(NodeIt.Next());
+			UpdateNodeMatrixRec(pBoneState);
+		}
+
+		for(size_t i=0;i < mvBoneStates.size(); i++)
+		{
+			mvBoneStates[i]->UpdateEntityChildren();
+		}
+
+		for(size_t i=0; i<mvSubMeshes.size(); ++i)
+		{
+			mvSubMeshes[i]->SetTransformUpdated(true);
+		}
+
+		mbBoneMatricesNeedUpdate = true;
+	}
+
+	//-----------------------------------------------------------------------
+
 	void cMeshEntity::CreateNodes()
 	{
 		/////////////////////////////////
@@ -44,6 +44,7 @@ namespace hpl {
 		mvWorldPosition = cVector3f(0,0,0);
 
 		mbTransformUpdated = true;
+		mlResolvedTransformGeneration = -1;
 
 		mbUsePreTransform = false;
 		mbUsePostTransform = false;
@@ -396,6 +397,15 @@ namespace hpl {
 	//-----------------------------------------------------------------------
 	void cNode3D::UpdateWorldTransform()
 	{
+		//Make sure any moved parent entity has marked its children as updated
+		while(mlResolvedTransformGeneration != iEntity3D::mlTransformGeneration)
+		{
+			mlResolvedTransformGeneration = iEntity3D::mlTransformGeneration;
+
+			iEntity3D *pTop = iEntity3D::GetTopPendingEntity(mpParent ? NULL : mpEntityParent, mpParent);
+			if(pTop) pTop->PropagateTransformToChildren();
+		}
+
 		if(mbTransformUpdated)
 		{
 			//if(msName == "WeaponJoint") LogUpdate("  update world transform!\n");
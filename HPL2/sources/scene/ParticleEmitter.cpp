@@ -181,6 +181,15 @@ namespace hpl {
         mbUsesDirection = false; // If Direction should be udpdated
     }
 
+    size_t iParticleEmitter::GetAllocatedSize(unsigned int alMaxParticles) {
+        // Position, uv and color for the four corners in each copy, and two triangles of indices
+        const size_t lVertexSize = sizeof(float3) + sizeof(float2) + sizeof(float4);
+        return alMaxParticles * (sizeof(cParticle) + sizeof(cParticle*) + 4 * NumberActiveCopies * lVertexSize +
+                                 6 * GeometrySet::IndexBufferStride);
+    }
+
+    //-----------------------------------------------------------------------
+
     iParticleEmitter::~iParticleEmitter() {
         for (int i = 0; i < (int)mvParticles.size(); i++) {
             hplDelete(mvParticles[i]);
@@ -67,6 +67,18 @@ namespace hpl {
 
 	//-----------------------------------------------------------------------
 
+	size_t cParticleSystemData::GetAllocatedSize()
+	{
+		size_t lSize = 0;
+		for(size_t i=0; i<mvEmitterData.size(); ++i)
+		{
+			lSize += iParticleEmitter::GetAllocatedSize(mvEmitterData[i]->GetMaxParticleNum());
+		}
+		return lSize;
+	}
+
+	//-----------------------------------------------------------------------
+
 	cParticleSystem* cParticleSystemData::Create(tString asName, cVector3f avSize)
 	{
 		if(mvEmitterData.empty())
@@ -25,6 +25,8 @@
 #include "graphics/RenderTarget.h"
 #include "math/MathTypes.h"
 #include "scene/Camera.h"
+#include "scene/Entity3D.h"
+#include "scene/MeshEntity.h"
 #include "scene/Viewport.h"
 #include "scene/World.h"
 
@@ -143,12 +145,20 @@ namespace hpl {
     }
 
     void cScene::Update(float timeStep) {
+        // Animation LOD distances are measured from the listener, which is the camera the player sees through
+        if (mpCurrentListener && mpCurrentListener->GetCamera()) {
+            cMeshEntity::SetAnimationLodOrigin(mpCurrentListener->GetCamera()->GetPosition());
+        }
+
         for (auto& world : m_worlds) {
             if (world->IsActive()) {
                 world->Update(timeStep);
             }
         }
 
+        // Children of everything moved during the update get their transforms updated once
+        iEntity3D::UpdatePendingTransforms();
+
         if (mpCurrentListener && mpCurrentListener->GetCamera()) {
             cCamera* pCamera3D = mpCurrentListener->GetCamera();
             mpSound->GetLowLevel()->SetListenerAttributes(
@@ -156,6 +166,28 @@ namespace hpl {
         }
     }
 
+    void cScene::EndInterpolationTick() {
+        // Cameras first, the tick number is increased by the entities
+        for (auto& camera : mlstCameras) {
+            camera->EndInterpolationTick();
+        }
+        iEntity3D::EndInterpolationTick();
+    }
+
+    void cScene::ApplyInterpolation(float afT) {
+        for (auto& camera : mlstCameras) {
+            camera->ApplyInterpolation(afT);
+        }
+        iEntity3D::ApplyInterpolation(afT);
+    }
+
+    void cScene::RestoreInterpolation() {
+        for (auto& camera : mlstCameras) {
+            camera->RestoreInterpolation();
+        }
+        iEntity3D::RestoreInterpolation();
+    }
+
     cCamera* cScene::CreateCamera(eCameraMoveMode aMoveMode) {
         cCamera* pCamera = hplNew(cCamera, ());
         pCamera->SetAspect(mpGraphics->GetLowLevel()->GetScreenSizeFloat().x / mpGraphics->GetLowLevel()->GetScreenSizeFloat().y);
@@ -176,6 +208,9 @@ namespace hpl {
         // Increase the frame count (do this at top, so render count is valid until this Render is called again!)
         iRenderer::IncRenderFrameCount();
 
+        // Anything moved after the update must be resolved before culling
+        iEntity3D::UpdatePendingTransforms();
+
         ///////////////////////////////////////////
         // Iterate all viewports and render
         for (auto& pViewPort : m_viewports) {
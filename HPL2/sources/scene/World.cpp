@@ -412,7 +412,8 @@ namespace hpl {
 		{
 			if(abSkipNonStaticEntity==false || pLoader->GetCreatesStaticEntity())
 			{
-				pEntity = pLoader->Load(asName,alID, abActive, pDoc,a_mtxTransform, avScale, this,pEntFile->GetName(),pEntFile->GetFullPath(), apInstanceVars);
+				pEntity = pLoader->Load(asName,alID, abActive, pDoc,a_mtxTransform, avScale, this,pEntFile->GetName(),pEntFile->GetFullPath(), apInstanceVars,
+										pEntFile->GetPrototype());
 				if(pEntity) pEntity->SetSourceFile(pEntFile->GetName());
 			}
 		}
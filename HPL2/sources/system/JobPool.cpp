@@ -0,0 +1,165 @@
+/*
+ * Copyright © 2009-2020 Frictional Games
+ *
+ * This file is part of Amnesia: The Dark Descent.
+ *
+ * Amnesia: The Dark Descent is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * Amnesia: The Dark Descent is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Amnesia: The Dark Descent.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "system/JobPool.h"
+
+#include <algorithm>
+
+namespace hpl {
+
+	//////////////////////////////////////////////////////////////////////////
+	// CONSTRUCTORS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	cJobPool::cJobPool(int alWorkerNum)
+	{
+		mbQuit = false;
+
+		mvWorkers.reserve(std::max(alWorkerNum, 0));
+		for(int i=0; i<alWorkerNum; ++i)
+		{
+			mvWorkers.emplace_back([this](){ WorkerThread(); });
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
+	cJobPool::~cJobPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mbQuit = true;
+		}
+		mWorkCondition.notify_all();
+
+		for(std::thread& worker : mvWorkers)
+		{
+			worker.join();
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// PUBLIC METHODS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	cJobPool* cJobPool::GetDefault()
+	{
+		static cJobPool defaultPool((int)std::max(1u, std::thread::hardware_concurrency()) - 1);
+		return &defaultPool;
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cJobPool::ParallelFor(size_t alCount, const std::function<void(size_t)>& aFunc, int alMaxThreads)
+	{
+		if(alCount == 0) return;
+
+		int lMaxWorkers = (int)std::min<size_t>(alCount, mvWorkers.size() + 1) - 1;
+		if(alMaxThreads >= 0) lMaxWorkers = std::min(lMaxWorkers, alMaxThreads - 1);
+		if(lMaxWorkers <= 0)
+		{
+			for(size_t i=0; i<alCount; ++i) aFunc(i);
+			return;
+		}
+
+		cBatch batch;
+		batch.mpFunc = &aFunc;
+		batch.mlCount = alCount;
+		batch.mlNext = 0;
+		batch.mlMaxWorkers = lMaxWorkers;
+		batch.mlActiveWorkers = 0;
+
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mlstBatches.push_back(&batch);
+		}
+		mWorkCondition.notify_all();
+
+		RunBatch(&batch);
+
+		//All indices are handed out, no more workers may join and the ones working are waited for
+		std::unique_lock<std::mutex> lock(mMutex);
+		auto it = std::find(mlstBatches.begin(), mlstBatches.end(), &batch);
+		if(it != mlstBatches.end()) mlstBatches.erase(it);
+
+		mDoneCondition.wait(lock, [&](){ return batch.mlActiveWorkers == 0; });
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// PRIVATE METHODS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	void cJobPool::RunBatch(cBatch *apBatch)
+	{
+		for(size_t i = apBatch->mlNext++; i < apBatch->mlCount; i = apBatch->mlNext++)
+		{
+			(*apBatch->mpFunc)(i);
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cJobPool::WorkerThread()
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+		while(true)
+		{
+			cBatch *pBatch = NULL;
+			mWorkCondition.wait(lock, [&]()
+			{
+				if(mbQuit) return true;
+				for(cBatch *pQueued : mlstBatches)
+				{
+					if(pQueued->mlActiveWorkers < pQueued->mlMaxWorkers)
+					{
+						pBatch = pQueued;
+						return true;
+					}
+				}
+				return false;
+			});
+			if(mbQuit) return;
+
+			++pBatch->mlActiveWorkers;
+			lock.unlock();
+
+			RunBatch(pBatch);
+
+			lock.lock();
+			//Nothing is left to hand out, so it is taken off the queue before the caller can return
+			auto it = std::find(mlstBatches.begin(), mlstBatches.end(), pBatch);
+			if(it != mlstBatches.end()) mlstBatches.erase(it);
+			--pBatch->mlActiveWorkers;
+			mDoneCondition.notify_all();
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
+}
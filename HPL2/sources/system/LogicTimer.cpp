@@ -35,6 +35,9 @@ namespace hpl {
 		mlMaxUpdates = alUpdatesPerSec/10;
 		mlUpdateCount =0;
 
+		mlUpdateLoopStartTime = 0;
+		mbDropUpdates = false;
+
 		mpLowLevelSystem = apLowLevelSystem;
 
 		mfSpeedMul = 1.0f;
@@ -67,8 +70,20 @@ namespace hpl {
 		++mlUpdateCount;
 		if(mlUpdateCount > mlMaxUpdates) return false;
 
-		if(mlLocalTime< (double)cPlatform::GetApplicationTime())
+		double fTime = (double)cPlatform::GetApplicationTime();
+		if(mlUpdateCount==1) mlUpdateLoopStartTime = fTime;
+
+		if(mlLocalTime< fTime)
 		{
+			////////////////////////////
+			// If the updates so far took longer than the time they stepped, each new one only puts the
+			// next frame further behind. Stop and let the frame render.
+			if(mlUpdateCount > 2 && fTime - mlUpdateLoopStartTime > (double)(mlUpdateCount-1) * (mlLocalTimeAdd/mfSpeedMul))
+			{
+				mbDropUpdates = true;
+				return false;
+			}
+
 			Update();
 			return true;
 		}
@@ -79,11 +94,25 @@ namespace hpl {
 
 	void cLogicTimer::EndUpdateLoop()
 	{
-		if(mlUpdateCount > mlMaxUpdates){
+		if(mlUpdateCount > mlMaxUpdates || mbDropUpdates){
 			Reset();
 		}
 
 		mlUpdateCount=0;
+		mbDropUpdates = false;
+	}
+
+	//-----------------------------------------------------------------------
+
+	float cLogicTimer::GetInterpolationFraction()
+	{
+		//mlLocalTime is the time of the last update, so the one before is a step back.
+		double fStep = mlLocalTimeAdd/mfSpeedMul;
+		double fT = ((double)cPlatform::GetApplicationTime() - (mlLocalTime - fStep)) / fStep;
+
+		if(fT < 0) return 0;
+		if(fT > 1) return 1;
+		return (float)fT;
 	}
 
 	//-----------------------------------------------------------------------
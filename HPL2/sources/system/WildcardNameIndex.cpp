@@ -0,0 +1,248 @@
+/*
+ * Copyright © 2009-2020 Frictional Games
+ *
+ * This file is part of Amnesia: The Dark Descent.
+ *
+ * Amnesia: The Dark Descent is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * Amnesia: The Dark Descent is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Amnesia: The Dark Descent.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "system/WildcardNameIndex.h"
+
+#include <algorithm>
+
+namespace hpl {
+
+	//////////////////////////////////////////////////////////////////////////
+	// HELPERS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	static const size_t kMaxCachedPatterns = 512;
+
+	static inline unsigned int GetGramKey(const tString& asString, size_t alStart, size_t alLength)
+	{
+		unsigned int lKey = (unsigned int)alLength << 24;
+		for(size_t i=0; i<alLength; ++i)
+		{
+			lKey |= (unsigned int)(unsigned char)asString[alStart+i] << (16 - i*8);
+		}
+		return lKey;
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// CONSTRUCTORS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	cWildcardNameIndex::cWildcardNameIndex()
+	{
+	}
+
+	cWildcardNameIndex::~cWildcardNameIndex()
+	{
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// PUBLIC METHODS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	void cWildcardNameIndex::Add(void *apData, int alOrder, const tString& asName)
+	{
+		if(m_mapEntries.find(alOrder) != m_mapEntries.end()) Remove(alOrder);
+
+		cEntry &entry = m_mapEntries[alOrder];
+		entry.mpData = apData;
+		entry.msName = asName;
+
+		GetNameGrams(asName, mvTempGrams);
+		for(size_t i=0; i<mvTempGrams.size(); ++i)
+		{
+			tIntVec &vOrders = m_mapGrams[mvTempGrams[i]];
+
+			//Orders are usually added increasing, only search when they are not.
+			if(vOrders.empty() || vOrders.back() < alOrder)
+				vOrders.push_back(alOrder);
+			else
+				vOrders.insert(std::lower_bound(vOrders.begin(), vOrders.end(), alOrder), alOrder);
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cWildcardNameIndex::Remove(int alOrder)
+	{
+		tEntryMapIt entryIt = m_mapEntries.find(alOrder);
+		if(entryIt == m_mapEntries.end()) return;
+
+		GetNameGrams(entryIt->second.msName, mvTempGrams);
+		for(size_t i=0; i<mvTempGrams.size(); ++i)
+		{
+			tGramMapIt gramIt = m_mapGrams.find(mvTempGrams[i]);
+			if(gramIt == m_mapGrams.end()) continue;
+
+			tIntVec &vOrders = gramIt->second;
+			tIntVecIt it = std::lower_bound(vOrders.begin(), vOrders.end(), alOrder);
+			if(it != vOrders.end() && *it == alOrder) vOrders.erase(it);
+
+			if(vOrders.empty()) m_mapGrams.erase(gramIt);
+		}
+
+		m_mapEntries.erase(entryIt);
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cWildcardNameIndex::Clear()
+	{
+		m_mapEntries.clear();
+		m_mapGrams.clear();
+	}
+
+	//-----------------------------------------------------------------------
+
+	void cWildcardNameIndex::Find(const tString& asPattern, std::vector<void*>& avData)
+	{
+		avData.clear();
+
+		const cWildcardPattern *pPattern = GetPattern(asPattern);
+
+		////////////////////////////
+		// No segments, everything matches
+		if(pPattern->mvSegments.empty())
+		{
+			avData.reserve(m_mapEntries.size());
+			for(tEntryMapIt it = m_mapEntries.begin(); it != m_mapEntries.end(); ++it)
+			{
+				avData.push_back(it->second.mpData);
+			}
+			return;
+		}
+
+		////////////////////////////
+		// Get the shortest list of names, a gram missing means no name has that segment
+		const tIntVec *pShortestList = NULL;
+		for(size_t i=0; i<pPattern->mvSegmentGrams.size(); ++i)
+		{
+			const std::vector<unsigned int> &vGrams = pPattern->mvSegmentGrams[i];
+			for(size_t j=0; j<vGrams.size(); ++j)
+			{
+				tGramMapIt gramIt = m_mapGrams.find(vGrams[j]);
+				if(gramIt == m_mapGrams.end()) return;
+
+				if(pShortestList==NULL || gramIt->second.size() < pShortestList->size())
+					pShortestList = &gramIt->second;
+			}
+		}
+
+		////////////////////////////
+		// Test the names in the list, it is sorted by order
+		for(size_t i=0; i<pShortestList->size(); ++i)
+		{
+			tEntryMapIt entryIt = m_mapEntries.find((*pShortestList)[i]);
+			const tString &sName = entryIt->second.msName;
+
+			bool bContainsStrings = true;
+			for(size_t j=0; j<pPattern->mvSegments.size(); ++j)
+			{
+				if(sName.find(pPattern->mvSegments[j]) == tString::npos)
+				{
+					bContainsStrings = false;
+					break;
+				}
+			}
+
+			if(bContainsStrings) avData.push_back(entryIt->second.mpData);
+		}
+	}
+
+	//-----------------------------------------------------------------------
+
+	const cWildcardPattern* cWildcardNameIndex::GetPattern(const tString& asPattern)
+	{
+		tPatternMapIt it = m_mapPatterns.find(asPattern);
+		if(it != m_mapPatterns.end()) return &it->second;
+
+		if(m_mapPatterns.size() >= kMaxCachedPatterns) m_mapPatterns.clear();
+
+		cWildcardPattern &pattern = m_mapPatterns[asPattern];
+
+		////////////////////////////
+		// Split at '*', empty parts are skipped like in cString::GetStringVec
+		size_t lStart = 0;
+		while(lStart < asPattern.size())
+		{
+			size_t lEnd = asPattern.find('*', lStart);
+			if(lEnd == tString::npos) lEnd = asPattern.size();
+
+			if(lEnd > lStart) pattern.mvSegments.push_back(asPattern.substr(lStart, lEnd - lStart));
+			lStart = lEnd + 1;
+		}
+
+		////////////////////////////
+		// Grams to look up for each segment
+		pattern.mvSegmentGrams.resize(pattern.mvSegments.size());
+		for(size_t i=0; i<pattern.mvSegments.size(); ++i)
+		{
+			const tString &sSegment = pattern.mvSegments[i];
+			std::vector<unsigned int> &vGrams = pattern.mvSegmentGrams[i];
+
+			if(sSegment.size() < 3)
+			{
+				vGrams.push_back(GetGramKey(sSegment, 0, sSegment.size()));
+			}
+			else
+			{
+				for(size_t j=0; j+3 <= sSegment.size(); ++j)
+					vGrams.push_back(GetGramKey(sSegment, j, 3));
+
+				std::sort(vGrams.begin(), vGrams.end());
+				vGrams.erase(std::unique(vGrams.begin(), vGrams.end()), vGrams.end());
+			}
+		}
+
+		return &pattern;
+	}
+
+	//-----------------------------------------------------------------------
+
+	//////////////////////////////////////////////////////////////////////////
+	// PRIVATE METHODS
+	//////////////////////////////////////////////////////////////////////////
+
+	//-----------------------------------------------------------------------
+
+	void cWildcardNameIndex::GetNameGrams(const tString& asName, std::vector<unsigned int>& avGrams)
+	{
+		avGrams.clear();
+		for(size_t lLength=1; lLength<=3; ++lLength)
+		{
+			for(size_t i=0; i+lLength <= asName.size(); ++i)
+				avGrams.push_back(GetGramKey(asName, i, lLength));
+		}
+
+		std::sort(avGrams.begin(), avGrams.end());
+		avGrams.erase(std::unique(avGrams.begin(), avGrams.end()), avGrams.end());
+	}
+
+	//-----------------------------------------------------------------------
+
+}
@@ -93,12 +93,15 @@ cLuxArea_Liquid::cLuxArea_Liquid(const tString &asName, int alID, cLuxMap *apMap
 	mbFullGameSave = true;
 
 	mfTimeCount = 0;
+
+	mpTrigger = NULL;
 }
 
 //-----------------------------------------------------------------------
 
 cLuxArea_Liquid::~cLuxArea_Liquid()
 {
+	if(mpTrigger) mpMap->GetPhysicsWorld()->DestroyTriggerVolume(mpTrigger);
 }
 
 //-----------------------------------------------------------------------
@@ -124,63 +127,37 @@ void cLuxArea_Liquid::OnUpdate(float afTimeStep)
 	if(afTimeStep < gpBase->mpEngine->GetStepSize()*0.8f) return;
 
 	///////////////////////////
-	// Get data
-	iPhysicsWorld *pPhysicsWorld = mpMap->GetPhysicsWorld();
-	iPhysicsBody *pAreaBody = mpBody;
-
-	float fSurfaceY =	mpBody->GetWorldPosition().y + mpBody->GetShape()->GetSize().y /2;
+	// Create trigger, the physics world updates it from now on
+	if(mpTrigger==NULL)
+	{
+		mpTrigger = mpMap->GetPhysicsWorld()->CreateTriggerVolume(mpBody, this);
+		mpTrigger->Update();
+	}
 
-	cCollideData collideData;
-	collideData.SetMaxSize(1);
+	float fSurfaceY = GetSurfaceY();
 
 	///////////////////////////
 	// Update count
 	mfTimeCount += afTimeStep;
 
-
 	///////////////////////////
-	// Iterate bodies
-	std::vector<iPhysicsBody*> vBodies;
-	pPhysicsWorld->GetBodiesInBV(mpBody->GetBoundingVolume(),&vBodies);
-
+	// Iterate bodies in the liquid, leaving is handled in OnBodyExit
+	const std::vector<iPhysicsBody*> &vBodies = mpTrigger->GetOverlaps();
 	for(size_t i=0; i<vBodies.size(); ++i)
 	{
 		iPhysicsBody *pBody = vBodies[i];
 
-		if(pBody->GetCollide()==false || pBody->IsActive()==false) continue;
-		if(pBody->GetMass()==0 && pBody->IsCharacter()==false) continue;
-
-		bool bInsideWater = true;
-
-		/////////////////////////
-		//Bounding volume check
-		if(cMath::CheckBVIntersection(*pBody->GetBoundingVolume(), *pAreaBody->GetBoundingVolume())==false)
-		{
-			bInsideWater = false;
-		}
-
-		///////////////////////////////
-		//Check for collision
-		if(bInsideWater)
-		{
-			if(pPhysicsWorld->CheckShapeCollision(	pBody->GetShape(),pBody->GetLocalMatrix(), pAreaBody->GetShape(), pAreaBody->GetLocalMatrix(),
-													collideData,1, false)==false)
-			{
-				bInsideWater = false;
-			}
-		}
-
 		/////////////////////////
 		//Character specific
 		if(pBody->IsCharacter())
 		{
-			DoBuoyancyOnCharBody(pBody->GetCharacterBody(),fSurfaceY, bInsideWater);
+			DoBuoyancyOnCharBody(pBody->GetCharacterBody(),fSurfaceY, true);
 		}
 		/////////////////////////
 		//Normal body specific
 		else
 		{
-			DoBuoyancyOnBody(pBody, fSurfaceY, bInsideWater);
+			DoBuoyancyOnBody(pBody, fSurfaceY, true);
 		}
 	}
 
@@ -188,6 +165,26 @@ void cLuxArea_Liquid::OnUpdate(float afTimeStep)
 
 //-----------------------------------------------------------------------
 
+bool cLuxArea_Liquid::CheckBody(iPhysicsBody *apBody)
+{
+	if(apBody->GetCollide()==false || apBody->IsActive()==false) return false;
+	if(apBody->GetMass()==0 && apBody->IsCharacter()==false) return false;
+
+	return true;
+}
+
+//-----------------------------------------------------------------------
+
+void cLuxArea_Liquid::OnBodyExit(iPhysicsBody *apBody)
+{
+	if(apBody->IsCharacter())
+		DoBuoyancyOnCharBody(apBody->GetCharacterBody(), GetSurfaceY(), false);
+	else
+		DoBuoyancyOnBody(apBody, GetSurfaceY(), false);
+}
+
+//-----------------------------------------------------------------------
+
 
 //////////////////////////////////////////////////////////////////////////
 // PRIVATE METHODS
@@ -303,6 +300,13 @@ void cLuxArea_Liquid::DoBuoyancyOnCharBody(iCharacterBody *apCharBody, float afS
 
 //-----------------------------------------------------------------------
 
+float cLuxArea_Liquid::GetSurfaceY()
+{
+	return mpBody->GetWorldPosition().y + mpBody->GetShape()->GetSize().y /2;
+}
+
+//-----------------------------------------------------------------------
+
 void cLuxArea_Liquid::SplashEffect(iPhysicsBody *apBody, float afSurfaceY)
 {
 	if(mpPhysicsMaterial==NULL) return;
@@ -50,7 +50,7 @@ public:
 
 //----------------------------------------------
 
-class cLuxArea_Liquid : public iLuxArea
+class cLuxArea_Liquid : public iLuxArea, public iPhysicsTriggerCallback
 {
 typedef iLuxArea super_class;
 friend class cLuxAreaLoader_Liquid;
@@ -67,6 +67,11 @@ public:
 	//Connection callbacks
 	void OnConnectionStateChange(iLuxEntity *apEntity, int alState){}
 
+	//////////////////////
+	//Trigger callbacks
+	bool CheckBody(iPhysicsBody *apBody);
+	void OnBodyExit(iPhysicsBody *apBody);
+
 	//////////////////////
 	//Save data stuff
 	iLuxEntity_SaveData* CreateSaveData();
@@ -80,6 +85,8 @@ private:
 
 	void SplashEffect(iPhysicsBody *apBody, float afSurfaceY);
 
+	float GetSurfaceY();
+
 	/////////////////////////
 	// Data
 	float mfDensity;
@@ -100,6 +107,8 @@ private:
 	float mfTimeCount;
 
 	cPlanef mSurfacePlane;
+
+	cPhysicsTriggerVolume *mpTrigger;
 };
 
 //----------------------------------------------
@@ -20,11 +20,17 @@
 #include "LuxArea_Rope.h"
 
 #include "LuxMap.h"
+#include "LuxPlayer.h"
 
 #include "LuxProp.h"
 
 //-----------------------------------------------------------------------
 
+//Ropes further than this from the camera only simulate every second and every fourth particle.
+static const float kLuxRopeLodDistance[2] = {15.0f, 30.0f};
+
+//-----------------------------------------------------------------------
+
 //////////////////////////////////////////////////////////////////////////
 // ROPE START LOADER
 //////////////////////////////////////////////////////////////////////////
@@ -239,7 +245,19 @@ void cLuxRope::OnSetActive(bool abX)
 
 void cLuxRope::OnUpdate(float afTimeStep)
 {
+	if(mpRope==NULL || mpRopeGfx==NULL) return;
+
+	///////////////////////////
+	// Simulate fewer particles far from the camera
+	cBoundingVolume *pBV = mpRopeGfx->GetBoundingVolume();
+	cVector3f vCamPos = gpBase->mpPlayer->GetCamera()->GetPosition();
+	float fDist = cMath::Vector3Dist(vCamPos, pBV->GetWorldCenter()) - pBV->GetRadius();
+
+	int lLodStep = 1;
+	if(fDist > kLuxRopeLodDistance[1])		lLodStep = 4;
+	else if(fDist > kLuxRopeLodDistance[0])	lLodStep = 2;
 
+	mpRope->SetLodStep(lLodStep);
 }
 
 //-----------------------------------------------------------------------
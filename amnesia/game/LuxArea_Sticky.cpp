@@ -128,6 +128,8 @@ cLuxArea_Sticky::cLuxArea_Sticky(const tString &asName, int alID, cLuxMap *apMap
 	mfAttachedBodyMass =0;
 	mbAttachedEntityFullGameSaved = false;
 
+	mpTrigger = NULL;
+
 	mbFullGameSave = true;
 }
 
@@ -135,6 +137,7 @@ cLuxArea_Sticky::cLuxArea_Sticky(const tString &asName, int alID, cLuxMap *apMap
 
 cLuxArea_Sticky::~cLuxArea_Sticky()
 {
+	if(mpTrigger) mpMap->GetPhysicsWorld()->DestroyTriggerVolume(mpTrigger);
 }
 
 //-----------------------------------------------------------------------
@@ -331,50 +334,20 @@ void cLuxArea_Sticky::UpdateCollision(float afTimeStep)
 	if(mpAttachedBody) return;
 
 	///////////////////////////
-	// Get data
-	iPhysicsWorld *pPhysicsWorld = mpMap->GetPhysicsWorld();
-	iPhysicsBody *pAreaBody = mpBody;
-
-	cCollideData collideData;
-	collideData.SetMaxSize(1);
+	// Create trigger, the physics world updates it from now on
+	if(mpTrigger==NULL)
+	{
+		mpTrigger = mpMap->GetPhysicsWorld()->CreateTriggerVolume(mpBody, this);
+		mpTrigger->Update();
+	}
 
 	///////////////////////////
-	// Iterate bodies
-	std::vector<iPhysicsBody*> vBodies;
-	pPhysicsWorld->GetBodiesInBV(mpBody->GetBoundingVolume(),&vBodies);
+	// Iterate bodies inside, copied since the script can destroy bodies
+	mvTempBodies = mpTrigger->GetOverlaps();
 
-	for(size_t i=0; i<vBodies.size(); ++i)
+	for(size_t i=0; i<mvTempBodies.size(); ++i)
 	{
-		iPhysicsBody *pBody = vBodies[i];
-
-		if(pBody->GetCollide()==false || pBody->IsActive()==false) continue;
-		if(pBody->GetMass()==0 && pBody->IsCharacter()==false) continue;
-
-		bool bInsideWater = true;
-
-		/////////////////////////
-		//Bounding volume check
-		bool bInsideBV = false;
-		if(mbCheckCenterInArea)
-		{
-			cVector3f vPos = cMath::MatrixMul(pBody->GetLocalMatrix(),pBody->GetMassCentre());
-			bInsideBV = cMath::CheckPointInBVIntersection(vPos,*pAreaBody->GetBoundingVolume());
-		}
-		else
-		{
-			bInsideBV = cMath::CheckBVIntersection(*pBody->GetBoundingVolume(),*pAreaBody->GetBoundingVolume());
-		}
-
-		//////////////////////////
-		//If not inside then skip this body
-		if(bInsideBV==false)
-		{
-			//If this was the last body that was attached, it has now moved out and does not need to be rejected.
-			if(pBody == mpLastAttachedBody)
-				mpLastAttachedBody = NULL;
-
-			continue;
-		}
+		iPhysicsBody *pBody = mvTempBodies[i];
 
 		//////////////////////////
 		//If the previously attached body is still inside, then skip it.
@@ -389,14 +362,6 @@ void cLuxArea_Sticky::UpdateCollision(float afTimeStep)
 			mbAllowAttachment = true;
 		}
 
-		///////////////////////////////
-		//Check for collision
-        if(pPhysicsWorld->CheckShapeCollision(	pBody->GetShape(),pBody->GetLocalMatrix(), pAreaBody->GetShape(), pAreaBody->GetLocalMatrix(),
-												collideData,1, false)==false)
-		{
-			continue;
-		}
-
 		///////////////////////////
 		// Call callback and see if it should be attached.
 		if(msAttachFunction!="")
@@ -413,6 +378,32 @@ void cLuxArea_Sticky::UpdateCollision(float afTimeStep)
 
 }
 
+//-----------------------------------------------------------------------
+
+bool cLuxArea_Sticky::CheckBody(iPhysicsBody *apBody)
+{
+	if(apBody->GetCollide()==false || apBody->IsActive()==false) return false;
+	if(apBody->GetMass()==0 && apBody->IsCharacter()==false) return false;
+
+	/////////////////////////
+	//Bounding volume check, the shape is checked by the trigger after this
+	if(mbCheckCenterInArea)
+	{
+		cVector3f vPos = cMath::MatrixMul(apBody->GetLocalMatrix(),apBody->GetMassCentre());
+		return cMath::CheckPointInBVIntersection(vPos,*mpBody->GetBoundingVolume());
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------
+
+void cLuxArea_Sticky::OnBodyExit(iPhysicsBody *apBody)
+{
+	//If this was the last body that was attached, it has now moved out and does not need to be rejected.
+	if(apBody == mpLastAttachedBody)
+		mpLastAttachedBody = NULL;
+}
 
 //-----------------------------------------------------------------------
 
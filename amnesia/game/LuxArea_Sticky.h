@@ -61,7 +61,7 @@ public:
 
 //----------------------------------------------
 
-class cLuxArea_Sticky : public iLuxArea
+class cLuxArea_Sticky : public iLuxArea, public iPhysicsTriggerCallback
 {
 typedef iLuxArea super_class;
 friend class cLuxAreaLoader_Sticky;
@@ -90,6 +90,11 @@ public:
 	//Connection callbacks
 	void OnConnectionStateChange(iLuxEntity *apEntity, int alState){}
 
+	//////////////////////
+	//Trigger callbacks
+	bool CheckBody(iPhysicsBody *apBody);
+	void OnBodyExit(iPhysicsBody *apBody);
+
 	//////////////////////
 	//Save data stuff
 	iLuxEntity_SaveData* CreateSaveData();
@@ -139,6 +144,9 @@ private:
 	float mfSetMtxTime;
 	cMatrixf mtxAttachedStart;
 
+	cPhysicsTriggerVolume *mpTrigger;
+	std::vector<iPhysicsBody*> mvTempBodies;
+
 	static bool mbAllowAttachment;
 };
 
@@ -1149,13 +1149,36 @@ bool cLuxBase::InitEngine()
     //mpEngine->GetGraphics()->GetLowLevel()->SetGammaCorrection(fGamma);
 
 	mpEngine->SetLimitFPS(mpMainConfig->GetBool("Engine","LimitFPS", false));
+	mpEngine->SetRenderInterpolation(mpMainConfig->GetBool("Engine","RenderInterpolation", false));
 	mpEngine->SetWaitIfAppOutOfFocus(mpMainConfig->GetBool("Engine","SleepWhenOutOfFocus", true));
 
+	/////////////////////////
+	// Animation LOD, skeleton poses of far away and hidden mesh entities are updated less often.
+	cMeshEntity::SetAnimationLodActiveByDefault(mpMainConfig->GetBool("Engine","AnimationLod", false));
+	cMeshEntity::SetAnimationLodDistances(	mpMainConfig->GetFloat("Engine","AnimationLodHalfRateDist", 12.0f),
+											mpMainConfig->GetFloat("Engine","AnimationLodQuarterRateDist", 25.0f));
+	cMeshEntity::SetAnimationLodHiddenInterval(mpMainConfig->GetInt("Engine","AnimationLodHiddenInterval", 4));
+
 	cMaterialManager* pMatMgr = mpEngine->GetResources()->GetMaterialManager();
 	pMatMgr->SetTextureSizeDownScaleLevel(mpConfigHandler->mlTextureQuality);
 	pMatMgr->SetTextureFilter((eTextureFilter)mpConfigHandler->mlTextureFilter);
 	pMatMgr->SetTextureAnisotropy(mpConfigHandler->mfTextureAnisotropy);
 
+	/////////////////////////
+	// Memory budgets (MB) for keeping unused resources loaded. 0 turns it off, they are then only destroyed at map changes.
+	cResources *pResources = mpEngine->GetResources();
+	pResources->GetTextureManager()->SetMemoryBudget((size_t)mpMainConfig->GetInt("Engine","TextureMemoryBudget", 1024) << 20);
+	pResources->GetMeshManager()->SetMemoryBudget((size_t)mpMainConfig->GetInt("Engine","MeshMemoryBudget", 256) << 20);
+	pResources->GetSoundManager()->SetMemoryBudget((size_t)mpMainConfig->GetInt("Engine","SoundMemoryBudget", 128) << 20);
+	pResources->GetParticleManager()->SetMemoryBudget((size_t)mpMainConfig->GetInt("Engine","ParticleMemoryBudget", 16) << 20);
+
+	/////////////////////////
+	// Input recording, for playing a session back exactly, eg to reproduce a slowdown. Replay takes precedence.
+	tWString sInputReplayFile = mpMainConfig->GetStringW("Engine","InputReplayFile", _W(""));
+	tWString sInputRecordFile = mpMainConfig->GetStringW("Engine","InputRecordFile", _W(""));
+	if(sInputReplayFile != _W(""))		mpEngine->StartInputReplay(sInputReplayFile);
+	else if(sInputRecordFile != _W(""))	mpEngine->StartInputRecording(sInputRecordFile);
+
 	cSound *pSound = mpEngine->GetSound();
 	pSound->GetLowLevel()->SetVolume(mpMainConfig->GetFloat("Sound","Volume",1.0f));
 
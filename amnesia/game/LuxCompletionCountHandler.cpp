@@ -133,7 +133,7 @@ void cLuxCompletionCountHandler::OnDraw(float afFrameTime)
 	gpBase->mpGameHudSet->DrawFont(mpFont, cVector3f(400,20,1),21,cColor(1,mfAlpha), eFontAlign_Right,eGuiMaterial_FontNormal,
 									_W("%.1f%%"), fPrecent);
 	gpBase->mpGameHudSet->DrawFont(mpFont, cVector3f(400,20,1),21,cColor(1,mfAlpha), eFontAlign_Left,eGuiMaterial_FontNormal,
-									_W(" %ls"), kTranslate("CompletionCount", "Completed").c_str());
+									_W(" %ls"), kTranslateConst("CompletionCount", "Completed").c_str());
 
 }
 
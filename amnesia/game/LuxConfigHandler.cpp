@@ -85,6 +85,9 @@ void cLuxConfigHandler::LoadMainConfig()
 	mbFastPhysicsLoad=	gpBase->mpMainConfig->GetBool("MapLoad","FastPhysicsLoad", false);
 	mbFastStaticLoad=	gpBase->mpMainConfig->GetBool("MapLoad","FastStaticLoad", false);
 	mbFastEntityLoad =	gpBase->mpMainConfig->GetBool("MapLoad","FastEntityLoad", false);
+	mbPreloadMaps =			gpBase->mpMainConfig->GetBool("MapLoad","PreloadMaps", true);
+	mfPreloadMapDistance =	gpBase->mpMainConfig->GetFloat("MapLoad","PreloadMapDistance", 12.0f);
+	mlPreloadMapMemoryMB =	gpBase->mpMainConfig->GetInt("MapLoad","PreloadMapMemoryMB", 256);
 
 	/////////////////////
 	// Graphics variables
@@ -149,6 +152,9 @@ void cLuxConfigHandler::SaveMainConfig()
 	gpBase->mpMainConfig->SetBool("MapLoad","FastPhysicsLoad", mbFastPhysicsLoad);
 	gpBase->mpMainConfig->SetBool("MapLoad","FastStaticLoad", mbFastStaticLoad);
 	gpBase->mpMainConfig->SetBool("MapLoad","FastEntityLoad", mbFastEntityLoad);
+	gpBase->mpMainConfig->SetBool("MapLoad","PreloadMaps", mbPreloadMaps);
+	gpBase->mpMainConfig->SetFloat("MapLoad","PreloadMapDistance", mfPreloadMapDistance);
+	gpBase->mpMainConfig->SetInt("MapLoad","PreloadMapMemoryMB", mlPreloadMapMemoryMB);
 
 	/////////////////////
 	// Graphics variables
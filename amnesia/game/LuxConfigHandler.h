@@ -80,6 +80,9 @@ public:
 	bool mbFastPhysicsLoad;
 	bool mbFastStaticLoad;
 	bool mbFastEntityLoad;
+	bool mbPreloadMaps;
+	float mfPreloadMapDistance;
+	int mlPreloadMapMemoryMB;
 
 	int mlSoundDevID;
 	int mlMaxSoundChannels;
@@ -374,7 +374,7 @@ void cLuxCredits::OnDraw(float afFrameTime)
 	// STATE 1 - SECRET CODE
 	else if(mlState >=2)
 	{
-		mpGuiSet->DrawFont(kTranslate("General", "TheEnd"), mpFontHeader, cVector3f(400,290,10),mvTheEndFontSize,cColor(1,1),eFontAlign_Center);
+		mpGuiSet->DrawFont(kTranslateConst("General", "TheEnd"), mpFontHeader, cVector3f(400,290,10),mvTheEndFontSize,cColor(1,1),eFontAlign_Center);
 
 		//Secret code
 		if(mlEndNum >=0 && mlEndNum<=2 && gpBase->mbPTestActivated==false)
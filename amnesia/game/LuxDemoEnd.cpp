@@ -279,7 +279,7 @@ void cLuxDemoEnd::OnDraw(float afFrameTime)
 
 			fY += mvMessageFontSize.y + 1;
 		}
-		mpGuiSet->DrawFont( kTranslate("Demo", "AvailableAt"), mpFontMessage, cVector3f(400.0f,mfAvailableAtY,10), mvAvailableAtFontSize, mAvailableAtFontColor,eFontAlign_Center);
+		mpGuiSet->DrawFont( kTranslateConst("Demo", "AvailableAt"), mpFontMessage, cVector3f(400.0f,mfAvailableAtY,10), mvAvailableAtFontSize, mAvailableAtFontColor,eFontAlign_Center);
 	}
 
 
@@ -1549,16 +1549,14 @@ void iLuxEnemy::UpdateCheckStuckAtDoor(float afTimeStep)
 
 
 	//////////////////////
-	// Iterate entities and look for a door overlapping
-    cLuxEntityIterator entIt = mpMap->GetEntityIterator();
-	while(entIt.HasNext())
+	// Iterate doors close to the body and look for one overlapping
+	mpMap->GetEntitiesInRadius(mvNearbyEntities, pBV->GetWorldCenter(), pBV->GetRadius(), eLuxEntityType_Prop, eLuxPropType_SwingDoor);
+	for(size_t lEntity=0; lEntity<mvNearbyEntities.size(); ++lEntity)
 	{
-		iLuxEntity *pEntity = entIt.Next();
-		if(pEntity->GetEntityType() != eLuxEntityType_Prop) continue;
+		iLuxEntity *pEntity = mvNearbyEntities[lEntity];
 		if(pEntity->GetDestroyMe()) continue;
 
 		iLuxProp *pProp = static_cast<iLuxProp*>(pEntity);
-		if(pProp->GetPropType() != eLuxPropType_SwingDoor) continue;
 
 		for(int i=0; i<pProp->GetBodyNum(); ++i)
 		{
@@ -2022,18 +2020,12 @@ cLuxProp_Object* iLuxEnemy::GetClosestFood(float afMaxDist, float afMaxHeightDis
 	cLuxProp_Object *pOutputFood=NULL;
 	float fShortestDist=-1;
 
-	cLuxEntityIterator it = mpMap->GetEntityIterator();
-	while(it.HasNext())
+	mpMap->GetEntitiesInRadius(mvNearbyEntities, mpCharBody->GetPosition(), afMaxDist, eLuxEntityType_Prop, eLuxPropType_Object);
+	for(size_t i=0; i<mvNearbyEntities.size(); ++i)
 	{
 		///////////////////////////////////////////
-		// Check so type is correct
-		iLuxEntity *pEntity = it.Next();
-        if(pEntity->GetEntityType() != eLuxEntityType_Prop) continue;
-
-		iLuxProp *pProp = static_cast<iLuxProp*>(pEntity);
-		if(pProp->GetPropType() != eLuxPropType_Object) continue;
-
-		cLuxProp_Object *pObject = static_cast<cLuxProp_Object*>(pProp);
+		// Check so it is food
+		cLuxProp_Object *pObject = static_cast<cLuxProp_Object*>(mvNearbyEntities[i]);
 		if(pObject->IsFood()==false) continue;
 
 		///////////////////////////////////////////
@@ -637,6 +637,8 @@ protected:
 	bool mbStuckAtDoor;
 	int mlStuckDoorID;
 
+	tLuxEntityVec mvNearbyEntities;
+
 	float mfDarknessGlowAlpha;
 	float mfDarknessGlowAlphaGoal;
 	float mfDarknessGlowUpdateCount;
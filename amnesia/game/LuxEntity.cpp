@@ -57,6 +57,12 @@ iLuxEntity::iLuxEntity(const tString &asName, int alID, cLuxMap *apMap, eLuxEnti
 	mbIsLookedAt = false;
 
 	mbInteractionDisabled = false;
+
+	mlMapOrder = 0;
+	mbInMapGrid = false;
+	mlMapGridCell = 0;
+	mfMapGridRadius = 0;
+	mlMapGridTransformCount = 0;
 }
 
 //-----------------------------------------------------------------------
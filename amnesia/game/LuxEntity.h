@@ -174,6 +174,10 @@ public:
 
 	virtual iEntity3D* GetAttachEntity()=0;
 
+	int GetMapOrder(){ return mlMapOrder;}
+	const cVector3f& GetMapGridPos(){ return mvMapGridPos;}
+	float GetMapGridRadius(){ return mfMapGridRadius;}
+
 	virtual cMeshEntity* GetMeshEntity(){ return NULL; }
 
 	void SetCallbackFunc(const tString& asFunc){ msCallbackFunc = asFunc;}
@@ -258,6 +262,14 @@ protected:
 	std::vector<cMesh*> mvPreloadedMeshes;
 	std::vector<cLuxEntityConnection*> mvConnections;
 
+	//Set up by cLuxMap for its type buckets and grid
+	int mlMapOrder;
+	bool mbInMapGrid;
+	unsigned long long mlMapGridCell;
+	cVector3f mvMapGridPos;
+	float mfMapGridRadius;
+	unsigned int mlMapGridTransformCount;
+
 private:
 	eLuxEntityType mEntityType;
 
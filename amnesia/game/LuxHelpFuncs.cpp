@@ -213,9 +213,27 @@ void cLuxHelpFuncs::DrawSetToScreen(bool abClearScreen, const cColor& aCol, cGui
 void cLuxHelpFuncs::CleanupData()
 {
 	//Destroy particle systems and sounds that are not in use.
-	gpBase->mpEngine->GetResources()->GetSoundManager()->DestroyUnused(20);
-	gpBase->mpEngine->GetResources()->GetParticleManager()->DestroyUnused(10);
+	//With a memory budget the least recently used are kept, so going back to a map is quick.
+	cResources *pResources = gpBase->mpEngine->GetResources();
+	if(pResources->GetSoundManager()->GetMemoryBudget() > 0)	pResources->GetSoundManager()->EvictUnused();
+	else														pResources->GetSoundManager()->DestroyUnused(20);
+
+	if(pResources->GetParticleManager()->GetMemoryBudget() > 0)	pResources->GetParticleManager()->EvictUnused();
+	else															pResources->GetParticleManager()->DestroyUnused(10);
+
+}
+
+//-----------------------------------------------------------------------
+
+void cLuxHelpFuncs::LogGuiDrawStats(const tString& asName, cGuiSet *apSet)
+{
+	const cGuiSetDrawStats& stats = apSet->GetDrawStats();
+	if(stats.mlFrames==0) return;
 
+	float fFrames = (float)stats.mlFrames;
+	Log("%s gui: %d frames, cpu per frame %.3f ms build + %.3f ms render. %.0f objects (%.0f cached) in %.1f draw calls per frame\n",
+		asName.c_str(), stats.mlFrames, stats.mfBuildTime / fFrames, stats.mfRenderTime / fFrames,
+		stats.mlRenderObjects / fFrames, stats.mlCachedRenderObjects / fFrames, stats.mlDrawCalls / fFrames);
 }
 
 //-----------------------------------------------------------------------
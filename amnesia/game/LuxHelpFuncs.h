@@ -71,6 +71,11 @@ public:
 
 	void CleanupData();
 
+	/**
+	 * Logs the gui cpu time per frame since the stats were last reset.
+	 */
+	void LogGuiDrawStats(const tString& asName, cGuiSet *apSet);
+
 	tWString ParseString(const tWString& asInput);
 
 	float GetStringDuration(const tWString& asStr);
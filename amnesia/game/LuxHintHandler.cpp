@@ -198,24 +198,21 @@ void cLuxHintHandler::DrawHintText(float afFrameTime, cGuiSet *apGuiSet)
 	float fX = mHintOscill.val*0.5;
 	cColor hintCol(1,fX,fX, mfAlpha);
 	apGuiSet->DrawFont(mpFont, cVector3f(400,mfYPos,20),mvFontSize,hintCol, eFontAlign_Center, eGuiMaterial_FontNormal,
-		_W(" %ls"), kTranslate("Hints", "HINT:").c_str());
+		_W(" %ls"), kTranslateConst("Hints", "HINT:").c_str());
 
-	tWStringVec vRows;
+	//The rows are drawn with a leading space, same as the " %ls" format used for the header
 	float fMaxWidth = 680;
 	float fStartY = mfYPos + mvFontSize.y + 3.0f;
-	mpFont->GetWordWrapRows(fMaxWidth,15, mvFontSize, msCurrentText, &vRows);
-    if(vRows.size()==1)
+	float fSpaceLength = mpFont->GetLength(mvFontSize, _W(" "));
+	const cTextLayout *pLayout = mpFont->GetWordWrapLayout(fMaxWidth, mvFontSize, msCurrentText);
+	if(pLayout->GetRowNum()==1)
 	{
-		apGuiSet->DrawFont(mpFont, cVector3f(400,fStartY,20),mvFontSize,cColor(1,mfAlpha), eFontAlign_Center, eGuiMaterial_FontNormal,
-							_W(" %ls"), msCurrentText.c_str());
+		float fX = 400 - (fSpaceLength + pLayout->GetRow(0).mfLength)*0.5f + fSpaceLength;
+		apGuiSet->DrawTextLayoutRow(pLayout, 0, cVector3f(fX,fStartY,20), cColor(1,mfAlpha));
 	}
 	else
 	{
-		for(size_t i=0; i<vRows.size(); ++i)
-		{
-			apGuiSet->DrawFont(mpFont, cVector3f(400-fMaxWidth*0.5f, fStartY + (float)i* (mvFontSize.y+2.0f), 20),mvFontSize,cColor(1,mfAlpha), eFontAlign_Left, eGuiMaterial_FontNormal,
-								_W(" %ls"), vRows[i].c_str());
-		}
+		apGuiSet->DrawTextLayout(pLayout, cVector3f(400-fMaxWidth*0.5f + fSpaceLength, fStartY, 20), mvFontSize.y+2.0f, cColor(1,mfAlpha));
 	}
 
 #ifdef USE_GAMEPAD
@@ -842,6 +842,7 @@ void cLuxInventory::OnEnterContainer(const tString& asOldContainer)
 
 	mpGuiSet->ResetMouseOver();
 	mpGui->SetFocus(mpGuiSet);
+	mpGuiSet->ResetDrawStats();
 
 	gpBase->mpMapHandler->ResumeSoundsAndMusic();
 
@@ -900,6 +901,8 @@ void cLuxInventory::OnLeaveContainer(const tString& asNewContainer)
 	mpViewport->SetVisible(false);
 	mpGuiSet->SetActive(false);
 
+	gpBase->mpHelpFuncs->LogGuiDrawStats("Inventory", mpGuiSet);
+
 	mbExitToJournal = false;
 	mbEnterFromJournal = false;
 
@@ -2040,8 +2043,9 @@ bool cLuxInventory::SanityOnUpdate(iWidget* apWidget, const cGuiMessageData& aDa
 	int lSanityStatus = StatusToIndex(gpBase->mpPlayer->GetSanity());
 	StatusWidgetUpdate(apWidget, lSanityStatus, mpSanityStatus, mvLayout_SanityCenter);
 
-	tString sSanityDesc = "SanityDesc"+cString::ToString(lSanityStatus);
-	MouseOverWidgetUpdate(apWidget, kTranslate("Inventory", "Sanity"), kTranslate("Inventory", sSanityDesc));
+	static const tLanguageEntryId vSanityDescIds[4] = {	kTranslateId("Inventory", "SanityDesc0"), kTranslateId("Inventory", "SanityDesc1"),
+															kTranslateId("Inventory", "SanityDesc2"), kTranslateId("Inventory", "SanityDesc3") };
+	MouseOverWidgetUpdate(apWidget, kTranslateConst("Inventory", "Sanity"), kTranslateFromId(vSanityDescIds[lSanityStatus]));
 
 	return true;
 }
@@ -2079,8 +2083,9 @@ bool cLuxInventory::HealthOnUpdate(iWidget* apWidget, const cGuiMessageData& aDa
 	int lHealthStatus = StatusToIndex(gpBase->mpPlayer->GetHealth());
 	StatusWidgetUpdate(apWidget, lHealthStatus, mpHealthStatus, mvLayout_HealthCenter);
 
-	tString sHealthDesc = "HealthDesc"+cString::ToString(lHealthStatus);
-	MouseOverWidgetUpdate(apWidget, kTranslate("Inventory", "Health"), kTranslate("Inventory", sHealthDesc));
+	static const tLanguageEntryId vHealthDescIds[4] = {	kTranslateId("Inventory", "HealthDesc0"), kTranslateId("Inventory", "HealthDesc1"),
+															kTranslateId("Inventory", "HealthDesc2"), kTranslateId("Inventory", "HealthDesc3") };
+	MouseOverWidgetUpdate(apWidget, kTranslateConst("Inventory", "Health"), kTranslateFromId(vHealthDescIds[lHealthStatus]));
 
 	return true;
 }
@@ -2152,7 +2157,7 @@ kGuiCallbackDeclaredFuncEnd(cLuxInventory, OilOnDraw);
 
 bool cLuxInventory::OilOnUpdate(iWidget* apWidget, const cGuiMessageData& aData)
 {
-	MouseOverWidgetUpdate(apWidget, kTranslate("Inventory", "LampOil"), kTranslate("Inventory", "LampOilDesc"));
+	MouseOverWidgetUpdate(apWidget, kTranslateConst("Inventory", "LampOil"), kTranslateConst("Inventory", "LampOilDesc"));
 
 	const cVector2f& vFullOilSize = apWidget->GetSize();
 	float fRemainingOilHeight = gpBase->mpPlayer->GetLampOil()*0.01f * vFullOilSize.y;
@@ -2237,7 +2242,7 @@ kGuiCallbackDeclaredFuncEnd(cLuxInventory, TinderboxOnDraw);
 
 bool cLuxInventory::TinderboxOnUpdate(iWidget* apWidget, const cGuiMessageData& aData)
 {
-	MouseOverWidgetUpdate(apWidget, kTranslate("Inventory", "Tinderboxes"), kTranslate("Inventory", "TinderboxesDesc"));
+	MouseOverWidgetUpdate(apWidget, kTranslateConst("Inventory", "Tinderboxes"), kTranslateConst("Inventory", "TinderboxesDesc"));
 
 	return true;
 }
@@ -2271,7 +2276,7 @@ kGuiCallbackDeclaredFuncEnd(cLuxInventory, JournalOnDraw);
 
 bool cLuxInventory::JournalOnUpdate(iWidget* apWidget, const cGuiMessageData& aData)
 {
-	MouseOverWidgetUpdate(apWidget, kTranslate("Inventory", "Journal"), kTranslate("Inventory", "JournalDesc"));
+	MouseOverWidgetUpdate(apWidget, kTranslateConst("Inventory", "Journal"), kTranslateConst("Inventory", "JournalDesc"));
 
 	return true;
 }
@@ -574,6 +574,7 @@ void cLuxJournal::OnEnterContainer(const tString& asOldContainer)
 
 	mpGuiSet->ResetMouseOver();
 	mpGui->SetFocus(mpGuiSet);
+	mpGuiSet->ResetDrawStats();
 
 	//gpBase->mpMapHandler->PauseSoundsAndMusic();
 
@@ -625,6 +626,8 @@ void cLuxJournal::OnLeaveContainer(const tString& asNewContainer)
 	mpViewport->SetVisible(false);
 	mpGuiSet->SetActive(false);
 
+	gpBase->mpHelpFuncs->LogGuiDrawStats("Journal", mpGuiSet);
+
 	DestroyGui();
 	DestroyBackground();
 
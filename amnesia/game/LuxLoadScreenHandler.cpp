@@ -248,7 +248,7 @@ void cLuxLoadScreenHandler::DrawGameScreen()
 void cLuxLoadScreenHandler::DrawMenuScreen()
 {
 	
-	tWString sLoading = kTranslate("General", "Loading");
+	tWString sLoading = kTranslateConst("General", "Loading");
 
 	cGuiSet *pSet = gpBase->mpHelpFuncs->GetSet();
 
@@ -445,7 +445,7 @@ void cLuxLoadScreenHandler::DrawGameScreen(cGuiSet *apSet)
 
 		///////////////////
 		//Loading
-		tWString sLoading = kTranslate("General", "Loading");
+		tWString sLoading = kTranslateConst("General", "Loading");
 		cVector3f vPos(400, mfLoadingY,1);
 
 		apSet->DrawFont(sLoading, mpFontDefault, vPos, mvLoadingFontSize, cColor(1,0,0,mfLoadingAlpha), eFontAlign_Center);
@@ -454,7 +454,7 @@ void cLuxLoadScreenHandler::DrawGameScreen(cGuiSet *apSet)
 	//Draw loading only
 	else
 	{
-		tWString sLoading = kTranslate("General", "Loading");
+		tWString sLoading = kTranslateConst("General", "Loading");
 		cVector3f vPos(400, 300-mvLoadingFontSize.y/2,1);
 
 		apSet->DrawFont(sLoading, mpFontDefault, vPos, mvLoadingFontSize, cColor(1,1), eFontAlign_Center);
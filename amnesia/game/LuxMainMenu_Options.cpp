@@ -1979,7 +1979,7 @@ bool cLuxMainMenu_Options::Window_OnUpdate(iWidget* apWidget, const cGuiMessageD
 		if(mpCurrentTipWidget && mpCurrentTipWidget->GetUserData())
 		{
 			cLuxOption_ExtData* pData = (cLuxOption_ExtData*)mpCurrentTipWidget->GetUserData();
-			tWString sRestart = pData->mbNeedsRestart? _W(" (") + kTranslate("OptionsMenu", "ReqRestart") + _W(")"): _W("");
+			tWString sRestart = pData->mbNeedsRestart? _W(" (") + kTranslateConst("OptionsMenu", "ReqRestart") + _W(")"): _W("");
 
 			mpLTip->SetText(pData->msMessage + sRestart);
 		}
@@ -42,6 +42,12 @@
 #include "LuxArea_Sticky.h"
 
 #include <sstream>
+#include <algorithm>
+
+//-----------------------------------------------------------------------
+
+static const float kLuxEntityGridCellSize = 8.0f;
+static const int kLuxEntityGridMaxQueryCells = 512;
 
 //////////////////////////////////////////////////////////////////////////
 // DISSOLVE ENTITIES
@@ -75,6 +81,13 @@ cLuxMap::cLuxMap(const tString& asName)
 
 	mpLatestAddedEntity = NULL;
 
+	mvEntitiesByType.resize(eLuxEntityType_LastEnum);
+	mvPropsByType.resize(eLuxPropType_LastEnum);
+	mvAreasByType.resize(eLuxAreaType_LastEnum);
+	mlEntityOrderCount = 0;
+	mfEntityGridStep = 0;
+	mfEntityGridPrevStep = 0;
+
 	mpScript = NULL;
 
 	msLanternLitCallback = "";
@@ -323,6 +336,7 @@ void cLuxMap::AfterWorldLoadEntitySetup()
 		iLuxEntity *pEntity = *entityIt;
 
 		pEntity->AfterWorldLoad();
+		UpdateEntityGridCell(pEntity);
 	}
 }
 
@@ -379,6 +393,10 @@ void cLuxMap::Update(float afTimeStep)
 
 	UpdateToBeDesotroyedEntities(true);
 
+	//Grid positions lag behind the entities by up to an update, queries are padded by the largest step
+	mfEntityGridPrevStep = mfEntityGridStep;
+	mfEntityGridStep = 0;
+
 	////////////////////////////////////
 	// Iterate entities
 	tLuxEntityListIt entityIt = mlstEntities.begin();
@@ -387,7 +405,10 @@ void cLuxMap::Update(float afTimeStep)
 		iLuxEntity *pEntity = *entityIt;
 
         if(pEntity->IsActive())
+		{
 			pEntity->UpdateLogic(afTimeStep);
+			UpdateEntityGridCell(pEntity);
+		}
 	}
 
 	UpdateToBeDesotroyedEntities(true);
@@ -571,8 +592,17 @@ void cLuxMap::DestroyAllEntities()
 	mlstToBeDestroyedEntities.clear();
 	mpLatestAddedEntity = NULL;
 	mlstEnemies.clear();
+	mEntityNameIndex.Clear();
 	mlstStickyAreas.clear();
 
+	for(size_t i=0; i<mvEntitiesByType.size(); ++i) mvEntitiesByType[i].clear();
+	for(size_t i=0; i<mvPropsByType.size(); ++i) mvPropsByType[i].clear();
+	for(size_t i=0; i<mvAreasByType.size(); ++i) mvAreasByType[i].clear();
+	m_mapEntityGrid.clear();
+	mvLargeGridEntities.clear();
+	mfEntityGridStep = 0;
+	mfEntityGridPrevStep = 0;
+
 	mbCommentaryIconsActive = false;//Can reset this since all commentary icons are destroyed
 }
 
@@ -583,6 +613,7 @@ void cLuxMap::AddEntity(iLuxEntity *apEntity)
 	m_mapEntitiesByName.insert(tLuxEntityNameMap::value_type(cString::ToLowerCase(apEntity->GetName()), apEntity));
 	m_mapEntitiesByID.insert(tLuxEntityIDMap::value_type(apEntity->GetID(), apEntity));
 	mlstEntities.push_back(apEntity);
+	AddToEntityIndex(apEntity);
 
 	mpLatestAddedEntity = apEntity;
 
@@ -657,6 +688,98 @@ cLuxEntityIterator cLuxMap::GetEntityIterator()
 	return cLuxEntityIterator(&mlstEntities);
 }
 
+cLuxEntityIterator cLuxMap::GetEntityIterator(eLuxEntityType aType, int alSubType)
+{
+	return cLuxEntityIterator(GetEntityTypeList(aType, alSubType));
+}
+
+//-----------------------------------------------------------------------
+
+static bool SortEntitiesByMapOrder(iLuxEntity *apEntityA, iLuxEntity *apEntityB)
+{
+	return apEntityA->GetMapOrder() < apEntityB->GetMapOrder();
+}
+
+static inline bool EntityInRadius(iLuxEntity *apEntity, const cVector3f& avPos, float afRadius)
+{
+	float fMaxDist = afRadius + apEntity->GetMapGridRadius();
+	return cMath::Vector3DistSqr(apEntity->GetMapGridPos(), avPos) <= fMaxDist * fMaxDist;
+}
+
+void cLuxMap::GetEntitiesInRadius(tLuxEntityVec& avEntities, const cVector3f& avPos, float afRadius, eLuxEntityType aType, int alSubType)
+{
+	avEntities.clear();
+
+	//The grid has the positions from the last update, so pad by how far an entity has moved in one.
+	//Callers do their own exact tests.
+	float fRadius = afRadius + cMath::Max(mfEntityGridStep, mfEntityGridPrevStep);
+
+	////////////////////////////////
+	// Large radius, cheaper to go through the type list
+	cVector3l vMin = GetEntityGridCoord(avPos - (fRadius + kLuxEntityGridCellSize));
+	cVector3l vMax = GetEntityGridCoord(avPos + (fRadius + kLuxEntityGridCellSize));
+	cVector3l vNum = vMax - vMin + 1;
+	if(vNum.x * vNum.y * vNum.z > kLuxEntityGridMaxQueryCells)
+	{
+		tLuxEntityList *pList = GetEntityTypeList(aType, alSubType);
+		for(tLuxEntityListIt it = pList->begin(); it != pList->end(); ++it)
+		{
+			iLuxEntity *pEntity = *it;
+			if(pEntity->mbInMapGrid && pEntity->IsActive() &&
+				EntityInRadius(pEntity, avPos, fRadius))
+			{
+				avEntities.push_back(pEntity);
+			}
+		}
+		return;
+	}
+
+	////////////////////////////////
+	// Cells, small entities are only in the cell of their center so the range is padded by one cell size
+	for(int z=vMin.z; z<=vMax.z; ++z)
+	for(int y=vMin.y; y<=vMax.y; ++y)
+	for(int x=vMin.x; x<=vMax.x; ++x)
+	{
+		tLuxEntityGridMapIt cellIt = m_mapEntityGrid.find(GetEntityGridKey(cVector3l(x,y,z)));
+		if(cellIt == m_mapEntityGrid.end()) continue;
+
+		tLuxEntityVec &vCell = cellIt->second;
+		for(size_t i=0; i<vCell.size(); ++i)
+		{
+			iLuxEntity *pEntity = vCell[i];
+			if(pEntity->IsActive() && LuxIsCorrectType(pEntity, aType, alSubType) &&
+				EntityInRadius(pEntity, avPos, fRadius))
+			{
+				avEntities.push_back(pEntity);
+			}
+		}
+	}
+
+	for(size_t i=0; i<mvLargeGridEntities.size(); ++i)
+	{
+		iLuxEntity *pEntity = mvLargeGridEntities[i];
+		if(pEntity->IsActive() && LuxIsCorrectType(pEntity, aType, alSubType) &&
+			EntityInRadius(pEntity, avPos, fRadius))
+		{
+			avEntities.push_back(pEntity);
+		}
+	}
+
+	std::sort(avEntities.begin(), avEntities.end(), SortEntitiesByMapOrder);
+}
+
+//-----------------------------------------------------------------------
+
+void cLuxMap::GetEntitiesMatchingName(const tString& asPattern, tLuxEntityList& alstEntities, eLuxEntityType aType, int alSubType)
+{
+	mEntityNameIndex.Find(asPattern, mvTempNameMatches);
+	for(size_t i=0; i<mvTempNameMatches.size(); ++i)
+	{
+		iLuxEntity *pEntity = static_cast<iLuxEntity*>(mvTempNameMatches[i]);
+		if(LuxIsCorrectType(pEntity, aType, alSubType)) alstEntities.push_back(pEntity);
+	}
+}
+
 //-----------------------------------------------------------------------
 
 cLuxEnemyIterator cLuxMap::GetEnemyIterator()
@@ -1295,6 +1418,7 @@ void cLuxMap::UpdateToBeDesotroyedEntities(bool abUseCallbacks)
 		STLFindAndRemove(mlstEntities, pEntity);
 		STLMapFindAndRemove(m_mapEntitiesByName, pEntity);
 		STLMapFindAndRemove(m_mapEntitiesByID, pEntity);
+		RemoveFromEntityIndex(pEntity);
 
 		//Extra remove for enemies
 		if(pEntity->GetEntityType() == eLuxEntityType_Enemy)
@@ -1317,6 +1441,178 @@ void cLuxMap::UpdateToBeDesotroyedEntities(bool abUseCallbacks)
 
 	mlstToBeDestroyedEntities.clear();
 }
+
+//-----------------------------------------------------------------------
+
+tLuxEntityList* cLuxMap::GetEntityTypeList(eLuxEntityType aType, int alSubType)
+{
+	if(aType == eLuxEntityType_LastEnum) return &mlstEntities;
+
+	if(alSubType >= 0)
+	{
+		if(aType == eLuxEntityType_Prop)
+			return alSubType < (int)mvPropsByType.size() ? &mvPropsByType[alSubType] : &mlstNoEntities;
+		if(aType == eLuxEntityType_Area)
+			return alSubType < (int)mvAreasByType.size() ? &mvAreasByType[alSubType] : &mlstNoEntities;
+	}
+
+	return &mvEntitiesByType[aType];
+}
+
+//-----------------------------------------------------------------------
+
+void cLuxMap::AddToEntityIndex(iLuxEntity *apEntity)
+{
+	//Entities are always added to the end of mlstEntities, so the count keeps the order of it.
+	apEntity->mlMapOrder = mlEntityOrderCount++;
+
+	mEntityNameIndex.Add(apEntity, apEntity->mlMapOrder, apEntity->GetName());
+
+	mvEntitiesByType[apEntity->GetEntityType()].push_back(apEntity);
+
+	if(apEntity->GetEntityType() == eLuxEntityType_Prop)
+	{
+		iLuxProp *pProp = static_cast<iLuxProp*>(apEntity);
+		mvPropsByType[pProp->GetPropType()].push_back(apEntity);
+	}
+	else if(apEntity->GetEntityType() == eLuxEntityType_Area)
+	{
+		iLuxArea *pArea = static_cast<iLuxArea*>(apEntity);
+		mvAreasByType[pArea->GetAreaType()].push_back(apEntity);
+	}
+
+	//Bodies are not always created when entity is added, it is put in the grid after world load or at the first update.
+}
+
+void cLuxMap::RemoveFromEntityIndex(iLuxEntity *apEntity)
+{
+	mEntityNameIndex.Remove(apEntity->mlMapOrder);
+
+	STLFindAndRemove(mvEntitiesByType[apEntity->GetEntityType()], apEntity);
+
+	if(apEntity->GetEntityType() == eLuxEntityType_Prop)
+	{
+		iLuxProp *pProp = static_cast<iLuxProp*>(apEntity);
+		STLFindAndRemove(mvPropsByType[pProp->GetPropType()], apEntity);
+	}
+	else if(apEntity->GetEntityType() == eLuxEntityType_Area)
+	{
+		iLuxArea *pArea = static_cast<iLuxArea*>(apEntity);
+		STLFindAndRemove(mvAreasByType[pArea->GetAreaType()], apEntity);
+	}
+
+	RemoveFromEntityGrid(apEntity);
+}
+
+//-----------------------------------------------------------------------
+
+void cLuxMap::UpdateEntityGridCell(iLuxEntity *apEntity)
+{
+	iEntity3D *pAttachEntity = apEntity->GetAttachEntity();
+	if(pAttachEntity==NULL) return;
+
+	////////////////////////////////
+	// Skip if nothing has moved since the last update, the counts only go up
+	unsigned int lTransformCount = (unsigned int)pAttachEntity->GetTransformUpdateCount();
+	for(int i=0; i<apEntity->GetBodyNum(); ++i)
+	{
+		iPhysicsBody *pBody = apEntity->GetBody(i);
+		if(pBody) lTransformCount += (unsigned int)pBody->GetTransformUpdateCount();
+	}
+	if(apEntity->mbInMapGrid && lTransformCount == apEntity->mlMapGridTransformCount) return;
+	apEntity->mlMapGridTransformCount = lTransformCount;
+
+	////////////////////////////////
+	// Radius that covers all bodies from the attach position, bodies can move apart so it is redone on every move
+	cVector3f vPos = pAttachEntity->GetWorldPosition();
+	cBoundingVolume *pAttachBV = pAttachEntity->GetBoundingVolume();
+	float fRadius = cMath::Vector3Dist(pAttachBV->GetWorldCenter(), vPos) + pAttachBV->GetRadius();
+	for(int i=0; i<apEntity->GetBodyNum(); ++i)
+	{
+		iPhysicsBody *pBody = apEntity->GetBody(i);
+		if(pBody==NULL) continue;
+
+		cBoundingVolume *pBV = pBody->GetBoundingVolume();
+		fRadius = cMath::Max(fRadius, cMath::Vector3Dist(pBV->GetWorldCenter(), vPos) + pBV->GetRadius());
+	}
+
+	////////////////////////////////
+	// Already in grid, only move cell if needed
+	if(apEntity->mbInMapGrid)
+	{
+		mfEntityGridStep = cMath::Max(mfEntityGridStep, cMath::Vector3Dist(vPos, apEntity->mvMapGridPos));
+
+		bool bLarge = fRadius > kLuxEntityGridCellSize;
+		if(bLarge == (apEntity->mfMapGridRadius > kLuxEntityGridCellSize) &&
+			(bLarge || GetEntityGridKey(GetEntityGridCoord(vPos)) == apEntity->mlMapGridCell))
+		{
+			apEntity->mvMapGridPos = vPos;
+			apEntity->mfMapGridRadius = fRadius;
+			return;
+		}
+
+		RemoveFromEntityGrid(apEntity);
+	}
+
+	AddToEntityGrid(apEntity, vPos, fRadius);
+}
+
+void cLuxMap::AddToEntityGrid(iLuxEntity *apEntity, const cVector3f& avPos, float afRadius)
+{
+	apEntity->mbInMapGrid = true;
+	apEntity->mvMapGridPos = avPos;
+	apEntity->mfMapGridRadius = afRadius;
+
+	if(afRadius > kLuxEntityGridCellSize)
+	{
+		mvLargeGridEntities.push_back(apEntity);
+	}
+	else
+	{
+		apEntity->mlMapGridCell = GetEntityGridKey(GetEntityGridCoord(avPos));
+		m_mapEntityGrid[apEntity->mlMapGridCell].push_back(apEntity);
+	}
+}
+
+void cLuxMap::RemoveFromEntityGrid(iLuxEntity *apEntity)
+{
+	if(apEntity->mbInMapGrid==false) return;
+
+	if(apEntity->mfMapGridRadius > kLuxEntityGridCellSize)
+	{
+		STLFindAndRemove(mvLargeGridEntities, apEntity);
+	}
+	else
+	{
+		tLuxEntityGridMapIt cellIt = m_mapEntityGrid.find(apEntity->mlMapGridCell);
+		if(cellIt != m_mapEntityGrid.end())
+		{
+			STLFindAndRemove(cellIt->second, apEntity);
+			if(cellIt->second.empty()) m_mapEntityGrid.erase(cellIt);
+		}
+	}
+
+	apEntity->mbInMapGrid = false;
+}
+
+//-----------------------------------------------------------------------
+
+cVector3l cLuxMap::GetEntityGridCoord(const cVector3f& avPos)
+{
+	return cVector3l(	(int)floor(avPos.x / kLuxEntityGridCellSize),
+						(int)floor(avPos.y / kLuxEntityGridCellSize),
+						(int)floor(avPos.z / kLuxEntityGridCellSize));
+}
+
+unsigned long long cLuxMap::GetEntityGridKey(const cVector3l& avCoord)
+{
+	//21 bits per axis, plenty for any map at the cell size
+	const unsigned long long lMask = (1ULL << 21) -1;
+	return	(((unsigned long long)avCoord.x & lMask) << 42) |
+			(((unsigned long long)avCoord.y & lMask) << 21) |
+			((unsigned long long)avCoord.z & lMask);
+}
+
 //-----------------------------------------------------------------------
 
 void cLuxMap::UpdateTimers(float afTimeStep)
@@ -24,6 +24,8 @@
 
 #include "LuxBase.h"
 
+#include <unordered_map>
+
 //----------------------------------------------
 
 class cLuxNode_Pos;
@@ -44,6 +46,9 @@ typedef tLuxArea_StickyList::iterator tLuxArea_StickyListIt;
 typedef std::list<cLuxLampLightConnection*> tLuxLampLightConnectionList;
 typedef tLuxLampLightConnectionList::iterator tLuxLampLightConnectionListIt;
 
+typedef std::unordered_map<unsigned long long, tLuxEntityVec> tLuxEntityGridMap;
+typedef tLuxEntityGridMap::iterator tLuxEntityGridMapIt;
+
 //----------------------------------------------
 class cLuxMap;
 
@@ -117,6 +122,20 @@ public:
 	void ResetLatestEntity(){ mpLatestAddedEntity=NULL;}
 	bool EntityExists(iLuxEntity *apEntity);
 	cLuxEntityIterator GetEntityIterator();
+	/**
+	 * Only the entities of a type, and sub type for props and areas, in the same order as GetEntityIterator().
+	 */
+	cLuxEntityIterator GetEntityIterator(eLuxEntityType aType, int alSubType=-1);
+	/**
+	 * Active entities whose bounds reach within afRadius of avPos, in the same order as GetEntityIterator().
+	 * Positions are the ones from the last update, the query is padded by the largest distance an entity moved
+	 * in an update so nothing is missed. Callers still do their exact test on the result.
+	 */
+	void GetEntitiesInRadius(tLuxEntityVec& avEntities, const cVector3f& avPos, float afRadius, eLuxEntityType aType=eLuxEntityType_LastEnum, int alSubType=-1);
+	/**
+	 * Entities with names containing all the '*' separated parts of asPattern, in the same order as GetEntityIterator().
+	 */
+	void GetEntitiesMatchingName(const tString& asPattern, tLuxEntityList& alstEntities, eLuxEntityType aType=eLuxEntityType_LastEnum, int alSubType=-1);
 	cLuxEnemyIterator GetEnemyIterator();
 
 	void BroadcastEnemyMessage(eLuxEnemyMessage aType, bool abHasPosition, const cVector3f& avPos, float afRadius,
@@ -200,6 +219,15 @@ private:
 	void UpdateLampLightConnections(float afTimeStep);
 	void UpdateCheckCommentaryIconActive(float afTimeStep);
 
+	tLuxEntityList* GetEntityTypeList(eLuxEntityType aType, int alSubType);
+	void AddToEntityIndex(iLuxEntity *apEntity);
+	void RemoveFromEntityIndex(iLuxEntity *apEntity);
+	void UpdateEntityGridCell(iLuxEntity *apEntity);
+	void AddToEntityGrid(iLuxEntity *apEntity, const cVector3f& avPos, float afRadius);
+	void RemoveFromEntityGrid(iLuxEntity *apEntity);
+	cVector3l GetEntityGridCoord(const cVector3f& avPos);
+	unsigned long long GetEntityGridKey(const cVector3l& avCoord);
+
 	tString msName;
 	tString msFileName;
 
@@ -242,6 +270,21 @@ private:
 	tLuxEnemyList mlstEnemies;
 	tLuxEntityList mlstToBeDestroyedEntities;
 	iLuxEntity *mpLatestAddedEntity;
+
+	std::vector<tLuxEntityList> mvEntitiesByType;
+	std::vector<tLuxEntityList> mvPropsByType;
+	std::vector<tLuxEntityList> mvAreasByType;
+	tLuxEntityList mlstNoEntities;
+	int mlEntityOrderCount;
+
+	tLuxEntityGridMap m_mapEntityGrid;
+	tLuxEntityVec mvLargeGridEntities;
+	float mfEntityGridStep;
+	float mfEntityGridPrevStep;
+
+	cWildcardNameIndex mEntityNameIndex;
+	std::vector<void*> mvTempNameMatches;
+
 	tLuxArea_StickyList mlstStickyAreas;
 
 	tLuxPlayerStartMap m_mapPlayerStartNodes;
@@ -33,6 +33,7 @@
 
 #include "LuxEnemy.h"
 #include "LuxAchievementHandler.h"
+#include "LuxProp_LevelDoor.h"
 #include "engine/Interface.h"
 #include <mutex>
 
@@ -180,6 +181,7 @@ cLuxMapHandler::cLuxMapHandler() : iLuxUpdateable("LuxMapHandler")
 	//Variables
 	mbPausedSoundsAndMusic = false;
 	mpDataCache =NULL;
+	mfMapPreloadCount = 0;
 
 	Reset();
 }
@@ -207,6 +209,12 @@ void cLuxMapHandler::OnStart()
 	mpViewport->ConnectDraw(m_postDebugSolidDrawHandler);
 	mpViewport->ConnectDraw(m_postDebugTranslucentDrawHandler);
 	UpdateViewportRenderProperties();
+
+	//////////////////////
+	//Set up map preloading
+	MapPreloader *pPreloader = gpBase->mpEngine->GetResources()->GetMapPreloader();
+	pPreloader->SetActive(gpBase->mpConfigHandler->mbPreloadMaps);
+	pPreloader->SetMemoryBudget((size_t)gpBase->mpConfigHandler->mlPreloadMapMemoryMB * 1024 * 1024);
 }
 
 //-----------------------------------------------------------------------
@@ -228,7 +236,11 @@ void cLuxMapHandler::Update(float afTimeStep)
 	CheckMapChange(afTimeStep);
 
 	if(mpCurrentMap && mMapChangeData.mbActive==false)
+	{
 		mpCurrentMap->Update(afTimeStep);
+
+		UpdateMapPreload(afTimeStep);
+	}
 }
 
 //-----------------------------------------------------------------------
@@ -250,6 +262,10 @@ void cLuxMapHandler::Reset()
 
 	mMapChangeData.mbActive = false;
 
+	mfMapPreloadCount = 0;
+	m_setPreloadedMapFiles.clear();
+	gpBase->mpEngine->GetResources()->GetMapPreloader()->Clear();
+
 	mpSavedGame->Reset();
 
 	gpBase->mpHelpFuncs->CleanupData();
@@ -361,6 +377,9 @@ void cLuxMapHandler::ChangeMap(const tString& asMapName, const tString& asStartP
 	mMapChangeData.msStartPos = asStartPos;
     mMapChangeData.msSound = asEndSound;
 
+	//Get a head start on the new map while fading out
+	PreloadMap(mMapChangeData.msMapFile);
+
     gpBase->mpHelpFuncs->PlayGuiSoundData(asStartSound, eSoundEntryType_Gui);
 
 	gpBase->mpEffectHandler->GetFade()->FadeOut(1.5f);
@@ -565,6 +584,12 @@ void cLuxMapHandler::CheckMapChange(float afTimeStep)
 	tString sNewMapName = FileToMapName(mMapChangeData.msMapFile);
 	if(mpCurrentMap->GetName() != sNewMapName)
 	{
+		//Nothing more is read in the background, what is already prepared is used by the loaders
+		MapPreloader *pPreloader = gpBase->mpEngine->GetResources()->GetMapPreloader();
+		pPreloader->CancelPending();
+		tWString sMapPath = gpBase->mpEngine->GetResources()->GetFileSearcher()->GetFilePath(msMapFolder + mMapChangeData.msMapFile);
+		bool bPreloaded = pPreloader->IsRequested(sMapPath);
+
 		unsigned long lLoadStartTime = 0;
 		{
 			std::lock_guard<std::recursive_mutex> lk(m_saveGameMutex);
@@ -638,6 +663,14 @@ void cLuxMapHandler::CheckMapChange(float afTimeStep)
 		//Check if any more load time needed
 		fTimeTaken = (float)(cPlatform::GetApplicationTime() - lLoadStartTime)/1000.0f;
 
+		//Compare against a run with MapLoad/PreloadMaps turned off in the main config to see what preloading gains
+		MapPreloader::cStats preloadStats = pPreloader->GetStats();
+		Log("Map '%s' loaded in %d ms (preloaded: %d, %d of %d prepared files used, %d bitmaps and %d sounds were prepared)\n",
+			sNewMapName.c_str(), (int)(fTimeTaken*1000.0f), bPreloaded ? 1 : 0, preloadStats.mlTakenFiles, preloadStats.mlPreparedFiles,
+			preloadStats.mlPreparedBitmaps, preloadStats.mlPreparedSounds);
+		pPreloader->Clear();
+		m_setPreloadedMapFiles.clear();
+
 		ProgLog(eLuxProgressLogLevel_High, "Entering map "+ mpCurrentMap->GetName());
 	}
 	///////////////////////
@@ -665,3 +698,57 @@ void cLuxMapHandler::CheckMapChange(float afTimeStep)
 
 
 
+
+void cLuxMapHandler::UpdateMapPreload(float afTimeStep)
+{
+	if(gpBase->mpConfigHandler->mbPreloadMaps==false) return;
+
+	//No need to check every frame, the player is not moving that fast.
+	mfMapPreloadCount -= afTimeStep;
+	if(mfMapPreloadCount > 0) return;
+	mfMapPreloadCount = 0.5f;
+
+	iCharacterBody *pCharBody = gpBase->mpPlayer->GetCharacterBody();
+	if(pCharBody==NULL) return;
+
+	cVector3f vPlayerPos = pCharBody->GetPosition();
+	float fMaxDistSqr = gpBase->mpConfigHandler->mfPreloadMapDistance * gpBase->mpConfigHandler->mfPreloadMapDistance;
+
+	////////////////////////////
+	// Queue the maps behind any unlocked level door the player is close to
+	cLuxEntityIterator entIt = mpCurrentMap->GetEntityIterator(eLuxEntityType_Prop, eLuxPropType_LevelDoor);
+	while(entIt.HasNext())
+	{
+		iLuxEntity *pEntity = entIt.Next();
+		if(pEntity->IsActive()==false) continue;
+
+		cLuxProp_LevelDoor *pDoor = static_cast<cLuxProp_LevelDoor*>(pEntity);
+		if(pDoor->GetLocked() || pDoor->GetMapFile() == "") continue;
+		if(pDoor->GetMeshEntity()==NULL) continue;
+
+		//Once requested a map stays prepared until the next map change, no need to look at the door again
+		tString sMapFile = cString::SetFileExt(pDoor->GetMapFile(), "map");
+		if(m_setPreloadedMapFiles.find(sMapFile) != m_setPreloadedMapFiles.end()) continue;
+
+		float fDistSqr = cMath::Vector3DistSqr(pDoor->GetMeshEntity()->GetWorldPosition(), vPlayerPos);
+		if(fDistSqr > fMaxDistSqr) continue;
+
+		PreloadMap(sMapFile);
+	}
+}
+
+//-----------------------------------------------------------------------
+
+void cLuxMapHandler::PreloadMap(const tString& asMapFile)
+{
+	if(gpBase->mpConfigHandler->mbPreloadMaps==false) return;
+	if(mpCurrentMap && FileToMapName(asMapFile) == mpCurrentMap->GetName()) return;
+	if(m_setPreloadedMapFiles.insert(asMapFile).second==false) return;
+
+	tWString sPath = gpBase->mpEngine->GetResources()->GetFileSearcher()->GetFilePath(msMapFolder + asMapFile);
+	if(sPath == _W("")) return;
+
+	gpBase->mpEngine->GetResources()->GetMapPreloader()->Request(sPath);
+}
+
+//-----------------------------------------------------------------------
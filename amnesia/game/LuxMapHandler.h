@@ -126,6 +126,9 @@ private:
 
 	void CheckMapChange(float afTimeStep);
 
+	void UpdateMapPreload(float afTimeStep);
+	void PreloadMap(const tString& asMapFile);
+
 	cViewport::PostSolidDraw::Handler m_postDebugSolidDrawHandler;
 	cViewport::PostTranslucenceDraw::Handler m_postDebugTranslucentDrawHandler;
 	// cLuxDebugRenderCallback mRenderCallback;
@@ -147,6 +150,9 @@ private:
 
 	bool mbShowCommentary;
 
+	float mfMapPreloadCount;
+	tStringSet m_setPreloadedMapFiles;
+
 	iPostEffect *mpPostEffect_Bloom;
 	iPostEffect *mpPostEffect_ImageTrail;
 	iPostEffect *mpPostEffect_Sepia;
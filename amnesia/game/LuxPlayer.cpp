@@ -1145,21 +1145,11 @@ void cLuxPlayer::DrawHud(float afFrameTime)
 	/////////////////////////////////////////
 	// Focus text
 	float fFocusTextY = 450;
-	if(msFocusText != _W(""))
+	const tWString& sFocusText = msFocusText != _W("") ? msFocusText : msLastFocusText;
+	if(msFocusText != _W("") || mfFocusTextAlpha >0)
 	{
-		tWStringVec vRows;
-		mpFocusFont->GetWordWrapRows(500, 22, 22, msFocusText,&vRows);
-
-		for(size_t i=0; i<vRows.size(); ++i)
-			gpBase->mpGameHudSet->DrawFont(vRows[i],mpFocusFont,cVector3f(400, fFocusTextY+i*24,1),22,cColor(1,mfFocusTextAlpha),	eFontAlign_Center);
-	}
-	else if(mfFocusTextAlpha >0)
-	{
-		tWStringVec vRows;
-		mpFocusFont->GetWordWrapRows(500, 22, 22, msLastFocusText,&vRows);
-
-		for(size_t i=0; i<vRows.size(); ++i)
-			gpBase->mpGameHudSet->DrawFont(vRows[i],mpFocusFont,cVector3f(400, fFocusTextY+i*24,1),22,cColor(1,mfFocusTextAlpha),	eFontAlign_Center);
+		const cTextLayout *pLayout = mpFocusFont->GetWordWrapLayout(500, 22, sFocusText);
+		gpBase->mpGameHudSet->DrawTextLayout(pLayout, cVector3f(400, fFocusTextY,1), 24, cColor(1,mfFocusTextAlpha), eFontAlign_Center);
 	}
 }
 
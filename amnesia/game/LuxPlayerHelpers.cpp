@@ -1364,15 +1364,10 @@ void cLuxPlayerSanity::UpdateCheckEnemySeen(float afTimeStep)
 	// Iterate critters
 	float fMinCritterDistSqrt = 3.0f * 3.0f;
 	bool bNearCritter = false;
-	cLuxEntityIterator entIt = pMap->GetEntityIterator();
-	while(entIt.HasNext())
+	pMap->GetEntitiesInRadius(mvNearbyEntities, vPlayerHeadPos, 3.0f, eLuxEntityType_Prop, eLuxPropType_Critter);
+	for(size_t i=0; i<mvNearbyEntities.size(); ++i)
 	{
-		iLuxEntity *pEntity = entIt.Next();
-		if(pEntity->IsActive()==false)continue;
-		if(pEntity->GetEntityType() != eLuxEntityType_Prop) continue;
-
-		iLuxProp *pProp = static_cast<iLuxProp*>(pEntity);
-		if(pProp->GetPropType() != eLuxPropType_Critter) continue;
+		iLuxProp *pProp = static_cast<iLuxProp*>(mvNearbyEntities[i]);
 
 		iLuxProp_CritterBase *pCritter = static_cast<iLuxProp_CritterBase*>(pProp);
 
@@ -355,6 +355,8 @@ private:
 
 	float mfShowHintTimer;
 
+	tLuxEntityVec mvNearbyEntities;
+
 	//////////////
 	// Data
 	float mfHitZoomInSpeed;
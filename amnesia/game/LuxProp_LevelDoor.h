@@ -74,6 +74,8 @@ public:
 	void SetLocked(bool abLocked);
 	bool GetLocked(){ return mbLocked; }
 
+	const tString& GetMapFile(){ return msMapFile; }
+
 	void SetLockedSound(const tString& asSound){ msLockedSound = asSound;}
 	void SetLockedText(const tString& asCat, const tString& asEntry){ msLockedTextCat = asCat; msLockedTextEntry=asEntry;}
 
@@ -216,33 +216,7 @@ bool cLuxScriptHandler::GetEntities(const tString& asName,tLuxEntityList &alstEn
 	// Wild card
 	else
 	{
-		tStringVec vWantedStrings;
-		tString sSepp = "*";
-		cString::GetStringVec(asName,vWantedStrings,&sSepp);
-
-        cLuxEntityIterator it = pMap->GetEntityIterator();
-		while(it.HasNext())
-		{
-			iLuxEntity *pEntity = it.Next();
-			if(LuxIsCorrectType(pEntity,aType, alSubType))
-			{
-				bool bContainsStrings = true;
-				int lLastPos = -1;
-
-				//Iterate wanted strings and name make sure they exist and show up in correct order.
-				for(size_t i=0; i<vWantedStrings.size(); ++i)
-				{
-					int lPos = cString::GetFirstStringPos(pEntity->GetName(), vWantedStrings[i]);
-                    if(lPos <= lLastPos)
-					{
-						bContainsStrings = false;
-						break;
-					}
-				}
-
-				if(bContainsStrings) alstEntities.push_back(pEntity);
-			}
-		}
+		pMap->GetEntitiesMatchingName(asName, alstEntities, aType, alSubType);
 
 		if(alstEntities.empty())
 		{
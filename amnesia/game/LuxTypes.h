@@ -38,6 +38,10 @@ namespace hpl {
 //----------------------------------------------
 
 #define kTranslate(sCategory, sEntry) gpBase->mpEngine->GetResources()->Translate(sCategory, sEntry)
+#define kTranslateId(sCategory, sEntry) gpBase->mpEngine->GetResources()->GetTranslationId(sCategory, sEntry)
+#define kTranslateFromId(lId) gpBase->mpEngine->GetResources()->Translate((tLanguageEntryId)(lId))
+// For constant category and entry in code that runs every frame, the id is looked up once per call site.
+#define kTranslateConst(sCategory, sEntry) ([]()->const tWString& { static const tLanguageEntryId lId = kTranslateId(sCategory, sEntry); return kTranslateFromId(lId); }())
 
 #define kCopyToVar(aVar, aVal)	(aVar->aVal = aVal)
 #define kCopyFromVar(aVar, aVal)(aVal = aVar->aVal)
@@ -527,6 +531,9 @@ typedef tLuxEntityList::iterator tLuxEntityListIt;
 
 typedef cSTLIterator<iLuxEntity*, tLuxEntityList, tLuxEntityListIt> cLuxEntityIterator;
 
+typedef std::vector<iLuxEntity*> tLuxEntityVec;
+typedef tLuxEntityVec::iterator tLuxEntityVecIt;
+
 //----------------------------------------------
 
 class iLuxEnemy;
@@ -0,0 +1,230 @@
+/*
+ * Copyright © 2009-2020 Frictional Games
+ *
+ * This file is part of Amnesia: The Dark Descent.
+ *
+ * Amnesia: The Dark Descent is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * Amnesia: The Dark Descent is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Amnesia: The Dark Descent.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "hpl.h"
+#include "HplBenchmarks.h"
+#include "system/Timer.h"
+
+using namespace hpl;
+
+namespace animationlodcheck {
+
+//------------------------------------------
+
+// Plays, fades and stops animations on pairs of mesh entities with the same skeleton, one with animation LOD and
+// one without, and checks that the bone states fetched from the LOD entity after any update, also the ones where
+// its pose was skipped, are the same as the full entity's. The entities have no sub meshes, so they are never
+// rendered and use the hidden interval. Prints the update time with and without LOD, bones not fetched.
+// Runs without creating the engine.
+// Returns non zero if any bone differs.
+
+int glEntities = 100;
+int glSteps = 600;
+int glBones = 24;
+int glInterval = 4;
+int glSeed = 1;
+
+const float kfStepSize = 1.0f / 60.0f;
+const float kfEpsilon = 0.0001f;
+
+//------------------------------------------
+
+cAnimation* CreateAnimation(const tString& asName, cSkeleton *apSkeleton)
+{
+	cAnimation *pAnim = hplNew(cAnimation, (asName, _W(""), ""));
+	pAnim->SetLength(2.0f);
+
+	for(int i=0; i<apSkeleton->GetBoneNum(); ++i)
+	{
+		cAnimationTrack *pTrack = pAnim->CreateTrack(apSkeleton->GetBoneByIndex(i)->GetName(), eAnimTransformFlag_Translate | eAnimTransformFlag_Rotate);
+		for(int lKey=0; lKey<=8; ++lKey)
+		{
+			cKeyFrame *pKey = pTrack->CreateKeyFrame(lKey * 0.25f);
+			cVector3f vAxis = cMath::Vector3Normalize(cVector3f(cMath::RandRectf(-1, 1), cMath::RandRectf(-1, 1), cMath::RandRectf(0.1f, 1)));
+			pKey->rotation = cQuaternion(cMath::RandRectf(-1, 1), vAxis);
+			pKey->trans = cVector3f(cMath::RandRectf(-0.1f, 0.1f), cMath::RandRectf(-0.1f, 0.1f), cMath::RandRectf(-0.1f, 0.1f));
+		}
+	}
+
+	return pAnim;
+}
+
+cMesh* CreateMesh()
+{
+	cMesh *pMesh = hplNew(cMesh, ("AnimationLodCheck", _W(""), NULL, NULL));
+
+	//A chain, with a side bone at every fourth
+	cSkeleton *pSkeleton = hplNew(cSkeleton, ());
+	cBone *pParent = pSkeleton->GetRootBone();
+	for(int i=0; i<glBones; ++i)
+	{
+		cBone *pBone = pParent->CreateChildBone("Bone"+cString::ToString(i), "");
+		pBone->SetTransform(cMath::MatrixTranslate(cVector3f(0, 0.5f, 0)));
+		if(i % 4 != 3) pParent = pBone;
+	}
+	pMesh->SetSkeleton(pSkeleton);
+
+	pMesh->AddAnimation(CreateAnimation("Walk", pSkeleton));
+	pMesh->AddAnimation(CreateAnimation("Run", pSkeleton));
+
+	return pMesh;
+}
+
+//------------------------------------------
+
+// Does the same to both entities of a pair
+void ChangeAnimation(cMeshEntity *apFull, cMeshEntity *apLod, int alStep, int alEntity)
+{
+	int lAction = (alStep + alEntity*7) % 90;
+	if(lAction == 0)
+	{
+		apFull->Play(0, true, true);
+		apLod->Play(0, true, true);
+	}
+	else if(lAction == 30)
+	{
+		apFull->PlayFadeTo(1, true, 0.3f);
+		apLod->PlayFadeTo(1, true, 0.3f);
+	}
+	else if(lAction == 70)
+	{
+		apFull->Stop();
+		apLod->Stop();
+	}
+}
+
+float BoneDiff(cMeshEntity *apFull, cMeshEntity *apLod)
+{
+	float fMaxDiff = 0;
+	for(int i=0; i<apFull->GetBoneStateNum(); ++i)
+	{
+		const cMatrixf& mtxFull = apFull->GetBoneState(i)->GetWorldMatrix();
+		const cMatrixf& mtxLod = apLod->GetBoneState(i)->GetWorldMatrix();
+		for(int j=0; j<16; ++j) fMaxDiff = cMath::Max(fMaxDiff, cMath::Abs(mtxFull.v[j] - mtxLod.v[j]));
+	}
+	return fMaxDiff;
+}
+
+//------------------------------------------
+
+void ParseCommandLine(const tString &asCommandLine)
+{
+	tStringVec args;
+	tString sSepp = " ";
+	cString::GetStringVec(asCommandLine, args,&sSepp);
+
+	for(size_t i=0; i+1<args.size(); i+=2)
+	{
+		const tString &sArg = args[i];
+		int lValue = cMath::Max(cString::ToInt(args[i+1].c_str(), 1), 1);
+
+		if(sArg == "-entities")			glEntities = lValue;
+		else if(sArg == "-steps")		glSteps = lValue;
+		else if(sArg == "-bones")		glBones = lValue;
+		else if(sArg == "-interval")	glInterval = lValue;
+		else if(sArg == "-seed")		glSeed = lValue;
+	}
+}
+
+//------------------------------------------
+
+} // namespace animationlodcheck
+
+//------------------------------------------
+
+int RunAnimationLodCheck(const tString &asCommandLine)
+{
+	using namespace animationlodcheck;
+
+	ParseCommandLine(asCommandLine);
+
+	printf("-------- ANIMATION LOD CHECK STARTED! -----------\n\n");
+	printf(" Entities: %d Steps: %d Bones: %d Interval: %d Seed: %d\n\n", glEntities, glSteps, glBones, glInterval, glSeed);
+
+	cMath::Randomize(glSeed);
+	cMeshEntity::SetAnimationLodHiddenInterval(glInterval);
+
+	cMesh *pMesh = CreateMesh();
+
+	std::vector<cMeshEntity*> vFull;
+	std::vector<cMeshEntity*> vLod;
+	for(int i=0; i<glEntities; ++i)
+	{
+		//No mesh manager, the mesh is destroyed here
+		vFull.push_back(hplNew(cMeshEntity, ("Full"+cString::ToString(i), pMesh, NULL, NULL, NULL)));
+		vLod.push_back(hplNew(cMeshEntity, ("Lod"+cString::ToString(i), pMesh, NULL, NULL, NULL)));
+		vFull[i]->SetAnimationLodActive(false);
+		vLod[i]->SetAnimationLodActive(true);
+	}
+
+	//////////////////////////
+	// Compare, bones fetched after the update every few steps, so some poses are skipped without anyone asking.
+	float fMaxDiff = 0;
+	int lMismatches = 0;
+	for(int lStep=0; lStep<glSteps; ++lStep)
+	{
+		for(int i=0; i<glEntities; ++i)
+		{
+			ChangeAnimation(vFull[i], vLod[i], lStep, i);
+			vFull[i]->UpdateLogic(kfStepSize);
+			vLod[i]->UpdateLogic(kfStepSize);
+
+			if((lStep + i) % 3 != 0) continue;
+
+			float fDiff = BoneDiff(vFull[i], vLod[i]);
+			fMaxDiff = cMath::Max(fMaxDiff, fDiff);
+			if(fDiff > kfEpsilon)
+			{
+				if(lMismatches < 20) printf(" MISMATCH entity %d step %d diff %f\n", i, lStep, fDiff);
+				++lMismatches;
+			}
+		}
+	}
+
+	//////////////////////////
+	// Time, without fetching bones
+	iTimer *pTimer = cPlatform::CreateTimer();
+	double fTime[2] = {0, 0};
+	for(int lLod=0; lLod<2; ++lLod)
+	{
+		std::vector<cMeshEntity*>& vEntities = lLod ? vLod : vFull;
+		for(int i=0; i<glEntities; ++i) vEntities[i]->Play(0, true, true);
+
+		pTimer->Start();
+		for(int lStep=0; lStep<glSteps; ++lStep)
+		{
+			for(int i=0; i<glEntities; ++i) vEntities[i]->UpdateLogic(kfStepSize);
+		}
+		pTimer->Stop();
+		fTime[lLod] = pTimer->GetTimeInMilliSec();
+	}
+	hplDelete(pTimer);
+
+	printf(" Max diff: %f Mismatches: %d\n", fMaxDiff, lMismatches);
+	printf(" Update time per step, full: %.3f ms lod: %.3f ms\n", fTime[0] / glSteps, fTime[1] / glSteps);
+
+	STLDeleteAll(vFull);
+	STLDeleteAll(vLod);
+	hplDelete(pMesh);
+
+	bool bPassed = lMismatches==0;
+	printf("\n-------- ANIMATION LOD CHECK %s! -----------\n", bPassed ? "PASSED" : "FAILED");
+
+	return bPassed ? 0 : 1;
+}
@@ -0,0 +1,283 @@
+/*
+ * Copyright © 2009-2020 Frictional Games
+ *
+ * This file is part of Amnesia: The Dark Descent.
+ *
+ * Amnesia: The Dark Descent is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * Amnesia: The Dark Descent is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Amnesia: The Dark Descent.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "hpl.h"
+#include "HplBenchmarks.h"
+#include "graphics/DecalCreator.h"
+#include "graphics/TriangleBVH.h"
+#include "system/Timer.h"
+
+#include <random>
+#include <thread>
+
+using namespace hpl;
+
+namespace decalbench {
+
+//------------------------------------------
+
+// Clips decals against large generated static meshes, the way a splatter hits a combined level mesh.
+// Every decal is clipped testing all triangles on one thread (the old clipper), and then split over
+// all threads, with the triangle tree, and with both. The outputs must match exactly, the tool returns 1 if not.
+// Runs without creating the engine.
+
+int glGridSize = 512;
+int glBoxes = 20000;
+int glDecals = 200;
+int glMaxTriangles = 250;
+int glThreads = (int)std::max(1u, std::thread::hardware_concurrency());
+float gfDecalSize = 1.0f;
+
+//------------------------------------------
+
+class cBenchMesh
+{
+public:
+	tString msName;
+	std::vector<float> mvPositions;
+	std::vector<float> mvNormals;
+	std::vector<unsigned int> mvIndices;
+	cVector3f mvMin;
+	cVector3f mvMax;
+
+	void AddVertex(const cVector3f& avPos, const cVector3f& avNormal)
+	{
+		for(int i=0; i<3; ++i)
+		{
+			mvPositions.push_back(avPos.v[i]);
+			mvNormals.push_back(avNormal.v[i]);
+		}
+	}
+
+	//Two triangles facing cross(avDirV, avDirU)
+	void AddQuad(const cVector3f& avPos, const cVector3f& avDirU, const cVector3f& avDirV)
+	{
+		cVector3f vNormal = cMath::Vector3Normalize(cMath::Vector3Cross(avDirV, avDirU));
+		unsigned int lStart = (unsigned int)(mvPositions.size()/3);
+		AddVertex(avPos, vNormal);
+		AddVertex(avPos + avDirU, vNormal);
+		AddVertex(avPos + avDirV, vNormal);
+		AddVertex(avPos + avDirU + avDirV, vNormal);
+
+		unsigned int vIdx[6] = {0,1,2, 1,3,2};
+		for(int i=0; i<6; ++i) mvIndices.push_back(lStart + vIdx[i]);
+	}
+
+	int GetTriangleNum() const { return (int)mvIndices.size()/3; }
+};
+
+//------------------------------------------
+
+void ParseCommandLine(const tString &asCommandLine)
+{
+	tStringVec args;
+	tString sSepp = " ";
+	cString::GetStringVec(asCommandLine, args,&sSepp);
+
+	for(size_t i=0; i+1<args.size(); i+=2)
+	{
+		const tString &sArg = args[i];
+		int lValue = cMath::Max(cString::ToInt(args[i+1].c_str(), 1), 1);
+
+		if(sArg == "-grid")				glGridSize = lValue;
+		else if(sArg == "-boxes")		glBoxes = lValue;
+		else if(sArg == "-decals")		glDecals = lValue;
+		else if(sArg == "-maxtris")		glMaxTriangles = lValue;
+		else if(sArg == "-threads")		glThreads = lValue;
+		else if(sArg == "-size")		gfDecalSize = cString::ToFloat(args[i+1].c_str(), 1.0f);
+	}
+}
+
+//------------------------------------------
+
+// Bumpy terrain, one quad per unit
+void CreateGridMesh(cBenchMesh& aMesh)
+{
+	aMesh.msName = "Grid";
+	int lSize = glGridSize;
+	for(int z=0; z<lSize; ++z)
+	for(int x=0; x<lSize; ++x)
+	{
+		cVector3f vPos((float)x, sinf((float)x*0.3f) * cosf((float)z*0.2f) * 0.5f, (float)z);
+		aMesh.AddQuad(vPos, cVector3f(1,0,0), cVector3f(0,0,1));
+	}
+	aMesh.mvMin = cVector3f(0,0,0);
+	aMesh.mvMax = cVector3f((float)lSize, 0, (float)lSize);
+}
+
+//------------------------------------------
+
+// Boxes of many sizes scattered over a level, like props combined into one static mesh
+void CreateBoxesMesh(cBenchMesh& aMesh, std::mt19937& aRandom)
+{
+	aMesh.msName = "Boxes";
+	float fArea = sqrtf((float)glBoxes) * 4.0f;
+	std::uniform_real_distribution<float> randPos(0, fArea);
+	std::uniform_real_distribution<float> randSize(0.2f, 2.0f);
+
+	for(int i=0; i<glBoxes; ++i)
+	{
+		cVector3f vMin(randPos(aRandom), 0, randPos(aRandom));
+		cVector3f vSize(randSize(aRandom), randSize(aRandom), randSize(aRandom));
+		cVector3f vX(vSize.x,0,0), vY(0,vSize.y,0), vZ(0,0,vSize.z);
+
+		aMesh.AddQuad(vMin + vY, vX, vZ);		//+y
+		aMesh.AddQuad(vMin, vZ, vX);			//-y
+		aMesh.AddQuad(vMin + vX, vZ, vY);		//+x
+		aMesh.AddQuad(vMin, vY, vZ);			//-x
+		aMesh.AddQuad(vMin + vZ, vY, vX);		//+z
+		aMesh.AddQuad(vMin, vX, vY);			//-z
+	}
+	aMesh.mvMin = cVector3f(0,0,0);
+	aMesh.mvMax = cVector3f(fArea, 2.0f, fArea);
+}
+
+//------------------------------------------
+
+// Same planes as cDecalCreator::Compile, the meshes are in world space.
+void CreateDecalPlanes(const cVector3f& avPos, const cVector3f& avForward, cPlanef *apPlanes)
+{
+	cVector3f vUp(0,1,0);
+	cVector3f vFwd = cMath::Vector3Normalize(avForward);
+	cVector3f vRight = cMath::Vector3Normalize(cMath::Vector3Cross(vUp, vFwd));
+	vFwd = cMath::Vector3Cross(vRight, vUp);
+
+	cVector3f vAxes[] = { vRight, vUp, vFwd };
+	float vSign[] = { 1.0f, -1.0f };
+	cVector3f vHalfSize = cVector3f(gfDecalSize, gfDecalSize, gfDecalSize) * 0.5f;
+
+	for(int i=0;i<3;++i)
+	{
+		cVector3f vAdd = vAxes[i]*vHalfSize.v[i];
+		for(int j=0;j<2;++j)
+		{
+			apPlanes[i*2+j] = cPlanef(vAxes[i]*vSign[j], avPos - vAdd*vSign[j]);
+		}
+	}
+}
+
+//------------------------------------------
+
+bool IsSameOutput(const cDecalClipOutput& aA, const cDecalClipOutput& aB)
+{
+	return	aA.mvPolygonSizes == aB.mvPolygonSizes &&
+			aA.mvPositions == aB.mvPositions &&
+			aA.mvNormals == aB.mvNormals;
+}
+
+//------------------------------------------
+
+bool RunMesh(const cBenchMesh& aMesh, std::mt19937& aRandom)
+{
+	iTimer *pTimer = cPlatform::CreateTimer();
+
+	////////////////////////////
+	// Tree
+	pTimer->Start();
+	cTriangleBVH bvh;
+	bvh.Build(&aMesh.mvPositions[0], 3, &aMesh.mvIndices[0], (int)aMesh.mvIndices.size());
+	pTimer->Stop();
+	printf(" %s: %d triangles, tree with %d nodes built in %.3f ms\n", aMesh.msName.c_str(), aMesh.GetTriangleNum(),
+			bvh.GetNodeNum(), pTimer->GetTimeInMilliSec());
+
+	////////////////////////////
+	// Decals at random spots on top of the mesh
+	std::uniform_real_distribution<float> randX(aMesh.mvMin.x, aMesh.mvMax.x);
+	std::uniform_real_distribution<float> randZ(aMesh.mvMin.z, aMesh.mvMax.z);
+	std::uniform_real_distribution<float> randY(aMesh.mvMin.y, aMesh.mvMax.y);
+	std::uniform_real_distribution<float> randAngle(0, k2Pif);
+
+	std::vector<cPlanef> vPlanes(glDecals*6);
+	for(int i=0; i<glDecals; ++i)
+	{
+		float fAngle = randAngle(aRandom);
+		CreateDecalPlanes(cVector3f(randX(aRandom), randY(aRandom), randZ(aRandom)), cVector3f(cosf(fAngle), 0, sinf(fAngle)), &vPlanes[i*6]);
+	}
+
+	////////////////////////////
+	// Clip with each setup
+	const char* vModeNames[] = {"All triangles", "All threaded", "Tree", "Tree threaded"};
+	std::vector<cDecalClipOutput> vReference(glDecals);
+	cDecalClipOutput output;
+	bool bMatch = true;
+	int lMismatches = 0;
+	for(int mode=0; mode<4; ++mode)
+	{
+		const cTriangleBVH *pBVH = mode<2 ? NULL : &bvh;
+		int lThreads = (mode&1) ? glThreads : 1;
+		int lTotalTriangles = 0;
+		double fTime = 0;
+
+		for(int i=0; i<glDecals; ++i)
+		{
+			cDecalClipOutput &dest = mode==0 ? vReference[i] : output;
+
+			pTimer->Start();
+			cDecalCreator::ClipTriangles(	&aMesh.mvPositions[0], 3, &aMesh.mvNormals[0], 3, &aMesh.mvIndices[0], (int)aMesh.mvIndices.size(),
+											&vPlanes[i*6], pBVH, glMaxTriangles, lThreads, dest);
+			pTimer->Stop();
+			fTime += pTimer->GetTimeInMilliSec();
+			lTotalTriangles += dest.mlTriangleCount;
+
+			if(mode != 0 && IsSameOutput(vReference[i], output)==false)
+			{
+				++lMismatches;
+				bMatch = false;
+			}
+		}
+
+		printf("   %-14s %9.3f ms total, %8.4f ms per decal, %6.1f triangles per decal\n", vModeNames[mode],
+				fTime, fTime / (double)glDecals, (double)lTotalTriangles / (double)glDecals);
+	}
+
+	if(bMatch)	printf("   Output matches the full clipper\n\n");
+	else		printf("   ERROR: %d decals differ from the full clipper!\n\n", lMismatches);
+
+	hplDelete(pTimer);
+
+	return bMatch;
+}
+
+} // namespace decalbench
+
+//------------------------------------------
+
+int RunDecalBench(const tString &asCommandLine)
+{
+	using namespace decalbench;
+
+	ParseCommandLine(asCommandLine);
+
+	printf("-------- DECAL BENCHMARK STARTED! -----------\n\n");
+	printf(" Decals: %d Size: %.2f Max triangles: %d Threads: %d\n\n", glDecals, gfDecalSize, glMaxTriangles, glThreads);
+
+	std::mt19937 random(1234);
+
+	cBenchMesh gridMesh;
+	CreateGridMesh(gridMesh);
+	bool bMatch = RunMesh(gridMesh, random);
+
+	cBenchMesh boxesMesh;
+	CreateBoxesMesh(boxesMesh, random);
+	bMatch = RunMesh(boxesMesh, random) && bMatch;
+
+	printf("-------- DECAL BENCHMARK DONE! -----------\n");
+
+	return bMatch ? 0 : 1;
+}
@@ -0,0 +1,179 @@
+/*
+ * Copyright © 2009-2020 Frictional Games
+ *
+ * This file is part of Amnesia: The Dark Descent.
+ *
+ * Amnesia: The Dark Descent is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * Amnesia: The Dark Descent is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Amnesia: The Dark Descent.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "hpl.h"
+#include "HplBenchmarks.h"
+#include "system/Timer.h"
+
+using namespace hpl;
+
+namespace fontlayoutbench {
+
+cEngine *gpEngine=NULL;
+
+//------------------------------------------
+
+// Lays out every entry of a language file the way the game gui does, first with an empty layout
+// cache and then again for a number of frames with everything cached, and prints the timings.
+
+tWString gsLangFile = _W("");
+tString gsFontFile = "game_default.fnt";
+float gfFontSize = 20;
+float gfRowLength = 500;
+int glFrames = 100;
+
+//------------------------------------------
+
+void ParseCommandLine(const tString &asCommandLine)
+{
+	tStringVec args;
+	tString sSepp = " ";
+	cString::GetStringVec(asCommandLine, args,&sSepp);
+
+	for(size_t i=0; i<args.size(); ++i)
+	{
+		const tString &sArg = args[i];
+		bool bHasNext = i+1 < args.size();
+
+		if(sArg == "-font" && bHasNext)			gsFontFile = args[++i];
+		else if(sArg == "-size" && bHasNext)	gfFontSize = cString::ToFloat(args[++i].c_str(), gfFontSize);
+		else if(sArg == "-length" && bHasNext)	gfRowLength = cString::ToFloat(args[++i].c_str(), gfRowLength);
+		else if(sArg == "-frames" && bHasNext)	glFrames = cString::ToInt(args[++i].c_str(), glFrames);
+		else									gsLangFile = cString::To16Char(sArg);
+	}
+}
+
+//------------------------------------------
+
+void CollectTexts(cLanguageFile *apLangFile, tWStringVec &avTexts)
+{
+	tLanguageCategoryMap *pCategories = apLangFile->GetCategoryMap();
+	for(tLanguageCategoryMapIt catIt = pCategories->begin(); catIt != pCategories->end(); ++catIt)
+	{
+		tLanguageEntryMap &mapEntries = catIt->second->m_mapEntries;
+		for(tLanguageEntryMapIt entryIt = mapEntries.begin(); entryIt != mapEntries.end(); ++entryIt)
+		{
+			avTexts.push_back(entryIt->second->mwsText);
+		}
+	}
+}
+
+//------------------------------------------
+
+void RunBenchmark(iFontData *apFont, const tWStringVec &avTexts)
+{
+	iTimer *pTimer = cPlatform::CreateTimer();
+	cVector2f vSize = gfFontSize;
+	size_t lRows=0;
+
+	//Make room for every entry, so the warm frames measure hits only
+	apFont->SetLayoutCacheSize(avTexts.size());
+	apFont->ClearLayoutCache();
+
+	////////////////////////////
+	// Cold, every layout is created
+	pTimer->Start();
+	for(size_t i=0; i<avTexts.size(); ++i)
+	{
+		lRows += apFont->GetWordWrapLayout(gfRowLength, vSize, avTexts[i])->GetRowNum();
+	}
+	pTimer->Stop();
+	double fColdTime = pTimer->GetTimeInMilliSec();
+
+	////////////////////////////
+	// Warm, the same texts drawn every frame
+	pTimer->Start();
+	for(int frame=0; frame<glFrames; ++frame)
+	{
+		for(size_t i=0; i<avTexts.size(); ++i)
+		{
+			apFont->GetWordWrapLayout(gfRowLength, vSize, avTexts[i]);
+		}
+	}
+	pTimer->Stop();
+	double fWarmTime = pTimer->GetTimeInMilliSec() / (double)cMath::Max(glFrames,1);
+
+	////////////////////////////
+	// Warm through the old interface, that still creates the row strings
+	pTimer->Start();
+	for(int frame=0; frame<glFrames; ++frame)
+	{
+		for(size_t i=0; i<avTexts.size(); ++i)
+		{
+			tWStringVec vRows;
+			apFont->GetWordWrapRows(gfRowLength, vSize.y+2, vSize, avTexts[i], &vRows);
+		}
+	}
+	pTimer->Stop();
+	double fRowsTime = pTimer->GetTimeInMilliSec() / (double)cMath::Max(glFrames,1);
+
+	printf(" Entries: %d Rows: %d\n", (int)avTexts.size(), (int)lRows);
+	printf(" Cold layout:           %8.3f ms\n", fColdTime);
+	printf(" Cached layout / frame: %8.3f ms\n", fWarmTime);
+	printf(" Cached rows / frame:   %8.3f ms\n", fRowsTime);
+	printf(" Cache hits: %d misses: %d\n", (int)apFont->GetLayoutCacheHits(), (int)apFont->GetLayoutCacheMisses());
+
+	hplDelete(pTimer);
+}
+
+} // namespace fontlayoutbench
+
+//------------------------------------------
+
+int RunFontLayoutBench(const tString &asCommandLine)
+{
+	using namespace fontlayoutbench;
+
+	cEngineInitVars vars;
+	gpEngine = CreateHPLEngine(eHplAPI_OpenGL, 0, &vars);
+	gpEngine->GetResources()->LoadResourceDirsFile("resources.cfg");
+
+	ParseCommandLine(asCommandLine);
+
+	printf("-------- FONT LAYOUT BENCHMARK STARTED! -----------\n\n");
+
+	cLanguageFile *pLangFile = hplNew( cLanguageFile, (gpEngine->GetResources()) );
+	iFontData *pFont = gpEngine->GetResources()->GetFontManager()->CreateFontData(gsFontFile);
+
+	if(gsLangFile == _W("") || pLangFile->AddFromFile(gsLangFile, false)==false)
+	{
+		printf("No valid language file specified!\n");
+	}
+	else if(pFont == NULL)
+	{
+		printf("Could not load font '%s'!\n", gsFontFile.c_str());
+	}
+	else
+	{
+		tWStringVec vTexts;
+		CollectTexts(pLangFile, vTexts);
+
+		printf(" '%s' with '%s' size %.1f length %.1f, %d frames\n\n", cString::To8Char(gsLangFile).c_str(),
+				gsFontFile.c_str(), gfFontSize, gfRowLength, glFrames);
+		RunBenchmark(pFont, vTexts);
+	}
+
+	hplDelete(pLangFile);
+
+	printf("\n-------- FONT LAYOUT BENCHMARK DONE! -----------\n");
+
+	DestroyHPLEngine(gpEngine);
+
+	return 0;
+}
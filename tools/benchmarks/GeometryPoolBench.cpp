@@ -0,0 +1,308 @@
+/*
+ * Copyright © 2009-2020 Frictional Games
+ *
+ * This file is part of Amnesia: The Dark Descent.
+ *
+ * Amnesia: The Dark Descent is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * Amnesia: The Dark Descent is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Amnesia: The Dark Descent.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "hpl.h"
+#include "HplBenchmarks.h"
+#include "graphics/GeometryPool.h"
+#include "graphics/offsetAllocator.h"
+
+#include <random>
+
+using namespace hpl;
+
+namespace geometrypoolbench {
+
+//------------------------------------------
+
+// Plays a long session of maps being loaded and unloaded, with props and effects coming and going
+// while a map is running, against a GeometryPool backed by plain memory. Every allocation is filled
+// with its own pattern and checked after each map, so a bad move or a range handed out twice shows up.
+// The same session is run against a fixed size offset allocator, the way the pools worked before.
+// Returns 1 if any data was lost. Runs without creating the engine.
+
+int glMaps = 200;
+int glChunkSize = 1000000;
+int glMaxChunks = 8;
+int glMoveBudget = 20000;
+int glFramesPerMap = 300;
+int glRetireFrames = 2;
+
+//------------------------------------------
+
+class cMemoryBackingStore : public GeometryPool::BackingStore
+{
+public:
+	void addChunk(uint32_t alChunk, uint32_t alNumElements) override
+	{
+		if(alChunk >= mvChunks.size()) mvChunks.resize(alChunk+1);
+		mvChunks[alChunk].assign(alNumElements, 0xdeadbeef);
+	}
+
+	void removeChunk(uint32_t alChunk) override
+	{
+		mvChunks[alChunk].clear();
+		mvChunks[alChunk].shrink_to_fit();
+	}
+
+	void move(uint32_t alSrcChunk, uint32_t alSrcOffset, uint32_t alDstChunk, uint32_t alDstOffset, uint32_t alNumElements) override
+	{
+		memcpy(&mvChunks[alDstChunk][alDstOffset], &mvChunks[alSrcChunk][alSrcOffset], alNumElements * sizeof(uint32_t));
+		//Catch reads of the old place after the move
+		std::fill_n(&mvChunks[alSrcChunk][alSrcOffset], alNumElements, 0xdeadbeef);
+	}
+
+	uint32_t* GetData(uint32_t alChunk, uint32_t alOffset) { return &mvChunks[alChunk][alOffset]; }
+
+private:
+	std::vector<std::vector<uint32_t> > mvChunks;
+};
+
+//------------------------------------------
+
+class cLiveAllocation
+{
+public:
+	GeometryPool::Handle mHandle;
+	uint32_t mlTag;
+};
+
+//------------------------------------------
+
+void ParseCommandLine(const tString &asCommandLine)
+{
+	tStringVec args;
+	tString sSepp = " ";
+	cString::GetStringVec(asCommandLine, args,&sSepp);
+
+	for(size_t i=0; i+1<args.size(); i+=2)
+	{
+		const tString &sArg = args[i];
+		int lValue = cMath::Max(cString::ToInt(args[i+1].c_str(), 0), 0);
+
+		if(sArg == "-maps")				glMaps = cMath::Max(lValue, 1);
+		else if(sArg == "-chunk")		glChunkSize = cMath::Max(lValue, 1024);
+		else if(sArg == "-maxchunks")	glMaxChunks = cMath::Max(lValue, 1);
+		else if(sArg == "-budget")		glMoveBudget = lValue;
+		else if(sArg == "-frames")		glFramesPerMap = cMath::Max(lValue, 1);
+		else if(sArg == "-retire")		glRetireFrames = lValue;
+	}
+}
+
+//------------------------------------------
+
+// Meshes are mostly small with a few large ones, like static props against combined level geometry
+uint32_t GetRandomSize(std::mt19937& aRandom)
+{
+	std::uniform_int_distribution<int> randType(0, 99);
+	int lType = randType(aRandom);
+	if(lType < 70)	return std::uniform_int_distribution<uint32_t>(8, 2000)(aRandom);
+	if(lType < 97)	return std::uniform_int_distribution<uint32_t>(2000, 20000)(aRandom);
+	return std::uniform_int_distribution<uint32_t>(20000, (uint32_t)glChunkSize / 4)(aRandom);
+}
+
+//------------------------------------------
+
+void FillAllocation(GeometryPool& aPool, cMemoryBackingStore& aStore, const cLiveAllocation& aAlloc)
+{
+	uint32_t *pData = aStore.GetData(aPool.chunk(aAlloc.mHandle), aPool.offset(aAlloc.mHandle));
+	for(uint32_t i=0; i<aPool.size(aAlloc.mHandle); ++i) pData[i] = aAlloc.mlTag + i;
+}
+
+bool CheckAllocation(GeometryPool& aPool, cMemoryBackingStore& aStore, const cLiveAllocation& aAlloc)
+{
+	const uint32_t *pData = aStore.GetData(aPool.chunk(aAlloc.mHandle), aPool.offset(aAlloc.mHandle));
+	for(uint32_t i=0; i<aPool.size(aAlloc.mHandle); ++i)
+	{
+		if(pData[i] != aAlloc.mlTag + i) return false;
+	}
+	return true;
+}
+
+//------------------------------------------
+
+bool RunPool(uint32_t alMoveBudget)
+{
+	cMemoryBackingStore store;
+	GeometryPool::Config config;
+	config.m_chunkSize = (uint32_t)glChunkSize;
+	config.m_maxChunks = (uint32_t)glMaxChunks;
+	config.m_retireFrames = (uint32_t)glRetireFrames;
+	config.m_moveBudget = alMoveBudget;
+	GeometryPool pool(config, &store);
+
+	std::mt19937 random(1234);
+	std::vector<cLiveAllocation> vResident; //Shared between maps, like the player and hud
+	std::vector<cLiveAllocation> vMap;
+	uint32_t lNextTag = 1;
+	uint64_t lFrame = 0;
+	int lFailed = 0;
+	int lCorrupt = 0;
+	float fMaxFragmentation = 0;
+	uint64_t lMaxCapacity = 0;
+
+	iTimer *pTimer = cPlatform::CreateTimer();
+	pTimer->Start();
+
+	auto Allocate = [&](std::vector<cLiveAllocation>& avDest)
+	{
+		cLiveAllocation alloc;
+		alloc.mHandle = pool.allocate(GetRandomSize(random));
+		alloc.mlTag = lNextTag;
+		lNextTag += 0x10000;
+		if(alloc.mHandle == GeometryPool::InvalidHandle) { ++lFailed; return; }
+		FillAllocation(pool, store, alloc);
+		avDest.push_back(alloc);
+	};
+
+	for(int i=0; i<50; ++i) Allocate(vResident);
+
+	for(int lMap=0; lMap<glMaps; ++lMap)
+	{
+		////////////////////////////
+		// Load
+		int lMeshes = std::uniform_int_distribution<int>(200, 800)(random);
+		for(int i=0; i<lMeshes; ++i) Allocate(vMap);
+
+		////////////////////////////
+		// Play, things spawn and go away while the pool compacts in the background
+		for(int lFrameInMap=0; lFrameInMap<glFramesPerMap; ++lFrameInMap)
+		{
+			if(!vMap.empty() && random()%4 == 0)
+			{
+				size_t lIdx = random() % vMap.size();
+				pool.free(vMap[lIdx].mHandle);
+				vMap[lIdx] = vMap.back();
+				vMap.pop_back();
+			}
+			if(random()%4 == 0) Allocate(vMap);
+
+			pool.update(++lFrame);
+		}
+
+		////////////////////////////
+		// Check and unload all but a few that are carried over
+		for(size_t i=0; i<vResident.size(); ++i) if(!CheckAllocation(pool, store, vResident[i])) ++lCorrupt;
+		for(size_t i=0; i<vMap.size(); ++i) if(!CheckAllocation(pool, store, vMap[i])) ++lCorrupt;
+
+		GeometryPool::Stats stats = pool.stats();
+		fMaxFragmentation = std::max(fMaxFragmentation, stats.m_fragmentation);
+		lMaxCapacity = std::max(lMaxCapacity, stats.m_capacity);
+
+		std::shuffle(vMap.begin(), vMap.end(), random);
+		size_t lKeep = vMap.size() / 10;
+		for(size_t i=lKeep; i<vMap.size(); ++i) pool.free(vMap[i].mHandle);
+		vMap.resize(lKeep);
+
+		//The loading screen, lets the GPU finish with the unloaded map
+		for(int i=0; i<glRetireFrames; ++i) pool.update(++lFrame);
+	}
+
+	////////////////////////////
+	// Idle in the last map and let the compaction catch up
+	for(int i=0; i<glFramesPerMap; ++i) pool.update(++lFrame);
+	pTimer->Stop();
+
+	for(size_t i=0; i<vResident.size(); ++i) if(!CheckAllocation(pool, store, vResident[i])) ++lCorrupt;
+	for(size_t i=0; i<vMap.size(); ++i) if(!CheckAllocation(pool, store, vMap[i])) ++lCorrupt;
+
+	GeometryPool::Stats stats = pool.stats();
+	printf(" Move budget %d: %.1f ms, %d failed allocations, %d corrupt\n", alMoveBudget, pTimer->GetTimeInMilliSec(), lFailed, lCorrupt);
+	printf("   idle: %u chunks, capacity %llu, used %llu (%.1f%%), fragmentation %.2f\n", stats.m_numChunks,
+			(unsigned long long)stats.m_capacity, (unsigned long long)stats.m_used, stats.m_occupancy*100.0f, stats.m_fragmentation);
+	printf("   peak capacity %llu, worst fragmentation %.2f, %u grows, %u releases, %llu elements moved\n\n",
+			(unsigned long long)lMaxCapacity, fMaxFragmentation, stats.m_numGrows, stats.m_numReleases, (unsigned long long)stats.m_movedElements);
+
+	hplDelete(pTimer);
+	return lCorrupt == 0;
+}
+
+//------------------------------------------
+
+// The same session on one offset allocator the size of all chunks, with no way to grow or move
+void RunFixed()
+{
+	OffsetAllocator::Allocator allocator((uint32_t)glChunkSize * (uint32_t)glMaxChunks);
+	std::mt19937 random(1234);
+	std::vector<OffsetAllocator::Allocation> vResident;
+	std::vector<OffsetAllocator::Allocation> vMap;
+	int lFailed = 0;
+	float fMaxFragmentation = 0;
+
+	auto Allocate = [&](std::vector<OffsetAllocator::Allocation>& avDest)
+	{
+		OffsetAllocator::Allocation alloc = allocator.allocate(GetRandomSize(random));
+		if(alloc.offset == OffsetAllocator::Allocation::NO_SPACE) { ++lFailed; return; }
+		avDest.push_back(alloc);
+	};
+
+	for(int i=0; i<50; ++i) Allocate(vResident);
+	for(int lMap=0; lMap<glMaps; ++lMap)
+	{
+		int lMeshes = std::uniform_int_distribution<int>(200, 800)(random);
+		for(int i=0; i<lMeshes; ++i) Allocate(vMap);
+		for(int lFrameInMap=0; lFrameInMap<glFramesPerMap; ++lFrameInMap)
+		{
+			if(!vMap.empty() && random()%4 == 0)
+			{
+				size_t lIdx = random() % vMap.size();
+				allocator.free(vMap[lIdx]);
+				vMap[lIdx] = vMap.back();
+				vMap.pop_back();
+			}
+			if(random()%4 == 0) Allocate(vMap);
+		}
+
+		OffsetAllocator::StorageReport report = allocator.storageReport();
+		if(report.totalFreeSpace > 0)
+			fMaxFragmentation = std::max(fMaxFragmentation, 1.0f - (float)report.largestFreeRegion / (float)report.totalFreeSpace);
+
+		std::shuffle(vMap.begin(), vMap.end(), random);
+		size_t lKeep = vMap.size() / 10;
+		for(size_t i=lKeep; i<vMap.size(); ++i) allocator.free(vMap[i]);
+		vMap.resize(lKeep);
+	}
+
+	printf(" Fixed allocator of %u: %d failed allocations, worst fragmentation %.2f\n\n",
+			(uint32_t)glChunkSize * (uint32_t)glMaxChunks, lFailed, fMaxFragmentation);
+}
+
+} // namespace geometrypoolbench
+
+//------------------------------------------
+
+int RunGeometryPoolBench(const tString &asCommandLine)
+{
+	using namespace geometrypoolbench;
+
+	ParseCommandLine(asCommandLine);
+
+	printf("-------- GEOMETRY POOL BENCHMARK STARTED! -----------\n\n");
+	printf(" Maps: %d Frames per map: %d Chunk: %d Max chunks: %d Retire frames: %d\n\n", glMaps, glFramesPerMap, glChunkSize, glMaxChunks, glRetireFrames);
+
+	RunFixed();
+	bool bOk = RunPool(0);
+	bOk = RunPool((uint32_t)glMoveBudget) && bOk;
+
+	if(bOk)	printf(" All allocations kept their data\n\n");
+	else	printf(" ERROR: allocations lost their data!\n\n");
+
+	printf("-------- GEOMETRY POOL BENCHMARK DONE! -----------\n");
+
+	return bOk ? 0 : 1;
+}
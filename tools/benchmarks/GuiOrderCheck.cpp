@@ -0,0 +1,149 @@
+/*
+ * Copyright © 2009-2020 Frictional Games
+ *
+ * This file is part of Amnesia: The Dark Descent.
+ *
+ * Amnesia: The Dark Descent is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * Amnesia: The Dark Descent is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Amnesia: The Dark Descent.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "hpl.h"
+#include "HplBenchmarks.h"
+
+#include <algorithm>
+
+using namespace hpl;
+
+namespace guiordercheck {
+
+//------------------------------------------
+
+// Checks that gui render objects sorted on cGuiSet::GetRenderObjectKey come out in the order the render object
+// set drew them in before the keys, on lists that mix materials, textures and clip regions at a few z levels.
+// Clip regions used to be ordered by address and are now ordered by first use, so the check gives the old
+// comparator the clip id instead. Textures are ordered by the low bits of their address, which is the old address
+// order for textures in the same 256 KB, the fake textures here are. Runs without creating the engine.
+// Returns non zero if any list is drawn in another order.
+
+int glLists = 200;
+int glObjects = 2000;
+int glSeed = 1;
+
+const int klTextures = 16;
+const int klClipRegions = 4;
+
+//------------------------------------------
+
+class cCheckObject
+{
+public:
+	float mfZ;
+	int mlClipId;
+	eGuiMaterial mMaterial;
+	const Image *mpTexture;
+};
+
+// The comparison the render object set used, clip region pointers replaced by the id
+bool OldCompare(const cCheckObject& aObjectA, const cCheckObject& aObjectB)
+{
+	if(aObjectA.mfZ != aObjectB.mfZ) return aObjectA.mfZ < aObjectB.mfZ;
+	if(aObjectA.mlClipId != aObjectB.mlClipId) return aObjectA.mlClipId < aObjectB.mlClipId;
+	if(aObjectA.mMaterial != aObjectB.mMaterial) return aObjectA.mMaterial > aObjectB.mMaterial;
+	if(aObjectA.mpTexture != aObjectB.mpTexture) return aObjectA.mpTexture > aObjectB.mpTexture;
+	return false;
+}
+
+//------------------------------------------
+
+void ParseCommandLine(const tString &asCommandLine)
+{
+	tStringVec args;
+	tString sSepp = " ";
+	cString::GetStringVec(asCommandLine, args,&sSepp);
+
+	for(size_t i=0; i+1<args.size(); i+=2)
+	{
+		const tString &sArg = args[i];
+		int lValue = cMath::Max(cString::ToInt(args[i+1].c_str(), 1), 1);
+
+		if(sArg == "-lists")		glLists = lValue;
+		else if(sArg == "-objects")	glObjects = lValue;
+		else if(sArg == "-seed")	glSeed = lValue;
+	}
+}
+
+//------------------------------------------
+
+} // namespace guiordercheck
+
+//------------------------------------------
+
+int RunGuiOrderCheck(const tString &asCommandLine)
+{
+	using namespace guiordercheck;
+
+	ParseCommandLine(asCommandLine);
+
+	printf("-------- GUI ORDER CHECK STARTED! -----------\n\n");
+	printf(" Lists: %d Objects: %d Seed: %d\n\n", glLists, glObjects, glSeed);
+
+	cMath::Randomize(glSeed);
+
+	//Never dereferenced, only compared
+	std::vector<const Image*> vTextures;
+	for(int i=0; i<klTextures; ++i) vTextures.push_back(reinterpret_cast<const Image*>((uintptr_t)0x10000000 + (uintptr_t)(i+1)*256));
+	vTextures.push_back(NULL);
+
+	std::vector<cCheckObject> vObjects;
+	std::vector<uint64_t> vKeys;
+	std::vector<uint32_t> vSorted;
+	std::vector<uint32_t> vTemp;
+	std::vector<uint32_t> vExpected;
+	int lMismatches = 0;
+
+	for(int lList=0; lList<glLists; ++lList)
+	{
+		vObjects.clear();
+		vKeys.clear();
+		for(int i=0; i<glObjects; ++i)
+		{
+			cCheckObject object;
+			object.mfZ = (float)cMath::RandRectl(0, 3) * (lList % 2 ? -1.0f : 1.0f);
+			object.mlClipId = cMath::RandRectl(0, klClipRegions-1);
+			object.mMaterial = (eGuiMaterial)cMath::RandRectl(0, eGuiMaterial_LastEnum-1);
+			object.mpTexture = vTextures[cMath::RandRectl(0, (int)vTextures.size()-1)];
+			vObjects.push_back(object);
+			vKeys.push_back(cGuiSet::GetRenderObjectKey(object.mfZ, object.mlClipId, object.mMaterial, object.mpTexture));
+		}
+
+		cGuiSet::SortRenderObjectKeys(vKeys, vSorted, vTemp);
+
+		//The set kept equal objects in the order they were added
+		vExpected.resize(vObjects.size());
+		for(size_t i=0; i<vExpected.size(); ++i) vExpected[i] = (uint32_t)i;
+		std::stable_sort(vExpected.begin(), vExpected.end(), [&](uint32_t alA, uint32_t alB){ return OldCompare(vObjects[alA], vObjects[alB]); });
+
+		if(vSorted != vExpected)
+		{
+			if(lMismatches < 20) printf(" MISMATCH in list %d\n", lList);
+			++lMismatches;
+		}
+	}
+
+	printf(" Mismatches: %d\n", lMismatches);
+
+	bool bPassed = lMismatches==0;
+	printf("\n-------- GUI ORDER CHECK %s! -----------\n", bPassed ? "PASSED" : "FAILED");
+
+	return bPassed ? 0 : 1;
+}
@@ -0,0 +1,675 @@
+/*
+ * Copyright © 2009-2020 Frictional Games
+ *
+ * This file is part of Amnesia: The Dark Descent.
+ *
+ * Amnesia: The Dark Descent is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * Amnesia: The Dark Descent is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Amnesia: The Dark Descent.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "hpl.h"
+#include "HplBenchmarks.h"
+#include "impl/LowLevelPhysicsNewton.h"
+#include "impl/LowLevelSystemSDL.h"
+#include "scene/RenderableContainer_BoxTree.h"
+#include "scene/RenderableContainer_DynBoxTree.h"
+#include "graphics/RenderList.h"
+#include "graphics/Renderer.h"
+#include "ai/AINodeContainer.h"
+#include "ai/AStar.h"
+#include "system/Timer.h"
+#include "impl/XmlDocumentTiny.h"
+#include "physics/PhysicsJointHinge.h"
+
+#include <algorithm>
+#include <random>
+
+using namespace hpl;
+
+//------------------------------------------
+
+// Runs the cpu side of a frame on a generated scene without creating the engine, so it needs no gpu,
+// window or sound device: a camera flies a fixed path through static and moving objects that are culled
+// into a render list, boxes fall and collide, agents look for paths over a node grid and a script is
+// ticked. Each part is timed every frame and the result is written as json, to stdout or the -out file,
+// so runs can be compared between builds. The scene only depends on the seed, so runs are repeatable.
+// After the frames a test .ent is placed -entities times, once compiling the file for every copy the
+// way each placement used to read the xml, and once creating the physics of every copy from one prototype.
+// Given the name of a check or subsystem benchmark as first argument, that one is run instead, see gvChecks.
+
+int glFrames = 600;
+int glStatic = 4000;
+int glDynamic = 800;
+int glBodies = 400;
+int glNodeGrid = 48;
+int glPathsPerFrame = 8;
+int glScriptCalls = 20;
+int glSeed = 1;
+int glEntityCopies = 300;
+tString gsOutFile = "";
+
+const float gfSceneSize = 200.0f;
+const float gfStepSize = 1.0f / 60.0f;
+
+//------------------------------------------
+
+class cBenchRenderable : public iRenderable
+{
+public:
+	cBenchRenderable(const tString& asName, cMaterial *apMaterial, const cVector3f& avSize) : iRenderable(asName), mpMaterial(apMaterial)
+	{
+		mbApplyTransformToBV = true;
+		mBoundingVolume.SetSize(avSize);
+	}
+
+	tString GetEntityType(){ return "BenchRenderable";}
+
+	cMaterial *GetMaterial() override { return mpMaterial;}
+	iVertexBuffer* GetVertexBuffer() override { return NULL;}
+	DrawPacket ResolveDrawPacket(const ForgeRenderer::Frame& frame) override
+	{
+		DrawPacket drawPacket;
+		drawPacket.m_type = DrawPacket::Unknown;
+		return drawPacket;
+	}
+	eRenderableType GetRenderType() override { return eRenderableType_Dummy;}
+	int GetMatrixUpdateCount() override { return GetTransformUpdateCount();}
+	cMatrixf* GetModelMatrix(cFrustum* apFrustum) override
+	{
+		m_mtxModel = GetWorldMatrix();
+		return &m_mtxModel;
+	}
+
+	cVector3f mvStartPos;
+	float mfPhase;
+
+private:
+	cMaterial *mpMaterial;
+	cMatrixf m_mtxModel;
+};
+
+//------------------------------------------
+
+class cSubsystemTiming
+{
+public:
+	cSubsystemTiming(const tString& asName) : msName(asName){}
+
+	tString msName;
+	std::vector<double> mvFrameMs;
+};
+
+enum eBenchSubsystem
+{
+	eBenchSubsystem_Entities,
+	eBenchSubsystem_Physics,
+	eBenchSubsystem_AI,
+	eBenchSubsystem_Scripts,
+	eBenchSubsystem_Culling,
+	eBenchSubsystem_RenderList,
+	eBenchSubsystem_EntityCompile,
+	eBenchSubsystem_EntityInstance,
+	eBenchSubsystem_LastEnum
+};
+
+//------------------------------------------
+
+void ParseCommandLine(const tString &asCommandLine)
+{
+	tStringVec args;
+	tString sSepp = " ";
+	cString::GetStringVec(asCommandLine, args,&sSepp);
+
+	for(size_t i=0; i+1<args.size(); i+=2)
+	{
+		const tString &sArg = args[i];
+		int lValue = cMath::Max(cString::ToInt(args[i+1].c_str(), 0), 0);
+
+		if(sArg == "-frames")		glFrames = cMath::Max(lValue, 1);
+		else if(sArg == "-static")	glStatic = lValue;
+		else if(sArg == "-dynamic")	glDynamic = lValue;
+		else if(sArg == "-bodies")	glBodies = lValue;
+		else if(sArg == "-nodes")	glNodeGrid = cMath::Max(lValue, 2);
+		else if(sArg == "-paths")	glPathsPerFrame = lValue;
+		else if(sArg == "-script")	glScriptCalls = lValue;
+		else if(sArg == "-seed")	glSeed = lValue;
+		else if(sArg == "-entities")	glEntityCopies = lValue;
+		else if(sArg == "-out")		gsOutFile = args[i+1];
+	}
+}
+
+//------------------------------------------
+
+static const char *gsBenchScript =
+	"float gfValue = 0;\n"
+	"int glTicks = 0;\n"
+	"void Tick()\n"
+	"{\n"
+	"	for(int i=0; i<64; ++i)\n"
+	"	{\n"
+	"		gfValue = gfValue*0.5f + float(i % 7) * 0.25f;\n"
+	"		if(gfValue > 100.0f) gfValue = 0;\n"
+	"	}\n"
+	"	glTicks++;\n"
+	"}\n";
+
+iScript* CreateBenchScript(iLowLevelSystem *apLowLevelSystem)
+{
+	tWString sFile = _W("hpl2_benchmarks_tmp.hps");
+	FILE *pFile = cPlatform::OpenFile(sFile, _W("wb"));
+	if(pFile==NULL) return NULL;
+	fputs(gsBenchScript, pFile);
+	fclose(pFile);
+
+	iScript *pScript = apLowLevelSystem->CreateScript("bench");
+	tString sMessages;
+	bool bOk = pScript->CreateFromFile(sFile, &sMessages);
+	cPlatform::RemoveFile(sFile);
+	if(bOk==false)
+	{
+		printf(" Could not compile bench script: %s\n", sMessages.c_str());
+		hplDelete(pScript);
+		return NULL;
+	}
+	return pScript;
+}
+
+//------------------------------------------
+
+// Fixed camera path, a loop around the scene that looks along the direction it moves and sways a little
+void UpdateCamera(cCamera *apCamera, int alFrame)
+{
+	float fT = (float)alFrame / (float)glFrames * k2Pif;
+	float fRadius = gfSceneSize * 0.35f;
+	cVector3f vPos(cos(fT)*fRadius, 2.0f + sin(fT*3.0f), sin(fT)*fRadius);
+
+	apCamera->SetPosition(vPos);
+	apCamera->SetYaw(-fT + sin(fT*5.0f)*0.3f);
+	apCamera->SetPitch(sin(fT*2.0f)*0.2f);
+}
+
+//------------------------------------------
+
+void WriteResults(FILE *apFile, std::vector<cSubsystemTiming>& avTimings, double afAvgVisible, double afAvgPathNodes)
+{
+	fprintf(apFile, "{\n");
+	fprintf(apFile, "  \"benchmark\": \"hpl2_benchmarks\",\n");
+	fprintf(apFile, "  \"frames\": %d,\n", glFrames);
+	fprintf(apFile, "  \"seed\": %d,\n", glSeed);
+	fprintf(apFile, "  \"scene\": { \"static\": %d, \"dynamic\": %d, \"bodies\": %d, \"nodes\": %d, \"paths_per_frame\": %d, \"script_calls\": %d, \"entity_copies\": %d },\n",
+			glStatic, glDynamic, glBodies, glNodeGrid*glNodeGrid, glPathsPerFrame, glScriptCalls, glEntityCopies);
+	fprintf(apFile, "  \"counters\": { \"visible_objects_avg\": %.1f, \"path_nodes_avg\": %.1f },\n", afAvgVisible, afAvgPathNodes);
+	fprintf(apFile, "  \"subsystems\": [\n");
+
+	for(size_t i=0; i<avTimings.size(); ++i)
+	{
+		std::vector<double> vSorted = avTimings[i].mvFrameMs;
+		std::sort(vSorted.begin(), vSorted.end());
+
+		double fTotal =0;
+		for(size_t j=0; j<vSorted.size(); ++j) fTotal += vSorted[j];
+
+		size_t lCount = vSorted.size();
+		double fMean = lCount ? fTotal / (double)lCount : 0;
+		double fP50 = lCount ? vSorted[lCount/2] : 0;
+		double fP95 = lCount ? vSorted[cMath::Min((size_t)((double)lCount*0.95), lCount-1)] : 0;
+		double fMax = lCount ? vSorted[lCount-1] : 0;
+
+		fprintf(apFile, "    { \"name\": \"%s\", \"total_ms\": %.3f, \"mean_ms\": %.4f, \"p50_ms\": %.4f, \"p95_ms\": %.4f, \"max_ms\": %.4f }%s\n",
+				avTimings[i].msName.c_str(), fTotal, fMean, fP50, fP95, fMax, i+1<avTimings.size() ? "," : "");
+	}
+
+	fprintf(apFile, "  ]\n");
+	fprintf(apFile, "}\n");
+}
+
+//------------------------------------------
+
+// A chair: two sub meshes, four shapes on a seat and a back that are joined by a hinge, and a few variables
+static const char *gsBenchEntity =
+	"<Entity>\n"
+	"  <ModelData>\n"
+	"    <Mesh Filename=\"chair.dae\">\n"
+	"      <SubMesh ID=\"1\" Name=\"seat\" WorldPos=\"0 0.45 0\" Rotation=\"0 0 0\" Scale=\"1 1 1\" />\n"
+	"      <SubMesh ID=\"2\" Name=\"back\" WorldPos=\"0 0.9 -0.22\" Rotation=\"0.1 0 0\" Scale=\"1 1 1\" />\n"
+	"    </Mesh>\n"
+	"    <Shapes>\n"
+	"      <Shape ID=\"10\" ShapeType=\"Box\" Scale=\"0.5 0.05 0.5\" RelativeTranslation=\"0 0 0\" RelativeRotation=\"0 0 0\" />\n"
+	"      <Shape ID=\"11\" ShapeType=\"Cylinder\" Scale=\"0.03 0.45 0.03\" RelativeTranslation=\"0.22 -0.22 0.22\" RelativeRotation=\"0 0 0\" />\n"
+	"      <Shape ID=\"12\" ShapeType=\"Cylinder\" Scale=\"0.03 0.45 0.03\" RelativeTranslation=\"-0.22 -0.22 0.22\" RelativeRotation=\"0 0 0\" />\n"
+	"      <Shape ID=\"13\" ShapeType=\"Box\" Scale=\"0.5 0.45 0.04\" RelativeTranslation=\"0 0 0\" RelativeRotation=\"0 0 0\" />\n"
+	"    </Shapes>\n"
+	"    <Bodies>\n"
+	"      <Body ID=\"20\" Name=\"seat\" Material=\"wood\" Mass=\"4\" WorldPos=\"0 0.45 0\" Rotation=\"0 0 0\" LinearDamping=\"0.1\" AngularDamping=\"0.1\">\n"
+	"        <Shape ID=\"10\" /><Shape ID=\"11\" /><Shape ID=\"12\" />\n"
+	"        <Children><Child ID=\"1\" /></Children>\n"
+	"      </Body>\n"
+	"      <Body ID=\"21\" Name=\"back\" Material=\"wood\" Mass=\"2\" WorldPos=\"0 0.9 -0.22\" Rotation=\"0.1 0 0\" BlocksSound=\"true\">\n"
+	"        <Shape ID=\"13\" />\n"
+	"        <Children><Child ID=\"2\" /></Children>\n"
+	"      </Body>\n"
+	"    </Bodies>\n"
+	"    <Joints>\n"
+	"      <JointHinge ID=\"30\" Name=\"back_hinge\" WorldPos=\"0 0.5 -0.22\" PinDir=\"1 0 0\" ConnectedParentBodyID=\"20\" ConnectedChildBodyID=\"21\"\n"
+	"                  MinAngle=\"-10\" MaxAngle=\"10\" MoveSound=\"creak\" Breakable=\"true\" BreakForce=\"500\" />\n"
+	"    </Joints>\n"
+	"  </ModelData>\n"
+	"  <UserDefinedVariables EntityType=\"Object\" EntitySubType=\"Grab\">\n"
+	"    <Var Name=\"Health\" Value=\"50\" />\n"
+	"    <Var Name=\"Toughness\" Value=\"2\" />\n"
+	"    <Var Name=\"CollideOnlyWithPlayer\" Value=\"false\" />\n"
+	"  </UserDefinedVariables>\n"
+	"</Entity>\n";
+
+// Creates the physics of one copy from the prototype the way cEntityLoader_Object does
+static void CreateEntityPhysics(const cEntityPrototype *apPrototype, iPhysicsWorld *apPhysicsWorld, const cMatrixf& a_mtxTransform, int alCopy)
+{
+	std::map<int, iCollideShape*> mapShapes;
+	for(size_t i=0; i<apPrototype->mvShapes.size(); ++i)
+	{
+		const cEntityPrototypeShape& shape = apPrototype->mvShapes[i];
+		mapShapes[shape.mlID] = shape.Create(apPhysicsWorld, 1);
+	}
+
+	tString sName = "chair"+cString::ToString(alCopy);
+	std::map<int, iPhysicsBody*> mapBodies;
+	for(size_t i=0; i<apPrototype->mvBodies.size(); ++i)
+	{
+		const cEntityPrototypeBody& body = apPrototype->mvBodies[i];
+
+		tCollideShapeVec vShapes;
+		for(size_t j=0; j<body.mvShapeIDs.size(); ++j)
+		{
+			std::map<int, iCollideShape*>::iterator it = mapShapes.find(body.mvShapeIDs[j]);
+			if(it != mapShapes.end()) vShapes.push_back(it->second);
+		}
+		if(vShapes.empty()) continue;
+
+		iCollideShape *pShape = vShapes.size()==1 ? vShapes[0] : apPhysicsWorld->CreateCompundShape(vShapes);
+		iPhysicsBody *pBody = apPhysicsWorld->CreateBody(sName+"_"+body.msName, pShape);
+		body.SetProperties(pBody, 1);
+		pBody->SetMatrix(cMath::MatrixMul(a_mtxTransform, pBody->GetLocalMatrix()));
+		mapBodies[body.mlID] = pBody;
+	}
+
+	for(size_t i=0; i<apPrototype->mvJoints.size(); ++i)
+	{
+		const cEntityPrototypeJoint& joint = apPrototype->mvJoints[i];
+		if(joint.mType != ePhysicsJointType_Hinge || mapBodies.count(joint.mlChildID)==0) continue;
+
+		iPhysicsBody *pParent = mapBodies.count(joint.mlParentID) ? mapBodies[joint.mlParentID] : NULL;
+		iPhysicsJointHinge *pJoint = apPhysicsWorld->CreateJointHinge(sName+"_"+joint.msName,
+																	cMath::MatrixMul(a_mtxTransform, joint.mvWorldPos),
+																	cMath::MatrixMul3x3(a_mtxTransform, joint.mvPinDir),
+																	pParent, mapBodies[joint.mlChildID]);
+		pJoint->SetMinAngle(joint.mfMinLimit);
+		pJoint->SetMaxAngle(joint.mfMaxLimit);
+		joint.SetProperties(pJoint);
+	}
+}
+
+void RunEntityBenchmark(cLowLevelPhysicsNewton *apLowLevelPhysics, iTimer *apTimer, std::mt19937& aRng, std::vector<cSubsystemTiming>& avTimings)
+{
+	std::uniform_real_distribution<float> randPos(-gfSceneSize*0.5f, gfSceneSize*0.5f);
+
+	cXmlDocumentTiny entityDoc("chair.ent");
+	if(entityDoc.CreateFromString(gsBenchEntity)==false)
+	{
+		printf(" Could not parse bench entity\n");
+		return;
+	}
+
+	cEntityPrototype::ResetLoadStats();
+
+	//Compiling the file once per copy, what every placement cost before prototypes
+	for(int i=0; i<glEntityCopies; ++i)
+	{
+		apTimer->Start();
+		cEntityPrototype prototype;
+		prototype.Compile(&entityDoc, _W("bench/chair.ent"));
+		apTimer->Stop();
+		avTimings[eBenchSubsystem_EntityCompile].mvFrameMs.push_back(apTimer->GetTimeInMilliSec());
+	}
+
+	//Creating every copy from one prototype
+	iPhysicsWorld *pPhysicsWorld = apLowLevelPhysics->CreateWorld();
+	pPhysicsWorld->SetWorldSize(cVector3f(-gfSceneSize, -50, -gfSceneSize), cVector3f(gfSceneSize, 200, gfSceneSize));
+
+	cEntityPrototype prototype;
+	prototype.Compile(&entityDoc, _W("bench/chair.ent"));
+	for(int i=0; i<glEntityCopies; ++i)
+	{
+		cMatrixf mtxTransform = cMath::MatrixRotateY(randPos(aRng));
+		mtxTransform.SetTranslation(cVector3f(randPos(aRng), 0, randPos(aRng)));
+
+		apTimer->Start();
+		CreateEntityPhysics(&prototype, pPhysicsWorld, mtxTransform, i);
+		apTimer->Stop();
+		avTimings[eBenchSubsystem_EntityInstance].mvFrameMs.push_back(apTimer->GetTimeInMilliSec());
+	}
+
+	hplDelete(pPhysicsWorld);
+}
+
+//------------------------------------------
+
+int RunBenchmark()
+{
+	std::mt19937 rng(glSeed);
+	std::uniform_real_distribution<float> randPos(-gfSceneSize*0.5f, gfSceneSize*0.5f);
+	std::uniform_real_distribution<float> randUnit(0.0f, 1.0f);
+
+	//////////////////////////
+	// Materials
+	ShaderMaterialData solidDesc;
+	solidDesc.m_id = MaterialID::SolidDiffuse;
+	cMaterial *pSolidMat = hplNew( cMaterial, ("bench_solid", _W(""), NULL) );
+	pSolidMat->SetDescriptor(solidDesc);
+
+	ShaderMaterialData transDesc;
+	transDesc.m_id = MaterialID::Translucent;
+	transDesc.m_translucent.m_blend = eMaterialBlendMode_Add;
+	cMaterial *pTransMat = hplNew( cMaterial, ("bench_translucent", _W(""), NULL) );
+	pTransMat->SetDescriptor(transDesc);
+
+	//////////////////////////
+	// Renderables, static ones in a box tree and moving ones in a dynamic one, the way cWorld keeps them
+	cRenderableContainer_BoxTree staticContainer;
+	cRenderableContainer_DynBoxTree dynamicContainer;
+	std::vector<cBenchRenderable*> vStatic;
+	std::vector<cBenchRenderable*> vDynamic;
+
+	for(int i=0; i<glStatic; ++i)
+	{
+		cVector3f vSize(0.5f + randUnit(rng)*4.0f, 0.5f + randUnit(rng)*3.0f, 0.5f + randUnit(rng)*4.0f);
+		cBenchRenderable *pObject = hplNew( cBenchRenderable, ("static"+cString::ToString(i), pSolidMat, vSize) );
+		pObject->SetPosition(cVector3f(randPos(rng), vSize.y*0.5f, randPos(rng)));
+		pObject->SetStatic(true);
+		staticContainer.Add(pObject);
+		vStatic.push_back(pObject);
+	}
+	staticContainer.Compile();
+
+	for(int i=0; i<glDynamic; ++i)
+	{
+		cMaterial *pMat = (i % 5)==0 ? pTransMat : pSolidMat;
+		cBenchRenderable *pObject = hplNew( cBenchRenderable, ("dynamic"+cString::ToString(i), pMat, cVector3f(0.5f + randUnit(rng))) );
+		pObject->mvStartPos = cVector3f(randPos(rng), 1.0f + randUnit(rng)*3.0f, randPos(rng));
+		pObject->mfPhase = randUnit(rng) * k2Pif;
+		pObject->SetPosition(pObject->mvStartPos);
+		dynamicContainer.Add(pObject);
+		vDynamic.push_back(pObject);
+	}
+	dynamicContainer.Compile();
+
+	cCamera camera;
+	camera.SetAspect(16.0f / 9.0f);
+	camera.SetFOV(cMath::ToRad(70.0f));
+	camera.SetFarClipPlane(100.0f);
+	camera.SetNearClipPlane(0.05f);
+
+	cRenderList renderList;
+
+	//////////////////////////
+	// Physics, a floor with boxes dropped on it in a few stacks
+	cLowLevelPhysicsNewton lowLevelPhysics;
+	iPhysicsWorld *pPhysicsWorld = lowLevelPhysics.CreateWorld();
+	pPhysicsWorld->SetWorldSize(cVector3f(-gfSceneSize, -50, -gfSceneSize), cVector3f(gfSceneSize, 200, gfSceneSize));
+	pPhysicsWorld->SetAccuracyLevel(ePhysicsAccuracy_Medium);
+
+	iCollideShape *pFloorShape = pPhysicsWorld->CreateBoxShape(cVector3f(gfSceneSize, 1, gfSceneSize), NULL);
+	iPhysicsBody *pFloor = pPhysicsWorld->CreateBody("floor", pFloorShape);
+	pFloor->SetMass(0);
+	pFloor->SetMatrix(cMath::MatrixTranslate(cVector3f(0,-0.5f,0)));
+
+	iCollideShape *pBoxShape = pPhysicsWorld->CreateBoxShape(cVector3f(0.5f), NULL);
+	for(int i=0; i<glBodies; ++i)
+	{
+		int lStack = i % 20;
+		int lLevel = i / 20;
+		iPhysicsBody *pBody = pPhysicsWorld->CreateBody("box"+cString::ToString(i), pBoxShape);
+		pBody->SetMass(1.0f);
+		pBody->SetMatrix(cMath::MatrixTranslate(cVector3f((float)(lStack%5)*3.0f + randUnit(rng)*0.1f, 0.3f + (float)lLevel*0.55f, (float)(lStack/5)*3.0f)));
+	}
+
+	//////////////////////////
+	// AI, a grid of nodes with a few holes, no world so all edges within range are free
+	cAINodeContainer nodeContainer("bench", "node", NULL, cVector3f(0.6f, 1.6f, 0.6f));
+	nodeContainer.SetMaxHeight(0.5f);
+	float fNodeSpacing = gfSceneSize / (float)glNodeGrid;
+	nodeContainer.SetMaxEdgeDistance(fNodeSpacing * 1.5f);
+	int lNodeID = 0;
+	for(int z=0; z<glNodeGrid; ++z)
+	for(int x=0; x<glNodeGrid; ++x)
+	{
+		if(randUnit(rng) < 0.1f) continue;
+		cVector3f vPos(((float)x+0.5f)*fNodeSpacing - gfSceneSize*0.5f, 0, ((float)z+0.5f)*fNodeSpacing - gfSceneSize*0.5f);
+		nodeContainer.AddNode("node"+cString::ToString(lNodeID), lNodeID, vPos);
+		++lNodeID;
+	}
+	nodeContainer.Compile();
+
+	cAStarHandler aStar(&nodeContainer);
+	aStar.SetMaxIterations(-1);
+	tAINodeList lstPath;
+
+	//////////////////////////
+	// Script
+	cLowLevelSystemSDL lowLevelSystem;
+	iScript *pScript = glScriptCalls > 0 ? CreateBenchScript(&lowLevelSystem) : NULL;
+	int lTickHandle = pScript ? pScript->GetFuncHandle("Tick") : -1;
+
+	//////////////////////////
+	// Frames
+	std::vector<cSubsystemTiming> vTimings;
+	vTimings.push_back(cSubsystemTiming("entities"));
+	vTimings.push_back(cSubsystemTiming("physics"));
+	vTimings.push_back(cSubsystemTiming("ai"));
+	vTimings.push_back(cSubsystemTiming("scripts"));
+	vTimings.push_back(cSubsystemTiming("culling"));
+	vTimings.push_back(cSubsystemTiming("render_list"));
+	vTimings.push_back(cSubsystemTiming("entity_compile_per_copy"));
+	vTimings.push_back(cSubsystemTiming("entity_instance_from_prototype"));
+	for(size_t i=0; i<vTimings.size(); ++i) vTimings[i].mvFrameMs.reserve(glFrames);
+
+	iTimer *pTimer = cPlatform::CreateTimer();
+	double fVisibleSum =0;
+	double fPathNodeSum =0;
+	int lPathCount =0;
+	std::array<cPlanef, 0> vOcclusionPlanes = {};
+
+	for(int lFrame=0; lFrame<glFrames; ++lFrame)
+	{
+		float fTime = (float)lFrame * gfStepSize;
+
+		//Entities
+		pTimer->Start();
+		for(size_t i=0; i<vDynamic.size(); ++i)
+		{
+			cBenchRenderable *pObject = vDynamic[i];
+			float fT = fTime + pObject->mfPhase;
+			pObject->SetPosition(pObject->mvStartPos + cVector3f(sin(fT)*3.0f, 0, cos(fT*0.7f)*3.0f));
+		}
+		pTimer->Stop();
+		vTimings[eBenchSubsystem_Entities].mvFrameMs.push_back(pTimer->GetTimeInMilliSec());
+
+		//Physics
+		pTimer->Start();
+		pPhysicsWorld->Simulate(gfStepSize);
+		pTimer->Stop();
+		vTimings[eBenchSubsystem_Physics].mvFrameMs.push_back(pTimer->GetTimeInMilliSec());
+
+		//AI
+		pTimer->Start();
+		for(int i=0; i<glPathsPerFrame && nodeContainer.GetNodeNum()>1; ++i)
+		{
+			cAINode *pStart = nodeContainer.GetNode((int)(randUnit(rng) * (float)(nodeContainer.GetNodeNum()-1)));
+			cAINode *pGoal = nodeContainer.GetNode((int)(randUnit(rng) * (float)(nodeContainer.GetNodeNum()-1)));
+			lstPath.clear();
+			if(aStar.GetPath(pStart->GetPosition(), pGoal->GetPosition(), &lstPath))
+			{
+				fPathNodeSum += (double)lstPath.size();
+				++lPathCount;
+			}
+		}
+		pTimer->Stop();
+		vTimings[eBenchSubsystem_AI].mvFrameMs.push_back(pTimer->GetTimeInMilliSec());
+
+		//Scripts
+		pTimer->Start();
+		if(lTickHandle >= 0)
+		{
+			for(int i=0; i<glScriptCalls; ++i) pScript->Run(lTickHandle);
+		}
+		pTimer->Stop();
+		vTimings[eBenchSubsystem_Scripts].mvFrameMs.push_back(pTimer->GetTimeInMilliSec());
+
+		//Culling, walks the containers and adds what is visible to the render list
+		UpdateCamera(&camera, lFrame);
+		iRenderer::IncRenderFrameCount();
+
+		pTimer->Start();
+		cFrustum *pFrustum = camera.GetFrustum();
+		staticContainer.UpdateBeforeRendering();
+		dynamicContainer.UpdateBeforeRendering();
+		renderList.BeginAndReset(gfStepSize, pFrustum);
+		cRenderList::UpdateRenderListWalkAllNodesTestFrustumAndVisibility(renderList, *pFrustum, *staticContainer.GetRoot(), vOcclusionPlanes, eRenderableFlag_VisibleInNonReflection);
+		cRenderList::UpdateRenderListWalkAllNodesTestFrustumAndVisibility(renderList, *pFrustum, *dynamicContainer.GetRoot(), vOcclusionPlanes, eRenderableFlag_VisibleInNonReflection);
+		pTimer->Stop();
+		vTimings[eBenchSubsystem_Culling].mvFrameMs.push_back(pTimer->GetTimeInMilliSec());
+
+		//Render list, sorting the way the deferred renderer asks for it
+		pTimer->Start();
+		renderList.End(eRenderListCompileFlag_Z | eRenderListCompileFlag_Diffuse | eRenderListCompileFlag_Translucent);
+		pTimer->Stop();
+		vTimings[eBenchSubsystem_RenderList].mvFrameMs.push_back(pTimer->GetTimeInMilliSec());
+
+		fVisibleSum += (double)(renderList.GetSolidObjectNum() + renderList.GetTransObjectNum());
+	}
+
+	//////////////////////////
+	// Entities
+	RunEntityBenchmark(&lowLevelPhysics, pTimer, rng, vTimings);
+
+	//////////////////////////
+	// Output
+	double fAvgVisible = fVisibleSum / (double)glFrames;
+	double fAvgPathNodes = lPathCount ? fPathNodeSum / (double)lPathCount : 0;
+
+	WriteResults(stdout, vTimings, fAvgVisible, fAvgPathNodes);
+	if(gsOutFile != "")
+	{
+		FILE *pFile = cPlatform::OpenFile(cString::To16Char(gsOutFile), _W("w"));
+		if(pFile)
+		{
+			WriteResults(pFile, vTimings, fAvgVisible, fAvgPathNodes);
+			fclose(pFile);
+		}
+		else
+		{
+			printf(" Could not write '%s'\n", gsOutFile.c_str());
+		}
+	}
+
+	//////////////////////////
+	// Clean up
+	hplDelete(pTimer);
+	if(pScript) hplDelete(pScript);
+	hplDelete(pPhysicsWorld);
+
+	for(size_t i=0; i<vStatic.size(); ++i) staticContainer.Remove(vStatic[i]);
+	for(size_t i=0; i<vDynamic.size(); ++i) dynamicContainer.Remove(vDynamic[i]);
+	STLDeleteAll(vStatic);
+	STLDeleteAll(vDynamic);
+	hplDelete(pSolidMat);
+	hplDelete(pTransMat);
+
+	return 0;
+}
+
+//------------------------------------------
+
+int RunFrameBenchmark(const tString &asCommandLine)
+{
+	ParseCommandLine(asCommandLine);
+
+	return RunBenchmark();
+}
+
+//------------------------------------------
+
+class cCheck
+{
+public:
+	const char *msName;
+	int (*mpRun)(const tString &asCommandLine);
+};
+
+static const cCheck gvChecks[] = {
+	{ "frame",			RunFrameBenchmark },
+	{ "fontlayout",		RunFontLayoutBench },
+	{ "guiorder",		RunGuiOrderCheck },
+	{ "transform",		RunTransformBench },
+	{ "decal",			RunDecalBench },
+	{ "geometrypool",	RunGeometryPoolBench },
+	{ "nameindex",		RunNameIndexCheck },
+	{ "shapecollision",	RunShapeCollisionCheck },
+	{ "triggervolume",	RunTriggerVolumeCheck },
+	{ "ropesolver",		RunRopeSolverCheck },
+	{ "interpolation",	RunInterpolationCheck },
+	{ "uvanimation",	RunUvAnimationCheck },
+	{ "animationlod",	RunAnimationLodCheck },
+};
+
+//------------------------------------------
+
+#ifdef WIN32
+	#include <Windows.h>
+
+#endif
+
+#ifdef WIN32
+	int main(int argc, const char* argv[] )
+	{
+		tString asCommandLine;
+		for(int i=1; i<argc; ++i)
+		{
+			asCommandLine += argv[i];
+			if(i!=argc-1) asCommandLine += " ";
+		}
+
+#else
+	int hplMain(const tString &asCommandLine)
+	{
+#endif
+
+	size_t lNameEnd = asCommandLine.find(' ');
+	tString sName = asCommandLine.substr(0, lNameEnd);
+	for(const cCheck& check : gvChecks)
+	{
+		if(sName == check.msName) return check.mpRun(lNameEnd==tString::npos ? "" : asCommandLine.substr(lNameEnd+1));
+	}
+
+	return RunFrameBenchmark(asCommandLine);
+}
+
+#ifdef WIN32
+	int hplMain(const tString &asCommandLine){return -1;}
+#endif
+
+#ifdef __APPLE__
+extern "C" int SDL_main(int argc, char *argv[]);
+int main(int argc, char * argv[]) {
+    return SDL_main(argc, argv);
+}
+#endif
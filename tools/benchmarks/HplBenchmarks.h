@@ -0,0 +1,47 @@
+/*
+ * Copyright © 2009-2020 Frictional Games
+ *
+ * This file is part of Amnesia: The Dark Descent.
+ *
+ * Amnesia: The Dark Descent is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * Amnesia: The Dark Descent is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Amnesia: The Dark Descent.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef HPL_BENCHMARKS_H
+#define HPL_BENCHMARKS_H
+
+#include "system/SystemTypes.h"
+
+//------------------------------------------
+
+// Checks and benchmarks of single subsystems that hpl2_benchmarks runs by name instead of the frame benchmark,
+// "hpl2_benchmarks <name> [-arg value]...". Each gets the command line after the name and returns non zero
+// if it failed.
+
+int RunFrameBenchmark(const hpl::tString &asCommandLine);
+int RunFontLayoutBench(const hpl::tString &asCommandLine);
+int RunGuiOrderCheck(const hpl::tString &asCommandLine);
+int RunTransformBench(const hpl::tString &asCommandLine);
+int RunDecalBench(const hpl::tString &asCommandLine);
+int RunGeometryPoolBench(const hpl::tString &asCommandLine);
+int RunNameIndexCheck(const hpl::tString &asCommandLine);
+int RunShapeCollisionCheck(const hpl::tString &asCommandLine);
+int RunTriggerVolumeCheck(const hpl::tString &asCommandLine);
+int RunRopeSolverCheck(const hpl::tString &asCommandLine);
+int RunInterpolationCheck(const hpl::tString &asCommandLine);
+int RunUvAnimationCheck(const hpl::tString &asCommandLine);
+int RunAnimationLodCheck(const hpl::tString &asCommandLine);
+
+//------------------------------------------
+
+#endif // HPL_BENCHMARKS_H
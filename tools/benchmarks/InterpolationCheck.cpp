@@ -0,0 +1,297 @@
+/*
+ * Copyright © 2009-2020 Frictional Games
+ *
+ * This file is part of Amnesia: The Dark Descent.
+ *
+ * Amnesia: The Dark Descent is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * Amnesia: The Dark Descent is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Amnesia: The Dark Descent.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "hpl.h"
+#include "HplBenchmarks.h"
+#include "system/Timer.h"
+
+using namespace hpl;
+
+namespace interpolationcheck {
+
+//------------------------------------------
+
+// Moves, teleports and scales entities with children and a camera each logic step, then renders "frames" at
+// random fractions of the step and checks that the interpolated world transforms are inbetween the transforms
+// before and after the step, that entities moved after the step and teleports are left as they are, and that
+// everything is back to the real transforms once the interpolation is restored. Prints the time spent per frame.
+// Runs without creating the engine.
+// Returns non zero if any frame differs.
+
+int glEntities = 500;
+int glSteps = 300;
+int glFramesPerStep = 3;
+int glSeed = 1;
+
+const float kfEpsilon = 0.001f;
+
+//------------------------------------------
+
+class cCheckEntity : public iEntity3D
+{
+public:
+	cCheckEntity(const tString& asName) : iEntity3D(asName){ SetRenderInterpolated(true);}
+
+	tString GetEntityType(){ return "CheckEntity";}
+};
+
+class cCheckPair
+{
+public:
+	cCheckEntity *mpRoot;
+	cCheckEntity *mpChild;
+	cMatrixf m_mtxRootPrev;
+	cMatrixf m_mtxChildPrev;
+	bool mbMovedLate;
+};
+
+//------------------------------------------
+
+float RandUnit()
+{
+	return cMath::RandRectf(-1, 1);
+}
+
+cCheckEntity* CreateChild(cCheckEntity *apRoot, int alNum)
+{
+	cCheckEntity *pChild = hplNew(cCheckEntity, ("Child"+cString::ToString(alNum)));
+	pChild->SetMatrix(cMath::MatrixMul(cMath::MatrixTranslate(cVector3f(0, 1, 0.5f)), cMath::MatrixRotateY(0.3f)));
+	apRoot->AddChild(pChild);
+	return pChild;
+}
+
+void MoveRoot(cCheckEntity *apRoot)
+{
+	cMatrixf mtxMove = cMath::MatrixRotate(cVector3f(RandUnit(), RandUnit(), RandUnit()) * 0.2f, eEulerRotationOrder_XYZ);
+	mtxMove.SetTranslation(cVector3f(RandUnit(), RandUnit(), RandUnit()) * 0.3f);
+
+	cMatrixf mtxNew = cMath::MatrixMul(apRoot->GetLocalMatrix(), mtxMove);
+	if(cMath::RandRectl(0, 9)==0) mtxNew = cMath::MatrixMul(mtxNew, cMath::MatrixScale(cVector3f(cMath::RandRectf(0.9f, 1.1f))));
+
+	apRoot->SetMatrix(mtxNew);
+}
+
+bool MatrixNear(const cMatrixf &aA, const cMatrixf &aB)
+{
+	for(int i=0; i<16; ++i)
+	{
+		if(cMath::Abs(aA.v[i] - aB.v[i]) > kfEpsilon) return false;
+	}
+	return true;
+}
+
+//------------------------------------------
+
+void ParseCommandLine(const tString &asCommandLine)
+{
+	tStringVec args;
+	tString sSepp = " ";
+	cString::GetStringVec(asCommandLine, args,&sSepp);
+
+	for(size_t i=0; i+1<args.size(); i+=2)
+	{
+		const tString &sArg = args[i];
+		int lValue = cMath::Max(cString::ToInt(args[i+1].c_str(), 1), 1);
+
+		if(sArg == "-entities")		glEntities = lValue;
+		else if(sArg == "-steps")	glSteps = lValue;
+		else if(sArg == "-frames")	glFramesPerStep = lValue;
+		else if(sArg == "-seed")	glSeed = lValue;
+	}
+}
+
+} // namespace interpolationcheck
+
+//------------------------------------------
+
+int RunInterpolationCheck(const tString &asCommandLine)
+{
+	using namespace interpolationcheck;
+
+	ParseCommandLine(asCommandLine);
+
+	printf("-------- INTERPOLATION CHECK STARTED! -----------\n\n");
+	printf(" Entities: %d Steps: %d Frames per step: %d Seed: %d\n\n", glEntities, glSteps, glFramesPerStep, glSeed);
+
+	cMath::Randomize(glSeed);
+
+	iEntity3D::SetInterpolationEnabled(true);
+
+	////////////////////////////
+	// Entities and camera
+	std::vector<cCheckPair> vPairs(glEntities);
+	int lChildCount = 0;
+	for(int i=0; i<glEntities; ++i)
+	{
+		vPairs[i].mpRoot = hplNew(cCheckEntity, ("Root"+cString::ToString(i)));
+		vPairs[i].mpRoot->SetPosition(cVector3f(RandUnit(), RandUnit(), RandUnit()) * 20.0f);
+		vPairs[i].mpChild = CreateChild(vPairs[i].mpRoot, lChildCount++);
+	}
+
+	cCamera camera;
+	camera.SetPosition(cVector3f(0, 1.7f, 0));
+	cVector3f vCameraPrevPos = camera.GetPosition();
+
+	////////////////////////////
+	// Run
+	iTimer *pTimer = cPlatform::CreateTimer();
+	double fTimeApply = 0;
+	size_t lInterpolated = 0;
+	int lMismatches = 0;
+	int lRestoreErrors = 0;
+	int lCameraErrors = 0;
+
+	camera.EndInterpolationTick();
+	iEntity3D::EndInterpolationTick();
+
+	for(int step=0; step<glSteps; ++step)
+	{
+		////////////////////////////
+		// Logic step
+		for(size_t i=0; i<vPairs.size(); ++i)
+		{
+			cCheckPair &pair = vPairs[i];
+			pair.m_mtxRootPrev = pair.mpRoot->GetWorldMatrix();
+			pair.m_mtxChildPrev = pair.mpChild->GetWorldMatrix();
+			pair.mbMovedLate = false;
+
+			int lRand = cMath::RandRectl(0, 99);
+			if(lRand < 50)		MoveRoot(pair.mpRoot);
+			else if(lRand < 52)	pair.mpRoot->SetPosition(pair.mpRoot->GetLocalPosition() + cVector3f(10, 0, 0));
+
+			//Children destroyed and created again, the new one has nothing kept from before
+			if(cMath::RandRectl(0, 199)==0)
+			{
+				hplDelete(pair.mpChild);
+				pair.mpChild = CreateChild(pair.mpRoot, lChildCount++);
+				pair.m_mtxChildPrev = pair.mpChild->GetWorldMatrix();
+			}
+		}
+
+		vCameraPrevPos = camera.GetPosition();
+		cMatrixf mtxCameraPrevView = camera.GetViewMatrix();
+		camera.SetPosition(camera.GetPosition() + cVector3f(RandUnit(), 0, RandUnit()) * 0.1f);
+		camera.AddYaw(RandUnit() * 0.1f);
+		camera.AddPitch(RandUnit() * 0.05f);
+
+		camera.EndInterpolationTick();
+		iEntity3D::EndInterpolationTick();
+
+		////////////////////////////
+		// Some are moved after the step, they are not interpolated
+		for(size_t i=0; i<vPairs.size(); ++i)
+		{
+			if(cMath::RandRectl(0, 49)!=0) continue;
+			MoveRoot(vPairs[i].mpRoot);
+			vPairs[i].mbMovedLate = true;
+		}
+
+		////////////////////////////
+		// Frames
+		for(int frame=0; frame<glFramesPerStep; ++frame)
+		{
+			float fT = cMath::RandRectf(0, 1);
+			if(frame==0) fT = 0;
+
+			std::vector<cMatrixf> vRealWorld(vPairs.size()*2);
+			for(size_t i=0; i<vPairs.size(); ++i)
+			{
+				vRealWorld[i*2] = vPairs[i].mpRoot->GetWorldMatrix();
+				vRealWorld[i*2+1] = vPairs[i].mpChild->GetWorldMatrix();
+			}
+			cVector3f vCameraRealPos = camera.GetPosition();
+
+			pTimer->Start();
+			iEntity3D::ApplyInterpolation(fT);
+			camera.ApplyInterpolation(fT);
+			pTimer->Stop();
+			fTimeApply += pTimer->GetTimeInMilliSec();
+			lInterpolated += iEntity3D::GetInterpolatedNum();
+
+			////////////////////////////
+			// Check the interpolated transforms
+			for(size_t i=0; i<vPairs.size(); ++i)
+			{
+				cCheckPair &pair = vPairs[i];
+				for(int j=0; j<2; ++j)
+				{
+					iEntity3D *pEntity = j==0 ? pair.mpRoot : pair.mpChild;
+					const cMatrixf &mtxPrev = j==0 ? pair.m_mtxRootPrev : pair.m_mtxChildPrev;
+					const cMatrixf &mtxReal = vRealWorld[i*2+j];
+
+					cMatrixf mtxExpected = mtxReal;
+					float fMaxDist = iEntity3D::GetInterpolationMaxDistance();
+					if(	pair.mbMovedLate==false &&
+						cMath::Vector3DistSqr(mtxPrev.GetTranslation(), mtxReal.GetTranslation()) <= fMaxDist*fMaxDist)
+					{
+						mtxExpected = cMath::MatrixSlerpScaled(fT, mtxPrev, mtxReal);
+					}
+
+					if(MatrixNear(pEntity->GetWorldMatrix(), mtxExpected)==false)
+					{
+						if(lMismatches < 20)
+							printf(" MISMATCH step %d frame %d: '%s' t %.2f\n", step, frame, pEntity->GetName().c_str(), fT);
+						++lMismatches;
+					}
+				}
+			}
+
+			cVector3f vCameraExpected = vCameraPrevPos * (1 - fT) + vCameraRealPos * fT;
+			if(	cMath::Vector3Dist(camera.GetPosition(), vCameraExpected) > kfEpsilon ||
+				(fT==0 && MatrixNear(camera.GetViewMatrix(), mtxCameraPrevView)==false))
+			{
+				++lCameraErrors;
+			}
+
+			camera.RestoreInterpolation();
+			iEntity3D::RestoreInterpolation();
+
+			////////////////////////////
+			// Check that everything is back
+			for(size_t i=0; i<vPairs.size(); ++i)
+			{
+				if(	vPairs[i].mpRoot->GetWorldMatrix() != vRealWorld[i*2] ||
+					vPairs[i].mpChild->GetWorldMatrix() != vRealWorld[i*2+1])
+				{
+					++lRestoreErrors;
+				}
+			}
+			if(camera.GetPosition() != vCameraRealPos) ++lCameraErrors;
+		}
+	}
+
+	hplDelete(pTimer);
+
+	int lFrames = glSteps * glFramesPerStep;
+	printf(" %d frames, %.1f entities interpolated per frame\n", lFrames, (double)lInterpolated / (double)lFrames);
+	printf(" Apply     %9.3f ms total, %.4f ms per frame\n", fTimeApply, fTimeApply / (double)lFrames);
+	printf(" Mismatches: %d Restore errors: %d Camera errors: %d\n", lMismatches, lRestoreErrors, lCameraErrors);
+
+	for(size_t i=0; i<vPairs.size(); ++i)
+	{
+		hplDelete(vPairs[i].mpChild);
+		hplDelete(vPairs[i].mpRoot);
+	}
+	iEntity3D::SetInterpolationEnabled(false);
+
+	bool bPassed = lMismatches==0 && lRestoreErrors==0 && lCameraErrors==0;
+	printf("\n-------- INTERPOLATION CHECK %s! -----------\n", bPassed ? "PASSED" : "FAILED");
+
+	return bPassed ? 0 : 1;
+}
@@ -0,0 +1,237 @@
+/*
+ * Copyright © 2009-2020 Frictional Games
+ *
+ * This file is part of Amnesia: The Dark Descent.
+ *
+ * Amnesia: The Dark Descent is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * Amnesia: The Dark Descent is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Amnesia: The Dark Descent.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "hpl.h"
+#include "HplBenchmarks.h"
+#include "system/Timer.h"
+
+using namespace hpl;
+
+namespace nameindexcheck {
+
+//------------------------------------------
+
+// Checks that cWildcardNameIndex gives the same entities, in the same order, as the linear matcher the
+// script handler used for wildcard names, over a corpus of map-like names and patterns. Entities are removed
+// and added between rounds the way a map does. Also times both. Runs without creating the engine.
+// Returns non zero if any pattern differs.
+
+int glNames = 2000;
+int glRounds = 4;
+int glRandomPatterns = 2000;
+int glSeed = 1;
+
+//------------------------------------------
+
+const char* gvNameBases[] = {
+	"lamp_", "candle_", "candlestick_floor_", "torch_", "door_", "cellar_door", "prison_section_door_",
+	"ScriptArea_", "AreaLookAt_", "PlayerStartArea_", "key_", "note_", "barrel", "chair_", "wine", "Lamp_",
+	"guardian_", "servant_grunt_", "pig_", "rock_", "rock_debris_", "book_", "L", "a", "_", "",
+};
+
+const char* gvFixedPatterns[] = {
+	"*", "**", "***", "lamp_*", "*lamp_*", "lamp*", "*_1", "*_1*", "candle*_1", "*door*", "door_*_2*",
+	"*_*", "Script*", "script*", "*Area*", "*Area_1*", "L*", "*a*", "a*b", "*a*a*", "*_*_*", "1*1", "*12",
+	"barrel**wine", "*xyz*", "prison*door*_1", "lamp_1", "*lamp_1", "*amp*", "*p_*", "_", "*1*2*3*",
+};
+
+//------------------------------------------
+
+// The loop from cLuxScriptHandler::GetEntities before the index.
+void FindLinear(const tString& asPattern, const std::vector<tString>& avNames, const std::vector<bool>& avAlive, std::vector<int>& avResult)
+{
+	avResult.clear();
+
+	tStringVec vWantedStrings;
+	tString sSepp = "*";
+	cString::GetStringVec(asPattern,vWantedStrings,&sSepp);
+
+	for(size_t lEntity=0; lEntity<avNames.size(); ++lEntity)
+	{
+		if(avAlive[lEntity]==false) continue;
+
+		bool bContainsStrings = true;
+		int lLastPos = -1;
+		for(size_t i=0; i<vWantedStrings.size(); ++i)
+		{
+			int lPos = cString::GetFirstStringPos(avNames[lEntity], vWantedStrings[i]);
+			if(lPos <= lLastPos)
+			{
+				bContainsStrings = false;
+				break;
+			}
+		}
+
+		if(bContainsStrings) avResult.push_back((int)lEntity);
+	}
+}
+
+void FindIndexed(cWildcardNameIndex *apIndex, const tString& asPattern, std::vector<void*>& avTemp, std::vector<int>& avResult)
+{
+	avResult.clear();
+
+	apIndex->Find(asPattern, avTemp);
+	for(size_t i=0; i<avTemp.size(); ++i)
+	{
+		//Data is the name index + 1
+		avResult.push_back((int)((size_t)avTemp[i]) - 1);
+	}
+}
+
+//------------------------------------------
+
+tString GetRandomName()
+{
+	tString sName = gvNameBases[cMath::RandRectl(0, (int)(sizeof(gvNameBases)/sizeof(gvNameBases[0])) - 1)];
+	int lNum = cMath::RandRectl(0, 2);
+	for(int i=0; i<lNum; ++i)
+	{
+		sName += cString::ToString(cMath::RandRectl(0, 29));
+		if(cMath::RandRectl(0, 1)) sName += "_";
+	}
+	return sName;
+}
+
+tString GetRandomPattern()
+{
+	const char *pChars = "*_la1o2dA";
+	int lLength = cMath::RandRectl(0, 7);
+
+	tString sPattern;
+	for(int i=0; i<lLength; ++i) sPattern += pChars[cMath::RandRectl(0, 8)];
+	return sPattern;
+}
+
+//------------------------------------------
+
+void ParseCommandLine(const tString &asCommandLine)
+{
+	tStringVec args;
+	tString sSepp = " ";
+	cString::GetStringVec(asCommandLine, args,&sSepp);
+
+	for(size_t i=0; i+1<args.size(); i+=2)
+	{
+		const tString &sArg = args[i];
+		int lValue = cMath::Max(cString::ToInt(args[i+1].c_str(), 1), 1);
+
+		if(sArg == "-names")			glNames = lValue;
+		else if(sArg == "-rounds")		glRounds = lValue;
+		else if(sArg == "-patterns")	glRandomPatterns = lValue;
+		else if(sArg == "-seed")		glSeed = lValue;
+	}
+}
+
+} // namespace nameindexcheck
+
+//------------------------------------------
+
+int RunNameIndexCheck(const tString &asCommandLine)
+{
+	using namespace nameindexcheck;
+
+	ParseCommandLine(asCommandLine);
+
+	printf("-------- NAME INDEX CHECK STARTED! -----------\n\n");
+	printf(" Names: %d Rounds: %d Random patterns: %d Seed: %d\n\n", glNames, glRounds, glRandomPatterns, glSeed);
+
+	cMath::Randomize(glSeed);
+
+	////////////////////////////
+	// Patterns
+	tStringVec vPatterns;
+	for(size_t i=0; i<sizeof(gvFixedPatterns)/sizeof(gvFixedPatterns[0]); ++i) vPatterns.push_back(gvFixedPatterns[i]);
+	for(int i=0; i<glRandomPatterns; ++i) vPatterns.push_back(GetRandomPattern());
+
+	////////////////////////////
+	// Names, the index gets the position in the list as order like cLuxMap does with its counter
+	std::vector<tString> vNames;
+	std::vector<bool> vAlive;
+	cWildcardNameIndex nameIndex;
+
+	iTimer *pTimer = cPlatform::CreateTimer();
+	double fLinearTime = 0;
+	double fIndexTime = 0;
+	int lMismatches = 0;
+	size_t lMatches = 0;
+
+	std::vector<int> vLinearResult;
+	std::vector<int> vIndexResult;
+	std::vector<void*> vTemp;
+
+	for(int round=0; round<glRounds; ++round)
+	{
+		////////////////////////////
+		// Remove some and add new ones
+		for(size_t i=0; i<vNames.size(); ++i)
+		{
+			if(vAlive[i] && cMath::RandRectl(0, 3) == 0)
+			{
+				nameIndex.Remove((int)i);
+				vAlive[i] = false;
+			}
+		}
+		int lAdd = round==0 ? glNames : glNames/4;
+		for(int i=0; i<lAdd; ++i)
+		{
+			vNames.push_back(GetRandomName());
+			vAlive.push_back(true);
+			nameIndex.Add((void*)(vNames.size()), (int)vNames.size()-1, vNames.back());
+		}
+
+		////////////////////////////
+		// Compare
+		for(size_t i=0; i<vPatterns.size(); ++i)
+		{
+			pTimer->Start();
+			FindLinear(vPatterns[i], vNames, vAlive, vLinearResult);
+			pTimer->Stop();
+			fLinearTime += pTimer->GetTimeInMilliSec();
+
+			pTimer->Start();
+			FindIndexed(&nameIndex, vPatterns[i], vTemp, vIndexResult);
+			pTimer->Stop();
+			fIndexTime += pTimer->GetTimeInMilliSec();
+
+			lMatches += vLinearResult.size();
+
+			if(vLinearResult != vIndexResult)
+			{
+				if(lMismatches < 20)
+				{
+					printf(" MISMATCH round %d pattern '%s': linear %d, index %d entities\n", round, vPatterns[i].c_str(),
+							(int)vLinearResult.size(), (int)vIndexResult.size());
+				}
+				++lMismatches;
+			}
+		}
+	}
+
+	hplDelete(pTimer);
+
+	double fQueries = (double)glRounds * (double)vPatterns.size();
+	printf(" %d queries, %d names in index, %.1f matches per query\n", (int)fQueries, nameIndex.GetSize(), (double)lMatches / fQueries);
+	printf(" Linear  %9.3f ms total, %7.3f us per query\n", fLinearTime, fLinearTime * 1000.0 / fQueries);
+	printf(" Index   %9.3f ms total, %7.3f us per query\n", fIndexTime, fIndexTime * 1000.0 / fQueries);
+	printf(" Mismatches: %d\n", lMismatches);
+
+	printf("\n-------- NAME INDEX CHECK %s! -----------\n", lMismatches==0 ? "PASSED" : "FAILED");
+
+	return lMismatches==0 ? 0 : 1;
+}
@@ -0,0 +1,313 @@
+/*
+ * Copyright © 2009-2020 Frictional Games
+ *
+ * This file is part of Amnesia: The Dark Descent.
+ *
+ * Amnesia: The Dark Descent is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * Amnesia: The Dark Descent is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Amnesia: The Dark Descent.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "hpl.h"
+#include "HplBenchmarks.h"
+#include "system/Timer.h"
+#include "impl/LowLevelPhysicsNewton.h"
+
+using namespace hpl;
+
+namespace ropesolvercheck {
+
+//------------------------------------------
+
+// Swings ropes by moving their start and checks that iPhysicsRope gives exactly the same particle positions
+// as the list based solver it used before (kept below), then lets them come to rest with extra damping and
+// checks that they fall asleep. Also prints how far the end of the rope gets from the full simulation with lod steps 2 and 4.
+// Runs without creating the engine.
+// Returns non zero if any setup differs or does not fall asleep.
+
+int glSteps = 600;
+int glSeed = 1;
+
+const float gfTimeStep = 1.0f / 60.0f;
+
+//------------------------------------------
+
+class cRopeSetup
+{
+public:
+	float mfLength;
+	float mfSegmentLength;
+	float mfDamping;
+	int mlIterations;
+};
+
+cRopeSetup gvSetups[] = {
+	{1.5f,	0,		0.001f,	3},
+	{2.0f,	0.1f,	0.001f,	3},
+	{5.0f,	0.2f,	0.01f,	5},
+	{4.0f,	0.3f,	0.001f,	3},
+	{10.0f,	0.05f,	0.001f,	3},
+};
+
+//------------------------------------------
+
+// The solver from before, particles in a list that every pass goes through.
+class cReferenceParticle
+{
+public:
+	cVector3f mvPosition;
+	cVector3f mvPrevPosition;
+	float mfInvMass;
+};
+
+class cReferenceRope
+{
+public:
+	cReferenceRope(iPhysicsRope *apRope)
+	{
+		cVerletParticleIterator it = apRope->GetParticleIterator();
+		while(it.HasNext())
+		{
+			cVerletParticle *pPart = it.Next();
+
+			cReferenceParticle *pRefPart = hplNew(cReferenceParticle, ());
+			pRefPart->mvPosition = pPart->GetPosition();
+			pRefPart->mvPrevPosition = pPart->GetPrevPosition();
+			pRefPart->mfInvMass = pPart->GetInvMass();
+			mlstParticles.push_back(pRefPart);
+		}
+
+		mvGravityForce = apRope->GetGravityForce();
+		mfDampingMul = 1 - apRope->GetDamping();
+		mlMaxIterations = apRope->GetMaxIterations();
+		mfSegmentLength = apRope->GetSegmentLength();
+
+		if(mfSegmentLength > 0)
+		{
+			mfFirstSegmentLength = cMath::Modulus(apRope->GetTotalLength(), mfSegmentLength);
+			if(mfFirstSegmentLength == 0) mfFirstSegmentLength = mfSegmentLength;
+		}
+		else
+		{
+			mfFirstSegmentLength = apRope->GetTotalLength();
+		}
+	}
+
+	~cReferenceRope()
+	{
+		STLDeleteAll(mlstParticles);
+	}
+
+	void Update(float afTimeStep)
+	{
+		for(std::list<cReferenceParticle*>::iterator it = mlstParticles.begin(); it != mlstParticles.end(); ++it)
+		{
+			cReferenceParticle *pPart = *it;
+
+			cVector3f vAcc = pPart->mfInvMass == 0 ? 0 : mvGravityForce;
+
+			cVector3f vTemp = pPart->mvPosition;
+			pPart->mvPosition += (pPart->mvPosition*mfDampingMul - pPart->mvPrevPosition*mfDampingMul) + vAcc * afTimeStep*afTimeStep;
+			pPart->mvPrevPosition = vTemp;
+		}
+
+		for(int i=0; i<mlMaxIterations; ++i)
+		{
+			cReferenceParticle *pPrevPart = NULL;
+			std::list<cReferenceParticle*>::iterator it = mlstParticles.begin();
+			for(int lCount = 0; it != mlstParticles.end(); ++it, ++lCount)
+			{
+				cReferenceParticle *pPart = *it;
+				if(lCount >0)
+				{
+					float fLength = lCount==1 ? mfFirstSegmentLength : mfSegmentLength;
+
+					cVector3f vDelta =  pPart->mvPosition - pPrevPart->mvPosition;
+					float fDist = vDelta.Length();
+
+					float fDiff = (fDist- fLength)/(fDist*(pPrevPart->mfInvMass + pPart->mfInvMass));
+
+					pPrevPart->mvPosition += vDelta * fDiff * pPrevPart->mfInvMass;
+					pPart->mvPosition -= vDelta * fDiff * pPart->mfInvMass;
+				}
+
+				pPrevPart = pPart;
+			}
+		}
+	}
+
+	std::list<cReferenceParticle*> mlstParticles;
+
+	cVector3f mvGravityForce;
+	float mfDampingMul;
+	int mlMaxIterations;
+	float mfSegmentLength;
+	float mfFirstSegmentLength;
+};
+
+//------------------------------------------
+
+iPhysicsRope* CreateRope(iPhysicsWorld *apWorld, const cRopeSetup &aSetup, int alLodStep)
+{
+	iPhysicsRope *pRope = apWorld->CreateRope("Rope", cVector3f(0, 0, 0), cVector3f(aSetup.mfLength, 0, 0));
+	pRope->SetGravityForce(cVector3f(0, -9.8f, 0));
+	pRope->SetDamping(aSetup.mfDamping);
+	pRope->SetMaxIterations(aSetup.mlIterations);
+	pRope->SetSegmentLength(aSetup.mfSegmentLength);
+	pRope->SetLodStep(alLodStep);
+	return pRope;
+}
+
+cVector3f GetStartPos(int alStep, float afSpeed)
+{
+	float fT = (float)alStep * gfTimeStep * afSpeed;
+	return cVector3f(sin(fT) * 0.4f, cos(fT * 0.7f) * 0.2f, sin(fT * 1.3f) * 0.3f);
+}
+
+//------------------------------------------
+
+void ParseCommandLine(const tString &asCommandLine)
+{
+	tStringVec args;
+	tString sSepp = " ";
+	cString::GetStringVec(asCommandLine, args,&sSepp);
+
+	for(size_t i=0; i+1<args.size(); i+=2)
+	{
+		const tString &sArg = args[i];
+		int lValue = cMath::Max(cString::ToInt(args[i+1].c_str(), 1), 1);
+
+		if(sArg == "-steps")		glSteps = lValue;
+		else if(sArg == "-seed")	glSeed = lValue;
+	}
+}
+
+} // namespace ropesolvercheck
+
+//------------------------------------------
+
+int RunRopeSolverCheck(const tString &asCommandLine)
+{
+	using namespace ropesolvercheck;
+
+	ParseCommandLine(asCommandLine);
+
+	printf("-------- ROPE SOLVER CHECK STARTED! -----------\n\n");
+	printf(" Steps: %d Seed: %d\n\n", glSteps, glSeed);
+
+	cMath::Randomize(glSeed);
+
+	cLowLevelPhysicsNewton lowLevelPhysics;
+	iPhysicsWorld *pWorld = lowLevelPhysics.CreateWorld();
+
+	iTimer *pTimer = cPlatform::CreateTimer();
+	int lFailed = 0;
+
+	for(size_t lSetup=0; lSetup<sizeof(gvSetups)/sizeof(gvSetups[0]); ++lSetup)
+	{
+		const cRopeSetup &setup = gvSetups[lSetup];
+		float fSpeed = cMath::RandRectf(1.0f, 6.0f);
+
+		iPhysicsRope *pRope = CreateRope(pWorld, setup, 1);
+		iPhysicsRope *vLodRopes[2] = { CreateRope(pWorld, setup, 2), CreateRope(pWorld, setup, 4) };
+		cReferenceRope refRope(pRope);
+
+		int lParticles = (int)refRope.mlstParticles.size();
+
+		////////////////////////////
+		// Swing, compare with the reference
+		double fTimeRope = 0;
+		double fTimeRef = 0;
+		int lMismatches = 0;
+		float fMaxLodError[2] = {0, 0};
+
+		for(int step=0; step<glSteps; ++step)
+		{
+			cVector3f vStartPos = GetStartPos(step, fSpeed);
+
+			pTimer->Start();
+			pRope->GetStartParticle()->SetPosition(vStartPos, false);
+			pRope->UpdateBeforeSimulate(gfTimeStep);
+			pRope->UpdateAfterSimulate(gfTimeStep);
+			pTimer->Stop();
+			fTimeRope += pTimer->GetTimeInMilliSec();
+
+			pTimer->Start();
+			refRope.mlstParticles.front()->mvPosition = vStartPos;
+			refRope.Update(gfTimeStep);
+			pTimer->Stop();
+			fTimeRef += pTimer->GetTimeInMilliSec();
+
+			cVerletParticleIterator it = pRope->GetParticleIterator();
+			std::list<cReferenceParticle*>::iterator refIt = refRope.mlstParticles.begin();
+			for(; it.HasNext(); ++refIt)
+			{
+				cVerletParticle *pPart = it.Next();
+				if(pPart->GetPosition() != (*refIt)->mvPosition || pPart->GetPrevPosition() != (*refIt)->mvPrevPosition)
+				{
+					++lMismatches;
+					break;
+				}
+			}
+
+			for(int i=0; i<2; ++i)
+			{
+				vLodRopes[i]->GetStartParticle()->SetPosition(vStartPos, false);
+				vLodRopes[i]->UpdateBeforeSimulate(gfTimeStep);
+				vLodRopes[i]->UpdateAfterSimulate(gfTimeStep);
+
+				float fError = cMath::Vector3Dist(vLodRopes[i]->GetEndParticle()->GetPosition(), pRope->GetEndParticle()->GetPosition());
+				fMaxLodError[i] = cMath::Max(fMaxLodError[i], fError);
+			}
+		}
+
+		////////////////////////////
+		// Rest, should fall asleep. The start is stopped and the damping raised, else a
+		// loosely damped rope keeps swinging far longer than is worth waiting for here.
+		pRope->GetStartParticle()->SetPosition(pRope->GetStartParticle()->GetPosition(), true);
+		pRope->SetDamping(0.05f);
+
+		int lStepsToSleep = -1;
+		for(int step=0; step<60*60; ++step)
+		{
+			pRope->UpdateBeforeSimulate(gfTimeStep);
+			pRope->UpdateAfterSimulate(gfTimeStep);
+
+			if(pRope->GetSleeping())
+			{
+				lStepsToSleep = step;
+				break;
+			}
+		}
+
+		bool bPassed = lMismatches==0 && lStepsToSleep >= 0;
+		if(bPassed==false) ++lFailed;
+
+		printf(" Setup %d: length %.2f segment %.2f, %d particles\n", (int)lSetup, setup.mfLength, setup.mfSegmentLength, lParticles);
+		printf("   Rope      %9.3f ms total, list based %9.3f ms total\n", fTimeRope, fTimeRef);
+		printf("   Mismatching steps: %d\n", lMismatches);
+		printf("   Lod 2 max end error: %.3f Lod 4 max end error: %.3f\n", fMaxLodError[0], fMaxLodError[1]);
+		if(lStepsToSleep >= 0)	printf("   Asleep after %d steps of rest\n", lStepsToSleep);
+		else					printf("   NOT asleep after 60 seconds of rest\n");
+
+		pWorld->DestroyRope(pRope);
+		pWorld->DestroyRope(vLodRopes[0]);
+		pWorld->DestroyRope(vLodRopes[1]);
+	}
+
+	hplDelete(pTimer);
+	hplDelete(pWorld);
+
+	printf("\n-------- ROPE SOLVER CHECK %s! -----------\n", lFailed==0 ? "PASSED" : "FAILED");
+
+	return lFailed==0 ? 0 : 1;
+}
@@ -0,0 +1,212 @@
+/*
+ * Copyright © 2009-2020 Frictional Games
+ *
+ * This file is part of Amnesia: The Dark Descent.
+ *
+ * Amnesia: The Dark Descent is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * Amnesia: The Dark Descent is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Amnesia: The Dark Descent.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "hpl.h"
+#include "HplBenchmarks.h"
+#include "system/Timer.h"
+#include "impl/LowLevelPhysicsNewton.h"
+#include "impl/PhysicsWorldNewton.h"
+
+using namespace hpl;
+
+namespace shapecollisioncheck {
+
+//------------------------------------------
+
+// Runs cPhysicsWorldNewton::CheckShapeCollision on random pairs of compound and single shapes with sub shape
+// pruning off and on. Checks that the results and contact points are the same and prints how many sub shape
+// pairs reached Newton and the time for each. Runs without creating the engine.
+// Returns non zero if any pair differs.
+
+int glCompounds = 40;
+int glMaxSubShapes = 24;
+int glPairs = 4000;
+int glSeed = 1;
+
+//------------------------------------------
+
+float RandUnit()
+{
+	return cMath::RandRectf(-1, 1);
+}
+
+iCollideShape* CreateRandomShape(iPhysicsWorld *apWorld, float afSpread)
+{
+	cMatrixf mtxOffset = cMath::MatrixRotate(cVector3f(RandUnit(), RandUnit(), RandUnit()) * kPif, eEulerRotationOrder_XYZ);
+	mtxOffset.SetTranslation(cVector3f(RandUnit(), RandUnit(), RandUnit()) * afSpread);
+
+	float fSize = cMath::RandRectf(0.05f, 0.4f);
+	switch(cMath::RandRectl(0, 3))
+	{
+	case 0:	return apWorld->CreateBoxShape(cVector3f(fSize, fSize*2, fSize*0.5f), &mtxOffset);
+	case 1:	return apWorld->CreateSphereShape(cVector3f(fSize), &mtxOffset);
+	case 2:	return apWorld->CreateCapsuleShape(fSize*0.5f, fSize*3, &mtxOffset);
+	default:return apWorld->CreateCylinderShape(fSize, fSize*2, &mtxOffset);
+	}
+}
+
+iCollideShape* CreateRandomCompound(iPhysicsWorld *apWorld)
+{
+	int lCount = cMath::RandRectl(2, glMaxSubShapes);
+	float fSpread = cMath::RandRectf(0.5f, 2.0f);
+
+	tCollideShapeVec vShapes;
+	for(int i=0; i<lCount; ++i) vShapes.push_back(CreateRandomShape(apWorld, fSpread));
+
+	return apWorld->CreateCompundShape(vShapes);
+}
+
+cMatrixf GetRandomTransform(float afRange)
+{
+	cMatrixf mtxTransform = cMath::MatrixRotate(cVector3f(RandUnit(), RandUnit(), RandUnit()) * kPif, eEulerRotationOrder_XYZ);
+	mtxTransform.SetTranslation(cVector3f(RandUnit(), RandUnit(), RandUnit()) * afRange);
+	return mtxTransform;
+}
+
+//------------------------------------------
+
+bool SameResult(bool abCollideA, const cCollideData& aDataA, bool abCollideB, const cCollideData& aDataB)
+{
+	if(abCollideA != abCollideB) return false;
+	if(abCollideA==false) return true;
+	if(aDataA.mlNumOfPoints != aDataB.mlNumOfPoints) return false;
+
+	for(int i=0; i<aDataA.mlNumOfPoints; ++i)
+	{
+		const cCollidePoint &pointA = aDataA.mvContactPoints[i];
+		const cCollidePoint &pointB = aDataB.mvContactPoints[i];
+		if(pointA.mvPoint != pointB.mvPoint || pointA.mvNormal != pointB.mvNormal || pointA.mfDepth != pointB.mfDepth)
+			return false;
+	}
+	return true;
+}
+
+//------------------------------------------
+
+void ParseCommandLine(const tString &asCommandLine)
+{
+	tStringVec args;
+	tString sSepp = " ";
+	cString::GetStringVec(asCommandLine, args,&sSepp);
+
+	for(size_t i=0; i+1<args.size(); i+=2)
+	{
+		const tString &sArg = args[i];
+		int lValue = cMath::Max(cString::ToInt(args[i+1].c_str(), 1), 1);
+
+		if(sArg == "-compounds")		glCompounds = lValue;
+		else if(sArg == "-subshapes")	glMaxSubShapes = cMath::Max(lValue, 2);
+		else if(sArg == "-pairs")		glPairs = lValue;
+		else if(sArg == "-seed")		glSeed = lValue;
+	}
+}
+
+} // namespace shapecollisioncheck
+
+//------------------------------------------
+
+int RunShapeCollisionCheck(const tString &asCommandLine)
+{
+	using namespace shapecollisioncheck;
+
+	ParseCommandLine(asCommandLine);
+
+	printf("-------- SHAPE COLLISION CHECK STARTED! -----------\n\n");
+	printf(" Compounds: %d Max sub shapes: %d Pairs: %d Seed: %d\n\n", glCompounds, glMaxSubShapes, glPairs, glSeed);
+
+	cMath::Randomize(glSeed);
+
+	cLowLevelPhysicsNewton lowLevelPhysics;
+	cPhysicsWorldNewton *pWorld = static_cast<cPhysicsWorldNewton*>(lowLevelPhysics.CreateWorld());
+
+	////////////////////////////
+	// Shapes, mostly compounds and a few single ones like the player and area boxes
+	std::vector<iCollideShape*> vShapes;
+	for(int i=0; i<glCompounds; ++i) vShapes.push_back(CreateRandomCompound(pWorld));
+	for(int i=0; i<glCompounds/4 + 1; ++i) vShapes.push_back(CreateRandomShape(pWorld, 0));
+
+	////////////////////////////
+	// Run
+	cCollideData collideDataAll;
+	cCollideData collideDataPruned;
+	collideDataAll.SetMaxSize(32);
+	collideDataPruned.SetMaxSize(32);
+
+	iTimer *pTimer = cPlatform::CreateTimer();
+	double fTimeAll = 0;
+	double fTimePruned = 0;
+	int lPairsAll = 0;
+	int lPairsPruned = 0;
+	int lCollisions = 0;
+	int lMismatches = 0;
+
+	for(int i=0; i<glPairs; ++i)
+	{
+		iCollideShape *pShapeA = vShapes[cMath::RandRectl(0, (int)vShapes.size()-1)];
+		iCollideShape *pShapeB = vShapes[cMath::RandRectl(0, (int)vShapes.size()-1)];
+		cMatrixf mtxA = GetRandomTransform(2.0f);
+		cMatrixf mtxB = GetRandomTransform(2.0f);
+
+		//Many callers only want to know if there is a collision and ask for a single point
+		int lMaxPoints = (i%2)==0 ? 1 : 16;
+		bool bCorrectNormal = (i%3)!=0;
+
+		pWorld->SetPruneShapePairs(false);
+		pWorld->ResetShapePairsTested();
+		pTimer->Start();
+		bool bCollideAll = pWorld->CheckShapeCollision(pShapeA, mtxA, pShapeB, mtxB, collideDataAll, lMaxPoints, bCorrectNormal);
+		pTimer->Stop();
+		fTimeAll += pTimer->GetTimeInMilliSec();
+		lPairsAll += pWorld->GetShapePairsTested();
+
+		pWorld->SetPruneShapePairs(true);
+		pWorld->ResetShapePairsTested();
+		pTimer->Start();
+		bool bCollidePruned = pWorld->CheckShapeCollision(pShapeA, mtxA, pShapeB, mtxB, collideDataPruned, lMaxPoints, bCorrectNormal);
+		pTimer->Stop();
+		fTimePruned += pTimer->GetTimeInMilliSec();
+		lPairsPruned += pWorld->GetShapePairsTested();
+
+		if(bCollideAll) ++lCollisions;
+
+		if(SameResult(bCollideAll, collideDataAll, bCollidePruned, collideDataPruned)==false)
+		{
+			if(lMismatches < 20)
+			{
+				printf(" MISMATCH pair %d: all %d (%d points), pruned %d (%d points)\n", i,
+						bCollideAll, bCollideAll ? collideDataAll.mlNumOfPoints : 0,
+						bCollidePruned, bCollidePruned ? collideDataPruned.mlNumOfPoints : 0);
+			}
+			++lMismatches;
+		}
+	}
+
+	hplDelete(pTimer);
+
+	printf(" %d pairs, %d colliding\n", glPairs, lCollisions);
+	printf(" All     %9d sub shape pairs, %9.3f ms total, %7.3f us per check\n", lPairsAll, fTimeAll, fTimeAll * 1000.0 / (double)glPairs);
+	printf(" Pruned  %9d sub shape pairs, %9.3f ms total, %7.3f us per check\n", lPairsPruned, fTimePruned, fTimePruned * 1000.0 / (double)glPairs);
+	printf(" Mismatches: %d\n", lMismatches);
+
+	hplDelete(pWorld);
+
+	printf("\n-------- SHAPE COLLISION CHECK %s! -----------\n", lMismatches==0 ? "PASSED" : "FAILED");
+
+	return lMismatches==0 ? 0 : 1;
+}
@@ -0,0 +1,176 @@
+/*
+ * Copyright © 2009-2020 Frictional Games
+ *
+ * This file is part of Amnesia: The Dark Descent.
+ *
+ * Amnesia: The Dark Descent is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * Amnesia: The Dark Descent is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Amnesia: The Dark Descent.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "hpl.h"
+#include "HplBenchmarks.h"
+#include "system/Timer.h"
+
+using namespace hpl;
+
+namespace transformbench {
+
+//------------------------------------------
+
+// Moves the roots of deep attachment chains several times per frame, the way physics moves bodies with
+// attached entities, and measures the cost per moved entity. Runs without creating the engine.
+// "Eager" resolves the hierarchy after every move, which is what every setter used to do.
+
+int glChains = 200;
+int glDepth = 8;
+int glMovesPerFrame = 4;
+int glFrames = 200;
+
+//------------------------------------------
+
+class cBenchEntity : public iEntity3D
+{
+public:
+	cBenchEntity(const tString& asName) : iEntity3D(asName){}
+
+	tString GetEntityType(){ return "BenchEntity";}
+};
+
+class cBenchCallback : public iEntityCallback
+{
+public:
+	cBenchCallback() : mlCount(0){}
+
+	void OnTransformUpdate(iEntity3D * apEntity){ ++mlCount;}
+
+	int mlCount;
+};
+
+//------------------------------------------
+
+void ParseCommandLine(const tString &asCommandLine)
+{
+	tStringVec args;
+	tString sSepp = " ";
+	cString::GetStringVec(asCommandLine, args,&sSepp);
+
+	for(size_t i=0; i+1<args.size(); i+=2)
+	{
+		const tString &sArg = args[i];
+		int lValue = cMath::Max(cString::ToInt(args[i+1].c_str(), 1), 1);
+
+		if(sArg == "-chains")		glChains = lValue;
+		else if(sArg == "-depth")	glDepth = lValue;
+		else if(sArg == "-moves")	glMovesPerFrame = lValue;
+		else if(sArg == "-frames")	glFrames = lValue;
+	}
+}
+
+//------------------------------------------
+
+double RunFrames(std::vector<cBenchEntity*>& avRoots, std::vector<cBenchEntity*>& avLeaves, bool abEager)
+{
+	iTimer *pTimer = cPlatform::CreateTimer();
+	float fSum = 0;
+
+	pTimer->Start();
+	for(int frame=0; frame<glFrames; ++frame)
+	{
+		////////////////////////////
+		// "Physics", each root moved a few times
+		for(int move=0; move<glMovesPerFrame; ++move)
+		{
+			for(size_t i=0; i<avRoots.size(); ++i)
+			{
+				avRoots[i]->SetPosition(cVector3f((float)frame, (float)move, (float)i));
+				if(abEager) iEntity3D::UpdatePendingTransforms();
+			}
+		}
+
+		////////////////////////////
+		// "Culling", every leaf world position read once
+		iEntity3D::UpdatePendingTransforms();
+		for(size_t i=0; i<avLeaves.size(); ++i)
+		{
+			fSum += avLeaves[i]->GetWorldPosition().x;
+		}
+	}
+	pTimer->Stop();
+
+	double fTime = pTimer->GetTimeInMilliSec();
+	hplDelete(pTimer);
+
+	//Keep the reads from being optimized away
+	if(fSum < 0) printf(" ");
+
+	return fTime;
+}
+
+} // namespace transformbench
+
+//------------------------------------------
+
+int RunTransformBench(const tString &asCommandLine)
+{
+	using namespace transformbench;
+
+	ParseCommandLine(asCommandLine);
+
+	printf("-------- TRANSFORM BENCHMARK STARTED! -----------\n\n");
+	printf(" Chains: %d Depth: %d Moves per frame: %d Frames: %d\n\n", glChains, glDepth, glMovesPerFrame, glFrames);
+
+	////////////////////////////
+	// Build the chains
+	std::vector<cBenchEntity*> vEntities;
+	std::vector<cBenchEntity*> vRoots;
+	std::vector<cBenchEntity*> vLeaves;
+	cBenchCallback callback;
+
+	for(int chain=0; chain<glChains; ++chain)
+	{
+		cBenchEntity *pParent = NULL;
+		for(int depth=0; depth<glDepth; ++depth)
+		{
+			cBenchEntity *pEntity = hplNew( cBenchEntity, ("Entity") );
+			pEntity->SetPosition(cVector3f(0,1,0));
+			pEntity->AddCallback(&callback);
+
+			if(pParent)	pParent->AddChild(pEntity);
+			else		vRoots.push_back(pEntity);
+
+			vEntities.push_back(pEntity);
+			pParent = pEntity;
+		}
+		vLeaves.push_back(pParent);
+	}
+	iEntity3D::UpdatePendingTransforms();
+
+	////////////////////////////
+	// Run
+	double fMoves = (double)glFrames * (double)glMovesPerFrame * (double)glChains;
+	const char* vModeNames[] = {"Eager", "Deferred"};
+	for(int mode=0; mode<2; ++mode)
+	{
+		callback.mlCount = 0;
+		double fTime = RunFrames(vRoots, vLeaves, mode==0);
+
+		printf(" %-8s %9.3f ms total, %7.3f us per moved entity, %7.1f callbacks per frame\n", vModeNames[mode],
+				fTime, fTime * 1000.0 / fMoves, (double)callback.mlCount / (double)glFrames);
+	}
+
+	for(size_t i=0; i<vEntities.size(); ++i) hplDelete(vEntities[i]);
+
+	printf("\n-------- TRANSFORM BENCHMARK DONE! -----------\n");
+
+	return 0;
+}
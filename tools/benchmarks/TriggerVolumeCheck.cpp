@@ -0,0 +1,255 @@
+/*
+ * Copyright © 2009-2020 Frictional Games
+ *
+ * This file is part of Amnesia: The Dark Descent.
+ *
+ * Amnesia: The Dark Descent is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * Amnesia: The Dark Descent is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Amnesia: The Dark Descent.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "hpl.h"
+#include "HplBenchmarks.h"
+#include "system/Timer.h"
+#include "impl/LowLevelPhysicsNewton.h"
+
+using namespace hpl;
+
+namespace triggervolumecheck {
+
+//------------------------------------------
+
+// Moves, disables and destroys some random bodies every step and checks that the overlaps of a
+// cPhysicsTriggerVolume, and the set kept from its enter and exit callbacks, are the same as testing
+// every body in the bounds like the game areas used to. Prints how many bodies were tested each way.
+// Runs without creating the engine.
+// Returns non zero if any step differs.
+
+int glBodies = 400;
+int glSteps = 300;
+int glMovedPercent = 5;
+int glSeed = 1;
+
+//------------------------------------------
+
+class cCheckCallback : public iPhysicsTriggerCallback
+{
+public:
+	cCheckCallback() : mlErrors(0) {}
+
+	bool CheckBody(iPhysicsBody *apBody)
+	{
+		return apBody->GetCollide() && apBody->IsActive();
+	}
+
+	void OnBodyEnter(iPhysicsBody *apBody)
+	{
+		if(m_setInside.insert(apBody).second==false) ++mlErrors;
+	}
+
+	void OnBodyExit(iPhysicsBody *apBody)
+	{
+		if(m_setInside.erase(apBody)==0) ++mlErrors;
+	}
+
+	tPhysicsBodySet m_setInside;
+	int mlErrors;
+};
+
+//------------------------------------------
+
+float RandUnit()
+{
+	return cMath::RandRectf(-1, 1);
+}
+
+iPhysicsBody* CreateRandomBody(iPhysicsWorld *apWorld, int alNum)
+{
+	float fSize = cMath::RandRectf(0.1f, 0.8f);
+	iCollideShape *pShape = NULL;
+	if(cMath::RandRectl(0, 1)==0)	pShape = apWorld->CreateBoxShape(cVector3f(fSize, fSize*2, fSize), NULL);
+	else							pShape = apWorld->CreateSphereShape(cVector3f(fSize), NULL);
+
+	iPhysicsBody *pBody = apWorld->CreateBody("Body"+cString::ToString(alNum), pShape);
+	pBody->SetPosition(cVector3f(RandUnit(), RandUnit(), RandUnit()) * 6.0f);
+	return pBody;
+}
+
+void MoveBody(iPhysicsBody *apBody)
+{
+	cMatrixf mtxTransform = cMath::MatrixRotate(cVector3f(RandUnit(), RandUnit(), RandUnit()) * kPif, eEulerRotationOrder_XYZ);
+	cVector3f vPos = apBody->GetLocalPosition() + cVector3f(RandUnit(), RandUnit(), RandUnit()) * 0.5f;
+	mtxTransform.SetTranslation(cVector3f(	cMath::Clamp(vPos.x, -6.0f, 6.0f),
+											cMath::Clamp(vPos.y, -6.0f, 6.0f),
+											cMath::Clamp(vPos.z, -6.0f, 6.0f)));
+	apBody->SetMatrix(mtxTransform);
+}
+
+//------------------------------------------
+
+void GetOverlapsBruteForce(	iPhysicsWorld *apWorld, iPhysicsBody *apTriggerBody, cCheckCallback *apCallback,
+							cCollideData &aCollideData, tPhysicsBodySet &a_setResult, int &alTested)
+{
+	a_setResult.clear();
+
+	std::vector<iPhysicsBody*> vBodies;
+	apWorld->GetBodiesInBV(apTriggerBody->GetBoundingVolume(), &vBodies);
+
+	for(size_t i=0; i<vBodies.size(); ++i)
+	{
+		iPhysicsBody *pBody = vBodies[i];
+		if(pBody == apTriggerBody) continue;
+
+		++alTested;
+		if(apCallback->CheckBody(pBody)==false) continue;
+		if(cMath::CheckBVIntersection(*pBody->GetBoundingVolume(), *apTriggerBody->GetBoundingVolume())==false) continue;
+
+		if(apWorld->CheckShapeCollision(pBody->GetShape(), pBody->GetLocalMatrix(),
+										apTriggerBody->GetShape(), apTriggerBody->GetLocalMatrix(),
+										aCollideData, 1, false))
+		{
+			a_setResult.insert(pBody);
+		}
+	}
+}
+
+//------------------------------------------
+
+void ParseCommandLine(const tString &asCommandLine)
+{
+	tStringVec args;
+	tString sSepp = " ";
+	cString::GetStringVec(asCommandLine, args,&sSepp);
+
+	for(size_t i=0; i+1<args.size(); i+=2)
+	{
+		const tString &sArg = args[i];
+		int lValue = cMath::Max(cString::ToInt(args[i+1].c_str(), 1), 1);
+
+		if(sArg == "-bodies")		glBodies = lValue;
+		else if(sArg == "-steps")	glSteps = lValue;
+		else if(sArg == "-moved")	glMovedPercent = cMath::Min(lValue, 100);
+		else if(sArg == "-seed")	glSeed = lValue;
+	}
+}
+
+} // namespace triggervolumecheck
+
+//------------------------------------------
+
+int RunTriggerVolumeCheck(const tString &asCommandLine)
+{
+	using namespace triggervolumecheck;
+
+	ParseCommandLine(asCommandLine);
+
+	printf("-------- TRIGGER VOLUME CHECK STARTED! -----------\n\n");
+	printf(" Bodies: %d Steps: %d Moved: %d%% Seed: %d\n\n", glBodies, glSteps, glMovedPercent, glSeed);
+
+	cMath::Randomize(glSeed);
+
+	cLowLevelPhysicsNewton lowLevelPhysics;
+	iPhysicsWorld *pWorld = lowLevelPhysics.CreateWorld();
+
+	////////////////////////////
+	// Trigger and bodies
+	iPhysicsBody *pTriggerBody = pWorld->CreateBody("Trigger", pWorld->CreateBoxShape(cVector3f(5, 3, 5), NULL));
+
+	std::vector<iPhysicsBody*> vBodies;
+	int lBodyCount = 0;
+	for(int i=0; i<glBodies; ++i) vBodies.push_back(CreateRandomBody(pWorld, lBodyCount++));
+
+	cCheckCallback callback;
+	cPhysicsTriggerVolume *pTrigger = pWorld->CreateTriggerVolume(pTriggerBody, &callback);
+
+	////////////////////////////
+	// Run
+	cCollideData collideData;
+	collideData.SetMaxSize(1);
+
+	iTimer *pTimer = cPlatform::CreateTimer();
+	double fTimeBrute = 0;
+	double fTimeTrigger = 0;
+	int lTestedBrute = 0;
+	int lTestedTrigger = 0;
+	size_t lOverlaps = 0;
+	int lMismatches = 0;
+
+	tPhysicsBodySet setExpected;
+	tPhysicsBodySet setOverlaps;
+
+	for(int step=0; step<glSteps; ++step)
+	{
+		////////////////////////////
+		// Change some bodies
+		for(size_t i=0; i<vBodies.size(); ++i)
+		{
+			if(cMath::RandRectl(0, 99) < glMovedPercent) MoveBody(vBodies[i]);
+			if(cMath::RandRectl(0, 499) == 0) vBodies[i]->SetCollide(!vBodies[i]->GetCollide());
+			if(cMath::RandRectl(0, 999) == 0) vBodies[i]->SetActive(!vBodies[i]->IsActive());
+		}
+		if(cMath::RandRectl(0, 9) == 0)
+		{
+			size_t lIdx = (size_t)cMath::RandRectl(0, (int)vBodies.size()-1);
+			//The trigger forgets destroyed bodies without calling exit
+			callback.m_setInside.erase(vBodies[lIdx]);
+			pWorld->DestroyBody(vBodies[lIdx]);
+			vBodies[lIdx] = CreateRandomBody(pWorld, lBodyCount++);
+		}
+		if(step == glSteps/2)
+		{
+			pTriggerBody->SetPosition(cVector3f(1, 0.5f, -1));
+		}
+
+		////////////////////////////
+		// Test
+		pTimer->Start();
+		GetOverlapsBruteForce(pWorld, pTriggerBody, &callback, collideData, setExpected, lTestedBrute);
+		pTimer->Stop();
+		fTimeBrute += pTimer->GetTimeInMilliSec();
+
+		pTimer->Start();
+		pTrigger->Update();
+		pTimer->Stop();
+		fTimeTrigger += pTimer->GetTimeInMilliSec();
+		lTestedTrigger += pTrigger->GetBodiesTested();
+
+		setOverlaps.clear();
+		setOverlaps.insert(pTrigger->GetOverlaps().begin(), pTrigger->GetOverlaps().end());
+		lOverlaps += setOverlaps.size();
+
+		if(setOverlaps != setExpected || callback.m_setInside != setExpected || setOverlaps.size() != pTrigger->GetOverlaps().size())
+		{
+			if(lMismatches < 20)
+			{
+				printf(" MISMATCH step %d: expected %d, overlaps %d, from callbacks %d\n", step, (int)setExpected.size(),
+						(int)pTrigger->GetOverlaps().size(), (int)callback.m_setInside.size());
+			}
+			++lMismatches;
+		}
+	}
+
+	hplDelete(pTimer);
+
+	printf(" %d steps, %.1f bodies inside per step\n", glSteps, (double)lOverlaps / (double)glSteps);
+	printf(" Test all  %9d bodies tested, %9.3f ms total\n", lTestedBrute, fTimeBrute);
+	printf(" Trigger   %9d bodies tested, %9.3f ms total\n", lTestedTrigger, fTimeTrigger);
+	printf(" Mismatches: %d Callback errors: %d\n", lMismatches, callback.mlErrors);
+
+	pWorld->DestroyTriggerVolume(pTrigger);
+	hplDelete(pWorld);
+
+	bool bPassed = lMismatches==0 && callback.mlErrors==0;
+	printf("\n-------- TRIGGER VOLUME CHECK %s! -----------\n", bPassed ? "PASSED" : "FAILED");
+
+	return bPassed ? 0 : 1;
+}
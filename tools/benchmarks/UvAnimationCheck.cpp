@@ -0,0 +1,192 @@
+/*
+ * Copyright © 2009-2020 Frictional Games
+ *
+ * This file is part of Amnesia: The Dark Descent.
+ *
+ * Amnesia: The Dark Descent is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * Amnesia: The Dark Descent is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Amnesia: The Dark Descent.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "hpl.h"
+#include "HplBenchmarks.h"
+#include "system/Timer.h"
+
+using namespace hpl;
+
+namespace uvanimationcheck {
+
+//------------------------------------------
+
+// Creates materials with random uv animations, most of them in the uv plane like water and lava, and updates
+// them each frame the way the renderer does, destroying and creating some as it goes. The uv matrices from the
+// animation table are checked against building them from the full matrices, which is also timed.
+// Runs without creating the engine.
+// Returns non zero if any matrix differs.
+
+int glMaterials = 2000;
+int glFrames = 300;
+int glSeed = 1;
+
+const float gfStepSize = 1.0f / 60.0f;
+const float kfEpsilon = 0.0001f;
+
+//------------------------------------------
+
+class cCheckMaterial
+{
+public:
+	cMaterial *mpMaterial;
+	double mfStartTime;
+};
+
+//------------------------------------------
+
+cCheckMaterial CreateMaterial(int alNum, double afTime)
+{
+	cCheckMaterial material;
+	material.mpMaterial = hplNew( cMaterial, ("check"+cString::ToString(alNum), _W(""), NULL) );
+	material.mfStartTime = afTime;
+
+	int lAnims = cMath::RandRectl(1, 4);
+	for(int i=0; i<lAnims; ++i)
+	{
+		eMaterialUvAnimation type = (eMaterialUvAnimation)cMath::RandRectl(0, eMaterialUvAnimation_LastEnum-1);
+		eMaterialAnimationAxis axis = type==eMaterialUvAnimation_Rotate ? eMaterialAnimationAxis_Z : (eMaterialAnimationAxis)cMath::RandRectl(0, 1);
+		//Some turn the uv plane out of itself, these use the full matrices
+		if(cMath::RandRectl(0, 9)==0) axis = (eMaterialAnimationAxis)cMath::RandRectl(0, eMaterialAnimationAxis_LastEnum-1);
+
+		material.mpMaterial->AddUvAnimation(type, cMath::RandRectf(-2, 2), cMath::RandRectf(0, 2), axis);
+	}
+	return material;
+}
+
+//------------------------------------------
+
+void ParseCommandLine(const tString &asCommandLine)
+{
+	tStringVec args;
+	tString sSepp = " ";
+	cString::GetStringVec(asCommandLine, args,&sSepp);
+
+	for(size_t i=0; i+1<args.size(); i+=2)
+	{
+		const tString &sArg = args[i];
+		int lValue = cMath::Max(cString::ToInt(args[i+1].c_str(), 1), 1);
+
+		if(sArg == "-materials")	glMaterials = lValue;
+		else if(sArg == "-frames")	glFrames = lValue;
+		else if(sArg == "-seed")	glSeed = lValue;
+	}
+}
+
+} // namespace uvanimationcheck
+
+//------------------------------------------
+
+int RunUvAnimationCheck(const tString &asCommandLine)
+{
+	using namespace uvanimationcheck;
+
+	ParseCommandLine(asCommandLine);
+
+	printf("-------- UV ANIMATION CHECK STARTED! -----------\n\n");
+	printf(" Materials: %d Frames: %d Seed: %d\n\n", glMaterials, glFrames, glSeed);
+
+	cMath::Randomize(glSeed);
+
+	double fTime = 0;
+	int lCreated = 0;
+	std::vector<cCheckMaterial> vMaterials;
+	for(int i=0; i<glMaterials; ++i) vMaterials.push_back(CreateMaterial(lCreated++, fTime));
+
+	////////////////////////////
+	// Run
+	iTimer *pTimer = cPlatform::CreateTimer();
+	double fTimeTable = 0;
+	double fTimeMatrices = 0;
+	size_t lChanged = 0;
+	int lMismatches = 0;
+
+	std::vector<cMatrixf> vExpected(vMaterials.size());
+
+	for(int frame=0; frame<glFrames; ++frame)
+	{
+		//Materials are destroyed and created while running, the table is set up again for the next frame
+		if(cMath::RandRectl(0, 9)==0)
+		{
+			size_t lIdx = (size_t)cMath::RandRectl(0, (int)vMaterials.size()-1);
+			hplDelete(vMaterials[lIdx].mpMaterial);
+			vMaterials[lIdx] = CreateMaterial(lCreated++, fTime);
+		}
+
+		////////////////////////////
+		// Update as the render list does, only the first material evaluates the table
+		pTimer->Start();
+		for(size_t i=0; i<vMaterials.size(); ++i)
+		{
+			cMaterial *pMaterial = vMaterials[i].mpMaterial;
+			pMaterial->SetRenderFrameCount(frame);
+			pMaterial->UpdateBeforeRendering(gfStepSize);
+		}
+		pTimer->Stop();
+		fTimeTable += pTimer->GetTimeInMilliSec();
+		lChanged += cMaterialUvAnimationTable::GetChangedNum();
+
+		////////////////////////////
+		// Full matrices, as each material was updated before
+		pTimer->Start();
+		for(size_t i=0; i<vMaterials.size(); ++i)
+		{
+			vExpected[i] = vMaterials[i].mpMaterial->GetUvMatrixAtTime((float)(fTime - vMaterials[i].mfStartTime));
+		}
+		pTimer->Stop();
+		fTimeMatrices += pTimer->GetTimeInMilliSec();
+
+		////////////////////////////
+		// Compare, only the x and y rows are used for the uvs
+		for(size_t i=0; i<vMaterials.size(); ++i)
+		{
+			const cMatrixf &mtxUV = vMaterials[i].mpMaterial->GetUvMatrix();
+			bool bSame = true;
+			for(int row=0; row<2; ++row)
+			{
+				for(int col=0; col<4; ++col)
+				{
+					if(cMath::Abs(mtxUV.m[row][col] - vExpected[i].m[row][col]) > kfEpsilon) bSame = false;
+				}
+			}
+			if(bSame==false)
+			{
+				if(lMismatches < 20) printf(" MISMATCH frame %d: '%s'\n", frame, vMaterials[i].mpMaterial->GetName().c_str());
+				++lMismatches;
+			}
+		}
+
+		fTime += gfStepSize;
+	}
+
+	hplDelete(pTimer);
+
+	printf(" %d materials, %d done in 2D, %.1f changed per frame\n", cMaterialUvAnimationTable::GetMaterialNum(),
+			cMaterialUvAnimationTable::GetPlanarMaterialNum(), (double)lChanged / (double)glFrames);
+	printf(" Animation table  %9.3f ms total, %.4f ms per frame\n", fTimeTable, fTimeTable / (double)glFrames);
+	printf(" Full matrices    %9.3f ms total, %.4f ms per frame\n", fTimeMatrices, fTimeMatrices / (double)glFrames);
+	printf(" Mismatches: %d\n", lMismatches);
+
+	for(size_t i=0; i<vMaterials.size(); ++i) hplDelete(vMaterials[i].mpMaterial);
+
+	bool bPassed = lMismatches==0 && cMaterialUvAnimationTable::GetMaterialNum()==0;
+	printf("\n-------- UV ANIMATION CHECK %s! -----------\n", bPassed ? "PASSED" : "FAILED");
+
+	return bPassed ? 0 : 1;
+}
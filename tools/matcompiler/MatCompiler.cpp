@@ -0,0 +1,225 @@
+/*
+ * Copyright © 2009-2020 Frictional Games
+ *
+ * This file is part of Amnesia: The Dark Descent.
+ *
+ * Amnesia: The Dark Descent is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * Amnesia: The Dark Descent is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Amnesia: The Dark Descent.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "hpl.h"
+#include "system/Timer.h"
+#include "resources/MaterialDatabase.h"
+#include "resources/BinaryBuffer.h"
+
+using namespace hpl;
+
+//------------------------------------------
+
+// Compiles all .mat files in a directory (and its sub directories) into a material database, the file
+// that <MaterialDatabase Path="..."/> in resources.cfg points to. The saved database is then loaded again
+// and every material is checked against parsing the .mat file, and the time for both is printed.
+// Runs without creating the engine.
+// Returns non zero if any material differs.
+
+tWString gsInputDir = _W("");
+tWString gsOutputFile = _W("materials.matdb");
+
+//------------------------------------------
+
+void ParseCommandLine(const tString &asCommandLine)
+{
+	tStringVec args;
+	tString sSepp = " ";
+	cString::GetStringVec(asCommandLine, args,&sSepp);
+
+	bool bCatchNextAsOutput=false;
+
+	for(tStringVecIt it = args.begin(); it != args.end(); ++it)
+	{
+		tString sArg = *it;
+
+		if(bCatchNextAsOutput)
+		{
+			gsOutputFile = cString::To16Char(sArg);
+			bCatchNextAsOutput = false;
+		}
+		else if(sArg == "-out")
+		{
+			bCatchNextAsOutput = true;
+		}
+		else
+		{
+			gsInputDir = cString::To16Char(sArg);
+		}
+	}
+
+	gsInputDir = cString::RemoveSlashAtEndW(cString::ReplaceCharToW(gsInputDir, _W("\\"), _W("/")));
+}
+
+//------------------------------------------
+
+bool SameMaterial(const cCompiledMaterial &aA, const cCompiledMaterial &aB)
+{
+	if(	aA.mID != aB.mID || aA.msType != aB.msType || aA.mbDepthTest != aB.mbDepthTest ||
+		aA.msPhysicsMaterial != aB.msPhysicsMaterial || aA.mbHasTextureUnits != aB.mbHasTextureUnits)
+	{
+		return false;
+	}
+
+	if(aA.mvTextures.size() != aB.mvTextures.size()) return false;
+	for(size_t i=0; i<aA.mvTextures.size(); ++i)
+	{
+		const cCompiledMaterialTexture &texA = aA.mvTextures[i];
+		const cCompiledMaterialTexture &texB = aB.mvTextures[i];
+		if(	texA.mUnit != texB.mUnit || texA.msFile != texB.msFile || texA.mType != texB.mType || texA.mWrap != texB.mWrap ||
+			texA.mAnimMode != texB.mAnimMode || texA.mbMipMaps != texB.mbMipMaps || texA.mbCompress != texB.mbCompress ||
+			texA.mfFrameTime != texB.mfFrameTime)
+		{
+			return false;
+		}
+	}
+
+	if(aA.mvUvAnimations.size() != aB.mvUvAnimations.size()) return false;
+	for(size_t i=0; i<aA.mvUvAnimations.size(); ++i)
+	{
+		const cMaterialUvAnimation &animA = aA.mvUvAnimations[i];
+		const cMaterialUvAnimation &animB = aB.mvUvAnimations[i];
+		if(animA.mType != animB.mType || animA.mfSpeed != animB.mfSpeed || animA.mfAmp != animB.mfAmp || animA.mAxis != animB.mAxis)
+			return false;
+	}
+
+	//Both are cleared before they are filled in, so the unused bytes match as well
+	return memcmp(&aA.mDescriptor, &aB.mDescriptor, sizeof(ShaderMaterialData))==0;
+}
+
+//------------------------------------------
+
+#ifdef WIN32
+	#include <Windows.h>
+
+#endif
+
+#ifdef WIN32
+	int main(int argc, const char* argv[] )
+	{
+		tString asCommandLine;
+		for(int i=1; i<argc; ++i)
+		{
+			asCommandLine += argv[i];
+			if(i!=argc-1) asCommandLine += " ";
+		}
+
+#else
+	int hplMain(const tString &asCommandLine)
+	{
+#endif
+
+	ParseCommandLine(asCommandLine);
+
+	printf("-------- MATERIAL COMPILING STARTED! -----------\n\n");
+
+	if(gsInputDir == _W("") || cPlatform::FolderExists(gsInputDir)==false)
+	{
+		printf("No valid directory specified!\n");
+		printf("\n-------- MATERIAL COMPILING FAILED! -----------\n");
+		return 1;
+	}
+
+	cFileSearcher fileSearcher;
+	fileSearcher.AddDirectory(gsInputDir, "*.mat", true);
+
+	tWStringVec vFiles;
+	fileSearcher.GetFilesWithExt(vFiles, "mat");
+
+	iTimer *pTimer = cPlatform::CreateTimer();
+
+	////////////////////////////
+	// Compile and save
+	cMaterialDatabase database;
+	database.Load(gsOutputFile);
+
+	cCompiledMaterial material;
+	int lFailed = 0;
+
+	pTimer->Start();
+	for(size_t i=0; i<vFiles.size(); ++i)
+	{
+		if(database.GetMaterial(vFiles[i], material)==false)
+		{
+			printf(" Could not compile '%s'\n", cString::To8Char(vFiles[i]).c_str());
+			++lFailed;
+		}
+	}
+	pTimer->Stop();
+	printf(" %d materials, %d compiled, %d up to date, %d failed in %.1f ms\n", (int)vFiles.size(),
+			database.GetCompiled(), database.GetHits(), lFailed, pTimer->GetTimeInMilliSec());
+
+	if(database.IsChanged() && database.Save(gsOutputFile)==false)
+	{
+		printf(" Could not save '%s'\n", cString::To8Char(gsOutputFile).c_str());
+	}
+
+	////////////////////////////
+	// Load again and compare with the .mat files
+	cMaterialDatabase loadedDatabase;
+	loadedDatabase.Load(gsOutputFile);
+
+	double fTimeParse = 0;
+	double fTimeLookup = 0;
+	int lMismatches = 0;
+
+	cCompiledMaterial parsedMaterial;
+	for(size_t i=0; i<vFiles.size(); ++i)
+	{
+		pTimer->Start();
+		cBinaryBuffer fileBuff;
+		bool bParsed = fileBuff.Load(vFiles[i]) &&
+						cMaterialDatabase::Compile(fileBuff.GetDataPointer(), fileBuff.GetSize(), vFiles[i], parsedMaterial);
+		pTimer->Stop();
+		fTimeParse += pTimer->GetTimeInMilliSec();
+
+		pTimer->Start();
+		bool bFound = loadedDatabase.GetMaterial(vFiles[i], material);
+		pTimer->Stop();
+		fTimeLookup += pTimer->GetTimeInMilliSec();
+
+		if(bParsed != bFound || (bParsed && SameMaterial(parsedMaterial, material)==false))
+		{
+			if(lMismatches < 20) printf(" MISMATCH '%s'\n", cString::To8Char(vFiles[i]).c_str());
+			++lMismatches;
+		}
+	}
+
+	hplDelete(pTimer);
+
+	printf(" Parse .mat files  %9.3f ms total\n", fTimeParse);
+	printf(" Database lookup   %9.3f ms total, %d compiled again\n", fTimeLookup, loadedDatabase.GetCompiled());
+	printf(" Mismatches: %d\n", lMismatches);
+
+	bool bPassed = lMismatches==0 && loadedDatabase.GetCompiled()==0;
+	printf("\n-------- MATERIAL COMPILING %s! -----------\n", bPassed ? "DONE" : "FAILED");
+
+	return bPassed ? 0 : 1;
+}
+
+#ifdef WIN32
+	int hplMain(const tString &asCommandLine){return -1;}
+#endif
+
+#ifdef __APPLE__
+extern "C" int SDL_main(int argc, char *argv[]);
+int main(int argc, char * argv[]) {
+    return SDL_main(argc, argv);
+}
+#endif
@@ -22,6 +22,7 @@
 #include "impl/MeshLoaderMSH.h"
 #include "impl/MeshLoaderCollada.h"
 #include "resources/WorldLoaderHplMap.h"
+#include "graphics/MeshUtility.h"
 
 
 using namespace hpl;
@@ -38,6 +39,8 @@ bool gbDirs_SubDirs = false;
 int glFileType = 0;		//0 = model, 1=anim, 2=map
 tWString gsFilePath = _W("");
 bool gbForce = false;
+bool gbOptimize = true;
+bool gbStats = false;
 
 //Was messy to get working, skipping:
 bool gbGenerateAIPaths=false;
@@ -59,6 +62,33 @@ public:
 };
 std::vector<cPathNodeData> gvPathNodeData;
 
+//------------------------------------------
+
+class cMeshStats
+{
+public:
+	cMeshStats() : mlVertices(0), mlTriangles(0), mfTransformed(0), mfFetched(0), mlFloatBytes(0) {}
+
+	void Add(const cMeshStats& aStats)
+	{
+		mlVertices += aStats.mlVertices;
+		mlTriangles += aStats.mlTriangles;
+		mfTransformed += aStats.mfTransformed;
+		mfFetched += aStats.mfFetched;
+		mlFloatBytes += aStats.mlFloatBytes;
+	}
+
+	size_t mlVertices;
+	size_t mlTriangles;
+	double mfTransformed;	//Vertices transformed with a 16 entry FIFO cache
+	double mfFetched;		//Vertex bytes read
+	size_t mlFloatBytes;
+};
+
+cMeshStats gStatsBefore;
+cMeshStats gStatsAfter;
+MeshUtility::QuantizationStats gMaxQuantizationError;
+
 //--------------------------------------------------------------------------------
 
 
@@ -151,6 +181,18 @@ void ParseCommandLine(const tString &asCommandLine)
 		{
 			gbForce = true;
 		}
+		//////////////////////////////
+		// Keep the vertex and index order of the source file
+		else if(sArg == "-nooptimize")
+		{
+			gbOptimize = false;
+		}
+		//////////////////////////////
+		// Print vertex cache, fetch and memory stats for meshes
+		else if(sArg == "-stats")
+		{
+			gbStats = true;
+		}
 		/*else if(sArg == "-pathnodesetup")
 		{
 			gbGenerateAIPaths = true;
@@ -219,6 +261,102 @@ void GenerateAIPaths(cWorld *apWorld)
 
 //------------------------------------------
 
+cSubMesh::StreamBufferInfo* FindStream(cSubMesh *apSubMesh, ShaderSemantic aSemantic)
+{
+	for(auto& stream : apSubMesh->streamBuffers())
+	{
+		if(stream.m_semantic == aSemantic) return &stream;
+	}
+	return NULL;
+}
+
+//------------------------------------------
+
+cMeshStats GetSubMeshStats(cSubMesh *apSubMesh)
+{
+	cMeshStats stats;
+	cSubMesh::StreamBufferInfo *pPosStream = FindStream(apSubMesh, ShaderSemantic::SEMANTIC_POSITION);
+	if(pPosStream == NULL) return stats;
+
+	uint32_t lVertexNum = pPosStream->m_numberElements;
+	uint32_t lIndexNum = apSubMesh->IndexStream().m_numberElements;
+	auto index = apSubMesh->IndexStream().GetView();
+
+	uint32_t lVertexSize = 0;
+	for(auto& stream : apSubMesh->streamBuffers()) lVertexSize += stream.m_stride;
+
+	////////////////////////////
+	// Vertex cache and fetch
+	MeshUtility::VertexCacheStats cacheStats = MeshUtility::AnalyzeVertexCache(lVertexNum, lIndexNum, &index);
+	float fOverfetch = MeshUtility::AnalyzeVertexFetch(lVertexNum, lIndexNum, &index, lVertexSize);
+
+	stats.mlVertices = lVertexNum;
+	stats.mlTriangles = lIndexNum/3;
+	stats.mfTransformed = (double)cacheStats.acmr * (double)stats.mlTriangles;
+	double fUsedVertices = cacheStats.atvr > 0 ? stats.mfTransformed / (double)cacheStats.atvr : 0;
+	stats.mfFetched = (double)fOverfetch * fUsedVertices * (double)lVertexSize;
+
+	stats.mlFloatBytes = (size_t)lVertexNum * lVertexSize + (size_t)lIndexNum * sizeof(uint32_t);
+
+	////////////////////////////
+	// Error if the streams were quantized, nothing is quantized yet
+	cSubMesh::StreamBufferInfo *pNormalStream = FindStream(apSubMesh, ShaderSemantic::SEMANTIC_NORMAL);
+	cSubMesh::StreamBufferInfo *pTangentStream = FindStream(apSubMesh, ShaderSemantic::SEMANTIC_TANGENT);
+	cSubMesh::StreamBufferInfo *pUVStream = FindStream(apSubMesh, ShaderSemantic::SEMANTIC_TEXCOORD0);
+
+	GraphicsBuffer::BufferStructuredView<float3> position = pPosStream->GetStructuredView<float3>();
+	GraphicsBuffer::BufferStructuredView<float3> normal, tangent;
+	GraphicsBuffer::BufferStructuredView<float2> uv;
+	if(pNormalStream) normal = pNormalStream->GetStructuredView<float3>();
+	if(pTangentStream) tangent = pTangentStream->GetStructuredView<float3>();
+	if(pUVStream) uv = pUVStream->GetStructuredView<float2>();
+
+	MeshUtility::QuantizationStats quantStats = MeshUtility::AnalyzeQuantization(lVertexNum, &position,
+		pNormalStream ? &normal : NULL, pTangentStream ? &tangent : NULL, pUVStream ? &uv : NULL);
+
+	gMaxQuantizationError.maxPositionError = cMath::Max(gMaxQuantizationError.maxPositionError, quantStats.maxPositionError);
+	gMaxQuantizationError.maxNormalError = cMath::Max(gMaxQuantizationError.maxNormalError, quantStats.maxNormalError);
+	gMaxQuantizationError.maxTangentError = cMath::Max(gMaxQuantizationError.maxTangentError, quantStats.maxTangentError);
+	gMaxQuantizationError.maxUVError = cMath::Max(gMaxQuantizationError.maxUVError, quantStats.maxUVError);
+
+	return stats;
+}
+
+//------------------------------------------
+
+void PrintStats(const char *asName, const cMeshStats& aStats)
+{
+	double fTriangles = (double)cMath::Max((int)aStats.mlTriangles, 1);
+	double fVertices = (double)cMath::Max((int)aStats.mlVertices, 1);
+	printf("   %-7s ACMR: %.3f ATVR: %.3f Fetched: %.2f KB Memory: %.2f KB\n", asName,
+			aStats.mfTransformed / fTriangles, aStats.mfTransformed / fVertices, aStats.mfFetched / 1024.0,
+			(double)aStats.mlFloatBytes / 1024.0);
+}
+
+//------------------------------------------
+
+void OptimizeMesh(cMesh *apMesh)
+{
+	cMeshStats before, after;
+	for(int i=0; i<apMesh->GetSubMeshNum(); ++i)
+	{
+		cSubMesh *pSubMesh = apMesh->GetSubMesh(i);
+		if(gbStats) before.Add(GetSubMeshStats(pSubMesh));
+		if(gbOptimize) pSubMesh->OptimizeVertexOrder();
+		if(gbStats) after.Add(GetSubMeshStats(pSubMesh));
+	}
+
+	if(gbStats == false) return;
+
+	printf("\n");
+	PrintStats("Before", before);
+	PrintStats("After", after);
+	gStatsBefore.Add(before);
+	gStatsAfter.Add(after);
+}
+
+//------------------------------------------
+
 bool ConvertFile(const tWString &asFile)
 {
 	//Check so file exists
@@ -294,6 +432,7 @@ bool ConvertFile(const tWString &asFile)
 	{
 		cMesh *pMesh = gpMeshLoaderCollada->LoadMesh(asFile,eMeshLoadFlag_NoMaterial);
 		if(pMesh)	{
+			OptimizeMesh(pMesh);
 			gpMeshLoaderMSH->SaveMesh(pMesh, sMSHPath);
 			hplDelete(pMesh);
 		}
@@ -425,6 +564,10 @@ void Init()
 	if(glFileType != 2)
 		gpMeshLoaderCollada->SetLoadAndSaveMSHFormat(false);
 
+	//Meshes are optimized after loading, so stats can be taken before and after
+	if(glFileType == 0)
+		gpMeshLoaderCollada->SetOptimizeVertexOrder(false);
+
 	if(gbGenerateAIPaths)
 		LoadPathNodeDataFile(gsPathNodeSetupFile);
 }
@@ -474,6 +617,16 @@ void Exit()
 	if(gbDirs)	ConvertInDirs();
 	else		ConvertFile();
 
+	if(gbStats && gStatsBefore.mlTriangles > 0)
+	{
+		printf("\n Total: %zu vertices %zu triangles\n", gStatsAfter.mlVertices, gStatsAfter.mlTriangles);
+		PrintStats("Before", gStatsBefore);
+		PrintStats("After", gStatsAfter);
+		printf("   Max quantization error, position: %f normal: %.4f deg tangent: %.4f deg uv: %f\n",
+				gMaxQuantizationError.maxPositionError, gMaxQuantizationError.maxNormalError,
+				gMaxQuantizationError.maxTangentError, gMaxQuantizationError.maxUVError);
+	}
+
 	printf("\n-------- MSH CONVERSION DONE! -----------\n");
 
 	Exit();
@@ -0,0 +1,215 @@
+#include "TexCompress.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+//------------------------------------------
+
+static inline uint16_t ToRGB565(const int *avColor)
+{
+	return (uint16_t)(((avColor[0] >> 3) << 11) | ((avColor[1] >> 2) << 5) | (avColor[2] >> 3));
+}
+
+static inline void FromRGB565(uint16_t alColor, int *avColor)
+{
+	int lR = (alColor >> 11) & 31;
+	int lG = (alColor >> 5) & 63;
+	int lB = alColor & 31;
+	avColor[0] = (lR << 3) | (lR >> 2);
+	avColor[1] = (lG << 2) | (lG >> 4);
+	avColor[2] = (lB << 3) | (lB >> 2);
+}
+
+//------------------------------------------
+
+int GetCompressedBlockSize(bool abAlpha)
+{
+	return abAlpha ? 16 : 8;
+}
+
+int GetCompressedImageSize(int alWidth, int alHeight, bool abAlpha)
+{
+	return std::max(1, (alWidth+3)/4) * std::max(1, (alHeight+3)/4) * GetCompressedBlockSize(abAlpha);
+}
+
+//------------------------------------------
+
+void CompressBlockBC1(const unsigned char *apBlockRGBA, unsigned char *apDest)
+{
+	////////////////////////////
+	// Bounding box of the colors, inset by 1/16 to reduce the error from the extremes
+	int vMin[3] = {255,255,255};
+	int vMax[3] = {0,0,0};
+	for(int i=0; i<16; ++i)
+	{
+		for(int c=0; c<3; ++c)
+		{
+			vMin[c] = std::min(vMin[c], (int)apBlockRGBA[i*4+c]);
+			vMax[c] = std::max(vMax[c], (int)apBlockRGBA[i*4+c]);
+		}
+	}
+	for(int c=0; c<3; ++c)
+	{
+		int lInset = (vMax[c] - vMin[c]) >> 4;
+		vMin[c] = std::min(255, vMin[c] + lInset);
+		vMax[c] = std::max(0, vMax[c] - lInset);
+	}
+
+	uint16_t lColor0 = ToRGB565(vMax);
+	uint16_t lColor1 = ToRGB565(vMin);
+
+	uint32_t lIndices = 0;
+	if(lColor0 != lColor1)
+	{
+		//Color0 must be the larger one for the four color mode
+		if(lColor0 < lColor1) std::swap(lColor0, lColor1);
+
+		////////////////////////////
+		// Build the palette and pick the closest entry for every pixel
+		int vPalette[4][3];
+		FromRGB565(lColor0, vPalette[0]);
+		FromRGB565(lColor1, vPalette[1]);
+		for(int c=0; c<3; ++c)
+		{
+			vPalette[2][c] = (2*vPalette[0][c] + vPalette[1][c]) / 3;
+			vPalette[3][c] = (vPalette[0][c] + 2*vPalette[1][c]) / 3;
+		}
+
+		for(int i=0; i<16; ++i)
+		{
+			int lBestIndex = 0;
+			int lBestDist = 0x7fffffff;
+			for(int p=0; p<4; ++p)
+			{
+				int lDR = (int)apBlockRGBA[i*4+0] - vPalette[p][0];
+				int lDG = (int)apBlockRGBA[i*4+1] - vPalette[p][1];
+				int lDB = (int)apBlockRGBA[i*4+2] - vPalette[p][2];
+				int lDist = lDR*lDR + lDG*lDG + lDB*lDB;
+				if(lDist < lBestDist)
+				{
+					lBestDist = lDist;
+					lBestIndex = p;
+				}
+			}
+			lIndices |= (uint32_t)lBestIndex << (i*2);
+		}
+	}
+
+	apDest[0] = (unsigned char)(lColor0 & 0xff);
+	apDest[1] = (unsigned char)(lColor0 >> 8);
+	apDest[2] = (unsigned char)(lColor1 & 0xff);
+	apDest[3] = (unsigned char)(lColor1 >> 8);
+	for(int i=0; i<4; ++i) apDest[4+i] = (unsigned char)((lIndices >> (i*8)) & 0xff);
+}
+
+//------------------------------------------
+
+static void CompressAlphaBlock(const unsigned char *apBlockRGBA, unsigned char *apDest)
+{
+	int lMin = 255;
+	int lMax = 0;
+	for(int i=0; i<16; ++i)
+	{
+		lMin = std::min(lMin, (int)apBlockRGBA[i*4+3]);
+		lMax = std::max(lMax, (int)apBlockRGBA[i*4+3]);
+	}
+
+	uint64_t lIndices = 0;
+	if(lMax != lMin)
+	{
+		////////////////////////////
+		// Eight alpha mode, alpha0 > alpha1
+		int vPalette[8];
+		vPalette[0] = lMax;
+		vPalette[1] = lMin;
+		for(int p=1; p<7; ++p)
+		{
+			vPalette[p+1] = ((7-p)*lMax + p*lMin) / 7;
+		}
+
+		for(int i=0; i<16; ++i)
+		{
+			int lAlpha = apBlockRGBA[i*4+3];
+			int lBestIndex = 0;
+			int lBestDist = 256;
+			for(int p=0; p<8; ++p)
+			{
+				int lDist = std::abs(lAlpha - vPalette[p]);
+				if(lDist < lBestDist)
+				{
+					lBestDist = lDist;
+					lBestIndex = p;
+				}
+			}
+			lIndices |= (uint64_t)lBestIndex << (i*3);
+		}
+	}
+
+	apDest[0] = (unsigned char)lMax;
+	apDest[1] = (unsigned char)lMin;
+	for(int i=0; i<6; ++i) apDest[2+i] = (unsigned char)((lIndices >> (i*8)) & 0xff);
+}
+
+void CompressBlockBC3(const unsigned char *apBlockRGBA, unsigned char *apDest)
+{
+	CompressAlphaBlock(apBlockRGBA, apDest);
+	CompressBlockBC1(apBlockRGBA, apDest + 8);
+}
+
+//------------------------------------------
+
+void CompressImage(const unsigned char *apRGBA, int alWidth, int alHeight, bool abAlpha, unsigned char *apDest)
+{
+	int lBlocksX = std::max(1, (alWidth+3)/4);
+	int lBlocksY = std::max(1, (alHeight+3)/4);
+	int lBlockSize = GetCompressedBlockSize(abAlpha);
+
+	unsigned char vBlock[16*4];
+	for(int by=0; by<lBlocksY; ++by)
+	for(int bx=0; bx<lBlocksX; ++bx)
+	{
+		//Gather the block, clamping at the edges
+		for(int y=0; y<4; ++y)
+		{
+			int lY = std::min(by*4 + y, alHeight-1);
+			for(int x=0; x<4; ++x)
+			{
+				int lX = std::min(bx*4 + x, alWidth-1);
+				memcpy(&vBlock[(y*4+x)*4], &apRGBA[(lY*alWidth + lX)*4], 4);
+			}
+		}
+
+		unsigned char *pDest = apDest + (by*lBlocksX + bx) * lBlockSize;
+		if(abAlpha)	CompressBlockBC3(vBlock, pDest);
+		else		CompressBlockBC1(vBlock, pDest);
+	}
+}
+
+//------------------------------------------
+
+void DownsampleImage(const unsigned char *apSrcRGBA, int alSrcWidth, int alSrcHeight, unsigned char *apDestRGBA)
+{
+	int lDestWidth = std::max(1, alSrcWidth/2);
+	int lDestHeight = std::max(1, alSrcHeight/2);
+
+	for(int y=0; y<lDestHeight; ++y)
+	{
+		int lY0 = std::min(y*2, alSrcHeight-1);
+		int lY1 = std::min(y*2+1, alSrcHeight-1);
+		for(int x=0; x<lDestWidth; ++x)
+		{
+			int lX0 = std::min(x*2, alSrcWidth-1);
+			int lX1 = std::min(x*2+1, alSrcWidth-1);
+			for(int c=0; c<4; ++c)
+			{
+				int lSum =	apSrcRGBA[(lY0*alSrcWidth + lX0)*4 + c] + apSrcRGBA[(lY0*alSrcWidth + lX1)*4 + c] +
+							apSrcRGBA[(lY1*alSrcWidth + lX0)*4 + c] + apSrcRGBA[(lY1*alSrcWidth + lX1)*4 + c];
+				apDestRGBA[(y*lDestWidth + x)*4 + c] = (unsigned char)((lSum + 2) / 4);
+			}
+		}
+	}
+}
+
+//------------------------------------------
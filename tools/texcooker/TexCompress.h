@@ -0,0 +1,32 @@
+#ifndef TEX_COMPRESS_H
+#define TEX_COMPRESS_H
+
+//------------------------------------------
+
+// Block compression of RGBA8 images into BC1 (DXT1) and BC3 (DXT5).
+// The encoder uses the bounding box of each block inset slightly towards the center as endpoints,
+// it is fast enough to run over a whole resource tree and works on one block at a time so images can
+// be split between threads freely.
+
+//------------------------------------------
+
+int GetCompressedBlockSize(bool abAlpha);
+int GetCompressedImageSize(int alWidth, int alHeight, bool abAlpha);
+
+void CompressBlockBC1(const unsigned char *apBlockRGBA, unsigned char *apDest);
+void CompressBlockBC3(const unsigned char *apBlockRGBA, unsigned char *apDest);
+
+/**
+ * Compresses a full RGBA8 image. Blocks that go past the edge of the image (mipmaps smaller than 4x4)
+ * repeat the last row and column.
+ */
+void CompressImage(const unsigned char *apRGBA, int alWidth, int alHeight, bool abAlpha, unsigned char *apDest);
+
+/**
+ * Creates the next mipmap level with a 2x2 box filter. Odd sizes repeat the last row and column.
+ */
+void DownsampleImage(const unsigned char *apSrcRGBA, int alSrcWidth, int alSrcHeight, unsigned char *apDestRGBA);
+
+//------------------------------------------
+
+#endif // TEX_COMPRESS_H
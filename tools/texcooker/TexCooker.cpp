@@ -0,0 +1,739 @@
+/*
+ * Copyright © 2009-2020 Frictional Games
+ *
+ * This file is part of Amnesia: The Dark Descent.
+ *
+ * Amnesia: The Dark Descent is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * Amnesia: The Dark Descent is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Amnesia: The Dark Descent.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "hpl.h"
+#include "system/JobPool.h"
+#include "system/Timer.h"
+
+#include "TexCompress.h"
+
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <set>
+
+using namespace hpl;
+
+cEngine *gpEngine=NULL;
+
+//------------------------------------------
+
+tWString gsInputDir = _W("");
+tWString gsOutputDir = _W("_cooked");
+bool gbForce = false;
+
+tWString gsManifestFile = _W("cooked_textures.xml");
+tWString gsReportFile = _W("cook_report.txt");
+
+//------------------------------------------
+
+class cCookFile
+{
+public:
+	tWString msName;		// Relative to the asset root, the input dir
+	tWString msSource;		// Relative to the working dir
+	tWString msCooked;		// Relative to the working dir
+
+	bool mbCooked;
+	bool mbSkipped;
+	tString msSkipReason;
+
+	cVector2l mvSize;
+	bool mbAlpha;
+	int mlNumOfMipMaps;
+
+	unsigned long mlSourceDiskSize;
+	unsigned long mlCookedDiskSize;
+	unsigned long mlSourceMemSize;	// RGBA8 with the mip chain the old load path generated
+	unsigned long mlCookedMemSize;
+
+	float mfSourceLoadTime;			// Milliseconds to load the bitmap, not counting mip generation
+	float mfCookedLoadTime;
+};
+
+//------------------------------------------
+
+class cCookMap
+{
+public:
+	tWString msFile;
+	std::vector<size_t> mvTextures;	// Indices into gvFiles
+};
+
+//------------------------------------------
+
+std::vector<cCookFile> gvFiles;
+std::vector<cCookMap> gvMaps;
+
+//Every file in the input dir by lower case name, the same lookup the file searcher does at runtime
+std::map<tString, tWString> gmapFilesByName;
+//Cookable files by lower case name without extension, materials can refer to a texture with another extension
+std::map<tString, size_t> gmapTexturesByName;
+std::mutex gPrintMutex;
+
+//------------------------------------------
+
+static const char* gvCubeSideSuffixes[] = {"_pos_x", "_neg_x", "_pos_y", "_neg_y", "_pos_z", "_neg_z"};
+
+//------------------------------------------
+
+void ParseCommandLine(const tString &asCommandLine)
+{
+	tStringVec args;
+	tString sSepp = " ";
+	cString::GetStringVec(asCommandLine, args,&sSepp);
+
+	bool bCatchNextAsOutput=false;
+
+	for(tStringVecIt it = args.begin(); it != args.end(); ++it)
+	{
+		tString sArg = *it;
+
+		//////////////////////////////
+		// Catch the output dir
+		if(bCatchNextAsOutput)
+		{
+			gsOutputDir = cString::To16Char(sArg);
+			bCatchNextAsOutput = false;
+		}
+		else if(sArg == "-out")
+		{
+			bCatchNextAsOutput = true;
+		}
+		else if(sArg == "-force")
+		{
+			gbForce = true;
+		}
+		//////////////////////////////
+		// The directory to cook
+		else
+		{
+			gsInputDir = cString::To16Char(sArg);
+		}
+	}
+
+	gsInputDir = cString::RemoveSlashAtEndW(cString::ReplaceCharToW(gsInputDir, _W("\\"), _W("/")));
+	gsOutputDir = cString::RemoveSlashAtEndW(cString::ReplaceCharToW(gsOutputDir, _W("\\"), _W("/")));
+}
+
+//------------------------------------------
+
+bool IsCookableFile(const tWString &asFile)
+{
+	tWString sExt = cString::ToLowerCaseW(cString::GetFileExtW(asFile));
+	return sExt == _W("tga") || sExt == _W("png") || sExt == _W("jpg") || sExt == _W("jpeg") ||
+			sExt == _W("bmp") || sExt == _W("tif") || sExt == _W("tiff");
+}
+
+bool IsCubeMapFace(const tWString &asFile)
+{
+	//Cube faces are put together at load time and must keep their original data
+	tString sName = cString::ToLowerCase(cString::To8Char(cString::SetFileExtW(cString::GetFileNameW(asFile), _W(""))));
+	for(int i=0; i<6; ++i)
+	{
+		tString sSuffix = gvCubeSideSuffixes[i];
+		if(sName.size() > sSuffix.size() && sName.compare(sName.size() - sSuffix.size(), sSuffix.size(), sSuffix)==0) return true;
+	}
+	return false;
+}
+
+//------------------------------------------
+
+void CollectFilesInDir(const tWString &asDir, const tWString &asRelativeDir)
+{
+	tWStringList lstFiles;
+	cPlatform::FindFilesInDir(lstFiles, asDir, _W("*.*"));
+
+	for(tWStringListIt it = lstFiles.begin(); it != lstFiles.end(); ++it)
+	{
+		tString sName = cString::ToLowerCase(cString::To8Char(*it));
+		gmapFilesByName.insert(std::pair<tString, tWString>(sName, cString::SetFilePathW(*it, asDir)));
+
+		if(cString::GetFileExt(sName) == "map")
+		{
+			cCookMap map;
+			map.msFile = cString::SetFilePathW(*it, asDir);
+			gvMaps.push_back(map);
+			continue;
+		}
+		if(IsCookableFile(*it)==false) continue;
+
+		gmapTexturesByName.insert(std::pair<tString, size_t>(cString::SetFileExt(sName, ""), gvFiles.size()));
+
+		cCookFile file;
+		file.msName = asRelativeDir == _W("") ? *it : asRelativeDir + _W("/") + *it;
+		file.msSource = cString::SetFilePathW(*it, asDir);
+		file.msCooked = gsOutputDir + _W("/") + cString::SetFileExtW(file.msName, _W("dds"));
+		file.mbCooked = false;
+		file.mbSkipped = false;
+		file.mvSize = 0;
+		file.mbAlpha = false;
+		file.mlNumOfMipMaps = 0;
+		file.mlSourceDiskSize = cPlatform::GetFileSize(file.msSource);
+		file.mlCookedDiskSize = 0;
+		file.mlSourceMemSize = 0;
+		file.mlCookedMemSize = 0;
+		file.mfSourceLoadTime = 0;
+		file.mfCookedLoadTime = 0;
+		gvFiles.push_back(file);
+	}
+
+	tWStringList lstFolders;
+	cPlatform::FindFoldersInDir(lstFolders, asDir, false);
+	for(tWStringListIt it = lstFolders.begin(); it != lstFolders.end(); ++it)
+	{
+		tWString sRelativeDir = asRelativeDir == _W("") ? *it : asRelativeDir + _W("/") + *it;
+		CollectFilesInDir(cString::SetFilePathW(*it, asDir), sRelativeDir);
+	}
+}
+
+//------------------------------------------
+
+void CreateFolders(const tWString &asPath)
+{
+	tWStringVec vDirs;
+	tWString sSepp = _W("/");
+	cString::GetStringVecW(asPath, vDirs, &sSepp);
+
+	tWString sPath = _W("");
+	for(size_t i=0; i<vDirs.size(); ++i)
+	{
+		sPath += vDirs[i];
+		if(cPlatform::FolderExists(sPath)==false) cPlatform::CreateFolder(sPath);
+		sPath += _W("/");
+	}
+}
+
+//------------------------------------------
+
+unsigned long GetMipChainMemSize(int alWidth, int alHeight, int alBpp)
+{
+	unsigned long lSize = 0;
+	while(true)
+	{
+		lSize += (unsigned long)(alWidth * alHeight * alBpp);
+		if(alWidth == 1 && alHeight == 1) break;
+		alWidth = std::max(1, alWidth/2);
+		alHeight = std::max(1, alHeight/2);
+	}
+	return lSize;
+}
+
+//------------------------------------------
+
+/**
+ * Converts the first image of the bitmap to tightly packed RGBA8. Returns false if the format is not
+ * one that is worth cooking.
+ */
+bool GetRGBAData(cBitmap *apBitmap, std::vector<unsigned char> &avDest, bool &abHasAlpha)
+{
+	ePixelFormat format = apBitmap->GetPixelFormat();
+	int lBpp = 0;
+	bool bSwapRB = false;
+	switch(format)
+	{
+	case ePixelFormat_RGB:	lBpp = 3; break;
+	case ePixelFormat_BGR:	lBpp = 3; bSwapRB = true; break;
+	case ePixelFormat_RGBA:	lBpp = 4; break;
+	case ePixelFormat_BGRA:	lBpp = 4; bSwapRB = true; break;
+	default: return false;
+	}
+
+	int lNumOfPixels = apBitmap->GetWidth() * apBitmap->GetHeight();
+	const unsigned char *pSrc = apBitmap->GetData(0,0)->mpData;
+	avDest.resize(lNumOfPixels * 4);
+
+	abHasAlpha = false;
+	for(int i=0; i<lNumOfPixels; ++i)
+	{
+		const unsigned char *pPixel = &pSrc[i*lBpp];
+		unsigned char *pDest = &avDest[i*4];
+		pDest[0] = pPixel[bSwapRB ? 2 : 0];
+		pDest[1] = pPixel[1];
+		pDest[2] = pPixel[bSwapRB ? 0 : 2];
+		pDest[3] = lBpp == 4 ? pPixel[3] : 255;
+		if(pDest[3] != 255) abHasAlpha = true;
+	}
+
+	return true;
+}
+
+//------------------------------------------
+
+bool WriteDDS(const tWString &asFile, int alWidth, int alHeight, bool abAlpha, const std::vector<std::vector<unsigned char> > &avMipMaps)
+{
+	FILE *pFile = cPlatform::OpenFile(asFile, _W("wb"));
+	if(pFile==NULL) return false;
+
+	//Header is 31 words after the magic number, see BitmapLoaderDDS.cpp for the layout.
+	uint32_t vHeader[31];
+	memset(vHeader, 0, sizeof(vHeader));
+	vHeader[0] = 124;
+	vHeader[1] = 0x1 | 0x2 | 0x4 | 0x1000 | 0x20000 | 0x80000;	//Caps, height, width, pixelformat, mipmapcount, linearsize
+	vHeader[2] = alHeight;
+	vHeader[3] = alWidth;
+	vHeader[4] = GetCompressedImageSize(alWidth, alHeight, abAlpha);
+	vHeader[6] = (uint32_t)avMipMaps.size();
+	vHeader[18] = 32;		//Pixel format size
+	vHeader[19] = 0x4;		//FourCC
+	vHeader[20] = abAlpha ? 0x35545844 : 0x31545844; //"DXT5" : "DXT1"
+	vHeader[26] = 0x1000 | 0x400000 | 0x8;	//Texture, mipmap, complex
+
+	uint32_t lMagic = 0x20534444; //"DDS "
+	bool bOk = fwrite(&lMagic, sizeof(uint32_t), 1, pFile)==1 &&
+				fwrite(vHeader, sizeof(uint32_t), 31, pFile)==31;
+	for(size_t i=0; i<avMipMaps.size() && bOk; ++i)
+	{
+		bOk = fwrite(avMipMaps[i].data(), 1, avMipMaps[i].size(), pFile) == avMipMaps[i].size();
+	}
+
+	fclose(pFile);
+	return bOk;
+}
+
+//------------------------------------------
+
+void CookFile(cCookFile &aFile)
+{
+	//////////////////////////
+	// Skip if the cooked file is up to date
+	if(	gbForce == false &&
+		cPlatform::FileExists(aFile.msCooked) &&
+		cPlatform::FileModifiedDate(aFile.msCooked) > cPlatform::FileModifiedDate(aFile.msSource))
+	{
+		aFile.mbCooked = true;
+		aFile.mbSkipped = true;
+		aFile.msSkipReason = "up to date";
+		aFile.mlCookedDiskSize = cPlatform::GetFileSize(aFile.msCooked);
+		return;
+	}
+
+	if(IsCubeMapFace(aFile.msSource))
+	{
+		aFile.mbSkipped = true;
+		aFile.msSkipReason = "cube map face";
+		return;
+	}
+
+	//////////////////////////
+	// Load
+	cBitmap *pBitmap = gpEngine->GetResources()->GetBitmapLoaderHandler()->LoadBitmap(aFile.msSource, 0);
+	if(pBitmap==NULL)
+	{
+		aFile.mbSkipped = true;
+		aFile.msSkipReason = "could not load";
+		return;
+	}
+
+	int lWidth = pBitmap->GetWidth();
+	int lHeight = pBitmap->GetHeight();
+	aFile.mvSize = cVector2l(lWidth, lHeight);
+	aFile.mlSourceMemSize = GetMipChainMemSize(lWidth, lHeight, 4);
+
+	//Single channel images are alpha or height maps and are used as such by the materials, leave them as they are.
+	std::vector<unsigned char> vRGBA;
+	bool bHasAlpha = false;
+	if(pBitmap->GetNumOfImages() > 1 || pBitmap->GetDepth() > 1)		aFile.msSkipReason = "multiple images";
+	else if(lWidth % 4 != 0 || lHeight % 4 != 0)						aFile.msSkipReason = "size not a multiple of 4";
+	else if(GetRGBAData(pBitmap, vRGBA, bHasAlpha)==false)				aFile.msSkipReason = "unsupported pixel format";
+	hplDelete(pBitmap);
+
+	if(aFile.msSkipReason != "")
+	{
+		aFile.mbSkipped = true;
+		return;
+	}
+
+	//////////////////////////
+	// Build mipmap chain and compress each level
+	aFile.mbAlpha = bHasAlpha;
+
+	std::vector<std::vector<unsigned char> > vMipMaps;
+	std::vector<unsigned char> vNextRGBA;
+	int lMipWidth = lWidth;
+	int lMipHeight = lHeight;
+	while(true)
+	{
+		std::vector<unsigned char> vCompressed(GetCompressedImageSize(lMipWidth, lMipHeight, bHasAlpha));
+		CompressImage(vRGBA.data(), lMipWidth, lMipHeight, bHasAlpha, vCompressed.data());
+		aFile.mlCookedMemSize += (unsigned long)vCompressed.size();
+		vMipMaps.push_back(vCompressed);
+
+		if(lMipWidth == 1 && lMipHeight == 1) break;
+
+		int lNextWidth = std::max(1, lMipWidth/2);
+		int lNextHeight = std::max(1, lMipHeight/2);
+		vNextRGBA.resize(lNextWidth * lNextHeight * 4);
+		DownsampleImage(vRGBA.data(), lMipWidth, lMipHeight, vNextRGBA.data());
+		vRGBA.swap(vNextRGBA);
+		lMipWidth = lNextWidth;
+		lMipHeight = lNextHeight;
+	}
+	aFile.mlNumOfMipMaps = (int)vMipMaps.size();
+
+	//////////////////////////
+	// Save
+	{
+		//Folder creation is not safe to race
+		std::lock_guard<std::mutex> lock(gPrintMutex);
+		CreateFolders(cString::GetFilePathW(aFile.msCooked));
+	}
+	if(WriteDDS(aFile.msCooked, lWidth, lHeight, bHasAlpha, vMipMaps)==false)
+	{
+		aFile.mbSkipped = true;
+		aFile.msSkipReason = "could not write";
+		return;
+	}
+
+	aFile.mbCooked = true;
+	aFile.mlCookedDiskSize = cPlatform::GetFileSize(aFile.msCooked);
+
+	std::lock_guard<std::mutex> lock(gPrintMutex);
+	printf(" Cooked '%s' %dx%d %s, %d mips\n", cString::To8Char(aFile.msSource).c_str(), lWidth, lHeight,
+			bHasAlpha ? "DXT5" : "DXT1", aFile.mlNumOfMipMaps);
+}
+
+//------------------------------------------
+
+void CookFiles()
+{
+	//Decoding through DevIL is serialized by the loader, compression and writing run in parallel.
+	cJobPool::GetDefault()->ParallelFor(gvFiles.size(), [](size_t alIdx)
+	{
+		CookFile(gvFiles[alIdx]);
+	});
+}
+
+//------------------------------------------
+
+/**
+ * Loads the source and the cooked file of each cooked texture once more on a single thread, so the times are not
+ * skewed by the cook threads waiting on the loader. Also fills in the sizes of files skipped as up to date.
+ */
+void MeasureLoadTimes()
+{
+	cBitmapLoaderHandler *pLoader = gpEngine->GetResources()->GetBitmapLoaderHandler();
+	iTimer *pTimer = cPlatform::CreateTimer();
+
+	for(size_t i=0; i<gvFiles.size(); ++i)
+	{
+		cCookFile &file = gvFiles[i];
+		if(file.mbCooked==false) continue;
+
+		pTimer->Start();
+		cBitmap *pSource = pLoader->LoadBitmap(file.msSource, 0);
+		pTimer->Stop();
+		file.mfSourceLoadTime = (float)pTimer->GetTimeInMilliSec();
+
+		pTimer->Start();
+		cBitmap *pCooked = pLoader->LoadBitmap(file.msCooked, 0);
+		pTimer->Stop();
+		file.mfCookedLoadTime = (float)pTimer->GetTimeInMilliSec();
+
+		if(pSource)
+		{
+			if(file.mlSourceMemSize==0)
+			{
+				file.mvSize = cVector2l(pSource->GetWidth(), pSource->GetHeight());
+				file.mlSourceMemSize = GetMipChainMemSize(pSource->GetWidth(), pSource->GetHeight(), 4);
+			}
+			hplDelete(pSource);
+		}
+		if(pCooked)
+		{
+			if(file.mlCookedMemSize==0)
+			{
+				for(int mip=0; mip<pCooked->GetNumOfMipMaps(); ++mip)
+				{
+					file.mlCookedMemSize += (unsigned long)pCooked->GetData(0, mip)->mlSize;
+				}
+				file.mbAlpha = pCooked->GetPixelFormat() == ePixelFormat_DXT5;
+				file.mlNumOfMipMaps = pCooked->GetNumOfMipMaps();
+			}
+			hplDelete(pCooked);
+		}
+	}
+
+	hplDelete(pTimer);
+}
+
+//------------------------------------------
+
+bool IsReferenceFile(const tString &asName)
+{
+	tString sExt = cString::GetFileExt(asName);
+	return sExt == "ent" || sExt == "dae" || sExt == "msh" || sExt == "mat" || sExt == "dds" ||
+			IsCookableFile(cString::To16Char(asName));
+}
+
+/**
+ * Gets the lower case names of all the files a map, entity, mesh or material refers to. Any token that ends in
+ * a known extension is taken, which covers xml attributes as well as the image paths in collada files.
+ */
+const tStringVec& GetFileReferences(const tWString &asFile)
+{
+	static std::map<tWString, tStringVec> mapReferences;
+	std::map<tWString, tStringVec>::iterator it = mapReferences.find(asFile);
+	if(it != mapReferences.end()) return it->second;
+
+	tStringVec &vRefs = mapReferences[asFile];
+
+	unsigned long lSize = cPlatform::GetFileSize(asFile);
+	std::vector<char> vData(lSize);
+	if(lSize==0 || cPlatform::CopyFileToBuffer(asFile, vData.data(), lSize)==false) return vRefs;
+
+	const char *pDelims = "\"'<>= \t\r\n";
+	size_t lStart = 0;
+	for(size_t i=0; i<=lSize; ++i)
+	{
+		if(i<lSize && vData[i]!=0 && strchr(pDelims, vData[i])==NULL) continue;
+
+		if(i > lStart)
+		{
+			tString sName = cString::ToLowerCase(cString::GetFileName(tString(&vData[lStart], i-lStart)));
+			if(IsReferenceFile(sName)) vRefs.push_back(sName);
+		}
+		lStart = i+1;
+	}
+
+	return vRefs;
+}
+
+//------------------------------------------
+
+/**
+ * Follows the entity, mesh and material files a map refers to and collects the textures found in the input dir.
+ * Meshes pick the material with the same name as their image, so that is followed as well.
+ */
+void CollectMapTextures(cCookMap &aMap)
+{
+	std::set<tString> setVisited;
+	std::set<size_t> setTextures;
+	std::vector<tWString> vToScan;
+	vToScan.push_back(aMap.msFile);
+
+	while(vToScan.empty()==false)
+	{
+		tWString sFile = vToScan.back();
+		vToScan.pop_back();
+
+		const tStringVec &vRefs = GetFileReferences(sFile);
+		for(size_t i=0; i<vRefs.size(); ++i)
+		{
+			tString sName = vRefs[i];
+			tString sExt = cString::GetFileExt(sName);
+
+			if(sExt == "msh")
+			{
+				//Binary cache of the collada file
+				sName = cString::SetFileExt(sName, "dae");
+			}
+			else if(sExt != "ent" && sExt != "dae" && sExt != "mat")
+			{
+				std::map<tString, size_t>::iterator texIt = gmapTexturesByName.find(cString::SetFileExt(sName, ""));
+				if(texIt != gmapTexturesByName.end()) setTextures.insert(texIt->second);
+
+				sName = cString::SetFileExt(sName, "mat");
+			}
+
+			std::map<tString, tWString>::iterator fileIt = gmapFilesByName.find(sName);
+			if(fileIt == gmapFilesByName.end()) continue;
+			if(setVisited.insert(sName).second) vToScan.push_back(fileIt->second);
+		}
+	}
+
+	aMap.mvTextures.assign(setTextures.begin(), setTextures.end());
+}
+
+//------------------------------------------
+
+void SaveManifest()
+{
+	iXmlDocument *pDoc = gpEngine->GetResources()->GetLowLevel()->CreateXmlDocument("CookedTextures");
+
+	//The game resolves the paths from the dir it runs in, so they are written relative to the asset root
+	//and not to where the cooker was started.
+	tWString sFullRoot = cString::ReplaceCharToW(cPlatform::GetFullFilePath(gsInputDir), _W("\\"), _W("/"));
+
+	for(size_t i=0; i<gvFiles.size(); ++i)
+	{
+		cCookFile &file = gvFiles[i];
+		if(file.mbCooked==false) continue;
+
+		tWString sFullCooked = cString::ReplaceCharToW(cPlatform::GetFullFilePath(file.msCooked), _W("\\"), _W("/"));
+
+		cXmlElement *pElem = pDoc->CreateChildElement("Texture");
+		pElem->SetAttributeString("Source", cString::To8Char(file.msName));
+		pElem->SetAttributeString("Cooked", cString::To8Char(cString::GetRelativePathW(sFullCooked, sFullRoot)));
+	}
+
+	pDoc->SaveToFile(gsOutputDir + _W("/") + gsManifestFile);
+	hplDelete(pDoc);
+}
+
+//------------------------------------------
+
+void SaveReport()
+{
+	FILE *pFile = cPlatform::OpenFile(gsOutputDir + _W("/") + gsReportFile, _W("w"));
+	if(pFile==NULL)
+	{
+		Error("Could not write report file!\n");
+		return;
+	}
+
+	unsigned long lSourceDisk=0, lCookedDisk=0, lSourceMem=0, lCookedMem=0;
+	float fSourceLoad=0, fCookedLoad=0;
+	int lNumCooked=0, lNumSkipped=0;
+
+	fprintf(pFile, "Texture cook report. Memory is the estimated video memory, source textures are uploaded as RGBA8 with a full mip chain.\n");
+	fprintf(pFile, "Load times are in ms for loading the bitmap on one thread. The mip chain the source textures need at load\n");
+	fprintf(pFile, "is not included, so the real saving is larger.\n\n");
+	fprintf(pFile, "%-70s %10s %10s %10s %10s %8s %8s  %s\n", "File", "Disk", "Cooked", "Mem", "CookedMem", "Load", "Cooked", "Notes");
+
+	for(size_t i=0; i<gvFiles.size(); ++i)
+	{
+		cCookFile &file = gvFiles[i];
+		if(file.mbCooked && file.mlCookedMemSize > 0)
+		{
+			lSourceDisk += file.mlSourceDiskSize;
+			lCookedDisk += file.mlCookedDiskSize;
+			lSourceMem += file.mlSourceMemSize;
+			lCookedMem += file.mlCookedMemSize;
+			fSourceLoad += file.mfSourceLoadTime;
+			fCookedLoad += file.mfCookedLoadTime;
+		}
+		if(file.mbCooked)	lNumCooked++;
+		else				lNumSkipped++;
+
+		fprintf(pFile, "%-70s %10lu %10lu %10lu %10lu %8.2f %8.2f  %s\n", cString::To8Char(file.msSource).c_str(),
+				file.mlSourceDiskSize, file.mlCookedDiskSize, file.mlSourceMemSize, file.mlCookedMemSize,
+				file.mfSourceLoadTime, file.mfCookedLoadTime,
+				file.mbSkipped ? file.msSkipReason.c_str() : (file.mbAlpha ? "DXT5" : "DXT1"));
+	}
+
+	fprintf(pFile, "\nCooked: %d Skipped: %d\n", lNumCooked, lNumSkipped);
+	fprintf(pFile, "Cooked textures, disk: %lu KB -> %lu KB, video memory: %lu KB -> %lu KB, load: %.0f ms -> %.0f ms\n",
+			lSourceDisk/1024, lCookedDisk/1024, lSourceMem/1024, lCookedMem/1024, fSourceLoad, fCookedLoad);
+
+	//////////////////////////
+	// Per map, only the cooked textures count towards the sizes
+	fprintf(pFile, "\nPer map, the textures found by following the entity, mesh and material files the map refers to.\n\n");
+	fprintf(pFile, "%-50s %8s %8s %10s %10s %10s %10s %8s %8s\n", "Map", "Textures", "Cooked", "Disk KB", "Cooked KB",
+			"Mem KB", "Cooked KB", "Load", "Cooked");
+
+	for(size_t i=0; i<gvMaps.size(); ++i)
+	{
+		cCookMap &map = gvMaps[i];
+
+		unsigned long lMapSourceDisk=0, lMapCookedDisk=0, lMapSourceMem=0, lMapCookedMem=0;
+		float fMapSourceLoad=0, fMapCookedLoad=0;
+		int lMapCooked=0;
+		for(size_t j=0; j<map.mvTextures.size(); ++j)
+		{
+			cCookFile &file = gvFiles[map.mvTextures[j]];
+			if(file.mbCooked==false || file.mlCookedMemSize == 0) continue;
+
+			lMapSourceDisk += file.mlSourceDiskSize;
+			lMapCookedDisk += file.mlCookedDiskSize;
+			lMapSourceMem += file.mlSourceMemSize;
+			lMapCookedMem += file.mlCookedMemSize;
+			fMapSourceLoad += file.mfSourceLoadTime;
+			fMapCookedLoad += file.mfCookedLoadTime;
+			lMapCooked++;
+		}
+
+		fprintf(pFile, "%-50s %8d %8d %10lu %10lu %10lu %10lu %8.0f %8.0f\n", cString::To8Char(map.msFile).c_str(),
+				(int)map.mvTextures.size(), lMapCooked, lMapSourceDisk/1024, lMapCookedDisk/1024,
+				lMapSourceMem/1024, lMapCookedMem/1024, fMapSourceLoad, fMapCookedLoad);
+	}
+
+	fclose(pFile);
+
+	printf("\n Cooked: %d Skipped: %d\n", lNumCooked, lNumSkipped);
+	printf(" Video memory: %lu KB -> %lu KB\n", lSourceMem/1024, lCookedMem/1024);
+	printf(" Load time: %.0f ms -> %.0f ms\n", fSourceLoad, fCookedLoad);
+}
+
+//------------------------------------------
+
+#ifdef WIN32
+	#include <Windows.h>
+
+#endif
+
+#ifdef WIN32
+	int main(int argc, const char* argv[] )
+	{
+		tString asCommandLine;
+		for(int i=1; i<argc; ++i)
+		{
+			asCommandLine += argv[i];
+			if(i!=argc-1) asCommandLine += " ";
+		}
+
+#else
+	int hplMain(const tString &asCommandLine)
+	{
+#endif
+
+	cEngineInitVars vars;
+	gpEngine = CreateHPLEngine(eHplAPI_OpenGL, 0, &vars);
+
+	ParseCommandLine(asCommandLine);
+
+	printf("-------- TEXTURE COOKING STARTED! -----------\n\n");
+
+	if(gsInputDir == _W("") || cPlatform::FolderExists(gsInputDir)==false)
+	{
+		printf("No valid directory specified!\n");
+	}
+	else
+	{
+		unsigned long lStartTime = cPlatform::GetApplicationTime();
+
+		CollectFilesInDir(gsInputDir, _W(""));
+		CreateFolders(gsOutputDir);
+		CookFiles();
+		MeasureLoadTimes();
+		for(size_t i=0; i<gvMaps.size(); ++i) CollectMapTextures(gvMaps[i]);
+		SaveManifest();
+		SaveReport();
+
+		printf(" Done in %lums\n", cPlatform::GetApplicationTime()-lStartTime);
+	}
+
+	printf("\n-------- TEXTURE COOKING DONE! -----------\n");
+
+	DestroyHPLEngine(gpEngine);
+
+	return 0;
+}
+
+#ifdef WIN32
+	int hplMain(const tString &asCommandLine){return -1;}
+#endif
+
+#ifdef __APPLE__
+extern "C" int SDL_main(int argc, char *argv[]);
+int main(int argc, char * argv[]) {
+    return SDL_main(argc, argv);
+}
+#endif